@@ -168,6 +168,8 @@ bool Config::Reload(std::filesystem::path iniPath)
             FGHUDLimit.set_from_config(readInt("OptiFG", "HUDLimit"));
             FGHUDFixExtended.set_from_config(readBool("OptiFG", "HUDFixExtended"));
             FGImmediateCapture.set_from_config(readBool("OptiFG", "HUDFixImmediate"));
+            FGHUDFixProfile.set_from_config(readBool("OptiFG", "HUDFixProfile"));
+            FGHUDFixScoring.set_from_config(readBool("OptiFG", "HUDFixScoring"));
             FGUseShards.set_from_config(readBool("OptiFG", "UseShards"));
             FGAlwaysTrackHeaps.set_from_config(readBool("OptiFG", "AlwaysTrackHeaps"));
             FGResourceBlocking.set_from_config(readBool("OptiFG", "ResourceBlocking"));
@@ -239,6 +241,12 @@ bool Config::Reload(std::filesystem::path iniPath)
         // Framerate
         {
             FramerateLimit.set_from_config(readFloat("Framerate", "FramerateLimit"));
+            FramerateLimitLatencyOptimized.set_from_config(readBool("Framerate", "LatencyOptimized"));
+
+            if (auto v = readEnum<FramerateSnap>("Framerate", "Snap"))
+                FramerateLimitSnap.set_from_config(*v);
+            else
+                FramerateLimitSnap.reset();
         }
 
         // FSR Common
@@ -292,6 +300,7 @@ bool Config::Reload(std::filesystem::path iniPath)
         // XeSS
         {
             BuildPipelines.set_from_config(readBool("XeSS", "BuildPipelines"));
+            XeSSPipelineCache.set_from_config(readBool("XeSS", "PipelineCache"));
             NetworkModel.set_from_config(readInt("XeSS", "NetworkModel"));
             CreateHeaps.set_from_config(readBool("XeSS", "CreateHeaps"));
         }
@@ -991,6 +1000,8 @@ bool Config::SaveIni()
         ini.SetValue("OptiFG", "HUDFixExtended", GetBoolValue(Instance()->FGHUDFixExtended.value_for_config()).c_str());
         ini.SetValue("OptiFG", "HUDFixImmediate",
                      GetBoolValue(Instance()->FGImmediateCapture.value_for_config()).c_str());
+        ini.SetValue("OptiFG", "HUDFixProfile", GetBoolValue(Instance()->FGHUDFixProfile.value_for_config()).c_str());
+        ini.SetValue("OptiFG", "HUDFixScoring", GetBoolValue(Instance()->FGHUDFixScoring.value_for_config()).c_str());
         ini.SetValue("OptiFG", "UseShards", GetBoolValue(Instance()->FGUseShards.value_for_config()).c_str());
         ini.SetValue("OptiFG", "AlwaysTrackHeaps",
                      GetBoolValue(Instance()->FGAlwaysTrackHeaps.value_for_config()).c_str());
@@ -1046,6 +1057,9 @@ bool Config::SaveIni()
     {
         ini.SetValue("Framerate", "FramerateLimit",
                      GetFloatValue(Instance()->FramerateLimit.value_for_config()).c_str());
+        ini.SetValue("Framerate", "Snap", GetIntValue(Instance()->FramerateLimitSnap.value_for_config()).c_str());
+        ini.SetValue("Framerate", "LatencyOptimized",
+                     GetBoolValue(Instance()->FramerateLimitLatencyOptimized.value_for_config()).c_str());
     }
 
     // Output Scaling
@@ -1098,6 +1112,7 @@ bool Config::SaveIni()
     // XeSS
     {
         ini.SetValue("XeSS", "BuildPipelines", GetBoolValue(Instance()->BuildPipelines.value_for_config()).c_str());
+        ini.SetValue("XeSS", "PipelineCache", GetBoolValue(Instance()->XeSSPipelineCache.value_for_config()).c_str());
         ini.SetValue("XeSS", "CreateHeaps", GetBoolValue(Instance()->CreateHeaps.value_for_config()).c_str());
         ini.SetValue("XeSS", "NetworkModel", GetIntValue(Instance()->NetworkModel.value_for_config()).c_str());
     }
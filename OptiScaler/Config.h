@@ -200,6 +200,14 @@ enum class LowLatencyInput : uint32_t
     _
 };
 
+enum class FramerateSnap : uint32_t
+{
+    Off,
+    RefreshDivisor,
+    VrrCap,
+    Count
+};
+
 enum class LowLatencyMode : uint32_t
 {
     None,
@@ -240,6 +248,7 @@ class Config
 
     // XeSS
     CustomOptional<bool> BuildPipelines { true };
+    CustomOptional<bool> XeSSPipelineCache { true };
     CustomOptional<int32_t> NetworkModel { 0 };
     CustomOptional<bool> CreateHeaps { true };
 
@@ -540,6 +549,8 @@ class Config
     CustomOptional<int> FGHUDLimit { 1 };
     CustomOptional<bool> FGHUDFixExtended { false };
     CustomOptional<bool> FGImmediateCapture { false };
+    CustomOptional<bool> FGHUDFixProfile { true };
+    CustomOptional<bool> FGHUDFixScoring { false };
     CustomOptional<bool> FGDontUseSwapchainBuffers { false };
     CustomOptional<bool> FGRelaxedResolutionCheck { false };
     CustomOptional<bool> FGHudfixDisableRTV { false };
@@ -630,6 +641,8 @@ class Config
 
     // Framerate
     CustomOptional<float> FramerateLimit { 0.0f };
+    CustomOptional<FramerateSnap> FramerateLimitSnap { FramerateSnap::Off };
+    CustomOptional<bool> FramerateLimitLatencyOptimized { false };
 
     // HDR
     CustomOptional<bool> ForceHDR { false };
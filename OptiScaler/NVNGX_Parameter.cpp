@@ -336,17 +336,25 @@ NVSDK_NGX_Result NVNGX_Parameters::Get(const char* key, ID3D12Resource** value)
 
 void NVNGX_Parameters::Reset()
 {
-    if (!m_values.empty())
+    // Preserve usage type if set
+    uint32_t allocType = NGX_AllocTypes::Unknown;
+    NVSDK_NGX_Result result = Get(NGX_AllocTypes::AllocKey.data(), &allocType);
+
     {
-        // Preserve usage type if set
-        uint32_t allocType = NGX_AllocTypes::Unknown;
-        NVSDK_NGX_Result result = Get(NGX_AllocTypes::AllocKey.data(), &allocType);
+        const std::lock_guard<std::mutex> lock(m_mutex);
+
         m_values.clear();
 
-        if (result != NVSDK_NGX_Result_Fail)
-            Set(NGX_AllocTypes::AllocKey.data(), allocType);
+        for (auto& slot : m_fixed)
+        {
+            if (slot.type.load(std::memory_order_relaxed) != ParameterType::None)
+                writeFixed(slot, Parameter {});
+        }
     }
 
+    if (result != NVSDK_NGX_Result_Fail)
+        Set(NGX_AllocTypes::AllocKey.data(), allocType);
+
     LOG_DEBUG("Start");
 
     InitNGXParameters(this);
@@ -356,7 +364,15 @@ void NVNGX_Parameters::Reset()
 
 std::vector<std::string> NVNGX_Parameters::enumerate() const
 {
+    const std::lock_guard<std::mutex> lock(m_mutex);
+
     std::vector<std::string> keys;
+    for (size_t i = 0; i < m_fixed.size(); i++)
+    {
+        if (m_fixed[i].type.load(std::memory_order_relaxed) != ParameterType::None)
+            keys.push_back(std::string(ngx_keys::KnownKeys[i]));
+    }
+
     for (auto& value : m_values)
     {
         keys.push_back(value.first);
@@ -364,27 +380,175 @@ std::vector<std::string> NVNGX_Parameters::enumerate() const
     return keys;
 }
 
+void NVNGX_Parameters::writeFixed(FixedSlot& slot, const Parameter& value)
+{
+    uint64_t raw = 0;
+    memcpy(&raw, &value.values, sizeof(value.values));
+
+    auto sequence = slot.sequence.load(std::memory_order_relaxed);
+    slot.sequence.store(sequence + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    slot.type.store(value.type, std::memory_order_relaxed);
+    slot.value.store(raw, std::memory_order_relaxed);
+
+    slot.sequence.store(sequence + 2, std::memory_order_release);
+}
+
+bool NVNGX_Parameters::readFixed(const FixedSlot& slot, Parameter& value) const
+{
+    while (true)
+    {
+        auto sequence = slot.sequence.load(std::memory_order_acquire);
+
+        // Writer in progress
+        if (sequence & 1)
+        {
+            YieldProcessor();
+            continue;
+        }
+
+        auto type = slot.type.load(std::memory_order_relaxed);
+        auto raw = slot.value.load(std::memory_order_relaxed);
+
+        std::atomic_thread_fence(std::memory_order_acquire);
+
+        if (slot.sequence.load(std::memory_order_relaxed) != sequence)
+            continue;
+
+        if (type == ParameterType::None)
+            return false;
+
+        value.type = type;
+        memcpy(&value.values, &raw, sizeof(value.values));
+        return true;
+    }
+}
+
 template <typename T> void NVNGX_Parameters::setT(const char* key, T& value)
 {
+    auto index = ngx_keys::Find(key);
+
     const std::lock_guard<std::mutex> lock(m_mutex);
+
+    if (index >= 0)
+    {
+        Parameter p;
+        p = value;
+        writeFixed(m_fixed[index], p);
+        return;
+    }
+
     m_values[key] = value;
 }
 
 template <typename T> NVSDK_NGX_Result NVNGX_Parameters::getT(const char* key, T* value) const
 {
-    const std::lock_guard<std::mutex> lock(m_mutex);
+    auto index = ngx_keys::Find(key);
+    Parameter p;
+
+    if (index >= 0)
+    {
+        if (!readFixed(m_fixed[index], p))
+        {
+            LOG_TRACE("('{0}', FAIL)", key);
+            return NVSDK_NGX_Result_Fail;
+        }
+    }
+    else
+    {
+        const std::lock_guard<std::mutex> lock(m_mutex);
+
+        if (!findLocked(key, index, p))
+        {
+            LOG_TRACE("('{0}', FAIL)", key);
+            return NVSDK_NGX_Result_Fail;
+        }
+    }
+
+    *value = p;
+    return NVSDK_NGX_Result_Success;
+}
+
+bool NVNGX_Parameters::findLocked(const char* key, int index, Parameter& value) const
+{
+    if (index >= 0)
+        return readFixed(m_fixed[index], value);
+
     auto k = m_values.find(key);
 
     if (k == m_values.end())
+        return false;
+
+    value = (*k).second;
+    return true;
+}
+
+template <typename T> static void StoreRequestValue(const Parameter& p, void* value) { *static_cast<T*>(value) = p; }
+
+static void StoreRequestValue(const Parameter& p, ParameterRequest& request)
+{
+    switch (request.Type)
     {
-        LOG_TRACE("('{0}', FAIL)", key);
-        return NVSDK_NGX_Result_Fail;
-    };
+    case ParameterType::Float:
+        StoreRequestValue<float>(p, request.Value);
+        break;
 
-    const Parameter& p = (*k).second;
-    *value = p;
+    case ParameterType::Double:
+        StoreRequestValue<double>(p, request.Value);
+        break;
 
-    return NVSDK_NGX_Result_Success;
+    case ParameterType::Int:
+        StoreRequestValue<int>(p, request.Value);
+        break;
+
+    case ParameterType::UInt:
+        StoreRequestValue<unsigned int>(p, request.Value);
+        break;
+
+    case ParameterType::ULongLong:
+        StoreRequestValue<unsigned long long>(p, request.Value);
+        break;
+
+    case ParameterType::Pointer:
+        StoreRequestValue<void*>(p, request.Value);
+        break;
+
+    default:
+        request.Found = false;
+        break;
+    }
+}
+
+size_t NVNGX_Parameters::GetMany(std::span<ParameterRequest> requests) const
+{
+    // Unknown keys need the map, take the lock once for the whole batch
+    std::unique_lock<std::mutex> lock(m_mutex, std::defer_lock);
+    size_t found = 0;
+
+    for (auto& request : requests)
+    {
+        auto index = ngx_keys::Find(request.Key);
+        Parameter p;
+
+        if (index < 0 && request.Key != nullptr && !lock.owns_lock())
+            lock.lock();
+
+        request.Found = request.Key != nullptr && findLocked(request.Key, index, p);
+
+        if (!request.Found)
+        {
+            LOG_TRACE("('{0}', FAIL)", request.Key == nullptr ? "null" : request.Key);
+            continue;
+        }
+
+        StoreRequestValue(p, request);
+
+        if (request.Found)
+            found++;
+    }
+
+    return found;
 }
 
 NVSDK_NGX_Result NVSDK_CONV NVSDK_NGX_DLSS_GetOptimalSettingsCallback(NVSDK_NGX_Parameter* InParams)
@@ -834,6 +998,64 @@ NVNGX_Parameters* GetNGXParameters(std::string_view name, bool isPersistent)
     return params;
 }
 
+size_t GetNGXParameterValues(const NVSDK_NGX_Parameter* params, std::span<ParameterRequest> requests)
+{
+    if (params == nullptr)
+        return 0;
+
+    // Only our own tables are tagged with intern alloc types
+    uint32_t allocType = NGX_AllocTypes::Unknown;
+    if (params->Get(NGX_AllocTypes::AllocKey.data(), &allocType) == NVSDK_NGX_Result_Success &&
+        (allocType == NGX_AllocTypes::InternDynamic || allocType == NGX_AllocTypes::InternPersistent))
+    {
+        return static_cast<const NVNGX_Parameters*>(params)->GetMany(requests);
+    }
+
+    size_t found = 0;
+
+    for (auto& request : requests)
+    {
+        NVSDK_NGX_Result result = NVSDK_NGX_Result_Fail;
+
+        switch (request.Type)
+        {
+        case ParameterType::Float:
+            result = params->Get(request.Key, static_cast<float*>(request.Value));
+            break;
+
+        case ParameterType::Double:
+            result = params->Get(request.Key, static_cast<double*>(request.Value));
+            break;
+
+        case ParameterType::Int:
+            result = params->Get(request.Key, static_cast<int*>(request.Value));
+            break;
+
+        case ParameterType::UInt:
+            result = params->Get(request.Key, static_cast<unsigned int*>(request.Value));
+            break;
+
+        case ParameterType::ULongLong:
+            result = params->Get(request.Key, static_cast<unsigned long long*>(request.Value));
+            break;
+
+        case ParameterType::Pointer:
+            result = params->Get(request.Key, static_cast<void**>(request.Value));
+            break;
+
+        default:
+            break;
+        }
+
+        request.Found = result == NVSDK_NGX_Result_Success;
+
+        if (request.Found)
+            found++;
+    }
+
+    return found;
+}
+
 void SetNGXParamAllocType(NVSDK_NGX_Parameter& params, uint32_t allocType)
 {
     params.Set(NGX_AllocTypes::AllocKey.data(), allocType);
@@ -1,5 +1,9 @@
 #pragma once
 
+#include "NVNGX_ParameterKeys.h"
+
+#include <span>
+
 // Use real NVNGX params encapsulated in custom one
 // Which is not working correctly
 // #define ENABLE_ENCAPSULATED_PARAMS
@@ -51,124 +55,111 @@ static NVSDK_NGX_Result NVSDK_CONV NVSDK_NGX_DLSS_GetStatsCallback(NVSDK_NGX_Par
 /// values.
 void InitNGXParameters(NVSDK_NGX_Parameter* InParams);
 
+/// @brief Type of the value stored in a Parameter.
+enum class ParameterType : uint8_t
+{
+    None = 0,
+    Float,
+    Double,
+    Int,
+    UInt,
+    ULongLong,
+    Pointer, // void*, ID3D11Resource*, ID3D12Resource*
+    Count
+};
+
+template <typename T> inline constexpr ParameterType ParameterTypeOf = ParameterType::None;
+template <> inline constexpr ParameterType ParameterTypeOf<float> = ParameterType::Float;
+template <> inline constexpr ParameterType ParameterTypeOf<double> = ParameterType::Double;
+template <> inline constexpr ParameterType ParameterTypeOf<int> = ParameterType::Int;
+template <> inline constexpr ParameterType ParameterTypeOf<unsigned int> = ParameterType::UInt;
+template <> inline constexpr ParameterType ParameterTypeOf<unsigned long long> = ParameterType::ULongLong;
+template <> inline constexpr ParameterType ParameterTypeOf<void*> = ParameterType::Pointer;
+template <> inline constexpr ParameterType ParameterTypeOf<ID3D11Resource*> = ParameterType::Pointer;
+template <> inline constexpr ParameterType ParameterTypeOf<ID3D12Resource*> = ParameterType::Pointer;
+
+/// @brief Which stored types can be read as which type, indexed [requested][stored].
+/// Numbers convert to each other, pointers only to pointers and unsigned long long.
+inline constexpr bool ParameterConversions[(size_t) ParameterType::Count][(size_t) ParameterType::Count] = {
+    // None   Float  Double Int    UInt   ULL    Pointer
+    { false, false, false, false, false, false, false }, // None
+    { false, true, true, true, true, true, false },      // Float
+    { false, true, true, true, true, true, false },      // Double
+    { false, true, true, true, true, true, false },      // Int
+    { false, true, true, true, true, true, false },      // UInt
+    { false, true, true, true, true, true, true },       // ULongLong
+    { false, false, false, false, false, false, true },  // Pointer
+};
+
 /// @brief Internal variant structure holding the value of a single NGX parameter.
 struct Parameter
 {
     template <typename T> void operator=(T value)
     {
-        if constexpr (std::is_same<T, void*>::value || std::is_same<T, ID3D11Resource*>::value ||
-                      std::is_same<T, ID3D12Resource*>::value)
-        {
-            key = typeid(void*).hash_code();
+        constexpr auto type = ParameterTypeOf<T>;
+        static_assert(type != ParameterType::None, "Unsupported parameter type");
+
+        this->type = type;
+
+        if constexpr (type == ParameterType::Pointer)
             values.vp = (void*) value;
-        }
-        else
-        {
-            key = typeid(T).hash_code();
-            if constexpr (std::is_same<T, float>::value)
-                values.f = value;
-            else if constexpr (std::is_same<T, int>::value)
-                values.i = value;
-            else if constexpr (std::is_same<T, unsigned int>::value)
-                values.ui = value;
-            else if constexpr (std::is_same<T, double>::value)
-                values.d = value;
-            else if constexpr (std::is_same<T, unsigned long long>::value)
-                values.ull = value;
-        }
+        else if constexpr (type == ParameterType::Float)
+            values.f = value;
+        else if constexpr (type == ParameterType::Int)
+            values.i = value;
+        else if constexpr (type == ParameterType::UInt)
+            values.ui = value;
+        else if constexpr (type == ParameterType::Double)
+            values.d = value;
+        else if constexpr (type == ParameterType::ULongLong)
+            values.ull = value;
     }
 
     template <typename T> operator T() const
     {
-        T v = {};
+        constexpr auto target = ParameterTypeOf<T>;
+        static_assert(target != ParameterType::None, "Unsupported parameter type");
 
-        bool isPointerKey = (key == typeid(void*).hash_code() || key == typeid(ID3D11Resource*).hash_code() ||
-                             key == typeid(ID3D12Resource*).hash_code());
+        if (!ParameterConversions[(size_t) target][(size_t) type])
+            return T {};
 
-        if constexpr (std::is_same<T, float>::value)
-        {
-            if (key == typeid(unsigned long long).hash_code())
-                v = (T) values.ull;
-            else if (key == typeid(float).hash_code())
-                v = (T) values.f;
-            else if (key == typeid(double).hash_code())
-                v = (T) values.d;
-            else if (key == typeid(unsigned int).hash_code())
-                v = (T) values.ui;
-            else if (key == typeid(int).hash_code())
-                v = (T) values.i;
-        }
-        else if constexpr (std::is_same<T, int>::value)
-        {
-            if (key == typeid(unsigned long long).hash_code())
-                v = (T) values.ull;
-            else if (key == typeid(float).hash_code())
-                v = (T) values.f;
-            else if (key == typeid(double).hash_code())
-                v = (T) values.d;
-            else if (key == typeid(int).hash_code())
-                v = (T) values.i;
-            else if (key == typeid(unsigned int).hash_code())
-                v = (T) values.ui;
-        }
-        else if constexpr (std::is_same<T, unsigned int>::value)
-        {
-            if (key == typeid(unsigned long long).hash_code())
-                v = (T) values.ull;
-            else if (key == typeid(float).hash_code())
-                v = (T) values.f;
-            else if (key == typeid(double).hash_code())
-                v = (T) values.d;
-            else if (key == typeid(int).hash_code())
-                v = (T) values.i;
-            else if (key == typeid(unsigned int).hash_code())
-                v = (T) values.ui;
-        }
-        else if constexpr (std::is_same<T, double>::value)
-        {
-            if (key == typeid(unsigned long long).hash_code())
-                v = (T) values.ull;
-            else if (key == typeid(float).hash_code())
-                v = (T) values.f;
-            else if (key == typeid(double).hash_code())
-                v = (T) values.d;
-            else if (key == typeid(int).hash_code())
-                v = (T) values.i;
-            else if (key == typeid(unsigned int).hash_code())
-                v = (T) values.ui;
-        }
-        else if constexpr (std::is_same<T, unsigned long long>::value)
+        switch (type)
         {
-            if (key == typeid(unsigned long long).hash_code())
-                v = (T) values.ull;
-            else if (key == typeid(float).hash_code())
-                v = (T) values.f;
-            else if (key == typeid(double).hash_code())
-                v = (T) values.d;
-            else if (key == typeid(int).hash_code())
-                v = (T) values.i;
-            else if (key == typeid(unsigned int).hash_code())
-                v = (T) values.ui;
-            else if (isPointerKey)
-                v = (T) values.vp;
-        }
-        else if constexpr (std::is_same<T, void*>::value)
-        {
-            if (isPointerKey)
-                v = values.vp;
-        }
-        else if constexpr (std::is_same<T, ID3D11Resource*>::value)
-        {
-            if (isPointerKey)
-                v = (T) values.vp;
-        }
-        else if constexpr (std::is_same<T, ID3D12Resource*>::value)
-        {
-            if (isPointerKey)
-                v = (T) values.vp;
+        case ParameterType::Float:
+            if constexpr (target != ParameterType::Pointer)
+                return (T) values.f;
+            break;
+
+        case ParameterType::Double:
+            if constexpr (target != ParameterType::Pointer)
+                return (T) values.d;
+            break;
+
+        case ParameterType::Int:
+            if constexpr (target != ParameterType::Pointer)
+                return (T) values.i;
+            break;
+
+        case ParameterType::UInt:
+            if constexpr (target != ParameterType::Pointer)
+                return (T) values.ui;
+            break;
+
+        case ParameterType::ULongLong:
+            if constexpr (target != ParameterType::Pointer)
+                return (T) values.ull;
+            break;
+
+        case ParameterType::Pointer:
+            if constexpr (target == ParameterType::Pointer || target == ParameterType::ULongLong)
+                return (T) values.vp;
+            break;
+
+        default:
+            break;
         }
 
-        return v;
+        return T {};
     }
 
     union
@@ -183,7 +174,25 @@ struct Parameter
         ID3D12Resource* d12r;
     } values;
 
-    size_t key = 0;
+    ParameterType type = ParameterType::None;
+};
+
+/// @brief One entry of a NVNGX_Parameters::GetMany batch.
+/// Value must point to a variable of the given type, it's left untouched when the key is missing.
+struct ParameterRequest
+{
+    const char* Key = nullptr;
+    ParameterType Type = ParameterType::None;
+    void* Value = nullptr;
+    bool Found = false;
+
+    ParameterRequest() = default;
+
+    template <typename T>
+    ParameterRequest(const char* key, T* value) : Key(key), Type(ParameterTypeOf<T>), Value((void*) value)
+    {
+        static_assert(ParameterTypeOf<T> != ParameterType::None, "Unsupported parameter type");
+    }
 };
 
 /// @brief Implementation of the NVSDK_NGX_Parameter interface, providing thread-safe storage and retrieval of NGX
@@ -225,15 +234,35 @@ struct NVNGX_Parameters : public NVSDK_NGX_Parameter
 
     void Reset() override;
 
+    /// @brief Reads all requested values in one pass, returns number of found keys.
+    size_t GetMany(std::span<ParameterRequest> requests) const;
+
     std::vector<std::string> enumerate() const;
 
   private:
+    // Value of a known key, readers don't lock.
+    // Writers hold m_mutex and bump sequence to odd while updating, readers retry on change.
+    struct FixedSlot
+    {
+        std::atomic<uint32_t> sequence { 0 };
+        std::atomic<ParameterType> type { ParameterType::None };
+        std::atomic<uint64_t> value { 0 };
+    };
+
+    std::array<FixedSlot, ngx_keys::KeyCount> m_fixed;
+
+    // Unknown keys
     ankerl::unordered_dense::map<std::string, Parameter> m_values;
     mutable std::mutex m_mutex;
 
+    void writeFixed(FixedSlot& slot, const Parameter& value);
+    bool readFixed(const FixedSlot& slot, Parameter& value) const;
+
     template <typename T> void setT(const char* key, T& value);
 
     template <typename T> NVSDK_NGX_Result getT(const char* key, T* value) const;
+
+    bool findLocked(const char* key, int index, Parameter& value) const;
 };
 
 /**
@@ -242,6 +271,12 @@ struct NVNGX_Parameters : public NVSDK_NGX_Parameter
  */
 NVNGX_Parameters* GetNGXParameters(std::string_view name, bool isPersistent);
 
+/**
+ * @brief Batched read which works for any NGX table. OptiScaler tables are read with
+ * NVNGX_Parameters::GetMany, others fall back to one Get call per request.
+ */
+size_t GetNGXParameterValues(const NVSDK_NGX_Parameter* params, std::span<ParameterRequest> requests);
+
 /**
  * @brief Sets a custom tracking tag to indicate the memory management strategy required by
  * the table, indicated by NGX_AllocTypes.
@@ -0,0 +1,492 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <cstring>
+#include <string_view>
+
+// Compile time table of known NGX parameter keys.
+// NVNGX_Parameters stores these in fixed slots, only unknown keys go to the map.
+namespace ngx_keys
+{
+
+inline constexpr std::string_view KnownKeys[] = {
+    // nvsdk_ngx_defs.h
+    NVSDK_NGX_EParameter_Reserved00,
+    NVSDK_NGX_EParameter_SuperSampling_Available,
+    NVSDK_NGX_EParameter_InPainting_Available,
+    NVSDK_NGX_EParameter_ImageSuperResolution_Available,
+    NVSDK_NGX_EParameter_SlowMotion_Available,
+    NVSDK_NGX_EParameter_VideoSuperResolution_Available,
+    NVSDK_NGX_EParameter_Reserved06,
+    NVSDK_NGX_EParameter_Reserved07,
+    NVSDK_NGX_EParameter_Reserved08,
+    NVSDK_NGX_EParameter_ImageSignalProcessing_Available,
+    NVSDK_NGX_EParameter_ImageSuperResolution_ScaleFactor_2_1,
+    NVSDK_NGX_EParameter_ImageSuperResolution_ScaleFactor_3_1,
+    NVSDK_NGX_EParameter_ImageSuperResolution_ScaleFactor_3_2,
+    NVSDK_NGX_EParameter_ImageSuperResolution_ScaleFactor_4_3,
+    NVSDK_NGX_EParameter_NumFrames,
+    NVSDK_NGX_EParameter_Scale,
+    NVSDK_NGX_EParameter_Width,
+    NVSDK_NGX_EParameter_Height,
+    NVSDK_NGX_EParameter_OutWidth,
+    NVSDK_NGX_EParameter_OutHeight,
+    NVSDK_NGX_EParameter_Sharpness,
+    NVSDK_NGX_EParameter_Scratch,
+    NVSDK_NGX_EParameter_Scratch_SizeInBytes,
+    NVSDK_NGX_EParameter_EvaluationNode,
+    NVSDK_NGX_EParameter_Input1,
+    NVSDK_NGX_EParameter_Input1_Format,
+    NVSDK_NGX_EParameter_Input1_SizeInBytes,
+    NVSDK_NGX_EParameter_Input2,
+    NVSDK_NGX_EParameter_Input2_Format,
+    NVSDK_NGX_EParameter_Input2_SizeInBytes,
+    NVSDK_NGX_EParameter_Color,
+    NVSDK_NGX_EParameter_Color_Format,
+    NVSDK_NGX_EParameter_Color_SizeInBytes,
+    NVSDK_NGX_EParameter_Albedo,
+    NVSDK_NGX_EParameter_Output,
+    NVSDK_NGX_EParameter_Output_Format,
+    NVSDK_NGX_EParameter_Output_SizeInBytes,
+    NVSDK_NGX_EParameter_Reset,
+    NVSDK_NGX_EParameter_BlendFactor,
+    NVSDK_NGX_EParameter_MotionVectors,
+    NVSDK_NGX_EParameter_Rect_X,
+    NVSDK_NGX_EParameter_Rect_Y,
+    NVSDK_NGX_EParameter_Rect_W,
+    NVSDK_NGX_EParameter_Rect_H,
+    NVSDK_NGX_EParameter_MV_Scale_X,
+    NVSDK_NGX_EParameter_MV_Scale_Y,
+    NVSDK_NGX_EParameter_Model,
+    NVSDK_NGX_EParameter_Format,
+    NVSDK_NGX_EParameter_SizeInBytes,
+    NVSDK_NGX_EParameter_ResourceAllocCallback,
+    NVSDK_NGX_EParameter_BufferAllocCallback,
+    NVSDK_NGX_EParameter_Tex2DAllocCallback,
+    NVSDK_NGX_EParameter_ResourceReleaseCallback,
+    NVSDK_NGX_EParameter_CreationNodeMask,
+    NVSDK_NGX_EParameter_VisibilityNodeMask,
+    NVSDK_NGX_EParameter_PreviousOutput,
+    NVSDK_NGX_EParameter_MV_Offset_X,
+    NVSDK_NGX_EParameter_MV_Offset_Y,
+    NVSDK_NGX_EParameter_Hint_UseFireflySwatter,
+    NVSDK_NGX_EParameter_Resource_Width,
+    NVSDK_NGX_EParameter_Resource_Height,
+    NVSDK_NGX_EParameter_Depth,
+    NVSDK_NGX_EParameter_DLSSOptimalSettingsCallback,
+    NVSDK_NGX_EParameter_PerfQualityValue,
+    NVSDK_NGX_EParameter_RTXValue,
+    NVSDK_NGX_EParameter_DLSSMode,
+    NVSDK_NGX_EParameter_DeepResolve_Available,
+    NVSDK_NGX_EParameter_Deprecated_43,
+    NVSDK_NGX_EParameter_OptLevel,
+    NVSDK_NGX_EParameter_IsDevSnippetBranch,
+    NVSDK_NGX_EParameter_DeepDVC_Available,
+    NVSDK_NGX_EParameter_Graphics_API,
+    NVSDK_NGX_EParameter_Reserved_48,
+    NVSDK_NGX_EParameter_Reserved_49,
+    NVSDK_NGX_Parameter_OptLevel,
+    NVSDK_NGX_Parameter_IsDevSnippetBranch,
+    NVSDK_NGX_Parameter_SuperSampling_ScaleFactor,
+    NVSDK_NGX_Parameter_ImageSignalProcessing_ScaleFactor,
+    NVSDK_NGX_Parameter_SuperSampling_Available,
+    NVSDK_NGX_Parameter_InPainting_Available,
+    NVSDK_NGX_Parameter_ImageSuperResolution_Available,
+    NVSDK_NGX_Parameter_SlowMotion_Available,
+    NVSDK_NGX_Parameter_VideoSuperResolution_Available,
+    NVSDK_NGX_Parameter_ImageSignalProcessing_Available,
+    NVSDK_NGX_Parameter_DeepResolve_Available,
+    NVSDK_NGX_Parameter_SuperSampling_NeedsUpdatedDriver,
+    NVSDK_NGX_Parameter_InPainting_NeedsUpdatedDriver,
+    NVSDK_NGX_Parameter_ImageSuperResolution_NeedsUpdatedDriver,
+    NVSDK_NGX_Parameter_SlowMotion_NeedsUpdatedDriver,
+    NVSDK_NGX_Parameter_VideoSuperResolution_NeedsUpdatedDriver,
+    NVSDK_NGX_Parameter_ImageSignalProcessing_NeedsUpdatedDriver,
+    NVSDK_NGX_Parameter_DeepResolve_NeedsUpdatedDriver,
+    NVSDK_NGX_Parameter_FrameInterpolation_NeedsUpdatedDriver,
+    NVSDK_NGX_Parameter_SuperSampling_MinDriverVersionMajor,
+    NVSDK_NGX_Parameter_InPainting_MinDriverVersionMajor,
+    NVSDK_NGX_Parameter_ImageSuperResolution_MinDriverVersionMajor,
+    NVSDK_NGX_Parameter_SlowMotion_MinDriverVersionMajor,
+    NVSDK_NGX_Parameter_VideoSuperResolution_MinDriverVersionMajor,
+    NVSDK_NGX_Parameter_ImageSignalProcessing_MinDriverVersionMajor,
+    NVSDK_NGX_Parameter_DeepResolve_MinDriverVersionMajor,
+    NVSDK_NGX_Parameter_FrameInterpolation_MinDriverVersionMajor,
+    NVSDK_NGX_Parameter_SuperSampling_MinDriverVersionMinor,
+    NVSDK_NGX_Parameter_InPainting_MinDriverVersionMinor,
+    NVSDK_NGX_Parameter_ImageSuperResolution_MinDriverVersionMinor,
+    NVSDK_NGX_Parameter_SlowMotion_MinDriverVersionMinor,
+    NVSDK_NGX_Parameter_VideoSuperResolution_MinDriverVersionMinor,
+    NVSDK_NGX_Parameter_ImageSignalProcessing_MinDriverVersionMinor,
+    NVSDK_NGX_Parameter_DeepResolve_MinDriverVersionMinor,
+    NVSDK_NGX_Parameter_SuperSampling_FeatureInitResult,
+    NVSDK_NGX_Parameter_InPainting_FeatureInitResult,
+    NVSDK_NGX_Parameter_ImageSuperResolution_FeatureInitResult,
+    NVSDK_NGX_Parameter_SlowMotion_FeatureInitResult,
+    NVSDK_NGX_Parameter_VideoSuperResolution_FeatureInitResult,
+    NVSDK_NGX_Parameter_ImageSignalProcessing_FeatureInitResult,
+    NVSDK_NGX_Parameter_DeepResolve_FeatureInitResult,
+    NVSDK_NGX_Parameter_FrameInterpolation_FeatureInitResult,
+    NVSDK_NGX_Parameter_ImageSuperResolution_ScaleFactor_2_1,
+    NVSDK_NGX_Parameter_ImageSuperResolution_ScaleFactor_3_1,
+    NVSDK_NGX_Parameter_ImageSuperResolution_ScaleFactor_3_2,
+    NVSDK_NGX_Parameter_ImageSuperResolution_ScaleFactor_4_3,
+    NVSDK_NGX_Parameter_NumFrames,
+    NVSDK_NGX_Parameter_Scale,
+    NVSDK_NGX_Parameter_Width,
+    NVSDK_NGX_Parameter_Height,
+    NVSDK_NGX_Parameter_OutWidth,
+    NVSDK_NGX_Parameter_OutHeight,
+    NVSDK_NGX_Parameter_Sharpness,
+    NVSDK_NGX_Parameter_Scratch,
+    NVSDK_NGX_Parameter_Scratch_SizeInBytes,
+    NVSDK_NGX_Parameter_Input1,
+    NVSDK_NGX_Parameter_Input1_Format,
+    NVSDK_NGX_Parameter_Input1_SizeInBytes,
+    NVSDK_NGX_Parameter_Input2,
+    NVSDK_NGX_Parameter_Input2_Format,
+    NVSDK_NGX_Parameter_Input2_SizeInBytes,
+    NVSDK_NGX_Parameter_Color,
+    NVSDK_NGX_Parameter_Color_Format,
+    NVSDK_NGX_Parameter_Color_SizeInBytes,
+    NVSDK_NGX_Parameter_FI_Color1,
+    NVSDK_NGX_Parameter_FI_Color2,
+    NVSDK_NGX_Parameter_Albedo,
+    NVSDK_NGX_Parameter_Output,
+    NVSDK_NGX_Parameter_Output_Format,
+    NVSDK_NGX_Parameter_Output_SizeInBytes,
+    NVSDK_NGX_Parameter_FI_Output1,
+    NVSDK_NGX_Parameter_FI_Output2,
+    NVSDK_NGX_Parameter_FI_Output3,
+    NVSDK_NGX_Parameter_Reset,
+    NVSDK_NGX_Parameter_BlendFactor,
+    NVSDK_NGX_Parameter_MotionVectors,
+    NVSDK_NGX_Parameter_FI_MotionVectors1,
+    NVSDK_NGX_Parameter_FI_MotionVectors2,
+    NVSDK_NGX_Parameter_Rect_X,
+    NVSDK_NGX_Parameter_Rect_Y,
+    NVSDK_NGX_Parameter_Rect_W,
+    NVSDK_NGX_Parameter_Rect_H,
+    NVSDK_NGX_Parameter_OutRect_X,
+    NVSDK_NGX_Parameter_OutRect_Y,
+    NVSDK_NGX_Parameter_OutRect_W,
+    NVSDK_NGX_Parameter_OutRect_H,
+    NVSDK_NGX_Parameter_MV_Scale_X,
+    NVSDK_NGX_Parameter_MV_Scale_Y,
+    NVSDK_NGX_Parameter_Model,
+    NVSDK_NGX_Parameter_Format,
+    NVSDK_NGX_Parameter_SizeInBytes,
+    NVSDK_NGX_Parameter_ResourceAllocCallback,
+    NVSDK_NGX_Parameter_BufferAllocCallback,
+    NVSDK_NGX_Parameter_Tex2DAllocCallback,
+    NVSDK_NGX_Parameter_ResourceReleaseCallback,
+    NVSDK_NGX_Parameter_CreationNodeMask,
+    NVSDK_NGX_Parameter_VisibilityNodeMask,
+    NVSDK_NGX_Parameter_MV_Offset_X,
+    NVSDK_NGX_Parameter_MV_Offset_Y,
+    NVSDK_NGX_Parameter_Hint_UseFireflySwatter,
+    NVSDK_NGX_Parameter_Resource_Width,
+    NVSDK_NGX_Parameter_Resource_Height,
+    NVSDK_NGX_Parameter_Resource_OutWidth,
+    NVSDK_NGX_Parameter_Resource_OutHeight,
+    NVSDK_NGX_Parameter_Depth,
+    NVSDK_NGX_Parameter_FI_Depth1,
+    NVSDK_NGX_Parameter_FI_Depth2,
+    NVSDK_NGX_Parameter_DLSSOptimalSettingsCallback,
+    NVSDK_NGX_Parameter_DLSSGetStatsCallback,
+    NVSDK_NGX_Parameter_PerfQualityValue,
+    NVSDK_NGX_Parameter_RTXValue,
+    NVSDK_NGX_Parameter_DLSSMode,
+    NVSDK_NGX_Parameter_FI_Mode,
+    NVSDK_NGX_Parameter_FI_OF_Preset,
+    NVSDK_NGX_Parameter_FI_OF_GridSize,
+    NVSDK_NGX_Parameter_Jitter_Offset_X,
+    NVSDK_NGX_Parameter_Jitter_Offset_Y,
+    NVSDK_NGX_Parameter_Denoise,
+    NVSDK_NGX_Parameter_TransparencyMask,
+    NVSDK_NGX_Parameter_ExposureTexture,
+    NVSDK_NGX_Parameter_DLSS_Feature_Create_Flags,
+    NVSDK_NGX_Parameter_DLSS_Checkerboard_Jitter_Hack,
+    NVSDK_NGX_Parameter_GBuffer_Normals,
+    NVSDK_NGX_Parameter_GBuffer_Albedo,
+    NVSDK_NGX_Parameter_GBuffer_Roughness,
+    NVSDK_NGX_Parameter_GBuffer_DiffuseAlbedo,
+    NVSDK_NGX_Parameter_GBuffer_SpecularAlbedo,
+    NVSDK_NGX_Parameter_GBuffer_IndirectAlbedo,
+    NVSDK_NGX_Parameter_GBuffer_SpecularMvec,
+    NVSDK_NGX_Parameter_GBuffer_DisocclusionMask,
+    NVSDK_NGX_Parameter_GBuffer_Metallic,
+    NVSDK_NGX_Parameter_GBuffer_Specular,
+    NVSDK_NGX_Parameter_GBuffer_Subsurface,
+    NVSDK_NGX_Parameter_GBuffer_ShadingModelId,
+    NVSDK_NGX_Parameter_GBuffer_MaterialId,
+    NVSDK_NGX_Parameter_GBuffer_Atrrib_8,
+    NVSDK_NGX_Parameter_GBuffer_Atrrib_9,
+    NVSDK_NGX_Parameter_GBuffer_Atrrib_10,
+    NVSDK_NGX_Parameter_GBuffer_Atrrib_11,
+    NVSDK_NGX_Parameter_GBuffer_Atrrib_12,
+    NVSDK_NGX_Parameter_GBuffer_Atrrib_13,
+    NVSDK_NGX_Parameter_GBuffer_Atrrib_14,
+    NVSDK_NGX_Parameter_GBuffer_Atrrib_15,
+    NVSDK_NGX_Parameter_TonemapperType,
+    NVSDK_NGX_Parameter_FreeMemOnReleaseFeature,
+    NVSDK_NGX_Parameter_MotionVectors3D,
+    NVSDK_NGX_Parameter_IsParticleMask,
+    NVSDK_NGX_Parameter_AnimatedTextureMask,
+    NVSDK_NGX_Parameter_DepthHighRes,
+    NVSDK_NGX_Parameter_Position_ViewSpace,
+    NVSDK_NGX_Parameter_FrameTimeDeltaInMsec,
+    NVSDK_NGX_Parameter_RayTracingHitDistance,
+    NVSDK_NGX_Parameter_MotionVectorsReflection,
+    NVSDK_NGX_Parameter_DLSS_Enable_Output_Subrects,
+    NVSDK_NGX_Parameter_DLSS_Input_Color_Subrect_Base_X,
+    NVSDK_NGX_Parameter_DLSS_Input_Color_Subrect_Base_Y,
+    NVSDK_NGX_Parameter_DLSS_Input_Depth_Subrect_Base_X,
+    NVSDK_NGX_Parameter_DLSS_Input_Depth_Subrect_Base_Y,
+    NVSDK_NGX_Parameter_DLSS_Input_MV_SubrectBase_X,
+    NVSDK_NGX_Parameter_DLSS_Input_MV_SubrectBase_Y,
+    NVSDK_NGX_Parameter_DLSS_Input_Translucency_SubrectBase_X,
+    NVSDK_NGX_Parameter_DLSS_Input_Translucency_SubrectBase_Y,
+    NVSDK_NGX_Parameter_DLSS_Output_Subrect_Base_X,
+    NVSDK_NGX_Parameter_DLSS_Output_Subrect_Base_Y,
+    NVSDK_NGX_Parameter_DLSS_Render_Subrect_Dimensions_Width,
+    NVSDK_NGX_Parameter_DLSS_Render_Subrect_Dimensions_Height,
+    NVSDK_NGX_Parameter_DLSS_Pre_Exposure,
+    NVSDK_NGX_Parameter_DLSS_Exposure_Scale,
+    NVSDK_NGX_Parameter_DLSS_Input_Bias_Current_Color_Mask,
+    NVSDK_NGX_Parameter_DLSS_Input_Bias_Current_Color_SubrectBase_X,
+    NVSDK_NGX_Parameter_DLSS_Input_Bias_Current_Color_SubrectBase_Y,
+    NVSDK_NGX_Parameter_DLSS_Indicator_Invert_Y_Axis,
+    NVSDK_NGX_Parameter_DLSS_Indicator_Invert_X_Axis,
+    NVSDK_NGX_Parameter_DLSS_INV_VIEW_PROJECTION_MATRIX,
+    NVSDK_NGX_Parameter_DLSS_CLIP_TO_PREV_CLIP_MATRIX,
+    NVSDK_NGX_Parameter_DLSS_TransparencyLayer,
+    NVSDK_NGX_Parameter_DLSS_TransparencyLayer_Subrect_Base_X,
+    NVSDK_NGX_Parameter_DLSS_TransparencyLayer_Subrect_Base_Y,
+    NVSDK_NGX_Parameter_DLSS_TransparencyLayerOpacity,
+    NVSDK_NGX_Parameter_DLSS_TransparencyLayerOpacity_Subrect_Base_X,
+    NVSDK_NGX_Parameter_DLSS_TransparencyLayerOpacity_Subrect_Base_Y,
+    NVSDK_NGX_Parameter_DLSS_TransparencyLayerMvecs,
+    NVSDK_NGX_Parameter_DLSS_TransparencyLayerMvecs_Subrect_Base_X,
+    NVSDK_NGX_Parameter_DLSS_TransparencyLayerMvecs_Subrect_Base_Y,
+    NVSDK_NGX_Parameter_DLSS_DisocclusionMask,
+    NVSDK_NGX_Parameter_DLSS_DisocclusionMask_Subrect_Base_X,
+    NVSDK_NGX_Parameter_DLSS_DisocclusionMask_Subrect_Base_Y,
+    NVSDK_NGX_Parameter_DLSS_Get_Dynamic_Max_Render_Width,
+    NVSDK_NGX_Parameter_DLSS_Get_Dynamic_Max_Render_Height,
+    NVSDK_NGX_Parameter_DLSS_Get_Dynamic_Min_Render_Width,
+    NVSDK_NGX_Parameter_DLSS_Get_Dynamic_Min_Render_Height,
+    NVSDK_NGX_Parameter_DLSS_Hint_Render_Preset_DLAA,
+    NVSDK_NGX_Parameter_DLSS_Hint_Render_Preset_Quality,
+    NVSDK_NGX_Parameter_DLSS_Hint_Render_Preset_Balanced,
+    NVSDK_NGX_Parameter_DLSS_Hint_Render_Preset_Performance,
+    NVSDK_NGX_Parameter_DLSS_Hint_Render_Preset_UltraPerformance,
+    NVSDK_NGX_Parameter_DLSS_Hint_Render_Preset_UltraQuality,
+
+    // DLSS / DLSSG / FSR extension keys used by games and OptiScaler
+    "DLSS.Denoise.Mode",
+    "DLSS.Roughness.Mode",
+    "DLSS.Use.HW.Depth",
+    "DLSSG.Backbuffer",
+    "DLSSG.CameraFar",
+    "DLSSG.CameraNear",
+    "DLSSG.Depth",
+    "DLSSG.DepthInverted",
+    "DLSSG.DispatchFlags",
+    "DLSSG.HUDLess",
+    "DLSSG.MVecsSubrectHeight",
+    "DLSSG.MVecsSubrectWidth",
+    "DLSSG.MultiFrameCount",
+    "DLSSG.MultiFrameCountMax",
+    "DLSSG.MultiFrameIndex",
+    "DLSSG.ShowDebug",
+    "DLSSG.run_lowres_mvec_pass",
+    "FSR.cameraFar",
+    "FSR.cameraFovAngleVertical",
+    "FSR.cameraNear",
+    "FSR.frameTimeDelta",
+    "FSR.reactive",
+    "FSR.transparencyAndComposition",
+    "FSR.upscaleSize.height",
+    "FSR.upscaleSize.width",
+    "FSR.viewSpaceToMetersFactor",
+    "OptiScaler",
+    "OptiScaler.ParamAllocType",
+    "OptiScaler.SupportsUpscaleSize",
+};
+
+inline constexpr size_t KeyCount = std::size(KnownKeys);
+
+namespace detail
+{
+// Table sizes must be power of two
+inline constexpr size_t SlotCount = 1024;
+inline constexpr size_t BucketCount = 256;
+
+static_assert(KeyCount * 2 <= SlotCount, "Too many known keys, increase SlotCount");
+
+// MSVC stops constant evaluation after /constexpr:steps evaluation steps (the project sets 1000000) with a
+// vague error. Build counts its loop iterations, a few evaluation steps each, and must stay under this budget
+// on every compiler, so a growing key list fails here first. Raise the budget together with /constexpr:steps.
+inline constexpr uint32_t MaxBuildSteps = 20000;
+
+inline constexpr uint64_t Hash(std::string_view key)
+{
+    uint64_t hash = 0xCBF29CE484222325ull;
+
+    for (auto c : key)
+    {
+        hash ^= (uint8_t) c;
+        hash *= 0x100000001B3ull;
+    }
+
+    return hash;
+}
+
+inline constexpr size_t BucketOf(uint64_t hash)
+{
+    // FNV high bits are weak for keys sharing a suffix, mix before taking them
+    hash ^= hash >> 29;
+    hash *= 0xBF58476D1CE4E5B9ull;
+    return (size_t) (hash >> 56) & (BucketCount - 1);
+}
+
+inline constexpr size_t SlotOf(uint64_t hash, uint32_t displacement)
+{
+    auto h1 = (uint32_t) hash;
+    auto h2 = (uint32_t) (hash >> 32) | 1;
+    return (size_t) (h1 + displacement * h2) & (SlotCount - 1);
+}
+
+// Hash and displace perfect hash, every bucket gets a displacement which
+// sends all of its keys to empty slots
+struct PerfectHash
+{
+    std::array<uint16_t, BucketCount> displacement {};
+    std::array<int16_t, SlotCount> keyIndex {};
+    uint32_t steps = 0; // loop iterations of Build
+    bool valid = false;
+};
+
+inline constexpr PerfectHash Build()
+{
+    PerfectHash table;
+    std::array<uint64_t, KeyCount> hashes {};
+    std::array<size_t, BucketCount + 1> bucketStart {};
+    std::array<size_t, KeyCount> bucketKeys {};
+
+    for (auto& index : table.keyIndex)
+        index = -1;
+
+    table.steps += SlotCount;
+
+    for (size_t i = 0; i < KeyCount; i++)
+    {
+        // Duplicate keys share the slot for every displacement, so they fail the build below
+        hashes[i] = Hash(KnownKeys[i]);
+        bucketStart[BucketOf(hashes[i]) + 1]++;
+        table.steps += (uint32_t) KnownKeys[i].size() + 2;
+    }
+
+    // Group key indexes by bucket
+    size_t maxBucketSize = 0;
+    for (size_t bucket = 0; bucket < BucketCount; bucket++)
+    {
+        if (bucketStart[bucket + 1] > maxBucketSize)
+            maxBucketSize = bucketStart[bucket + 1];
+
+        bucketStart[bucket + 1] += bucketStart[bucket];
+    }
+
+    auto fill = bucketStart;
+    for (size_t i = 0; i < KeyCount; i++)
+        bucketKeys[fill[BucketOf(hashes[i])]++] = i;
+
+    table.steps += BucketCount + KeyCount;
+
+    // Place biggest buckets first while the table is still empty
+    for (size_t size = maxBucketSize; size > 0; size--)
+    {
+        table.steps += BucketCount;
+
+        for (size_t bucket = 0; bucket < BucketCount; bucket++)
+        {
+            auto first = bucketStart[bucket];
+
+            if (bucketStart[bucket + 1] - first != size)
+                continue;
+
+            bool placed = false;
+            for (uint32_t d = 0; d < 0x10000 && !placed; d++)
+            {
+                placed = true;
+
+                for (size_t i = 0; i < size && placed; i++)
+                {
+                    auto slot = SlotOf(hashes[bucketKeys[first + i]], d);
+                    table.steps += (uint32_t) i + 1;
+
+                    if (table.keyIndex[slot] >= 0)
+                        placed = false;
+
+                    for (size_t j = 0; j < i && placed; j++)
+                    {
+                        if (SlotOf(hashes[bucketKeys[first + j]], d) == slot)
+                            placed = false;
+                    }
+                }
+
+                if (!placed)
+                    continue;
+
+                table.displacement[bucket] = (uint16_t) d;
+
+                for (size_t i = 0; i < size; i++)
+                    table.keyIndex[SlotOf(hashes[bucketKeys[first + i]], d)] = (int16_t) bucketKeys[first + i];
+            }
+
+            if (!placed)
+                return table;
+        }
+    }
+
+    table.valid = true;
+    return table;
+}
+
+inline constexpr PerfectHash Table = Build();
+static_assert(Table.valid, "Can't build perfect hash for known NGX keys");
+static_assert(Table.steps <= MaxBuildSteps, "Perfect hash build is close to MSVC's constexpr step limit");
+} // namespace detail
+
+// Returns index of key in KnownKeys or -1 for unknown keys
+inline int Find(const char* key)
+{
+    if (key == nullptr)
+        return -1;
+
+    // Hash and measure in one pass
+    uint64_t hash = 0xCBF29CE484222325ull;
+    size_t length = 0;
+
+    for (; key[length] != 0; length++)
+    {
+        hash ^= (uint8_t) key[length];
+        hash *= 0x100000001B3ull;
+    }
+
+    auto slot = detail::SlotOf(hash, detail::Table.displacement[detail::BucketOf(hash)]);
+    auto index = detail::Table.keyIndex[slot];
+
+    if (index < 0)
+        return -1;
+
+    auto& known = KnownKeys[index];
+    if (known.size() != length || memcmp(known.data(), key, length) != 0)
+        return -1;
+
+    return index;
+}
+
+} // namespace ngx_keys
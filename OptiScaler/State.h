@@ -2,12 +2,13 @@
 #include "upscalers/IFeature.h"
 
 #include "misc/Quirks.h"
+#include "misc/FrameStats.h"
+#include "upscaler_time/GpuProfiler.h"
 #include "framegen/IFGFeature_Dx12.h"
 #include <inputs/FG/Streamline_Inputs_Dx12.h>
 #include <inputs/FG/Streamline_Inputs_Sl1_Dx12.h>
 
 #include <set>
-#include <deque>
 #include <mutex>
 #include <sl_dlss_g.h>
 #include <vulkan/vulkan.h>
@@ -264,11 +265,15 @@ class State
     VkInstance VulkanInstance = nullptr;
 
     // Framegraph
-    std::deque<double> upscaleTimes;
-    std::deque<double> frameTimes;
+    frame_stats::History<double, 300> frameTimes;
     double lastFGFrameTime = 0.0;
     double presentFrameTime = 0.0;
-    std::mutex frameTimeMutex;
+
+    // Present, upscaler and FG frame time percentiles for the overlay
+    frame_stats::FrameStats frameStats;
+
+    // Per scope GPU timings, filled by GpuProfilerDx11/Dx12/Vk
+    gpu_profiler::GpuProfiler gpuProfiler;
 
     // Opti checking if everything is setup correctly on game launch
     // Takes effect up to the first time Opti can show anything on the screen
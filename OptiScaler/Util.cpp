@@ -3,6 +3,8 @@
 #include "Util.h"
 #include "Config.h"
 
+#include <misc/FileLocator.h>
+
 #include <proxies/Ntdll_Proxy.h>
 #include <proxies/KernelBase_Proxy.h>
 
@@ -490,40 +492,43 @@ bool Util::IsSubpath(const std::filesystem::path& path, const std::filesystem::p
     return first != "." && first != "..";
 }
 
-std::optional<std::filesystem::path> Util::FindFilePath(const std::filesystem::path& startDir,
-                                                        const std::filesystem::path& fileName)
+#pragma region File locator
+
+static std::mutex _locatorMutex;
+static file_locator::PathCache _pathCache;
+static bool _pathCacheLoaded = false;
+
+// Files which were searched without result in this session
+struct NotFoundFile
 {
-    std::filesystem::path optiPath(Config::Instance()->MainDllPath.value());
-    optiPath /= L"streamline";
-    auto normalizedStreamlinePath = optiPath.lexically_normal();
+    std::filesystem::path Root;
+    std::filesystem::path FileName;
 
-    const bool isDlssgOutput = State::Instance().activeFgOutput == FGOutput::DLSSG ||
-                               State::Instance().activeFgOutput == FGOutput::DLSSGWithNvngx;
+    // Streamline folder is only walked with DLSSG output, a miss without it says nothing about a walk with it
+    bool WithStreamline = false;
+};
 
-    // 1) Direct check in startDir
-    std::filesystem::path candidate = startDir / fileName;
-    if (std::filesystem::exists(candidate) && std::filesystem::is_regular_file(candidate))
-    {
-        LOG_INFO(L"{} found at {}", fileName.wstring(), candidate.parent_path().wstring());
-        return candidate;
-    }
+static std::vector<NotFoundFile> _notFound;
 
-    // 2) Recursive search under startDir
-    for (auto& entry : std::filesystem::recursive_directory_iterator(
-             startDir, std::filesystem::directory_options::skip_permission_denied))
+static std::filesystem::path PathCachePath() { return Util::DllPath().parent_path() / "OptiScaler.pathcache"; }
+
+static bool IsNotFound(const std::filesystem::path& root, const std::filesystem::path& fileName, bool withStreamline)
+{
+    for (auto& notFound : _notFound)
     {
-        if (!entry.is_directory() && entry.path().filename() == fileName)
+        if (notFound.WithStreamline == withStreamline && file_locator::SamePath(notFound.Root, root) &&
+            file_locator::SamePath(notFound.FileName, fileName))
         {
-            auto normalizedPath = entry.path().lexically_normal();
-            if (isDlssgOutput || !IsSubpath(normalizedPath, normalizedStreamlinePath))
-            {
-                LOG_INFO(L"{} found at {}", fileName.wstring(), entry.path().parent_path().wstring());
-                return entry.path();
-            }
+            return true;
         }
     }
 
-    // 3) Unreal-Engine/WinGDK fallback: check for Win64 or WinGDK in parent
+    return false;
+}
+
+// Unreal-Engine/WinGDK fallback: game root above startDir when the exe is in Win64 or WinGDK
+static std::optional<std::filesystem::path> GetFallbackRoot(const std::filesystem::path& startDir)
+{
     std::filesystem::path parent = startDir.parent_path().parent_path();
     uint32_t cnt = 0;
     for (const char* folder : { "Win64", "WinGDK", "Win64MasterMasterSteamPGO" })
@@ -531,37 +536,147 @@ std::optional<std::filesystem::path> Util::FindFilePath(const std::filesystem::p
         if (std::filesystem::exists(parent / folder) && std::filesystem::is_directory(parent / folder))
         {
             // Move up two more levels from 'parent' to reach UE project root but one level for KCD2
-            std::filesystem::path gameRoot;
             if (cnt < 2)
-                gameRoot = parent.parent_path().parent_path();
+                return parent.parent_path().parent_path();
             else
-                gameRoot = parent.parent_path();
+                return parent.parent_path();
+        }
+
+        cnt++;
+    }
+
+    return std::nullopt;
+}
+
+std::vector<std::optional<std::filesystem::path>>
+Util::FindFilePaths(std::span<const std::filesystem::path> startDirs, std::span<const std::filesystem::path> fileNames)
+{
+    std::scoped_lock lock(_locatorMutex);
+
+    std::vector<std::optional<std::filesystem::path>> results(fileNames.size());
+
+    if (!_pathCacheLoaded)
+    {
+        _pathCacheLoaded = true;
+
+        if (_pathCache.Load(PathCachePath()))
+            LOG_DEBUG("Loaded {} path cache entries", _pathCache.Size());
+    }
+
+    std::filesystem::path optiPath(Config::Instance()->MainDllPath.value());
+    optiPath /= L"streamline";
+    auto normalizedStreamlinePath = file_locator::Normalize(optiPath);
+
+    const bool isDlssgOutput = State::Instance().activeFgOutput == FGOutput::DLSSG ||
+                               State::Instance().activeFgOutput == FGOutput::DLSSGWithNvngx;
+
+    file_locator::WalkOptions options {};
+    if (!isDlssgOutput)
+        options.ExcludedDirs.push_back(normalizedStreamlinePath);
+
+    auto isAllowed = [&](const std::filesystem::path& path)
+    { return isDlssgOutput || !IsSubpath(path.lexically_normal(), normalizedStreamlinePath); };
+
+    std::vector<std::filesystem::path> searchedRoots;
 
-            for (auto& entry : std::filesystem::recursive_directory_iterator(
-                     gameRoot, std::filesystem::directory_options::skip_permission_denied))
+    for (auto& startDir : startDirs)
+    {
+        auto root = file_locator::Normalize(startDir);
+
+        // Same folder was already searched (e.g. Opti is next to the exe)
+        bool alreadySearched = false;
+        for (auto& searched : searchedRoots)
+            alreadySearched |= file_locator::SamePath(searched, root);
+
+        if (alreadySearched)
+            continue;
+
+        searchedRoots.push_back(root);
+
+        // Files still missing which need a walk of this root
+        std::vector<size_t> pending;
+
+        for (size_t i = 0; i < fileNames.size(); i++)
+        {
+            if (results[i].has_value())
+                continue;
+
+            // 1) Direct check in startDir
+            std::filesystem::path candidate = startDir / fileNames[i];
+            if (std::filesystem::exists(candidate) && std::filesystem::is_regular_file(candidate))
             {
-                if (!entry.is_directory() && entry.path().filename() == fileName)
-                {
-                    auto normalizedPath = entry.path().lexically_normal();
-                    if (isDlssgOutput || !IsSubpath(normalizedPath, normalizedStreamlinePath))
-                    {
-                        LOG_INFO(L"{} found at {}", fileName.wstring(), entry.path().parent_path().wstring());
-                        return entry.path();
-                    }
-                }
+                results[i] = candidate;
+                continue;
             }
 
-            // If not found under this folder, break to avoid double-search
-            break;
+            // 2) Path found by a previous run, validated with a single stat
+            if (auto cached = _pathCache.Lookup(root, fileNames[i]); cached.has_value() && isAllowed(cached.value()))
+            {
+                results[i] = cached;
+                continue;
+            }
+
+            if (!IsNotFound(root, fileNames[i], isDlssgOutput))
+                pending.push_back(i);
         }
 
-        cnt++;
+        if (pending.empty())
+            continue;
+
+        std::vector<std::filesystem::path> names;
+        std::vector<std::optional<std::filesystem::path>> found(pending.size());
+
+        for (auto index : pending)
+            names.push_back(fileNames[index]);
+
+        // 3) Single recursive walk under startDir for all missing files
+        auto foundCount = file_locator::FindFiles(startDir, names, found, options);
+
+        // 4) Walk the game root, startDir was already searched
+        if (foundCount < pending.size())
+        {
+            if (auto gameRoot = GetFallbackRoot(startDir); gameRoot.has_value())
+            {
+                auto fallbackOptions = options;
+                fallbackOptions.ExcludedDirs.push_back(root);
+                file_locator::FindFiles(gameRoot.value(), names, found, fallbackOptions);
+            }
+        }
+
+        for (size_t i = 0; i < pending.size(); i++)
+        {
+            if (found[i].has_value())
+            {
+                results[pending[i]] = found[i];
+                _pathCache.Store(root, names[i], found[i].value());
+            }
+            else
+            {
+                _notFound.push_back({ root, names[i], isDlssgOutput });
+            }
+        }
     }
 
-    // Not found anywhere
-    return std::nullopt;
+    for (size_t i = 0; i < fileNames.size(); i++)
+    {
+        if (results[i].has_value())
+            LOG_INFO(L"{} found at {}", fileNames[i].wstring(), results[i].value().parent_path().wstring());
+    }
+
+    if (_pathCache.IsDirty() && !_pathCache.Save(PathCachePath()))
+        LOG_DEBUG("Can't save path cache");
+
+    return results;
+}
+
+std::optional<std::filesystem::path> Util::FindFilePath(const std::filesystem::path& startDir,
+                                                        const std::filesystem::path& fileName)
+{
+    return FindFilePaths({ &startDir, 1 }, { &fileName, 1 })[0];
 }
 
+#pragma endregion
+
 int Util::GetActiveRefreshRate(HWND hwnd)
 {
     // Step 1: Get monitor handle
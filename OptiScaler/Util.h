@@ -1,6 +1,9 @@
 #pragma once
 #include "SysUtils.h"
 
+#include <span>
+#include <vector>
+#include <optional>
 #include <filesystem>
 
 #include <dxgi1_6.h>
@@ -84,6 +87,10 @@ void GetExeInfo();
 std::wstring GetWindowTitle(HWND hwnd);
 std::optional<std::filesystem::path> FindFilePath(const std::filesystem::path& startDir,
                                                   const std::filesystem::path& fileName);
+
+// Searches startDirs in order, every folder is walked at most once for all files
+std::vector<std::optional<std::filesystem::path>> FindFilePaths(std::span<const std::filesystem::path> startDirs,
+                                                                std::span<const std::filesystem::path> fileNames);
 std::string WhoIsTheCaller(void* returnAddress);
 HMODULE GetCallerModule(void* returnAddress);
 MonitorInfo GetMonitorInfoForWindow(HWND hwnd);
@@ -47,7 +47,8 @@
 #include <magic_enum.hpp>
 #include <version_check.h>
 #include <misc/IdentifyGpu.h>
-#include <sha1/sha1.hpp>
+#include <misc/ExeHash.h>
+#include <scanner/scanner.h>
 
 static std::vector<HMODULE> _asiHandles;
 static std::vector<std::filesystem::directory_entry> _lateLoadingEntries;
@@ -1322,16 +1323,9 @@ static void CheckQuirks(bool isNvidia)
 
 #ifndef _DEBUG
     // Hash is very slow on Debug builds + we don't need to check our own hashes
+    // Exe is hashed in background, result is logged when ready
     if (Config::Instance()->LogToFile.value_or_default() && Config::Instance()->LogLevel.value_or_default() == 0)
-    {
-        SHA1 checksum;
-        std::ifstream file(Util::ExePath(), std::ios::binary);
-
-        checksum.update(file);
-        const std::string hash = checksum.final();
-
-        LOG_TRACE("Game's Exe SHA1: {}", hash);
-    }
+        ExeHash::Start(Util::ExePath());
 #endif
 
     auto quirks = getQuirksForExe(State::Instance().gameExe);
@@ -1945,19 +1939,20 @@ BOOL APIENTRY DllMain(HMODULE hModule, DWORD ul_reason_for_call, LPVOID lpReserv
             }
         }
 
-        if (!State::Instance().NVNGX_DLSS_Path.has_value())
-            State::Instance().NVNGX_DLSS_Path = Util::FindFilePath(optiDllPath, "nvngx_dlss.dll");
+        // Opti folder first, then exe folder. Each folder is walked once for all files.
+        const std::filesystem::path searchDirs[] = { optiDllPath, exePath };
+        const std::filesystem::path nvngxFiles[] = { "nvngx_dlss.dll", "nvngx_dlssd.dll", "nvngx_dlssg.dll" };
 
-        if (!State::Instance().NVNGX_DLSS_Path.has_value())
-            State::Instance().NVNGX_DLSS_Path = Util::FindFilePath(exePath, "nvngx_dlss.dll");
+        auto nvngxPaths = Util::FindFilePaths(searchDirs, nvngxFiles);
 
-        State::Instance().NVNGX_DLSSD_Path = Util::FindFilePath(optiDllPath, "nvngx_dlssd.dll");
-        if (!State::Instance().NVNGX_DLSSD_Path.has_value())
-            State::Instance().NVNGX_DLSSD_Path = Util::FindFilePath(exePath, "nvngx_dlssd.dll");
+        if (!State::Instance().NVNGX_DLSS_Path.has_value() && nvngxPaths[0].has_value())
+            State::Instance().NVNGX_DLSS_Path = nvngxPaths[0].value();
 
-        State::Instance().NVNGX_DLSSG_Path = Util::FindFilePath(optiDllPath, "nvngx_dlssg.dll");
-        if (!State::Instance().NVNGX_DLSSG_Path.has_value())
-            State::Instance().NVNGX_DLSSG_Path = Util::FindFilePath(exePath, "nvngx_dlssg.dll");
+        if (nvngxPaths[1].has_value())
+            State::Instance().NVNGX_DLSSD_Path = nvngxPaths[1].value();
+
+        if (nvngxPaths[2].has_value())
+            State::Instance().NVNGX_DLSSG_Path = nvngxPaths[2].value();
 
         // Not 100% accurate for Nvidia cards without DLSS
         if (Config::Instance()->DLSSEnabled.value_or_default() && possibleNvidia)
@@ -2106,12 +2101,6 @@ BOOL APIENTRY DllMain(HMODULE hModule, DWORD ul_reason_for_call, LPVOID lpReserv
             Config::Instance()->FGResourceFlip.set_volatile_value(true);
         }
 
-        for (size_t i = 0; i < 300; i++)
-        {
-            State::Instance().frameTimes.push_back(0.0f);
-            State::Instance().upscaleTimes.push_back(0.0f);
-        }
-
         spdlog::info("");
         spdlog::info("Init done");
         spdlog::info("---------------------------------------------");
@@ -2124,6 +2113,8 @@ BOOL APIENTRY DllMain(HMODULE hModule, DWORD ul_reason_for_call, LPVOID lpReserv
 
     case DLL_PROCESS_DETACH:
         State::Instance().isShuttingDown = true;
+        ExeHash::Cancel();
+        scanner::FlushCache();
 
         // Unhooking and cleaning stuff causing issues during shutdown.
         // Disabled for now to check if it cause any issues
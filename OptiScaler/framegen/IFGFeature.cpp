@@ -48,7 +48,7 @@ UINT64 IFGFeature::StartNewFrame()
     auto fIndex = GetIndex();
     LOG_DEBUG("_frameCount: {}, fIndex: {}", _frameCount, fIndex);
 
-    _resourceReady[fIndex].clear();
+    _resourceReady[fIndex].Clear();
     _waitingExecute[fIndex] = false;
 
     _noUi[fIndex] = true;
@@ -65,7 +65,7 @@ bool IFGFeature::IsResourceReady(FG_ResourceType type, int index)
     if (index < 0)
         index = GetIndex();
 
-    return _resourceReady[index].contains(type);
+    return _resourceReady[index].Has(type);
 }
 
 bool IFGFeature::WaitingExecution(int index)
@@ -203,6 +203,20 @@ void IFGFeature::SetJitter(float x, float y, int index)
 
     _jitterX[index] = x;
     _jitterY[index] = y;
+
+    std::scoped_lock lock(_jitterMutex);
+
+    if (_jitterAnalyzedFrame != _frameCount)
+    {
+        _jitterAnalyzedFrame = _frameCount;
+        _jitterAnalyzer.Record(x, y);
+    }
+}
+
+jitter_analysis::Result IFGFeature::JitterAnalysis()
+{
+    std::scoped_lock lock(_jitterMutex);
+    return _jitterAnalyzer.GetResult();
 }
 
 void IFGFeature::SetMVScale(float x, float y, int index)
@@ -318,8 +332,8 @@ void IFGFeature::SetResourceReady(FG_ResourceType type, int index)
     if (index < 0)
         index = GetIndex();
 
-    _resourceReady[index][type] = true;
-    _resourceFrame[type] = _frameCount;
+    _resourceReady[index].Set(type);
+    _resourceFrame[type].store(_frameCount, std::memory_order_relaxed);
 }
 
 UINT IFGFeature::GetInterpolatedFrameCount() { return _framesToInterpolate < 0 ? 1 : _framesToInterpolate; }
@@ -1,9 +1,13 @@
 #pragma once
 #include "SysUtils.h"
 #include <OwnedMutex.h>
+#include "ResourceSlots.h"
+#include <upscalers/JitterAnalyzer.h>
 #include <dxgi1_6.h>
 #include <flag-set-cpp/flag_set.hpp>
 
+#include <mutex>
+
 enum class FG_Flags : uint64_t
 {
     Async,
@@ -49,6 +53,12 @@ class IFGFeature
   protected:
     float _jitterX[BUFFER_COUNT] = {};
     float _jitterY[BUFFER_COUNT] = {};
+
+    // Some inputs set jitter more than once per frame, only first one is analyzed
+    std::mutex _jitterMutex;
+    jitter_analysis::Analyzer _jitterAnalyzer;
+    UINT64 _jitterAnalyzedFrame = 0;
+
     float _mvScaleX[BUFFER_COUNT] = {};
     float _mvScaleY[BUFFER_COUNT] = {};
     float _cameraNear[BUFFER_COUNT] = {};
@@ -77,8 +87,8 @@ class IFGFeature
     UINT64 _targetFrame = 0;
     FG_Constants _constants {};
 
-    std::unordered_map<FG_ResourceType, bool> _resourceReady[BUFFER_COUNT] {};
-    std::unordered_map<FG_ResourceType, UINT64> _resourceFrame {};
+    resource_slots::Flags _resourceReady[BUFFER_COUNT] {};
+    std::atomic<UINT64> _resourceFrame[FG_ResourceType::ResourceTypeCOUNT] {};
 
     bool _noHudless[BUFFER_COUNT] = { true, true, true, true };
     bool _noUi[BUFFER_COUNT] = { true, true, true, true };
@@ -133,6 +143,7 @@ class IFGFeature
 
     void SetFrameCount(UINT64 frameId);
     void SetJitter(float x, float y, int index = -1);
+    jitter_analysis::Result JitterAnalysis();
     void SetMVScale(float x, float y, int index = -1);
     void SetCameraValues(float nearValue, float farValue, float vFov, float aspectRatio, float meterFactor = 0.0f,
                          int index = -1);
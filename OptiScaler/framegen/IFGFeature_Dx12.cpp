@@ -1,5 +1,6 @@
 #include "pch.h"
 #include "IFGFeature_Dx12.h"
+#include "ResourcePool_Dx12.h"
 #include <State.h>
 #include <Config.h>
 
@@ -202,13 +203,7 @@ LockedDx12Resource IFGFeature_Dx12::GetResource(FG_ResourceType type, int index)
 
     std::shared_lock lock(_resourceMutex[index]);
 
-    auto& resources = _frameResources[index];
-
-    auto it = resources.find(type);
-    if (it != resources.end())
-        return { &it->second, std::move(lock) };
-
-    return { nullptr, std::move(lock) };
+    return { _frameResources[index].find(type), std::move(lock) };
 }
 
 void IFGFeature_Dx12::NewFrame()
@@ -306,22 +301,6 @@ bool IFGFeature_Dx12::CreateBufferResourceWithSize(ID3D12Device* device, ID3D12R
     if (depth)
         inDesc.Format = DXGI_FORMAT_R32_FLOAT;
 
-    if (*target != nullptr)
-    {
-        auto bufDesc = (*target)->GetDesc();
-
-        if (bufDesc.Width != width || bufDesc.Height != height || bufDesc.Format != inDesc.Format ||
-            bufDesc.Flags != inDesc.Flags)
-        {
-            (*target)->Release();
-            (*target) = nullptr;
-        }
-        else
-        {
-            return true;
-        }
-    }
-
     D3D12_HEAP_PROPERTIES heapProperties;
     D3D12_HEAP_FLAGS heapFlags;
     HRESULT hr = source->GetHeapProperties(&heapProperties, &heapFlags);
@@ -335,18 +314,7 @@ bool IFGFeature_Dx12::CreateBufferResourceWithSize(ID3D12Device* device, ID3D12R
     inDesc.Width = width;
     inDesc.Height = height;
 
-    hr = device->CreateCommittedResource(&heapProperties, D3D12_HEAP_FLAG_NONE, &inDesc, state, nullptr,
-                                         IID_PPV_ARGS(target));
-
-    if (hr != S_OK)
-    {
-        LOG_ERROR("CreateCommittedResource result: {:X}", (UINT64) hr);
-        return false;
-    }
-
-    LOG_DEBUG("Created new one: {}x{}", inDesc.Width, inDesc.Height);
-
-    return true;
+    return ResourcePoolDx12::Ensure(device, inDesc, heapProperties, state, target);
 }
 
 bool IFGFeature_Dx12::InitCopyCmdList()
@@ -423,41 +391,17 @@ bool IFGFeature_Dx12::CreateBufferResource(ID3D12Device* device, ID3D12Resource*
     if (depth)
         inDesc.Format = DXGI_FORMAT_R32_FLOAT;
 
-    if (*target != nullptr)
-    {
-        //(*target)->Release();
-        //(*target) = nullptr;
-
-        auto bufDesc = (*target)->GetDesc();
-
-        if (bufDesc.Width != inDesc.Width || bufDesc.Height != inDesc.Height || bufDesc.Format != inDesc.Format ||
-            bufDesc.Flags != inDesc.Flags)
-        {
-            (*target)->Release();
-            (*target) = nullptr;
-        }
-        else
-        {
-            return true;
-        }
-    }
-
     D3D12_HEAP_PROPERTIES heapProperties;
     D3D12_HEAP_FLAGS heapFlags;
     auto hr = source->GetHeapProperties(&heapProperties, &heapFlags);
 
-    hr = device->CreateCommittedResource(&heapProperties, D3D12_HEAP_FLAG_NONE, &inDesc, initialState, nullptr,
-                                         IID_PPV_ARGS(target));
-
     if (hr != S_OK)
     {
-        LOG_ERROR("CreateCommittedResource result: {:X}", (UINT64) hr);
+        LOG_ERROR("GetHeapProperties result: {:X}", (UINT64) hr);
         return false;
     }
 
-    LOG_DEBUG("Created new one: {}x{}", inDesc.Width, inDesc.Height);
-
-    return true;
+    return ResourcePoolDx12::Ensure(device, inDesc, heapProperties, initialState, target);
 }
 
 void IFGFeature_Dx12::ResourceBarrier(ID3D12GraphicsCommandList* cmdList, ID3D12Resource* resource,
@@ -475,6 +419,8 @@ void IFGFeature_Dx12::ResourceBarrier(ID3D12GraphicsCommandList* cmdList, ID3D12
     cmdList->ResourceBarrier(1, &barrier);
 }
 
+// Recorded on the game's command list, the source is only valid at this point of the list.
+// A copy queue would need a fence signalled here and a queue can only signal between command lists.
 bool IFGFeature_Dx12::CopyResource(ID3D12GraphicsCommandList* cmdList, ID3D12Resource* source, ID3D12Resource** target,
                                    D3D12_RESOURCE_STATES sourceState)
 {
@@ -76,8 +76,10 @@ class IFGFeature_Dx12 : public virtual IFGFeature
     ID3D12Fence* _uiFence = nullptr;
     HANDLE _uiFenceEvent = nullptr;
 
-    std::unordered_map<FG_ResourceType, Dx12Resource> _frameResources[BUFFER_COUNT] {};
-    std::unordered_map<FG_ResourceType, ID3D12Resource*> _resourceCopy[BUFFER_COUNT] {};
+    resource_slots::Map<FG_ResourceType, Dx12Resource, FG_ResourceType::ResourceTypeCOUNT>
+        _frameResources[BUFFER_COUNT] {};
+    resource_slots::Map<FG_ResourceType, ID3D12Resource*, FG_ResourceType::ResourceTypeCOUNT>
+        _resourceCopy[BUFFER_COUNT] {};
     std::shared_mutex _resourceMutex[BUFFER_COUNT];
 
     std::unique_ptr<RF_Dx12> _mvFlip;
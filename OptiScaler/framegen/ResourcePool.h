@@ -0,0 +1,216 @@
+#pragma once
+
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+// Shared pool for transient FG copy resources.
+// Resources given back are kept and handed out again for the same description once the GPU
+// has passed the fence value of the frame they were released in, unused ones are destroyed after a while.
+// Device is a template parameter, so allocation and lifetime logic can be tested on any OS with a fake device.
+namespace resource_pool
+{
+
+struct Key
+{
+    // Device the resource is created on
+    uint64_t Owner = 0;
+
+    uint32_t Dimension = 0;
+    uint64_t Alignment = 0;
+    uint64_t Width = 0;
+    uint32_t Height = 0;
+    uint16_t DepthOrArraySize = 0;
+    uint16_t MipLevels = 0;
+    uint32_t Format = 0;
+    uint32_t SampleCount = 0;
+    uint32_t SampleQuality = 0;
+    uint32_t Layout = 0;
+    uint32_t Flags = 0;
+
+    uint32_t HeapType = 0;
+    uint32_t HeapCpuPageProperty = 0;
+    uint32_t HeapMemoryPool = 0;
+
+    uint32_t InitialState = 0;
+
+    bool operator==(const Key&) const = default;
+};
+
+struct Stats
+{
+    uint64_t Hits = 0;
+    uint64_t Misses = 0;
+    uint64_t Created = 0;
+    uint64_t Destroyed = 0;
+    uint64_t BytesResident = 0;
+    uint64_t BytesInUse = 0;
+    uint32_t Resident = 0;
+    uint32_t InUse = 0;
+
+    double HitRate() const
+    {
+        auto total = Hits + Misses;
+        return total == 0 ? 0.0 : (double) Hits / (double) total;
+    }
+};
+
+// Device needs:
+//   using Resource = <pointer like handle>;
+//   Resource Create(const Key& key, uint64_t& size); returns Resource {} on failure
+//   void Destroy(Resource resource);
+//   uint64_t CompletedFrame(); last Frame() value the GPU has finished, signalled after each EndFrame
+// Not thread safe.
+template <typename Device> class Pool
+{
+  public:
+    using Resource = typename Device::Resource;
+
+  private:
+    struct Entry
+    {
+        Resource Value {};
+        Key Desc {};
+        uint64_t Size = 0;
+
+        // Fence value which covers the last use
+        uint64_t ReleaseFrame = 0;
+        bool InUse = false;
+    };
+
+    std::vector<Entry> _entries;
+    uint64_t _frame = 0;
+    uint64_t _latency;
+    uint64_t _trimFrames;
+    Stats _stats;
+
+    size_t IndexOf(Resource resource) const
+    {
+        for (size_t i = 0; i < _entries.size(); i++)
+        {
+            if (_entries[i].Value == resource)
+                return i;
+        }
+
+        return SIZE_MAX;
+    }
+
+    void Erase(Device& device, size_t index)
+    {
+        auto& entry = _entries[index];
+        device.Destroy(entry.Value);
+
+        _stats.Destroyed++;
+        _stats.Resident--;
+        _stats.BytesResident -= entry.Size;
+
+        _entries[index] = _entries.back();
+        _entries.pop_back();
+    }
+
+  public:
+    // latency: frames a released resource is kept even after its fence value is reached, for queues
+    // the fence doesn't cover
+    // trimFrames: free resources are destroyed when not used for this many frames
+    explicit Pool(uint64_t latency, uint64_t trimFrames = 300) : _latency(latency), _trimFrames(trimFrames) {}
+
+    Resource Acquire(Device& device, const Key& key)
+    {
+        auto completed = device.CompletedFrame();
+
+        for (auto& entry : _entries)
+        {
+            if (entry.InUse || !(entry.Desc == key) || entry.ReleaseFrame > completed ||
+                entry.ReleaseFrame + _latency > _frame + 1)
+            {
+                continue;
+            }
+
+            entry.InUse = true;
+
+            _stats.Hits++;
+            _stats.InUse++;
+            _stats.BytesInUse += entry.Size;
+
+            return entry.Value;
+        }
+
+        _stats.Misses++;
+
+        uint64_t size = 0;
+        auto resource = device.Create(key, size);
+
+        if (resource == Resource {})
+            return resource;
+
+        _entries.push_back({ resource, key, size, 0, true });
+
+        _stats.Created++;
+        _stats.Resident++;
+        _stats.InUse++;
+        _stats.BytesResident += size;
+        _stats.BytesInUse += size;
+
+        return resource;
+    }
+
+    // Resource goes back to the pool. Work recorded so far is submitted by the end of the frame, so it can be
+    // handed out again once the fence value signalled after the next EndFrame is reached.
+    // Returns false if resource is not from this pool.
+    bool Release(Resource resource)
+    {
+        auto index = IndexOf(resource);
+
+        if (index == SIZE_MAX || !_entries[index].InUse)
+            return false;
+
+        auto& entry = _entries[index];
+        entry.InUse = false;
+        entry.ReleaseFrame = _frame + 1;
+
+        _stats.InUse--;
+        _stats.BytesInUse -= entry.Size;
+
+        return true;
+    }
+
+    bool Owns(Resource resource) const { return IndexOf(resource) != SIZE_MAX; }
+
+    // Advances the frame and destroys free resources which are not used for trimFrames.
+    // Caller signals the new Frame() value on the present queue afterwards
+    void EndFrame(Device& device)
+    {
+        _frame++;
+
+        for (size_t i = 0; i < _entries.size();)
+        {
+            auto& entry = _entries[i];
+
+            if (!entry.InUse && entry.ReleaseFrame + _trimFrames <= _frame &&
+                entry.ReleaseFrame <= device.CompletedFrame())
+                Erase(device, i);
+            else
+                i++;
+        }
+    }
+
+    // Destroys everything, resources in use included
+    void Clear(Device& device)
+    {
+        while (!_entries.empty())
+        {
+            if (_entries.back().InUse)
+            {
+                _stats.InUse--;
+                _stats.BytesInUse -= _entries.back().Size;
+            }
+
+            Erase(device, _entries.size() - 1);
+        }
+    }
+
+    uint64_t Frame() const { return _frame; }
+    const Stats& GetStats() const { return _stats; }
+};
+
+} // namespace resource_pool
@@ -0,0 +1,186 @@
+#include "pch.h"
+#include "ResourcePool_Dx12.h"
+
+struct ResourcePoolDx12::Device
+{
+    using Resource = ID3D12Resource*;
+
+    ID3D12Device* D3D = nullptr;
+
+    // Signalled with the pool frame on the present queue
+    ID3D12Fence* Fence = nullptr;
+    ID3D12Device* FenceDevice = nullptr;
+
+    Resource Create(const resource_pool::Key& key, uint64_t& size)
+    {
+        D3D12_RESOURCE_DESC desc {};
+        desc.Dimension = (D3D12_RESOURCE_DIMENSION) key.Dimension;
+        desc.Alignment = key.Alignment;
+        desc.Width = key.Width;
+        desc.Height = key.Height;
+        desc.DepthOrArraySize = key.DepthOrArraySize;
+        desc.MipLevels = key.MipLevels;
+        desc.Format = (DXGI_FORMAT) key.Format;
+        desc.SampleDesc.Count = key.SampleCount;
+        desc.SampleDesc.Quality = key.SampleQuality;
+        desc.Layout = (D3D12_TEXTURE_LAYOUT) key.Layout;
+        desc.Flags = (D3D12_RESOURCE_FLAGS) key.Flags;
+
+        D3D12_HEAP_PROPERTIES heapProperties {};
+        heapProperties.Type = (D3D12_HEAP_TYPE) key.HeapType;
+        heapProperties.CPUPageProperty = (D3D12_CPU_PAGE_PROPERTY) key.HeapCpuPageProperty;
+        heapProperties.MemoryPoolPreference = (D3D12_MEMORY_POOL) key.HeapMemoryPool;
+
+        ID3D12Resource* resource = nullptr;
+        auto hr = D3D->CreateCommittedResource(&heapProperties, D3D12_HEAP_FLAG_NONE, &desc,
+                                               (D3D12_RESOURCE_STATES) key.InitialState, nullptr,
+                                               IID_PPV_ARGS(&resource));
+
+        if (hr != S_OK)
+        {
+            LOG_ERROR("CreateCommittedResource result: {:X}", (UINT64) hr);
+            return nullptr;
+        }
+
+        size = D3D->GetResourceAllocationInfo(0, 1, &desc).SizeInBytes;
+
+        LOG_DEBUG("Created new one: {}x{}, format: {}, size: {}", desc.Width, desc.Height, (UINT) desc.Format, size);
+        return resource;
+    }
+
+    void Destroy(Resource resource) { resource->Release(); }
+
+    // Without a fence nothing was presented yet, so nothing released is in flight either
+    uint64_t CompletedFrame() { return Fence != nullptr ? Fence->GetCompletedValue() : UINT64_MAX; }
+};
+
+// Frames of FG resource slots, a released resource is not handed out before all of them are done
+static resource_pool::Pool<ResourcePoolDx12::Device> _pool(BUFFER_COUNT + 1);
+static ResourcePoolDx12::Device _device;
+static std::mutex _poolMutex;
+
+static resource_pool::Key MakeKey(const D3D12_RESOURCE_DESC& desc, const D3D12_HEAP_PROPERTIES& heapProperties,
+                                  D3D12_RESOURCE_STATES initialState)
+{
+    resource_pool::Key key;
+    key.Dimension = (uint32_t) desc.Dimension;
+    key.Alignment = desc.Alignment;
+    key.Width = desc.Width;
+    key.Height = desc.Height;
+    key.DepthOrArraySize = desc.DepthOrArraySize;
+    key.MipLevels = desc.MipLevels;
+    key.Format = (uint32_t) desc.Format;
+    key.SampleCount = desc.SampleDesc.Count;
+    key.SampleQuality = desc.SampleDesc.Quality;
+    key.Layout = (uint32_t) desc.Layout;
+    key.Flags = (uint32_t) desc.Flags;
+    key.HeapType = (uint32_t) heapProperties.Type;
+
+    // Only custom heaps use these, others must have them unknown
+    if (heapProperties.Type == D3D12_HEAP_TYPE_CUSTOM)
+    {
+        key.HeapCpuPageProperty = (uint32_t) heapProperties.CPUPageProperty;
+        key.HeapMemoryPool = (uint32_t) heapProperties.MemoryPoolPreference;
+    }
+
+    key.InitialState = (uint32_t) initialState;
+    return key;
+}
+
+bool ResourcePoolDx12::Ensure(ID3D12Device* device, const D3D12_RESOURCE_DESC& desc,
+                              const D3D12_HEAP_PROPERTIES& heapProperties, D3D12_RESOURCE_STATES initialState,
+                              ID3D12Resource** target)
+{
+    if (device == nullptr || target == nullptr)
+        return false;
+
+    if (*target != nullptr)
+    {
+        auto current = (*target)->GetDesc();
+
+        if (current.Width == desc.Width && current.Height == desc.Height && current.Format == desc.Format &&
+            current.Flags == desc.Flags && current.DepthOrArraySize == desc.DepthOrArraySize &&
+            current.MipLevels == desc.MipLevels)
+        {
+            return true;
+        }
+
+        LOG_DEBUG("Release {}x{}, new one: {}x{}", current.Width, current.Height, desc.Width, desc.Height);
+    }
+
+    std::lock_guard<std::mutex> lock(_poolMutex);
+
+    if (*target != nullptr)
+    {
+        // Resources created before the pool are released as before
+        if (!_pool.Release(*target))
+            (*target)->Release();
+
+        *target = nullptr;
+    }
+
+    auto key = MakeKey(desc, heapProperties, initialState);
+    key.Owner = (uint64_t) device;
+
+    _device.D3D = device;
+    *target = _pool.Acquire(_device, key);
+    return *target != nullptr;
+}
+
+void ResourcePoolDx12::Release(ID3D12Resource** target)
+{
+    if (target == nullptr || *target == nullptr)
+        return;
+
+    std::lock_guard<std::mutex> lock(_poolMutex);
+
+    if (!_pool.Release(*target))
+        (*target)->Release();
+
+    *target = nullptr;
+}
+
+void ResourcePoolDx12::EndFrame(ID3D12CommandQueue* queue)
+{
+    if (queue == nullptr)
+        return;
+
+    std::lock_guard<std::mutex> lock(_poolMutex);
+
+    if (_device.D3D == nullptr)
+        return;
+
+    ID3D12Device* queueDevice = nullptr;
+
+    if (queue->GetDevice(IID_PPV_ARGS(&queueDevice)) != S_OK)
+        return;
+
+    // Fence has to be on the device of the queue, work on the previous one is not waited
+    if (_device.FenceDevice != queueDevice)
+    {
+        SAFE_RELEASE(_device.Fence);
+        _device.FenceDevice = queueDevice;
+
+        auto hr = queueDevice->CreateFence(_pool.Frame(), D3D12_FENCE_FLAG_NONE, IID_PPV_ARGS(&_device.Fence));
+
+        if (hr != S_OK)
+        {
+            LOG_ERROR("CreateFence result: {:X}", (UINT64) hr);
+            _device.Fence = nullptr;
+            _device.FenceDevice = nullptr;
+        }
+    }
+
+    queueDevice->Release();
+
+    _pool.EndFrame(_device);
+
+    if (_device.Fence != nullptr)
+        queue->Signal(_device.Fence, _pool.Frame());
+}
+
+resource_pool::Stats ResourcePoolDx12::Stats()
+{
+    std::lock_guard<std::mutex> lock(_poolMutex);
+    return _pool.GetStats();
+}
@@ -0,0 +1,28 @@
+#pragma once
+
+#include "SysUtils.h"
+#include "ResourcePool.h"
+
+#include <d3d12.h>
+
+// Shared pool of committed resources for FG and Hudfix copies
+class ResourcePoolDx12
+{
+  public:
+    // Keeps *target if it already matches desc, otherwise gives it back to the pool
+    // and takes a resource with desc, heap and initial state from the pool
+    static bool Ensure(ID3D12Device* device, const D3D12_RESOURCE_DESC& desc,
+                       const D3D12_HEAP_PROPERTIES& heapProperties, D3D12_RESOURCE_STATES initialState,
+                       ID3D12Resource** target);
+
+    // Gives *target back to the pool and clears it
+    static void Release(ID3D12Resource** target);
+
+    // Call once per present with the queue presenting, released resources are reused after its fence passes them
+    static void EndFrame(ID3D12CommandQueue* queue);
+
+    static resource_pool::Stats Stats();
+
+  private:
+    struct Device;
+};
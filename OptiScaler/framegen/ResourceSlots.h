@@ -0,0 +1,66 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <cstddef>
+
+// Per frame slot storage of FG resources, keyed by a small enum.
+// Values live in a fixed array and an atomic bitmask tells which keys are set,
+// so membership checks and ready flags are single atomic operations without locks.
+// No platform dependencies, so slot lifecycle can be tested on any OS.
+namespace resource_slots
+{
+
+inline constexpr uint32_t Bit(uint32_t index) { return 1u << index; }
+
+// Lock free set of flags, one bit per key
+class Flags
+{
+  private:
+    std::atomic<uint32_t> _mask { 0 };
+
+  public:
+    void Set(uint32_t index) { _mask.fetch_or(Bit(index), std::memory_order_release); }
+    bool Has(uint32_t index) const { return (_mask.load(std::memory_order_acquire) & Bit(index)) != 0; }
+    void Clear() { _mask.store(0, std::memory_order_release); }
+    uint32_t Mask() const { return _mask.load(std::memory_order_acquire); }
+};
+
+// Map like access for the existing call sites.
+// contains() is lock free, writers (operator[] and clear) must be serialized by the caller
+// and readers of the values must hold the same lock in shared mode.
+template <typename Key, typename T, size_t Count> class Map
+{
+    static_assert(Count <= 32, "Keys must fit in the mask");
+
+  private:
+    std::array<T, Count> _values {};
+    Flags _used;
+
+  public:
+    bool contains(Key key) const { return _used.Has((uint32_t) key); }
+
+    // Like std::map, value of a missing key is default constructed and the key is added
+    T& operator[](Key key)
+    {
+        auto index = (uint32_t) key;
+
+        if (!_used.Has(index))
+        {
+            _values[index] = T {};
+            _used.Set(index);
+        }
+
+        return _values[index];
+    }
+
+    T* find(Key key) { return contains(key) ? &_values[(uint32_t) key] : nullptr; }
+
+    // Values are reset lazily when their key is added again
+    void clear() { _used.Clear(); }
+
+    uint32_t mask() const { return _used.Mask(); }
+};
+
+} // namespace resource_slots
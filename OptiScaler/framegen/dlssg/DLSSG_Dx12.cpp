@@ -326,10 +326,7 @@ bool DLSSG_Dx12::Dispatch()
 
     LOG_DEBUG("_frameCount: {}, willDispatchFrame: {}, fIndex: {}", _frameCount, willDispatchFrame, fIndex);
 
-    if (!_resourceReady[fIndex].contains(FG_ResourceType::Depth) ||
-        !_resourceReady[fIndex].at(FG_ResourceType::Depth) ||
-        !_resourceReady[fIndex].contains(FG_ResourceType::Velocity) ||
-        !_resourceReady[fIndex].at(FG_ResourceType::Velocity))
+    if (!IsResourceReady(FG_ResourceType::Depth, fIndex) || !IsResourceReady(FG_ResourceType::Velocity, fIndex))
     {
         LOG_WARN("Depth or Velocity is not ready, skipping");
         return false;
@@ -5,6 +5,7 @@
 
 #include <hudfix/Hudfix_Dx12.h>
 #include <menu/menu_overlay_dx.h>
+#include <upscaler_time/GpuProfiler_Dx12.h>
 
 #include <magic_enum.hpp>
 
@@ -338,10 +339,7 @@ bool FSRFG_Dx12::Dispatch()
 
     LOG_DEBUG("_frameCount: {}, willDispatchFrame: {}, fIndex: {}", _frameCount, willDispatchFrame, fIndex);
 
-    if (!_resourceReady[fIndex].contains(FG_ResourceType::Depth) ||
-        !_resourceReady[fIndex].at(FG_ResourceType::Depth) ||
-        !_resourceReady[fIndex].contains(FG_ResourceType::Velocity) ||
-        !_resourceReady[fIndex].at(FG_ResourceType::Velocity))
+    if (!IsResourceReady(FG_ResourceType::Depth, fIndex) || !IsResourceReady(FG_ResourceType::Velocity, fIndex))
     {
         LOG_WARN("Depth or Velocity is not ready, skipping");
         return false;
@@ -583,7 +581,18 @@ bool FSRFG_Dx12::Dispatch()
 
         dfgPrepare.viewSpaceToMetersFactor = _meterFactor[fIndex];
 
+        // Profiler frames are only fenced on the present queue, timestamps written on
+        // another queue could be read back before they land
+        auto profile = _gameCommandQueue == State::Instance().currentCommandQueue;
+
+        if (profile)
+            GpuProfilerDx12::Begin(_fgCommandList[fIndex], gpu_profiler::Scope::FGDispatch);
+
         retCode = FfxApiProxy::D3D12_Dispatch(&_fgContext, &dfgPrepare.header);
+
+        if (profile)
+            GpuProfilerDx12::End(_fgCommandList[fIndex], gpu_profiler::Scope::FGDispatch);
+
         LOG_DEBUG("D3D12_Dispatch result: {0}, frame: {1}, fIndex: {2}, commandList: {3:X}", retCode, willDispatchFrame,
                   fIndex, (size_t) dfgPrepare.commandList);
 
@@ -1519,7 +1528,7 @@ bool FSRFG_Dx12::SetResource(Dx12Resource* inputResource)
         ID3D12Resource* copyOutput = nullptr;
 
         if (_resourceCopy[fIndex].contains(type))
-            copyOutput = _resourceCopy[fIndex].at(type);
+            copyOutput = _resourceCopy[fIndex][type];
 
         if (!CopyResource(inputResource->cmdList, inputResource->resource, &copyOutput, inputResource->state))
         {
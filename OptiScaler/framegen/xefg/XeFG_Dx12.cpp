@@ -192,7 +192,7 @@ xefg_swapchain_d3d12_resource_data_t XeFG_Dx12::GetResourceData(FG_ResourceType
         return resourceParam;
     }
 
-    auto fResource = &_frameResources[index].at(type);
+    auto fResource = &_frameResources[index][type];
 
     resourceParam.validity = (fResource->validity == FG_ResourceValidity::ValidNow)
                                  ? XEFG_SWAPCHAIN_RV_ONLY_NOW
@@ -731,10 +731,7 @@ bool XeFG_Dx12::Dispatch()
 
     LOG_DEBUG("_frameCount: {}, willDispatchFrame: {}, fIndex: {}", _frameCount, willDispatchFrame, fIndex);
 
-    if (!_resourceReady[fIndex].contains(FG_ResourceType::Depth) ||
-        !_resourceReady[fIndex].at(FG_ResourceType::Depth) ||
-        !_resourceReady[fIndex].contains(FG_ResourceType::Velocity) ||
-        !_resourceReady[fIndex].at(FG_ResourceType::Velocity))
+    if (!IsResourceReady(FG_ResourceType::Depth, fIndex) || !IsResourceReady(FG_ResourceType::Velocity, fIndex))
     {
         LOG_WARN("Depth or Velocity is not ready, skipping");
         return false;
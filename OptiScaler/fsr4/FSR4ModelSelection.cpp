@@ -146,13 +146,47 @@ void FSR4ModelSelection::Hook(HMODULE module, FSR4Source source)
         }
     }
 
+    // Older SDK and Driver use this
+    static const scanner::Pattern modelBlobPattern("83 F9 05 0F 87");
+
+    // From amd_fidelityfx_upscaler_dx12 4.0.3.604 from FFX 2.1 SDK
+    // Used by some versions of SDK and Driver
+    static const scanner::Pattern pattern403(
+        "48 89 5C 24 ? 55 56 57 41 54 41 55 41 56 41 57 48 8D AC 24 ? ? ? ? B8 ? ? ? ? E8 ? ? ? ? 48 2B E0 0F 29 B4 24 "
+        "? ? ? ? 0F 29 BC 24 ? ? ? ? 48 8B 05 ? ? ? ? 48 33 C4 48 89 85 ? ? ? ? 44 8B F2");
+
+    // From amd_fidelityfx_upscaler_dx12 4.1.0 from FFX 2.2 SDK
+    static const scanner::Pattern pattern410(
+        "48 8B C4 48 89 58 18 55 56 57 41 54 41 55 41 56 41 57 48 8D A8 28 F2 FF FF 48 81 EC A0 "
+        "0E 00 00 0F 29 70 B8 0F 29 78 A8 48 8B ? ? ? ? ? 48 33 C4 48 89 85 78 0D 00 00 44 8B F2");
+
+    // From amdxcffx64 2.1.0.968/2.2.0.1328
+    static const scanner::Pattern patternDriver(
+        "48 8B C4 48 89 58 ? 55 56 57 41 54 41 55 41 56 41 57 48 8D A8 ? ? ? ? 48 81 EC ? ? ? ? 0F 29 70 ? 0F "
+        "29 78 ? 48 8B 05 ? ? ? ? 48 33 C4 48 89 85 ? ? ? ? 44 8B F2 48 8B F1 E8");
+
+    // From amdxcffx64 2.3.0 / amd_fidelityfx_upscaler_dx12 4.1.1.2740
+    static const scanner::Pattern pattern411(
+        "48 8B C4 48 89 58 ? 55 56 57 41 54 41 55 41 56 41 57 48 8D A8 ? ? ? ? 48 81 EC ? ? ? ? "
+        "0F 29 70 ? 0F 29 78 ? 48 8B 05 ? ? ? ? 48 33 C4 48 89 85 ? ? ? ? 4D 8B E8 8B FA 48 8B");
+
+    // Scan the module once for every candidate
+    const scanner::Pattern* patterns[] = { &modelBlobPattern, &pattern403,
+                                           source == FSR4Source::SDK ? &pattern410 : &patternDriver, &pattern411 };
+    uintptr_t addresses[std::size(patterns)] = {};
+    scanner::GetAddresses(module, patterns, addresses);
+    scanner::FlushCache();
+
+    const auto modelBlobAddress = addresses[0];
+    const auto address403 = addresses[1];
+    const auto addressFallback = addresses[2];
+    const auto address411 = addresses[3];
+
     /// Hooks for getModelBlob
 
-    // Older SDK and Driver use this
-    const char* modelBlobPattern = "83 F9 05 0F 87";
     if (!o_getModelBlobSDK && source == FSR4Source::SDK)
     {
-        o_getModelBlobSDK = (PFN_getModelBlob) scanner::GetAddress(module, modelBlobPattern);
+        o_getModelBlobSDK = (PFN_getModelBlob) modelBlobAddress;
 
         if (o_getModelBlobSDK)
         {
@@ -173,7 +207,7 @@ void FSR4ModelSelection::Hook(HMODULE module, FSR4Source source)
     }
     else if (!o_getModelBlobDriver && source == FSR4Source::DriverDll)
     {
-        o_getModelBlobDriver = (PFN_getModelBlob) scanner::GetAddress(module, modelBlobPattern);
+        o_getModelBlobDriver = (PFN_getModelBlob) modelBlobAddress;
 
         if (o_getModelBlobDriver)
         {
@@ -195,24 +229,12 @@ void FSR4ModelSelection::Hook(HMODULE module, FSR4Source source)
 
     /// Hooks for createModel
 
-    // From amd_fidelityfx_upscaler_dx12 4.0.3.604 from FFX 2.1 SDK
-    // Used by some versions of SDK and Driver
-    const char* pattern403 =
-        "48 89 5C 24 ? 55 56 57 41 54 41 55 41 56 41 57 48 8D AC 24 ? ? ? ? B8 ? ? ? ? E8 ? ? ? ? 48 2B E0 0F 29 B4 24 "
-        "? ? ? ? 0F 29 BC 24 ? ? ? ? 48 8B 05 ? ? ? ? 48 33 C4 48 89 85 ? ? ? ? 44 8B F2";
-
     if (!o_createModelSDK && source == FSR4Source::SDK)
     {
-        o_createModelSDK = (PFN_createModel) scanner::GetAddress(module, pattern403);
+        o_createModelSDK = (PFN_createModel) address403;
 
         if (!o_createModelSDK)
-        {
-            // From amd_fidelityfx_upscaler_dx12 4.1.0 from FFX 2.2 SDK
-            const char* pattern410 =
-                "48 8B C4 48 89 58 18 55 56 57 41 54 41 55 41 56 41 57 48 8D A8 28 F2 FF FF 48 81 EC A0 "
-                "0E 00 00 0F 29 70 B8 0F 29 78 A8 48 8B ? ? ? ? ? 48 33 C4 48 89 85 78 0D 00 00 44 8B F2";
-            o_createModelSDK = (PFN_createModel) scanner::GetAddress(module, pattern410);
-        }
+            o_createModelSDK = (PFN_createModel) addressFallback;
 
         if (o_createModelSDK)
         {
@@ -233,16 +255,10 @@ void FSR4ModelSelection::Hook(HMODULE module, FSR4Source source)
     }
     else if (!o_createModelDriver && source == FSR4Source::DriverDll)
     {
-        o_createModelDriver = (PFN_createModel) scanner::GetAddress(module, pattern403);
+        o_createModelDriver = (PFN_createModel) address403;
 
         if (!o_createModelDriver)
-        {
-            // From amdxcffx64 2.1.0.968/2.2.0.1328
-            const char* pattern =
-                "48 8B C4 48 89 58 ? 55 56 57 41 54 41 55 41 56 41 57 48 8D A8 ? ? ? ? 48 81 EC ? ? ? ? 0F 29 70 ? 0F "
-                "29 78 ? 48 8B 05 ? ? ? ? 48 33 C4 48 89 85 ? ? ? ? 44 8B F2 48 8B F1 E8";
-            o_createModelDriver = (PFN_createModel) scanner::GetAddress(module, pattern);
-        }
+            o_createModelDriver = (PFN_createModel) addressFallback;
 
         if (o_createModelDriver)
         {
@@ -262,13 +278,9 @@ void FSR4ModelSelection::Hook(HMODULE module, FSR4Source source)
         }
     }
 
-    // From amdxcffx64 2.3.0 / amd_fidelityfx_upscaler_dx12 4.1.1.2740
-    const char* pattern411 = "48 8B C4 48 89 58 ? 55 56 57 41 54 41 55 41 56 41 57 48 8D A8 ? ? ? ? 48 81 EC ? ? ? ? "
-                             "0F 29 70 ? 0F 29 78 ? 48 8B 05 ? ? ? ? 48 33 C4 48 89 85 ? ? ? ? 4D 8B E8 8B FA 48 8B";
-
     if (!o_createModelDriver && !o_createModelDriver2 && source == FSR4Source::DriverDll)
     {
-        o_createModelDriver2 = (PFN_createModel2) scanner::GetAddress(module, pattern411);
+        o_createModelDriver2 = (PFN_createModel2) address411;
 
         if (o_createModelDriver2)
         {
@@ -290,7 +302,7 @@ void FSR4ModelSelection::Hook(HMODULE module, FSR4Source source)
 
     else if (!o_createModelSDK && !o_createModelSDK2 && source == FSR4Source::SDK)
     {
-        o_createModelSDK2 = (PFN_createModel2) scanner::GetAddress(module, pattern411);
+        o_createModelSDK2 = (PFN_createModel2) address411;
 
         if (o_createModelSDK2)
         {
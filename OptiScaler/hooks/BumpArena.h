@@ -0,0 +1,50 @@
+#pragma once
+
+#include <cstdint>
+#include <span>
+#include <vector>
+
+namespace vk_state
+{
+
+// Append only storage which keeps its capacity between recordings.
+// Calls store offsets instead of pointers so state snapshots stay valid after copy.
+template <typename T> struct BumpArena
+{
+    // Don't keep peak memory of an unusually big recording forever
+    static constexpr size_t kTrimCapacity = 64 * 1024;
+
+    std::vector<T> Data;
+
+    uint32_t Push(const T* values, uint32_t count)
+    {
+        auto offset = static_cast<uint32_t>(Data.size());
+        Data.insert(Data.end(), values, values + count);
+        return offset;
+    }
+
+    uint32_t PushDefault(uint32_t count, T value)
+    {
+        auto offset = static_cast<uint32_t>(Data.size());
+        Data.resize(Data.size() + count, value);
+        return offset;
+    }
+
+    std::span<const T> Get(uint32_t offset, uint32_t count) const
+    {
+        if (count == 0 || (size_t) offset + count > Data.size())
+            return {};
+
+        return std::span<const T>(Data.data() + offset, count);
+    }
+
+    void Rewind()
+    {
+        if (Data.capacity() > kTrimCapacity)
+            std::vector<T>().swap(Data);
+        else
+            Data.clear();
+    }
+};
+
+} // namespace vk_state
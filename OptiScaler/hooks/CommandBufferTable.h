@@ -0,0 +1,279 @@
+#pragma once
+
+#include <misc/GracePeriod.h>
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace vk_state
+{
+
+// Open addressing command buffer handle -> entry table.
+// Find is lock free, Insert / Erase must be serialized by the caller.
+// Table grows by publishing a new copy, the old one is freed once no reader can still be probing it.
+template <typename Handle, typename Entry> class HandleTable
+{
+  private:
+    struct Slot
+    {
+        std::atomic<Handle> Key { Handle {} };
+        std::atomic<Entry*> Value { nullptr };
+    };
+
+    struct Table
+    {
+        size_t Mask = 0;
+        size_t Used = 0; // live + tombstones
+        size_t Live = 0;
+        std::unique_ptr<Slot[]> Slots;
+    };
+
+    static constexpr size_t InitialCapacity = 1024;
+
+    inline static const Handle Tombstone = reinterpret_cast<Handle>(~uintptr_t(0));
+
+    std::atomic<Table*> _current { nullptr };
+    std::unique_ptr<Table> _owned;
+
+    // Readers hold a guard while they probe a table
+    mutable grace_period::Domain _readers;
+
+    static size_t Hash(Handle cmd)
+    {
+        // Handles are pointers, mix the bits so aligned addresses spread over the table
+        auto value = (uint64_t) (uintptr_t) cmd;
+        value ^= value >> 33;
+        value *= 0xFF51AFD7ED558CCDull;
+        value ^= value >> 33;
+        return (size_t) value;
+    }
+
+    static std::unique_ptr<Table> MakeTable(size_t capacity)
+    {
+        auto table = std::make_unique<Table>();
+        table->Mask = capacity - 1;
+        table->Slots = std::make_unique<Slot[]>(capacity);
+        return table;
+    }
+
+    static void InsertInto(Table* table, Handle cmd, Entry* entry)
+    {
+        for (size_t i = Hash(cmd) & table->Mask;; i = (i + 1) & table->Mask)
+        {
+            auto& slot = table->Slots[i];
+            auto key = slot.Key.load(std::memory_order_relaxed);
+
+            if (key == Handle {} || key == Tombstone)
+            {
+                // Value first, so a reader matching the key always sees a valid entry
+                slot.Value.store(entry, std::memory_order_release);
+                slot.Key.store(cmd, std::memory_order_release);
+
+                if (key == Handle {})
+                    table->Used++;
+
+                table->Live++;
+                return;
+            }
+        }
+    }
+
+    void Publish(std::unique_ptr<Table> table)
+    {
+        _current.store(table.get(), std::memory_order_seq_cst);
+
+        auto retired = std::move(_owned);
+        _owned = std::move(table);
+
+        // Growing is rare, waiting for the readers here is cheap
+        if (retired != nullptr)
+            _readers.Synchronize();
+    }
+
+    void Rebuild(size_t capacity)
+    {
+        auto current = _current.load(std::memory_order_relaxed);
+        auto table = MakeTable(capacity);
+
+        for (size_t i = 0; i <= current->Mask; i++)
+        {
+            auto key = current->Slots[i].Key.load(std::memory_order_relaxed);
+
+            if (key != Handle {} && key != Tombstone)
+                InsertInto(table.get(), key, current->Slots[i].Value.load(std::memory_order_relaxed));
+        }
+
+        Publish(std::move(table));
+    }
+
+  public:
+    HandleTable() { Publish(MakeTable(InitialCapacity)); }
+    HandleTable(const HandleTable&) = delete;
+    HandleTable& operator=(const HandleTable&) = delete;
+
+    Entry* Find(Handle cmd) const
+    {
+        if (cmd == Handle {})
+            return nullptr;
+
+        auto guard = _readers.Enter();
+        auto table = _current.load(std::memory_order_seq_cst);
+
+        for (size_t i = Hash(cmd) & table->Mask, probes = 0; probes <= table->Mask; i = (i + 1) & table->Mask, probes++)
+        {
+            auto& slot = table->Slots[i];
+            auto key = slot.Key.load(std::memory_order_acquire);
+
+            if (key == cmd)
+                return slot.Value.load(std::memory_order_acquire);
+
+            if (key == Handle {})
+                return nullptr;
+        }
+
+        return nullptr;
+    }
+
+    // Caller must serialize writers and make sure cmd is not already present
+    void Insert(Handle cmd, Entry* entry)
+    {
+        auto table = _current.load(std::memory_order_relaxed);
+
+        // Keep load factor under 50%, grow only when live entries need it
+        if ((table->Used + 1) * 2 > table->Mask + 1)
+        {
+            auto capacity = table->Mask + 1;
+            Rebuild((table->Live + 1) * 4 > capacity ? capacity * 2 : capacity);
+            table = _current.load(std::memory_order_relaxed);
+        }
+
+        InsertInto(table, cmd, entry);
+    }
+
+    // Caller must serialize writers
+    Entry* Erase(Handle cmd)
+    {
+        auto table = _current.load(std::memory_order_relaxed);
+
+        for (size_t i = Hash(cmd) & table->Mask, probes = 0; probes <= table->Mask; i = (i + 1) & table->Mask, probes++)
+        {
+            auto& slot = table->Slots[i];
+            auto key = slot.Key.load(std::memory_order_relaxed);
+
+            if (key == cmd)
+            {
+                auto entry = slot.Value.load(std::memory_order_relaxed);
+                slot.Value.store(nullptr, std::memory_order_release);
+                slot.Key.store(Tombstone, std::memory_order_release);
+                table->Live--;
+                return entry;
+            }
+
+            if (key == Handle {})
+                return nullptr;
+        }
+
+        return nullptr;
+    }
+};
+
+// Entries of the command buffers, looked up through a HandleTable.
+// Entries are recycled and never freed, so a pointer loaded from the table stays valid.
+// StateEntry needs a std::mutex Mutex, the Handle Cmd it belongs to and Recycle(), called with Mutex held when freed.
+template <typename Handle, typename StateEntry> class EntryRegistry
+{
+  private:
+    std::mutex _writeMutex;
+    HandleTable<Handle, StateEntry> _table;
+    std::vector<std::unique_ptr<StateEntry>> _entries;
+    std::vector<StateEntry*> _freeEntries;
+
+  public:
+    struct LockedEntry
+    {
+        StateEntry* Entry;
+        std::unique_lock<std::mutex> Lock;
+    };
+
+    // Serializes entry creation and release, callers can guard their own lists with it too
+    std::mutex& WriteMutex() { return _writeMutex; }
+
+    // Lock free, the entry could be recycled for another command buffer before the caller locks it
+    StateEntry* Find(Handle cmd) const { return _table.Find(cmd); }
+
+    // Entry of cmd with its Mutex held. Lookup doesn't lock, so a racing free could recycle the entry
+    // for another command buffer before we get the lock; Cmd is checked under the lock and the lookup retried
+    LockedEntry Lock(Handle cmd)
+    {
+        while (true)
+        {
+            auto entry = GetOrCreate(cmd);
+            std::unique_lock stateLock(entry->Mutex);
+
+            if (entry->Cmd == cmd)
+                return { entry, std::move(stateLock) };
+        }
+    }
+
+    StateEntry* GetOrCreate(Handle cmd)
+    {
+        // Hot path, every recorded command ends up here
+        if (auto entry = _table.Find(cmd); entry != nullptr)
+            return entry;
+
+        std::scoped_lock lock(_writeMutex);
+
+        if (auto entry = _table.Find(cmd); entry != nullptr)
+            return entry;
+
+        return CreateLocked(cmd);
+    }
+
+    // Following methods expect WriteMutex to be held
+
+    StateEntry* CreateLocked(Handle cmd)
+    {
+        StateEntry* entry;
+
+        if (!_freeEntries.empty())
+        {
+            entry = _freeEntries.back();
+            _freeEntries.pop_back();
+        }
+        else
+        {
+            entry = _entries.emplace_back(std::make_unique<StateEntry>()).get();
+        }
+
+        {
+            std::scoped_lock stateLock(entry->Mutex);
+            entry->Cmd = cmd;
+        }
+
+        _table.Insert(cmd, entry);
+        return entry;
+    }
+
+    void ReleaseLocked(Handle cmd)
+    {
+        auto entry = _table.Erase(cmd);
+        if (entry == nullptr)
+            return;
+
+        {
+            std::scoped_lock stateLock(entry->Mutex);
+            entry->Cmd = Handle {};
+            entry->Recycle();
+        }
+
+        _freeEntries.push_back(entry);
+    }
+
+    // Entries in use and free ones, releasing entries while iterating is fine
+    const std::vector<std::unique_ptr<StateEntry>>& EntriesLocked() const { return _entries; }
+};
+
+} // namespace vk_state
@@ -6,12 +6,16 @@
 
 #include <State.h>
 
+#include <hooks/BumpArena.h>
+#include <hooks/CommandBufferTable.h>
+
 #include <array>
 #include <cstdint>
 #include <cstring>
 #include <mutex>
 #include <unordered_map>
 #include <vector>
+#include <span>
 #include <optional>
 #include <algorithm>
 #include <bitset>
@@ -92,8 +96,12 @@ struct DescriptorBindCall
     VkPipelineLayout Layout = VK_NULL_HANDLE;
     uint32_t FirstSet = 0;
     uint32_t DescriptorSetCount = 0;
-    std::vector<VkDescriptorSet> Sets;    // Store sets dynamically to handle any valid count
-    std::vector<uint32_t> DynamicOffsets; // All dynamic offsets for this call
+
+    // Ranges in owning BindPointState's arenas
+    uint32_t SetsOffset = 0;
+    uint32_t SetsCount = 0;
+    uint32_t DynamicOffsetsOffset = 0;
+    uint32_t DynamicOffsetsCount = 0;
 };
 
 struct PushConstantEntry
@@ -115,7 +123,32 @@ struct BindPointState
     // NEW: Timeline of descriptor bind calls
     std::vector<DescriptorBindCall> DescriptorBindCalls;
 
+    // Backing storage of DescriptorBindCalls
+    BumpArena<VkDescriptorSet> SetArena;
+    BumpArena<uint32_t> DynamicOffsetArena;
+
     BindPointState() { DescriptorBindCalls.reserve(4); }
+
+    std::span<const VkDescriptorSet> CallSets(const DescriptorBindCall& call) const
+    {
+        return SetArena.Get(call.SetsOffset, call.SetsCount);
+    }
+
+    std::span<const uint32_t> CallDynamicOffsets(const DescriptorBindCall& call) const
+    {
+        return DynamicOffsetArena.Get(call.DynamicOffsetsOffset, call.DynamicOffsetsCount);
+    }
+
+    // Clears recorded state but keeps allocations for the next recording
+    void Reset()
+    {
+        Pipeline = VK_NULL_HANDLE;
+        CurrentPipelineLayout = VK_NULL_HANDLE;
+        Sets.fill(DescriptorBinding {});
+        DescriptorBindCalls.clear();
+        SetArena.Rewind();
+        DynamicOffsetArena.Rewind();
+    }
 };
 
 struct DynamicState
@@ -201,16 +234,35 @@ struct CommandBufferState
         PushConstantHistory.reserve(8);
     }
 
+    // Keeps vector capacities, vkBeginCommandBuffer is called thousands of times per frame
     void ResetForNewRecording(uint32_t flags, uint64_t epoch)
     {
-        *this = CommandBufferState {};
+#ifndef LOW_PRECISION_TRACKING
+        ImageLayouts.clear();
+        InRenderPass = false;
+        ActiveRenderPass = VK_NULL_HANDLE;
+        ActiveFramebuffer = VK_NULL_HANDLE;
+#endif
+
+        for (auto& bp : BP)
+            bp.Reset();
+
+        Dyn = DynamicState {};
+        VI = VertexInputState {};
+        PushConstantHistory.clear();
+
         Recording = true;
         HasBegun = true;
         BeginFlags = flags;
         BeginEpoch = epoch;
     }
 
-    void ResetAll() { *this = CommandBufferState {}; }
+    void ResetAll()
+    {
+        ResetForNewRecording(0, 0);
+        Recording = false;
+        HasBegun = false;
+    }
 };
 
 struct ReplayParams
@@ -232,12 +284,33 @@ struct ReplayParams
     bool ReplayComputeToo = false;
 };
 
-struct CommandBufferStateEntry
+struct CommandPoolInfo
+{
+    std::atomic<uint64_t> Epoch { 0 };
+    uint32_t QueueFamily = 0;
+    VkCommandPool Pool = VK_NULL_HANDLE;
+};
+
+// Everything a recorded command needs, kept on its own cache line.
+// Entries are recycled and never freed, so a pointer loaded from the table stays valid;
+// Cmd is checked under Mutex when the entry might have been reused meanwhile.
+struct alignas(64) CommandBufferStateEntry
 {
-    std::shared_ptr<CommandBufferState> State;
     std::mutex Mutex; // Fine-grained lock per command buffer
+    VkCommandBuffer Cmd = VK_NULL_HANDLE;
+    std::atomic<CommandPoolInfo*> Pool { nullptr };
+    std::shared_ptr<CommandBufferState> State = std::make_shared<CommandBufferState>();
+
+    // State keeps its allocations for the next command buffer using this entry
+    void Recycle()
+    {
+        Pool.store(nullptr, std::memory_order_release);
+        State->ResetAll();
+    }
 };
 
+using CommandBufferEntries = EntryRegistry<VkCommandBuffer, CommandBufferStateEntry>;
+
 class CommandBufferStateTracker
 {
   public:
@@ -247,37 +320,18 @@ class CommandBufferStateTracker
     void OnAllocateCommandBuffers(VkCommandPool pool, uint32_t count, const VkCommandBuffer* pCommandBuffers,
                                   uint32_t queueFamilyIndex)
     {
-        // Phase 1: Ensure pool metadata exists (only _poolMetadataMutex)
-        {
-            std::shared_lock poolLock(_poolMetadataMutex);
-            if (_poolToQueueFamily.find(pool) == _poolToQueueFamily.end())
-            {
-                poolLock.unlock();
-
-                std::unique_lock exclusivePoolLock(_poolMetadataMutex);
-                // Double-check after acquiring exclusive lock
-                if (_poolToQueueFamily.find(pool) == _poolToQueueFamily.end())
-                {
-                    _poolToQueueFamily[pool] = queueFamilyIndex;
+        std::scoped_lock lock(_entries.WriteMutex());
 
-                    auto epochIt = _poolEpochs.find(pool);
-                    if (epochIt == _poolEpochs.end())
-                    {
-                        _poolEpochs[pool] = std::make_shared<std::atomic<uint64_t>>(
-                            _globalEpochCounter.load(std::memory_order_acquire));
-                    }
-                }
-            }
-        }
-        // _poolMetadataMutex fully released here before touching _statesMapMutex
+        auto poolInfo = GetOrCreatePoolLocked(pool, queueFamilyIndex);
 
-        // Phase 2: Map command buffers (only _statesMapMutex)
+        for (uint32_t i = 0; i < count; ++i)
         {
-            std::unique_lock mapLock(_statesMapMutex);
-            for (uint32_t i = 0; i < count; ++i)
-            {
-                _cmdBufferToPool[pCommandBuffers[i]] = pool;
-            }
+            auto entry = _entries.Find(pCommandBuffers[i]);
+
+            if (entry == nullptr)
+                entry = _entries.CreateLocked(pCommandBuffers[i]);
+
+            entry->Pool.store(poolInfo, std::memory_order_release);
         }
     }
 
@@ -288,68 +342,13 @@ class CommandBufferStateTracker
 
         const uint32_t flags = (pBeginInfo) ? pBeginInfo->flags : 0;
 
-        // Fast path: Try to get existing entry with read lock
-        std::shared_ptr<CommandBufferStateEntry> entry;
-        {
-            std::shared_lock mapLock(_statesMapMutex);
-            auto it = _states.find(cmd);
-            if (it != _states.end())
-                entry = it->second;
-        }
-
-        // Slow path: Create new entry if needed
-        if (!entry)
-        {
-            std::unique_lock mapLock(_statesMapMutex);
-            auto& entryRef = _states[cmd];
-            if (!entryRef)
-                entryRef = std::make_shared<CommandBufferStateEntry>();
-            entry = entryRef;
-        }
-
-        // Get pool and epoch info (only needs _cmdBufferToPool lock)
-        VkCommandPool pool = VK_NULL_HANDLE;
-        {
-            std::shared_lock mapLock(_statesMapMutex);
-            auto poolIt = _cmdBufferToPool.find(cmd);
-            if (poolIt != _cmdBufferToPool.end())
-                pool = poolIt->second;
-        }
+        // Lock only THIS command buffer's state
+        auto [entry, stateLock] = _entries.Lock(cmd);
 
+        // Pool is part of the entry, epoch is a single atomic read
         uint64_t currentEpoch = 0;
-        if (pool != VK_NULL_HANDLE)
-        {
-            // Lock-free atomic read
-            std::shared_lock poolLock(_poolMetadataMutex);
-            auto epochIt = _poolEpochs.find(pool);
-
-            if (epochIt == _poolEpochs.end())
-            {
-                poolLock.unlock();
-                std::unique_lock exclusiveLock(_poolMetadataMutex);
-
-                // Double-check after exclusive lock
-                epochIt = _poolEpochs.find(pool);
-                if (epochIt == _poolEpochs.end())
-                {
-                    currentEpoch = _globalEpochCounter.load(std::memory_order_acquire);
-                    _poolEpochs[pool] = std::make_shared<std::atomic<uint64_t>>(currentEpoch);
-                }
-                else
-                {
-                    currentEpoch = epochIt->second->load(std::memory_order_acquire);
-                }
-            }
-            else
-            {
-                currentEpoch = epochIt->second->load(std::memory_order_acquire);
-            }
-        }
-
-        // Now lock only THIS command buffer's state
-        std::scoped_lock stateLock(entry->Mutex);
-        if (!entry->State)
-            entry->State = std::make_shared<CommandBufferState>();
+        if (auto poolInfo = entry->Pool.load(std::memory_order_acquire); poolInfo != nullptr)
+            currentEpoch = poolInfo->Epoch.load(std::memory_order_acquire);
 
         entry->State->ResetForNewRecording(flags, currentEpoch);
     }
@@ -359,21 +358,13 @@ class CommandBufferStateTracker
         if (_state->currentFeature == nullptr || !_state->currentFeature->IsWithDx12())
             return;
 
-        // Fast path: get entry with read lock
-        std::shared_ptr<CommandBufferStateEntry> entry;
-        {
-            std::shared_lock mapLock(_statesMapMutex);
-            auto it = _states.find(cmd);
-            if (it != _states.end())
-                entry = it->second;
-        }
-
-        if (!entry)
+        auto entry = _entries.Find(cmd);
+        if (entry == nullptr)
             return;
 
         // Lock only this command buffer's state
         std::scoped_lock stateLock(entry->Mutex);
-        if (entry->State)
+        if (entry->Cmd == cmd)
             entry->State->Recording = false;
     }
 
@@ -382,21 +373,13 @@ class CommandBufferStateTracker
         if (_state->currentFeature == nullptr || !_state->currentFeature->IsWithDx12())
             return;
 
-        // Fast path: get entry with read lock
-        std::shared_ptr<CommandBufferStateEntry> entry;
-        {
-            std::shared_lock mapLock(_statesMapMutex);
-            auto it = _states.find(cmd);
-            if (it != _states.end())
-                entry = it->second;
-        }
-
-        if (!entry)
+        auto entry = _entries.Find(cmd);
+        if (entry == nullptr)
             return;
 
         // Lock only this command buffer's state
         std::scoped_lock stateLock(entry->Mutex);
-        if (entry->State)
+        if (entry->Cmd == cmd)
             entry->State->ResetAll();
     }
 
@@ -408,18 +391,12 @@ class CommandBufferStateTracker
         // Atomic increment - lock-free for the epoch counter
         uint64_t newEpoch = _globalEpochCounter.fetch_add(1, std::memory_order_acq_rel) + 1;
 
-        // Need lock only to access/modify the map itself
-        std::unique_lock poolLock(_poolMetadataMutex);
+        // Need lock only to access/modify the pool map itself
+        std::scoped_lock lock(_entries.WriteMutex());
 
-        auto epochIt = _poolEpochs.find(pool);
-        if (epochIt != _poolEpochs.end())
-        {
-            epochIt->second->store(newEpoch, std::memory_order_release);
-        }
-        else
-        {
-            _poolEpochs[pool] = std::make_shared<std::atomic<uint64_t>>(newEpoch);
-        }
+        auto it = _pools.find(pool);
+        if (it != _pools.end())
+            it->second->Epoch.store(newEpoch, std::memory_order_release);
     }
 
     void OnBindPipeline(VkCommandBuffer cmd, VkPipelineBindPoint bindPoint, VkPipeline pipeline)
@@ -427,29 +404,8 @@ class CommandBufferStateTracker
         if (_state->currentFeature == nullptr || !_state->currentFeature->IsWithDx12())
             return;
 
-        // Fast path: Try to get existing entry with read lock
-        std::shared_ptr<CommandBufferStateEntry> entry;
-        {
-            std::shared_lock mapLock(_statesMapMutex);
-            auto it = _states.find(cmd);
-            if (it != _states.end())
-                entry = it->second;
-        }
-
-        // Slow path: Create new entry if needed
-        if (!entry)
-        {
-            std::unique_lock mapLock(_statesMapMutex);
-            auto& entryRef = _states[cmd];
-            if (!entryRef)
-                entryRef = std::make_shared<CommandBufferStateEntry>();
-            entry = entryRef;
-        }
-
-        // Now lock only THIS command buffer's state
-        std::scoped_lock stateLock(entry->Mutex);
-        if (!entry->State)
-            entry->State = std::make_shared<CommandBufferState>();
+        // Lock only THIS command buffer's state
+        auto [entry, stateLock] = _entries.Lock(cmd);
 
         auto idx = ToIndex(bindPoint);
         if (!idx.has_value())
@@ -465,29 +421,8 @@ class CommandBufferStateTracker
         if (_state->currentFeature == nullptr || !_state->currentFeature->IsWithDx12())
             return;
 
-        // Fast path: Try to get existing entry with read lock
-        std::shared_ptr<CommandBufferStateEntry> entry;
-        {
-            std::shared_lock mapLock(_statesMapMutex);
-            auto it = _states.find(cmd);
-            if (it != _states.end())
-                entry = it->second;
-        }
-
-        // Slow path: Create new entry if needed
-        if (!entry)
-        {
-            std::unique_lock mapLock(_statesMapMutex);
-            auto& entryRef = _states[cmd];
-            if (!entryRef)
-                entryRef = std::make_shared<CommandBufferStateEntry>();
-            entry = entryRef;
-        }
-
-        // Now lock only THIS command buffer's state
-        std::scoped_lock stateLock(entry->Mutex);
-        if (!entry->State)
-            entry->State = std::make_shared<CommandBufferState>();
+        // Lock only THIS command buffer's state
+        auto [entry, stateLock] = _entries.Lock(cmd);
 
         auto idx = ToIndex(bindPoint);
         if (!idx.has_value())
@@ -496,48 +431,41 @@ class CommandBufferStateTracker
         auto& bp = entry->State->BP[static_cast<uint32_t>(*idx)];
         bp.CurrentPipelineLayout = layout;
 
-        // Record the bind call verbatim
+        // Validate pointers are non-null when count > 0, before touching the arenas
+        if (descriptorSetCount > 0 && !pDescriptorSets)
+        {
+            LOG_ERROR("vkCmdBindDescriptorSets called with descriptorSetCount={} but pDescriptorSets=nullptr",
+                      descriptorSetCount);
+            return;
+        }
+
+        if (dynamicOffsetCount > 0 && !pDynamicOffsets)
+        {
+            LOG_ERROR("vkCmdBindDescriptorSets called with dynamicOffsetCount={} but pDynamicOffsets=nullptr",
+                      dynamicOffsetCount);
+            return;
+        }
+
+        // Record the bind call verbatim, sets and offsets are copied into the bind point arenas
         DescriptorBindCall bindCall;
         bindCall.Layout = layout;
         bindCall.FirstSet = firstSet;
         bindCall.DescriptorSetCount = descriptorSetCount;
 
-        // Copy descriptor sets into vector - validate pointer is non-null when count > 0
         if (descriptorSetCount > 0)
         {
-            if (pDescriptorSets)
-            {
-                bindCall.Sets.assign(pDescriptorSets, pDescriptorSets + descriptorSetCount);
-            }
-            else
-            {
-                LOG_ERROR("vkCmdBindDescriptorSets called with descriptorSetCount={} but pDescriptorSets=nullptr",
-                          descriptorSetCount);
-                return;
-            }
-        }
-        else
-        {
-            bindCall.Sets.resize(descriptorSetCount, VK_NULL_HANDLE);
+            bindCall.SetsOffset = bp.SetArena.Push(pDescriptorSets, descriptorSetCount);
+            bindCall.SetsCount = descriptorSetCount;
         }
 
-        // Copy dynamic offsets - validate pointer is non-null when count > 0
         if (dynamicOffsetCount > 0)
         {
-            if (pDynamicOffsets)
-            {
-                bindCall.DynamicOffsets.assign(pDynamicOffsets, pDynamicOffsets + dynamicOffsetCount);
-            }
-            else
-            {
-                LOG_ERROR("vkCmdBindDescriptorSets called with dynamicOffsetCount={} but pDynamicOffsets=nullptr",
-                          dynamicOffsetCount);
-                return;
-            }
+            bindCall.DynamicOffsetsOffset = bp.DynamicOffsetArena.Push(pDynamicOffsets, dynamicOffsetCount);
+            bindCall.DynamicOffsetsCount = dynamicOffsetCount;
         }
 
         uint32_t bindCallIndex = static_cast<uint32_t>(bp.DescriptorBindCalls.size());
-        bp.DescriptorBindCalls.push_back(std::move(bindCall));
+        bp.DescriptorBindCalls.push_back(bindCall);
 
         // Update per-set tracking for quick queries
         for (uint32_t i = 0; i < descriptorSetCount; ++i)
@@ -560,8 +488,7 @@ class CommandBufferStateTracker
         if (_state->currentFeature == nullptr || !_state->currentFeature->IsWithDx12())
             return;
 
-        auto entry = GetOrCreateEntry(cmd, true);
-        std::scoped_lock stateLock(entry->Mutex);
+        auto [entry, stateLock] = _entries.Lock(cmd);
 
         auto idx = ToIndex(bindPoint);
         if (!idx.has_value())
@@ -605,8 +532,7 @@ class CommandBufferStateTracker
             return;
         }
 
-        auto entry = GetOrCreateEntry(cmd, true);
-        std::scoped_lock stateLock(entry->Mutex);
+        auto [entry, stateLock] = _entries.Lock(cmd);
 
         for (uint32_t i = 0; i < count; ++i)
         {
@@ -630,8 +556,7 @@ class CommandBufferStateTracker
             return;
         }
 
-        auto entry = GetOrCreateEntry(cmd, true);
-        std::scoped_lock stateLock(entry->Mutex);
+        auto [entry, stateLock] = _entries.Lock(cmd);
 
         for (uint32_t i = 0; i < count; ++i)
         {
@@ -657,8 +582,7 @@ class CommandBufferStateTracker
             return;
         }
 
-        auto entry = GetOrCreateEntry(cmd, true);
-        std::scoped_lock stateLock(entry->Mutex);
+        auto [entry, stateLock] = _entries.Lock(cmd);
 
         for (uint32_t i = 0; i < count; ++i)
         {
@@ -677,8 +601,7 @@ class CommandBufferStateTracker
         if (_state->currentFeature == nullptr || !_state->currentFeature->IsWithDx12())
             return;
 
-        auto entry = GetOrCreateEntry(cmd, true);
-        std::scoped_lock stateLock(entry->Mutex);
+        auto [entry, stateLock] = _entries.Lock(cmd);
 
         entry->State->VI.IndexBufferValid = true;
         entry->State->VI.IndexBuffer = buffer;
@@ -696,8 +619,7 @@ class CommandBufferStateTracker
         if (_state->currentFeature == nullptr || !_state->currentFeature->IsWithDx12())
             return;
 
-        auto entry = GetOrCreateEntry(cmd, true);
-        std::scoped_lock stateLock(entry->Mutex);
+        auto [entry, stateLock] = _entries.Lock(cmd);
 
         for (uint32_t i = 0; i < imageMemoryBarrierCount; ++i)
         {
@@ -712,8 +634,7 @@ class CommandBufferStateTracker
         if (_state->currentFeature == nullptr || !_state->currentFeature->IsWithDx12())
             return;
 
-        auto entry = GetOrCreateEntry(cmd, true);
-        std::scoped_lock stateLock(entry->Mutex);
+        auto [entry, stateLock] = _entries.Lock(cmd);
 
         entry->State->Dyn.CullMode = cullMode;
         entry->State->Dyn.CullModeSet = true;
@@ -724,8 +645,7 @@ class CommandBufferStateTracker
         if (_state->currentFeature == nullptr || !_state->currentFeature->IsWithDx12())
             return;
 
-        auto entry = GetOrCreateEntry(cmd, true);
-        std::scoped_lock stateLock(entry->Mutex);
+        auto [entry, stateLock] = _entries.Lock(cmd);
 
         entry->State->Dyn.FrontFace = frontFace;
         entry->State->Dyn.FrontFaceSet = true;
@@ -736,8 +656,7 @@ class CommandBufferStateTracker
         if (_state->currentFeature == nullptr || !_state->currentFeature->IsWithDx12())
             return;
 
-        auto entry = GetOrCreateEntry(cmd, true);
-        std::scoped_lock stateLock(entry->Mutex);
+        auto [entry, stateLock] = _entries.Lock(cmd);
 
         entry->State->Dyn.PrimitiveTopology = primitiveTopology;
         entry->State->Dyn.PrimitiveTopologySet = true;
@@ -749,8 +668,7 @@ class CommandBufferStateTracker
         if (_state->currentFeature == nullptr || !_state->currentFeature->IsWithDx12())
             return;
 
-        auto entry = GetOrCreateEntry(cmd, true);
-        std::scoped_lock stateLock(entry->Mutex);
+        auto [entry, stateLock] = _entries.Lock(cmd);
 
         entry->State->Dyn.DepthTestEnable = depthTestEnable;
         entry->State->Dyn.DepthTestEnableSet = true;
@@ -763,8 +681,7 @@ class CommandBufferStateTracker
         if (_state->currentFeature == nullptr || !_state->currentFeature->IsWithDx12())
             return;
 
-        auto entry = GetOrCreateEntry(cmd, true);
-        std::scoped_lock stateLock(entry->Mutex);
+        auto [entry, stateLock] = _entries.Lock(cmd);
 
         entry->State->Dyn.DepthWriteEnable = depthWriteEnable;
         entry->State->Dyn.DepthWriteEnableSet = true;
@@ -777,8 +694,7 @@ class CommandBufferStateTracker
         if (_state->currentFeature == nullptr || !_state->currentFeature->IsWithDx12())
             return;
 
-        auto entry = GetOrCreateEntry(cmd, true);
-        std::scoped_lock stateLock(entry->Mutex);
+        auto [entry, stateLock] = _entries.Lock(cmd);
 
         entry->State->Dyn.DepthCompareOp = depthCompareOp;
         entry->State->Dyn.DepthCompareOpSet = true;
@@ -791,8 +707,7 @@ class CommandBufferStateTracker
         if (_state->currentFeature == nullptr || !_state->currentFeature->IsWithDx12())
             return;
 
-        auto entry = GetOrCreateEntry(cmd, true);
-        std::scoped_lock stateLock(entry->Mutex);
+        auto [entry, stateLock] = _entries.Lock(cmd);
 
         entry->State->Dyn.DepthBoundsTestEnable = depthBoundsTestEnable;
         entry->State->Dyn.DepthBoundsTestEnableSet = true;
@@ -805,8 +720,7 @@ class CommandBufferStateTracker
         if (_state->currentFeature == nullptr || !_state->currentFeature->IsWithDx12())
             return;
 
-        auto entry = GetOrCreateEntry(cmd, true);
-        std::scoped_lock stateLock(entry->Mutex);
+        auto [entry, stateLock] = _entries.Lock(cmd);
 
         entry->State->Dyn.StencilTestEnable = stencilTestEnable;
         entry->State->Dyn.StencilTestEnableSet = true;
@@ -820,8 +734,7 @@ class CommandBufferStateTracker
         if (_state->currentFeature == nullptr || !_state->currentFeature->IsWithDx12())
             return;
 
-        auto entry = GetOrCreateEntry(cmd, true);
-        std::scoped_lock stateLock(entry->Mutex);
+        auto [entry, stateLock] = _entries.Lock(cmd);
 
         entry->State->Dyn.StencilOpFaceMask = faceMask;
         entry->State->Dyn.StencilFailOp = failOp;
@@ -839,8 +752,7 @@ class CommandBufferStateTracker
         if (_state->currentFeature == nullptr || !_state->currentFeature->IsWithDx12())
             return;
 
-        auto entry = GetOrCreateEntry(cmd, true);
-        std::scoped_lock stateLock(entry->Mutex);
+        auto [entry, stateLock] = _entries.Lock(cmd);
 
         entry->State->InRenderPass = true;
         entry->State->ActiveRenderPass = pRenderPassBegin ? pRenderPassBegin->renderPass : VK_NULL_HANDLE;
@@ -854,8 +766,7 @@ class CommandBufferStateTracker
         if (_state->currentFeature == nullptr || !_state->currentFeature->IsWithDx12())
             return;
 
-        auto entry = GetOrCreateEntry(cmd, true);
-        std::scoped_lock stateLock(entry->Mutex);
+        auto [entry, stateLock] = _entries.Lock(cmd);
 
         entry->State->InRenderPass = false;
 #endif
@@ -863,18 +774,15 @@ class CommandBufferStateTracker
 
     void OnCommandBufferDestroyed(VkCommandBuffer cmd)
     {
-        std::unique_lock lock(_statesMapMutex);
-        _states.erase(cmd);
+        std::scoped_lock lock(_entries.WriteMutex());
+        _entries.ReleaseLocked(cmd);
     }
 
     void OnFreeCommandBuffers(VkCommandPool pool, uint32_t count, const VkCommandBuffer* pCommandBuffers)
     {
-        std::unique_lock lock(_statesMapMutex);
+        std::scoped_lock lock(_entries.WriteMutex());
         for (uint32_t i = 0; i < count; ++i)
-        {
-            _states.erase(pCommandBuffers[i]);
-            _cmdBufferToPool.erase(pCommandBuffers[i]);
-        }
+            _entries.ReleaseLocked(pCommandBuffers[i]);
 
         // LOG_DEBUG("Freed {} command buffers from pool {:X}", count, (size_t) pool);
     }
@@ -885,24 +793,25 @@ class CommandBufferStateTracker
         if (_state->currentFeature == nullptr || !_state->currentFeature->IsWithDx12())
             return;
 
-        std::unique_lock poolLock(_poolMetadataMutex);
-        std::unique_lock mapLock(_statesMapMutex);
+        std::scoped_lock lock(_entries.WriteMutex());
+
+        auto it = _pools.find(pool);
+        if (it == _pools.end())
+            return;
+
+        auto poolInfo = it->second;
 
         // Remove all command buffers allocated from this pool
-        for (auto it = _cmdBufferToPool.begin(); it != _cmdBufferToPool.end();)
+        for (auto& entry : _entries.EntriesLocked())
         {
-            if (it->second == pool)
-            {
-                _states.erase(it->first);
-                it = _cmdBufferToPool.erase(it);
-            }
-            else
-            {
-                ++it;
-            }
+            if (entry->Cmd != VK_NULL_HANDLE && entry->Pool.load(std::memory_order_relaxed) == poolInfo)
+                _entries.ReleaseLocked(entry->Cmd);
         }
 
-        _poolEpochs.erase(pool);
+        // Pool info stays alive, a reader might still hold it through an entry
+        _pools.erase(it);
+        _freePools.push_back(poolInfo);
+
         LOG_DEBUG("Pool {:X} destroyed - removed all associated command buffers", (size_t) pool);
     }
 
@@ -1016,31 +925,16 @@ class CommandBufferStateTracker
 
     std::optional<uint32_t> GetCommandBufferQueueFamily(VkCommandBuffer cmd) const
     {
-        // Phase 1: Get pool handle (only _statesMapMutex)
-        VkCommandPool pool = VK_NULL_HANDLE;
-        {
-            std::shared_lock mapLock(_statesMapMutex);
-            auto poolIt = _cmdBufferToPool.find(cmd);
-            if (poolIt == _cmdBufferToPool.end())
-            {
-                LOG_WARN("Command buffer {:X} not tracked in any pool", (size_t) cmd);
-                return std::nullopt;
-            }
-            pool = poolIt->second;
-        }
-        // _statesMapMutex fully released here before touching _poolMetadataMutex
+        auto entry = _entries.Find(cmd);
+        auto poolInfo = entry != nullptr ? entry->Pool.load(std::memory_order_acquire) : nullptr;
 
-        // Phase 2: Get queue family (only _poolMetadataMutex)
+        if (poolInfo == nullptr)
         {
-            std::shared_lock poolLock(_poolMetadataMutex);
-            auto familyIt = _poolToQueueFamily.find(pool);
-            if (familyIt == _poolToQueueFamily.end())
-            {
-                LOG_WARN("Pool {:X} has no queue family info", (size_t) pool);
-                return std::nullopt;
-            }
-            return familyIt->second;
+            LOG_WARN("Command buffer {:X} not tracked in any pool", (size_t) cmd);
+            return std::nullopt;
         }
+
+        return poolInfo->QueueFamily;
     }
 
   private:
@@ -1140,29 +1034,31 @@ class CommandBufferStateTracker
             if (!layoutToUse)
                 continue;
 
+            const auto callSets = bindPoint.CallSets(call);
+            const auto callDynamicOffsets = bindPoint.CallDynamicOffsets(call);
+
             // Validate consistency between DescriptorSetCount and Sets.size()
-            if (call.DescriptorSetCount > call.Sets.size())
+            if (call.DescriptorSetCount > callSets.size())
             {
                 LOG_ERROR("Descriptor set call {} has count={} but Sets.size()={} - skipping to avoid driver crash",
-                          callIdx, call.DescriptorSetCount, call.Sets.size());
+                          callIdx, call.DescriptorSetCount, callSets.size());
                 continue;
             }
 
             // CRITICAL: If this call has dynamic offsets, we MUST replay it verbatim (no slicing)
             // Dynamic offsets are paired with descriptor sets in a complex way that requires
             // pipeline layout introspection to understand - without that, slicing is unsafe
-            if (!call.DynamicOffsets.empty())
+            if (!callDynamicOffsets.empty())
             {
                 // Additional safety check for verbatim replay path
-                const VkDescriptorSet* pSetsToUse = (call.DescriptorSetCount > 0) ? call.Sets.data() : nullptr;
+                const VkDescriptorSet* pSetsToUse = (call.DescriptorSetCount > 0) ? callSets.data() : nullptr;
 
                 // Replay the entire original call verbatim
                 fns.CmdBindDescriptorSets(dstCmd, bindPointType, layoutToUse, call.FirstSet, call.DescriptorSetCount,
-                                          pSetsToUse, (uint32_t) call.DynamicOffsets.size(),
-                                          call.DynamicOffsets.data());
+                                          pSetsToUse, (uint32_t) callDynamicOffsets.size(), callDynamicOffsets.data());
 
                 LOG_DEBUG("Replayed descriptor set call {} verbatim (has {} dynamic offsets, firstSet={}, count={})",
-                          callIdx, call.DynamicOffsets.size(), call.FirstSet, call.DescriptorSetCount);
+                          callIdx, callDynamicOffsets.size(), call.FirstSet, call.DescriptorSetCount);
                 continue;
             }
 
@@ -1229,15 +1125,15 @@ class CommandBufferStateTracker
 
                     uint32_t setIndexInCall = absoluteSetIdx - call.FirstSet;
 
-                    if (setIndexInCall >= call.Sets.size())
+                    if (setIndexInCall >= callSets.size())
                     {
                         LOG_ERROR("Set index {} maps to out-of-bounds call array index {} (size {})", absoluteSetIdx,
-                                  setIndexInCall, call.Sets.size());
+                                  setIndexInCall, callSets.size());
                         allValid = false;
                         break;
                     }
 
-                    setsToRebind.push_back(call.Sets[setIndexInCall]);
+                    setsToRebind.push_back(callSets[setIndexInCall]);
                 }
 
                 // Replay this contiguous range if all sets were valid
@@ -1368,48 +1264,26 @@ class CommandBufferStateTracker
 
     bool TryGetSnapshot(VkCommandBuffer cmd, CommandBufferState& out) const
     {
-        // Get entry with read lock
-        std::shared_ptr<CommandBufferStateEntry> entry;
-        {
-            std::shared_lock mapLock(_statesMapMutex);
-            auto it = _states.find(cmd);
-            if (it == _states.end())
-                return false;
-            entry = it->second;
-        }
-
-        if (!entry)
+        auto entry = _entries.Find(cmd);
+        if (entry == nullptr)
             return false;
 
-        // Get pool info
-        VkCommandPool pool = VK_NULL_HANDLE;
-        {
-            std::shared_lock mapLock(_statesMapMutex);
-            auto poolIt = _cmdBufferToPool.find(cmd);
-            if (poolIt == _cmdBufferToPool.end())
-            {
-                LOG_WARN("Command buffer {:p} not tracked in any pool", (void*) cmd);
-                return false;
-            }
-            pool = poolIt->second;
-        }
+        // Lock THIS command buffer's state for snapshot
+        std::scoped_lock stateLock(entry->Mutex);
+
+        // Entry might have been recycled for another command buffer after the lookup
+        if (entry->Cmd != cmd)
+            return false;
 
-        // Lock-free atomic read
-        std::shared_lock poolLock(_poolMetadataMutex);
-        auto epochIt = _poolEpochs.find(pool);
-        if (epochIt == _poolEpochs.end())
+        auto poolInfo = entry->Pool.load(std::memory_order_acquire);
+        if (poolInfo == nullptr)
         {
-            LOG_ERROR("Pool {:X} has no epoch entry", (size_t) pool);
+            LOG_WARN("Command buffer {:p} not tracked in any pool", (void*) cmd);
             return false;
         }
 
-        uint64_t currentPoolEpoch = epochIt->second->load(std::memory_order_acquire);
-        poolLock.unlock();
-
-        // Lock THIS command buffer's state for snapshot
-        std::scoped_lock stateLock(entry->Mutex);
-        if (!entry->State)
-            return false;
+        auto pool = poolInfo->Pool;
+        uint64_t currentPoolEpoch = poolInfo->Epoch.load(std::memory_order_acquire);
 
         if (entry->State->BeginEpoch < currentPoolEpoch)
         {
@@ -1429,61 +1303,35 @@ class CommandBufferStateTracker
 
         // Capture state from source command buffer
         {
-            // Get entry with read lock
-            std::shared_ptr<CommandBufferStateEntry> entry;
-            {
-                std::shared_lock mapLock(_statesMapMutex);
-                auto it = _states.find(srcCmd);
-                if (it == _states.end())
-                {
-                    LOG_WARN("Can't found captured state for command buffer {:p}", (void*) srcCmd);
-                    return false;
-                }
-                entry = it->second;
-            }
-
-            if (!entry)
+            auto entry = _entries.Find(srcCmd);
+            if (entry == nullptr)
             {
-                LOG_WARN("Captured state is empty for command buffer {:p}", (void*) srcCmd);
+                LOG_WARN("Can't found captured state for command buffer {:p}", (void*) srcCmd);
                 return false;
             }
 
-            // Get pool info
-            VkCommandPool pool = VK_NULL_HANDLE;
-            {
-                std::shared_lock mapLock(_statesMapMutex);
-                auto poolIt = _cmdBufferToPool.find(srcCmd);
-                if (poolIt == _cmdBufferToPool.end())
-                {
-                    LOG_WARN("Command buffer {:p} not tracked in any pool (allocation hook missed?). "
-                             "Cannot validate epoch - refusing replay for safety.",
-                             (void*) srcCmd);
-                    return false;
-                }
-                pool = poolIt->second;
-            }
+            // Lock THIS command buffer's state for deep copy
+            std::scoped_lock stateLock(entry->Mutex);
 
-            // Lock-free atomic read
-            std::shared_lock poolLock(_poolMetadataMutex);
-            auto epochIt = _poolEpochs.find(pool);
-            if (epochIt == _poolEpochs.end())
+            // Entry might have been recycled for another command buffer after the lookup
+            if (entry->Cmd != srcCmd)
             {
-                LOG_ERROR("Pool {:X} for command buffer {:p} has no epoch entry. Internal state corruption?",
-                          (size_t) pool, (void*) srcCmd);
+                LOG_WARN("Can't found captured state for command buffer {:p}", (void*) srcCmd);
                 return false;
             }
 
-            uint64_t currentPoolEpoch = epochIt->second->load(std::memory_order_acquire);
-            poolLock.unlock();
-
-            // Lock THIS command buffer's state for deep copy
-            std::scoped_lock stateLock(entry->Mutex);
-            if (!entry->State)
+            auto poolInfo = entry->Pool.load(std::memory_order_acquire);
+            if (poolInfo == nullptr)
             {
-                LOG_WARN("Captured state is empty for command buffer {:p}", (void*) srcCmd);
+                LOG_WARN("Command buffer {:p} not tracked in any pool (allocation hook missed?). "
+                         "Cannot validate epoch - refusing replay for safety.",
+                         (void*) srcCmd);
                 return false;
             }
 
+            auto pool = poolInfo->Pool;
+            uint64_t currentPoolEpoch = poolInfo->Epoch.load(std::memory_order_acquire);
+
             if (entry->State->BeginEpoch < currentPoolEpoch)
             {
                 LOG_WARN("Command buffer {:p} has stale state (epoch {} < pool {:X} epoch {}), refusing replay. "
@@ -1541,39 +1389,41 @@ class CommandBufferStateTracker
                     if (!call.Layout || call.DescriptorSetCount == 0)
                         continue;
 
+                    const auto callSets = comp.CallSets(call);
+                    const auto callDynamicOffsets = comp.CallDynamicOffsets(call);
+
                     // Validate consistency before replay
-                    if (call.DescriptorSetCount > call.Sets.size())
+                    if (call.DescriptorSetCount > callSets.size())
                     {
                         LOG_ERROR("Compute descriptor set call has count={} but Sets.size()={} - skipping",
-                                  call.DescriptorSetCount, call.Sets.size());
+                                  call.DescriptorSetCount, callSets.size());
                         continue;
                     }
 
                     // Sanity check: validate dynamic offset data consistency
-                    if (!call.DynamicOffsets.empty() && call.DescriptorSetCount == 0)
+                    if (!callDynamicOffsets.empty() && call.DescriptorSetCount == 0)
                     {
                         LOG_WARN("Compute bind call has {} dynamic offsets but zero sets (firstSet={}) - possible "
                                  "corruption, skipping",
-                                 call.DynamicOffsets.size(), call.FirstSet);
+                                 callDynamicOffsets.size(), call.FirstSet);
                         continue;
                     }
 
                     // Additional safety: cap dynamic offset count to avoid pathological driver behavior
                     constexpr uint32_t kMaxSaneDynamicOffsets = 1024; // Generous upper bound
-                    if (call.DynamicOffsets.size() > kMaxSaneDynamicOffsets)
+                    if (callDynamicOffsets.size() > kMaxSaneDynamicOffsets)
                     {
                         LOG_ERROR("Compute bind call has {} dynamic offsets (exceeds sanity limit of {}) - possible "
                                   "corruption, skipping",
-                                  call.DynamicOffsets.size(), kMaxSaneDynamicOffsets);
+                                  callDynamicOffsets.size(), kMaxSaneDynamicOffsets);
                         continue;
                     }
 
-                    const VkDescriptorSet* pSets = call.Sets.data();
-                    const uint32_t* pDynamicOffsets =
-                        call.DynamicOffsets.empty() ? nullptr : call.DynamicOffsets.data();
+                    const VkDescriptorSet* pSets = callSets.data();
+                    const uint32_t* pDynamicOffsets = callDynamicOffsets.empty() ? nullptr : callDynamicOffsets.data();
 
                     fns.CmdBindDescriptorSets(dstCmd, VK_PIPELINE_BIND_POINT_COMPUTE, call.Layout, call.FirstSet,
-                                              call.DescriptorSetCount, pSets, (uint32_t) call.DynamicOffsets.size(),
+                                              call.DescriptorSetCount, pSets, (uint32_t) callDynamicOffsets.size(),
                                               pDynamicOffsets);
                 }
             }
@@ -1657,40 +1507,42 @@ class CommandBufferStateTracker
         return true;
     }
 
-    std::shared_ptr<CommandBufferStateEntry> GetOrCreateEntry(VkCommandBuffer cmd, bool createState = true)
+    // Expects the write mutex of _entries to be held
+
+    CommandPoolInfo* GetOrCreatePoolLocked(VkCommandPool pool, uint32_t queueFamilyIndex)
     {
-        {
-            std::shared_lock mapLock(_statesMapMutex);
-            auto it = _states.find(cmd);
-            if (it != _states.end())
-                return it->second;
-        }
+        auto& poolInfo = _pools[pool];
 
-        std::unique_lock mapLock(_statesMapMutex);
-        auto it = _states.find(cmd);
-        if (it != _states.end())
-            return it->second;
+        if (poolInfo == nullptr)
+        {
+            if (!_freePools.empty())
+            {
+                poolInfo = _freePools.back();
+                _freePools.pop_back();
+            }
+            else
+            {
+                poolInfo = _poolStorage.emplace_back(std::make_unique<CommandPoolInfo>()).get();
+            }
 
-        auto entry = std::make_shared<CommandBufferStateEntry>();
-        if (createState)
-            entry->State = std::make_shared<CommandBufferState>();
+            poolInfo->Pool = pool;
+            poolInfo->QueueFamily = queueFamilyIndex;
+            poolInfo->Epoch.store(_globalEpochCounter.load(std::memory_order_acquire), std::memory_order_release);
+        }
 
-        _states[cmd] = entry;
-        return entry;
+        return poolInfo;
     }
 
-    mutable std::shared_mutex _poolMetadataMutex; // Separate lock for pool metadata
-    mutable std::shared_mutex _statesMapMutex;    // Only for map structure modifications
-
-    std::unordered_map<VkCommandBuffer, std::shared_ptr<CommandBufferStateEntry>> _states;
+    // Its write mutex serializes entry and pool list modifications
+    CommandBufferEntries _entries;
 
     VulkanCmdFns _cachedFns {};
     bool _hasCachedFns = false;
 
     // Per-pool epoch tracking for accurate invalidation
-    std::unordered_map<VkCommandBuffer, VkCommandPool> _cmdBufferToPool;
-    std::unordered_map<VkCommandPool, uint32_t> _poolToQueueFamily;
-    std::unordered_map<VkCommandPool, std::shared_ptr<std::atomic<uint64_t>>> _poolEpochs;
+    std::unordered_map<VkCommandPool, CommandPoolInfo*> _pools;
+    std::vector<std::unique_ptr<CommandPoolInfo>> _poolStorage;
+    std::vector<CommandPoolInfo*> _freePools;
     std::atomic<uint64_t> _globalEpochCounter { 1 };
 };
 } // namespace vk_state
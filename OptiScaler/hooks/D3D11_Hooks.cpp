@@ -16,6 +16,8 @@
 
 #include "Hook_Utils.h"
 
+#include <shaders/Shader_Common.h>
+
 #pragma intrinsic(_ReturnAddress)
 
 bool _skipDx11Create = false;
@@ -162,6 +164,7 @@ static HRESULT hkD3D11On12CreateDevice(IUnknown* pDevice, UINT Flags, const D3D_
     {
         LOG_INFO("Device captured, D3D11Device: {0:X}", (UINT64) *ppDevice);
         HookToDeviceLocal(*ppDevice);
+        WarmupDx11Shaders();
     }
 
     if (result == S_OK && *ppDevice != nullptr)
@@ -263,6 +266,7 @@ static HRESULT hkD3D11CreateDevice(IDXGIAdapter* pAdapter, D3D_DRIVER_TYPE Drive
     {
         LOG_INFO("Device captured");
         HookToDeviceLocal(*ppDevice);
+        WarmupDx11Shaders();
     }
 
     LOG_FUNC_RESULT(result);
@@ -404,6 +408,7 @@ static HRESULT hkD3D11CreateDeviceAndSwapChain(IDXGIAdapter* pAdapter, D3D_DRIVE
     {
         LOG_INFO("Device captured");
         HookToDeviceLocal(*ppDevice);
+        WarmupDx11Shaders();
     }
 
     if (result == S_OK && pSwapChainDesc != nullptr && ppSwapChain != nullptr && *ppSwapChain != nullptr &&
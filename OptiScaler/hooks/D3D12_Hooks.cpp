@@ -8,6 +8,8 @@
 
 #include <resource_tracking/ResTrack_Dx12.h>
 
+#include "RootStateTracker.h"
+
 #include <proxies/D3D12_Proxy.h>
 #include <proxies/XeFG_Proxy.h>
 #include <proxies/XeSS_Proxy.h>
@@ -19,6 +21,7 @@
 
 #include <dxgi1_6.h>
 #include <misc/IdentifyGpu.h>
+#include <shaders/Shader_Dx12.h>
 
 #include "Hook_Utils.h"
 
@@ -107,69 +110,18 @@ template <typename T> struct RootRestoreHook
     T GetHook() const { return o_lateHook ? o_lateHook : o_earlyHook; };
 };
 
-struct DescriptorHeap
-{
-    UINT NumDescriptorHeaps {};
-    ID3D12DescriptorHeap* Heaps[2] = { nullptr, nullptr }; // apparently 2 is max
-};
-
-enum class RootEntryType
-{
-    Invalid,
-    Table,
-    Constant,
-    Constants,
-    CBV,
-    SRV,
-    UAV,
-};
-
-struct RootState
-{
-    RootEntryType type = RootEntryType::Invalid;
+// Root state of each command list, written only by the thread recording it
+static root_state::Tracker<4096> rootStateTracker;
 
-    // Table
-    D3D12_GPU_DESCRIPTOR_HANDLE rootDescriptorTable {};
+// Frees the root state record when a command list is destroyed
+static PFN_Release o_CommandListRelease = nullptr;
 
-    // CBV / SRV / UAV
-    D3D12_GPU_VIRTUAL_ADDRESS bufferLocation {};
-
-    // Constants; Constant uses Data[0] and DestOffset
-    UINT Num32BitValues = 0;
-    UINT DestOffset = 0;
-    std::vector<uint32_t> Data;
-};
-
-enum class SignatureEntryType
-{
-    Invalid,
-    Compute,
-    Graphics,
-};
-
-struct SignatureEntry
-{
-    SignatureEntryType type = SignatureEntryType::Invalid;
-    ID3D12RootSignature* ptr {};
-};
-
-static std::shared_mutex descriptorHeapsMutex;
-static ankerl::unordered_dense::map<ID3D12GraphicsCommandList*, DescriptorHeap> descriptorHeaps;
 static RootRestoreHook<PFN_SetDescriptorHeaps> s_SetDescriptorHeaps {};
-
-static std::shared_mutex pipelineStatesMutex;
-static ankerl::unordered_dense::map<ID3D12GraphicsCommandList*, ID3D12PipelineState*> pipelineStates;
 static RootRestoreHook<PFN_SetPipelineState> s_SetPipelineState {};
 
-// Those use a common rootSignatureMutex mutex
-static std::shared_mutex rootSignatureMutex;
-static ankerl::unordered_dense::map<ID3D12GraphicsCommandList*, SignatureEntry> signatures;
 static RootRestoreHook<PFN_SetGraphicsRootSignature> s_SetGraphicsRootSignature {};
 static RootRestoreHook<PFN_SetComputeRootSignature> s_SetComputeRootSignature {};
 
-// Those use a common rootStatesMutex mutex
-static std::shared_mutex rootStatesMutex;
-static ankerl::unordered_dense::map<ID3D12GraphicsCommandList*, std::vector<RootState>> rootStates;
 static RootRestoreHook<PFN_SetComputeRootDescriptorTable> s_SetComputeRootDescriptorTable {};
 static RootRestoreHook<PFN_SetComputeRoot32BitConstant> s_SetComputeRoot32BitConstant {};
 static RootRestoreHook<PFN_SetComputeRoot32BitConstants> s_SetComputeRoot32BitConstants {};
@@ -203,8 +155,9 @@ static thread_local bool lateInProgressSetGraphicsRootConstantBufferView = false
 static thread_local bool lateInProgressSetGraphicsRootShaderResourceView = false;
 static thread_local bool lateInProgressSetGraphicsRootUnorderedAccessView = false;
 
-static std::shared_mutex rootSigParameterCountMutex;
-static ankerl::unordered_dense::map<ID3D12RootSignature*, UINT> rootSigParameterCount;
+// Written when root signatures are created, read when a command list sets a new root signature
+static std::shared_mutex rootSigLayoutsMutex;
+static ankerl::unordered_dense::map<ID3D12RootSignature*, root_state::Layout> rootSigLayouts;
 
 static bool isUpscalerActive = false;
 
@@ -375,61 +328,144 @@ static void ApplySamplerOverrides(D3D12_STATIC_SAMPLER_DESC1& samplerDesc)
     }
 }
 
-// Early hooks, from Opti's own cmdlist
-VALIDATE_HOOK(hkSetPipelineState, PFN_SetPipelineState)
-static void hkSetPipelineState(ID3D12GraphicsCommandList* commandList, ID3D12PipelineState* pPipelineState)
+VALIDATE_HOOK(hkCommandListRelease, PFN_Release)
+static ULONG hkCommandListRelease(IUnknown* commandList)
+{
+    // Lists which never recorded a root call have nothing to free
+    if (rootStateTracker.Find(commandList) == nullptr)
+        return o_CommandListRelease(commandList);
+
+    // Extra reference keeps the address from being reused by a new list before the record is freed
+    commandList->AddRef();
+
+    if (o_CommandListRelease(commandList) == 1)
+        rootStateTracker.Remove(commandList);
+
+    return o_CommandListRelease(commandList);
+}
+
+static root_state::Record* TrackedRecord(ID3D12GraphicsCommandList* commandList)
+{
+    if (isUpscalerActive || commandList == nullptr)
+        return nullptr;
+
+    return rootStateTracker.Acquire(commandList);
+}
+
+static root_state::Layout GetRootSignatureLayout(ID3D12RootSignature* pRootSignature)
 {
-    if (!lateInProgressSetPipelineState && !isUpscalerActive && commandList != nullptr && pPipelineState != nullptr)
+    std::shared_lock<std::shared_mutex> lock(rootSigLayoutsMutex);
+    auto it = rootSigLayouts.find(pRootSignature);
+    return (it != rootSigLayouts.end()) ? it->second : root_state::Layout {};
+}
+
+template <typename T>
+static void StoreRootSignatureLayout(void* pRootSignature, UINT numParameters, const T* parameters)
+{
+    root_state::Layout layout {};
+
+    for (UINT i = 0; i < numParameters; i++)
     {
-        std::unique_lock<std::shared_mutex> lock(pipelineStatesMutex);
-        pipelineStates.insert_or_assign(commandList, pPipelineState);
+        auto constants = parameters[i].ParameterType == D3D12_ROOT_PARAMETER_TYPE_32BIT_CONSTANTS
+                             ? parameters[i].Constants.Num32BitValues
+                             : 0;
+
+        if (!layout.AddParameter(constants))
+            break;
     }
 
-    s_SetPipelineState.o_earlyHook(commandList, pPipelineState);
+    std::unique_lock<std::shared_mutex> lock(rootSigLayoutsMutex);
+    rootSigLayouts.insert_or_assign((ID3D12RootSignature*) pRootSignature, layout);
 }
 
-VALIDATE_HOOK(hkSetDescriptorHeaps, PFN_SetDescriptorHeaps)
-static void hkSetDescriptorHeaps(ID3D12GraphicsCommandList* commandList, UINT NumDescriptorHeaps,
+static void StoreRootSignatureLayout(const D3D12_VERSIONED_ROOT_SIGNATURE_DESC* desc, void* pRootSignature)
+{
+    if (desc->Version == D3D_ROOT_SIGNATURE_VERSION_1_0)
+        StoreRootSignatureLayout(pRootSignature, desc->Desc_1_0.NumParameters, desc->Desc_1_0.pParameters);
+    else if (desc->Version == D3D_ROOT_SIGNATURE_VERSION_1_1)
+        StoreRootSignatureLayout(pRootSignature, desc->Desc_1_1.NumParameters, desc->Desc_1_1.pParameters);
+    else if (desc->Version == D3D_ROOT_SIGNATURE_VERSION_1_2)
+        StoreRootSignatureLayout(pRootSignature, desc->Desc_1_2.NumParameters, desc->Desc_1_2.pParameters);
+}
+
+static void TrackPipelineState(ID3D12GraphicsCommandList* commandList, ID3D12PipelineState* pPipelineState)
+{
+    if (auto record = TrackedRecord(commandList))
+        record->SetPipelineState((uint64_t) pPipelineState);
+}
+
+static void TrackDescriptorHeaps(ID3D12GraphicsCommandList* commandList, UINT NumDescriptorHeaps,
                                  ID3D12DescriptorHeap* const* ppDescriptorHeaps)
 {
-    if (!lateInProgressSetDescriptorHeaps && !isUpscalerActive && commandList != nullptr &&
-        ppDescriptorHeaps != nullptr)
+    if (auto record = TrackedRecord(commandList))
     {
-        std::unique_lock<std::shared_mutex> lock(descriptorHeapsMutex);
-        DescriptorHeap temp {};
-        temp.NumDescriptorHeaps = NumDescriptorHeaps;
-        for (UINT i = 0; i < NumDescriptorHeaps; ++i)
-        {
-            temp.Heaps[i] = ppDescriptorHeaps[i];
-        }
-        descriptorHeaps.insert_or_assign(commandList, std::move(temp));
+        record->SetDescriptorHeaps(NumDescriptorHeaps, NumDescriptorHeaps > 0 ? (uint64_t) ppDescriptorHeaps[0] : 0,
+                                   NumDescriptorHeaps > 1 ? (uint64_t) ppDescriptorHeaps[1] : 0);
     }
+}
 
-    s_SetDescriptorHeaps.o_earlyHook(commandList, NumDescriptorHeaps, ppDescriptorHeaps);
+static void TrackRootSignature(ID3D12GraphicsCommandList* commandList, root_state::SignatureType type,
+                               ID3D12RootSignature* pRootSignature)
+{
+    auto record = TrackedRecord(commandList);
+
+    if (record == nullptr)
+        return;
+
+    // Layout is only looked up when the list switches to another root signature
+    auto& current = record->Current().For(type);
+
+    if (current.Signature == (uint64_t) pRootSignature)
+        record->SetSignature(type, current.Signature, current.SignatureLayout);
+    else
+        record->SetSignature(type, (uint64_t) pRootSignature, GetRootSignatureLayout(pRootSignature));
 }
 
-UINT GetRootParameterCount(ID3D12RootSignature* pRootSignature)
+static void TrackRootParameter(ID3D12GraphicsCommandList* commandList, root_state::SignatureType type,
+                               UINT RootParameterIndex, root_state::ParameterType parameterType, UINT64 value)
 {
-    std::unique_lock<std::shared_mutex> lock(rootSigParameterCountMutex);
-    auto it = rootSigParameterCount.find(pRootSignature);
-    return (it != rootSigParameterCount.end()) ? it->second : 0;
+    if (auto record = TrackedRecord(commandList))
+        record->SetParameter(type, RootParameterIndex, parameterType, value);
+}
+
+static void TrackRootConstants(ID3D12GraphicsCommandList* commandList, root_state::SignatureType type,
+                               UINT RootParameterIndex, UINT Num32BitValuesToSet, const void* pSrcData,
+                               UINT DestOffsetIn32BitValues)
+{
+    if (auto record = TrackedRecord(commandList))
+    {
+        record->SetConstants(type, RootParameterIndex, Num32BitValuesToSet, static_cast<const uint32_t*>(pSrcData),
+                             DestOffsetIn32BitValues);
+    }
+}
+
+// Early hooks, from Opti's own cmdlist
+VALIDATE_HOOK(hkSetPipelineState, PFN_SetPipelineState)
+static void hkSetPipelineState(ID3D12GraphicsCommandList* commandList, ID3D12PipelineState* pPipelineState)
+{
+    if (!lateInProgressSetPipelineState && pPipelineState != nullptr)
+        TrackPipelineState(commandList, pPipelineState);
+
+    s_SetPipelineState.o_earlyHook(commandList, pPipelineState);
+}
+
+VALIDATE_HOOK(hkSetDescriptorHeaps, PFN_SetDescriptorHeaps)
+static void hkSetDescriptorHeaps(ID3D12GraphicsCommandList* commandList, UINT NumDescriptorHeaps,
+                                 ID3D12DescriptorHeap* const* ppDescriptorHeaps)
+{
+    if (!lateInProgressSetDescriptorHeaps && ppDescriptorHeaps != nullptr)
+        TrackDescriptorHeaps(commandList, NumDescriptorHeaps, ppDescriptorHeaps);
+
+    s_SetDescriptorHeaps.o_earlyHook(commandList, NumDescriptorHeaps, ppDescriptorHeaps);
 }
 
 VALIDATE_HOOK(hkSetComputeRootSignature, PFN_SetComputeRootSignature)
 static void hkSetComputeRootSignature(ID3D12GraphicsCommandList* commandList, ID3D12RootSignature* pRootSignature)
 {
-    if (!lateInProgressSetComputeRootSignature && Config::Instance()->RestoreComputeSignature.value_or_default() &&
-        !isUpscalerActive && commandList != nullptr && pRootSignature != nullptr)
+    if (!lateInProgressSetComputeRootSignature && pRootSignature != nullptr &&
+        Config::Instance()->RestoreComputeSignature.value_or_default())
     {
-        {
-            auto paramCount = GetRootParameterCount(pRootSignature);
-            std::unique_lock<std::shared_mutex> lock(rootStatesMutex);
-            auto& table = rootStates[commandList];
-            table.resize(paramCount);
-        }
-
-        std::unique_lock<std::shared_mutex> lock(rootSignatureMutex);
-        signatures.insert_or_assign(commandList, SignatureEntry { SignatureEntryType::Compute, pRootSignature });
+        TrackRootSignature(commandList, root_state::SignatureType::Compute, pRootSignature);
     }
 
     s_SetComputeRootSignature.o_earlyHook(commandList, pRootSignature);
@@ -439,16 +475,10 @@ VALIDATE_HOOK(hkSetComputeRootDescriptorTable, PFN_SetComputeRootDescriptorTable
 static void hkSetComputeRootDescriptorTable(ID3D12GraphicsCommandList* commandList, UINT RootParameterIndex,
                                             D3D12_GPU_DESCRIPTOR_HANDLE BaseDescriptor)
 {
-    if (!lateInProgressSetComputeRootDescriptorTable && !isUpscalerActive && commandList != nullptr &&
-        BaseDescriptor.ptr)
+    if (!lateInProgressSetComputeRootDescriptorTable && BaseDescriptor.ptr)
     {
-        std::unique_lock<std::shared_mutex> lock(rootStatesMutex);
-        auto& table = rootStates[commandList];
-        if (RootParameterIndex < table.size())
-        {
-            table[RootParameterIndex].type = RootEntryType::Table;
-            table[RootParameterIndex].rootDescriptorTable = BaseDescriptor;
-        }
+        TrackRootParameter(commandList, root_state::SignatureType::Compute, RootParameterIndex,
+                           root_state::ParameterType::Table, BaseDescriptor.ptr);
     }
 
     s_SetComputeRootDescriptorTable.o_earlyHook(commandList, RootParameterIndex, BaseDescriptor);
@@ -458,18 +488,10 @@ VALIDATE_HOOK(hkSetComputeRoot32BitConstants, PFN_SetComputeRoot32BitConstants)
 static void hkSetComputeRoot32BitConstants(ID3D12GraphicsCommandList* commandList, UINT RootParameterIndex,
                                            UINT Num32BitValuesToSet, const void* pSrcData, UINT DestOffsetIn32BitValues)
 {
-    if (!lateInProgressSetComputeRoot32BitConstants && !isUpscalerActive && commandList != nullptr && pSrcData)
+    if (!lateInProgressSetComputeRoot32BitConstants && pSrcData)
     {
-        std::unique_lock<std::shared_mutex> lock(rootStatesMutex);
-        auto& table = rootStates[commandList];
-        if (RootParameterIndex < table.size())
-        {
-            table[RootParameterIndex].type = RootEntryType::Constants;
-            table[RootParameterIndex].Num32BitValues = Num32BitValuesToSet;
-            table[RootParameterIndex].DestOffset = DestOffsetIn32BitValues;
-            auto* src = static_cast<const uint32_t*>(pSrcData);
-            table[RootParameterIndex].Data.assign(src, src + Num32BitValuesToSet);
-        }
+        TrackRootConstants(commandList, root_state::SignatureType::Compute, RootParameterIndex, Num32BitValuesToSet,
+                           pSrcData, DestOffsetIn32BitValues);
     }
 
     s_SetComputeRoot32BitConstants.o_earlyHook(commandList, RootParameterIndex, Num32BitValuesToSet, pSrcData,
@@ -480,16 +502,10 @@ VALIDATE_HOOK(hkSetComputeRoot32BitConstant, PFN_SetComputeRoot32BitConstant)
 static void hkSetComputeRoot32BitConstant(ID3D12GraphicsCommandList* commandList, UINT RootParameterIndex, UINT SrcData,
                                           UINT DestOffsetIn32BitValues)
 {
-    if (!lateInProgressSetComputeRoot32BitConstant && !isUpscalerActive && commandList != nullptr)
+    if (!lateInProgressSetComputeRoot32BitConstant)
     {
-        std::unique_lock<std::shared_mutex> lock(rootStatesMutex);
-        auto& table = rootStates[commandList];
-        if (RootParameterIndex < table.size())
-        {
-            table[RootParameterIndex].type = RootEntryType::Constant;
-            table[RootParameterIndex].DestOffset = DestOffsetIn32BitValues;
-            table[RootParameterIndex].Data.assign(1, SrcData);
-        }
+        TrackRootConstants(commandList, root_state::SignatureType::Compute, RootParameterIndex, 1, &SrcData,
+                           DestOffsetIn32BitValues);
     }
 
     s_SetComputeRoot32BitConstant.o_earlyHook(commandList, RootParameterIndex, SrcData, DestOffsetIn32BitValues);
@@ -499,15 +515,10 @@ VALIDATE_HOOK(hkSetComputeRootConstantBufferView, PFN_SetComputeRootConstantBuff
 static void hkSetComputeRootConstantBufferView(ID3D12GraphicsCommandList* commandList, UINT RootParameterIndex,
                                                D3D12_GPU_VIRTUAL_ADDRESS BufferLocation)
 {
-    if (!lateInProgressSetComputeRootConstantBufferView && !isUpscalerActive && commandList != nullptr)
+    if (!lateInProgressSetComputeRootConstantBufferView)
     {
-        std::unique_lock<std::shared_mutex> lock(rootStatesMutex);
-        auto& table = rootStates[commandList];
-        if (RootParameterIndex < table.size())
-        {
-            table[RootParameterIndex].type = RootEntryType::CBV;
-            table[RootParameterIndex].bufferLocation = BufferLocation;
-        }
+        TrackRootParameter(commandList, root_state::SignatureType::Compute, RootParameterIndex,
+                           root_state::ParameterType::CBV, BufferLocation);
     }
 
     s_SetComputeRootConstantBufferView.o_earlyHook(commandList, RootParameterIndex, BufferLocation);
@@ -517,35 +528,23 @@ VALIDATE_HOOK(hkSetComputeRootShaderResourceView, PFN_SetComputeRootShaderResour
 static void hkSetComputeRootShaderResourceView(ID3D12GraphicsCommandList* commandList, UINT RootParameterIndex,
                                                D3D12_GPU_VIRTUAL_ADDRESS BufferLocation)
 {
-    if (!lateInProgressSetComputeRootShaderResourceView && !isUpscalerActive && commandList != nullptr)
+    if (!lateInProgressSetComputeRootShaderResourceView)
     {
-        std::unique_lock<std::shared_mutex> lock(rootStatesMutex);
-        auto& table = rootStates[commandList];
-        if (RootParameterIndex < table.size())
-        {
-            table[RootParameterIndex].type = RootEntryType::SRV;
-            table[RootParameterIndex].bufferLocation = BufferLocation;
-        }
+        TrackRootParameter(commandList, root_state::SignatureType::Compute, RootParameterIndex,
+                           root_state::ParameterType::SRV, BufferLocation);
     }
 
     s_SetComputeRootShaderResourceView.o_earlyHook(commandList, RootParameterIndex, BufferLocation);
-
-    lateInProgressSetComputeRootShaderResourceView = false;
 }
 
 VALIDATE_HOOK(hkSetComputeRootUnorderedAccessView, PFN_SetComputeRootUnorderedAccessView)
 static void hkSetComputeRootUnorderedAccessView(ID3D12GraphicsCommandList* commandList, UINT RootParameterIndex,
                                                 D3D12_GPU_VIRTUAL_ADDRESS BufferLocation)
 {
-    if (lateInProgressSetComputeRootUnorderedAccessView && !isUpscalerActive && commandList != nullptr)
+    if (!lateInProgressSetComputeRootUnorderedAccessView)
     {
-        std::unique_lock<std::shared_mutex> lock(rootStatesMutex);
-        auto& table = rootStates[commandList];
-        if (RootParameterIndex < table.size())
-        {
-            table[RootParameterIndex].type = RootEntryType::UAV;
-            table[RootParameterIndex].bufferLocation = BufferLocation;
-        }
+        TrackRootParameter(commandList, root_state::SignatureType::Compute, RootParameterIndex,
+                           root_state::ParameterType::UAV, BufferLocation);
     }
 
     s_SetComputeRootUnorderedAccessView.o_earlyHook(commandList, RootParameterIndex, BufferLocation);
@@ -554,11 +553,10 @@ static void hkSetComputeRootUnorderedAccessView(ID3D12GraphicsCommandList* comma
 VALIDATE_HOOK(hkSetGraphicsRootSignature, PFN_SetGraphicsRootSignature)
 static void hkSetGraphicsRootSignature(ID3D12GraphicsCommandList* commandList, ID3D12RootSignature* pRootSignature)
 {
-    if (!lateInProgressSetGraphicsRootSignature && Config::Instance()->RestoreGraphicSignature.value_or_default() &&
-        !isUpscalerActive && commandList != nullptr && pRootSignature != nullptr)
+    if (!lateInProgressSetGraphicsRootSignature && pRootSignature != nullptr &&
+        Config::Instance()->RestoreGraphicSignature.value_or_default())
     {
-        std::unique_lock<std::shared_mutex> lock(rootSignatureMutex);
-        signatures.insert_or_assign(commandList, SignatureEntry { SignatureEntryType::Graphics, pRootSignature });
+        TrackRootSignature(commandList, root_state::SignatureType::Graphics, pRootSignature);
     }
 
     s_SetGraphicsRootSignature.o_earlyHook(commandList, pRootSignature);
@@ -568,16 +566,10 @@ VALIDATE_HOOK(hkSetGraphicsRootDescriptorTable, PFN_SetGraphicsRootDescriptorTab
 static void hkSetGraphicsRootDescriptorTable(ID3D12GraphicsCommandList* commandList, UINT RootParameterIndex,
                                              D3D12_GPU_DESCRIPTOR_HANDLE BaseDescriptor)
 {
-    if (!lateInProgressSetGraphicsRootDescriptorTable && !isUpscalerActive && commandList != nullptr &&
-        BaseDescriptor.ptr)
+    if (!lateInProgressSetGraphicsRootDescriptorTable && BaseDescriptor.ptr)
     {
-        std::unique_lock<std::shared_mutex> lock(rootStatesMutex);
-        auto& table = rootStates[commandList];
-        if (RootParameterIndex < table.size())
-        {
-            table[RootParameterIndex].type = RootEntryType::Table;
-            table[RootParameterIndex].rootDescriptorTable = BaseDescriptor;
-        }
+        TrackRootParameter(commandList, root_state::SignatureType::Graphics, RootParameterIndex,
+                           root_state::ParameterType::Table, BaseDescriptor.ptr);
     }
 
     s_SetGraphicsRootDescriptorTable.o_earlyHook(commandList, RootParameterIndex, BaseDescriptor);
@@ -588,18 +580,10 @@ static void hkSetGraphicsRoot32BitConstants(ID3D12GraphicsCommandList* commandLi
                                             UINT Num32BitValuesToSet, const void* pSrcData,
                                             UINT DestOffsetIn32BitValues)
 {
-    if (!lateInProgressSetGraphicsRoot32BitConstants && !isUpscalerActive && commandList != nullptr && pSrcData)
+    if (!lateInProgressSetGraphicsRoot32BitConstants && pSrcData)
     {
-        std::unique_lock<std::shared_mutex> lock(rootStatesMutex);
-        auto& table = rootStates[commandList];
-        if (RootParameterIndex < table.size())
-        {
-            table[RootParameterIndex].type = RootEntryType::Constants;
-            table[RootParameterIndex].Num32BitValues = Num32BitValuesToSet;
-            table[RootParameterIndex].DestOffset = DestOffsetIn32BitValues;
-            auto* src = static_cast<const uint32_t*>(pSrcData);
-            table[RootParameterIndex].Data.assign(src, src + Num32BitValuesToSet);
-        }
+        TrackRootConstants(commandList, root_state::SignatureType::Graphics, RootParameterIndex, Num32BitValuesToSet,
+                           pSrcData, DestOffsetIn32BitValues);
     }
 
     s_SetGraphicsRoot32BitConstants.o_earlyHook(commandList, RootParameterIndex, Num32BitValuesToSet, pSrcData,
@@ -610,16 +594,10 @@ VALIDATE_HOOK(hkSetGraphicsRoot32BitConstant, PFN_SetGraphicsRoot32BitConstant)
 static void hkSetGraphicsRoot32BitConstant(ID3D12GraphicsCommandList* commandList, UINT RootParameterIndex,
                                            UINT SrcData, UINT DestOffsetIn32BitValues)
 {
-    if (!lateInProgressSetGraphicsRoot32BitConstant && !isUpscalerActive && commandList != nullptr)
+    if (!lateInProgressSetGraphicsRoot32BitConstant)
     {
-        std::unique_lock<std::shared_mutex> lock(rootStatesMutex);
-        auto& table = rootStates[commandList];
-        if (RootParameterIndex < table.size())
-        {
-            table[RootParameterIndex].type = RootEntryType::Constant;
-            table[RootParameterIndex].DestOffset = DestOffsetIn32BitValues;
-            table[RootParameterIndex].Data.assign(1, SrcData);
-        }
+        TrackRootConstants(commandList, root_state::SignatureType::Graphics, RootParameterIndex, 1, &SrcData,
+                           DestOffsetIn32BitValues);
     }
 
     s_SetGraphicsRoot32BitConstant.o_earlyHook(commandList, RootParameterIndex, SrcData, DestOffsetIn32BitValues);
@@ -629,15 +607,10 @@ VALIDATE_HOOK(hkSetGraphicsRootConstantBufferView, PFN_SetGraphicsRootConstantBu
 static void hkSetGraphicsRootConstantBufferView(ID3D12GraphicsCommandList* commandList, UINT RootParameterIndex,
                                                 D3D12_GPU_VIRTUAL_ADDRESS BufferLocation)
 {
-    if (!lateInProgressSetGraphicsRootConstantBufferView && !isUpscalerActive && commandList != nullptr)
+    if (!lateInProgressSetGraphicsRootConstantBufferView)
     {
-        std::unique_lock<std::shared_mutex> lock(rootStatesMutex);
-        auto& table = rootStates[commandList];
-        if (RootParameterIndex < table.size())
-        {
-            table[RootParameterIndex].type = RootEntryType::CBV;
-            table[RootParameterIndex].bufferLocation = BufferLocation;
-        }
+        TrackRootParameter(commandList, root_state::SignatureType::Graphics, RootParameterIndex,
+                           root_state::ParameterType::CBV, BufferLocation);
     }
 
     s_SetGraphicsRootConstantBufferView.o_earlyHook(commandList, RootParameterIndex, BufferLocation);
@@ -647,35 +620,23 @@ VALIDATE_HOOK(hkSetGraphicsRootShaderResourceView, PFN_SetGraphicsRootShaderReso
 static void hkSetGraphicsRootShaderResourceView(ID3D12GraphicsCommandList* commandList, UINT RootParameterIndex,
                                                 D3D12_GPU_VIRTUAL_ADDRESS BufferLocation)
 {
-    if (!lateInProgressSetGraphicsRootShaderResourceView && !isUpscalerActive && commandList != nullptr)
+    if (!lateInProgressSetGraphicsRootShaderResourceView)
     {
-        std::unique_lock<std::shared_mutex> lock(rootStatesMutex);
-        auto& table = rootStates[commandList];
-        if (RootParameterIndex < table.size())
-        {
-            table[RootParameterIndex].type = RootEntryType::SRV;
-            table[RootParameterIndex].bufferLocation = BufferLocation;
-        }
+        TrackRootParameter(commandList, root_state::SignatureType::Graphics, RootParameterIndex,
+                           root_state::ParameterType::SRV, BufferLocation);
     }
 
     s_SetGraphicsRootShaderResourceView.o_earlyHook(commandList, RootParameterIndex, BufferLocation);
-
-    lateInProgressSetGraphicsRootShaderResourceView = false;
 }
 
 VALIDATE_HOOK(hkSetGraphicsRootUnorderedAccessView, PFN_SetGraphicsRootUnorderedAccessView)
 static void hkSetGraphicsRootUnorderedAccessView(ID3D12GraphicsCommandList* commandList, UINT RootParameterIndex,
                                                  D3D12_GPU_VIRTUAL_ADDRESS BufferLocation)
 {
-    if (lateInProgressSetGraphicsRootUnorderedAccessView && !isUpscalerActive && commandList != nullptr)
+    if (!lateInProgressSetGraphicsRootUnorderedAccessView)
     {
-        std::unique_lock<std::shared_mutex> lock(rootStatesMutex);
-        auto& table = rootStates[commandList];
-        if (RootParameterIndex < table.size())
-        {
-            table[RootParameterIndex].type = RootEntryType::UAV;
-            table[RootParameterIndex].bufferLocation = BufferLocation;
-        }
+        TrackRootParameter(commandList, root_state::SignatureType::Graphics, RootParameterIndex,
+                           root_state::ParameterType::UAV, BufferLocation);
     }
 
     s_SetGraphicsRootUnorderedAccessView.o_earlyHook(commandList, RootParameterIndex, BufferLocation);
@@ -687,11 +648,8 @@ static void hkSetPipelineStateLate(ID3D12GraphicsCommandList* commandList, ID3D1
 {
     lateInProgressSetPipelineState = true;
 
-    if (!isUpscalerActive && commandList != nullptr && pPipelineState != nullptr)
-    {
-        std::unique_lock<std::shared_mutex> lock(pipelineStatesMutex);
-        pipelineStates.insert_or_assign(commandList, pPipelineState);
-    }
+    if (pPipelineState != nullptr)
+        TrackPipelineState(commandList, pPipelineState);
 
     s_SetPipelineState.o_lateHook(commandList, pPipelineState);
 
@@ -704,17 +662,8 @@ static void hkSetDescriptorHeapsLate(ID3D12GraphicsCommandList* commandList, UIN
 {
     lateInProgressSetDescriptorHeaps = true;
 
-    if (!isUpscalerActive && commandList != nullptr && ppDescriptorHeaps != nullptr)
-    {
-        std::unique_lock<std::shared_mutex> lock(descriptorHeapsMutex);
-        DescriptorHeap temp {};
-        temp.NumDescriptorHeaps = NumDescriptorHeaps;
-        for (UINT i = 0; i < NumDescriptorHeaps; ++i)
-        {
-            temp.Heaps[i] = ppDescriptorHeaps[i];
-        }
-        descriptorHeaps.insert_or_assign(commandList, std::move(temp));
-    }
+    if (ppDescriptorHeaps != nullptr)
+        TrackDescriptorHeaps(commandList, NumDescriptorHeaps, ppDescriptorHeaps);
 
     s_SetDescriptorHeaps.o_lateHook(commandList, NumDescriptorHeaps, ppDescriptorHeaps);
 
@@ -726,19 +675,8 @@ static void hkSetComputeRootSignatureLate(ID3D12GraphicsCommandList* commandList
 {
     lateInProgressSetComputeRootSignature = true;
 
-    if (Config::Instance()->RestoreComputeSignature.value_or_default() && !isUpscalerActive && commandList != nullptr &&
-        pRootSignature != nullptr)
-    {
-        {
-            auto paramCount = GetRootParameterCount(pRootSignature);
-            std::unique_lock<std::shared_mutex> lock(rootStatesMutex);
-            auto& table = rootStates[commandList];
-            table.resize(paramCount);
-        }
-
-        std::unique_lock<std::shared_mutex> lock(rootSignatureMutex);
-        signatures.insert_or_assign(commandList, SignatureEntry { SignatureEntryType::Compute, pRootSignature });
-    }
+    if (pRootSignature != nullptr && Config::Instance()->RestoreComputeSignature.value_or_default())
+        TrackRootSignature(commandList, root_state::SignatureType::Compute, pRootSignature);
 
     s_SetComputeRootSignature.o_lateHook(commandList, pRootSignature);
 
@@ -751,15 +689,10 @@ static void hkSetComputeRootDescriptorTableLate(ID3D12GraphicsCommandList* comma
 {
     lateInProgressSetComputeRootDescriptorTable = true;
 
-    if (!isUpscalerActive && commandList != nullptr && BaseDescriptor.ptr)
+    if (BaseDescriptor.ptr)
     {
-        std::unique_lock<std::shared_mutex> lock(rootStatesMutex);
-        auto& table = rootStates[commandList];
-        if (RootParameterIndex < table.size())
-        {
-            table[RootParameterIndex].type = RootEntryType::Table;
-            table[RootParameterIndex].rootDescriptorTable = BaseDescriptor;
-        }
+        TrackRootParameter(commandList, root_state::SignatureType::Compute, RootParameterIndex,
+                           root_state::ParameterType::Table, BaseDescriptor.ptr);
     }
 
     s_SetComputeRootDescriptorTable.o_lateHook(commandList, RootParameterIndex, BaseDescriptor);
@@ -774,18 +707,10 @@ static void hkSetComputeRoot32BitConstantsLate(ID3D12GraphicsCommandList* comman
 {
     lateInProgressSetComputeRoot32BitConstants = true;
 
-    if (!isUpscalerActive && commandList != nullptr && pSrcData)
+    if (pSrcData)
     {
-        std::unique_lock<std::shared_mutex> lock(rootStatesMutex);
-        auto& table = rootStates[commandList];
-        if (RootParameterIndex < table.size())
-        {
-            table[RootParameterIndex].type = RootEntryType::Constants;
-            table[RootParameterIndex].Num32BitValues = Num32BitValuesToSet;
-            table[RootParameterIndex].DestOffset = DestOffsetIn32BitValues;
-            auto* src = static_cast<const uint32_t*>(pSrcData);
-            table[RootParameterIndex].Data.assign(src, src + Num32BitValuesToSet);
-        }
+        TrackRootConstants(commandList, root_state::SignatureType::Compute, RootParameterIndex, Num32BitValuesToSet,
+                           pSrcData, DestOffsetIn32BitValues);
     }
 
     s_SetComputeRoot32BitConstants.o_lateHook(commandList, RootParameterIndex, Num32BitValuesToSet, pSrcData,
@@ -800,17 +725,8 @@ static void hkSetComputeRoot32BitConstantLate(ID3D12GraphicsCommandList* command
 {
     lateInProgressSetComputeRoot32BitConstant = true;
 
-    if (!isUpscalerActive && commandList != nullptr)
-    {
-        std::unique_lock<std::shared_mutex> lock(rootStatesMutex);
-        auto& table = rootStates[commandList];
-        if (RootParameterIndex < table.size())
-        {
-            table[RootParameterIndex].type = RootEntryType::Constant;
-            table[RootParameterIndex].DestOffset = DestOffsetIn32BitValues;
-            table[RootParameterIndex].Data.assign(1, SrcData);
-        }
-    }
+    TrackRootConstants(commandList, root_state::SignatureType::Compute, RootParameterIndex, 1, &SrcData,
+                       DestOffsetIn32BitValues);
 
     s_SetComputeRoot32BitConstant.o_lateHook(commandList, RootParameterIndex, SrcData, DestOffsetIn32BitValues);
 
@@ -823,16 +739,8 @@ static void hkSetComputeRootConstantBufferViewLate(ID3D12GraphicsCommandList* co
 {
     lateInProgressSetComputeRootConstantBufferView = true;
 
-    if (!isUpscalerActive && commandList != nullptr)
-    {
-        std::unique_lock<std::shared_mutex> lock(rootStatesMutex);
-        auto& table = rootStates[commandList];
-        if (RootParameterIndex < table.size())
-        {
-            table[RootParameterIndex].type = RootEntryType::CBV;
-            table[RootParameterIndex].bufferLocation = BufferLocation;
-        }
-    }
+    TrackRootParameter(commandList, root_state::SignatureType::Compute, RootParameterIndex,
+                       root_state::ParameterType::CBV, BufferLocation);
 
     s_SetComputeRootConstantBufferView.o_lateHook(commandList, RootParameterIndex, BufferLocation);
 
@@ -845,16 +753,8 @@ static void hkSetComputeRootShaderResourceViewLate(ID3D12GraphicsCommandList* co
 {
     lateInProgressSetComputeRootShaderResourceView = true;
 
-    if (!isUpscalerActive && commandList != nullptr)
-    {
-        std::unique_lock<std::shared_mutex> lock(rootStatesMutex);
-        auto& table = rootStates[commandList];
-        if (RootParameterIndex < table.size())
-        {
-            table[RootParameterIndex].type = RootEntryType::SRV;
-            table[RootParameterIndex].bufferLocation = BufferLocation;
-        }
-    }
+    TrackRootParameter(commandList, root_state::SignatureType::Compute, RootParameterIndex,
+                       root_state::ParameterType::SRV, BufferLocation);
 
     s_SetComputeRootShaderResourceView.o_lateHook(commandList, RootParameterIndex, BufferLocation);
 
@@ -867,16 +767,8 @@ static void hkSetComputeRootUnorderedAccessViewLate(ID3D12GraphicsCommandList* c
 {
     lateInProgressSetComputeRootUnorderedAccessView = true;
 
-    if (!isUpscalerActive && commandList != nullptr)
-    {
-        std::unique_lock<std::shared_mutex> lock(rootStatesMutex);
-        auto& table = rootStates[commandList];
-        if (RootParameterIndex < table.size())
-        {
-            table[RootParameterIndex].type = RootEntryType::UAV;
-            table[RootParameterIndex].bufferLocation = BufferLocation;
-        }
-    }
+    TrackRootParameter(commandList, root_state::SignatureType::Compute, RootParameterIndex,
+                       root_state::ParameterType::UAV, BufferLocation);
 
     s_SetComputeRootUnorderedAccessView.o_lateHook(commandList, RootParameterIndex, BufferLocation);
 
@@ -888,12 +780,8 @@ static void hkSetGraphicsRootSignatureLate(ID3D12GraphicsCommandList* commandLis
 {
     lateInProgressSetGraphicsRootSignature = true;
 
-    if (Config::Instance()->RestoreGraphicSignature.value_or_default() && !isUpscalerActive && commandList != nullptr &&
-        pRootSignature != nullptr)
-    {
-        std::unique_lock<std::shared_mutex> lock(rootSignatureMutex);
-        signatures.insert_or_assign(commandList, SignatureEntry { SignatureEntryType::Graphics, pRootSignature });
-    }
+    if (pRootSignature != nullptr && Config::Instance()->RestoreGraphicSignature.value_or_default())
+        TrackRootSignature(commandList, root_state::SignatureType::Graphics, pRootSignature);
 
     s_SetGraphicsRootSignature.o_lateHook(commandList, pRootSignature);
 
@@ -906,15 +794,10 @@ static void hkSetGraphicsRootDescriptorTableLate(ID3D12GraphicsCommandList* comm
 {
     lateInProgressSetGraphicsRootDescriptorTable = true;
 
-    if (!isUpscalerActive && commandList != nullptr && BaseDescriptor.ptr)
+    if (BaseDescriptor.ptr)
     {
-        std::unique_lock<std::shared_mutex> lock(rootStatesMutex);
-        auto& table = rootStates[commandList];
-        if (RootParameterIndex < table.size())
-        {
-            table[RootParameterIndex].type = RootEntryType::Table;
-            table[RootParameterIndex].rootDescriptorTable = BaseDescriptor;
-        }
+        TrackRootParameter(commandList, root_state::SignatureType::Graphics, RootParameterIndex,
+                           root_state::ParameterType::Table, BaseDescriptor.ptr);
     }
 
     s_SetGraphicsRootDescriptorTable.o_lateHook(commandList, RootParameterIndex, BaseDescriptor);
@@ -929,18 +812,10 @@ static void hkSetGraphicsRoot32BitConstantsLate(ID3D12GraphicsCommandList* comma
 {
     lateInProgressSetGraphicsRoot32BitConstants = true;
 
-    if (!isUpscalerActive && commandList != nullptr && pSrcData)
+    if (pSrcData)
     {
-        std::unique_lock<std::shared_mutex> lock(rootStatesMutex);
-        auto& table = rootStates[commandList];
-        if (RootParameterIndex < table.size())
-        {
-            table[RootParameterIndex].type = RootEntryType::Constants;
-            table[RootParameterIndex].Num32BitValues = Num32BitValuesToSet;
-            table[RootParameterIndex].DestOffset = DestOffsetIn32BitValues;
-            auto* src = static_cast<const uint32_t*>(pSrcData);
-            table[RootParameterIndex].Data.assign(src, src + Num32BitValuesToSet);
-        }
+        TrackRootConstants(commandList, root_state::SignatureType::Graphics, RootParameterIndex, Num32BitValuesToSet,
+                           pSrcData, DestOffsetIn32BitValues);
     }
 
     s_SetGraphicsRoot32BitConstants.o_lateHook(commandList, RootParameterIndex, Num32BitValuesToSet, pSrcData,
@@ -955,17 +830,8 @@ static void hkSetGraphicsRoot32BitConstantLate(ID3D12GraphicsCommandList* comman
 {
     lateInProgressSetGraphicsRoot32BitConstant = true;
 
-    if (!isUpscalerActive && commandList != nullptr)
-    {
-        std::unique_lock<std::shared_mutex> lock(rootStatesMutex);
-        auto& table = rootStates[commandList];
-        if (RootParameterIndex < table.size())
-        {
-            table[RootParameterIndex].type = RootEntryType::Constant;
-            table[RootParameterIndex].DestOffset = DestOffsetIn32BitValues;
-            table[RootParameterIndex].Data.assign(1, SrcData);
-        }
-    }
+    TrackRootConstants(commandList, root_state::SignatureType::Graphics, RootParameterIndex, 1, &SrcData,
+                       DestOffsetIn32BitValues);
 
     s_SetGraphicsRoot32BitConstant.o_lateHook(commandList, RootParameterIndex, SrcData, DestOffsetIn32BitValues);
 
@@ -978,16 +844,8 @@ static void hkSetGraphicsRootConstantBufferViewLate(ID3D12GraphicsCommandList* c
 {
     lateInProgressSetGraphicsRootConstantBufferView = true;
 
-    if (!isUpscalerActive && commandList != nullptr)
-    {
-        std::unique_lock<std::shared_mutex> lock(rootStatesMutex);
-        auto& table = rootStates[commandList];
-        if (RootParameterIndex < table.size())
-        {
-            table[RootParameterIndex].type = RootEntryType::CBV;
-            table[RootParameterIndex].bufferLocation = BufferLocation;
-        }
-    }
+    TrackRootParameter(commandList, root_state::SignatureType::Graphics, RootParameterIndex,
+                       root_state::ParameterType::CBV, BufferLocation);
 
     s_SetGraphicsRootConstantBufferView.o_lateHook(commandList, RootParameterIndex, BufferLocation);
 
@@ -1000,16 +858,8 @@ static void hkSetGraphicsRootShaderResourceViewLate(ID3D12GraphicsCommandList* c
 {
     lateInProgressSetGraphicsRootShaderResourceView = true;
 
-    if (!isUpscalerActive && commandList != nullptr)
-    {
-        std::unique_lock<std::shared_mutex> lock(rootStatesMutex);
-        auto& table = rootStates[commandList];
-        if (RootParameterIndex < table.size())
-        {
-            table[RootParameterIndex].type = RootEntryType::SRV;
-            table[RootParameterIndex].bufferLocation = BufferLocation;
-        }
-    }
+    TrackRootParameter(commandList, root_state::SignatureType::Graphics, RootParameterIndex,
+                       root_state::ParameterType::SRV, BufferLocation);
 
     s_SetGraphicsRootShaderResourceView.o_lateHook(commandList, RootParameterIndex, BufferLocation);
 
@@ -1022,16 +872,8 @@ static void hkSetGraphicsRootUnorderedAccessViewLate(ID3D12GraphicsCommandList*
 {
     lateInProgressSetGraphicsRootUnorderedAccessView = true;
 
-    if (!isUpscalerActive && commandList != nullptr)
-    {
-        std::unique_lock<std::shared_mutex> lock(rootStatesMutex);
-        auto& table = rootStates[commandList];
-        if (RootParameterIndex < table.size())
-        {
-            table[RootParameterIndex].type = RootEntryType::UAV;
-            table[RootParameterIndex].bufferLocation = BufferLocation;
-        }
-    }
+    TrackRootParameter(commandList, root_state::SignatureType::Graphics, RootParameterIndex,
+                       root_state::ParameterType::UAV, BufferLocation);
 
     s_SetGraphicsRootUnorderedAccessView.o_lateHook(commandList, RootParameterIndex, BufferLocation);
 
@@ -1225,6 +1067,7 @@ static void HookToCommandList(ID3D12Device* InDevice)
             s_SetComputeRootConstantBufferView.o_earlyHook = (PFN_SetComputeRootConstantBufferView) pVTable[37];
             s_SetComputeRootShaderResourceView.o_earlyHook = (PFN_SetComputeRootShaderResourceView) pVTable[39];
             s_SetComputeRootUnorderedAccessView.o_earlyHook = (PFN_SetComputeRootUnorderedAccessView) pVTable[41];
+            o_CommandListRelease = (PFN_Release) pVTable[2];
 
             if (s_SetPipelineState.o_earlyHook || s_SetDescriptorHeaps.o_earlyHook ||
                 s_SetComputeRootSignature.o_earlyHook || s_SetGraphicsRootSignature.o_earlyHook ||
@@ -1235,6 +1078,9 @@ static void HookToCommandList(ID3D12Device* InDevice)
                 DetourTransactionBegin();
                 DetourUpdateThread(GetCurrentThread());
 
+                if (o_CommandListRelease != nullptr)
+                    DetourAttach(&(PVOID&) o_CommandListRelease, hkCommandListRelease);
+
                 if (s_SetPipelineState.o_earlyHook != nullptr && extendedRestoreSignature)
                     DetourAttach(&(PVOID&) s_SetPipelineState.o_earlyHook, hkSetPipelineState);
 
@@ -1291,6 +1137,7 @@ static void HookToCommandList(ID3D12Device* InDevice)
                     s_SetComputeRootConstantBufferView.o_earlyHook = nullptr;
                     s_SetComputeRootShaderResourceView.o_earlyHook = nullptr;
                     s_SetComputeRootUnorderedAccessView.o_earlyHook = nullptr;
+                    o_CommandListRelease = nullptr;
 
                     LOG_WARN("Hooking RootSignature failed");
                 }
@@ -1325,6 +1172,12 @@ static void UnhookAll()
         DetourDetach(&(PVOID&) s_SetGraphicsRootSignature.o_earlyHook, hkSetGraphicsRootSignature);
         s_SetGraphicsRootSignature.o_earlyHook = nullptr;
     }
+
+    if (o_CommandListRelease != nullptr)
+    {
+        DetourDetach(&(PVOID&) o_CommandListRelease, hkCommandListRelease);
+        o_CommandListRelease = nullptr;
+    }
 }
 
 VALIDATE_HOOK(hkD3D12CreateDevice, D3d12Proxy::PFN_D3D12CreateDevice)
@@ -1704,6 +1557,15 @@ static HRESULT hkD3D12SerializeVersionedRootSignature(const D3D12_VERSIONED_ROOT
 VALIDATE_HOOK(hkD3D12DeviceRelease, PFN_Release)
 static ULONG hkD3D12DeviceRelease(IUnknown* device)
 {
+    // Pipeline manager holds one reference, it's released together with the last one of the game
+    if (Shader_Dx12::HasPipelines((ID3D12Device*) device))
+    {
+        device->AddRef();
+
+        if (o_D3D12DeviceRelease(device) == 2)
+            Shader_Dx12::ReleasePipelines((ID3D12Device*) device);
+    }
+
     if (Config::Instance()->UESpoofIntelAtomics64.value_or_default() && device == _intelD3D12Device)
     {
         auto refCount = device->AddRef();
@@ -1962,24 +1824,7 @@ static HRESULT hkCreateRootSignature(ID3D12Device* device, UINT nodeMask, const
             o_CreateRootSignature(device, nodeMask, pBlobWithRootSignature, blobLengthInBytes, riid, ppvRootSignature);
 
         if (SUCCEEDED(result))
-        {
-            std::unique_lock<std::shared_mutex> lock(rootSigParameterCountMutex);
-            if (desc->Version == D3D_ROOT_SIGNATURE_VERSION_1_0)
-            {
-                rootSigParameterCount.insert_or_assign((ID3D12RootSignature*) *ppvRootSignature,
-                                                       desc->Desc_1_0.NumParameters);
-            }
-            else if (desc->Version == D3D_ROOT_SIGNATURE_VERSION_1_1)
-            {
-                rootSigParameterCount.insert_or_assign((ID3D12RootSignature*) *ppvRootSignature,
-                                                       desc->Desc_1_1.NumParameters);
-            }
-            else if (desc->Version == D3D_ROOT_SIGNATURE_VERSION_1_2)
-            {
-                rootSigParameterCount.insert_or_assign((ID3D12RootSignature*) *ppvRootSignature,
-                                                       desc->Desc_1_2.NumParameters);
-            }
-        }
+            StoreRootSignatureLayout(desc, *ppvRootSignature);
 
         deserializer->Release();
         return result;
@@ -1995,12 +1840,6 @@ static HRESULT hkCreateRootSignature(ID3D12Device* device, UINT nodeMask, const
     // Modify Samplers based on Version
     if (descCopy.Version == D3D_ROOT_SIGNATURE_VERSION_1_0)
     {
-        {
-            std::unique_lock<std::shared_mutex> lock(rootSigParameterCountMutex);
-            rootSigParameterCount.insert_or_assign((ID3D12RootSignature*) *ppvRootSignature,
-                                                   desc->Desc_1_0.NumParameters);
-        }
-
         if (descCopy.Desc_1_0.NumStaticSamplers > 0)
         {
             samplers.assign(descCopy.Desc_1_0.pStaticSamplers,
@@ -2014,12 +1853,6 @@ static HRESULT hkCreateRootSignature(ID3D12Device* device, UINT nodeMask, const
     }
     else if (descCopy.Version == D3D_ROOT_SIGNATURE_VERSION_1_1)
     {
-        {
-            std::unique_lock<std::shared_mutex> lock(rootSigParameterCountMutex);
-            rootSigParameterCount.insert_or_assign((ID3D12RootSignature*) *ppvRootSignature,
-                                                   desc->Desc_1_1.NumParameters);
-        }
-
         if (descCopy.Desc_1_1.NumStaticSamplers > 0)
         {
             samplers.assign(descCopy.Desc_1_1.pStaticSamplers,
@@ -2033,12 +1866,6 @@ static HRESULT hkCreateRootSignature(ID3D12Device* device, UINT nodeMask, const
     }
     else if (descCopy.Version == D3D_ROOT_SIGNATURE_VERSION_1_2)
     {
-        {
-            std::unique_lock<std::shared_mutex> lock(rootSigParameterCountMutex);
-            rootSigParameterCount.insert_or_assign((ID3D12RootSignature*) *ppvRootSignature,
-                                                   desc->Desc_1_2.NumParameters);
-        }
-
         if (descCopy.Desc_1_2.NumStaticSamplers > 0)
         {
             samplers1.assign(descCopy.Desc_1_2.pStaticSamplers,
@@ -2082,6 +1909,9 @@ static HRESULT hkCreateRootSignature(ID3D12Device* device, UINT nodeMask, const
             o_CreateRootSignature(device, nodeMask, pBlobWithRootSignature, blobLengthInBytes, riid, ppvRootSignature);
     }
 
+    if (SUCCEEDED(result))
+        StoreRootSignatureLayout(desc, *ppvRootSignature);
+
     deserializer->Release();
     return result;
 }
@@ -2359,192 +2189,207 @@ void D3D12Hooks::SetRootSignatureTracking(bool enable) { isUpscalerActive = !ena
 
 bool D3D12Hooks::CanRestoreRootSignature(ID3D12GraphicsCommandList* cmdList)
 {
-    std::unique_lock<std::shared_mutex> lock(rootSignatureMutex);
-    return signatures.contains(cmdList);
+    auto record = rootStateTracker.Find(cmdList);
+
+    if (record == nullptr)
+        return false;
+
+    root_state::State state;
+    record->Snapshot(state);
+
+    return state.Last != root_state::SignatureType::None;
 }
 
-bool D3D12Hooks::RestoreDescriptorHeaps(ID3D12GraphicsCommandList* cmdList)
+bool D3D12Hooks::RestoreDescriptorHeaps(ID3D12GraphicsCommandList* cmdList, const root_state::State& state)
 {
-    std::unique_lock<std::shared_mutex> lock(descriptorHeapsMutex);
-    if (descriptorHeaps.contains(cmdList))
+    if (state.HeapCount == 0)
+        return false;
+
+    if (state.Heaps[0] != 0)
     {
-        auto& heaps = descriptorHeaps[cmdList];
+        ID3D12DescriptorHeap* heaps[2] = { (ID3D12DescriptorHeap*) state.Heaps[0],
+                                           (ID3D12DescriptorHeap*) state.Heaps[1] };
 
-        if (heaps.NumDescriptorHeaps > 0 && heaps.Heaps[0] != nullptr)
+        if (auto hook = s_SetDescriptorHeaps.GetHook())
         {
-            if (auto hook = s_SetDescriptorHeaps.GetHook())
-            {
-                hook(cmdList, heaps.NumDescriptorHeaps, heaps.Heaps);
-            }
-            else
-            {
-                LOG_ERROR("Couldn't restore DescriptorHeaps, no original SetDescriptorHeaps");
-                return false;
-            }
+            hook(cmdList, state.HeapCount, heaps);
+        }
+        else
+        {
+            LOG_ERROR("Couldn't restore DescriptorHeaps, no original SetDescriptorHeaps");
+            return false;
         }
-
-        return true;
     }
 
-    return false;
+    return true;
 }
 
-bool D3D12Hooks::RestorePipelineState(ID3D12GraphicsCommandList* cmdList)
+bool D3D12Hooks::RestorePipelineState(ID3D12GraphicsCommandList* cmdList, const root_state::State& state)
 {
-    std::unique_lock<std::shared_mutex> lock(pipelineStatesMutex);
-    if (pipelineStates.contains(cmdList))
+    if (state.PipelineState == 0)
+        return false;
+
+    if (auto hook = s_SetPipelineState.GetHook())
     {
-        auto& pipelineState = pipelineStates[cmdList];
+        hook(cmdList, (ID3D12PipelineState*) state.PipelineState);
+    }
+    else
+    {
+        LOG_ERROR("Couldn't restore PipelineState, no original SetPipelineState");
+        return false;
+    }
 
-        if (auto hook = s_SetPipelineState.GetHook())
-        {
-            hook(cmdList, pipelineState);
-        }
-        else
+    return true;
+}
+
+// Root constants are kept per DWORD, each run of set values is restored with one call
+template <typename F> static void ForEachConstantRun(const root_state::Bindings& bindings, UINT index, F restore)
+{
+    UINT offset = bindings.SignatureLayout.ConstantOffset[index];
+    UINT count = bindings.SignatureLayout.ConstantCount[index];
+
+    auto isSet = [&](UINT i) { return (bindings.ConstantMask & (1ull << (offset + i))) != 0; };
+
+    for (UINT i = 0; i < count;)
+    {
+        if (!isSet(i))
         {
-            LOG_ERROR("Couldn't restore PipelineState, no original SetPipelineState");
-            return false;
+            i++;
+            continue;
         }
 
-        return true;
-    }
+        auto start = i;
 
-    return false;
+        while (i < count && isSet(i))
+            i++;
+
+        restore(i - start, &bindings.Constants[offset + start], start);
+    }
 }
 
-bool D3D12Hooks::RestoreComputeRootState(ID3D12GraphicsCommandList* cmdList)
+bool D3D12Hooks::RestoreComputeRootState(ID3D12GraphicsCommandList* cmdList, const root_state::State& state)
 {
-    std::unique_lock<std::shared_mutex> lock(rootStatesMutex);
-    if (rootStates.contains(cmdList))
+    auto& bindings = state.Compute;
+
+    if (bindings.Signature == 0)
+        return false;
+
+    for (uint32_t i = 0; i < bindings.SignatureLayout.Count; i++)
     {
-        auto& table = rootStates[cmdList];
+        auto& parameter = bindings.Parameters[i];
 
-        for (uint32_t i = 0; i < table.size(); i++)
+        if (parameter.Type == root_state::ParameterType::Table)
         {
-            if (table[i].type == RootEntryType::Table)
-            {
-                if (auto hook = s_SetComputeRootDescriptorTable.GetHook())
-                    hook(cmdList, i, table[i].rootDescriptorTable);
-                else
-                    LOG_ERROR("Couldn't restore ComputeRootDescriptorTable, no original SetComputeRootDescriptorTable");
-            }
-            else if (table[i].type == RootEntryType::Constant)
-            {
-                if (auto hook = s_SetComputeRoot32BitConstant.GetHook())
-                    hook(cmdList, i, table[i].Data[0], table[i].DestOffset);
-                else
-                    LOG_ERROR("Couldn't restore ComputeRoot32BitConstant, no original SetComputeRoot32BitConstant");
-            }
-            else if (table[i].type == RootEntryType::Constants)
-            {
-                if (auto hook = s_SetComputeRoot32BitConstants.GetHook())
-                {
-                    hook(cmdList, i, table[i].Num32BitValues, table[i].Data.data(), table[i].DestOffset);
-                }
-                else
-                {
-                    LOG_ERROR("Couldn't restore ComputeRoot32BitConstants, no original SetComputeRoot32BitConstants");
-                }
-            }
-            else if (table[i].type == RootEntryType::CBV)
-            {
-                if (auto hook = s_SetComputeRootConstantBufferView.GetHook())
-                    hook(cmdList, i, table[i].bufferLocation);
-                else
-                    LOG_ERROR("Couldn't restore ComputeRoot CBV, no original SetComputeRootConstantBufferView");
-            }
-            else if (table[i].type == RootEntryType::SRV)
-            {
-                if (auto hook = s_SetComputeRootShaderResourceView.GetHook())
-                    hook(cmdList, i, table[i].bufferLocation);
-                else
-                    LOG_ERROR("Couldn't restore ComputeRoot SRV, no original SetComputeRootShaderResourceView");
-            }
-            else if (table[i].type == RootEntryType::UAV)
+            if (auto hook = s_SetComputeRootDescriptorTable.GetHook())
+                hook(cmdList, i, D3D12_GPU_DESCRIPTOR_HANDLE { parameter.Value });
+            else
+                LOG_ERROR("Couldn't restore ComputeRootDescriptorTable, no original SetComputeRootDescriptorTable");
+        }
+        else if (parameter.Type == root_state::ParameterType::Constants)
+        {
+            if (auto hook = s_SetComputeRoot32BitConstants.GetHook())
             {
-                if (auto hook = s_SetComputeRootUnorderedAccessView.GetHook())
-                    hook(cmdList, i, table[i].bufferLocation);
-                else
-                    LOG_ERROR("Couldn't restore ComputeRoot UAV, no original SetComputeRootUnorderedAccessView");
+                ForEachConstantRun(bindings, i, [&](UINT count, const uint32_t* data, UINT offset)
+                                   { hook(cmdList, i, count, data, offset); });
             }
-            else if (table[i].type == RootEntryType::Invalid)
+            else
             {
-                LOG_WARN("Can't restore index: {} for CmdList: {:X}", i, (UINT64) cmdList);
+                LOG_ERROR("Couldn't restore ComputeRoot32BitConstants, no original SetComputeRoot32BitConstants");
             }
         }
-
-        return true;
+        else if (parameter.Type == root_state::ParameterType::CBV)
+        {
+            if (auto hook = s_SetComputeRootConstantBufferView.GetHook())
+                hook(cmdList, i, parameter.Value);
+            else
+                LOG_ERROR("Couldn't restore ComputeRoot CBV, no original SetComputeRootConstantBufferView");
+        }
+        else if (parameter.Type == root_state::ParameterType::SRV)
+        {
+            if (auto hook = s_SetComputeRootShaderResourceView.GetHook())
+                hook(cmdList, i, parameter.Value);
+            else
+                LOG_ERROR("Couldn't restore ComputeRoot SRV, no original SetComputeRootShaderResourceView");
+        }
+        else if (parameter.Type == root_state::ParameterType::UAV)
+        {
+            if (auto hook = s_SetComputeRootUnorderedAccessView.GetHook())
+                hook(cmdList, i, parameter.Value);
+            else
+                LOG_ERROR("Couldn't restore ComputeRoot UAV, no original SetComputeRootUnorderedAccessView");
+        }
+        else if (parameter.Type == root_state::ParameterType::Invalid)
+        {
+            LOG_WARN("Can't restore index: {} for CmdList: {:X}", i, (UINT64) cmdList);
+        }
     }
 
-    return false;
+    return true;
 }
 
-bool D3D12Hooks::RestoreGraphicsRootState(ID3D12GraphicsCommandList* cmdList)
+bool D3D12Hooks::RestoreGraphicsRootState(ID3D12GraphicsCommandList* cmdList, const root_state::State& state)
 {
-    std::unique_lock<std::shared_mutex> lock(rootStatesMutex);
-    if (rootStates.contains(cmdList))
+    auto& bindings = state.Graphics;
+
+    if (bindings.Signature == 0)
+        return false;
+
+    for (uint32_t i = 0; i < bindings.SignatureLayout.Count; i++)
     {
-        auto& table = rootStates[cmdList];
+        auto& parameter = bindings.Parameters[i];
 
-        for (uint32_t i = 0; i < table.size(); i++)
+        if (parameter.Type == root_state::ParameterType::Table)
         {
-            if (table[i].type == RootEntryType::Table)
-            {
-                if (auto hook = s_SetGraphicsRootDescriptorTable.GetHook())
-                {
-                    hook(cmdList, i, table[i].rootDescriptorTable);
-                }
-                else
-                {
-                    LOG_ERROR(
-                        "Couldn't restore GraphicsRootDescriptorTable, no original SetGraphicsRootDescriptorTable");
-                }
-            }
-            else if (table[i].type == RootEntryType::Constant)
+            if (auto hook = s_SetGraphicsRootDescriptorTable.GetHook())
             {
-                if (auto hook = s_SetGraphicsRoot32BitConstant.GetHook())
-                    hook(cmdList, i, table[i].Data[0], table[i].DestOffset);
-                else
-                    LOG_ERROR("Couldn't restore GraphicsRoot32BitConstant, no original SetGraphicsRoot32BitConstant");
-            }
-            else if (table[i].type == RootEntryType::Constants)
-            {
-                if (auto hook = s_SetGraphicsRoot32BitConstants.GetHook())
-                    hook(cmdList, i, table[i].Num32BitValues, table[i].Data.data(), table[i].DestOffset);
-                else
-                    LOG_ERROR("Couldn't restore GraphicsRoot32BitConstants, no original SetGraphicsRoot32BitConstants");
+                hook(cmdList, i, D3D12_GPU_DESCRIPTOR_HANDLE { parameter.Value });
             }
-            else if (table[i].type == RootEntryType::CBV)
-            {
-                if (auto hook = s_SetGraphicsRootConstantBufferView.GetHook())
-                    hook(cmdList, i, table[i].bufferLocation);
-                else
-                    LOG_ERROR("Couldn't restore GraphicsRoot CBV, no original SetGraphicsRootConstantBufferView");
-            }
-            else if (table[i].type == RootEntryType::SRV)
+            else
             {
-                if (auto hook = s_SetGraphicsRootShaderResourceView.GetHook())
-                    hook(cmdList, i, table[i].bufferLocation);
-                else
-                    LOG_ERROR("Couldn't restore GraphicsRoot SRV, no original SetGraphicsRootShaderResourceView");
+                LOG_ERROR(
+                    "Couldn't restore GraphicsRootDescriptorTable, no original SetGraphicsRootDescriptorTable");
             }
-            else if (table[i].type == RootEntryType::UAV)
+        }
+        else if (parameter.Type == root_state::ParameterType::Constants)
+        {
+            if (auto hook = s_SetGraphicsRoot32BitConstants.GetHook())
             {
-                if (auto hook = s_SetGraphicsRootUnorderedAccessView.GetHook())
-                    hook(cmdList, i, table[i].bufferLocation);
-                else
-                    LOG_ERROR("Couldn't restore GraphicsRoot UAV, no original SetGraphicsRootUnorderedAccessView");
+                ForEachConstantRun(bindings, i, [&](UINT count, const uint32_t* data, UINT offset)
+                                   { hook(cmdList, i, count, data, offset); });
             }
-            else if (table[i].type == RootEntryType::Invalid)
+            else
             {
-                LOG_WARN("Can't restore index: {} for CmdList: {:X}", i, (UINT64) cmdList);
+                LOG_ERROR("Couldn't restore GraphicsRoot32BitConstants, no original SetGraphicsRoot32BitConstants");
             }
         }
-
-        return true;
+        else if (parameter.Type == root_state::ParameterType::CBV)
+        {
+            if (auto hook = s_SetGraphicsRootConstantBufferView.GetHook())
+                hook(cmdList, i, parameter.Value);
+            else
+                LOG_ERROR("Couldn't restore GraphicsRoot CBV, no original SetGraphicsRootConstantBufferView");
+        }
+        else if (parameter.Type == root_state::ParameterType::SRV)
+        {
+            if (auto hook = s_SetGraphicsRootShaderResourceView.GetHook())
+                hook(cmdList, i, parameter.Value);
+            else
+                LOG_ERROR("Couldn't restore GraphicsRoot SRV, no original SetGraphicsRootShaderResourceView");
+        }
+        else if (parameter.Type == root_state::ParameterType::UAV)
+        {
+            if (auto hook = s_SetGraphicsRootUnorderedAccessView.GetHook())
+                hook(cmdList, i, parameter.Value);
+            else
+                LOG_ERROR("Couldn't restore GraphicsRoot UAV, no original SetGraphicsRootUnorderedAccessView");
+        }
+        else if (parameter.Type == root_state::ParameterType::Invalid)
+        {
+            LOG_WARN("Can't restore index: {} for CmdList: {:X}", i, (UINT64) cmdList);
+        }
     }
 
-    return false;
+    return true;
 }
 
 void D3D12Hooks::RestoreRoot(ID3D12GraphicsCommandList* cmdList)
@@ -2554,58 +2399,63 @@ void D3D12Hooks::RestoreRoot(ID3D12GraphicsCommandList* cmdList)
 
     if (restoreComputeSignature || restoreGraphicSignature)
     {
-        std::unique_lock<std::shared_mutex> lock(rootSignatureMutex);
+        // Taken once, restore calls below don't change the tracked state
+        root_state::State state;
+        auto record = rootStateTracker.Find(cmdList);
+
+        if (record != nullptr)
+            record->Snapshot(state);
 
-        if (signatures.contains(cmdList))
+        if (state.Last != root_state::SignatureType::None)
         {
-            auto& signature = signatures[cmdList];
+            auto& signature = state.For(state.Last);
             const bool extendedRestoreSignature = Config::Instance()->ExtendedStateRestore.value_or_default();
 
             if (extendedRestoreSignature)
             {
-                if (RestoreDescriptorHeaps(cmdList))
+                if (RestoreDescriptorHeaps(cmdList, state))
                     LOG_TRACE("Restored DescriptorHeaps for CmdList: {:X}", (UINT64) cmdList);
                 else
                     LOG_WARN("Can't restore DescriptorHeaps for CmdList: {:X}", (UINT64) cmdList);
             }
 
-            if (signature.type == SignatureEntryType::Compute)
+            if (state.Last == root_state::SignatureType::Compute)
             {
-                LOG_TRACE("Restore ComputeRootSig: {:X}, for CmdList: {:X}", (UINT64) signature.ptr, (UINT64) cmdList);
+                LOG_TRACE("Restore ComputeRootSig: {:X}, for CmdList: {:X}", signature.Signature, (UINT64) cmdList);
 
                 if (auto hook = s_SetComputeRootSignature.GetHook())
-                    hook(cmdList, signature.ptr);
+                    hook(cmdList, (ID3D12RootSignature*) signature.Signature);
                 else
                     LOG_ERROR("Couldn't restore Compute RootSignature, no original SetComputeRootSignature");
             }
-            else if (signature.type == SignatureEntryType::Graphics)
+            else if (state.Last == root_state::SignatureType::Graphics)
             {
-                LOG_TRACE("Restore GraphicsRootSig: {:X}, for CmdList: {:X}", (UINT64) signature.ptr, (UINT64) cmdList);
+                LOG_TRACE("Restore GraphicsRootSig: {:X}, for CmdList: {:X}", signature.Signature, (UINT64) cmdList);
 
                 if (auto hook = s_SetGraphicsRootSignature.GetHook())
-                    hook(cmdList, signature.ptr);
+                    hook(cmdList, (ID3D12RootSignature*) signature.Signature);
                 else
                     LOG_ERROR("Couldn't restore Graphics RootSignature, no original SetGraphicsRootSignature");
             }
 
             if (extendedRestoreSignature)
             {
-                if (signature.type == SignatureEntryType::Compute)
+                if (state.Last == root_state::SignatureType::Compute)
                 {
-                    if (RestoreComputeRootState(cmdList))
+                    if (RestoreComputeRootState(cmdList, state))
                         LOG_TRACE("Restored ComputeRootState for CmdList: {:X}", (UINT64) cmdList);
                     else
                         LOG_WARN("Can't restore ComputeRootState for CmdList: {:X}", (UINT64) cmdList);
                 }
-                else if (signature.type == SignatureEntryType::Graphics)
+                else if (state.Last == root_state::SignatureType::Graphics)
                 {
-                    if (RestoreGraphicsRootState(cmdList))
+                    if (RestoreGraphicsRootState(cmdList, state))
                         LOG_TRACE("Restored GraphicsRootState for CmdList: {:X}", (UINT64) cmdList);
                     else
                         LOG_WARN("Can't restore GraphicsRootState for CmdList: {:X}", (UINT64) cmdList);
                 }
 
-                if (RestorePipelineState(cmdList))
+                if (RestorePipelineState(cmdList, state))
                     LOG_TRACE("Restored PipelineState for CmdList: {:X}", (UINT64) cmdList);
                 else
                     LOG_TRACE("Can't restore PipelineState for CmdList: {:X}", (UINT64) cmdList);
@@ -1,5 +1,6 @@
 #pragma once
 #include "SysUtils.h"
+#include "RootStateTracker.h"
 #include <d3d12.h>
 
 class D3D12Hooks
@@ -8,10 +9,10 @@ class D3D12Hooks
     inline static std::mutex hookMutex;
     inline static std::mutex agilityMutex;
 
-    static bool RestoreDescriptorHeaps(ID3D12GraphicsCommandList* cmdList);
-    static bool RestorePipelineState(ID3D12GraphicsCommandList* cmdList);
-    static bool RestoreComputeRootState(ID3D12GraphicsCommandList* cmdList);
-    static bool RestoreGraphicsRootState(ID3D12GraphicsCommandList* cmdList);
+    static bool RestoreDescriptorHeaps(ID3D12GraphicsCommandList* cmdList, const root_state::State& state);
+    static bool RestorePipelineState(ID3D12GraphicsCommandList* cmdList, const root_state::State& state);
+    static bool RestoreComputeRootState(ID3D12GraphicsCommandList* cmdList, const root_state::State& state);
+    static bool RestoreGraphicsRootState(ID3D12GraphicsCommandList* cmdList, const root_state::State& state);
 
   public:
     static void Hook();
@@ -5,6 +5,7 @@
 #include <framegen/ffx/FSRFG_Dx12.h>
 #include <framegen/xefg/XeFG_Dx12.h>
 #include <framegen/dlssg/DLSSG_Dx12.h>
+#include <framegen/ResourcePool_Dx12.h>
 
 #include <inputs/FG/FSR3_Dx12_FG.h>
 #include <inputs/FG/FfxApi_Dx12_FG.h>
@@ -13,8 +14,8 @@
 #include <resource_tracking/ResTrack_Dx12.h>
 
 #include <misc/FrameLimit.h>
-#include <upscaler_time/UpscalerTime_Dx11.h>
-#include <upscaler_time/UpscalerTime_Dx12.h>
+#include <upscaler_time/GpuProfiler_Dx11.h>
+#include <upscaler_time/GpuProfiler_Dx12.h>
 
 #include <misc/IdentifyGpu.h>
 #include <hooks/Reflex_Hooks.h>
@@ -1124,6 +1125,9 @@ HRESULT FGHooks::FGPresent(IDXGISwapChain* This, UINT SyncInterval, UINT Flags,
         _lastFGFrameTime = now;
         state.lastFGFrameTime = ftDelta;
 
+        if (ftDelta > 0.0)
+            state.frameStats.Record(frame_stats::Series::FrameGen, ftDelta);
+
         LOG_DEBUG("flags: {:X}, Frametime: {}", Flags, ftDelta);
 
 #ifdef LOW_LATENCY_INPUTS
@@ -1140,15 +1144,19 @@ HRESULT FGHooks::FGPresent(IDXGISwapChain* This, UINT SyncInterval, UINT Flags,
         {
             ID3D11DeviceContext* context = nullptr;
             state.currentD3D11Device->GetImmediateContext(&context);
-            UpscalerTimeDx11::ReadUpscalingTime(context);
+            GpuProfilerDx11::EndFrame(context);
             context->Release();
         }
         else if (state.swapchainInteropApi == SwapchainInteropApi::None && state.currentCommandQueue != nullptr)
         {
-            UpscalerTimeDx12::ReadUpscalingTime(state.currentCommandQueue);
+            GpuProfilerDx12::EndFrame(state.currentCommandQueue);
         }
     }
 
+    // Pool is advanced on every present, Dx11wDx12 presents through the Dx12 queue too
+    if (willPresent && state.currentCommandQueue != nullptr)
+        ResourcePoolDx12::EndFrame(state.currentCommandQueue);
+
     bool mutexUsed = false;
     if (willPresent && fg != nullptr && fg->IsActive() && !fg->IsPaused() &&
         config->FGUseMutexForSwapchain.value_or_default() && fg->Mutex.getOwner() != 2)
@@ -1,6 +1,7 @@
 #include "pch.h"
 #include "Reflex_Hooks.h"
 #include <Config.h>
+#include <misc/FrameLimit.h>
 
 #include <nvapi/fakenvapi.h>
 
@@ -136,8 +137,14 @@ NvAPI_Status ReflexHooks::hkNvAPI_D3D_SetLatencyMarker(IUnknown* pDev,
     static bool skip[20] = {};
 
     if (pSetLatencyMarkerParams->markerType == SIMULATION_START)
+    {
         _lastMarkerFrame = State::Instance().fgLastFrame;
 
+        // Markers injected by RTSS don't tell when the game samples input
+        if ((pSetLatencyMarkerParams->frameID >> 32) == 0)
+            FrameLimit::simulationStart();
+    }
+
     if ((State::Instance().activeFgOutput == FGOutput::DLSSG ||
          State::Instance().activeFgOutput == FGOutput::DLSSGWithNvngx) &&
         StreamlineProxy::IsD3D12Inited() && Config::Instance()->FGDLSSGUseGamesReflexMarkers.value_or_default() &&
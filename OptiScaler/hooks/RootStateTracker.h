@@ -0,0 +1,510 @@
+#pragma once
+
+#include <array>
+#include <algorithm>
+#include <atomic>
+#include <mutex>
+#include <thread>
+#include <memory>
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+#include <cstring>
+#include <type_traits>
+#include <unordered_map>
+
+// Root state of game's command lists, restored after the upscaler records its own work.
+// Each command list gets its own record in a slab and only the thread recording the list writes it,
+// so recording threads don't share any lock. Records are found through a lock free pointer table and
+// a per thread cache, readers take a consistent copy with a sequence lock.
+// Records of destroyed lists are reused, only adding and removing a list takes a lock.
+// Pointers and handles are kept as integers, so the core has no platform dependencies.
+namespace root_state
+{
+
+// Root signatures are limited to 64 DWORDs, so to 64 parameters and 64 root constants
+inline constexpr uint32_t MaxParameters = 64;
+inline constexpr uint32_t MaxConstants = 64;
+
+enum class SignatureType : uint32_t
+{
+    None,
+    Compute,
+    Graphics,
+};
+
+enum class ParameterType : uint32_t
+{
+    Invalid,
+    Table,
+    Constants,
+    CBV,
+    SRV,
+    UAV,
+};
+
+// Where the root constants of each parameter are kept
+struct Layout
+{
+    uint32_t Count = 0;
+    uint32_t ConstantsUsed = 0;
+    std::array<uint8_t, MaxParameters> ConstantOffset {};
+    std::array<uint8_t, MaxParameters> ConstantCount {};
+
+    // constantCount is 0 for tables and root descriptors
+    bool AddParameter(uint32_t constantCount)
+    {
+        if (Count >= MaxParameters || ConstantsUsed + constantCount > MaxConstants)
+            return false;
+
+        ConstantOffset[Count] = (uint8_t) ConstantsUsed;
+        ConstantCount[Count] = (uint8_t) constantCount;
+        ConstantsUsed += constantCount;
+        Count++;
+
+        return true;
+    }
+};
+
+struct Parameter
+{
+    ParameterType Type = ParameterType::Invalid;
+
+    // Descriptor table handle or root descriptor address
+    uint64_t Value = 0;
+};
+
+struct Bindings
+{
+    uint64_t Signature = 0;
+    Layout SignatureLayout;
+    std::array<Parameter, MaxParameters> Parameters {};
+    std::array<uint32_t, MaxConstants> Constants {};
+
+    // Which Constants are set
+    uint64_t ConstantMask = 0;
+};
+
+struct State
+{
+    uint64_t PipelineState = 0;
+    uint32_t HeapCount = 0;
+    std::array<uint64_t, 2> Heaps {};
+
+    // Type of the last set root signature
+    SignatureType Last = SignatureType::None;
+
+    Bindings Compute;
+    Bindings Graphics;
+
+    Bindings& For(SignatureType type) { return type == SignatureType::Graphics ? Graphics : Compute; }
+    const Bindings& For(SignatureType type) const { return type == SignatureType::Graphics ? Graphics : Compute; }
+};
+
+static_assert(std::is_trivially_copyable_v<State>, "State is published as raw words");
+
+// Written only by the thread recording the command list.
+// The writer works on its own copy and publishes changed bytes to atomic words, which readers copy back.
+class Record
+{
+  private:
+    static constexpr size_t WordCount = (sizeof(State) + sizeof(uint64_t) - 1) / sizeof(uint64_t);
+
+    std::atomic<uint32_t> _sequence { 0 };
+    State _state;
+    std::array<std::atomic<uint64_t>, WordCount> _words {};
+
+    // Odd sequence marks a write in progress
+    void BeginWrite()
+    {
+        _sequence.store(_sequence.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+    }
+
+    void EndWrite() { _sequence.store(_sequence.load(std::memory_order_relaxed) + 1, std::memory_order_release); }
+
+    // Copies the words covering a member of _state to the shared words
+    void Publish(const void* member, size_t size)
+    {
+        auto base = reinterpret_cast<const uint8_t*>(&_state);
+        auto begin = (size_t) (static_cast<const uint8_t*>(member) - base);
+
+        for (auto i = begin / sizeof(uint64_t); i * sizeof(uint64_t) < begin + size; i++)
+        {
+            uint64_t word = 0;
+            auto offset = i * sizeof(uint64_t);
+            std::memcpy(&word, base + offset, std::min(sizeof(uint64_t), sizeof(State) - offset));
+            _words[i].store(word, std::memory_order_relaxed);
+        }
+    }
+
+    template <typename T> void Publish(const T& member) { Publish(&member, sizeof(T)); }
+
+  public:
+    Record() { Publish(_state); }
+
+    void SetPipelineState(uint64_t pipelineState)
+    {
+        BeginWrite();
+        _state.PipelineState = pipelineState;
+        Publish(_state.PipelineState);
+        EndWrite();
+    }
+
+    void SetDescriptorHeaps(uint32_t count, uint64_t heap0, uint64_t heap1)
+    {
+        BeginWrite();
+        _state.HeapCount = count > 2 ? 2 : count;
+        _state.Heaps = { heap0, heap1 };
+        Publish(_state.HeapCount);
+        Publish(_state.Heaps);
+        EndWrite();
+    }
+
+    // Bindings are only kept while the same root signature is set, like on the GPU
+    void SetSignature(SignatureType type, uint64_t signature, const Layout& layout)
+    {
+        BeginWrite();
+
+        auto& bindings = _state.For(type);
+
+        if (bindings.Signature != signature)
+        {
+            bindings.Signature = signature;
+            bindings.SignatureLayout = layout;
+            bindings.Parameters = {};
+            bindings.ConstantMask = 0;
+            Publish(bindings);
+        }
+
+        _state.Last = type;
+        Publish(_state.Last);
+
+        EndWrite();
+    }
+
+    void SetParameter(SignatureType type, uint32_t index, ParameterType parameterType, uint64_t value)
+    {
+        auto& bindings = _state.For(type);
+
+        if (index >= bindings.SignatureLayout.Count)
+            return;
+
+        BeginWrite();
+        bindings.Parameters[index] = { parameterType, value };
+        Publish(bindings.Parameters[index]);
+        EndWrite();
+    }
+
+    void SetConstants(SignatureType type, uint32_t index, uint32_t count, const uint32_t* data, uint32_t destOffset)
+    {
+        auto& bindings = _state.For(type);
+        auto& layout = bindings.SignatureLayout;
+
+        if (index >= layout.Count || destOffset + count > layout.ConstantCount[index])
+            return;
+
+        BeginWrite();
+
+        auto offset = layout.ConstantOffset[index] + destOffset;
+
+        for (uint32_t i = 0; i < count; i++)
+        {
+            bindings.Constants[offset + i] = data[i];
+            bindings.ConstantMask |= 1ull << (offset + i);
+        }
+
+        bindings.Parameters[index].Type = ParameterType::Constants;
+
+        Publish(&bindings.Constants[offset], count * sizeof(uint32_t));
+        Publish(bindings.ConstantMask);
+        Publish(bindings.Parameters[index].Type);
+
+        EndWrite();
+    }
+
+    // Record is reused for a new command list
+    void Clear()
+    {
+        BeginWrite();
+        _state = {};
+        Publish(_state);
+        EndWrite();
+    }
+
+    // Same thread as the writer, no copy needed
+    const State& Current() const { return _state; }
+
+    // Consistent copy from any thread
+    void Snapshot(State& out) const
+    {
+        while (true)
+        {
+            auto before = _sequence.load(std::memory_order_acquire);
+
+            if ((before & 1) == 0)
+            {
+                auto bytes = reinterpret_cast<uint8_t*>(&out);
+
+                for (size_t i = 0; i < WordCount; i++)
+                {
+                    auto word = _words[i].load(std::memory_order_relaxed);
+                    auto offset = i * sizeof(uint64_t);
+                    std::memcpy(bytes + offset, &word, std::min(sizeof(uint64_t), sizeof(State) - offset));
+                }
+
+                std::atomic_thread_fence(std::memory_order_acquire);
+
+                if (_sequence.load(std::memory_order_relaxed) == before)
+                    return;
+            }
+
+            std::this_thread::yield();
+        }
+    }
+};
+
+// Capacity is the number of command lists kept in the lock free table, lists over it go to a locked map.
+// Slots of released lists are reused, so the table only has to fit the lists alive at the same time.
+// Adding and removing lists is serialized, D3D12 command lists are recorded by one thread at a time.
+template <size_t Capacity> class Tracker
+{
+    static_assert(Capacity % 64 == 0, "Capacity must be a multiple of chunk size");
+
+  private:
+    static constexpr size_t ChunkSize = 64;
+    static constexpr size_t TableSize = Capacity * 2;
+
+    // Key of a removed list, lookups probe past it and adds reuse it. Entries never go back to empty
+    static constexpr uintptr_t Removed = UINTPTR_MAX;
+
+    struct Chunk
+    {
+        std::array<Record, ChunkSize> Records;
+    };
+
+    struct Entry
+    {
+        std::atomic<uintptr_t> Key { 0 };
+
+        // Written before the key is published
+        std::atomic<uint32_t> Slot { 0 };
+    };
+
+    struct CacheEntry
+    {
+        const Tracker* Owner = nullptr;
+        uintptr_t Key = 0;
+        uint64_t Generation = 0;
+        Record* Value = nullptr;
+    };
+
+    std::array<Entry, TableSize> _table {};
+    std::array<std::atomic<Chunk*>, Capacity / ChunkSize> _chunks {};
+
+    // Taken by adds and removes, lookups of tracked lists don't take it
+    std::mutex _mutex;
+    uint32_t _next = 0;
+    std::vector<uint32_t> _freeSlots;
+    std::unordered_map<uintptr_t, std::unique_ptr<Record>> _overflow;
+    std::atomic<size_t> _overflowCount { 0 };
+
+    // Bumped on every removal, drops the per thread caches which could point to a reused record
+    std::atomic<uint64_t> _generation { 0 };
+    std::atomic<uint32_t> _count { 0 };
+
+    static size_t Hash(uintptr_t key)
+    {
+        uint64_t h = (uint64_t) key;
+        h ^= h >> 33;
+        h *= 0xFF51AFD7ED558CCDull;
+        h ^= h >> 33;
+        return (size_t) h & (TableSize - 1);
+    }
+
+    Record* RecordAt(uint32_t slot)
+    {
+        return &_chunks[slot / ChunkSize].load(std::memory_order_acquire)->Records[slot % ChunkSize];
+    }
+
+    Entry* FindEntry(uintptr_t key)
+    {
+        auto index = Hash(key);
+
+        for (size_t i = 0; i < TableSize; i++, index = (index + 1) & (TableSize - 1))
+        {
+            auto& entry = _table[index];
+            auto current = entry.Key.load(std::memory_order_acquire);
+
+            if (current == key)
+                return &entry;
+
+            if (current == 0)
+                return nullptr;
+        }
+
+        return nullptr;
+    }
+
+    Record* Lookup(uintptr_t key)
+    {
+        if (auto entry = FindEntry(key); entry != nullptr)
+            return RecordAt(entry->Slot.load(std::memory_order_relaxed));
+
+        if (_overflowCount.load(std::memory_order_acquire) == 0)
+            return nullptr;
+
+        std::scoped_lock lock(_mutex);
+        auto it = _overflow.find(key);
+        return it != _overflow.end() ? it->second.get() : nullptr;
+    }
+
+    // Mutex must be held
+    bool AllocateSlot(uint32_t& slot)
+    {
+        if (!_freeSlots.empty())
+        {
+            slot = _freeSlots.back();
+            _freeSlots.pop_back();
+            return true;
+        }
+
+        if (_next >= Capacity)
+            return false;
+
+        slot = _next++;
+        auto& chunk = _chunks[slot / ChunkSize];
+
+        // Only happens once per 64 command lists
+        if (chunk.load(std::memory_order_relaxed) == nullptr)
+            chunk.store(new Chunk(), std::memory_order_release);
+
+        return true;
+    }
+
+    // Mutex must be held
+    Entry* FreeEntry(uintptr_t key)
+    {
+        auto index = Hash(key);
+
+        for (size_t i = 0; i < TableSize; i++, index = (index + 1) & (TableSize - 1))
+        {
+            auto current = _table[index].Key.load(std::memory_order_relaxed);
+
+            if (current == 0 || current == Removed)
+                return &_table[index];
+        }
+
+        return nullptr;
+    }
+
+    Record* Add(uintptr_t key)
+    {
+        std::scoped_lock lock(_mutex);
+
+        if (auto entry = FindEntry(key); entry != nullptr)
+            return RecordAt(entry->Slot.load(std::memory_order_relaxed));
+
+        if (auto it = _overflow.find(key); it != _overflow.end())
+            return it->second.get();
+
+        uint32_t slot = 0;
+        Entry* entry = nullptr;
+
+        if (AllocateSlot(slot))
+        {
+            entry = FreeEntry(key);
+
+            if (entry == nullptr)
+                _freeSlots.push_back(slot);
+        }
+
+        _count.fetch_add(1, std::memory_order_relaxed);
+
+        if (entry == nullptr)
+        {
+            auto record = _overflow.emplace(key, std::make_unique<Record>()).first->second.get();
+            _overflowCount.fetch_add(1, std::memory_order_release);
+            return record;
+        }
+
+        // Reused slots still have the state of the released list
+        auto record = RecordAt(slot);
+        record->Clear();
+
+        entry->Slot.store(slot, std::memory_order_relaxed);
+        entry->Key.store(key, std::memory_order_release);
+
+        return record;
+    }
+
+  public:
+    Tracker() = default;
+    Tracker(const Tracker&) = delete;
+    Tracker& operator=(const Tracker&) = delete;
+
+    ~Tracker()
+    {
+        for (auto& chunk : _chunks)
+            delete chunk.load(std::memory_order_acquire);
+    }
+
+    // Record of the command list, added on first use
+    Record* Acquire(const void* commandList)
+    {
+        // Recording threads usually make many calls on the same list in a row
+        static thread_local CacheEntry cache;
+
+        auto key = (uintptr_t) commandList;
+        auto generation = _generation.load(std::memory_order_acquire);
+
+        if (cache.Owner == this && cache.Key == key && cache.Generation == generation)
+            return cache.Value;
+
+        auto record = Lookup(key);
+
+        if (record == nullptr)
+            record = Add(key);
+
+        cache = { this, key, generation, record };
+
+        return record;
+    }
+
+    // nullptr when nothing was recorded for the command list
+    Record* Find(const void* commandList) { return Lookup((uintptr_t) commandList); }
+
+    // Called when the command list is destroyed, its slot is reused by the next new list
+    void Remove(const void* commandList)
+    {
+        auto key = (uintptr_t) commandList;
+
+        // Most released objects were never tracked
+        if (FindEntry(key) == nullptr && _overflowCount.load(std::memory_order_acquire) == 0)
+            return;
+
+        std::scoped_lock lock(_mutex);
+
+        if (auto entry = FindEntry(key); entry != nullptr)
+        {
+            _freeSlots.push_back(entry->Slot.load(std::memory_order_relaxed));
+            entry->Key.store(Removed, std::memory_order_release);
+        }
+        else if (_overflow.erase(key) != 0)
+        {
+            _overflowCount.fetch_sub(1, std::memory_order_release);
+        }
+        else
+        {
+            return;
+        }
+
+        _generation.fetch_add(1, std::memory_order_release);
+        _count.fetch_sub(1, std::memory_order_relaxed);
+    }
+
+    // Tracked lists, including the ones in the locked map
+    uint32_t Count() const { return _count.load(std::memory_order_relaxed); }
+};
+
+} // namespace root_state
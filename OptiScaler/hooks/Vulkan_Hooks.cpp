@@ -8,7 +8,7 @@
 
 #include <menu/menu_overlay_vk.h>
 #include <proxies/KernelBase_Proxy.h>
-#include <upscaler_time/UpscalerTime_Vk.h>
+#include <upscaler_time/GpuProfiler_Vk.h>
 
 #include <misc/FrameLimit.h>
 #include "Reflex_Hooks.h"
@@ -240,8 +240,8 @@ static VkResult hkvkQueuePresentKHR(VkQueue queue, const VkPresentInfoKHR* pPres
 {
     LOG_FUNC();
 
-    // get upscaler time
-    UpscalerTimeVk::ReadUpscalingTime(_device);
+    // read finished GPU timings
+    GpuProfilerVk::EndFrame(_device);
 
     // ??? TODO: if we are hooking dxvk's vulkan calls then this present call could be either coming from dxvk or from a
     // native vk game
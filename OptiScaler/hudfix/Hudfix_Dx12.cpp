@@ -6,6 +6,8 @@
 #include <Config.h>
 
 #include <framegen/IFGFeature_Dx12.h>
+#include <framegen/ResourcePool_Dx12.h>
+#include <upscaler_time/GpuProfiler_Dx12.h>
 
 inline static int GetFormatGroup(DXGI_FORMAT format)
 {
@@ -157,23 +159,6 @@ bool Hudfix_Dx12::CreateBufferResource(ID3D12Device* InDevice, ResourceInfo* InS
     if (InDevice == nullptr || InSource == nullptr || InSource->buffer == nullptr)
         return false;
 
-    if (*OutResource != nullptr)
-    {
-        auto bufDesc = (*OutResource)->GetDesc();
-
-        if (bufDesc.Width != (UINT64) (InSource->width) || bufDesc.Height != (UINT) (InSource->height) ||
-            bufDesc.Format != InSource->format)
-        {
-            (*OutResource)->Release();
-            (*OutResource) = nullptr;
-            LOG_WARN("Release {}x{}, new one: {}x{}", bufDesc.Width, bufDesc.Height, InSource->width, InSource->height);
-        }
-        else
-        {
-            return true;
-        }
-    }
-
     D3D12_HEAP_PROPERTIES heapProperties;
     D3D12_HEAP_FLAGS heapFlags;
     HRESULT hr = InSource->buffer->GetHeapProperties(&heapProperties, &heapFlags);
@@ -187,17 +172,7 @@ bool Hudfix_Dx12::CreateBufferResource(ID3D12Device* InDevice, ResourceInfo* InS
     D3D12_RESOURCE_DESC texDesc = InSource->buffer->GetDesc();
     texDesc.Flags = D3D12_RESOURCE_FLAG_ALLOW_RENDER_TARGET | D3D12_RESOURCE_FLAG_ALLOW_UNORDERED_ACCESS;
 
-    hr = InDevice->CreateCommittedResource(&heapProperties, D3D12_HEAP_FLAG_NONE, &texDesc, InState, nullptr,
-                                           IID_PPV_ARGS(OutResource));
-
-    if (hr != S_OK)
-    {
-        LOG_ERROR("CreateCommittedResource result: {:X}", (UINT64) hr);
-        return false;
-    }
-
-    LOG_DEBUG("Created new one: {}x{}", texDesc.Width, texDesc.Height);
-    return true;
+    return ResourcePoolDx12::Ensure(InDevice, texDesc, heapProperties, InState, OutResource);
 }
 
 bool Hudfix_Dx12::CreateBufferResourceWithSize(ID3D12Device* InDevice, ResourceInfo* InSource,
@@ -207,22 +182,6 @@ bool Hudfix_Dx12::CreateBufferResourceWithSize(ID3D12Device* InDevice, ResourceI
     if (InDevice == nullptr || InSource == nullptr)
         return false;
 
-    if (*OutResource != nullptr)
-    {
-        auto bufDesc = (*OutResource)->GetDesc();
-
-        if (bufDesc.Width != (UINT64) InWidth || bufDesc.Height != InHeight || bufDesc.Format != InSource->format)
-        {
-            (*OutResource)->Release();
-            (*OutResource) = nullptr;
-            LOG_WARN("Release {}x{}, new one: {}x{}", bufDesc.Width, bufDesc.Height, InWidth, InHeight);
-        }
-        else
-        {
-            return true;
-        }
-    }
-
     D3D12_HEAP_PROPERTIES heapProperties;
     D3D12_HEAP_FLAGS heapFlags;
     HRESULT hr = InSource->buffer->GetHeapProperties(&heapProperties, &heapFlags);
@@ -239,17 +198,7 @@ bool Hudfix_Dx12::CreateBufferResourceWithSize(ID3D12Device* InDevice, ResourceI
     texDesc.Width = InWidth;
     texDesc.Height = InHeight;
 
-    hr = InDevice->CreateCommittedResource(&heapProperties, D3D12_HEAP_FLAG_NONE, &texDesc, InState, nullptr,
-                                           IID_PPV_ARGS(OutResource));
-
-    if (hr != S_OK)
-    {
-        LOG_ERROR("CreateCommittedResource result: {:X}", (UINT64) hr);
-        return false;
-    }
-
-    LOG_DEBUG("Created new one: {}x{}", InWidth, InHeight);
-    return true;
+    return ResourcePoolDx12::Ensure(InDevice, texDesc, heapProperties, InState, OutResource);
 }
 
 void Hudfix_Dx12::ResourceBarrier(ID3D12GraphicsCommandList* InCommandList, ID3D12Resource* InResource,
@@ -267,7 +216,52 @@ void Hudfix_Dx12::ResourceBarrier(ID3D12GraphicsCommandList* InCommandList, ID3D
     InCommandList->ResourceBarrier(1, &barrier);
 }
 
-bool Hudfix_Dx12::CheckCapture()
+#pragma region Hudless profile
+
+static hudless_profile::ProfileFile _profileFile;
+
+static std::filesystem::path ProfilePath() { return Util::DllPath().parent_path() / "OptiScaler.hudless"; }
+
+static std::string ProfileKey()
+{
+    auto u8 = Util::ExePath().filename().u8string();
+    return std::string(u8.begin(), u8.end());
+}
+
+// _checkMutex must be held
+void Hudfix_Dx12::LoadProfile()
+{
+    if (_profileLoaded)
+        return;
+
+    _profileLoaded = true;
+    _profileFile.Load(ProfilePath());
+
+    auto signature = _profileFile.Lookup(ProfileKey());
+    _profile.SetStored(signature);
+
+    if (signature.has_value())
+    {
+        LOG_INFO("Loaded hudless profile, format: {}, size ratio: {}x{}, capture: {:X}, ordinal: {}", signature->Format,
+                 signature->WidthRatio, signature->HeightRatio, signature->CaptureInfo, signature->Ordinal);
+    }
+}
+
+// _checkMutex must be held, nullopt removes the profile of current exe
+void Hudfix_Dx12::SaveProfile(std::optional<hudless_profile::Signature> signature)
+{
+    if (signature.has_value())
+        _profileFile.Store(ProfileKey(), signature.value());
+    else
+        _profileFile.Remove(ProfileKey());
+
+    if (_profileFile.IsDirty() && !_profileFile.Save(ProfilePath()))
+        LOG_WARN("Can't save hudless profile");
+}
+
+#pragma endregion
+
+bool Hudfix_Dx12::CheckCapture(bool ignoreLimit)
 {
     auto fIndex = GetIndex();
 
@@ -285,7 +279,7 @@ bool Hudfix_Dx12::CheckCapture()
         LOG_TRACE("frameCounter: {}, _captureCounter: {}, Limit: {}", State::Instance().currentFeature->FrameCount(),
                   _captureCounter[fIndex], Config::Instance()->FGHUDLimit.value_or_default());
 
-        if (_captureCounter[fIndex] < Config::Instance()->FGHUDLimit.value_or_default())
+        if (!ignoreLimit && _captureCounter[fIndex] < Config::Instance()->FGHUDLimit.value_or_default())
             return false;
     }
 
@@ -512,6 +506,46 @@ void Hudfix_Dx12::UpscaleEnd(UINT64 frameId, double lastFGFrameTime)
     auto index = GetIndex();
     _captureCounter[index] = 0;
     _skipHudlessChecks = false;
+
+    auto candidateCount = _candidateOrdinal.exchange(0, std::memory_order_relaxed);
+    auto useProfile = Config::Instance()->FGHUDFixProfile.value_or_default();
+    auto useScoring = Config::Instance()->FGHUDFixScoring.value_or_default();
+
+    if (!useProfile && !useScoring)
+        return;
+
+    std::lock_guard<std::mutex> lock(_checkMutex);
+
+    if (useProfile)
+    {
+        LoadProfile();
+
+        if (_profile.FrameEnd(candidateCount))
+        {
+            LOG_WARN("Hudless profile didn't match for {} frames, removing it", hudless_profile::MaxMissFrames);
+            SaveProfile(std::nullopt);
+        }
+    }
+
+    if (useScoring)
+    {
+        auto limit = Config::Instance()->FGHUDLimit.value_or_default();
+
+        hudless_scoring::FrameSettings settings;
+        settings.DisplayFormatGroup = GetFormatGroup(State::Instance().currentSwapchainDesc.BufferDesc.Format);
+        settings.PreferredRank = limit > 1 ? limit - 1 : 0;
+
+        if (useProfile)
+            settings.Profile = _profile.Stored();
+
+        auto decision = _scoring.EndFrame(settings);
+
+        if (decision.Elected)
+        {
+            LOG_TRACE("Elected {:X} as hudless, score: {}, candidates: {}/{}", decision.Winner.Key, decision.Score,
+                      decision.Distinct, decision.Candidates);
+        }
+    }
 }
 
 void Hudfix_Dx12::PresentStart() { _fgCounter = _upscaleCounter; }
@@ -585,6 +619,12 @@ bool Hudfix_Dx12::CheckForHudless(ID3D12GraphicsCommandList* cmdList, ResourceIn
             break;
         }
 
+        auto ordinal = _candidateOrdinal.fetch_add(1, std::memory_order_relaxed);
+
+        auto& scDesc = s.currentSwapchainDesc.BufferDesc;
+        auto signature = hudless_profile::MakeSignature((UINT) resource->format, resource->width, resource->height,
+                                                        scDesc.Width, scDesc.Height, resource->captureInfo, ordinal);
+
         CapturedHudlessInfo* capturedHudlessInfo = nullptr;
         auto it = s.capturedHudlesses.find(resource->buffer);
         if (it != s.capturedHudlesses.end())
@@ -598,11 +638,50 @@ bool Hudfix_Dx12::CheckForHudless(ID3D12GraphicsCommandList* cmdList, ResourceIn
             }
         }
 
+        // Scoring only records the candidate, capture is done for the one elected at last frame boundary
+        auto elected = false;
+
+        if (Config::Instance()->FGHUDFixScoring.value_or_default())
+        {
+            hudless_scoring::Candidate candidate { (uint64_t) resource->buffer, signature.Format,
+                                                   GetFormatGroup(resource->format), signature.WidthRatio,
+                                                   signature.HeightRatio, signature.CaptureInfo, ordinal };
+
+            if (!_scoring.Record(candidate))
+                break;
+
+            LOG_DEBUG("Resource {:X} is the elected hudless, ordinal: {}", (size_t) resource->buffer, ordinal);
+            elected = true;
+        }
+
         // Prevent double capture
         LOG_DEBUG("Waiting _checkMutex");
         std::lock_guard<std::mutex> lock(_checkMutex);
 
-        if (!ignoreBlocked && Config::Instance()->FGResourceBlocking.value_or_default())
+        auto useProfile = Config::Instance()->FGHUDFixProfile.value_or_default();
+        auto decision = hudless_profile::Decision::Regular;
+
+        if (useProfile && !elected)
+        {
+            LoadProfile();
+            decision = _profile.Check(signature);
+        }
+
+        if (decision == hudless_profile::Decision::Defer)
+        {
+            LOG_TRACE("Deferring {:X}, ordinal: {}, waiting for profile match", (size_t) resource->buffer, ordinal);
+            break;
+        }
+
+        auto profileMatch = decision == hudless_profile::Decision::Capture;
+
+        if (profileMatch)
+            LOG_DEBUG("Resource {:X} matches the hudless profile, ordinal: {}", (size_t) resource->buffer, ordinal);
+
+        // Elected or matching candidates are captured without blocking checks and delay
+        auto skipChecks = elected || profileMatch;
+
+        if (!ignoreBlocked && !skipChecks && Config::Instance()->FGResourceBlocking.value_or_default())
         {
             if (_hudlessList.contains(resource->buffer))
             {
@@ -695,7 +774,7 @@ bool Hudfix_Dx12::CheckForHudless(ID3D12GraphicsCommandList* cmdList, ResourceIn
             }
         }
 
-        if (!CheckCapture())
+        if (!CheckCapture(skipChecks))
             break;
 
         auto fIndex = GetIndex();
@@ -723,7 +802,9 @@ bool Hudfix_Dx12::CheckForHudless(ID3D12GraphicsCommandList* cmdList, ResourceIn
                 if (state != D3D12_RESOURCE_STATE_VIDEO_ENCODE_WRITE)
                     ResourceBarrier(cmdList, resource->buffer, resource->state, D3D12_RESOURCE_STATE_COPY_SOURCE);
 
+                GpuProfilerDx12::Begin(cmdList, gpu_profiler::Scope::HudfixCopy);
                 cmdList->CopyResource(_captureBuffer[fIndex], resource->buffer);
+                GpuProfilerDx12::End(cmdList, gpu_profiler::Scope::HudfixCopy);
 
                 // Using state D3D12_RESOURCE_STATE_VIDEO_ENCODE_WRITE as skip flag
                 if (state != D3D12_RESOURCE_STATE_VIDEO_ENCODE_WRITE)
@@ -909,6 +990,14 @@ bool Hudfix_Dx12::CheckForHudless(ID3D12GraphicsCommandList* cmdList, ResourceIn
         _skipHudlessChecks = true;
         HudlessFound(cmdList);
 
+        if (useProfile && _profile.Captured(signature))
+        {
+            LOG_INFO("Saving hudless profile, format: {}, size ratio: {}x{}, capture: {:X}, ordinal: {}",
+                     signature.Format, signature.WidthRatio, signature.HeightRatio, signature.CaptureInfo,
+                     signature.Ordinal);
+            SaveProfile(signature);
+        }
+
         if (capturedHudlessInfo != nullptr)
         {
             capturedHudlessInfo->usageCount++;
@@ -943,6 +1032,11 @@ void Hudfix_Dx12::ResetCounters()
 
     _hudlessList.clear();
 
+    {
+        std::lock_guard<std::mutex> lock(_checkMutex);
+        _scoring.Reset();
+    }
+
     _captureCounter[0] = 0;
     _captureCounter[1] = 0;
     _captureCounter[2] = 0;
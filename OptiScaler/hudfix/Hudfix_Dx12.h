@@ -2,9 +2,13 @@
 #include "SysUtils.h"
 #include <shaders/format_transfer/FT_Dx12.h>
 
+#include "HudlessProfile.h"
+#include "HudlessScoring.h"
+
 #include <ankerl/unordered_dense.h>
 
 #include <set>
+#include <atomic>
 #include <dxgi.h>
 #include <d3d12.h>
 #include <shared_mutex>
@@ -96,6 +100,19 @@ class Hudfix_Dx12
 
     inline static bool _skipHudlessChecks = false;
 
+    // Per game hudless profile, guarded by _checkMutex
+    inline static hudless_profile::Tracker _profile;
+    inline static bool _profileLoaded = false;
+
+    // Candidate scoring, used instead of sequential checks when FGHUDFixScoring is enabled
+    inline static hudless_scoring::Engine _scoring;
+
+    // Order of the candidate in current upscale frame
+    inline static std::atomic<uint32_t> _candidateOrdinal = 0;
+
+    static void LoadProfile();
+    static void SaveProfile(std::optional<hudless_profile::Signature> signature);
+
     static bool CreateObjects();
     static bool CreateBufferResource(ID3D12Device* InDevice, ResourceInfo* InSource, D3D12_RESOURCE_STATES InState,
                                      ID3D12Resource** OutResource);
@@ -105,8 +122,8 @@ class Hudfix_Dx12
     static void ResourceBarrier(ID3D12GraphicsCommandList* InCommandList, ID3D12Resource* InResource,
                                 D3D12_RESOURCE_STATES InBeforeState, D3D12_RESOURCE_STATES InAfterState);
 
-    // Check _captureCounter for current frame
-    static bool CheckCapture();
+    // Check _captureCounter for current frame, ignoreLimit skips the HUDLimit delay
+    static bool CheckCapture(bool ignoreLimit = false);
 
     static void HudlessFound(ID3D12GraphicsCommandList* cmdList);
 
@@ -0,0 +1,333 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <fstream>
+#include <sstream>
+#include <optional>
+#include <filesystem>
+
+// Remembers which resource was the hudless one for each game.
+// On next launch the stored signature is matched before the regular checks,
+// so hudless can be found at the first frame. No platform dependencies, so it can be tested on any OS.
+namespace hudless_profile
+{
+
+// Size ratios are stored in 1/1000 of the display size
+inline constexpr uint32_t RatioScale = 1000;
+inline constexpr uint32_t RatioTolerance = 5;
+
+// Candidates of the frame don't arrive in exactly same order when command lists are recorded in parallel
+inline constexpr uint32_t MinOrdinalTolerance = 2;
+
+// Profile is dropped after this many frames with candidates but without a match
+inline constexpr uint32_t MaxMissFrames = 120;
+
+// Captured signature must stay same for this many frames before it's saved
+inline constexpr uint32_t StableFrames = 30;
+
+struct Signature
+{
+    uint32_t Format = 0;
+    uint32_t WidthRatio = 0;
+    uint32_t HeightRatio = 0;
+    uint32_t CaptureInfo = 0;
+    uint32_t Ordinal = 0;
+
+    bool operator==(const Signature&) const = default;
+};
+
+inline uint32_t Ratio(uint64_t size, uint64_t displaySize)
+{
+    if (displaySize == 0)
+        return 0;
+
+    return (uint32_t) ((size * RatioScale + displaySize / 2) / displaySize);
+}
+
+inline Signature MakeSignature(uint32_t format, uint64_t width, uint64_t height, uint64_t displayWidth,
+                               uint64_t displayHeight, uint32_t captureInfo, uint32_t ordinal)
+{
+    return { format, Ratio(width, displayWidth), Ratio(height, displayHeight), captureInfo, ordinal };
+}
+
+inline uint32_t OrdinalTolerance(uint32_t ordinal)
+{
+    auto tolerance = ordinal / 16;
+    return tolerance < MinOrdinalTolerance ? MinOrdinalTolerance : tolerance;
+}
+
+inline uint32_t Distance(uint32_t a, uint32_t b) { return a > b ? a - b : b - a; }
+
+// Same resource kind, captured from same place at about same point of the frame
+inline bool Matches(const Signature& stored, const Signature& candidate)
+{
+    if (stored.Format != candidate.Format || stored.CaptureInfo != candidate.CaptureInfo)
+        return false;
+
+    if (Distance(stored.WidthRatio, candidate.WidthRatio) > RatioTolerance ||
+        Distance(stored.HeightRatio, candidate.HeightRatio) > RatioTolerance)
+    {
+        return false;
+    }
+
+    return Distance(stored.Ordinal, candidate.Ordinal) <= OrdinalTolerance(stored.Ordinal);
+}
+
+enum class Decision
+{
+    // No profile or its window is passed, use regular checks
+    Regular,
+
+    // Matches the profile, capture without waiting
+    Capture,
+
+    // Profile match is still possible in this frame, skip this candidate
+    Defer,
+};
+
+// Per session matching state of one game, not thread safe
+class Tracker
+{
+  private:
+    std::optional<Signature> _stored;
+    uint32_t _missFrames = 0;
+    bool _matchedThisFrame = false;
+
+    Signature _last {};
+    uint32_t _lastFrames = 0;
+    bool _saved = false;
+
+  public:
+    void SetStored(std::optional<Signature> signature)
+    {
+        _stored = signature;
+        _missFrames = 0;
+        _matchedThisFrame = false;
+        _saved = signature.has_value();
+    }
+
+    const std::optional<Signature>& Stored() const { return _stored; }
+
+    Decision Check(const Signature& candidate) const
+    {
+        if (!_stored.has_value() || _matchedThisFrame)
+            return Decision::Regular;
+
+        auto& stored = _stored.value();
+
+        if (Matches(stored, candidate))
+            return Decision::Capture;
+
+        if (candidate.Ordinal <= stored.Ordinal + OrdinalTolerance(stored.Ordinal))
+            return Decision::Defer;
+
+        return Decision::Regular;
+    }
+
+    // Called for each captured hudless, returns true when the signature should be persisted
+    bool Captured(const Signature& signature)
+    {
+        if (_stored.has_value() && Matches(_stored.value(), signature))
+        {
+            _matchedThisFrame = true;
+            return false;
+        }
+
+        if (signature == _last)
+        {
+            _lastFrames++;
+        }
+        else
+        {
+            _last = signature;
+            _lastFrames = 1;
+            _saved = false;
+        }
+
+        if (_saved || _lastFrames < StableFrames)
+            return false;
+
+        _saved = true;
+        _stored = signature;
+        _missFrames = 0;
+        _matchedThisFrame = true;
+        return true;
+    }
+
+    // Frame boundary, frames without candidates (menus, loading) don't count as misses.
+    // Returns true when the profile is dropped.
+    bool FrameEnd(uint32_t candidateCount)
+    {
+        auto matched = _matchedThisFrame;
+        _matchedThisFrame = false;
+
+        if (!_stored.has_value() || candidateCount == 0)
+            return false;
+
+        if (matched)
+        {
+            _missFrames = 0;
+            return false;
+        }
+
+        if (++_missFrames < MaxMissFrames)
+            return false;
+
+        _stored.reset();
+        _missFrames = 0;
+        return true;
+    }
+};
+
+// Persistent exe name -> signature list
+class ProfileFile
+{
+  private:
+    static constexpr const char* Header = "OptiScaler hudless profile 1";
+    static constexpr size_t MaxEntries = 64;
+
+    struct Entry
+    {
+        std::string Exe;
+        Signature Value;
+    };
+
+    std::vector<Entry> _entries;
+    bool _dirty = false;
+
+    size_t IndexOf(const std::string& exe) const
+    {
+        for (size_t i = 0; i < _entries.size(); i++)
+        {
+            if (_entries[i].Exe == exe)
+                return i;
+        }
+
+        return SIZE_MAX;
+    }
+
+  public:
+    std::optional<Signature> Lookup(const std::string& exe) const
+    {
+        auto index = IndexOf(exe);
+
+        if (index == SIZE_MAX)
+            return std::nullopt;
+
+        return _entries[index].Value;
+    }
+
+    void Store(const std::string& exe, const Signature& signature)
+    {
+        auto index = IndexOf(exe);
+
+        if (index != SIZE_MAX)
+        {
+            if (_entries[index].Value == signature)
+                return;
+
+            _entries.erase(_entries.begin() + index);
+        }
+
+        // Oldest entries are at the front
+        if (_entries.size() >= MaxEntries)
+            _entries.erase(_entries.begin());
+
+        _entries.push_back({ exe, signature });
+        _dirty = true;
+    }
+
+    void Remove(const std::string& exe)
+    {
+        auto index = IndexOf(exe);
+
+        if (index == SIZE_MAX)
+            return;
+
+        _entries.erase(_entries.begin() + index);
+        _dirty = true;
+    }
+
+    bool IsDirty() const { return _dirty; }
+    size_t Size() const { return _entries.size(); }
+
+    // Tab separated lines, exe name first
+    bool Load(const std::filesystem::path& path)
+    {
+        _entries.clear();
+        _dirty = false;
+
+        std::ifstream file(path, std::ios::binary);
+
+        if (!file.is_open())
+            return false;
+
+        std::string line;
+
+        if (!std::getline(file, line) || line != Header)
+            return false;
+
+        while (std::getline(file, line) && _entries.size() < MaxEntries)
+        {
+            auto tab = line.find('\t');
+
+            if (tab == std::string::npos || tab == 0)
+                continue;
+
+            Entry entry;
+            entry.Exe = line.substr(0, tab);
+
+            std::istringstream values(line.substr(tab + 1));
+            auto& v = entry.Value;
+
+            if (!(values >> v.Format >> v.WidthRatio >> v.HeightRatio >> v.CaptureInfo >> v.Ordinal))
+                continue;
+
+            _entries.push_back(std::move(entry));
+        }
+
+        return true;
+    }
+
+    // Writes to a temp file and renames so a crash never leaves a half written profile
+    bool Save(const std::filesystem::path& path)
+    {
+        auto tempPath = path;
+        tempPath += ".tmp";
+
+        {
+            std::ofstream file(tempPath, std::ios::binary | std::ios::trunc);
+
+            if (!file.is_open())
+                return false;
+
+            file << Header << '\n';
+
+            for (auto& entry : _entries)
+            {
+                auto& v = entry.Value;
+                file << entry.Exe << '\t' << v.Format << '\t' << v.WidthRatio << '\t' << v.HeightRatio << '\t'
+                     << v.CaptureInfo << '\t' << v.Ordinal << '\n';
+            }
+
+            if (!file)
+                return false;
+        }
+
+        std::error_code ec;
+        std::filesystem::rename(tempPath, path, ec);
+
+        if (ec)
+        {
+            std::filesystem::remove(tempPath, ec);
+            return false;
+        }
+
+        _dirty = false;
+        return true;
+    }
+};
+
+} // namespace hudless_profile
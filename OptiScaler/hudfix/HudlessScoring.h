@@ -0,0 +1,423 @@
+#pragma once
+
+#include "HudlessProfile.h"
+
+#include <span>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <istream>
+#include <sstream>
+#include <optional>
+#include <algorithm>
+#include <unordered_map>
+
+// Scores hudless candidates once per frame instead of running every check for every draw.
+// Draw path only appends a small feature record to a per-frame table and compares it with the
+// candidate elected at the last frame boundary, no locks are taken there.
+// No platform dependencies, so it can be tested and traces can be replayed on any OS.
+namespace hudless_scoring
+{
+
+struct Candidate
+{
+    // Resource address
+    uint64_t Key = 0;
+
+    uint32_t Format = 0;
+    int32_t FormatGroup = -1;
+
+    // 1/1000 of the display size, same as hudless_profile
+    uint32_t WidthRatio = 0;
+    uint32_t HeightRatio = 0;
+
+    uint32_t CaptureInfo = 0;
+    uint32_t Ordinal = 0;
+
+    hudless_profile::Signature ToSignature() const { return { Format, WidthRatio, HeightRatio, CaptureInfo, Ordinal }; }
+};
+
+struct Weights
+{
+    int32_t SizeExact = 40;
+    int32_t SizeRelaxed = 10;
+    int32_t FormatGroup = 30;
+    int32_t Rank = 20;
+    int32_t RankStep = 5;
+    int32_t HitRate = 30;
+    int32_t LastWinner = 10;
+    int32_t Profile = 50;
+    int32_t MinScore = 60;
+};
+
+struct FrameSettings
+{
+    int32_t DisplayFormatGroup = -1;
+
+    // Preferred position among distinct candidates of the frame, HUDLimit - 1
+    uint32_t PreferredRank = 0;
+
+    std::optional<hudless_profile::Signature> Profile;
+};
+
+struct Decision
+{
+    bool Elected = false;
+    Candidate Winner {};
+    int32_t Score = 0;
+    uint32_t Candidates = 0;
+    uint32_t Distinct = 0;
+};
+
+class Engine
+{
+  public:
+    static constexpr uint32_t TableSize = 1024;
+
+    // Exponential moving average step of the hit rate, 1/8
+    static constexpr float HitRateStep = 0.125f;
+    static constexpr float MinHitRate = 0.01f;
+
+  private:
+    struct Slot
+    {
+        // Frame + 1 when Value is complete, 0 while written
+        std::atomic<uint64_t> Stamp { 0 };
+        Candidate Value {};
+    };
+
+    struct Table
+    {
+        std::atomic<uint32_t> Count { 0 };
+        std::array<Slot, TableSize> Slots;
+    };
+
+    struct Distinct
+    {
+        Candidate Value;
+        uint32_t Uses = 0;
+    };
+
+    struct History
+    {
+        float HitRate = 0.0f;
+        bool Seen = false;
+    };
+
+    Weights _weights;
+
+    // Written on draw path
+    std::array<Table, 2> _tables;
+    std::atomic<uint64_t> _frame { 0 };
+    std::atomic<uint64_t> _claimedFrame { 0 };
+    std::atomic<uint64_t> _dropped { 0 };
+
+    // Written at frame boundary, read on draw path
+    std::atomic<uint64_t> _electedKey { 0 };
+    std::atomic<uint32_t> _electedCapture { 0 };
+
+    // Frame boundary only
+    std::vector<Distinct> _distinct;
+    std::unordered_map<uint64_t, uint32_t> _distinctIndex;
+    std::unordered_map<uint64_t, History> _history;
+    uint64_t _lastWinner = 0;
+
+    static uint64_t HistoryKey(const Candidate& candidate)
+    {
+        // Capture bits are mixed in, same resource can be a candidate as RTV and SRV
+        return candidate.Key ^ ((uint64_t) candidate.CaptureInfo << 48);
+    }
+
+    static uint32_t Distance(uint32_t a, uint32_t b) { return a > b ? a - b : b - a; }
+
+    int32_t Score(const Candidate& candidate, uint32_t rank, const FrameSettings& settings) const
+    {
+        int32_t score = 0;
+
+        if (Distance(candidate.WidthRatio, hudless_profile::RatioScale) <= hudless_profile::RatioTolerance &&
+            Distance(candidate.HeightRatio, hudless_profile::RatioScale) <= hudless_profile::RatioTolerance)
+        {
+            score += _weights.SizeExact;
+        }
+        else
+        {
+            score += _weights.SizeRelaxed;
+        }
+
+        if (candidate.FormatGroup >= 0 && candidate.FormatGroup == settings.DisplayFormatGroup)
+            score += _weights.FormatGroup;
+
+        auto rankScore = _weights.Rank - _weights.RankStep * (int32_t) Distance(rank, settings.PreferredRank);
+        if (rankScore > 0)
+            score += rankScore;
+
+        if (auto it = _history.find(HistoryKey(candidate)); it != _history.end())
+            score += (int32_t) (it->second.HitRate * _weights.HitRate);
+
+        if (_lastWinner != 0 && HistoryKey(candidate) == _lastWinner)
+            score += _weights.LastWinner;
+
+        if (settings.Profile.has_value() && hudless_profile::Matches(settings.Profile.value(), candidate.ToSignature()))
+            score += _weights.Profile;
+
+        return score;
+    }
+
+  public:
+    Engine() = default;
+    explicit Engine(const Weights& weights) : _weights(weights) {}
+
+    // Draw path, thread safe and lock free.
+    // Returns true only for the elected candidate, once per frame.
+    bool Record(const Candidate& candidate)
+    {
+        auto frame = _frame.load(std::memory_order_acquire);
+        auto& table = _tables[frame & 1];
+        auto index = table.Count.fetch_add(1, std::memory_order_relaxed);
+
+        if (index < TableSize)
+        {
+            auto& slot = table.Slots[index];
+            slot.Stamp.store(0, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_release);
+            slot.Value = candidate;
+            slot.Stamp.store(frame + 1, std::memory_order_release);
+        }
+        else
+        {
+            _dropped.fetch_add(1, std::memory_order_relaxed);
+        }
+
+        if (candidate.Key != _electedKey.load(std::memory_order_relaxed) ||
+            candidate.CaptureInfo != _electedCapture.load(std::memory_order_relaxed))
+        {
+            return false;
+        }
+
+        auto claimed = _claimedFrame.load(std::memory_order_relaxed);
+
+        if (claimed == frame + 1)
+            return false;
+
+        return _claimedFrame.compare_exchange_strong(claimed, frame + 1, std::memory_order_relaxed);
+    }
+
+    // Frame boundary, must not be called concurrently with itself or Reset.
+    // Scores candidates of the ending frame and elects the one to capture in next frame.
+    Decision EndFrame(const FrameSettings& settings)
+    {
+        auto frame = _frame.load(std::memory_order_relaxed);
+        _frame.store(frame + 1, std::memory_order_release);
+
+        auto& table = _tables[frame & 1];
+        auto count = table.Count.load(std::memory_order_acquire);
+
+        if (count > TableSize)
+            count = TableSize;
+
+        Decision decision;
+        decision.Candidates = count;
+
+        _distinct.clear();
+        _distinctIndex.clear();
+
+        for (uint32_t i = 0; i < count; i++)
+        {
+            auto& slot = table.Slots[i];
+
+            if (slot.Stamp.load(std::memory_order_acquire) != frame + 1)
+                continue;
+
+            auto value = slot.Value;
+            std::atomic_thread_fence(std::memory_order_acquire);
+
+            // Overwritten by a late writer while copying
+            if (slot.Stamp.load(std::memory_order_relaxed) != frame + 1)
+                continue;
+
+            auto [it, inserted] = _distinctIndex.try_emplace(HistoryKey(value), (uint32_t) _distinct.size());
+
+            if (inserted)
+            {
+                _distinct.push_back({ value, 1 });
+                continue;
+            }
+
+            auto& distinct = _distinct[it->second];
+            distinct.Uses++;
+
+            if (value.Ordinal < distinct.Value.Ordinal)
+                distinct.Value.Ordinal = value.Ordinal;
+        }
+
+        // Table is reused two frames later
+        table.Count.store(0, std::memory_order_relaxed);
+
+        decision.Distinct = (uint32_t) _distinct.size();
+
+        // Frames without candidates (menus, loading screens) keep the current state
+        if (_distinct.empty())
+            return decision;
+
+        for (auto& [key, history] : _history)
+            history.Seen = false;
+
+        for (auto& distinct : _distinct)
+            _history[HistoryKey(distinct.Value)].Seen = true;
+
+        for (auto it = _history.begin(); it != _history.end();)
+        {
+            auto& history = it->second;
+            history.HitRate += ((history.Seen ? 1.0f : 0.0f) - history.HitRate) * HitRateStep;
+
+            if (!history.Seen && history.HitRate < MinHitRate)
+                it = _history.erase(it);
+            else
+                ++it;
+        }
+
+        std::sort(_distinct.begin(), _distinct.end(),
+                  [](const Distinct& a, const Distinct& b) { return a.Value.Ordinal < b.Value.Ordinal; });
+
+        for (uint32_t rank = 0; rank < _distinct.size(); rank++)
+        {
+            auto score = Score(_distinct[rank].Value, rank, settings);
+
+            // Ties go to the earlier candidate
+            if (score > decision.Score)
+            {
+                decision.Score = score;
+                decision.Winner = _distinct[rank].Value;
+            }
+        }
+
+        decision.Elected = decision.Score >= _weights.MinScore;
+
+        if (decision.Elected)
+        {
+            _lastWinner = HistoryKey(decision.Winner);
+            _electedCapture.store(decision.Winner.CaptureInfo, std::memory_order_relaxed);
+            _electedKey.store(decision.Winner.Key, std::memory_order_relaxed);
+        }
+        else
+        {
+            _lastWinner = 0;
+            _electedKey.store(0, std::memory_order_relaxed);
+        }
+
+        return decision;
+    }
+
+    // Must not be called concurrently with EndFrame
+    void Reset()
+    {
+        _electedKey.store(0, std::memory_order_relaxed);
+        _history.clear();
+        _lastWinner = 0;
+    }
+
+    uint64_t Dropped() const { return _dropped.load(std::memory_order_relaxed); }
+    uint64_t Frame() const { return _frame.load(std::memory_order_relaxed); }
+};
+
+// Recorded candidate of a trace
+struct TraceEntry
+{
+    uint64_t Frame = 0;
+    Candidate Value {};
+};
+
+// One candidate per line in draw order:
+// frame key format formatGroup widthRatio heightRatio captureInfo ordinal
+// Empty lines and lines starting with # are skipped
+inline std::vector<TraceEntry> ParseTrace(std::istream& input)
+{
+    std::vector<TraceEntry> entries;
+    std::string line;
+
+    while (std::getline(input, line))
+    {
+        if (line.empty() || line[0] == '#')
+            continue;
+
+        std::istringstream values(line);
+        TraceEntry entry;
+        auto& v = entry.Value;
+
+        if (values >> entry.Frame >> v.Key >> v.Format >> v.FormatGroup >> v.WidthRatio >> v.HeightRatio >>
+            v.CaptureInfo >> v.Ordinal)
+        {
+            entries.push_back(entry);
+        }
+    }
+
+    return entries;
+}
+
+struct ReplayFrame
+{
+    uint64_t Frame = 0;
+    Decision Result {};
+
+    // Candidate which Record returned true for, capture of the previous decision
+    std::optional<Candidate> Captured;
+};
+
+struct ReplayReport
+{
+    std::vector<ReplayFrame> Frames;
+    uint64_t Candidates = 0;
+    double RecordNs = 0.0;
+    double EndFrameNs = 0.0;
+
+    double NsPerCandidate() const { return Candidates == 0 ? 0.0 : RecordNs / (double) Candidates; }
+    double NsPerFrame() const { return Frames.empty() ? 0.0 : EndFrameNs / (double) Frames.size(); }
+};
+
+// Feeds a trace through the engine on the calling thread, frame boundary is placed
+// whenever the frame number of the trace changes
+inline ReplayReport Replay(std::span<const TraceEntry> trace, const FrameSettings& settings, Engine& engine)
+{
+    using Clock = std::chrono::steady_clock;
+
+    ReplayReport report;
+    size_t begin = 0;
+
+    while (begin < trace.size())
+    {
+        auto frame = trace[begin].Frame;
+        auto end = begin;
+
+        while (end < trace.size() && trace[end].Frame == frame)
+            end++;
+
+        ReplayFrame result;
+        result.Frame = frame;
+
+        auto start = Clock::now();
+
+        for (auto i = begin; i < end; i++)
+        {
+            if (engine.Record(trace[i].Value))
+                result.Captured = trace[i].Value;
+        }
+
+        auto recorded = Clock::now();
+        result.Result = engine.EndFrame(settings);
+        auto ended = Clock::now();
+
+        report.RecordNs += std::chrono::duration<double, std::nano>(recorded - start).count();
+        report.EndFrameNs += std::chrono::duration<double, std::nano>(ended - recorded).count();
+        report.Candidates += end - begin;
+        report.Frames.push_back(result);
+
+        begin = end;
+    }
+
+    return report;
+}
+
+} // namespace hudless_scoring
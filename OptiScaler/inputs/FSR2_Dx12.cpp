@@ -1254,6 +1254,7 @@ void HookFSR2ExeInputs()
         } while (false);
 
         // LOG_DEBUG("Pattern matching finished");
+        scanner::FlushCache();
     }
 
     auto detourResult = DetourTransactionCommit();
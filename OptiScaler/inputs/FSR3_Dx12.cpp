@@ -792,6 +792,8 @@ void HookFSR3ExeInputs()
 
         LOG_DEBUG("ffxFsr3UpscalerGetUpscaleRatioFromQualityMode_Pattern_Dx12: {:X}",
                   (size_t) o_ffxFsr3UpscalerGetUpscaleRatioFromQualityMode_Pattern_Dx12);
+
+        scanner::FlushCache();
     }
 
     // if (o_ffxFSR3GetInterfaceDX12 == nullptr)
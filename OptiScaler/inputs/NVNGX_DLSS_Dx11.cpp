@@ -13,7 +13,7 @@
 #include <with_dx12/with_dx12.h>
 #include "FG/Upscaler_Inputs_Dx11wDx12.h"
 
-#include <upscaler_time/UpscalerTime_Dx11.h>
+#include <upscaler_time/GpuProfiler_Dx11.h>
 
 #include <ankerl/unordered_dense.h>
 #include <imgui/ImGuiNotify.hpp>
@@ -53,43 +53,29 @@ static void UpdateInitPaths(NVSDK_NGX_FeatureCommonInfo* InFeatureInfo)
         std::optional<std::filesystem::path> nvngxDlssDPath = std::nullopt;
         std::optional<std::filesystem::path> nvngxDlssGPath = std::nullopt;
 
-        // Check DLSS path
         if (State::Instance().NVNGX_DLSS_Path.has_value())
-        {
             nvngxDlssPath = std::filesystem::path(State::Instance().NVNGX_DLSS_Path.value());
-        }
-        else
-        {
-            auto path = Util::FindFilePath(exePath, "nvngx_dlss.dll");
 
-            if (path.has_value())
-                nvngxDlssPath = path.value();
-        }
-
-        // Check DLSS-D path
         if (State::Instance().NVNGX_DLSSD_Path.has_value())
-        {
             nvngxDlssDPath = std::filesystem::path(State::Instance().NVNGX_DLSSD_Path.value());
-        }
-        else
-        {
-            auto path = Util::FindFilePath(exePath, "nvngx_dlssd.dll");
-
-            if (path.has_value())
-                nvngxDlssDPath = path.value();
-        }
 
-        // Check DLSS-G path
         if (State::Instance().NVNGX_DLSSG_Path.has_value())
-        {
             nvngxDlssGPath = std::filesystem::path(State::Instance().NVNGX_DLSSG_Path.value());
-        }
-        else
+
+        // Search missing ones with a single walk of exe folder
+        if (!nvngxDlssPath.has_value() || !nvngxDlssDPath.has_value() || !nvngxDlssGPath.has_value())
         {
-            auto path = Util::FindFilePath(exePath, "nvngx_dlssg.dll");
+            const std::filesystem::path nvngxFiles[] = { "nvngx_dlss.dll", "nvngx_dlssd.dll", "nvngx_dlssg.dll" };
+            auto nvngxPaths = Util::FindFilePaths({ &exePath, 1 }, nvngxFiles);
+
+            if (!nvngxDlssPath.has_value())
+                nvngxDlssPath = nvngxPaths[0];
+
+            if (!nvngxDlssDPath.has_value())
+                nvngxDlssDPath = nvngxPaths[1];
 
-            if (path.has_value())
-                nvngxDlssGPath = path.value();
+            if (!nvngxDlssGPath.has_value())
+                nvngxDlssGPath = nvngxPaths[2];
         }
 
         // Override locations
@@ -203,7 +189,7 @@ NVSDK_NGX_API NVSDK_NGX_Result NVSDK_NGX_D3D11_Init_Ext(unsigned long long InApp
     State::Instance().currentD3D11Device = InDevice;
     State::Instance().nvngxDx11Inited = true;
 
-    UpscalerTimeDx11::Init(InDevice);
+    GpuProfilerDx11::Init(InDevice);
 
     return NVSDK_NGX_Result_Success;
 }
@@ -784,11 +770,11 @@ NVSDK_NGX_API NVSDK_NGX_Result NVSDK_NGX_D3D11_EvaluateFeature(ID3D11DeviceConte
         return NVSDK_NGX_Result_Success;
     }
 
-    UpscalerTimeDx11::UpscaleStart(InDevCtx);
+    GpuProfilerDx11::Begin(InDevCtx, gpu_profiler::Scope::Upscale);
 
     auto upscaleResult = deviceContext->Evaluate(InDevCtx, InParameters);
 
-    UpscalerTimeDx11::UpscaleEnd(InDevCtx);
+    GpuProfilerDx11::End(InDevCtx, gpu_profiler::Scope::Upscale);
 
     if (State::Instance().activeFgInput == FGInput::Upscaler)
     {
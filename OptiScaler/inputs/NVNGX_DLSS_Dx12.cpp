@@ -13,7 +13,7 @@
 #include "FG/FSR3_Dx12_FG.h"
 #include "FG/Upscaler_Inputs_Dx12.h"
 
-#include <upscaler_time/UpscalerTime_Dx12.h>
+#include <upscaler_time/GpuProfiler_Dx12.h>
 #include <imgui/ImGuiNotify.hpp>
 
 #include <hooks/D3D12_Hooks.h>
@@ -60,43 +60,29 @@ static void UpdateInitPaths(NVSDK_NGX_FeatureCommonInfo* InFeatureInfo)
         std::optional<std::filesystem::path> nvngxDlssDPath = std::nullopt;
         std::optional<std::filesystem::path> nvngxDlssGPath = std::nullopt;
 
-        // Check DLSS path
         if (State::Instance().NVNGX_DLSS_Path.has_value())
-        {
             nvngxDlssPath = std::filesystem::path(State::Instance().NVNGX_DLSS_Path.value());
-        }
-        else
-        {
-            auto path = Util::FindFilePath(exePath, "nvngx_dlss.dll");
 
-            if (path.has_value())
-                nvngxDlssPath = path.value();
-        }
-
-        // Check DLSS-D path
         if (State::Instance().NVNGX_DLSSD_Path.has_value())
-        {
             nvngxDlssDPath = std::filesystem::path(State::Instance().NVNGX_DLSSD_Path.value());
-        }
-        else
-        {
-            auto path = Util::FindFilePath(exePath, "nvngx_dlssd.dll");
-
-            if (path.has_value())
-                nvngxDlssDPath = path.value();
-        }
 
-        // Check DLSS-G path
         if (State::Instance().NVNGX_DLSSG_Path.has_value())
-        {
             nvngxDlssGPath = std::filesystem::path(State::Instance().NVNGX_DLSSG_Path.value());
-        }
-        else
+
+        // Search missing ones with a single walk of exe folder
+        if (!nvngxDlssPath.has_value() || !nvngxDlssDPath.has_value() || !nvngxDlssGPath.has_value())
         {
-            auto path = Util::FindFilePath(exePath, "nvngx_dlssg.dll");
+            const std::filesystem::path nvngxFiles[] = { "nvngx_dlss.dll", "nvngx_dlssd.dll", "nvngx_dlssg.dll" };
+            auto nvngxPaths = Util::FindFilePaths({ &exePath, 1 }, nvngxFiles);
+
+            if (!nvngxDlssPath.has_value())
+                nvngxDlssPath = nvngxPaths[0];
+
+            if (!nvngxDlssDPath.has_value())
+                nvngxDlssDPath = nvngxPaths[1];
 
-            if (path.has_value())
-                nvngxDlssGPath = path.value();
+            if (!nvngxDlssGPath.has_value())
+                nvngxDlssGPath = nvngxPaths[2];
         }
 
         // Override locations
@@ -216,7 +202,7 @@ NVSDK_NGX_API NVSDK_NGX_Result NVSDK_NGX_D3D12_Init_Ext(unsigned long long InApp
     State::Instance().currentD3D12Device = InDevice;
     D3D12Hooks::HookDevice(InDevice);
 
-    UpscalerTimeDx12::Init(InDevice);
+    GpuProfilerDx12::Init(InDevice);
 
     State::Instance().nvngxDx12Inited = true;
 
@@ -1069,7 +1055,7 @@ static NVSDK_NGX_Result TryEvaluateOptiFeature(ID3D12GraphicsCommandList* InCmdL
     FSR3FG::SetUpscalerInputs(InCmdList, InParameters, feature);
 
     // Record the first timestamp
-    UpscalerTimeDx12::UpscaleStart(InCmdList);
+    GpuProfilerDx12::Begin(InCmdList, gpu_profiler::Scope::Upscale);
 
     // Evaluate the feature
     bool evalSuccess = false;
@@ -1087,7 +1073,7 @@ static NVSDK_NGX_Result TryEvaluateOptiFeature(ID3D12GraphicsCommandList* InCmdL
         // Upscaler time calc
         // Record the second timestamp
         if (!feature->CallsUpscalerEndByItself())
-            UpscalerTimeDx12::UpscaleEnd(InCmdList);
+            GpuProfilerDx12::End(InCmdList, gpu_profiler::Scope::Upscale);
     }
     else
     {
@@ -10,7 +10,7 @@
 
 #include "upscalers/FeatureProvider_Vk.h"
 
-#include <upscaler_time/UpscalerTime_Vk.h>
+#include <upscaler_time/GpuProfiler_Vk.h>
 
 #include <vulkan/vulkan.hpp>
 #include <ankerl/unordered_dense.h>
@@ -56,43 +56,29 @@ static void UpdateInitPaths(NVSDK_NGX_FeatureCommonInfo* InFeatureInfo)
         std::optional<std::filesystem::path> nvngxDlssDPath = std::nullopt;
         std::optional<std::filesystem::path> nvngxDlssGPath = std::nullopt;
 
-        // Check DLSS path
         if (State::Instance().NVNGX_DLSS_Path.has_value())
-        {
             nvngxDlssPath = std::filesystem::path(State::Instance().NVNGX_DLSS_Path.value());
-        }
-        else
-        {
-            auto path = Util::FindFilePath(exePath, "nvngx_dlss.dll");
 
-            if (path.has_value())
-                nvngxDlssPath = path.value();
-        }
-
-        // Check DLSS-D path
         if (State::Instance().NVNGX_DLSSD_Path.has_value())
-        {
             nvngxDlssDPath = std::filesystem::path(State::Instance().NVNGX_DLSSD_Path.value());
-        }
-        else
-        {
-            auto path = Util::FindFilePath(exePath, "nvngx_dlssd.dll");
-
-            if (path.has_value())
-                nvngxDlssDPath = path.value();
-        }
 
-        // Check DLSS-G path
         if (State::Instance().NVNGX_DLSSG_Path.has_value())
-        {
             nvngxDlssGPath = std::filesystem::path(State::Instance().NVNGX_DLSSG_Path.value());
-        }
-        else
+
+        // Search missing ones with a single walk of exe folder
+        if (!nvngxDlssPath.has_value() || !nvngxDlssDPath.has_value() || !nvngxDlssGPath.has_value())
         {
-            auto path = Util::FindFilePath(exePath, "nvngx_dlssg.dll");
+            const std::filesystem::path nvngxFiles[] = { "nvngx_dlss.dll", "nvngx_dlssd.dll", "nvngx_dlssg.dll" };
+            auto nvngxPaths = Util::FindFilePaths({ &exePath, 1 }, nvngxFiles);
+
+            if (!nvngxDlssPath.has_value())
+                nvngxDlssPath = nvngxPaths[0];
+
+            if (!nvngxDlssDPath.has_value())
+                nvngxDlssDPath = nvngxPaths[1];
 
-            if (path.has_value())
-                nvngxDlssGPath = path.value();
+            if (!nvngxDlssGPath.has_value())
+                nvngxDlssGPath = nvngxPaths[2];
         }
 
         // Override locations
@@ -247,7 +233,7 @@ NVSDK_NGX_API NVSDK_NGX_Result NVSDK_NGX_VULKAN_Init_Ext2(
 
     State::Instance().currentVkDevice = InDevice;
 
-    UpscalerTimeVk::Init(InDevice, InPD);
+    GpuProfilerVk::Init(InDevice, InPD);
 
     State::Instance().nvngxVkInited = true;
 
@@ -1068,7 +1054,7 @@ NVSDK_NGX_API NVSDK_NGX_Result NVSDK_NGX_VULKAN_EvaluateFeature(VkCommandBuffer
     deviceContext = VkContexts[handleId].feature.get();
     state.currentFeature = deviceContext;
 
-    UpscalerTimeVk::UpscaleStart(InCmdList);
+    GpuProfilerVk::Begin(InCmdList, gpu_profiler::Scope::Upscale);
 
     auto upscaleResult = deviceContext->Evaluate(InCmdList, InParameters);
 
@@ -1083,7 +1069,7 @@ NVSDK_NGX_API NVSDK_NGX_Result NVSDK_NGX_VULKAN_EvaluateFeature(VkCommandBuffer
         return NVSDK_NGX_Result_Success;
     }
 
-    UpscalerTimeVk::UpscaleEnd(InCmdList);
+    GpuProfilerVk::End(InCmdList, gpu_profiler::Scope::Upscale);
 
     return upscaleResult ? NVSDK_NGX_Result_Success : NVSDK_NGX_Result_Fail;
 }
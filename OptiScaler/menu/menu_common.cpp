@@ -11,15 +11,13 @@
 #include <proxies/Streamline_Proxy.h>
 
 #include <framegen/nvngx/Nvngx_FG.h>
+#include <framegen/ResourcePool_Dx12.h>
 
 #include <nvapi/fakenvapi.h>
 #include <hooks/Reflex_Hooks.h>
 
 #include <version_check.h>
 
-#include <upscaler_time/UpscalerTime_Vk.h>
-#include <upscaler_time/UpscalerTime_Dx11.h>
-#include <upscaler_time/UpscalerTime_Dx12.h>
 
 #include <imgui/imgui_internal.h>
 #include <imgui/ImGuiNotify.hpp>
@@ -34,6 +32,7 @@
 #include <memory>
 #include <type_traits>
 #include <misc/IdentifyGpu.h>
+#include <misc/PrecisionSleep.h>
 #include <hooks/Xell_Hooks.h>
 #include <low_latency/input/input_common.h>
 
@@ -1252,8 +1251,10 @@ void MenuCommon::UpdateRenderTiming(RenderMenuContext& ctx)
         frameRate = 1000.0 / frameTime;
     }
 
-    state.frameTimes.pop_front();
-    state.frameTimes.push_back(frameTime);
+    state.frameTimes.Push(frameTime);
+
+    if (frameTime > 0.0)
+        state.frameStats.Record(frame_stats::Series::Present, frameTime);
 }
 
 void MenuCommon::UpdateMenuInputMode(RenderMenuContext& ctx)
@@ -1603,11 +1604,11 @@ void MenuCommon::UpdateFrameTimeAverages(RenderMenuContext& ctx)
     {
         float frameCnt = 0;
         frameTime = 0;
-        for (size_t i = 299; i > 199; i--)
+        for (size_t age = 0; age < 100; age++)
         {
-            if (state.frameTimes[i] > 0.0)
+            if (state.frameTimes.Recent(age) > 0.0)
             {
-                frameTime += state.frameTimes[i];
+                frameTime += state.frameTimes.Recent(age);
                 frameCnt++;
             }
         }
@@ -1616,8 +1617,10 @@ void MenuCommon::UpdateFrameTimeAverages(RenderMenuContext& ctx)
         frameRate = 1000.0 / frameTime;
         frameTimesCalculated = true;
 
-        float lastFT = static_cast<float>(state.frameTimes.empty() ? 0.0f : state.frameTimes.back());
-        float lastUT = static_cast<float>(state.upscaleTimes.empty() ? 0.0f : state.upscaleTimes.back());
+        state.frameStats.Update();
+
+        float lastFT = static_cast<float>(state.frameTimes.Last());
+        float lastUT = static_cast<float>(state.frameStats.Get(frame_stats::Series::Upscaler).Last());
         gFrameTimes.Push(lastFT);
         gUpscalerTimes.Push(lastUT);
 
@@ -1857,14 +1860,36 @@ void MenuCommon::RenderPerformanceOverlay(RenderMenuContext& ctx)
                     ImGui::Spacing();
                 }
 
-                secondLine = StrFmt("Frame Time: %7.2f ms, Avg: %7.2f ms", state.frameTimes.back(), averageFrameTime);
+                auto present = state.frameStats.Summarize(frame_stats::Series::Present);
+                secondLine = StrFmt("Frame Time: %7.2f ms, Avg: %7.2f ms, P99: %7.2f ms, P99.9: %7.2f ms",
+                                    state.frameTimes.Last(), averageFrameTime, present.P99, present.P999);
+
+                // Pacing of generated frames
+                if (fg != nullptr && fg->IsActive() && !fg->IsPaused())
+                {
+                    auto frameGen = state.frameStats.Summarize(frame_stats::Series::FrameGen);
+
+                    if (frameGen.Count > 0)
+                        secondLine += StrFmt(", FG P99: %7.2f ms, Jitter: %5.2f ms", frameGen.P99, frameGen.Jitter);
+                }
             }
 
             // Prepare Line 3
             if (config->FpsOverlayType.value_or_default() >= FpsOverlay_Full)
             {
-                thirdLine =
-                    StrFmt("Upscaler Time: %7.2f ms, Avg: %7.2f ms", state.upscaleTimes.back(), averageUpscalerFT);
+                auto upscaler = state.frameStats.Summarize(frame_stats::Series::Upscaler);
+                thirdLine = StrFmt("Upscaler Time: %7.2f ms, Avg: %7.2f ms, P99: %7.2f ms", upscaler.Last,
+                                   averageUpscalerFT, upscaler.P99);
+
+                // Other measured GPU passes, averaged
+                for (uint32_t i = (uint32_t) gpu_profiler::Scope::Upscale + 1; i < gpu_profiler::ScopeCount; i++)
+                {
+                    auto scope = (gpu_profiler::Scope) i;
+
+                    if (state.gpuProfiler.IsRecent(scope))
+                        thirdLine += StrFmt(", %s: %5.2f ms", gpu_profiler::ScopeName(scope),
+                                            state.gpuProfiler.Average(scope));
+                }
             }
 
             ImVec2 plotSize;
@@ -3262,6 +3287,17 @@ void MenuCommon::RenderFrameGenerationSelection(RenderMenuContext& ctx)
              state.activeFgInput != FGInput::NoFG && state.activeFgInput != FGInput::NvngxFG) &&
             fgOutput)
         {
+            if (auto jitter = fgOutput->JitterAnalysis(); jitter.State == jitter_analysis::Status::Periodic)
+            {
+                ImGui::Text("Jitter: %u phases, %s, Jittered MVs: %s", jitter.Period,
+                            jitter_analysis::GeneratorName(jitter.Sequence), fgOutput->IsJitteredMVs() ? "Yes" : "No");
+            }
+            else
+            {
+                ImGui::Text("Jitter: %s, Jittered MVs: %s", jitter_analysis::StatusName(jitter.State),
+                            fgOutput->IsJitteredMVs() ? "Yes" : "No");
+            }
+
             ImGui::Checkbox("Show Detected UI", &state.fgHudlessCompare);
             ShowHelpMarker("Needs HUDless texture to compare with final image.\n"
                            "UI elements and ONLY UI elements should have a pink tint!");
@@ -4184,6 +4220,10 @@ void MenuCommon::RenderFrameGenerationRuntimeSettings(RenderMenuContext& ctx)
 
                     ImGui::EndDisabled();
 
+                    auto poolStats = ResourcePoolDx12::Stats();
+                    ImGui::Text("Copy pool: %u resources, %.1f MB, hit rate: %.0f%%", poolStats.Resident,
+                                poolStats.BytesResident / (1024.0 * 1024.0), poolStats.HitRate() * 100.0);
+
                     ImGui::Spacing();
                     ImGui::Spacing();
                     if (ImGui::TreeNode("Tracking Settings"))
@@ -4759,6 +4799,38 @@ void MenuCommon::RenderFramerateSettings(RenderMenuContext& ctx)
             config->FramerateLimit = _limitFps;
         }
 
+        static std::vector<MenuOption<FramerateSnap>> snapModes = {
+            { FramerateSnap::Off, "Off", "Limit is used as is" },
+            { FramerateSnap::RefreshDivisor, "Refresh Divisor", "Limit is lowered to refresh rate / n" },
+            { FramerateSnap::VrrCap, "VRR Cap",
+              "Limit is kept a bit under refresh rate to stay in VRR range\nAlso caps when limit is 0" }
+        };
+
+        PopulateCombo("Limit Snap", config->FramerateLimitSnap, snapModes);
+
+        if (bool latencyOptimized = config->FramerateLimitLatencyOptimized.value_or_default();
+            ImGui::Checkbox("Latency Optimized", &latencyOptimized))
+        {
+            config->FramerateLimitLatencyOptimized = latencyOptimized;
+        }
+
+        ShowHelpMarker("Waits at game's Reflex simulation start marker instead of at present\n"
+                       "so input is sampled after the wait.\n"
+                       "Only for OptiScaler's own limiter and when the game sends Reflex markers.");
+
+        if (auto sleepStats = PrecisionSleep::Stats(); sleepStats.Waits > 0)
+        {
+            ImGui::Text("Sleep error: avg %.0f us, max %.0f us, spin margin %.0f us", sleepStats.MeanErrorNs / 1000.0,
+                        sleepStats.MaxErrorNs / 1000.0, sleepStats.MarginNs / 1000.0);
+            ShowTooltip("Wake up error of the frame limiter and low latency sleeps.\n"
+                        "Spin margin is learned from how late the OS timer wakes up.");
+
+            ImGui::SameLine(0.0f, 16.0f);
+
+            if (ImGui::Button("Reset Stats"))
+                PrecisionSleep::ResetStats();
+        }
+
         ImGui::Spacing();
         if (auto ch = ScopedCollapsingHeader("VRR Frame Cap Calculator"); ch.IsHeaderOpen())
         {
@@ -5404,13 +5476,37 @@ void MenuCommon::RenderActiveImageSettings(RenderMenuContext& ctx)
 
                 if (currentFeature != nullptr && !currentFeature->IsFrozen())
                 {
-                    ImGui::Text("Output Scaling is %s, Target Res: %dx%d (%.2f)\nJitter Count: %d",
+                    ImGui::Text("Output Scaling is %s, Target Res: %dx%d (%.2f)",
                                 config->OutputScalingEnabled.value_or_default() ? "ENABLED" : "DISABLED",
                                 (uint32_t) (currentFeature->DisplayWidth() * _ssRatio),
                                 (uint32_t) (currentFeature->DisplayHeight() * _ssRatio),
                                 ((float) currentFeature->DisplayWidth() * _ssRatio) /
-                                    (float) currentFeature->RenderWidth(),
-                                currentFeature->JitterCount());
+                                    (float) currentFeature->RenderWidth());
+
+                    auto jitter = currentFeature->JitterAnalysis();
+                    auto ratio = (float) currentFeature->DisplayWidth() / (float) currentFeature->RenderWidth();
+
+                    if (jitter.State == jitter_analysis::Status::Periodic)
+                    {
+                        ImGui::Text("Jitter: %u phases (%u recommended), %s", jitter.Period,
+                                    jitter_analysis::RecommendedPhases(ratio),
+                                    jitter_analysis::GeneratorName(jitter.Sequence));
+                    }
+                    else
+                    {
+                        ImGui::Text("Jitter: %s, %u distinct offsets", jitter_analysis::StatusName(jitter.State),
+                                    jitter.Distinct);
+                    }
+
+                    if (jitter.Sequence != jitter_analysis::Generator::Unknown)
+                    {
+                        ImGui::Text("Jitter Units: %s, Signs X: %c Y: %c",
+                                    std::fabs(jitter.ScaleX - 1.0f) < 0.01f ? "Pixels" : "Scaled",
+                                    jitter.SignX > 0 ? '+' : '-', jitter.SignY > 0 ? '+' : '-');
+                        ShowHelpMarker("Unit and axis signs of the offsets compared to the standard generator\n"
+                                       "Jitter Cancellation expects jitter in motion vectors\n"
+                                       "to use the same convention");
+                    }
                 }
 
                 ImGui::EndDisabled();
@@ -6319,6 +6415,25 @@ void MenuCommon::RenderFpsOverlaySettings(RenderMenuContext& ctx)
         bool useTheme = config->OverlaysUseTheme.value_or_default();
         if (ImGui::Checkbox("Use Theme Colors", &useTheme))
             config->OverlaysUseTheme = useTheme;
+
+        auto& gpuProfiler = State::Instance().gpuProfiler;
+        bool gpuCsv = gpuProfiler.IsCsvActive();
+        if (ImGui::Checkbox("Export GPU Timings", &gpuCsv))
+        {
+            if (gpuCsv)
+            {
+                auto csvPath = Util::DllPath().parent_path() / "OptiScaler_GpuTimings.csv";
+
+                if (!gpuProfiler.StartCsv(csvPath))
+                    LOG_ERROR("Can't create {}", csvPath.string());
+            }
+            else
+            {
+                gpuProfiler.StopCsv();
+            }
+        }
+        ShowHelpMarker("Writes per frame GPU time of each measured pass\n"
+                       "to OptiScaler_GpuTimings.csv next to OptiScaler");
     }
 }
 
@@ -6755,7 +6870,7 @@ void MenuCommon::RenderMainMenuGraphs(RenderMenuContext& ctx)
         {
             ImGui::TableNextColumn();
             ImGui::Text("Upscaler");
-            auto ups = StrFmt("%7.2f ms", state.upscaleTimes.back());
+            auto ups = StrFmt("%7.2f ms", state.frameStats.Get(frame_stats::Series::Upscaler).Last());
             ImGui::PlotLines(
                 ups.c_str(), [](void* rb, int idx) -> float
                 { return static_cast<RingBuffer<float, plotWidth>*>(rb)->At(idx); }, &gUpscalerTimes, plotWidth);
@@ -7033,6 +7148,26 @@ void MenuCommon::RenderMipmapBiasWindow(RenderMenuContext& ctx, ImGuiWindowFlags
 
             ImGui::SliderFloat("Mipmap Bias", &_mipBiasCalculated, -15.0f, 0.0f, "%.6f");
 
+            if (auto jitter = currentFeature->JitterAnalysis();
+                jitter.State != jitter_analysis::Status::Unknown && _renderWidth > 0)
+            {
+                auto jitterBias =
+                    jitter_analysis::RecommendedMipBias(jitter, (float) _renderWidth, (float) _displayWidth);
+
+                ImGui::Text("Game's jitter supports: %.2f", jitterBias);
+                ShowHelpMarker("Negative bias needs enough jitter phases to resolve the extra detail\n"
+                               "(8 x ratio^2 phases for full bias), with fewer phases textures shimmer.\n"
+                               "Without jitter bias is not useful.");
+
+                if (jitterBias > _mipBiasCalculated)
+                {
+                    ImGui::SameLine();
+
+                    if (ImGui::Button("Limit To Jitter"))
+                        _mipBiasCalculated = jitterBias;
+                }
+            }
+
             // BOTTOM LINE
             ImGui::Spacing();
             ImGui::Separator();
@@ -7173,11 +7308,11 @@ void MenuCommon::RenderMainMenuWindow(RenderMenuContext& ctx)
     {
         float frameCnt = 0;
         frameTime = 0;
-        for (size_t i = 299; i > 199; i--)
+        for (size_t age = 0; age < 100; age++)
         {
-            if (state.frameTimes[i] > 0.0)
+            if (state.frameTimes.Recent(age) > 0.0)
             {
-                frameTime += state.frameTimes[i];
+                frameTime += state.frameTimes.Recent(age);
                 frameCnt++;
             }
         }
@@ -7,6 +7,7 @@
 #include "menu_common.h"
 #include <imgui/imgui_impl_dx12.h>
 #include <imgui/imgui_impl_win32.h>
+#include <upscaler_time/GpuProfiler_Dx12.h>
 
 long frameCounter = 0;
 static int const SRV_HEAP_SIZE = 64;
@@ -125,7 +126,11 @@ bool Menu_Dx12::Render(ID3D12GraphicsCommandList* pCmdList, ID3D12Resource* outT
 
         // Render
         if (MenuDxBase::RenderMenu())
+        {
+            GpuProfilerDx12::Begin(pCmdList, gpu_profiler::Scope::MenuRender);
             ImGui_ImplDX12_RenderDrawData(ImGui::GetDrawData(), pCmdList);
+            GpuProfilerDx12::End(pCmdList, gpu_profiler::Scope::MenuRender);
+        }
 
         outBarrier.Transition.StateBefore = D3D12_RESOURCE_STATE_RENDER_TARGET;
         outBarrier.Transition.StateAfter = D3D12_RESOURCE_STATE_UNORDERED_ACCESS;
@@ -173,7 +178,9 @@ bool Menu_Dx12::Render(ID3D12GraphicsCommandList* pCmdList, ID3D12Resource* outT
     // Render to buffer
     if (MenuDxBase::RenderMenu())
     {
+        GpuProfilerDx12::Begin(pCmdList, gpu_profiler::Scope::MenuRender);
         ImGui_ImplDX12_RenderDrawData(ImGui::GetDrawData(), pCmdList);
+        GpuProfilerDx12::End(pCmdList, gpu_profiler::Scope::MenuRender);
 
         outBarrier.Transition.StateBefore = D3D12_RESOURCE_STATE_COPY_SOURCE;
         outBarrier.Transition.StateAfter = D3D12_RESOURCE_STATE_COPY_DEST;
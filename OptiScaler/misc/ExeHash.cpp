@@ -0,0 +1,156 @@
+#include "pch.h"
+#include "ExeHash.h"
+#include "TreeHash.h"
+
+#include <Util.h>
+
+namespace
+{
+struct WorkerArgs
+{
+    std::filesystem::path Path;
+    HMODULE Module;
+};
+} // namespace
+
+void ExeHash::Start(const std::filesystem::path& path)
+{
+    {
+        std::scoped_lock lock(_mutex);
+
+        if (_started)
+            return;
+
+        _started = true;
+    }
+
+    HMODULE module = nullptr;
+
+    if (!GetModuleHandleExW(GET_MODULE_HANDLE_EX_FLAG_FROM_ADDRESS, reinterpret_cast<LPCWSTR>(&ExeHash::Worker),
+                            &module))
+    {
+        LOG_DEBUG("Can't reference module for hashing: {:X}", GetLastError());
+        return;
+    }
+
+    auto args = new WorkerArgs { path, module };
+    auto thread = CreateThread(nullptr, 0, Worker, args, 0, nullptr);
+
+    if (thread == nullptr)
+    {
+        LOG_DEBUG("Can't create hashing thread: {:X}", GetLastError());
+        delete args;
+        FreeLibrary(module);
+        return;
+    }
+
+    CloseHandle(thread);
+}
+
+DWORD WINAPI ExeHash::Worker(LPVOID param)
+{
+    auto args = static_cast<WorkerArgs*>(param);
+    auto module = args->Module;
+
+    Run(std::move(args->Path));
+    delete args;
+
+    FreeLibraryAndExitThread(module, 0);
+}
+
+void ExeHash::Cancel() { _cancel.store(true, std::memory_order_release); }
+
+std::optional<std::string> ExeHash::Result()
+{
+    std::scoped_lock lock(_mutex);
+    return _result;
+}
+
+void ExeHash::OnReady(std::function<void(const std::string&)> callback)
+{
+    std::optional<std::string> result;
+
+    {
+        std::scoped_lock lock(_mutex);
+
+        if (!_result.has_value())
+        {
+            _callbacks.push_back(std::move(callback));
+            return;
+        }
+
+        result = _result;
+    }
+
+    callback(result.value());
+}
+
+void ExeHash::Run(std::filesystem::path path)
+{
+    SetThreadPriority(GetCurrentThread(), THREAD_PRIORITY_BELOW_NORMAL);
+
+    auto file = CreateFileW(path.c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE, nullptr,
+                            OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+
+    if (file == INVALID_HANDLE_VALUE)
+    {
+        LOG_DEBUG("Can't open exe for hashing: {:X}", GetLastError());
+        return;
+    }
+
+    LARGE_INTEGER fileSize {};
+    HANDLE mapping = nullptr;
+    const uint8_t* view = nullptr;
+
+    if (GetFileSizeEx(file, &fileSize) && fileSize.QuadPart > 0)
+        mapping = CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+
+    if (mapping != nullptr)
+        view = static_cast<const uint8_t*>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+
+    if (view == nullptr)
+    {
+        LOG_DEBUG("Can't map exe for hashing: {:X}", GetLastError());
+
+        if (mapping != nullptr)
+            CloseHandle(mapping);
+
+        CloseHandle(file);
+        return;
+    }
+
+    // Keep some cores for the game while it's starting
+    auto workers = std::thread::hardware_concurrency() / 2;
+    if (workers > 4)
+        workers = 4;
+
+    auto start = Util::MillisecondsNow();
+    auto digest = tree_hash::Hash({ view, (size_t) fileSize.QuadPart }, _cancel, workers);
+    auto elapsed = Util::MillisecondsNow() - start;
+
+    UnmapViewOfFile(view);
+    CloseHandle(mapping);
+    CloseHandle(file);
+
+    if (!digest.has_value())
+        return;
+
+    auto hash = digest->ToString();
+
+    // Logger might be already closed
+    if (_cancel.load(std::memory_order_acquire))
+        return;
+
+    LOG_TRACE("Game's Exe hash: {} ({:.0f} ms)", hash, elapsed);
+
+    std::vector<std::function<void(const std::string&)>> callbacks;
+
+    {
+        std::scoped_lock lock(_mutex);
+        _result = hash;
+        callbacks.swap(_callbacks);
+    }
+
+    for (auto& callback : callbacks)
+        callback(hash);
+}
@@ -0,0 +1,37 @@
+#pragma once
+#include "SysUtils.h"
+
+#include <mutex>
+#include <vector>
+#include <atomic>
+#include <optional>
+#include <functional>
+#include <filesystem>
+
+// Hashes the game exe on a background thread
+class ExeHash
+{
+    static inline std::mutex _mutex;
+    static inline std::atomic<bool> _cancel { false };
+    static inline bool _started = false;
+    static inline std::optional<std::string> _result;
+    static inline std::vector<std::function<void(const std::string&)>> _callbacks;
+
+    static void Run(std::filesystem::path path);
+
+    // Holds a reference of our module and releases it with FreeLibraryAndExitThread,
+    // so the dll stays loaded while the worker runs
+    static DWORD WINAPI Worker(LPVOID param);
+
+  public:
+    static void Start(const std::filesystem::path& path);
+
+    // Stops hashing and logging, safe to call from DllMain as it doesn't wait for the worker
+    static void Cancel();
+
+    // Hex digest when hashing is done
+    static std::optional<std::string> Result();
+
+    // Called from the worker thread when hash is ready, or right away if it already is
+    static void OnReady(std::function<void(const std::string&)> callback);
+};
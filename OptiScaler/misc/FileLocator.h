@@ -0,0 +1,277 @@
+#pragma once
+
+#include <span>
+#include <string>
+#include <vector>
+#include <cwctype>
+#include <fstream>
+#include <optional>
+#include <filesystem>
+
+// Finds several files with a single directory walk and remembers where they were.
+// No platform dependencies, so it can be tested on any OS.
+namespace file_locator
+{
+
+// Lexically normal path without trailing separator
+inline std::filesystem::path Normalize(const std::filesystem::path& path)
+{
+    auto normal = path.lexically_normal();
+
+    if (!normal.has_filename() && normal.has_relative_path())
+        normal = normal.parent_path();
+
+    return normal;
+}
+
+// Case insensitive compare of normalized paths, like the Windows file systems
+inline bool SamePath(const std::filesystem::path& a, const std::filesystem::path& b)
+{
+    auto& left = a.native();
+    auto& right = b.native();
+
+    if (left.size() != right.size())
+        return false;
+
+    for (size_t i = 0; i < left.size(); i++)
+    {
+        if (left[i] == right[i])
+            continue;
+
+        if (std::towlower((wint_t) left[i]) != std::towlower((wint_t) right[i]))
+            return false;
+    }
+
+    return true;
+}
+
+struct WalkOptions
+{
+    // Directories deeper than this below the root are not entered
+    int MaxDepth = 16;
+
+    // Normalized directories which are skipped with their whole subtree
+    std::vector<std::filesystem::path> ExcludedDirs;
+};
+
+// Walks root once and looks for every file name whose result is still empty.
+// Stops as soon as all of them are found, first match in walk order wins.
+// Returns number of newly found files.
+inline size_t FindFiles(const std::filesystem::path& root, std::span<const std::filesystem::path> fileNames,
+                        std::span<std::optional<std::filesystem::path>> results, const WalkOptions& options = {})
+{
+    size_t remaining = 0;
+
+    for (size_t i = 0; i < fileNames.size(); i++)
+    {
+        if (!results[i].has_value())
+            remaining++;
+    }
+
+    if (remaining == 0)
+        return 0;
+
+    size_t found = 0;
+    std::error_code ec;
+    std::filesystem::recursive_directory_iterator it(root, std::filesystem::directory_options::skip_permission_denied,
+                                                     ec);
+
+    for (; !ec && it != std::filesystem::recursive_directory_iterator(); it.increment(ec))
+    {
+        auto& entry = *it;
+        std::error_code typeEc;
+
+        if (entry.is_directory(typeEc))
+        {
+            if (it.depth() + 1 >= options.MaxDepth)
+            {
+                it.disable_recursion_pending();
+                continue;
+            }
+
+            if (!options.ExcludedDirs.empty())
+            {
+                auto normalized = Normalize(entry.path());
+
+                for (auto& excluded : options.ExcludedDirs)
+                {
+                    if (SamePath(normalized, excluded))
+                    {
+                        it.disable_recursion_pending();
+                        break;
+                    }
+                }
+            }
+
+            continue;
+        }
+
+        auto fileName = entry.path().filename();
+
+        for (size_t i = 0; i < fileNames.size(); i++)
+        {
+            if (results[i].has_value() || !SamePath(fileName, fileNames[i]))
+                continue;
+
+            results[i] = entry.path();
+            found++;
+            remaining--;
+        }
+
+        if (remaining == 0)
+            break;
+    }
+
+    return found;
+}
+
+// Persistent (search root, file name) -> path cache.
+// Entries are revalidated with a single stat on lookup, stale ones are dropped.
+class PathCache
+{
+  private:
+    static constexpr const char* Header = "OptiScaler path cache 1";
+    static constexpr size_t MaxEntries = 64;
+
+    struct Entry
+    {
+        std::filesystem::path Root;
+        std::filesystem::path FileName;
+        std::filesystem::path Path;
+    };
+
+    std::vector<Entry> _entries;
+    bool _dirty = false;
+
+    static std::string ToUtf8(const std::filesystem::path& path)
+    {
+        auto u8 = path.u8string();
+        return std::string(u8.begin(), u8.end());
+    }
+
+    static std::filesystem::path FromUtf8(const std::string& value)
+    {
+        return std::filesystem::path(std::u8string(value.begin(), value.end()));
+    }
+
+    size_t IndexOf(const std::filesystem::path& root, const std::filesystem::path& fileName) const
+    {
+        for (size_t i = 0; i < _entries.size(); i++)
+        {
+            if (SamePath(_entries[i].Root, root) && SamePath(_entries[i].FileName, fileName))
+                return i;
+        }
+
+        return SIZE_MAX;
+    }
+
+  public:
+    std::optional<std::filesystem::path> Lookup(const std::filesystem::path& root,
+                                                const std::filesystem::path& fileName)
+    {
+        auto index = IndexOf(Normalize(root), fileName);
+
+        if (index == SIZE_MAX)
+            return std::nullopt;
+
+        std::error_code ec;
+        if (std::filesystem::is_regular_file(_entries[index].Path, ec))
+            return _entries[index].Path;
+
+        _entries.erase(_entries.begin() + index);
+        _dirty = true;
+        return std::nullopt;
+    }
+
+    void Store(const std::filesystem::path& root, const std::filesystem::path& fileName,
+               const std::filesystem::path& path)
+    {
+        auto normalRoot = Normalize(root);
+        auto index = IndexOf(normalRoot, fileName);
+
+        if (index != SIZE_MAX)
+        {
+            if (_entries[index].Path == path)
+                return;
+
+            _entries.erase(_entries.begin() + index);
+        }
+
+        // Oldest entries are at the front
+        if (_entries.size() >= MaxEntries)
+            _entries.erase(_entries.begin());
+
+        _entries.push_back({ normalRoot, fileName, path });
+        _dirty = true;
+    }
+
+    bool IsDirty() const { return _dirty; }
+    size_t Size() const { return _entries.size(); }
+
+    // Tab separated UTF-8 lines, tabs can't be part of a Windows path
+    bool Load(const std::filesystem::path& path)
+    {
+        _entries.clear();
+        _dirty = false;
+
+        std::ifstream file(path, std::ios::binary);
+
+        if (!file.is_open())
+            return false;
+
+        std::string line;
+
+        if (!std::getline(file, line) || line != Header)
+            return false;
+
+        while (std::getline(file, line) && _entries.size() < MaxEntries)
+        {
+            auto first = line.find('\t');
+            auto second = first == std::string::npos ? std::string::npos : line.find('\t', first + 1);
+
+            if (second == std::string::npos)
+                continue;
+
+            _entries.push_back({ FromUtf8(line.substr(0, first)), FromUtf8(line.substr(first + 1, second - first - 1)),
+                                 FromUtf8(line.substr(second + 1)) });
+        }
+
+        return true;
+    }
+
+    // Writes to a temp file and renames so a crash never leaves a half written cache
+    bool Save(const std::filesystem::path& path)
+    {
+        auto tempPath = path;
+        tempPath += ".tmp";
+
+        {
+            std::ofstream file(tempPath, std::ios::binary | std::ios::trunc);
+
+            if (!file.is_open())
+                return false;
+
+            file << Header << '\n';
+
+            for (auto& entry : _entries)
+                file << ToUtf8(entry.Root) << '\t' << ToUtf8(entry.FileName) << '\t' << ToUtf8(entry.Path) << '\n';
+
+            if (!file)
+                return false;
+        }
+
+        std::error_code ec;
+        std::filesystem::rename(tempPath, path, ec);
+
+        if (ec)
+        {
+            std::filesystem::remove(tempPath, ec);
+            return false;
+        }
+
+        _dirty = false;
+        return true;
+    }
+};
+
+} // namespace file_locator
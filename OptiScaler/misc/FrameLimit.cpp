@@ -1,83 +1,93 @@
 #include "pch.h"
 #include "FrameLimit.h"
+#include "FramePacer.h"
+#include "PrecisionSleep.h"
 
 #include "Config.h"
+#include <State.h>
 // #include "hooks/D3D11Hooks.h"
 
-inline uint64_t FrameLimit::get_timestamp()
+// Present path waits again when no marker wait happened for this many presents
+static constexpr uint64_t MarkerPresents = 2;
+
+// Refresh rate is queried again after this long
+static constexpr uint64_t RefreshQueryNs = 1'000'000'000;
+
+static frame_pacer::Pacer _pacer;
+static std::mutex _pacerMutex;
+
+static std::atomic<uint64_t> _presents { 0 };
+static std::atomic<uint64_t> _markerPresent { 0 };
+static std::atomic<bool> _lastFgActive { false };
+
+static double RefreshRate(uint64_t now)
 {
-    FILETIME fileTime;
-    GetSystemTimePreciseAsFileTime(&fileTime);
+    static double refreshRate = 0.0;
+    static uint64_t lastQuery = 0;
 
-    uint64_t time = (static_cast<uint64_t>(fileTime.dwHighDateTime) << 32) | fileTime.dwLowDateTime;
+    if (lastQuery == 0 || now - lastQuery > RefreshQueryNs)
+    {
+        refreshRate = Util::GetActiveRefreshRate(State::Instance().currentSwapchainDesc.OutputWindow);
+        lastQuery = now;
+    }
 
-    return time * 100;
+    return refreshRate;
 }
 
-// https://learn.microsoft.com/en-us/windows/win32/sync/using-waitable-timer-objects
-inline int FrameLimit::timer_sleep(int64_t hundred_ns)
+void FrameLimit::wait(bool fgActive)
 {
-    static HANDLE timer = CreateWaitableTimerExW(NULL, NULL, CREATE_WAITABLE_TIMER_HIGH_RESOLUTION, TIMER_ALL_ACCESS);
-    LARGE_INTEGER due_time;
+    auto config = Config::Instance();
 
-    due_time.QuadPart = -hundred_ns;
+    frame_pacer::Target target;
+    target.Fps = config->FramerateLimit.value_or_default();
+    target.FramesPerRender = fgActive ? 2 : 1;
+    target.Mode = (frame_pacer::Snap) config->FramerateLimitSnap.value_or_default();
 
-    if (!timer)
-        return 1;
+    uint64_t deadline = 0;
 
-    if (!SetWaitableTimerEx(timer, &due_time, 0, NULL, NULL, NULL, 0))
-        return 2;
+    {
+        std::scoped_lock lock(_pacerMutex);
 
-    if (WaitForSingleObject(timer, 1000) != WAIT_OBJECT_0)
-        return 3;
+        auto now = PrecisionSleep::Now();
 
-    return 0;
-};
+        if (target.Mode != frame_pacer::Snap::Off)
+            target.RefreshHz = RefreshRate(now);
 
-inline int FrameLimit::busywait_sleep(int64_t ns)
-{
-    auto current_time = get_timestamp();
-    auto wait_until = current_time + ns;
-    while (current_time < wait_until)
-    {
-        current_time = get_timestamp();
+        deadline = _pacer.Next(now, frame_pacer::Interval(target));
     }
-    return 0;
-}
 
-inline int FrameLimit::combined_sleep(int64_t ns)
-{
-    constexpr int64_t busywait_threshold = 2'000'000; // 2ms
-    int status {};
-    auto current_time = get_timestamp();
-    if (ns <= busywait_threshold)
-        status = busywait_sleep(ns);
-    else
-        status = timer_sleep((ns - busywait_threshold) / 100);
-
-    if (int64_t sleep_deviation = ns - (get_timestamp() - current_time); sleep_deviation > 0 && !status)
-        status = busywait_sleep(sleep_deviation);
-
-    return status;
+    if (deadline == 0)
+        return;
+
+    if (auto res = PrecisionSleep::WaitUntil(deadline); res)
+        LOG_ERROR("Sleep command failed: {}", res);
 }
 
 void FrameLimit::sleep(bool fgActive)
 {
-    if (auto fpsCap = Config::Instance()->FramerateLimit.value_or_default(); fpsCap != 0.0f)
+    _lastFgActive = fgActive;
+    auto presents = _presents.fetch_add(1) + 1;
+
+    // Already waited at simulation start
+    if (Config::Instance()->FramerateLimitLatencyOptimized.value_or_default() && _markerPresent != 0 &&
+        presents - _markerPresent <= MarkerPresents)
     {
-        uint64_t min_interval_us = std::clamp((uint64_t) (1'000'000 / fpsCap), 0ULL, 100'000'000ULL);
-
-        if (fgActive)
-            min_interval_us *= 2;
-
-        static uint64_t previous_frame_time = 0;
-        uint64_t current_time = get_timestamp();
-        uint64_t frame_time = current_time - previous_frame_time;
-        if (frame_time < 1000 * min_interval_us)
-        {
-            if (auto res = combined_sleep(min_interval_us * 1000 - frame_time); res)
-                LOG_ERROR("Sleep command failed: {}", res);
-        }
-        previous_frame_time = get_timestamp();
+        return;
     }
+
+    wait(fgActive);
+}
+
+void FrameLimit::simulationStart()
+{
+    if (!Config::Instance()->FramerateLimitLatencyOptimized.value_or_default())
+        return;
+
+    // Limiter is not used at present (Reflex limits fps, no FG output) or already waited for this frame
+    auto presents = _presents.load();
+    if (presents == 0 || presents == _markerPresent)
+        return;
+
+    _markerPresent = presents;
+    wait(_lastFgActive);
 }
@@ -3,11 +3,12 @@
 
 class FrameLimit
 {
-    static uint64_t get_timestamp();
-    static int timer_sleep(int64_t hundred_ns);
-    static int busywait_sleep(int64_t ns);
-    static int combined_sleep(int64_t ns);
+    static void wait(bool fgActive);
 
   public:
+    // Called at present
     static void sleep(bool fgActive);
+
+    // Called at game's Reflex simulation start marker, waits here in latency optimized mode
+    static void simulationStart();
 };
@@ -0,0 +1,132 @@
+#pragma once
+
+#include <cmath>
+#include <cstdint>
+
+// Frame limiter pacing on absolute deadlines.
+// Deadlines are kept on a fixed grid, so a late wake up is taken from the next wait instead of
+// being added to every following frame. Time is passed in by the caller, so pacing is
+// deterministic and can be tested with a simulated clock on any OS.
+namespace frame_pacer
+{
+
+enum class Snap : uint32_t
+{
+    Off,
+
+    // Limit is lowered to refresh rate / n
+    RefreshDivisor,
+
+    // Limit is kept a bit under refresh rate to stay in VRR range
+    VrrCap,
+};
+
+// Same margin as the VRR frame cap calculator of the menu
+inline constexpr double VrrMarginMs = 0.3;
+
+struct Target
+{
+    // Displayed frames per second, 0 means no limit
+    double Fps = 0.0;
+
+    // Displayed frames per rendered frame, 2 with frame generation
+    uint32_t FramesPerRender = 1;
+
+    // 0 when unknown, snapping is skipped then
+    double RefreshHz = 0.0;
+
+    Snap Mode = Snap::Off;
+};
+
+inline double DisplayFps(const Target& target)
+{
+    auto fps = target.Fps;
+
+    if (target.RefreshHz < 1.0)
+        return fps;
+
+    if (target.Mode == Snap::VrrCap)
+    {
+        auto cap = 1000.0 / (1000.0 / target.RefreshHz + VrrMarginMs);
+
+        if (fps <= 0.0 || fps > cap)
+            fps = cap;
+    }
+    else if (target.Mode == Snap::RefreshDivisor && fps > 0.0)
+    {
+        // Highest refresh / n which is not above the limit
+        auto divisor = std::ceil(target.RefreshHz / fps - 1e-6);
+
+        if (divisor < 1.0)
+            divisor = 1.0;
+
+        fps = target.RefreshHz / divisor;
+    }
+
+    return fps;
+}
+
+// Time between rendered frames in ns, 0 means no limit
+inline int64_t Interval(const Target& target)
+{
+    auto fps = DisplayFps(target);
+
+    if (fps <= 0.0)
+        return 0;
+
+    auto framesPerRender = target.FramesPerRender < 1 ? 1 : target.FramesPerRender;
+    return (int64_t) std::llround(1'000'000'000.0 / fps * framesPerRender);
+}
+
+// Not thread safe
+class Pacer
+{
+  private:
+    uint64_t _deadline = 0;
+    int64_t _interval = 0;
+    uint64_t _resyncs = 0;
+
+  public:
+    // Called once per frame at the pacing point.
+    // Returns the time to wait until, 0 when the frame can go on without waiting.
+    uint64_t Next(uint64_t now, int64_t interval)
+    {
+        if (interval <= 0)
+        {
+            _deadline = 0;
+            _interval = 0;
+            return 0;
+        }
+
+        // First frame or new limit, start a new grid
+        if (_deadline == 0 || interval != _interval)
+        {
+            _interval = interval;
+            _deadline = now;
+            return 0;
+        }
+
+        auto target = _deadline + (uint64_t) interval;
+
+        // More than a whole frame behind (hitch, loading screen), catching up would only cause a burst
+        if (now > target + (uint64_t) interval)
+        {
+            _deadline = now;
+            _resyncs++;
+            return 0;
+        }
+
+        _deadline = target;
+        return target > now ? target : 0;
+    }
+
+    void Reset()
+    {
+        _deadline = 0;
+        _interval = 0;
+    }
+
+    uint64_t Resyncs() const { return _resyncs; }
+};
+
+} // namespace frame_pacer
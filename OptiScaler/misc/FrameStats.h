@@ -0,0 +1,350 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <bit>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+
+// Fixed memory frame time statistics.
+// Producers push samples into per series SPSC rings, the overlay drains them
+// once per frame and reads percentiles from a sliding log bucketed histogram.
+// No platform dependencies, so traces can be replayed on any OS.
+namespace frame_stats
+{
+
+enum class Series : uint32_t
+{
+    Present,  // present to present time
+    Upscaler, // upscaler GPU time
+    FrameGen, // present to present time of FG swapchain, includes generated frames
+    Count
+};
+
+// Lock free ring for exactly one producer and one consumer thread
+template <typename T, size_t N> class SpscRing
+{
+    static_assert(N > 1 && (N & (N - 1)) == 0, "Size must be power of two");
+
+  private:
+    std::array<T, N> _data {};
+    alignas(64) std::atomic<size_t> _head { 0 }; // written by producer
+    alignas(64) std::atomic<size_t> _tail { 0 }; // written by consumer
+
+  public:
+    // Returns false when ring is full, sample is dropped
+    bool Push(const T& value)
+    {
+        auto head = _head.load(std::memory_order_relaxed);
+
+        if (head - _tail.load(std::memory_order_acquire) >= N)
+            return false;
+
+        _data[head & (N - 1)] = value;
+        _head.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    bool Pop(T& value)
+    {
+        auto tail = _tail.load(std::memory_order_relaxed);
+
+        if (tail == _head.load(std::memory_order_acquire))
+            return false;
+
+        value = _data[tail & (N - 1)];
+        _tail.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+};
+
+// Last N values, the oldest one is overwritten. Starts filled with zeros
+template <typename T, size_t N> class History
+{
+  private:
+    std::array<T, N> _data {};
+    size_t _next = 0;
+
+  public:
+    void Push(T value)
+    {
+        _data[_next] = value;
+        _next = (_next + 1) % N;
+    }
+
+    // age 0 is the newest value
+    T Recent(size_t age) const { return _data[(_next + N - 1 - age % N) % N]; }
+    T Last() const { return Recent(0); }
+
+    static constexpr size_t Size() { return N; }
+};
+
+// HDR histogram style bucketing of microsecond values.
+// Values below 64us get exact buckets, above that each power of two is split
+// into 32 buckets which keeps the relative error under ~3%.
+class LogHistogram
+{
+  public:
+    static constexpr uint32_t SubBucketBits = 5;
+    static constexpr uint32_t SubBucketCount = 1 << SubBucketBits;
+    static constexpr uint32_t MaxValue = (1u << 24) - 1; // ~16.7 seconds
+    static constexpr uint32_t BucketCount = 2 * SubBucketCount + (24 - SubBucketBits - 1) * SubBucketCount;
+
+  private:
+    std::array<uint32_t, BucketCount> _counts {};
+    uint64_t _total = 0;
+
+  public:
+    static uint32_t BucketOf(uint32_t value)
+    {
+        if (value > MaxValue)
+            value = MaxValue;
+
+        if (value < 2 * SubBucketCount)
+            return value;
+
+        auto exponent = (uint32_t) std::bit_width(value) - 1; // >= SubBucketBits + 1
+        auto shift = exponent - SubBucketBits;
+        auto top = value >> shift; // [SubBucketCount, 2 * SubBucketCount)
+
+        return 2 * SubBucketCount + (exponent - SubBucketBits - 1) * SubBucketCount + (top - SubBucketCount);
+    }
+
+    // Lowest value which falls into bucket
+    static uint32_t BucketStart(uint32_t bucket)
+    {
+        if (bucket < 2 * SubBucketCount)
+            return bucket;
+
+        auto exponent = (bucket - 2 * SubBucketCount) / SubBucketCount + SubBucketBits + 1;
+        auto top = (bucket - 2 * SubBucketCount) % SubBucketCount + SubBucketCount;
+
+        return top << (exponent - SubBucketBits);
+    }
+
+    static uint32_t BucketWidth(uint32_t bucket)
+    {
+        if (bucket < 2 * SubBucketCount)
+            return 1;
+
+        auto exponent = (bucket - 2 * SubBucketCount) / SubBucketCount + SubBucketBits + 1;
+        return 1u << (exponent - SubBucketBits);
+    }
+
+    void Add(uint32_t value)
+    {
+        _counts[BucketOf(value)]++;
+        _total++;
+    }
+
+    void Remove(uint32_t value)
+    {
+        auto& count = _counts[BucketOf(value)];
+
+        if (count == 0)
+            return;
+
+        count--;
+        _total--;
+    }
+
+    void Reset()
+    {
+        _counts.fill(0);
+        _total = 0;
+    }
+
+    uint64_t Count() const { return _total; }
+
+    // percentile in [0, 100], returns middle of the bucket holding the value
+    uint32_t ValueAtPercentile(double percentile) const
+    {
+        if (_total == 0)
+            return 0;
+
+        if (percentile < 0.0)
+            percentile = 0.0;
+        else if (percentile > 100.0)
+            percentile = 100.0;
+
+        auto rank = (uint64_t) std::ceil(percentile / 100.0 * (double) _total);
+        if (rank == 0)
+            rank = 1;
+
+        uint64_t seen = 0;
+        for (uint32_t i = 0; i < BucketCount; i++)
+        {
+            seen += _counts[i];
+
+            if (seen >= rank)
+                return BucketStart(i) + BucketWidth(i) / 2;
+        }
+
+        return MaxValue;
+    }
+};
+
+struct Summary
+{
+    double Last = 0.0;
+    double Average = 0.0;
+    double Min = 0.0;
+    double Max = 0.0;
+    double P50 = 0.0;
+    double P95 = 0.0;
+    double P99 = 0.0;
+    double P999 = 0.0;
+    double Jitter = 0.0; // mean absolute difference of consecutive samples
+    uint64_t Count = 0;  // samples in window
+};
+
+// Statistics over the last WindowSize samples of one series, all values in ms
+class SeriesStats
+{
+  public:
+    static constexpr size_t WindowSize = 1024;
+
+  private:
+    LogHistogram _histogram;
+    std::array<uint32_t, WindowSize> _window {}; // microseconds
+    size_t _next = 0;
+    size_t _size = 0;
+    uint64_t _sum = 0;
+    uint64_t _diffSum = 0;
+
+    static uint32_t Diff(uint32_t a, uint32_t b) { return a > b ? a - b : b - a; }
+
+    uint32_t At(size_t age) const { return _window[(_next + WindowSize - 1 - age) % WindowSize]; }
+
+  public:
+    void Add(double ms)
+    {
+        if (!(ms >= 0.0))
+            return;
+
+        auto us = ms * 1000.0 >= (double) LogHistogram::MaxValue ? LogHistogram::MaxValue
+                                                                  : (uint32_t) std::lround(ms * 1000.0);
+
+        if (_size == WindowSize)
+        {
+            // Evict oldest sample and its difference to the next one
+            auto oldest = _window[_next];
+            auto second = _window[(_next + 1) % WindowSize];
+
+            _histogram.Remove(oldest);
+            _sum -= oldest;
+            _diffSum -= Diff(oldest, second);
+            _size--;
+        }
+
+        if (_size > 0)
+            _diffSum += Diff(At(0), us);
+
+        _window[_next] = us;
+        _next = (_next + 1) % WindowSize;
+        _size++;
+
+        _histogram.Add(us);
+        _sum += us;
+    }
+
+    void Reset()
+    {
+        _histogram.Reset();
+        _next = 0;
+        _size = 0;
+        _sum = 0;
+        _diffSum = 0;
+    }
+
+    size_t Size() const { return _size; }
+
+    double Last() const { return _size == 0 ? 0.0 : At(0) / 1000.0; }
+
+    // age 0 is the newest sample
+    double Sample(size_t age) const { return age >= _size ? 0.0 : At(age) / 1000.0; }
+
+    double Percentile(double percentile) const { return _histogram.ValueAtPercentile(percentile) / 1000.0; }
+
+    Summary Summarize() const
+    {
+        Summary summary;
+
+        if (_size == 0)
+            return summary;
+
+        uint32_t minValue = UINT32_MAX;
+        uint32_t maxValue = 0;
+
+        for (size_t i = 0; i < _size; i++)
+        {
+            auto value = At(i);
+
+            if (value < minValue)
+                minValue = value;
+
+            if (value > maxValue)
+                maxValue = value;
+        }
+
+        summary.Last = Last();
+        summary.Average = (double) _sum / (double) _size / 1000.0;
+        summary.Min = minValue / 1000.0;
+        summary.Max = maxValue / 1000.0;
+        summary.P50 = Percentile(50.0);
+        summary.P95 = Percentile(95.0);
+        summary.P99 = Percentile(99.0);
+        summary.P999 = Percentile(99.9);
+        summary.Jitter = _size > 1 ? (double) _diffSum / (double) (_size - 1) / 1000.0 : 0.0;
+        summary.Count = _size;
+
+        return summary;
+    }
+};
+
+// Record() may be called from one producer thread per series,
+// Update() and readers must run on a single consumer thread (overlay).
+class FrameStats
+{
+  public:
+    static constexpr size_t RingSize = 256;
+
+  private:
+    std::array<SpscRing<float, RingSize>, (size_t) Series::Count> _rings;
+    std::array<SeriesStats, (size_t) Series::Count> _stats;
+    std::atomic<uint64_t> _dropped { 0 };
+
+  public:
+    void Record(Series series, double ms)
+    {
+        if (!_rings[(size_t) series].Push((float) ms))
+            _dropped.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    // Drains pending samples into statistics, call once per overlay frame
+    void Update()
+    {
+        float ms;
+
+        for (size_t i = 0; i < _rings.size(); i++)
+        {
+            while (_rings[i].Pop(ms))
+                _stats[i].Add(ms);
+        }
+    }
+
+    void Reset()
+    {
+        Update();
+
+        for (auto& stats : _stats)
+            stats.Reset();
+    }
+
+    const SeriesStats& Get(Series series) const { return _stats[(size_t) series]; }
+    Summary Summarize(Series series) const { return _stats[(size_t) series].Summarize(); }
+    uint64_t Dropped() const { return _dropped.load(std::memory_order_relaxed); }
+};
+
+} // namespace frame_stats
@@ -0,0 +1,89 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <thread>
+
+// Grace periods for lock free readers of copy-on-write data.
+// Readers hold a Guard while they use a published pointer. A writer unpublishes the old object, calls
+// Synchronize and frees it afterwards, Synchronize returns once every reader which could have loaded it has left.
+// Readers count themselves in striped counters of two phases, Synchronize flips the phase before waiting for each
+// one to drain so a steady stream of new readers can't hold it off.
+// Pointers must be published and loaded with seq_cst, a thread holding a Guard must not call Synchronize.
+namespace grace_period
+{
+
+inline constexpr uint32_t Stripes = 16;
+
+inline uint32_t ThreadStripe()
+{
+    static std::atomic<uint32_t> next { 0 };
+    thread_local uint32_t stripe = next.fetch_add(1, std::memory_order_relaxed) % Stripes;
+    return stripe;
+}
+
+class Domain
+{
+  private:
+    struct alignas(64) Counter
+    {
+        std::atomic<int64_t> Value { 0 };
+    };
+
+    // Phase * Stripes + stripe
+    std::array<Counter, Stripes * 2> _readers;
+    std::atomic<uint32_t> _phase { 0 };
+
+    bool Drained(uint32_t phase) const
+    {
+        for (uint32_t i = 0; i < Stripes; i++)
+        {
+            if (_readers[phase * Stripes + i].Value.load(std::memory_order_seq_cst) != 0)
+                return false;
+        }
+
+        return true;
+    }
+
+  public:
+    class Guard
+    {
+      private:
+        std::atomic<int64_t>* _counter;
+
+      public:
+        explicit Guard(std::atomic<int64_t>* counter) : _counter(counter) {}
+        Guard(const Guard&) = delete;
+        Guard& operator=(const Guard&) = delete;
+
+        ~Guard() { _counter->fetch_sub(1, std::memory_order_release); }
+    };
+
+    Domain() = default;
+    Domain(const Domain&) = delete;
+    Domain& operator=(const Domain&) = delete;
+
+    // Pointers loaded while the guard lives stay valid until it is destroyed
+    [[nodiscard]] Guard Enter()
+    {
+        auto phase = _phase.load(std::memory_order_relaxed) & 1;
+        auto counter = &_readers[phase * Stripes + ThreadStripe()].Value;
+        counter->fetch_add(1, std::memory_order_seq_cst);
+        return Guard(counter);
+    }
+
+    // Waits for readers which entered before the call, writers must be serialized by the caller
+    void Synchronize()
+    {
+        for (uint32_t i = 0; i < 2; i++)
+        {
+            auto old = _phase.fetch_add(1, std::memory_order_seq_cst) & 1;
+
+            while (!Drained(old))
+                std::this_thread::yield();
+        }
+    }
+};
+
+} // namespace grace_period
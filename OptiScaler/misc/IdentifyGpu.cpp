@@ -155,6 +155,10 @@ std::vector<GpuInformation> IdentifyGpu::checkGpuInfo()
                     gpuInfo.amdHwGeneration = cardInfo.value().generation;
             }
 
+            LARGE_INTEGER umdVersion {};
+            if (adapter->CheckInterfaceSupport(__uuidof(IDXGIDevice), &umdVersion) == S_OK)
+                gpuInfo.driverVersion = (uint64_t) umdVersion.QuadPart;
+
             Util::Luid luid(gpuInfo.luid.LowPart, gpuInfo.luid.HighPart);
 
             if (storePaths.contains(luid))
@@ -55,6 +55,7 @@ struct GpuInformation
     uint32_t subsystemId = 0x0;
     uint32_t revisionId = 0x0;
     size_t dedicatedVramInBytes = 0;
+    uint64_t driverVersion = 0; // UMD version, 0 when unknown
     bool usesDxvk = false;
     bool usesVkd3dProton = false;
     bool softwareAdapter = false;
@@ -0,0 +1,122 @@
+#include "pch.h"
+#include "PrecisionSleep.h"
+
+#include <intrin.h>
+#include <immintrin.h>
+
+static precision_wait::Calibrator _calibrator;
+
+// TSC cycles of one tpause step, about a microsecond or less
+static constexpr uint64_t TpauseCycles = 2000;
+
+static bool HasWaitPkg()
+{
+    static const bool result = []()
+    {
+        int info[4] {};
+        __cpuid(info, 0);
+
+        if (info[0] < 7)
+            return false;
+
+        __cpuidex(info, 7, 0);
+        return (info[2] & (1 << 5)) != 0;
+    }();
+
+    return result;
+}
+
+// High resolution waitable timer per thread, limiter and low latency techs can wait at the same time
+class ThreadTimer
+{
+  private:
+    HANDLE _handle = nullptr;
+
+  public:
+    ThreadTimer()
+    {
+        _handle = CreateWaitableTimerExW(NULL, NULL, CREATE_WAITABLE_TIMER_HIGH_RESOLUTION, TIMER_ALL_ACCESS);
+    }
+
+    ~ThreadTimer()
+    {
+        if (_handle != nullptr)
+            CloseHandle(_handle);
+    }
+
+    HANDLE Handle() const { return _handle; }
+};
+
+class WinClock
+{
+  private:
+    static uint64_t Frequency()
+    {
+        static const uint64_t frequency = []()
+        {
+            LARGE_INTEGER value;
+            QueryPerformanceFrequency(&value);
+            return (uint64_t) value.QuadPart;
+        }();
+
+        return frequency;
+    }
+
+  public:
+    uint64_t Now()
+    {
+        LARGE_INTEGER counter;
+        QueryPerformanceCounter(&counter);
+
+        auto value = (uint64_t) counter.QuadPart;
+        auto frequency = Frequency();
+
+        return (value / frequency) * 1'000'000'000ULL + (value % frequency) * 1'000'000'000ULL / frequency;
+    }
+
+    // https://learn.microsoft.com/en-us/windows/win32/sync/using-waitable-timer-objects
+    int Sleep(int64_t ns)
+    {
+        thread_local ThreadTimer timer;
+
+        if (timer.Handle() == nullptr)
+            return 1;
+
+        LARGE_INTEGER dueTime;
+        dueTime.QuadPart = -(ns / 100);
+
+        if (!SetWaitableTimerEx(timer.Handle(), &dueTime, 0, NULL, NULL, NULL, 0))
+            return 2;
+
+        if (WaitForSingleObject(timer.Handle(), (DWORD) (ns / 1'000'000) + 1000) != WAIT_OBJECT_0)
+            return 3;
+
+        return 0;
+    }
+
+    void Relax(uint64_t)
+    {
+        if (HasWaitPkg())
+            _tpause(0, __rdtsc() + TpauseCycles);
+        else
+            _mm_pause();
+    }
+};
+
+int PrecisionSleep::Wait(int64_t ns)
+{
+    WinClock clock;
+    return precision_wait::WaitFor(clock, _calibrator, ns);
+}
+
+int PrecisionSleep::WaitUntil(uint64_t deadline)
+{
+    WinClock clock;
+    return precision_wait::WaitUntil(clock, _calibrator, deadline);
+}
+
+uint64_t PrecisionSleep::Now() { return WinClock().Now(); }
+
+precision_wait::Stats PrecisionSleep::Stats() { return _calibrator.GetStats(); }
+
+void PrecisionSleep::ResetStats() { _calibrator.ResetStats(); }
@@ -0,0 +1,18 @@
+#pragma once
+#include "SysUtils.h"
+#include "PrecisionWait.h"
+
+// Shared precise sleep of the frame limiter and low latency techs
+class PrecisionSleep
+{
+  public:
+    // Returns 0 on success, timer errors are logged by the caller
+    static int Wait(int64_t ns);
+    static int WaitUntil(uint64_t deadline);
+
+    // Time base of WaitUntil, QPC in ns
+    static uint64_t Now();
+
+    static precision_wait::Stats Stats();
+    static void ResetStats();
+};
@@ -0,0 +1,204 @@
+#pragma once
+
+#include <array>
+#include <mutex>
+#include <cstdint>
+
+// Precise waits with an OS timer for the bulk of the wait and a short spin for the rest.
+// How early the timer has to wake up (spin margin) is learned from the timer's overshoot
+// instead of a fixed threshold. Clock is a template parameter, so the logic can be tested
+// and benchmarked on any OS.
+namespace precision_wait
+{
+
+// Overshoot histogram, 20us buckets up to 2.56ms
+inline constexpr int64_t BucketNs = 20'000;
+inline constexpr uint32_t BucketCount = 128;
+
+// Until this many timer waits are measured the old fixed 2ms margin is used
+inline constexpr uint32_t WarmupSamples = 32;
+inline constexpr int64_t DefaultMarginNs = 2'000'000;
+
+// Margin covers this share of the measured overshoots plus a small safety
+inline constexpr uint32_t MarginQuantilePermille = 990;
+inline constexpr int64_t SafetyNs = 50'000;
+inline constexpr int64_t MinMarginNs = 100'000;
+inline constexpr int64_t MaxMarginNs = 4'000'000;
+
+// Histogram counts are halved after this many samples, so it follows changes of the timer
+inline constexpr uint32_t DecaySamples = 512;
+
+struct Stats
+{
+    uint64_t Waits = 0;
+    uint64_t TimerWaits = 0;
+
+    // Wake up error of the whole wait, positive values are late
+    double MeanErrorNs = 0.0;
+    int64_t MaxErrorNs = 0;
+
+    // How late the OS timer itself wakes up
+    double MeanOvershootNs = 0.0;
+
+    double MeanSpinNs = 0.0;
+    int64_t MarginNs = DefaultMarginNs;
+};
+
+// Learns the overshoot distribution and keeps the statistics, thread safe
+class Calibrator
+{
+  private:
+    mutable std::mutex _mutex;
+    std::array<uint32_t, BucketCount + 1> _buckets {};
+    uint32_t _samples = 0;
+    uint32_t _sinceDecay = 0;
+    int64_t _margin = DefaultMarginNs;
+    Stats _stats;
+
+    // Running mean without keeping a sum
+    static void Accumulate(double& mean, uint64_t count, double value) { mean += (value - mean) / (double) count; }
+
+    void UpdateMargin()
+    {
+        if (_samples < WarmupSamples)
+            return;
+
+        uint64_t total = 0;
+        for (auto count : _buckets)
+            total += count;
+
+        if (total == 0)
+            return;
+
+        auto target = (total * MarginQuantilePermille + 999) / 1000;
+        uint64_t seen = 0;
+        uint32_t bucket = 0;
+
+        for (; bucket < _buckets.size(); bucket++)
+        {
+            seen += _buckets[bucket];
+
+            if (seen >= target)
+                break;
+        }
+
+        // Upper edge of the bucket, overflow bucket goes to max
+        auto margin = bucket >= BucketCount ? MaxMarginNs : (int64_t) (bucket + 1) * BucketNs + SafetyNs;
+
+        if (margin < MinMarginNs)
+            margin = MinMarginNs;
+        else if (margin > MaxMarginNs)
+            margin = MaxMarginNs;
+
+        _margin = margin;
+    }
+
+  public:
+    int64_t Margin() const
+    {
+        std::scoped_lock lock(_mutex);
+        return _margin;
+    }
+
+    void RecordOvershoot(int64_t overshootNs)
+    {
+        if (overshootNs < 0)
+            overshootNs = 0;
+
+        std::scoped_lock lock(_mutex);
+
+        auto bucket = (uint64_t) (overshootNs / BucketNs);
+        _buckets[bucket < BucketCount ? bucket : BucketCount]++;
+
+        if (_samples < WarmupSamples)
+            _samples++;
+
+        if (++_sinceDecay >= DecaySamples)
+        {
+            for (auto& count : _buckets)
+                count /= 2;
+
+            _sinceDecay = 0;
+        }
+
+        _stats.TimerWaits++;
+        Accumulate(_stats.MeanOvershootNs, _stats.TimerWaits, (double) overshootNs);
+
+        UpdateMargin();
+        _stats.MarginNs = _margin;
+    }
+
+    void RecordWait(int64_t errorNs, int64_t spinNs)
+    {
+        std::scoped_lock lock(_mutex);
+
+        _stats.Waits++;
+        Accumulate(_stats.MeanErrorNs, _stats.Waits, (double) errorNs);
+        Accumulate(_stats.MeanSpinNs, _stats.Waits, (double) spinNs);
+
+        if (errorNs > _stats.MaxErrorNs)
+            _stats.MaxErrorNs = errorNs;
+    }
+
+    Stats GetStats() const
+    {
+        std::scoped_lock lock(_mutex);
+        return _stats;
+    }
+
+    void ResetStats()
+    {
+        std::scoped_lock lock(_mutex);
+        _stats = {};
+        _stats.MarginNs = _margin;
+    }
+};
+
+// Clock needs:
+//   uint64_t Now();             monotonic time in ns
+//   int Sleep(int64_t ns);      OS timer wait, returns 0 on success
+//   void Relax(uint64_t until); one short spin step, may return early
+// Returns the error of Sleep, the wait is still finished by spinning in that case.
+template <typename Clock> int WaitUntil(Clock& clock, Calibrator& calibrator, uint64_t deadline)
+{
+    int status = 0;
+    auto start = clock.Now();
+
+    if (deadline <= start)
+        return status;
+
+    auto timerNs = (int64_t) (deadline - start) - calibrator.Margin();
+
+    if (timerNs > 0)
+    {
+        status = clock.Sleep(timerNs);
+
+        auto woke = clock.Now();
+
+        if (status == 0)
+            calibrator.RecordOvershoot((int64_t) (woke - start) - timerNs);
+    }
+
+    auto spinStart = clock.Now();
+    auto now = spinStart;
+
+    while (now < deadline)
+    {
+        clock.Relax(deadline);
+        now = clock.Now();
+    }
+
+    calibrator.RecordWait((int64_t) (now - deadline), (int64_t) (now - spinStart));
+
+    return status;
+}
+
+template <typename Clock> int WaitFor(Clock& clock, Calibrator& calibrator, int64_t ns)
+{
+    if (ns <= 0)
+        return 0;
+
+    return WaitUntil(clock, calibrator, clock.Now() + (uint64_t) ns);
+}
+
+} // namespace precision_wait
@@ -0,0 +1,208 @@
+#pragma once
+
+#include <span>
+#include <atomic>
+#include <string>
+#include <thread>
+#include <vector>
+#include <cstdint>
+#include <cstring>
+#include <optional>
+
+// Chunked tree hash for big files.
+// Data is split into fixed size chunks which are hashed with XXH64 in parallel,
+// chunk digests are hashed again to get the final value. Result does not depend
+// on number of workers. No platform dependencies, so it can be benchmarked on any OS.
+namespace tree_hash
+{
+
+inline constexpr size_t ChunkSize = 4 * 1024 * 1024;
+
+namespace detail
+{
+inline constexpr uint64_t Prime1 = 0x9E3779B185EBCA87ull;
+inline constexpr uint64_t Prime2 = 0xC2B2AE3D27D4EB4Full;
+inline constexpr uint64_t Prime3 = 0x165667B19E3779F9ull;
+inline constexpr uint64_t Prime4 = 0x85EBCA77C2B2AE63ull;
+inline constexpr uint64_t Prime5 = 0x27D4EB2F165667C5ull;
+
+inline uint64_t Rotl(uint64_t value, int bits) { return (value << bits) | (value >> (64 - bits)); }
+
+inline uint64_t Read64(const uint8_t* data)
+{
+    uint64_t value;
+    memcpy(&value, data, sizeof(value));
+    return value;
+}
+
+inline uint32_t Read32(const uint8_t* data)
+{
+    uint32_t value;
+    memcpy(&value, data, sizeof(value));
+    return value;
+}
+
+inline uint64_t Round(uint64_t acc, uint64_t input)
+{
+    acc += input * Prime2;
+    acc = Rotl(acc, 31);
+    return acc * Prime1;
+}
+
+inline uint64_t MergeRound(uint64_t acc, uint64_t value)
+{
+    acc ^= Round(0, value);
+    return acc * Prime1 + Prime4;
+}
+} // namespace detail
+
+// Reference XXH64, little endian hosts only
+inline uint64_t XXH64(const uint8_t* data, size_t size, uint64_t seed = 0)
+{
+    using namespace detail;
+
+    auto end = data + size;
+    uint64_t hash;
+
+    if (size >= 32)
+    {
+        uint64_t v1 = seed + Prime1 + Prime2;
+        uint64_t v2 = seed + Prime2;
+        uint64_t v3 = seed;
+        uint64_t v4 = seed - Prime1;
+
+        auto limit = end - 32;
+        do
+        {
+            v1 = Round(v1, Read64(data));
+            v2 = Round(v2, Read64(data + 8));
+            v3 = Round(v3, Read64(data + 16));
+            v4 = Round(v4, Read64(data + 24));
+            data += 32;
+        } while (data <= limit);
+
+        hash = Rotl(v1, 1) + Rotl(v2, 7) + Rotl(v3, 12) + Rotl(v4, 18);
+        hash = MergeRound(hash, v1);
+        hash = MergeRound(hash, v2);
+        hash = MergeRound(hash, v3);
+        hash = MergeRound(hash, v4);
+    }
+    else
+    {
+        hash = seed + Prime5;
+    }
+
+    hash += (uint64_t) size;
+
+    while (data + 8 <= end)
+    {
+        hash ^= Round(0, Read64(data));
+        hash = Rotl(hash, 27) * Prime1 + Prime4;
+        data += 8;
+    }
+
+    if (data + 4 <= end)
+    {
+        hash ^= (uint64_t) Read32(data) * Prime1;
+        hash = Rotl(hash, 23) * Prime2 + Prime3;
+        data += 4;
+    }
+
+    while (data < end)
+    {
+        hash ^= (*data) * Prime5;
+        hash = Rotl(hash, 11) * Prime1;
+        data++;
+    }
+
+    hash ^= hash >> 33;
+    hash *= Prime2;
+    hash ^= hash >> 29;
+    hash *= Prime3;
+    hash ^= hash >> 32;
+
+    return hash;
+}
+
+struct Digest
+{
+    uint64_t High = 0;
+    uint64_t Low = 0;
+
+    bool operator==(const Digest&) const = default;
+
+    std::string ToString() const
+    {
+        static constexpr char hex[] = "0123456789abcdef";
+        std::string result(32, '0');
+
+        for (int i = 0; i < 16; i++)
+        {
+            result[15 - i] = hex[(High >> (i * 4)) & 0xF];
+            result[31 - i] = hex[(Low >> (i * 4)) & 0xF];
+        }
+
+        return result;
+    }
+};
+
+// Root of the tree, total size is mixed in so truncated files never match
+inline Digest Combine(std::span<const uint64_t> chunkHashes, uint64_t totalSize)
+{
+    auto bytes = reinterpret_cast<const uint8_t*>(chunkHashes.data());
+    auto size = chunkHashes.size_bytes();
+
+    Digest digest;
+    digest.High = XXH64(bytes, size, totalSize);
+    digest.Low = XXH64(bytes, size, ~totalSize);
+    return digest;
+}
+
+// Hashes data with up to workerCount threads (calling thread included).
+// Returns nullopt when cancel is set before all chunks are done.
+inline std::optional<Digest> Hash(std::span<const uint8_t> data, const std::atomic<bool>& cancel,
+                                  uint32_t workerCount = 1)
+{
+    auto chunkCount = (data.size() + ChunkSize - 1) / ChunkSize;
+    std::vector<uint64_t> chunkHashes(chunkCount);
+    std::atomic<size_t> nextChunk { 0 };
+
+    auto worker = [&]()
+    {
+        while (!cancel.load(std::memory_order_relaxed))
+        {
+            auto chunk = nextChunk.fetch_add(1, std::memory_order_relaxed);
+
+            if (chunk >= chunkCount)
+                break;
+
+            auto offset = chunk * ChunkSize;
+            auto size = data.size() - offset < ChunkSize ? data.size() - offset : ChunkSize;
+
+            // Chunk index as seed, so swapped chunks change the result
+            chunkHashes[chunk] = XXH64(data.data() + offset, size, chunk);
+        }
+    };
+
+    if (workerCount < 1)
+        workerCount = 1;
+
+    if (workerCount > chunkCount)
+        workerCount = chunkCount > 0 ? (uint32_t) chunkCount : 1;
+
+    std::vector<std::thread> helpers;
+    for (uint32_t i = 1; i < workerCount; i++)
+        helpers.emplace_back(worker);
+
+    worker();
+
+    for (auto& helper : helpers)
+        helper.join();
+
+    if (cancel.load(std::memory_order_relaxed))
+        return std::nullopt;
+
+    return Combine(chunkHashes, data.size());
+}
+
+} // namespace tree_hash
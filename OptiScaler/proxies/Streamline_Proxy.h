@@ -310,9 +310,11 @@ class StreamlineProxy
         pref.flags &= ~sl::PreferenceFlags::eLoadDownloadedPlugins;
 
         auto exePath = Util::ExePath().remove_filename();
-        auto nvngxDlssPath = Util::FindFilePath(exePath, "nvngx_dlss.dll");
-        auto nvngxDlssDPath = Util::FindFilePath(exePath, "nvngx_dlssd.dll");
-        auto nvngxDlssGPath = Util::FindFilePath(exePath, "nvngx_dlssg.dll");
+        const std::filesystem::path nvngxFiles[] = { "nvngx_dlss.dll", "nvngx_dlssd.dll", "nvngx_dlssg.dll" };
+        auto nvngxPaths = Util::FindFilePaths({ &exePath, 1 }, nvngxFiles);
+        auto& nvngxDlssPath = nvngxPaths[0];
+        auto& nvngxDlssDPath = nvngxPaths[1];
+        auto& nvngxDlssGPath = nvngxPaths[2];
 
         std::vector<std::wstring> pathStorage;
 
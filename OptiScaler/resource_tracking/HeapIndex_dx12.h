@@ -0,0 +1,175 @@
+#pragma once
+
+#include <misc/GracePeriod.h>
+
+#include <vector>
+#include <atomic>
+#include <memory>
+#include <cstdint>
+#include <algorithm>
+
+// Sorted [start, end) interval index used to map descriptor handles to their heaps.
+// Readers never lock, they load the current snapshot inside a grace period guard and binary search it.
+// Writers (heap create / release) must be serialized by the caller, they build a new snapshot
+// copy-on-write, publish it with a single atomic store and free the old one once no reader can hold it.
+template <typename T> class HeapIntervalIndex
+{
+  public:
+    struct Range
+    {
+        size_t start = 0;
+        size_t end = 0;
+        T* value = nullptr;
+    };
+
+  private:
+    struct Snapshot
+    {
+        uint64_t epoch = 0;
+        std::vector<size_t> starts; // kept separate for cache friendly search
+        std::vector<Range> ranges;
+    };
+
+    std::atomic<Snapshot*> _current { nullptr };
+    std::unique_ptr<Snapshot> _owned;
+    uint64_t _epoch = 0;
+
+    // Readers hold a guard while they use a snapshot
+    mutable grace_period::Domain _readers;
+
+    void Publish(std::unique_ptr<Snapshot> snapshot)
+    {
+        snapshot->epoch = ++_epoch;
+        _current.store(snapshot.get(), std::memory_order_seq_cst);
+
+        auto retired = std::move(_owned);
+        _owned = std::move(snapshot);
+
+        // Heap creation is rare compared to lookups, waiting for the readers here is cheap
+        if (retired != nullptr)
+            _readers.Synchronize();
+    }
+
+    std::unique_ptr<Snapshot> CopyCurrent() const
+    {
+        auto snapshot = std::make_unique<Snapshot>();
+        auto current = _current.load(std::memory_order_acquire);
+
+        if (current != nullptr)
+        {
+            snapshot->starts.reserve(current->starts.size() + 1);
+            snapshot->ranges.reserve(current->ranges.size() + 1);
+            snapshot->starts = current->starts;
+            snapshot->ranges = current->ranges;
+        }
+
+        return snapshot;
+    }
+
+  public:
+    HeapIntervalIndex() = default;
+    HeapIntervalIndex(const HeapIntervalIndex&) = delete;
+    HeapIntervalIndex& operator=(const HeapIntervalIndex&) = delete;
+
+    // Lock free, returns nullptr when handle is not inside any range
+    T* Find(size_t handle) const
+    {
+        auto guard = _readers.Enter();
+        auto snapshot = _current.load(std::memory_order_seq_cst);
+
+        if (snapshot == nullptr || snapshot->starts.empty())
+            return nullptr;
+
+        auto& starts = snapshot->starts;
+
+        // first range which starts after handle, previous one is the candidate
+        auto it = std::upper_bound(starts.begin(), starts.end(), handle);
+
+        if (it == starts.begin())
+            return nullptr;
+
+        auto& range = snapshot->ranges[(it - starts.begin()) - 1];
+
+        if (handle >= range.end)
+            return nullptr;
+
+        return range.value;
+    }
+
+    uint64_t Epoch() const
+    {
+        auto guard = _readers.Enter();
+        auto snapshot = _current.load(std::memory_order_seq_cst);
+        return snapshot == nullptr ? 0 : snapshot->epoch;
+    }
+
+    size_t Size() const
+    {
+        auto guard = _readers.Enter();
+        auto snapshot = _current.load(std::memory_order_seq_cst);
+        return snapshot == nullptr ? 0 : snapshot->ranges.size();
+    }
+
+    // Caller must serialize writers
+    void Insert(size_t start, size_t end, T* value)
+    {
+        if (start == 0 || end <= start || value == nullptr)
+            return;
+
+        auto snapshot = CopyCurrent();
+
+        // drop any stale range overlapping the new one, address space got reused
+        for (size_t i = 0; i < snapshot->ranges.size();)
+        {
+            auto& range = snapshot->ranges[i];
+
+            if (range.start < end && start < range.end)
+            {
+                snapshot->ranges.erase(snapshot->ranges.begin() + i);
+                snapshot->starts.erase(snapshot->starts.begin() + i);
+                continue;
+            }
+
+            i++;
+        }
+
+        auto it = std::upper_bound(snapshot->starts.begin(), snapshot->starts.end(), start);
+        auto pos = it - snapshot->starts.begin();
+
+        snapshot->starts.insert(it, start);
+        snapshot->ranges.insert(snapshot->ranges.begin() + pos, Range { start, end, value });
+
+        Publish(std::move(snapshot));
+    }
+
+    // Caller must serialize writers
+    void Remove(T* value)
+    {
+        if (value == nullptr)
+            return;
+
+        auto current = _current.load(std::memory_order_acquire);
+
+        if (current == nullptr || std::none_of(current->ranges.begin(), current->ranges.end(),
+                                               [value](const Range& r) { return r.value == value; }))
+        {
+            return;
+        }
+
+        auto snapshot = CopyCurrent();
+
+        for (size_t i = 0; i < snapshot->ranges.size();)
+        {
+            if (snapshot->ranges[i].value == value)
+            {
+                snapshot->ranges.erase(snapshot->ranges.begin() + i);
+                snapshot->starts.erase(snapshot->starts.begin() + i);
+                continue;
+            }
+
+            i++;
+        }
+
+        Publish(std::move(snapshot));
+    }
+};
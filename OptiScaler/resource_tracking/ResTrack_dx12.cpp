@@ -1,5 +1,6 @@
 #include "pch.h"
 #include "ResTrack_dx12.h"
+#include "HeapIndex_dx12.h"
 
 #include <Config.h>
 #include <State.h>
@@ -127,6 +128,16 @@ static std::mutex _heapCreationMutex;
 
 static std::vector<std::unique_ptr<HeapInfo>> fgHeaps;
 
+// Handle -> heap lookup indexes, rebuilt under _heapCreationMutex, read without locks
+static HeapIntervalIndex<HeapInfo> _cpuHeapIndex;
+static HeapIntervalIndex<HeapInfo> _gpuHeapIndex;
+
+#ifdef USE_SPINLOCK_MUTEX
+static SpinLock _capturedHudlessesMutex;
+#else
+static std::mutex _capturedHudlessesMutex;
+#endif
+
 static std::set<void*> _notFoundCmdLists;
 static std::unordered_map<FG_ResourceType, void*> _resCmdList[BUFFER_COUNT];
 
@@ -267,20 +278,16 @@ void ResTrack_Dx12::ResourceBarrier(ID3D12GraphicsCommandList* InCommandList, ID
 
 SIZE_T ResTrack_Dx12::GetGPUHandle(ID3D12Device* This, SIZE_T cpuHandle, D3D12_DESCRIPTOR_HEAP_TYPE type)
 {
-    size_t count = fgHeaps.size();
-    for (size_t i = 0; i < count; i++)
+    auto val = _cpuHeapIndex.Find(cpuHandle);
+
+    if (val != nullptr && val->active && val->gpuStart != 0)
     {
-        auto val = fgHeaps[i].get();
-        if (fgHeaps[i] != nullptr && val->active && val->cpuStart <= cpuHandle && val->cpuEnd > cpuHandle &&
-            val->gpuStart != 0)
-        {
-            auto incSize = This->GetDescriptorHandleIncrementSize(type);
-            auto addr = cpuHandle - val->cpuStart;
-            auto index = addr / incSize;
-            auto gpuAddr = val->gpuStart + (index * incSize);
+        auto incSize = This->GetDescriptorHandleIncrementSize(type);
+        auto addr = cpuHandle - val->cpuStart;
+        auto index = addr / incSize;
+        auto gpuAddr = val->gpuStart + (index * incSize);
 
-            return gpuAddr;
-        }
+        return gpuAddr;
     }
 
     return NULL;
@@ -288,20 +295,16 @@ SIZE_T ResTrack_Dx12::GetGPUHandle(ID3D12Device* This, SIZE_T cpuHandle, D3D12_D
 
 SIZE_T ResTrack_Dx12::GetCPUHandle(ID3D12Device* This, SIZE_T gpuHandle, D3D12_DESCRIPTOR_HEAP_TYPE type)
 {
-    size_t count = fgHeaps.size();
-    for (size_t i = 0; i < count; i++)
+    auto val = _gpuHeapIndex.Find(gpuHandle);
+
+    if (val != nullptr && val->active && val->cpuStart != 0)
     {
-        auto val = fgHeaps[i].get();
-        if (fgHeaps[i] != nullptr && val->active && val->gpuStart <= gpuHandle && val->gpuEnd > gpuHandle &&
-            val->cpuStart != 0)
-        {
-            auto incSize = This->GetDescriptorHandleIncrementSize(type);
-            auto addr = gpuHandle - val->gpuStart;
-            auto index = addr / incSize;
-            auto cpuAddr = val->cpuStart + (index * incSize);
+        auto incSize = This->GetDescriptorHandleIncrementSize(type);
+        auto addr = gpuHandle - val->gpuStart;
+        auto index = addr / incSize;
+        auto cpuAddr = val->cpuStart + (index * incSize);
 
-            return cpuAddr;
-        }
+        return cpuAddr;
     }
 
     return NULL;
@@ -317,17 +320,14 @@ HeapInfo* ResTrack_Dx12::GetHeapByCpuHandleCBV(SIZE_T cpuHandle)
         return cacheCBV.heapPtr;
     }
 
-    size_t count = fgHeaps.size();
-    for (size_t i = 0; i < count; i++)
+    auto heap = _cpuHeapIndex.Find(cpuHandle);
+
+    if (heap != nullptr && heap->active)
     {
-        if (fgHeaps[i] != nullptr && fgHeaps[i]->active && fgHeaps[i]->cpuStart <= cpuHandle &&
-            cpuHandle < fgHeaps[i]->cpuEnd)
-        {
-            cacheCBV.genSeen = currentGen;
-            cacheCBV.heapPtr = fgHeaps[i].get();
-            cacheCBV.heapVersion = cacheCBV.heapPtr->version;
-            return cacheCBV.heapPtr;
-        }
+        cacheCBV.genSeen = currentGen;
+        cacheCBV.heapPtr = heap;
+        cacheCBV.heapVersion = heap->version;
+        return heap;
     }
 
     cacheCBV.heapVersion = 0;
@@ -345,17 +345,14 @@ HeapInfo* ResTrack_Dx12::GetHeapByCpuHandleRTV(SIZE_T cpuHandle)
         return cacheRTV.heapPtr;
     }
 
-    size_t count = fgHeaps.size();
-    for (size_t i = 0; i < count; i++)
+    auto heap = _cpuHeapIndex.Find(cpuHandle);
+
+    if (heap != nullptr && heap->active)
     {
-        if (fgHeaps[i] != nullptr && fgHeaps[i]->active && fgHeaps[i]->cpuStart <= cpuHandle &&
-            cpuHandle < fgHeaps[i]->cpuEnd)
-        {
-            cacheRTV.genSeen = currentGen;
-            cacheRTV.heapPtr = fgHeaps[i].get();
-            cacheRTV.heapVersion = cacheRTV.heapPtr->version;
-            return cacheRTV.heapPtr;
-        }
+        cacheRTV.genSeen = currentGen;
+        cacheRTV.heapPtr = heap;
+        cacheRTV.heapVersion = heap->version;
+        return heap;
     }
 
     cacheRTV.heapVersion = 0;
@@ -373,17 +370,14 @@ HeapInfo* ResTrack_Dx12::GetHeapByCpuHandleSRV(SIZE_T cpuHandle)
         return cacheSRV.heapPtr;
     }
 
-    size_t count = fgHeaps.size();
-    for (size_t i = 0; i < count; i++)
+    auto heap = _cpuHeapIndex.Find(cpuHandle);
+
+    if (heap != nullptr && heap->active)
     {
-        if (fgHeaps[i] != nullptr && fgHeaps[i]->active && fgHeaps[i]->cpuStart <= cpuHandle &&
-            cpuHandle < fgHeaps[i]->cpuEnd)
-        {
-            cacheSRV.genSeen = currentGen;
-            cacheSRV.heapPtr = fgHeaps[i].get();
-            cacheSRV.heapVersion = cacheSRV.heapPtr->version;
-            return cacheSRV.heapPtr;
-        }
+        cacheSRV.genSeen = currentGen;
+        cacheSRV.heapPtr = heap;
+        cacheSRV.heapVersion = heap->version;
+        return heap;
     }
 
     cacheSRV.heapVersion = 0;
@@ -401,17 +395,14 @@ HeapInfo* ResTrack_Dx12::GetHeapByCpuHandleUAV(SIZE_T cpuHandle)
         return cacheUAV.heapPtr;
     }
 
-    size_t count = fgHeaps.size();
-    for (size_t i = 0; i < count; i++)
+    auto heap = _cpuHeapIndex.Find(cpuHandle);
+
+    if (heap != nullptr && heap->active)
     {
-        if (fgHeaps[i] != nullptr && fgHeaps[i]->active && fgHeaps[i]->cpuStart <= cpuHandle &&
-            cpuHandle < fgHeaps[i]->cpuEnd)
-        {
-            cacheUAV.genSeen = currentGen;
-            cacheUAV.heapPtr = fgHeaps[i].get();
-            cacheUAV.heapVersion = cacheUAV.heapPtr->version;
-            return cacheUAV.heapPtr;
-        }
+        cacheUAV.genSeen = currentGen;
+        cacheUAV.heapPtr = heap;
+        cacheUAV.heapVersion = heap->version;
+        return heap;
     }
 
     cacheUAV.heapVersion = 0;
@@ -428,17 +419,14 @@ HeapInfo* ResTrack_Dx12::GetHeapByCpuHandle(SIZE_T cpuHandle)
         return cache.heapPtr;
     }
 
-    size_t count = fgHeaps.size();
-    for (size_t i = 0; i < count; i++)
+    auto heap = _cpuHeapIndex.Find(cpuHandle);
+
+    if (heap != nullptr && heap->active)
     {
-        if (fgHeaps[i] != nullptr && fgHeaps[i]->active && fgHeaps[i]->cpuStart <= cpuHandle &&
-            cpuHandle < fgHeaps[i]->cpuEnd)
-        {
-            cache.genSeen = currentGen;
-            cache.heapPtr = fgHeaps[i].get();
-            cache.heapVersion = cache.heapPtr->version;
-            return cache.heapPtr;
-        }
+        cache.genSeen = currentGen;
+        cache.heapPtr = heap;
+        cache.heapVersion = heap->version;
+        return heap;
     }
 
     cache.heapVersion = 0;
@@ -459,17 +447,14 @@ HeapInfo* ResTrack_Dx12::GetHeapByGpuHandleGR(SIZE_T gpuHandle)
         return cacheGR.heapPtr;
     }
 
-    size_t count = fgHeaps.size();
-    for (size_t i = 0; i < count; i++)
+    auto heap = _gpuHeapIndex.Find(gpuHandle);
+
+    if (heap != nullptr && heap->active)
     {
-        if (fgHeaps[i] != nullptr && fgHeaps[i]->active && fgHeaps[i]->gpuStart <= gpuHandle &&
-            gpuHandle < fgHeaps[i]->gpuEnd)
-        {
-            cacheGR.genSeen = currentGen;
-            cacheGR.heapPtr = fgHeaps[i].get();
-            cacheGR.heapVersion = cacheGR.heapPtr->version;
-            return cacheGR.heapPtr;
-        }
+        cacheGR.genSeen = currentGen;
+        cacheGR.heapPtr = heap;
+        cacheGR.heapVersion = heap->version;
+        return heap;
     }
 
     cacheGR.heapVersion = 0;
@@ -490,17 +475,14 @@ HeapInfo* ResTrack_Dx12::GetHeapByGpuHandleCR(SIZE_T gpuHandle)
         return cacheCR.heapPtr;
     }
 
-    size_t count = fgHeaps.size();
-    for (size_t i = 0; i < count; i++)
+    auto heap = _gpuHeapIndex.Find(gpuHandle);
+
+    if (heap != nullptr && heap->active)
     {
-        if (fgHeaps[i] != nullptr && fgHeaps[i]->active && fgHeaps[i]->gpuStart <= gpuHandle &&
-            gpuHandle < fgHeaps[i]->gpuEnd)
-        {
-            cacheCR.genSeen = currentGen;
-            cacheCR.heapPtr = fgHeaps[i].get();
-            cacheCR.heapVersion = cacheCR.heapPtr->version;
-            return cacheCR.heapPtr;
-        }
+        cacheCR.genSeen = currentGen;
+        cacheCR.heapPtr = heap;
+        cacheCR.heapVersion = heap->version;
+        return heap;
     }
 
     cacheCR.heapVersion = 0;
@@ -837,31 +819,20 @@ static ULONG STDMETHODCALLTYPE hkHeapRelease(ID3D12DescriptorHeap* This)
 #endif
 
             up->active = false;
+            _cpuHeapIndex.Remove(up.get());
+            _gpuHeapIndex.Remove(up.get());
 
             LOG_INFO("Heap released: {:X}", (size_t) This);
 
-            // detach all slots from _trackedResources
+            // detach all slots from TrackedResources
+            for (UINT j = 0; j < up->numDescriptors; ++j)
             {
-                std::scoped_lock lk(_trackedResourcesMutex);
-
-                for (UINT j = 0; j < up->numDescriptors; ++j)
-                {
-                    auto& slot = up->info[j];
-
-                    if (slot.buffer == nullptr)
-                        continue;
+                auto& slot = up->info[j];
 
-                    if (auto it = _trackedResources.find(slot.buffer); it != _trackedResources.end())
-                    {
-                        auto& vec = it->second;
-                        vec.erase(std::remove(vec.begin(), vec.end(), &slot), vec.end());
-                        if (vec.empty())
-                            _trackedResources.erase(it);
-                    }
+                TrackedResources::Detach(&up->links[j]);
 
-                    slot.buffer = nullptr;
-                    slot.lastUsedFrame = 0;
-                }
+                slot.buffer = nullptr;
+                slot.lastUsedFrame = 0;
             }
 
             gHeapGeneration.fetch_add(1, std::memory_order_release); // invalidate caches
@@ -924,11 +895,16 @@ HRESULT ResTrack_Dx12::hkCreateDescriptorHeap(ID3D12Device* This, D3D12_DESCRIPT
             {
                 if (fgHeaps[i] != nullptr && !fgHeaps[i]->active)
                 {
+                    _cpuHeapIndex.Remove(fgHeaps[i].get());
+                    _gpuHeapIndex.Remove(fgHeaps[i].get());
 
                     fgHeaps[i].reset();
                     fgHeaps[i] = std::make_unique<HeapInfo>(heap, cpuStart, cpuEnd, gpuStart, gpuEnd, numDescriptors,
                                                             increment, type);
 
+                    _cpuHeapIndex.Insert(cpuStart, cpuEnd, fgHeaps[i].get());
+                    _gpuHeapIndex.Insert(gpuStart, gpuEnd, fgHeaps[i].get());
+
                     gHeapGeneration.fetch_add(1, std::memory_order_release);
                     foundEmpty = true;
                     LOG_DEBUG("Reusing empty heap slot: {}", i);
@@ -945,6 +921,9 @@ HRESULT ResTrack_Dx12::hkCreateDescriptorHeap(ID3D12Device* This, D3D12_DESCRIPT
                 fgHeaps.push_back(std::make_unique<HeapInfo>(heap, cpuStart, cpuEnd, gpuStart, gpuEnd, numDescriptors,
                                                              increment, type));
 
+                _cpuHeapIndex.Insert(cpuStart, cpuEnd, fgHeaps.back().get());
+                _gpuHeapIndex.Insert(gpuStart, gpuEnd, fgHeaps.back().get());
+
                 gHeapGeneration.fetch_add(1, std::memory_order_release);
                 LOG_DEBUG("Adding new heap slot: {}", fgHeaps.size() - 1);
             }
@@ -968,29 +947,22 @@ ULONG ResTrack_Dx12::hkRelease(ID3D12Resource* This)
     if (State::Instance().isShuttingDown)
         return o_Release(This);
 
-    std::vector<ResourceInfo*> toClean;
+    bool wasTracked = false;
     {
-        std::lock_guard lock(_trackedResourcesMutex);
+        auto& shard = TrackedResources::GetShard(This);
+        std::scoped_lock lock(shard.mutex);
 
         This->AddRef();
         auto refCount = o_Release(This);
 
-        if (refCount <= 1 && _trackedResources.contains(This))
-        {
-            toClean = _trackedResources[This]; // Copy vector
-            _trackedResources.erase(This);
-            State::Instance().capturedHudlesses.erase(This);
-        }
+        if (refCount <= 1)
+            wasTracked = TrackedResources::DetachAllLocked(shard, This);
     }
 
-    // Clean up outside lock
-    for (auto* info : toClean)
+    if (wasTracked)
     {
-        if (info->buffer == This)
-        {
-            info->buffer = nullptr;
-            info->lastUsedFrame = 0;
-        }
+        std::scoped_lock lock(_capturedHudlessesMutex);
+        State::Instance().capturedHudlesses.erase(This);
     }
 
     return o_Release(This);
@@ -1070,7 +1042,7 @@ void ResTrack_Dx12::hkCopyDescriptors(ID3D12Device* This, UINT NumDestDescriptor
             if (cachedSrcHeap != nullptr)
             {
                 // Access to heap info is synchronized through HeapInfo's const methods
-                // which use _trackedResourcesMutex internally
+                // which use TrackedResources shard locks internally
                 srcInfo = cachedSrcHeap->GetByCpuHandle(srcHandle);
             }
 
@@ -1086,7 +1058,7 @@ void ResTrack_Dx12::hkCopyDescriptors(ID3D12Device* This, UINT NumDestDescriptor
         // Update destination heap tracking with proper synchronization
         if (cachedDestHeap != nullptr)
         {
-            // HeapInfo's Set/Clear methods use _trackedResourcesMutex internally
+            // HeapInfo's Set/Clear methods use TrackedResources shard locks internally
             if (srcInfo != nullptr && srcInfo->buffer != nullptr)
                 cachedDestHeap->SetByCpuHandle(destHandle, *srcInfo);
             else
@@ -2094,7 +2066,7 @@ void ResTrack_Dx12::HookDevice(ID3D12Device* device)
     if (fgHeaps.capacity() < 65536)
     {
         _useShards = Config::Instance()->FGUseShards.value_or_default();
-        _trackedResources.reserve(1024);
+        TrackedResources::Reserve(1024);
         fgHeaps.reserve(65536);
     }
 
@@ -3,6 +3,7 @@
 #include "SysUtils.h"
 
 #include <hudfix/Hudfix_Dx12.h>
+#include <resource_tracking/ResourceLinks.h>
 #include <framegen/IFGFeature_Dx12.h>
 
 #include <ankerl/unordered_dense.h>
@@ -120,13 +121,22 @@ struct SpinLock
 #endif
 #endif
 
-static ankerl::unordered_dense::map<ID3D12Resource*, std::vector<ResourceInfo*>> _trackedResources;
 #ifdef USE_SPINLOCK_MUTEX
-static SpinLock _trackedResourcesMutex;
+using TrackedResourceMutex = SpinLock;
 #else
-static std::mutex _trackedResourcesMutex;
+using TrackedResourceMutex = std::mutex;
 #endif
 
+// Intrusive link of a descriptor slot into its resource's descriptor list.
+// Nodes are preallocated per heap so attach/detach never allocates.
+using DescriptorLink = resource_links::Link<ID3D12Resource, ResourceInfo>;
+
+using TrackedResources =
+    resource_links::Map<ID3D12Resource, ResourceInfo, TrackedResourceMutex,
+                        ankerl::unordered_dense::map<ID3D12Resource*, DescriptorLink*>, CACHE_LINE_SIZE>;
+
+using TrackedResourceShard = TrackedResources::Shard;
+
 struct HeapInfo
 {
     // mutable std::shared_mutex mutex;
@@ -140,6 +150,7 @@ struct HeapInfo
     UINT increment = 0;
     UINT type = 0;
     std::shared_ptr<ResourceInfo[]> info;
+    std::unique_ptr<DescriptorLink[]> links;
     UINT lastOffset = 0;
     bool active = true;
     std::atomic<uint64_t> version { 0 };
@@ -147,7 +158,8 @@ struct HeapInfo
     HeapInfo(ID3D12DescriptorHeap* heap, SIZE_T cpuStart, SIZE_T cpuEnd, SIZE_T gpuStart, SIZE_T gpuEnd,
              UINT numResources, UINT increment, UINT type)
         : heap(heap), cpuStart(cpuStart), cpuEnd(cpuEnd), gpuStart(gpuStart), gpuEnd(gpuEnd),
-          numDescriptors(numResources), increment(increment), type(type), info(new ResourceInfo[numResources])
+          numDescriptors(numResources), increment(increment), type(type), info(new ResourceInfo[numResources]),
+          links(new DescriptorLink[numResources])
     {
         static std::atomic<uint64_t> globalHeapVersion { 1 };
         version.store(globalHeapVersion.fetch_add(1, std::memory_order_relaxed), std::memory_order_relaxed);
@@ -155,6 +167,7 @@ struct HeapInfo
         for (size_t i = 0; i < numDescriptors; i++)
         {
             info[i].buffer = nullptr;
+            links[i].info = &info[i];
         }
     }
 
@@ -163,27 +176,16 @@ struct HeapInfo
         if (info[index].buffer == nullptr)
             return;
 
-        std::scoped_lock lock(_trackedResourcesMutex);
         LOG_TRACK("Heap: {:X}, Index: {}, Resource: {:X}, Res: {}x{}, Format: {}", (size_t) this, index,
                   (size_t) info[index].buffer, info[index].width, info[index].height, (UINT) info[index].format);
-        auto it = _trackedResources.find(info[index].buffer);
-        if (it != _trackedResources.end())
-        {
-            auto& vec = it->second;
-            vec.erase(std::remove(vec.begin(), vec.end(), &info[index]), vec.end());
-            if (vec.empty())
-                _trackedResources.erase(it);
-        }
+        TrackedResources::Detach(&links[index]);
     }
 
     void AttachToNewResource(SIZE_T index) const
     {
-        std::scoped_lock lock(_trackedResourcesMutex);
         LOG_TRACK("Heap: {:X}, Index: {}, Resource: {:X}, Res: {}x{}, Format: {}", (size_t) this, index,
                   (size_t) info[index].buffer, info[index].width, info[index].height, (UINT) info[index].format);
-        auto& vec = _trackedResources[info[index].buffer];
-        if (std::find(vec.begin(), vec.end(), &info[index]) == vec.end())
-            vec.push_back(&info[index]);
+        TrackedResources::Attach(&links[index], info[index].buffer);
     }
 
     ResourceInfo* GetByCpuHandle(SIZE_T cpuHandle) const
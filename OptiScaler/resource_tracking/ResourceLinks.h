@@ -0,0 +1,157 @@
+#pragma once
+
+#include <mutex>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+// Resource -> descriptor slots reverse map, sharded by resource pointer
+// so descriptor writes for different resources don't serialize.
+// Each resource owns an intrusive doubly linked list of its slots. Links are preallocated per heap by the
+// caller, so attach / detach never allocates. Info needs buffer and lastUsedFrame members, they are cleared
+// when the resource is released. No platform dependencies, the map and lock types are given by the caller.
+namespace resource_links
+{
+
+template <typename Resource, typename Info> struct Link
+{
+    Link* prev = nullptr;
+    Link* next = nullptr;
+    Info* info = nullptr;
+    std::atomic<Resource*> owner { nullptr };
+};
+
+// HeadMap maps Resource* to the first Link*
+template <typename Resource, typename Info, typename Mutex, typename HeadMap, size_t Alignment = 64> class Map
+{
+  public:
+    using LinkType = Link<Resource, Info>;
+
+    struct alignas(Alignment) Shard
+    {
+        Mutex mutex;
+        HeadMap heads;
+    };
+
+    static constexpr size_t ShardCount = 64;
+
+  private:
+    inline static Shard _shards[ShardCount];
+
+    // Shard lock must be held by caller
+    static void Unlink(Shard& shard, LinkType* link, Resource* resource)
+    {
+        if (link->prev != nullptr)
+        {
+            link->prev->next = link->next;
+        }
+        else
+        {
+            auto it = shard.heads.find(resource);
+
+            if (it != shard.heads.end())
+            {
+                if (link->next == nullptr)
+                    shard.heads.erase(it);
+                else
+                    it->second = link->next;
+            }
+        }
+
+        if (link->next != nullptr)
+            link->next->prev = link->prev;
+
+        link->prev = nullptr;
+        link->next = nullptr;
+        link->owner.store(nullptr, std::memory_order_release);
+    }
+
+  public:
+    static Shard& GetShard(Resource* resource)
+    {
+        auto addr = (uint64_t) (uintptr_t) resource;
+        return _shards[((addr >> 4) ^ (addr >> 12)) % ShardCount];
+    }
+
+    static void Reserve(size_t count)
+    {
+        for (size_t i = 0; i < ShardCount; i++)
+            _shards[i].heads.reserve(count / ShardCount);
+    }
+
+    // Moves the link to the resource's list, a link is in one list at most
+    static void Attach(LinkType* link, Resource* resource)
+    {
+        if (resource == nullptr)
+            return;
+
+        if (auto owner = link->owner.load(std::memory_order_acquire); owner != nullptr && owner != resource)
+            Detach(link);
+
+        auto& shard = GetShard(resource);
+        std::scoped_lock lock(shard.mutex);
+
+        if (link->owner.load(std::memory_order_relaxed) == resource)
+            return;
+
+        auto& head = shard.heads[resource];
+
+        link->prev = nullptr;
+        link->next = head;
+
+        if (head != nullptr)
+            head->prev = link;
+
+        head = link;
+        link->owner.store(resource, std::memory_order_release);
+    }
+
+    static void Detach(LinkType* link)
+    {
+        auto resource = link->owner.load(std::memory_order_acquire);
+
+        if (resource == nullptr)
+            return;
+
+        auto& shard = GetShard(resource);
+        std::scoped_lock lock(shard.mutex);
+
+        // Might be unlinked by hkRelease while we were waiting
+        if (link->owner.load(std::memory_order_relaxed) != resource)
+            return;
+
+        Unlink(shard, link, resource);
+    }
+
+    // Shard lock must be held by caller, returns false if resource is not tracked
+    static bool DetachAllLocked(Shard& shard, Resource* resource)
+    {
+        auto it = shard.heads.find(resource);
+
+        if (it == shard.heads.end())
+            return false;
+
+        auto link = it->second;
+        while (link != nullptr)
+        {
+            auto next = link->next;
+
+            if (link->info->buffer == resource)
+            {
+                link->info->buffer = nullptr;
+                link->info->lastUsedFrame = 0;
+            }
+
+            link->prev = nullptr;
+            link->next = nullptr;
+            link->owner.store(nullptr, std::memory_order_release);
+
+            link = next;
+        }
+
+        shard.heads.erase(it);
+        return true;
+    }
+};
+
+} // namespace resource_links
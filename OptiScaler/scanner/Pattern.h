@@ -0,0 +1,370 @@
+#pragma once
+
+#include <span>
+#include <array>
+#include <vector>
+#include <cstdint>
+#include <cstring>
+#include <string_view>
+
+#include <emmintrin.h>
+#include <immintrin.h>
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#define SCANNER_TARGET_AVX2
+#else
+#define SCANNER_TARGET_AVX2 __attribute__((target("avx2")))
+#endif
+
+namespace scanner
+{
+
+// 64 bit FNV-1a, stable across runs and platforms
+inline uint64_t Fnv1a(const void* data, size_t size, uint64_t seed = 0xCBF29CE484222325ull)
+{
+    auto bytes = static_cast<const uint8_t*>(data);
+    auto hash = seed;
+
+    for (size_t i = 0; i < size; i++)
+    {
+        hash ^= bytes[i];
+        hash *= 0x100000001B3ull;
+    }
+
+    return hash;
+}
+
+// Rough byte frequencies of x64 code, higher is more common.
+// Used to select the rarest bytes of a pattern as SIMD anchors.
+inline constexpr std::array<uint8_t, 256> ByteFrequency = []()
+{
+    std::array<uint8_t, 256> table {};
+
+    for (auto& v : table)
+        v = 16;
+
+    constexpr uint8_t veryCommon[] = { 0x00, 0xFF, 0x48, 0x8B, 0x89, 0xCC, 0x24, 0xE8, 0x4C, 0x8D, 0x0F, 0x44 };
+    constexpr uint8_t common[] = { 0x41, 0x85, 0xC0, 0x74, 0x75, 0x83, 0x33, 0xC3, 0x90, 0x01, 0x08, 0x10,
+                                   0x20, 0x40, 0x45, 0x49, 0x4D, 0x5C, 0x28, 0x30, 0x38, 0x18, 0xEB, 0x84,
+                                   0xC4, 0xC7, 0xF8, 0x50, 0x54, 0x55, 0x56, 0x57, 0x8E, 0x80, 0x02, 0x04 };
+
+    for (auto b : common)
+        table[b] = 128;
+
+    for (auto b : veryCommon)
+        table[b] = 255;
+
+    return table;
+}();
+
+// Signature parsed once from "48 8B ? ? 89" style string.
+// Both "?" and "??" are accepted as wildcards.
+class Pattern
+{
+  private:
+    std::vector<uint8_t> _bytes;
+    std::vector<uint8_t> _wildcard;
+    size_t _anchor = 0;
+    size_t _secondAnchor = 0;
+    uint64_t _hash = 0;
+    bool _valid = false;
+
+    static int HexValue(char c)
+    {
+        if (c >= '0' && c <= '9')
+            return c - '0';
+
+        if (c >= 'a' && c <= 'f')
+            return c - 'a' + 10;
+
+        if (c >= 'A' && c <= 'F')
+            return c - 'A' + 10;
+
+        return -1;
+    }
+
+  public:
+    Pattern() = default;
+
+    explicit Pattern(std::string_view mask)
+    {
+        size_t i = 0;
+
+        while (i < mask.size())
+        {
+            if (mask[i] == ' ')
+            {
+                i++;
+                continue;
+            }
+
+            if (mask[i] == '?')
+            {
+                _bytes.push_back(0);
+                _wildcard.push_back(1);
+
+                i++;
+                if (i < mask.size() && mask[i] == '?')
+                    i++;
+
+                continue;
+            }
+
+            auto hi = HexValue(mask[i]);
+            auto lo = (i + 1 < mask.size()) ? HexValue(mask[i + 1]) : -1;
+
+            if (hi < 0 || lo < 0)
+            {
+                _bytes.clear();
+                _wildcard.clear();
+                return;
+            }
+
+            _bytes.push_back((uint8_t) ((hi << 4) | lo));
+            _wildcard.push_back(0);
+            i += 2;
+        }
+
+        // Pick two rarest fixed bytes as anchors
+        bool found = false;
+        for (size_t j = 0; j < _bytes.size(); j++)
+        {
+            if (_wildcard[j])
+                continue;
+
+            if (!found || ByteFrequency[_bytes[j]] < ByteFrequency[_bytes[_anchor]])
+                _anchor = j;
+
+            found = true;
+        }
+
+        if (!found)
+            return;
+
+        _secondAnchor = _anchor;
+        for (size_t j = 0; j < _bytes.size(); j++)
+        {
+            if (_wildcard[j] || j == _anchor)
+                continue;
+
+            if (_secondAnchor == _anchor || ByteFrequency[_bytes[j]] < ByteFrequency[_bytes[_secondAnchor]])
+                _secondAnchor = j;
+        }
+
+        _hash = Fnv1a(_bytes.data(), _bytes.size());
+        _hash = Fnv1a(_wildcard.data(), _wildcard.size(), _hash);
+        _valid = true;
+    }
+
+    bool IsValid() const { return _valid; }
+    uint64_t Hash() const { return _hash; }
+    size_t Size() const { return _bytes.size(); }
+    size_t Anchor() const { return _anchor; }
+    size_t SecondAnchor() const { return _secondAnchor; }
+    uint8_t AnchorByte() const { return _bytes[_anchor]; }
+    uint8_t SecondAnchorByte() const { return _bytes[_secondAnchor]; }
+
+    bool MatchAt(const uint8_t* data) const
+    {
+        for (size_t i = 0; i < _bytes.size(); i++)
+        {
+            if (!_wildcard[i] && data[i] != _bytes[i])
+                return false;
+        }
+
+        return true;
+    }
+};
+
+namespace detail
+{
+inline int TrailingZeros(uint32_t value)
+{
+#ifdef _MSC_VER
+    unsigned long index;
+    _BitScanForward(&index, value);
+    return (int) index;
+#else
+    return __builtin_ctz(value);
+#endif
+}
+
+// Returns offset of first match in [0, count) or SIZE_MAX
+inline size_t FindScalar(const uint8_t* data, size_t count, const Pattern& pattern)
+{
+    for (size_t i = 0; i < count; i++)
+    {
+        if (data[i + pattern.Anchor()] == pattern.AnchorByte() && pattern.MatchAt(data + i))
+            return i;
+    }
+
+    return SIZE_MAX;
+}
+
+inline size_t FindSSE2(const uint8_t* data, size_t count, const Pattern& pattern)
+{
+    const auto first = _mm_set1_epi8((char) pattern.AnchorByte());
+    const auto second = _mm_set1_epi8((char) pattern.SecondAnchorByte());
+    const auto firstPtr = data + pattern.Anchor();
+    const auto secondPtr = data + pattern.SecondAnchor();
+
+    size_t i = 0;
+    for (; i + 16 <= count; i += 16)
+    {
+        auto a = _mm_cmpeq_epi8(first, _mm_loadu_si128((const __m128i*) (firstPtr + i)));
+        auto b = _mm_cmpeq_epi8(second, _mm_loadu_si128((const __m128i*) (secondPtr + i)));
+        auto mask = (uint32_t) _mm_movemask_epi8(_mm_and_si128(a, b));
+
+        while (mask != 0)
+        {
+            auto bit = TrailingZeros(mask);
+
+            if (pattern.MatchAt(data + i + bit))
+                return i + bit;
+
+            mask &= mask - 1;
+        }
+    }
+
+    auto tail = FindScalar(data + i, count - i, pattern);
+    return tail == SIZE_MAX ? SIZE_MAX : i + tail;
+}
+
+SCANNER_TARGET_AVX2 inline size_t FindAVX2(const uint8_t* data, size_t count, const Pattern& pattern)
+{
+    const auto first = _mm256_set1_epi8((char) pattern.AnchorByte());
+    const auto second = _mm256_set1_epi8((char) pattern.SecondAnchorByte());
+    const auto firstPtr = data + pattern.Anchor();
+    const auto secondPtr = data + pattern.SecondAnchor();
+
+    size_t i = 0;
+    for (; i + 32 <= count; i += 32)
+    {
+        auto a = _mm256_cmpeq_epi8(first, _mm256_loadu_si256((const __m256i*) (firstPtr + i)));
+        auto b = _mm256_cmpeq_epi8(second, _mm256_loadu_si256((const __m256i*) (secondPtr + i)));
+        auto mask = (uint32_t) _mm256_movemask_epi8(_mm256_and_si256(a, b));
+
+        while (mask != 0)
+        {
+            auto bit = TrailingZeros(mask);
+
+            if (pattern.MatchAt(data + i + bit))
+                return i + bit;
+
+            mask &= mask - 1;
+        }
+    }
+
+    auto tail = FindSSE2(data + i, count - i, pattern);
+    return tail == SIZE_MAX ? SIZE_MAX : i + tail;
+}
+
+inline bool HasAVX2()
+{
+    static const bool result = []()
+    {
+#ifdef _MSC_VER
+        int info[4] {};
+        __cpuid(info, 0);
+
+        if (info[0] < 7)
+            return false;
+
+        __cpuid(info, 1);
+
+        // OSXSAVE + AVX
+        if ((info[2] & (1 << 27)) == 0 || (info[2] & (1 << 28)) == 0)
+            return false;
+
+        // OS saves YMM state
+        if ((_xgetbv(0) & 0x6) != 0x6)
+            return false;
+
+        __cpuidex(info, 7, 0);
+        return (info[1] & (1 << 5)) != 0;
+#else
+        return __builtin_cpu_supports("avx2") != 0;
+#endif
+    }();
+
+    return result;
+}
+} // namespace detail
+
+// Finds first match of pattern which fits completely inside data
+inline const uint8_t* FindPattern(std::span<const uint8_t> data, const Pattern& pattern)
+{
+    if (!pattern.IsValid() || data.size() < pattern.Size())
+        return nullptr;
+
+    // Number of possible start positions
+    // Anchors are inside the pattern so SIMD loads never pass the end of data
+    auto count = data.size() - pattern.Size() + 1;
+
+    size_t result;
+    if (detail::HasAVX2())
+        result = detail::FindAVX2(data.data(), count, pattern);
+    else
+        result = detail::FindSSE2(data.data(), count, pattern);
+
+    return result == SIZE_MAX ? nullptr : data.data() + result;
+}
+
+// Single pass search for multiple patterns.
+// results[i] receives the first match of patterns[i] or nullptr.
+// Returns number of patterns found.
+inline size_t FindPatterns(std::span<const uint8_t> data, std::span<const Pattern* const> patterns,
+                           std::span<const uint8_t*> results)
+{
+    size_t remaining = 0;
+
+    for (size_t p = 0; p < patterns.size(); p++)
+    {
+        if (results[p] == nullptr && patterns[p] != nullptr && patterns[p]->IsValid() &&
+            patterns[p]->Size() <= data.size())
+        {
+            remaining++;
+        }
+    }
+
+    if (remaining == 0)
+        return 0;
+
+    size_t found = 0;
+
+    // Walk the data in cache sized blocks, every pending pattern is checked against
+    // the block while it is hot, so the section is read from memory only once.
+    constexpr size_t BlockSize = 16 * 1024;
+    for (size_t blockStart = 0; blockStart < data.size() && remaining > 0; blockStart += BlockSize)
+    {
+        for (size_t p = 0; p < patterns.size(); p++)
+        {
+            auto pattern = patterns[p];
+
+            if (results[p] != nullptr || pattern == nullptr || !pattern->IsValid() || pattern->Size() > data.size())
+                continue;
+
+            auto count = data.size() - pattern->Size() + 1;
+
+            if (blockStart >= count)
+                continue;
+
+            auto blockCount = (count - blockStart) < BlockSize ? (count - blockStart) : BlockSize;
+
+            // Extend the span by pattern size so matches crossing the block border are seen
+            auto match = FindPattern(data.subspan(blockStart, blockCount + pattern->Size() - 1), *pattern);
+
+            if (match != nullptr)
+            {
+                results[p] = match;
+                remaining--;
+                found++;
+            }
+        }
+    }
+
+    return found;
+}
+
+} // namespace scanner
@@ -0,0 +1,275 @@
+#pragma once
+
+#include "Pattern.h"
+
+#include <span>
+#include <vector>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <filesystem>
+#include <unordered_map>
+
+namespace scanner
+{
+
+// Identifies a module binary without hashing the whole file
+struct ModuleKey
+{
+    uint64_t fileSize = 0;
+    uint64_t timestamp = 0;
+    uint64_t headerHash = 0; // hash of PE section headers
+
+    bool operator==(const ModuleKey&) const = default;
+};
+
+// Persistent (module, pattern) -> RVA cache.
+// Entries are only hints, callers must verify the pattern at the returned RVA before use.
+// Patterns which are not in the module are stored as NotFound for the current run only, they are not saved.
+// A packed exe can be scanned before it unpacks itself, a saved miss would hide the pattern until the exe changes.
+class ScanCache
+{
+  public:
+    static constexpr uint64_t NotFound = UINT64_MAX;
+    static constexpr size_t MaxEntries = 1024;
+
+  private:
+    static constexpr uint32_t Magic = 0x4353534F; // "OSSC"
+    static constexpr uint32_t Version = 1;
+
+#pragma pack(push, 1)
+    struct FileHeader
+    {
+        uint32_t magic;
+        uint32_t version;
+        uint32_t count;
+        uint32_t reserved;
+    };
+
+    struct FileEntry
+    {
+        uint64_t fileSize;
+        uint64_t timestamp;
+        uint64_t headerHash;
+        uint64_t patternHash;
+        uint64_t rva;
+        uint64_t useOrder;
+    };
+#pragma pack(pop)
+
+    struct Key
+    {
+        ModuleKey module;
+        uint64_t patternHash = 0;
+
+        bool operator==(const Key&) const = default;
+    };
+
+    struct KeyHash
+    {
+        size_t operator()(const Key& key) const { return (size_t) Fnv1a(&key, sizeof(Key)); }
+    };
+
+    struct Value
+    {
+        uint64_t rva = 0;
+        uint64_t useOrder = 0;
+    };
+
+    std::unordered_map<Key, Value, KeyHash> _entries;
+    uint64_t _useCounter = 0;
+    bool _dirty = false;
+
+    void Evict()
+    {
+        while (_entries.size() > MaxEntries)
+        {
+            auto oldest = _entries.begin();
+
+            for (auto it = _entries.begin(); it != _entries.end(); it++)
+            {
+                if (it->second.useOrder < oldest->second.useOrder)
+                    oldest = it;
+            }
+
+            _entries.erase(oldest);
+        }
+    }
+
+  public:
+    bool Lookup(const ModuleKey& module, uint64_t patternHash, uint64_t& rva)
+    {
+        auto it = _entries.find(Key { module, patternHash });
+
+        if (it == _entries.end())
+            return false;
+
+        it->second.useOrder = ++_useCounter;
+        rva = it->second.rva;
+
+        // Use order is saved for eviction after a restart
+        if (rva != NotFound)
+            _dirty = true;
+
+        return true;
+    }
+
+    void Store(const ModuleKey& module, uint64_t patternHash, uint64_t rva)
+    {
+        auto [it, added] = _entries.try_emplace(Key { module, patternHash });
+        auto& value = it->second;
+
+        // Misses aren't saved, only found entries change the file
+        if (value.rva != rva && (rva != NotFound || (!added && value.rva != NotFound)))
+            _dirty = true;
+
+        value.rva = rva;
+        value.useOrder = ++_useCounter;
+
+        Evict();
+    }
+
+    // Used when a cached entry failed verification
+    void Remove(const ModuleKey& module, uint64_t patternHash)
+    {
+        auto it = _entries.find(Key { module, patternHash });
+
+        if (it == _entries.end())
+            return;
+
+        if (it->second.rva != NotFound)
+            _dirty = true;
+
+        _entries.erase(it);
+    }
+
+    bool IsDirty() const { return _dirty; }
+    size_t Size() const { return _entries.size(); }
+
+    std::vector<uint8_t> Serialize() const
+    {
+        size_t count = 0;
+
+        for (auto& [key, value] : _entries)
+        {
+            if (value.rva != NotFound)
+                count++;
+        }
+
+        std::vector<uint8_t> data(sizeof(FileHeader) + count * sizeof(FileEntry) + sizeof(uint64_t));
+
+        FileHeader header { Magic, Version, (uint32_t) count, 0 };
+        memcpy(data.data(), &header, sizeof(header));
+
+        auto offset = sizeof(FileHeader);
+        for (auto& [key, value] : _entries)
+        {
+            if (value.rva == NotFound)
+                continue;
+
+            FileEntry entry { key.module.fileSize, key.module.timestamp, key.module.headerHash,
+                              key.patternHash,     value.rva,            value.useOrder };
+            memcpy(data.data() + offset, &entry, sizeof(entry));
+            offset += sizeof(entry);
+        }
+
+        auto checksum = Fnv1a(data.data(), offset);
+        memcpy(data.data() + offset, &checksum, sizeof(checksum));
+
+        return data;
+    }
+
+    // Replaces current entries, returns false (and leaves cache empty) for invalid data
+    bool Deserialize(std::span<const uint8_t> data)
+    {
+        _entries.clear();
+        _useCounter = 0;
+        _dirty = false;
+
+        if (data.size() < sizeof(FileHeader) + sizeof(uint64_t))
+            return false;
+
+        FileHeader header;
+        memcpy(&header, data.data(), sizeof(header));
+
+        if (header.magic != Magic || header.version != Version || header.count > MaxEntries)
+            return false;
+
+        auto bodySize = sizeof(FileHeader) + (size_t) header.count * sizeof(FileEntry);
+
+        if (data.size() != bodySize + sizeof(uint64_t))
+            return false;
+
+        uint64_t checksum;
+        memcpy(&checksum, data.data() + bodySize, sizeof(checksum));
+
+        if (checksum != Fnv1a(data.data(), bodySize))
+            return false;
+
+        for (uint32_t i = 0; i < header.count; i++)
+        {
+            FileEntry entry;
+            memcpy(&entry, data.data() + sizeof(FileHeader) + i * sizeof(FileEntry), sizeof(entry));
+
+            Key key { { entry.fileSize, entry.timestamp, entry.headerHash }, entry.patternHash };
+            _entries[key] = Value { entry.rva, entry.useOrder };
+
+            if (entry.useOrder > _useCounter)
+                _useCounter = entry.useOrder;
+        }
+
+        return true;
+    }
+
+    bool Load(const std::filesystem::path& path)
+    {
+        std::error_code ec;
+        auto size = std::filesystem::file_size(path, ec);
+
+        if (ec || size == 0 || size > 16 * 1024 * 1024)
+        {
+            Deserialize({});
+            return false;
+        }
+
+        std::vector<uint8_t> data(size);
+        std::ifstream file(path, std::ios::binary);
+
+        if (!file.read(reinterpret_cast<char*>(data.data()), data.size()))
+        {
+            Deserialize({});
+            return false;
+        }
+
+        return Deserialize(data);
+    }
+
+    // Writes to a temp file and renames so a crash never leaves a half written cache
+    bool Save(const std::filesystem::path& path)
+    {
+        auto data = Serialize();
+        auto tempPath = path;
+        tempPath += ".tmp";
+
+        {
+            std::ofstream file(tempPath, std::ios::binary | std::ios::trunc);
+
+            if (!file.write(reinterpret_cast<const char*>(data.data()), data.size()))
+                return false;
+        }
+
+        std::error_code ec;
+        std::filesystem::rename(tempPath, path, ec);
+
+        if (ec)
+        {
+            std::filesystem::remove(tempPath, ec);
+            return false;
+        }
+
+        _dirty = false;
+        return true;
+    }
+};
+
+} // namespace scanner
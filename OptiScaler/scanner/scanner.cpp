@@ -1,5 +1,7 @@
 #include "pch.h"
 #include "scanner.h"
+#include "ScanCache.h"
+#include <Util.h>
 #include <proxies/KernelBase_Proxy.h>
 
 struct SectionRange
@@ -7,7 +9,7 @@ struct SectionRange
     BYTE *start, *end;
 };
 
-std::vector<SectionRange> GetExecSections(HMODULE hMod)
+static std::vector<SectionRange> GetExecSections(HMODULE hMod)
 {
     std::vector<SectionRange> secs;
 
@@ -35,84 +37,182 @@ std::vector<SectionRange> GetExecSections(HMODULE hMod)
     return secs;
 }
 
-uintptr_t FindPattern(uintptr_t startAddress, uintptr_t maxSize, const char* mask)
+#pragma region Scan cache
+
+static std::mutex _cacheMutex;
+static scanner::ScanCache _cache;
+static bool _cacheLoaded = false;
+
+static std::filesystem::path CachePath() { return Util::DllPath().parent_path() / "OptiScaler.scancache"; }
+
+// Cache mutex must be held
+static void LoadCache()
+{
+    if (_cacheLoaded)
+        return;
+
+    _cacheLoaded = true;
+
+    if (_cache.Load(CachePath()))
+        LOG_DEBUG("Loaded {} scan cache entries", _cache.Size());
+}
+
+// Cache mutex must be held. Writes the whole file, so it's only done by FlushCache after a group of scans
+static void SaveCache()
+{
+    if (!_cache.IsDirty())
+        return;
+
+    if (!_cache.Save(CachePath()))
+        LOG_DEBUG("Can't save scan cache");
+}
+
+static bool GetModuleKey(HMODULE module, scanner::ModuleKey& key)
+{
+    wchar_t modulePath[MAX_PATH] {};
+    auto length = GetModuleFileNameW(module, modulePath, MAX_PATH);
+
+    if (length == 0 || length == MAX_PATH)
+        return false;
+
+    std::error_code ec;
+    key.fileSize = std::filesystem::file_size(modulePath, ec);
+
+    if (ec)
+        return false;
+
+    key.timestamp = std::filesystem::last_write_time(modulePath, ec).time_since_epoch().count();
+
+    if (ec)
+        return false;
+
+    BYTE* base = reinterpret_cast<BYTE*>(module);
+    auto dos = reinterpret_cast<IMAGE_DOS_HEADER*>(base);
+    auto nt = reinterpret_cast<IMAGE_NT_HEADERS64*>(base + dos->e_lfanew);
+
+    auto sectionsSize = sizeof(IMAGE_SECTION_HEADER) * nt->FileHeader.NumberOfSections;
+    key.headerHash = scanner::Fnv1a(&nt->FileHeader, sizeof(nt->FileHeader));
+    key.headerHash = scanner::Fnv1a(IMAGE_FIRST_SECTION(nt), sectionsSize, key.headerHash);
+
+    return true;
+}
+
+#pragma endregion
+
+static uintptr_t FindPattern(uintptr_t startAddress, uintptr_t maxSize, const scanner::Pattern& pattern)
+{
+    auto data = std::span<const uint8_t>(reinterpret_cast<const uint8_t*>(startAddress), maxSize);
+    auto sig = scanner::FindPattern(data, pattern);
+
+    if (sig == nullptr)
+        return NULL;
+
+    return reinterpret_cast<uintptr_t>(sig);
+}
+
+static uintptr_t ScanSections(HMODULE module, const scanner::Pattern& pattern, uintptr_t startAddress)
 {
-    std::vector<std::pair<uint8_t, bool>> pattern;
+    uintptr_t address = NULL;
+    auto sections = GetExecSections(module);
 
-    for (size_t i = 0; i < strlen(mask);)
+    for (size_t i = 0; i < sections.size(); i++)
     {
-        if (mask[i] != '?')
+        auto section = &sections[i];
+
+        if (startAddress != 0 && (uintptr_t) section->start < startAddress && (uintptr_t) section->end > startAddress)
         {
-            pattern.emplace_back(static_cast<uint8_t>(strtoul(&mask[i], nullptr, 16)), false);
-            i += 3;
+            address = FindPattern(startAddress, (uintptr_t) section->end - startAddress, pattern);
         }
-        else
+        else if (startAddress == 0 || (uintptr_t) section->start > startAddress)
         {
-            pattern.emplace_back(0x00, true);
-            i += 2;
+            address = FindPattern((uintptr_t) section->start, (uintptr_t) section->end - (uintptr_t) section->start,
+                                  pattern);
         }
-    }
 
-    const auto dataStart = reinterpret_cast<const uint8_t*>(startAddress);
-    const auto dataEnd = dataStart + maxSize + 1;
-
-    auto sig = std::search(dataStart, dataEnd, pattern.begin(), pattern.end(),
-                           [](uint8_t currentByte, std::pair<uint8_t, bool> Pattern)
-                           { return Pattern.second || (currentByte == Pattern.first); });
-
-    if (sig == dataEnd)
-        return NULL;
+        if (address != NULL)
+            break;
+    }
 
-    return std::distance(dataStart, sig) + startAddress;
+    return address;
 }
 
 uintptr_t scanner::GetAddress(const std::wstring_view moduleName, const std::string_view pattern, ptrdiff_t offset,
                               uintptr_t startAddress)
 {
-    uintptr_t address = NULL;
     auto module = GetModuleHandle(moduleName.data());
 
     if (module == nullptr)
         return NULL;
 
+    return GetAddress(module, Pattern(pattern), offset, startAddress);
+}
+
+uintptr_t scanner::GetAddress(HMODULE module, const std::string_view pattern, ptrdiff_t offset, uintptr_t startAddress)
+{
+    return GetAddress(module, Pattern(pattern), offset, startAddress);
+}
+
+// Checks cached address against the pattern, address must be inside an executable section
+static bool VerifyAddress(HMODULE module, const scanner::Pattern& pattern, uintptr_t address)
+{
     auto sections = GetExecSections(module);
 
-    if (startAddress != 0)
+    for (size_t i = 0; i < sections.size(); i++)
     {
-        for (size_t i = 0; i < sections.size(); i++)
-        {
-            auto section = &sections[i];
-
-            if (((uintptr_t) section->start < startAddress && (uintptr_t) section->end > startAddress))
-            {
-                address = FindPattern(startAddress, (uintptr_t) section->end - startAddress, pattern.data());
-
-                if (address != NULL)
-                    break;
-            }
-            else if ((uintptr_t) section->start > startAddress)
-            {
-                address = FindPattern((uintptr_t) section->start, (uintptr_t) section->end - (uintptr_t) section->start,
-                                      pattern.data());
-
-                if (address != NULL)
-                    break;
-            }
-        }
+        auto start = (uintptr_t) sections[i].start;
+        auto end = (uintptr_t) sections[i].end;
+
+        if (address >= start && address + pattern.Size() <= end)
+            return pattern.MatchAt(reinterpret_cast<const uint8_t*>(address));
     }
-    else
+
+    return false;
+}
+
+// Only used for full module scans, startAddress scans depend on the caller's state
+static uintptr_t ScanWithCache(HMODULE module, const scanner::Pattern& pattern)
+{
+    std::scoped_lock lock(_cacheMutex);
+
+    LoadCache();
+
+    scanner::ModuleKey key;
+    if (!GetModuleKey(module, key))
+        return ScanSections(module, pattern, 0);
+
+    auto base = (uintptr_t) module;
+    uint64_t rva = 0;
+
+    if (_cache.Lookup(key, pattern.Hash(), rva))
     {
-        for (size_t i = 0; i < sections.size(); i++)
-        {
-            auto section = &sections[i];
-            address = FindPattern((uintptr_t) section->start, (uintptr_t) section->end - (uintptr_t) section->start,
-                                  pattern.data());
+        if (rva == scanner::ScanCache::NotFound)
+            return NULL;
 
-            if (address != NULL)
-                break;
-        }
+        if (VerifyAddress(module, pattern, base + rva))
+            return base + rva;
+
+        LOG_DEBUG("Stale scan cache entry, rva: {:X}", rva);
+        _cache.Remove(key, pattern.Hash());
     }
 
+    auto address = ScanSections(module, pattern, 0);
+    _cache.Store(key, pattern.Hash(), address != NULL ? address - base : scanner::ScanCache::NotFound);
+
+    return address;
+}
+
+uintptr_t scanner::GetAddress(HMODULE module, const Pattern& pattern, ptrdiff_t offset, uintptr_t startAddress)
+{
+    if (module == nullptr)
+        return NULL;
+
+    uintptr_t address = NULL;
+
+    if (startAddress == 0)
+        address = ScanWithCache(module, pattern);
+    else
+        address = ScanSections(module, pattern, startAddress);
+
     if (address != NULL)
     {
         return (address + offset);
@@ -123,58 +223,83 @@ uintptr_t scanner::GetAddress(const std::wstring_view moduleName, const std::str
     }
 }
 
-uintptr_t scanner::GetAddress(HMODULE module, const std::string_view pattern, ptrdiff_t offset, uintptr_t startAddress)
+size_t scanner::GetAddresses(HMODULE module, std::span<const Pattern* const> patterns, std::span<uintptr_t> addresses)
 {
-    if (module == nullptr)
-        return NULL;
+    for (size_t i = 0; i < addresses.size(); i++)
+        addresses[i] = NULL;
 
-    uintptr_t address = NULL;
-    auto sections = GetExecSections(module);
+    if (module == nullptr || patterns.size() > addresses.size())
+        return 0;
+
+    std::scoped_lock lock(_cacheMutex);
 
-    if (startAddress != 0)
+    LoadCache();
+
+    ModuleKey key;
+    auto hasKey = GetModuleKey(module, key);
+    auto base = (uintptr_t) module;
+
+    std::vector<const uint8_t*> results(patterns.size(), nullptr);
+    size_t found = 0;
+
+    // Resolve what we can from cache, only scan for the rest
+    std::vector<const Pattern*> pending(patterns.begin(), patterns.end());
+
+    for (size_t i = 0; i < patterns.size() && hasKey; i++)
     {
-        for (size_t i = 0; i < sections.size(); i++)
+        uint64_t rva = 0;
+
+        if (patterns[i] == nullptr || !_cache.Lookup(key, patterns[i]->Hash(), rva))
+            continue;
+
+        if (rva == ScanCache::NotFound)
         {
-            auto section = &sections[i];
-
-            if (((uintptr_t) section->start < startAddress && (uintptr_t) section->end > startAddress))
-            {
-                address = FindPattern(startAddress, (uintptr_t) section->end - startAddress, pattern.data());
-
-                if (address != NULL)
-                    break;
-            }
-            else if ((uintptr_t) section->start > startAddress)
-            {
-                address = FindPattern((uintptr_t) section->start, (uintptr_t) section->end - (uintptr_t) section->start,
-                                      pattern.data());
-
-                if (address != NULL)
-                    break;
-            }
+            pending[i] = nullptr;
+            continue;
         }
-    }
-    else
-    {
-        for (size_t i = 0; i < sections.size(); i++)
-        {
-            auto section = &sections[i];
-            address = FindPattern((uintptr_t) section->start, (uintptr_t) section->end - (uintptr_t) section->start,
-                                  pattern.data());
 
-            if (address != NULL)
-                break;
+        if (VerifyAddress(module, *patterns[i], base + rva))
+        {
+            results[i] = reinterpret_cast<const uint8_t*>(base + rva);
+            pending[i] = nullptr;
+            found++;
+        }
+        else
+        {
+            _cache.Remove(key, patterns[i]->Hash());
         }
     }
 
-    if (address != NULL)
+    // Cached misses are not scanned again
+    auto scanning = (size_t) std::count_if(pending.begin(), pending.end(), [](const Pattern* p) { return p; });
+    auto scanTarget = found + scanning;
+
+    if (scanning > 0)
     {
-        return (address + offset);
+        auto sections = GetExecSections(module);
+
+        for (size_t i = 0; i < sections.size() && found < scanTarget; i++)
+        {
+            auto data = std::span<const uint8_t>(sections[i].start, sections[i].end);
+            found += FindPatterns(data, pending, results);
+        }
     }
-    else
+
+    for (size_t i = 0; i < patterns.size(); i++)
     {
-        return NULL;
+        addresses[i] = reinterpret_cast<uintptr_t>(results[i]);
+
+        if (hasKey && pending[i] != nullptr)
+            _cache.Store(key, pending[i]->Hash(), results[i] != nullptr ? addresses[i] - base : ScanCache::NotFound);
     }
+
+    return found;
+}
+
+void scanner::FlushCache()
+{
+    std::scoped_lock lock(_cacheMutex);
+    SaveCache();
 }
 
 uintptr_t scanner::GetOffsetFromInstruction(const std::wstring_view moduleName, const std::string_view pattern,
@@ -185,19 +310,7 @@ uintptr_t scanner::GetOffsetFromInstruction(const std::wstring_view moduleName,
     if (module == nullptr)
         return NULL;
 
-    uintptr_t address = NULL;
-
-    auto sections = GetExecSections(module);
-
-    for (size_t i = 0; i < sections.size(); i++)
-    {
-        auto section = &sections[i];
-        address = FindPattern((uintptr_t) section->start, (uintptr_t) section->end - (uintptr_t) section->start,
-                              pattern.data());
-
-        if (address != NULL)
-            break;
-    }
+    auto address = ScanWithCache(module, Pattern(pattern));
 
     if (address != NULL)
     {
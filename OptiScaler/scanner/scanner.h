@@ -1,13 +1,23 @@
 #pragma once
 
 #include "SysUtils.h"
+#include "Pattern.h"
 
 namespace scanner
 {
 uintptr_t GetAddress(const std::wstring_view moduleName, const std::string_view pattern, ptrdiff_t offset = 0,
                      uintptr_t startAddress = 0);
 uintptr_t GetAddress(HMODULE module, const std::string_view pattern, ptrdiff_t offset = 0, uintptr_t startAddress = 0);
+uintptr_t GetAddress(HMODULE module, const Pattern& pattern, ptrdiff_t offset = 0, uintptr_t startAddress = 0);
 uintptr_t GetOffsetFromInstruction(const std::wstring_view moduleName, const std::string_view pattern,
                                    ptrdiff_t offset = 0);
 
+// Searches all patterns in a single pass over each executable section.
+// addresses[i] receives the first match of patterns[i] or NULL, returns number of patterns found.
+size_t GetAddresses(HMODULE module, std::span<const Pattern* const> patterns, std::span<uintptr_t> addresses);
+
+// Scans only update the cache in memory, this writes it when it changed.
+// Call after a group of scans and at exit
+void FlushCache();
+
 } // namespace scanner
@@ -0,0 +1,393 @@
+#pragma once
+
+#include <misc/TreeHash.h>
+
+#include <span>
+#include <deque>
+#include <mutex>
+#include <atomic>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+#include <cstdint>
+#include <functional>
+#include <unordered_map>
+#include <condition_variable>
+
+// Root signatures and pipelines of OptiScaler's own passes, owned for the lifetime of the device.
+// Root signatures are keyed by their serialized blob so identical ones are created once. Pipelines are keyed by
+// everything which changes the result, variants the config can reach are queued after device creation and built
+// on a worker thread. Handles are published with an atomic store, a pass created later takes the ready pipeline
+// or builds it on its own thread when the worker didn't start it yet.
+// Handles are kept as integers and the device is behind Backend, so the core has no platform dependencies.
+namespace pipeline_manager
+{
+
+class Backend
+{
+  public:
+    virtual ~Backend() = default;
+
+    // 0 on failure
+    virtual uint64_t CreateSignature(std::span<const uint8_t> blob) = 0;
+
+    // Used for both signatures and pipelines
+    virtual void Release(uint64_t handle) = 0;
+};
+
+// Builds the pipeline with the given root signature, 0 on failure.
+// Runs on the worker or on the thread calling Acquire.
+using CreateFunc = std::function<uint64_t(uint64_t signature)>;
+
+enum class Status : uint32_t
+{
+    Queued,
+    Building,
+    Ready,
+    Failed,
+};
+
+struct Stats
+{
+    uint32_t Signatures = 0;
+    uint32_t SignatureHits = 0;
+    uint32_t Pipelines = 0;
+
+    // Acquire calls which found the pipeline ready
+    uint32_t PipelineHits = 0;
+
+    // Built by the worker, on the calling thread and Acquire calls which waited for the worker
+    uint32_t Prewarmed = 0;
+    uint32_t BuiltInline = 0;
+    uint32_t Waited = 0;
+
+    uint32_t Failed = 0;
+};
+
+inline uint64_t SignatureKey(std::span<const uint8_t> blob) { return tree_hash::XXH64(blob.data(), blob.size()); }
+
+class Manager
+{
+  private:
+    struct Signature
+    {
+        std::vector<uint8_t> Blob;
+        Status State = Status::Queued;
+        uint64_t Handle = 0;
+    };
+
+    struct Pipeline
+    {
+        std::string Name;
+        uint64_t SignatureKey = 0;
+        CreateFunc Create;
+        std::atomic<Status> State { Status::Queued };
+        std::atomic<uint64_t> Handle { 0 };
+    };
+
+    std::unique_ptr<Backend> _backend;
+
+    // Guards everything below, State of the entries only changes under it
+    std::mutex _mutex;
+    std::condition_variable _changed;
+
+    std::unordered_map<uint64_t, std::unique_ptr<Signature>> _signatures;
+    std::unordered_map<uint64_t, std::unique_ptr<Pipeline>> _pipelines;
+
+    // Keys waiting for the worker
+    std::deque<uint64_t> _queue;
+    std::thread _worker;
+    bool _workerBusy = false;
+    bool _stop = false;
+
+    Stats _stats;
+
+    Pipeline* FindPipeline(uint64_t key)
+    {
+        auto it = _pipelines.find(key);
+        return it == _pipelines.end() ? nullptr : it->second.get();
+    }
+
+    Pipeline* AddPipeline(uint64_t key, uint64_t signatureKey, CreateFunc create, std::string name, bool& added)
+    {
+        auto pipeline = FindPipeline(key);
+        added = pipeline == nullptr;
+
+        if (added)
+        {
+            auto entry = std::make_unique<Pipeline>();
+            entry->Name = std::move(name);
+            entry->SignatureKey = signatureKey;
+            entry->Create = std::move(create);
+
+            pipeline = entry.get();
+            _pipelines.emplace(key, std::move(entry));
+        }
+
+        return pipeline;
+    }
+
+    // Creates the root signature on first use, other threads wait for it
+    uint64_t ResolveSignature(uint64_t key)
+    {
+        std::unique_lock lock(_mutex);
+
+        auto it = _signatures.find(key);
+
+        if (it == _signatures.end())
+            return 0;
+
+        auto signature = it->second.get();
+        _changed.wait(lock, [signature] { return signature->State != Status::Building; });
+
+        if (signature->State != Status::Queued)
+            return signature->Handle;
+
+        signature->State = Status::Building;
+        lock.unlock();
+
+        auto handle = _backend->CreateSignature(signature->Blob);
+
+        lock.lock();
+        signature->Handle = handle;
+        signature->State = handle != 0 ? Status::Ready : Status::Failed;
+
+        if (handle != 0)
+            _stats.Signatures++;
+
+        _changed.notify_all();
+
+        return handle;
+    }
+
+    // Pipeline must be claimed (Building) by the calling thread. Dependent pipelines of a failed
+    // root signature fail without calling Create.
+    bool Build(Pipeline* pipeline)
+    {
+        auto signature = ResolveSignature(pipeline->SignatureKey);
+        uint64_t handle = signature != 0 ? pipeline->Create(signature) : 0;
+
+        std::lock_guard lock(_mutex);
+
+        pipeline->Handle.store(handle, std::memory_order_relaxed);
+        pipeline->State.store(handle != 0 ? Status::Ready : Status::Failed, std::memory_order_release);
+
+        // Not needed anymore, captured resources are freed
+        pipeline->Create = nullptr;
+
+        if (handle != 0)
+            _stats.Pipelines++;
+        else
+            _stats.Failed++;
+
+        _changed.notify_all();
+
+        return handle != 0;
+    }
+
+    void Worker()
+    {
+        std::unique_lock lock(_mutex);
+
+        while (true)
+        {
+            _changed.wait(lock, [this] { return _stop || !_queue.empty(); });
+
+            if (_stop)
+                return;
+
+            auto pipeline = FindPipeline(_queue.front());
+            _queue.pop_front();
+
+            // Claimed by Acquire in the meantime
+            if (pipeline == nullptr || pipeline->State.load(std::memory_order_relaxed) != Status::Queued)
+                continue;
+
+            pipeline->State.store(Status::Building, std::memory_order_relaxed);
+            _workerBusy = true;
+            lock.unlock();
+
+            auto built = Build(pipeline);
+
+            lock.lock();
+            _workerBusy = false;
+
+            if (built)
+                _stats.Prewarmed++;
+
+            _changed.notify_all();
+        }
+    }
+
+  public:
+    explicit Manager(std::unique_ptr<Backend> backend) : _backend(std::move(backend)) {}
+
+    Manager(const Manager&) = delete;
+    Manager& operator=(const Manager&) = delete;
+
+    ~Manager()
+    {
+        Stop();
+
+        // Pipelines first, they reference the root signatures
+        for (auto& [key, pipeline] : _pipelines)
+        {
+            if (auto handle = pipeline->Handle.load(std::memory_order_acquire); handle != 0)
+                _backend->Release(handle);
+        }
+
+        for (auto& [key, signature] : _signatures)
+        {
+            if (signature->Handle != 0)
+                _backend->Release(signature->Handle);
+        }
+    }
+
+    // Returns the key of the root signature, it's created when first needed
+    uint64_t AddSignature(std::span<const uint8_t> blob)
+    {
+        auto key = SignatureKey(blob);
+
+        std::lock_guard lock(_mutex);
+
+        if (_signatures.contains(key))
+        {
+            _stats.SignatureHits++;
+            return key;
+        }
+
+        auto signature = std::make_unique<Signature>();
+        signature->Blob.assign(blob.begin(), blob.end());
+        _signatures.emplace(key, std::move(signature));
+
+        return key;
+    }
+
+    // Handle of the root signature, created on the calling thread if needed. 0 on failure
+    uint64_t AcquireSignature(uint64_t key) { return ResolveSignature(key); }
+    uint64_t AcquireSignature(std::span<const uint8_t> blob) { return ResolveSignature(AddSignature(blob)); }
+
+    // Queues the pipeline for the worker, does nothing if the key is already known
+    void Prewarm(uint64_t key, uint64_t signatureKey, CreateFunc create, std::string name = "")
+    {
+        std::lock_guard lock(_mutex);
+
+        if (_stop)
+            return;
+
+        bool added = false;
+        AddPipeline(key, signatureKey, std::move(create), std::move(name), added);
+
+        if (!added)
+            return;
+
+        _queue.push_back(key);
+
+        if (!_worker.joinable())
+            _worker = std::thread(&Manager::Worker, this);
+
+        _changed.notify_all();
+    }
+
+    // Handle of the pipeline, 0 on failure. Built on the calling thread when the worker didn't start it yet,
+    // waits when the worker is building it. create is only used when the key is new.
+    uint64_t Acquire(uint64_t key, uint64_t signatureKey, CreateFunc create, std::string name = "")
+    {
+        std::unique_lock lock(_mutex);
+
+        bool added = false;
+        auto pipeline = AddPipeline(key, signatureKey, std::move(create), std::move(name), added);
+
+        auto state = pipeline->State.load(std::memory_order_acquire);
+
+        if (state == Status::Building)
+        {
+            _stats.Waited++;
+            _changed.wait(lock, [pipeline] { return pipeline->State.load() != Status::Building; });
+            state = pipeline->State.load(std::memory_order_acquire);
+        }
+        else if (state == Status::Ready)
+        {
+            _stats.PipelineHits++;
+        }
+
+        if (state != Status::Queued)
+            return pipeline->Handle.load(std::memory_order_relaxed);
+
+        // Worker skips it when it reaches the key
+        pipeline->State.store(Status::Building, std::memory_order_relaxed);
+        _stats.BuiltInline++;
+        lock.unlock();
+
+        Build(pipeline);
+
+        return pipeline->Handle.load(std::memory_order_relaxed);
+    }
+
+    // Handle of the pipeline if it's ready, otherwise moves it to the front of the queue and returns 0
+    uint64_t TryGet(uint64_t key)
+    {
+        std::lock_guard lock(_mutex);
+
+        auto pipeline = FindPipeline(key);
+
+        if (pipeline == nullptr)
+            return 0;
+
+        auto state = pipeline->State.load(std::memory_order_acquire);
+
+        if (state == Status::Ready)
+            return pipeline->Handle.load(std::memory_order_relaxed);
+
+        if (state == Status::Queued)
+        {
+            std::erase(_queue, key);
+            _queue.push_front(key);
+        }
+
+        return 0;
+    }
+
+    Status GetStatus(uint64_t key)
+    {
+        std::lock_guard lock(_mutex);
+
+        auto pipeline = FindPipeline(key);
+        return pipeline == nullptr ? Status::Failed : pipeline->State.load(std::memory_order_acquire);
+    }
+
+    // Waits until the worker has nothing left to build
+    void WaitIdle()
+    {
+        std::unique_lock lock(_mutex);
+        _changed.wait(lock, [this] { return _stop || (_queue.empty() && !_workerBusy); });
+    }
+
+    // Queued pipelines are left as they are, Acquire still builds them
+    void Stop()
+    {
+        {
+            std::lock_guard lock(_mutex);
+            _stop = true;
+            _changed.notify_all();
+        }
+
+        if (_worker.joinable())
+            _worker.join();
+    }
+
+    size_t PendingCount()
+    {
+        std::lock_guard lock(_mutex);
+        return _queue.size();
+    }
+
+    Stats GetStats()
+    {
+        std::lock_guard lock(_mutex);
+        return _stats;
+    }
+};
+
+} // namespace pipeline_manager
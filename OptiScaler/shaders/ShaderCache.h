@@ -0,0 +1,502 @@
+#pragma once
+
+#include <misc/TreeHash.h>
+
+#include <list>
+#include <deque>
+#include <mutex>
+#include <span>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+#include <cstdio>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <algorithm>
+#include <functional>
+#include <filesystem>
+#include <string_view>
+#include <unordered_map>
+#include <condition_variable>
+
+// Content addressed cache of compiled shader blobs.
+// Blobs are found by a hash of source, entry point, target, defines and flags. They are kept
+// in a LRU limited by size in memory and as one file per blob on disk. Concurrent requests of the
+// same shader are compiled once, others wait for the result. Compiler is passed in, so the cache
+// has no platform dependencies and can be tested with a fake compiler.
+namespace shader_cache
+{
+
+inline constexpr uint32_t Magic = 0x4853534F; // "OSSH"
+
+// Increase when the file layout changes
+inline constexpr uint32_t FormatVersion = 1;
+
+inline constexpr const char* Extension = ".cso";
+
+// Oldest files are deleted above this, only checked once per run
+inline constexpr size_t MaxDiskFiles = 256;
+inline constexpr uint64_t MaxBlobBytes = 16 * 1024 * 1024;
+
+struct Define
+{
+    std::string Name;
+    std::string Value;
+};
+
+struct Request
+{
+    // Not copied, OptiScaler's shader sources are static strings
+    std::string_view Source;
+    std::string Entry;
+    std::string Target;
+    std::vector<Define> Defines;
+    uint32_t Flags = 0;
+};
+
+struct Key
+{
+    uint64_t Low = 0;
+    uint64_t High = 0;
+
+    bool operator==(const Key&) const = default;
+};
+
+struct KeyHash
+{
+    size_t operator()(const Key& key) const { return (size_t) (key.Low ^ (key.High * 0x9E3779B97F4A7C15ull)); }
+};
+
+namespace detail
+{
+inline void Append(std::vector<uint8_t>& buffer, const void* data, size_t size)
+{
+    auto bytes = static_cast<const uint8_t*>(data);
+    buffer.insert(buffer.end(), bytes, bytes + size);
+}
+
+// Length prefixed, so ("ab", "c") and ("a", "bc") give different keys
+inline void AppendString(std::vector<uint8_t>& buffer, std::string_view value)
+{
+    uint64_t size = value.size();
+    Append(buffer, &size, sizeof(size));
+    Append(buffer, value.data(), value.size());
+}
+} // namespace detail
+
+// salt covers everything outside of the request which changes the output (e.g. compiler version)
+inline Key MakeKey(const Request& request, uint64_t salt)
+{
+    auto source = reinterpret_cast<const uint8_t*>(request.Source.data());
+
+    std::vector<uint8_t> buffer;
+    buffer.reserve(128);
+
+    uint64_t sourceHashes[2] { tree_hash::XXH64(source, request.Source.size(), 0),
+                               tree_hash::XXH64(source, request.Source.size(), ~0ull) };
+
+    detail::Append(buffer, &salt, sizeof(salt));
+    detail::Append(buffer, sourceHashes, sizeof(sourceHashes));
+    detail::AppendString(buffer, request.Entry);
+    detail::AppendString(buffer, request.Target);
+    detail::Append(buffer, &request.Flags, sizeof(request.Flags));
+
+    for (auto& define : request.Defines)
+    {
+        detail::AppendString(buffer, define.Name);
+        detail::AppendString(buffer, define.Value);
+    }
+
+    return { tree_hash::XXH64(buffer.data(), buffer.size(), 0), tree_hash::XXH64(buffer.data(), buffer.size(), ~0ull) };
+}
+
+inline std::string FileName(const Key& key)
+{
+    char name[48];
+    snprintf(name, sizeof(name), "%016llx%016llx%s", (unsigned long long) key.High, (unsigned long long) key.Low,
+             Extension);
+    return name;
+}
+
+#pragma pack(push, 1)
+struct FileHeader
+{
+    uint32_t Magic;
+    uint32_t Version;
+    Key BlobKey;
+    uint64_t Size;
+    uint64_t Hash;
+};
+#pragma pack(pop)
+
+inline std::vector<uint8_t> Serialize(const Key& key, std::span<const uint8_t> blob)
+{
+    std::vector<uint8_t> data(sizeof(FileHeader) + blob.size());
+
+    FileHeader header { Magic, FormatVersion, key, blob.size(), tree_hash::XXH64(blob.data(), blob.size()) };
+    memcpy(data.data(), &header, sizeof(header));
+
+    if (!blob.empty())
+        memcpy(data.data() + sizeof(FileHeader), blob.data(), blob.size());
+
+    return data;
+}
+
+// False for anything which is not a valid blob of this key
+inline bool Deserialize(std::span<const uint8_t> data, const Key& key, std::vector<uint8_t>& blob)
+{
+    blob.clear();
+
+    if (data.size() < sizeof(FileHeader))
+        return false;
+
+    FileHeader header;
+    memcpy(&header, data.data(), sizeof(header));
+
+    if (header.Magic != Magic || header.Version != FormatVersion || !(header.BlobKey == key) || header.Size == 0 ||
+        header.Size != data.size() - sizeof(FileHeader))
+        return false;
+
+    auto body = data.subspan(sizeof(FileHeader));
+
+    if (tree_hash::XXH64(body.data(), body.size()) != header.Hash)
+        return false;
+
+    blob.assign(body.begin(), body.end());
+    return true;
+}
+
+struct Stats
+{
+    uint64_t MemoryHits = 0;
+    uint64_t DiskHits = 0;
+    uint64_t Compiles = 0;
+    uint64_t Failures = 0;
+
+    // Requests which waited for the same shader compiled by another thread
+    uint64_t Waits = 0;
+
+    size_t MemoryEntries = 0;
+    size_t MemoryBytes = 0;
+};
+
+using Blob = std::shared_ptr<const std::vector<uint8_t>>;
+
+// Returns false when compile failed, may be called from several threads at once
+using Compiler = std::function<bool(const Request& request, std::vector<uint8_t>& bytecode)>;
+
+// Thread safe
+class Cache
+{
+  private:
+    enum class Origin
+    {
+        Disk,
+        Compiler,
+        Failed,
+    };
+
+    struct Entry
+    {
+        Blob Data;
+        std::list<Key>::iterator Use;
+    };
+
+    struct InFlight
+    {
+        bool Done = false;
+        Blob Result;
+    };
+
+    std::filesystem::path _folder;
+    Compiler _compiler;
+    uint64_t _salt = 0;
+    size_t _memoryBudget = 0;
+
+    std::mutex _mutex;
+    std::condition_variable _finished;
+
+    // Front is the most recently used
+    std::list<Key> _uses;
+    std::unordered_map<Key, Entry, KeyHash> _entries;
+    std::unordered_map<Key, std::shared_ptr<InFlight>, KeyHash> _inFlight;
+    size_t _memoryBytes = 0;
+    bool _diskTrimmed = false;
+    Stats _stats;
+
+    // Warmup worker
+    std::deque<Request> _queue;
+    std::condition_variable _queueChanged;
+    std::thread _worker;
+    bool _working = false;
+    bool _stop = false;
+
+    void Insert(const Key& key, const Blob& blob)
+    {
+        if (blob->size() > _memoryBudget)
+            return;
+
+        _uses.push_front(key);
+        _entries[key] = Entry { blob, _uses.begin() };
+        _memoryBytes += blob->size();
+
+        while (_memoryBytes > _memoryBudget && !_uses.empty())
+        {
+            auto oldest = _entries.find(_uses.back());
+            _memoryBytes -= oldest->second.Data->size();
+            _entries.erase(oldest);
+            _uses.pop_back();
+        }
+    }
+
+    bool LoadFile(const Key& key, std::vector<uint8_t>& blob)
+    {
+        auto path = _folder / FileName(key);
+
+        std::error_code ec;
+        auto size = std::filesystem::file_size(path, ec);
+
+        if (ec || size < sizeof(FileHeader) || size > sizeof(FileHeader) + MaxBlobBytes)
+            return false;
+
+        std::vector<uint8_t> data(size);
+        bool valid = false;
+
+        {
+            std::ifstream file(path, std::ios::binary);
+            valid = file.read(reinterpret_cast<char*>(data.data()), data.size()) && Deserialize(data, key, blob);
+        }
+
+        if (!valid)
+            std::filesystem::remove(path, ec);
+        else
+            std::filesystem::last_write_time(path, std::filesystem::file_time_type::clock::now(), ec);
+
+        return valid;
+    }
+
+    // Same key is never written by two threads, it's in _inFlight while saving.
+    // Writes to a temp file and renames so other processes never see a half written file.
+    void SaveFile(const Key& key, std::span<const uint8_t> blob)
+    {
+        std::error_code ec;
+        std::filesystem::create_directories(_folder, ec);
+
+        auto path = _folder / FileName(key);
+        auto tempPath = path;
+        tempPath += ".tmp";
+
+        auto data = Serialize(key, blob);
+
+        {
+            std::ofstream file(tempPath, std::ios::binary | std::ios::trunc);
+
+            if (!file.write(reinterpret_cast<const char*>(data.data()), data.size()))
+            {
+                file.close();
+                std::filesystem::remove(tempPath, ec);
+                return;
+            }
+        }
+
+        std::filesystem::rename(tempPath, path, ec);
+
+        if (ec)
+            std::filesystem::remove(tempPath, ec);
+    }
+
+    void TrimFolder()
+    {
+        std::vector<std::pair<std::filesystem::file_time_type, std::filesystem::path>> files;
+
+        std::error_code ec;
+        for (auto& entry : std::filesystem::directory_iterator(_folder, ec))
+        {
+            if (entry.is_regular_file(ec) && entry.path().extension() == Extension)
+                files.emplace_back(entry.last_write_time(ec), entry.path());
+        }
+
+        if (files.size() <= MaxDiskFiles)
+            return;
+
+        std::sort(files.begin(), files.end(), [](auto& a, auto& b) { return a.first < b.first; });
+
+        for (size_t i = 0; i < files.size() - MaxDiskFiles; i++)
+            std::filesystem::remove(files[i].second, ec);
+    }
+
+    Blob Produce(const Key& key, const Request& request, Origin& origin)
+    {
+        auto data = std::make_shared<std::vector<uint8_t>>();
+
+        if (!_folder.empty() && LoadFile(key, *data))
+        {
+            origin = Origin::Disk;
+            return data;
+        }
+
+        if (!_compiler(request, *data) || data->empty() || data->size() > MaxBlobBytes)
+        {
+            origin = Origin::Failed;
+            return nullptr;
+        }
+
+        origin = Origin::Compiler;
+
+        if (!_folder.empty())
+            SaveFile(key, *data);
+
+        return data;
+    }
+
+    void Work()
+    {
+        std::unique_lock lock(_mutex);
+
+        while (true)
+        {
+            _queueChanged.wait(lock, [this] { return _stop || !_queue.empty(); });
+
+            if (_stop)
+                return;
+
+            auto request = std::move(_queue.front());
+            _queue.pop_front();
+            _working = true;
+
+            lock.unlock();
+            Get(request);
+            lock.lock();
+
+            _working = false;
+            _queueChanged.notify_all();
+        }
+    }
+
+  public:
+    // Empty folder keeps blobs only in memory
+    Cache(std::filesystem::path folder, Compiler compiler, uint64_t salt, size_t memoryBudget)
+        : _folder(std::move(folder)), _compiler(std::move(compiler)), _salt(salt), _memoryBudget(memoryBudget)
+    {
+    }
+
+    Cache(const Cache&) = delete;
+    Cache& operator=(const Cache&) = delete;
+
+    ~Cache()
+    {
+        {
+            std::scoped_lock lock(_mutex);
+            _stop = true;
+        }
+
+        _queueChanged.notify_all();
+
+        if (_worker.joinable())
+            _worker.join();
+    }
+
+    // nullptr when the shader can't be compiled
+    Blob Get(const Request& request)
+    {
+        auto key = MakeKey(request, _salt);
+        std::shared_ptr<InFlight> inFlight;
+
+        {
+            std::unique_lock lock(_mutex);
+
+            if (auto it = _entries.find(key); it != _entries.end())
+            {
+                _uses.splice(_uses.begin(), _uses, it->second.Use);
+                _stats.MemoryHits++;
+                return it->second.Data;
+            }
+
+            if (auto it = _inFlight.find(key); it != _inFlight.end())
+            {
+                inFlight = it->second;
+                _stats.Waits++;
+                _finished.wait(lock, [&] { return inFlight->Done; });
+                return inFlight->Result;
+            }
+
+            inFlight = std::make_shared<InFlight>();
+            _inFlight.emplace(key, inFlight);
+        }
+
+        Origin origin;
+        auto blob = Produce(key, request, origin);
+        bool trim = false;
+
+        {
+            std::scoped_lock lock(_mutex);
+
+            if (blob != nullptr)
+                Insert(key, blob);
+
+            if (origin == Origin::Disk)
+                _stats.DiskHits++;
+            else if (origin == Origin::Compiler)
+                _stats.Compiles++;
+            else
+                _stats.Failures++;
+
+            if (origin == Origin::Compiler && !_folder.empty() && !_diskTrimmed)
+            {
+                _diskTrimmed = true;
+                trim = true;
+            }
+
+            inFlight->Done = true;
+            inFlight->Result = blob;
+            _inFlight.erase(key);
+        }
+
+        _finished.notify_all();
+
+        if (trim)
+            TrimFolder();
+
+        return blob;
+    }
+
+    // Compiles on a background thread in the given order, Get calls for them wait or hit the cache
+    void Warmup(std::span<const Request> requests)
+    {
+        {
+            std::scoped_lock lock(_mutex);
+
+            if (_stop)
+                return;
+
+            _queue.insert(_queue.end(), requests.begin(), requests.end());
+
+            if (!_worker.joinable())
+                _worker = std::thread([this] { Work(); });
+        }
+
+        _queueChanged.notify_all();
+    }
+
+    void WaitForWarmup()
+    {
+        std::unique_lock lock(_mutex);
+        _queueChanged.wait(lock, [this] { return _stop || (_queue.empty() && !_working); });
+    }
+
+    Stats GetStats()
+    {
+        std::scoped_lock lock(_mutex);
+
+        auto stats = _stats;
+        stats.MemoryEntries = _entries.size();
+        stats.MemoryBytes = _memoryBytes;
+
+        return stats;
+    }
+};
+
+} // namespace shader_cache
@@ -1,4 +1,25 @@
 #include "pch.h"
+#include "Shader_Common.h"
+#include "ShaderCache.h"
+
+#include <Util.h>
+#include <proxies/Ntdll_Proxy.h>
+
+#include "output_scaling/OS_Dx11.h"
+#include "output_scaling/OS_Dx12.h"
+#include "rcas/RCAS_Dx11.h"
+#include "rcas/RCAS_Dx12.h"
+#include "bias/Bias_Dx11.h"
+#include "bias/Bias_Dx12.h"
+#include "hudless_compare/HC_Dx12.h"
+#include "render_ui/RUI_Dx12.h"
+#include "magnifier/Magnifier_Dx12.h"
+#include "resource_flip/RF_Dx12.h"
+#include "depth_invert/DI_Dx12.h"
+#include "depth_scale/DS_Dx12.h"
+#include "format_transfer/FT_Dx12.h"
+#include "hud_copy/HudCopy_Dx12.h"
+#include "hudless_compare_compute/HCC_Dx12.h"
 
 #include <d3dcompiler.h>
 
@@ -6,13 +27,25 @@
 #include <imgui/ImGuiNotify.hpp>
 #endif
 
-ID3DBlob* CompileShader(const char* shaderCode, const char* entryPoint, const char* target)
+static constexpr UINT CompileFlags = D3DCOMPILE_OPTIMIZATION_LEVEL3;
+
+// Blobs kept in memory, all OptiScaler shaders together are well below this
+static constexpr size_t MemoryBudget = 8 * 1024 * 1024;
+
+static bool CompileWithD3D(const shader_cache::Request& request, std::vector<uint8_t>& bytecode)
 {
+    std::vector<D3D_SHADER_MACRO> macros;
+
+    for (auto& define : request.Defines)
+        macros.push_back({ define.Name.c_str(), define.Value.c_str() });
+
+    macros.push_back({ nullptr, nullptr });
+
     ID3DBlob* shaderBlob = nullptr;
     ID3DBlob* errorBlob = nullptr;
 
-    HRESULT hr = D3DCompile(shaderCode, strlen(shaderCode), nullptr, nullptr, nullptr, entryPoint, target,
-                            D3DCOMPILE_OPTIMIZATION_LEVEL3, 0, &shaderBlob, &errorBlob);
+    HRESULT hr = D3DCompile(request.Source.data(), request.Source.size(), nullptr, macros.data(), nullptr,
+                            request.Entry.c_str(), request.Target.c_str(), request.Flags, 0, &shaderBlob, &errorBlob);
 
     if (FAILED(hr))
     {
@@ -31,11 +64,124 @@ ID3DBlob* CompileShader(const char* shaderCode, const char* entryPoint, const ch
         if (shaderBlob)
             shaderBlob->Release();
 
-        return nullptr;
+        return false;
     }
 
     if (errorBlob)
         errorBlob->Release();
 
+    auto data = static_cast<const uint8_t*>(shaderBlob->GetBufferPointer());
+    bytecode.assign(data, data + shaderBlob->GetBufferSize());
+    shaderBlob->Release();
+
+    return true;
+}
+
+// File version of the d3dcompiler which does the compiling, a game can ship or load its own copy.
+// Compiler is delay loaded, loading it here resolves to the same module D3DCompile will use.
+static uint64_t CompilerSalt()
+{
+    auto module = GetModuleHandleW(D3DCOMPILER_DLL_W);
+
+    if (module == nullptr)
+        module = NtdllProxy::LoadLibraryExW_Ldr(D3DCOMPILER_DLL_W, NULL, 0);
+
+    wchar_t path[MAX_PATH];
+    Util::version_t version;
+
+    if (module == nullptr || GetModuleFileNameW(module, path, MAX_PATH) == 0 || !Util::GetFileVersion(path, &version))
+    {
+        LOG_WARN("Can't get d3dcompiler version, shader cache uses the header version");
+        return D3D_COMPILER_VERSION;
+    }
+
+    LOG_INFO("Shader compiler: {} {}.{}.{}.{}", wstring_to_string(path), version.major, version.minor, version.patch,
+             version.reserved);
+
+    return ((uint64_t) version.major << 48) | ((uint64_t) version.minor << 32) | ((uint64_t) version.patch << 16) |
+           version.reserved;
+}
+
+static shader_cache::Cache& ShaderCache()
+{
+    // Never destroyed, warmup thread can't be joined while the dll is unloading
+    static auto cache = new shader_cache::Cache(Util::DllPath().parent_path() / "OptiScaler.shadercache",
+                                                CompileWithD3D, CompilerSalt(), MemoryBudget);
+    return *cache;
+}
+
+static shader_cache::Request MakeRequest(const char* shaderCode, const char* entryPoint, const char* target)
+{
+    return { shaderCode, entryPoint, target, {}, CompileFlags };
+}
+
+ID3DBlob* CompileShader(const char* shaderCode, const char* entryPoint, const char* target)
+{
+    auto bytecode = ShaderCache().Get(MakeRequest(shaderCode, entryPoint, target));
+
+    if (bytecode == nullptr)
+        return nullptr;
+
+    ID3DBlob* shaderBlob = nullptr;
+
+    if (FAILED(D3DCreateBlob(bytecode->size(), &shaderBlob)))
+    {
+        LOG_ERROR("D3DCreateBlob failed!");
+        return nullptr;
+    }
+
+    memcpy(shaderBlob->GetBufferPointer(), bytecode->data(), bytecode->size());
+
     return shaderBlob;
 }
+
+void WarmupShader(const char* shaderCode, const char* entryPoint, const char* target)
+{
+    auto request = MakeRequest(shaderCode, entryPoint, target);
+    ShaderCache().Warmup({ &request, 1 });
+}
+
+void WarmupDx11Shaders()
+{
+    static std::once_flag once;
+
+    std::call_once(once,
+                   []()
+                   {
+                       LOG_DEBUG("");
+
+                       OS_Dx11::Warmup();
+                       RCAS_Dx11::Warmup();
+                       Bias_Dx11::Warmup();
+                   });
+}
+
+void WarmupDx12Shaders(ID3D12Device* device)
+{
+    static std::once_flag once;
+
+    // Graphics pipelines depend on the swapchain format, only their shaders are compiled
+    std::call_once(once,
+                   []()
+                   {
+                       HC_Dx12::Warmup();
+                       RUI_Dx12::Warmup();
+                   });
+
+    if (device == nullptr)
+        return;
+
+    LOG_DEBUG("device: {:X}", (size_t) device);
+
+    // Pipelines belong to the device, already queued ones are skipped
+    OS_Dx12::Warmup(device);
+    RCAS_Dx12::Warmup(device);
+    Bias_Dx12::Warmup(device);
+    Magnifier_Dx12::Warmup(device);
+    RF_Dx12::Warmup(device);
+    DI_Dx12::Warmup(device);
+    DS_Dx12::Warmup(device);
+    FT_Dx12::Warmup(device);
+    HudCopy_Dx12::Warmup(device);
+    HCC_Dx12::Warmup(device);
+}
@@ -2,4 +2,15 @@
 
 #include "SysUtils.h"
 
-ID3DBlob* CompileShader(const char* shaderCode, const char* entryPoint, const char* target);
\ No newline at end of file
+// Goes through the shader cache, returned blob is owned by the caller
+ID3DBlob* CompileShader(const char* shaderCode, const char* entryPoint, const char* target);
+
+// Queues a compile on the background thread, later CompileShader calls for it are served from the cache.
+// shaderCode has to stay valid until the process exits.
+void WarmupShader(const char* shaderCode, const char* entryPoint, const char* target);
+
+// Shaders current config can compile at runtime, only queued once per process
+void WarmupDx11Shaders();
+
+// Also queues the pipelines of the Dx12 passes, once a device is used for a swapchain
+void WarmupDx12Shaders(ID3D12Device* device);
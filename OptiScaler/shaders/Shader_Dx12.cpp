@@ -4,6 +4,186 @@
 
 using Microsoft::WRL::ComPtr;
 
+class PipelineBackend_Dx12 : public pipeline_manager::Backend
+{
+  private:
+    ID3D12Device* _device = nullptr;
+
+  public:
+    uint64_t CreateSignature(std::span<const uint8_t> blob) override
+    {
+        ID3D12RootSignature* rootSignature = nullptr;
+        auto hr = _device->CreateRootSignature(0, blob.data(), blob.size(), IID_PPV_ARGS(&rootSignature));
+
+        if (FAILED(hr))
+        {
+            LOG_ERROR("CreateRootSignature error {0:x}", hr);
+            return 0;
+        }
+
+        return (uint64_t) rootSignature;
+    }
+
+    void Release(uint64_t handle) override { ((IUnknown*) handle)->Release(); }
+
+    // Worker can still be building when the game releases the device. This is the only reference the manager
+    // holds, ReleasePipelines is called once the game releases its last one
+    PipelineBackend_Dx12(ID3D12Device* device) : _device(device) { _device->AddRef(); }
+
+    ~PipelineBackend_Dx12() { _device->Release(); }
+};
+
+static uint64_t HashBytes(const void* data, size_t size)
+{
+    return tree_hash::XXH64(reinterpret_cast<const uint8_t*>(data), size);
+}
+
+// Source is only set when it's compiled at runtime
+static uint64_t ComputePipelineKey(uint64_t signatureKey, const void* bytecode, size_t bytecodeSize,
+                                   const char* source)
+{
+    uint64_t parts[3] = { signatureKey, HashBytes(bytecode, bytecodeSize),
+                          source != nullptr ? HashBytes(source, strlen(source)) : 0 };
+
+    return HashBytes(parts, sizeof(parts));
+}
+
+static void HashShader(std::vector<uint64_t>& parts, const D3D12_SHADER_BYTECODE& shader)
+{
+    parts.push_back(shader.pShaderBytecode != nullptr ? HashBytes(shader.pShaderBytecode, shader.BytecodeLength) : 0);
+}
+
+static void HashStencilOp(std::vector<uint64_t>& parts, const D3D12_DEPTH_STENCILOP_DESC& op)
+{
+    parts.push_back(((uint64_t) op.StencilFailOp << 48) | ((uint64_t) op.StencilDepthFailOp << 32) |
+                    ((uint64_t) op.StencilPassOp << 16) | (uint64_t) op.StencilFunc);
+}
+
+// Everything CreateGraphicsPipelineState reads except the root signature and the cached blob.
+// Fields are added one by one, padding of the structs is not guaranteed to be cleared
+static uint64_t GraphicsPipelineKey(uint64_t signatureKey, const D3D12_GRAPHICS_PIPELINE_STATE_DESC& desc)
+{
+    std::vector<uint64_t> parts;
+    parts.reserve(64);
+
+    parts.push_back(signatureKey);
+
+    HashShader(parts, desc.VS);
+    HashShader(parts, desc.PS);
+    HashShader(parts, desc.DS);
+    HashShader(parts, desc.HS);
+    HashShader(parts, desc.GS);
+
+    auto& so = desc.StreamOutput;
+    parts.push_back(((uint64_t) so.NumEntries << 32) | so.RasterizedStream);
+
+    for (UINT i = 0; i < so.NumEntries && so.pSODeclaration != nullptr; i++)
+    {
+        auto& entry = so.pSODeclaration[i];
+        parts.push_back(entry.SemanticName != nullptr ? HashBytes(entry.SemanticName, strlen(entry.SemanticName)) : 0);
+        parts.push_back(((uint64_t) entry.Stream << 32) | entry.SemanticIndex);
+        parts.push_back(((uint64_t) entry.StartComponent << 48) | ((uint64_t) entry.ComponentCount << 32) |
+                        entry.OutputSlot);
+    }
+
+    for (UINT i = 0; i < so.NumStrides && so.pBufferStrides != nullptr; i++)
+        parts.push_back(so.pBufferStrides[i]);
+
+    auto& blend = desc.BlendState;
+    parts.push_back(((uint64_t) blend.AlphaToCoverageEnable << 32) | (uint64_t) blend.IndependentBlendEnable);
+
+    for (auto& target : blend.RenderTarget)
+    {
+        parts.push_back(((uint64_t) target.BlendEnable << 32) | (uint64_t) target.LogicOpEnable);
+        parts.push_back(((uint64_t) target.SrcBlend << 48) | ((uint64_t) target.DestBlend << 32) |
+                        ((uint64_t) target.BlendOp << 16) | (uint64_t) target.LogicOp);
+        parts.push_back(((uint64_t) target.SrcBlendAlpha << 48) | ((uint64_t) target.DestBlendAlpha << 32) |
+                        ((uint64_t) target.BlendOpAlpha << 16) | (uint64_t) target.RenderTargetWriteMask);
+    }
+
+    parts.push_back(desc.SampleMask);
+
+    auto& raster = desc.RasterizerState;
+    uint32_t depthBiasClamp;
+    uint32_t slopeScaledDepthBias;
+    memcpy(&depthBiasClamp, &raster.DepthBiasClamp, sizeof(depthBiasClamp));
+    memcpy(&slopeScaledDepthBias, &raster.SlopeScaledDepthBias, sizeof(slopeScaledDepthBias));
+
+    parts.push_back(((uint64_t) raster.FillMode << 48) | ((uint64_t) raster.CullMode << 32) |
+                    ((uint64_t) raster.FrontCounterClockwise << 16) | (uint64_t) raster.ConservativeRaster);
+    parts.push_back(((uint64_t) (uint32_t) raster.DepthBias << 32) | depthBiasClamp);
+    parts.push_back(((uint64_t) slopeScaledDepthBias << 32) | raster.ForcedSampleCount);
+    parts.push_back(((uint64_t) raster.DepthClipEnable << 48) | ((uint64_t) raster.MultisampleEnable << 32) |
+                    (uint64_t) raster.AntialiasedLineEnable);
+
+    auto& depth = desc.DepthStencilState;
+    parts.push_back(((uint64_t) depth.DepthEnable << 48) | ((uint64_t) depth.DepthWriteMask << 32) |
+                    ((uint64_t) depth.DepthFunc << 16) | (uint64_t) depth.StencilEnable);
+    parts.push_back(((uint64_t) depth.StencilReadMask << 8) | depth.StencilWriteMask);
+    HashStencilOp(parts, depth.FrontFace);
+    HashStencilOp(parts, depth.BackFace);
+
+    auto& layout = desc.InputLayout;
+    parts.push_back(layout.NumElements);
+
+    for (UINT i = 0; i < layout.NumElements && layout.pInputElementDescs != nullptr; i++)
+    {
+        auto& element = layout.pInputElementDescs[i];
+        parts.push_back(element.SemanticName != nullptr ? HashBytes(element.SemanticName, strlen(element.SemanticName))
+                                                        : 0);
+        parts.push_back(((uint64_t) element.SemanticIndex << 32) | (uint64_t) element.Format);
+        parts.push_back(((uint64_t) element.InputSlot << 32) | element.AlignedByteOffset);
+        parts.push_back(((uint64_t) element.InputSlotClass << 32) | element.InstanceDataStepRate);
+    }
+
+    parts.push_back(((uint64_t) desc.IBStripCutValue << 32) | (uint64_t) desc.PrimitiveTopologyType);
+    parts.push_back(desc.NumRenderTargets);
+
+    for (auto format : desc.RTVFormats)
+        parts.push_back((uint64_t) format);
+
+    parts.push_back((uint64_t) desc.DSVFormat);
+    parts.push_back(((uint64_t) desc.SampleDesc.Count << 32) | desc.SampleDesc.Quality);
+    parts.push_back(((uint64_t) desc.NodeMask << 32) | (uint64_t) desc.Flags);
+
+    return HashBytes(parts.data(), parts.size() * sizeof(uint64_t));
+}
+
+// Compiles the source when set, precompiled bytecode is used when it's null or fails to compile
+static pipeline_manager::CreateFunc ComputePipelineFunc(ID3D12Device* device, const void* bytecode,
+                                                        size_t bytecodeSize, const char* source)
+{
+    std::string code = source != nullptr ? source : "";
+
+    return [device, bytecode, bytecodeSize, code](uint64_t rootSignature) -> uint64_t
+    {
+        ComPtr<ID3DBlob> shaderBlob;
+
+        if (!code.empty())
+            shaderBlob.Attach(CompileShader(code.c_str(), "CSMain", "cs_5_0"));
+
+        D3D12_COMPUTE_PIPELINE_STATE_DESC psoDesc = {};
+        psoDesc.pRootSignature = (ID3D12RootSignature*) rootSignature;
+        psoDesc.Flags = D3D12_PIPELINE_STATE_FLAG_NONE;
+
+        if (shaderBlob != nullptr)
+            psoDesc.CS = CD3DX12_SHADER_BYTECODE(shaderBlob->GetBufferPointer(), shaderBlob->GetBufferSize());
+        else
+            psoDesc.CS = CD3DX12_SHADER_BYTECODE(bytecode, bytecodeSize);
+
+        ID3D12PipelineState* pipelineState = nullptr;
+        auto hr = device->CreateComputePipelineState(&psoDesc, IID_PPV_ARGS(&pipelineState));
+
+        if (FAILED(hr))
+        {
+            LOG_ERROR("CreateComputePipelineState error {0:x}", hr);
+            return 0;
+        }
+
+        return (uint64_t) pipelineState;
+    };
+}
+
 Shader_Dx12::Shader_Dx12(std::string InName, ID3D12Device* InDevice) : _name(InName), _device(InDevice) {}
 
 Shader_Dx12::~Shader_Dx12()
@@ -11,11 +191,53 @@ Shader_Dx12::~Shader_Dx12()
     if (!_init || State::Instance().isShuttingDown)
         return;
 
-    SAFE_RELEASE(_pipelineState);
-    SAFE_RELEASE(_rootSignature);
     SAFE_RELEASE(_constantBuffer);
 }
 
+static std::mutex _managersMutex;
+static std::unordered_map<ID3D12Device*, pipeline_manager::Manager*> _managers;
+
+pipeline_manager::Manager& Shader_Dx12::Pipelines(ID3D12Device* device)
+{
+    std::lock_guard lock(_managersMutex);
+
+    auto& manager = _managers[device];
+
+    // Deleted by ReleasePipelines, kept while shutting down as shaders can be released after the device
+    if (manager == nullptr)
+        manager = new pipeline_manager::Manager(std::make_unique<PipelineBackend_Dx12>(device));
+
+    return *manager;
+}
+
+bool Shader_Dx12::HasPipelines(ID3D12Device* device)
+{
+    std::lock_guard lock(_managersMutex);
+    return _managers.contains(device);
+}
+
+void Shader_Dx12::ReleasePipelines(ID3D12Device* device)
+{
+    pipeline_manager::Manager* manager = nullptr;
+
+    {
+        std::lock_guard lock(_managersMutex);
+
+        auto it = _managers.find(device);
+
+        if (it == _managers.end())
+            return;
+
+        manager = it->second;
+        _managers.erase(it);
+    }
+
+    LOG_DEBUG("device: {:X}", (size_t) device);
+
+    // Outside of the lock, releasing the device reference goes through the Release hook again
+    delete manager;
+}
+
 DXGI_FORMAT Shader_Dx12::TranslateTypelessFormats(DXGI_FORMAT format)
 {
     switch (format)
@@ -65,41 +287,64 @@ DXGI_FORMAT Shader_Dx12::TranslateTypelessFormats(DXGI_FORMAT format)
     }
 }
 
-bool Shader_Dx12::CreateComputeShader(ID3D12Device* device, ID3D12RootSignature* rootSignature,
-                                      ID3D12PipelineState** pipelineState, ID3DBlob* shaderBlob,
-                                      D3D12_SHADER_BYTECODE byteCode)
+bool Shader_Dx12::CreateComputePipeline(ID3D12Device* device, ID3D12PipelineState** pipelineState, const void* bytecode,
+                                        size_t bytecodeSize, const char* source)
 {
-    D3D12_COMPUTE_PIPELINE_STATE_DESC psoDesc = {};
-    psoDesc.pRootSignature = rootSignature;
-    psoDesc.Flags = D3D12_PIPELINE_STATE_FLAG_NONE;
+    // Compile if not using precompiled
+    if (Config::Instance()->UsePrecompiledShaders.value_or_default())
+        source = nullptr;
 
-    if (shaderBlob != nullptr)
-        psoDesc.CS = CD3DX12_SHADER_BYTECODE(shaderBlob->GetBufferPointer(), shaderBlob->GetBufferSize());
-    else
-        psoDesc.CS = byteCode;
+    auto key = ComputePipelineKey(_signatureKey, bytecode, bytecodeSize, source);
 
-    HRESULT hr = device->CreateComputePipelineState(&psoDesc, __uuidof(ID3D12PipelineState*), (void**) pipelineState);
+    // Ready if it was prewarmed, otherwise built here
+    *pipelineState = (ID3D12PipelineState*) Pipelines(device).Acquire(
+        key, _signatureKey, ComputePipelineFunc(device, bytecode, bytecodeSize, source), _name);
 
-    if (FAILED(hr))
+    return *pipelineState != nullptr;
+}
+
+bool Shader_Dx12::CreateGraphicsPipeline(ID3D12Device* device, const D3D12_GRAPHICS_PIPELINE_STATE_DESC& desc)
+{
+    auto key = GraphicsPipelineKey(_signatureKey, desc);
+
+    // New keys are built on this thread, so desc is still valid
+    auto create = [device, &desc](uint64_t rootSignature) -> uint64_t
     {
-        LOG_ERROR("CreateComputePipelineState error {0:x}", hr);
-        return false;
-    }
+        auto psoDesc = desc;
+        psoDesc.pRootSignature = (ID3D12RootSignature*) rootSignature;
 
-    return true;
+        ID3D12PipelineState* pipelineState = nullptr;
+        auto hr = device->CreateGraphicsPipelineState(&psoDesc, IID_PPV_ARGS(&pipelineState));
+
+        if (FAILED(hr))
+        {
+            LOG_ERROR("CreateGraphicsPipelineState error: {:X}", (unsigned long) hr);
+            return 0;
+        }
+
+        return (uint64_t) pipelineState;
+    };
+
+    _pipelineState = (ID3D12PipelineState*) Pipelines(device).Acquire(key, _signatureKey, create, _name);
+
+    return _pipelineState != nullptr;
 }
 
-bool Shader_Dx12::CreateComputePipeline(ID3D12Device* device, ID3D12PipelineState** pipelineState, const void* bytecode,
-                                        size_t bytecodeSize, const char* source)
+void Shader_Dx12::PrewarmComputePipeline(ID3D12Device* device, const std::vector<uint8_t>& rootSignature,
+                                         const void* bytecode, size_t bytecodeSize, const char* source,
+                                         const char* name)
 {
-    ComPtr<ID3DBlob> shaderBlob;
+    if (device == nullptr || rootSignature.empty())
+        return;
 
-    // Compile if not using precompiled
-    if (!Config::Instance()->UsePrecompiledShaders.value_or_default() && source)
-        shaderBlob = CompileShader(source, "CSMain", "cs_5_0");
+    if (Config::Instance()->UsePrecompiledShaders.value_or_default())
+        source = nullptr;
 
-    return CreateComputeShader(device, _rootSignature, pipelineState, shaderBlob.Get(),
-                               CD3DX12_SHADER_BYTECODE(bytecode, bytecodeSize));
+    auto& pipelines = Pipelines(device);
+    auto signatureKey = pipelines.AddSignature(rootSignature);
+    auto key = ComputePipelineKey(signatureKey, bytecode, bytecodeSize, source);
+
+    pipelines.Prewarm(key, signatureKey, ComputePipelineFunc(device, bytecode, bytecodeSize, source), name);
 }
 
 bool Shader_Dx12::CreateBufferResource(ID3D12Device* InDevice, ID3D12Resource* InResource,
@@ -397,36 +642,27 @@ void Shader_Dx12::CreateRenderTargetView(ID3D12Device* device, ID3D12Resource* t
     device->CreateRenderTargetView(tex, &rtvDesc, rtvDescriptor);
 }
 
-bool Shader_Dx12::SetupRootSignature(ID3D12Device* InDevice, uint32_t srcCount, uint32_t uavCount, uint32_t cbvCount,
-                                     uint32_t rtvCount, uint32_t samplerCount, uint32_t staticSamplerCount,
-                                     const D3D12_STATIC_SAMPLER_DESC* pStaticSamplers, D3D12_ROOT_SIGNATURE_FLAGS flags)
+std::vector<uint8_t> Shader_Dx12::SerializeRootSignature(uint32_t srcCount, uint32_t uavCount, uint32_t cbvCount,
+                                                         uint32_t samplerCount, uint32_t staticSamplerCount,
+                                                         const D3D12_STATIC_SAMPLER_DESC* pStaticSamplers,
+                                                         D3D12_ROOT_SIGNATURE_FLAGS flags)
 {
-    if (_init)
-    {
-        LOG_ERROR("Already inited");
-        return true;
-    }
+    std::vector<CD3DX12_DESCRIPTOR_RANGE1> descriptorRanges;
 
-    _srcCount = srcCount;
-    _uavCount = uavCount;
-    _cbvCount = cbvCount;
-    _rtvCount = rtvCount;
-    _samplerCount = samplerCount;
+    if (srcCount > 0)
+        descriptorRanges.emplace_back(D3D12_DESCRIPTOR_RANGE_TYPE_SRV, srcCount, 0);
 
-    if (_srcCount > 0)
-        _descriptorRanges.emplace_back(D3D12_DESCRIPTOR_RANGE_TYPE_SRV, _srcCount, 0);
+    if (uavCount > 0)
+        descriptorRanges.emplace_back(D3D12_DESCRIPTOR_RANGE_TYPE_UAV, uavCount, 0);
 
-    if (_uavCount > 0)
-        _descriptorRanges.emplace_back(D3D12_DESCRIPTOR_RANGE_TYPE_UAV, _uavCount, 0);
+    if (cbvCount > 0)
+        descriptorRanges.emplace_back(D3D12_DESCRIPTOR_RANGE_TYPE_CBV, cbvCount, 0);
 
-    if (_cbvCount > 0)
-        _descriptorRanges.emplace_back(D3D12_DESCRIPTOR_RANGE_TYPE_CBV, _cbvCount, 0);
-
-    if (_samplerCount > 0)
-        _descriptorRanges.emplace_back(D3D12_DESCRIPTOR_RANGE_TYPE_SAMPLER, _samplerCount, 0);
+    if (samplerCount > 0)
+        descriptorRanges.emplace_back(D3D12_DESCRIPTOR_RANGE_TYPE_SAMPLER, samplerCount, 0);
 
     CD3DX12_ROOT_PARAMETER1 rootParameter {};
-    rootParameter.InitAsDescriptorTable(static_cast<UINT>(_descriptorRanges.size()), _descriptorRanges.data());
+    rootParameter.InitAsDescriptorTable(static_cast<UINT>(descriptorRanges.size()), descriptorRanges.data());
 
     CD3DX12_VERSIONED_ROOT_SIGNATURE_DESC rootSigDesc {};
     rootSigDesc.Init_1_1(1, &rootParameter, staticSamplerCount, pStaticSamplers, flags);
@@ -434,26 +670,44 @@ bool Shader_Dx12::SetupRootSignature(ID3D12Device* InDevice, uint32_t srcCount,
     ComPtr<ID3DBlob> errorBlob;
     ComPtr<ID3DBlob> signatureBlob;
 
-    do
+    auto hr = D3D12SerializeVersionedRootSignature(&rootSigDesc, &signatureBlob, &errorBlob);
+
+    if (FAILED(hr))
     {
-        auto hr = D3D12SerializeVersionedRootSignature(&rootSigDesc, &signatureBlob, &errorBlob);
+        LOG_ERROR("D3D12SerializeVersionedRootSignature error {0:x}", hr);
+        return {};
+    }
 
-        if (FAILED(hr))
-        {
-            LOG_ERROR("[{0}] D3D12SerializeVersionedRootSignature error {1:x}", _name, hr);
-            break;
-        }
+    auto data = reinterpret_cast<const uint8_t*>(signatureBlob->GetBufferPointer());
+    return std::vector<uint8_t>(data, data + signatureBlob->GetBufferSize());
+}
+
+bool Shader_Dx12::SetupRootSignature(ID3D12Device* InDevice, uint32_t srcCount, uint32_t uavCount, uint32_t cbvCount,
+                                     uint32_t rtvCount, uint32_t samplerCount, uint32_t staticSamplerCount,
+                                     const D3D12_STATIC_SAMPLER_DESC* pStaticSamplers, D3D12_ROOT_SIGNATURE_FLAGS flags)
+{
+    if (_init)
+    {
+        LOG_ERROR("Already inited");
+        return true;
+    }
 
-        hr = InDevice->CreateRootSignature(0, signatureBlob->GetBufferPointer(), signatureBlob->GetBufferSize(),
-                                           IID_PPV_ARGS(&_rootSignature));
+    _srcCount = srcCount;
+    _uavCount = uavCount;
+    _cbvCount = cbvCount;
+    _rtvCount = rtvCount;
+    _samplerCount = samplerCount;
 
-        if (FAILED(hr))
-        {
-            LOG_ERROR("[{0}] CreateRootSignature error {1:x}", _name, hr);
-            break;
-        }
+    auto signatureBlob =
+        SerializeRootSignature(srcCount, uavCount, cbvCount, samplerCount, staticSamplerCount, pStaticSamplers, flags);
 
-    } while (false);
+    if (!signatureBlob.empty())
+    {
+        // Same layouts are shared between the passes
+        auto& pipelines = Pipelines(InDevice);
+        _signatureKey = pipelines.AddSignature(signatureBlob);
+        _rootSignature = (ID3D12RootSignature*) pipelines.AcquireSignature(_signatureKey);
+    }
 
     if (_rootSignature == nullptr)
     {
@@ -1,6 +1,7 @@
 #pragma once
 #include <d3d12.h>
 #include "Shader_Common.h"
+#include "PipelineManager.h"
 
 class Shader_Dx12
 {
@@ -16,20 +17,30 @@ class Shader_Dx12
     bool _init = false;
     int _counter = 0;
 
+    // Owned by the pipeline manager of the device, not released with the shader
     ID3D12RootSignature* _rootSignature = nullptr;
     ID3D12PipelineState* _pipelineState = nullptr;
+    uint64_t _signatureKey = 0;
 
     ID3D12Device* _device = nullptr;
     ID3D12Resource* _constantBuffer = nullptr;
 
-    std::vector<CD3DX12_DESCRIPTOR_RANGE1> _descriptorRanges;
-
     static DXGI_FORMAT TranslateTypelessFormats(DXGI_FORMAT format);
-    static bool CreateComputeShader(ID3D12Device* device, ID3D12RootSignature* rootSignature,
-                                    ID3D12PipelineState** pipelineState, ID3DBlob* shaderBlob,
-                                    D3D12_SHADER_BYTECODE byteCode);
     bool CreateComputePipeline(ID3D12Device* device, ID3D12PipelineState** pipelineState, const void* bytecode,
                                size_t bytecodeSize, const char* source);
+    bool CreateGraphicsPipeline(ID3D12Device* device, const D3D12_GRAPHICS_PIPELINE_STATE_DESC& desc);
+
+    static pipeline_manager::Manager& Pipelines(ID3D12Device* device);
+    static std::vector<uint8_t>
+    SerializeRootSignature(uint32_t srcCount, uint32_t uavCount, uint32_t cbvCount, uint32_t samplerCount = 0,
+                           uint32_t staticSamplerCount = 0, const D3D12_STATIC_SAMPLER_DESC* pStaticSamplers = nullptr,
+                           D3D12_ROOT_SIGNATURE_FLAGS flags = D3D12_ROOT_SIGNATURE_FLAG_NONE);
+
+    // Queues the pipeline CreateComputePipeline would create with the same arguments
+    static void PrewarmComputePipeline(ID3D12Device* device, const std::vector<uint8_t>& rootSignature,
+                                       const void* bytecode, size_t bytecodeSize, const char* source,
+                                       const char* name);
+
     static bool CreateBufferResource(ID3D12Device* InDevice, ID3D12Resource* InResource, D3D12_RESOURCE_STATES InState,
                                      ID3D12Resource** OutResource, D3D12_RESOURCE_FLAGS ResourceFlags,
                                      uint64_t InWidth = 0, uint32_t InHeight = 0,
@@ -56,6 +67,12 @@ class Shader_Dx12
   public:
     bool IsInit() const { return _init; }
 
+    // Pipeline manager of the device holds one reference to it
+    static bool HasPipelines(ID3D12Device* device);
+
+    // Stops prewarming and releases the pipelines, root signatures and the device reference of the manager
+    static void ReleasePipelines(ID3D12Device* device);
+
     Shader_Dx12(std::string InName, ID3D12Device* InDevice);
 
     ~Shader_Dx12();
@@ -183,6 +183,12 @@ bool Bias_Dx11::Dispatch(ID3D11Device* InDevice, ID3D11DeviceContext* InContext,
     return true;
 }
 
+void Bias_Dx11::Warmup()
+{
+    if (!Config::Instance()->UsePrecompiledShaders.value_or_default())
+        WarmupShader(biasShader.c_str(), "CSMain", "cs_5_0");
+}
+
 Bias_Dx11::Bias_Dx11(std::string InName, ID3D11Device* InDevice) : _name(InName), _device(InDevice)
 {
     if (InDevice == nullptr)
@@ -39,6 +39,8 @@ class Bias_Dx11
     bool IsInit() const { return _init; }
     bool CanRender() const { return _init && _buffer != nullptr; }
 
+    static void Warmup();
+
     Bias_Dx11(std::string InName, ID3D11Device* InDevice);
 
     ~Bias_Dx11();
@@ -71,6 +71,12 @@ bool Bias_Dx12::Dispatch(ID3D12GraphicsCommandList* InCmdList, ID3D12Resource* I
     return true;
 }
 
+void Bias_Dx12::Warmup(ID3D12Device* InDevice)
+{
+    PrewarmComputePipeline(InDevice, SerializeRootSignature(1, 1, 1), bias_cso, sizeof(bias_cso), biasShader.c_str(),
+                           "Bias");
+}
+
 Bias_Dx12::Bias_Dx12(std::string InName, ID3D12Device* InDevice) : Shader_Dx12(InName, InDevice)
 {
     if (InDevice == nullptr)
@@ -66,6 +66,16 @@ bool DI_Dx12::Dispatch(ID3D12GraphicsCommandList* InCmdList, ID3D12Resource* InR
     return true;
 }
 
+void DI_Dx12::Warmup(ID3D12Device* InDevice)
+{
+    // Only used by frame generation
+    if (Config::Instance()->FGOutput.value_or_default() == FGOutput::NoFG)
+        return;
+
+    PrewarmComputePipeline(InDevice, SerializeRootSignature(1, 1, 0), DI_cso, sizeof(DI_cso), shaderCode.c_str(),
+                           "DepthInvert");
+}
+
 DI_Dx12::DI_Dx12(std::string InName, ID3D12Device* InDevice) : Shader_Dx12(InName, InDevice)
 {
     if (InDevice == nullptr)
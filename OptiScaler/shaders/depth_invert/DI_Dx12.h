@@ -29,6 +29,8 @@ class DI_Dx12 : public Shader_Dx12
     ID3D12Resource* Buffer() { return _buffer; }
     bool CanRender() const { return _init && _buffer != nullptr; }
 
+    static void Warmup(ID3D12Device* InDevice);
+
     DI_Dx12(std::string InName, ID3D12Device* InDevice);
 
     ~DI_Dx12();
@@ -87,6 +87,16 @@ bool DS_Dx12::Dispatch(ID3D12GraphicsCommandList* InCmdList, ID3D12Resource* InR
     return true;
 }
 
+void DS_Dx12::Warmup(ID3D12Device* InDevice)
+{
+    // Only used by frame generation
+    if (Config::Instance()->FGOutput.value_or_default() == FGOutput::NoFG)
+        return;
+
+    PrewarmComputePipeline(InDevice, SerializeRootSignature(1, 1, 1), DS_cso, sizeof(DS_cso), shaderCode.c_str(),
+                           "Depth Scale");
+}
+
 DS_Dx12::DS_Dx12(std::string InName, ID3D12Device* InDevice) : Shader_Dx12(InName, InDevice)
 {
     if (InDevice == nullptr)
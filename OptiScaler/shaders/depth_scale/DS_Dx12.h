@@ -29,6 +29,8 @@ class DS_Dx12 : public Shader_Dx12
     ID3D12Resource* Buffer() { return _buffer; }
     bool CanRender() const { return _init && _buffer != nullptr; }
 
+    static void Warmup(ID3D12Device* InDevice);
+
     DS_Dx12(std::string InName, ID3D12Device* InDevice);
 
     ~DS_Dx12();
@@ -97,6 +97,16 @@ bool FT_Dx12::Dispatch(ID3D12GraphicsCommandList* InCmdList, ID3D12Resource* InR
     return true;
 }
 
+void FT_Dx12::Warmup(ID3D12Device* InDevice)
+{
+    // Only used by frame generation
+    if (Config::Instance()->FGOutput.value_or_default() == FGOutput::NoFG)
+        return;
+
+    PrewarmComputePipeline(InDevice, SerializeRootSignature(1, 1, 0), FT_cso, sizeof(FT_cso), FT_ShaderCode.c_str(),
+                           "FormatTransfer");
+}
+
 FT_Dx12::FT_Dx12(std::string InName, ID3D12Device* InDevice, DXGI_FORMAT InFormat)
     : Shader_Dx12(InName, InDevice), format(InFormat)
 {
@@ -33,6 +33,8 @@ class FT_Dx12 : public Shader_Dx12
     bool CanRender() const { return _init && _buffer != nullptr; }
     DXGI_FORMAT Format() const { return format; }
 
+    static void Warmup(ID3D12Device* InDevice);
+
     FT_Dx12(std::string InName, ID3D12Device* InDevice, DXGI_FORMAT InFormat);
 
     bool IsFormatCompatible(DXGI_FORMAT InFormat);
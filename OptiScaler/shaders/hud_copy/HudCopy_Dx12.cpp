@@ -99,6 +99,16 @@ bool HudCopy_Dx12::Dispatch(ID3D12GraphicsCommandList* cmdList, ID3D12Resource*
     return true;
 }
 
+void HudCopy_Dx12::Warmup(ID3D12Device* InDevice)
+{
+    // Only used by frame generation
+    if (Config::Instance()->FGOutput.value_or_default() == FGOutput::NoFG)
+        return;
+
+    PrewarmComputePipeline(InDevice, SerializeRootSignature(2, 1, 1), HudCopy_cso, sizeof(HudCopy_cso),
+                           shaderCode.c_str(), "HudCopy");
+}
+
 HudCopy_Dx12::HudCopy_Dx12(std::string InName, ID3D12Device* InDevice) : Shader_Dx12(InName, InDevice)
 {
     if (InDevice == nullptr)
@@ -32,6 +32,8 @@ class HudCopy_Dx12 : public Shader_Dx12
     bool Dispatch(ID3D12GraphicsCommandList* cmdList, ID3D12Resource* hudless, ID3D12Resource* present,
                   D3D12_RESOURCE_STATES hudlessState, D3D12_RESOURCE_STATES presentState, float hudDetectionThreshold);
 
+    static void Warmup(ID3D12Device* InDevice);
+
     HudCopy_Dx12(std::string InName, ID3D12Device* InDevice);
 
     ~HudCopy_Dx12();
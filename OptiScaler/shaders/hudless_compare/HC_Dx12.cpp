@@ -125,6 +125,17 @@ void HC_Dx12::SetBufferState(UINT index, ID3D12GraphicsCommandList* InCommandLis
     _bufferState[index] = InState;
 }
 
+void HC_Dx12::Warmup()
+{
+    // Only used by frame generation
+    if (Config::Instance()->UsePrecompiledShaders.value_or_default() ||
+        Config::Instance()->FGOutput.value_or_default() == FGOutput::NoFG)
+        return;
+
+    WarmupShader(hcCode.c_str(), "VSMain", "vs_5_1");
+    WarmupShader(hcCode.c_str(), "PSMain", "ps_5_1");
+}
+
 HC_Dx12::HC_Dx12(std::string InName, ID3D12Device* InDevice) : Shader_Dx12(InName, InDevice)
 {
     DXGI_SWAP_CHAIN_DESC scDesc {};
@@ -188,10 +199,10 @@ HC_Dx12::HC_Dx12(std::string InName, ID3D12Device* InDevice) : Shader_Dx12(InNam
         Shader_Dx12::TranslateTypelessFormats(scDesc.BufferDesc.Format); // match swapchain RTV format (can be *_SRGB)
     graphicsPsoDesc.SampleDesc = { 1, 0 };
 
-    auto result = InDevice->CreateGraphicsPipelineState(&graphicsPsoDesc, IID_PPV_ARGS(&_pipelineState));
-    if (result != S_OK)
+    // Kept by the pipeline manager, recreating the pass doesn't build it again
+    if (!CreateGraphicsPipeline(InDevice, graphicsPsoDesc))
     {
-        LOG_ERROR("CreateGraphicsPipelineState error: {:X}", (unsigned long) result);
+        LOG_ERROR("[{0}] Failed to create graphics pipeline", _name);
         return;
     }
 
@@ -199,7 +210,7 @@ HC_Dx12::HC_Dx12(std::string InName, ID3D12Device* InDevice) : Shader_Dx12(InNam
     D3D12_RESOURCE_DESC desc = CD3DX12_RESOURCE_DESC::Buffer(sizeof(InternalCompareParams));
     auto heapProps = CD3DX12_HEAP_PROPERTIES(D3D12_HEAP_TYPE_UPLOAD);
 
-    result =
+    auto result =
         InDevice->CreateCommittedResource(&heapProps, D3D12_HEAP_FLAG_NONE, &desc, D3D12_RESOURCE_STATE_GENERIC_READ,
                                           nullptr, IID_PPV_ARGS(&_constantBuffer));
 
@@ -336,7 +347,6 @@ HC_Dx12::~HC_Dx12()
     if (!_init || State::Instance().isShuttingDown)
         return;
 
-    SAFE_RELEASE(_rootSignature);
     SAFE_RELEASE(_constantBuffer);
 
     for (int i = 0; i < HC_NUM_OF_HEAPS; i++)
@@ -35,6 +35,8 @@ class HC_Dx12 : public Shader_Dx12
     bool Dispatch(IDXGISwapChain3* sc, ID3D12GraphicsCommandList* cmdList, ID3D12Resource* hudless,
                   D3D12_RESOURCE_STATES state);
 
+    static void Warmup();
+
     HC_Dx12(std::string InName, ID3D12Device* InDevice);
 
     ~HC_Dx12();
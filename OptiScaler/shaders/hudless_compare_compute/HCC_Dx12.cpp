@@ -101,6 +101,16 @@ bool HCC_Dx12::Dispatch(ID3D12GraphicsCommandList* cmdList, ID3D12Resource* hudl
     return true;
 }
 
+void HCC_Dx12::Warmup(ID3D12Device* InDevice)
+{
+    // Only used by frame generation
+    if (Config::Instance()->FGOutput.value_or_default() == FGOutput::NoFG)
+        return;
+
+    PrewarmComputePipeline(InDevice, SerializeRootSignature(2, 1, 1), HCC_cso, sizeof(HCC_cso), shaderCode.c_str(),
+                           "HudlessCompareCompute");
+}
+
 HCC_Dx12::HCC_Dx12(std::string InName, ID3D12Device* InDevice) : Shader_Dx12(InName, InDevice)
 {
     if (InDevice == nullptr)
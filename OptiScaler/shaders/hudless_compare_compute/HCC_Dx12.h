@@ -33,6 +33,8 @@ class HCC_Dx12 : public Shader_Dx12
     bool Dispatch(ID3D12GraphicsCommandList* cmdList, ID3D12Resource* hudless, ID3D12Resource* present,
                   D3D12_RESOURCE_STATES hudlessState, D3D12_RESOURCE_STATES presentState);
 
+    static void Warmup(ID3D12Device* InDevice);
+
     HCC_Dx12(std::string InName, ID3D12Device* InDevice);
 
     ~HCC_Dx12();
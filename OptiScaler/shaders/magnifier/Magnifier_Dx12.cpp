@@ -80,6 +80,12 @@ bool Magnifier_Dx12::CreateBufferResource(ID3D12Device* InDevice, ID3D12Resource
     return result;
 }
 
+void Magnifier_Dx12::Warmup(ID3D12Device* InDevice)
+{
+    PrewarmComputePipeline(InDevice, SerializeRootSignature(1, 1, 1), Magnifier_cso, sizeof(Magnifier_cso),
+                           shaderCode.c_str(), "Magnifier");
+}
+
 Magnifier_Dx12::Magnifier_Dx12(std::string InName, ID3D12Device* InDevice) : Shader_Dx12(InName, InDevice)
 {
     if (InDevice == nullptr)
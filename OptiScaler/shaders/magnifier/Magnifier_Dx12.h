@@ -33,6 +33,8 @@ class Magnifier_Dx12 : public Shader_Dx12, public Magnifier_Common
     ID3D12Resource* Buffer() { return _buffer; }
     bool CanRender() const { return _init && _buffer != nullptr; }
 
+    static void Warmup(ID3D12Device* InDevice);
+
     Magnifier_Dx12(std::string InName, ID3D12Device* InDevice);
 
     ~Magnifier_Dx12();
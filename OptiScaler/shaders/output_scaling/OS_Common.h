@@ -2,13 +2,10 @@
 
 #include "SysUtils.h"
 
-struct alignas(256) Constants
-{
-    int32_t srcWidth;
-    int32_t srcHeight;
-    int32_t destWidth;
-    int32_t destHeight;
-};
+#include <Config.h>
+#include <shaders/Shader_Common.h>
+
+#include "OS_Constants.h"
 
 // Lanczos with luminance correction
 inline static std::string downsampleCodeKaiser2 = R"(
@@ -1295,3 +1292,61 @@ void CSMain(uint3 DTid : SV_DispatchThreadID, uint3 GTid : SV_GroupThreadID, uin
     Dest[DTid.xy] = Result;
 }
 )";
+
+// Runtime compiled downscaler, FSR1 always uses the precompiled shader
+inline static const std::string& DownsampleCode(Scaler scaler)
+{
+    switch (scaler)
+    {
+    case Scaler::CatmullRom:
+        return downsampleCodeCatmull;
+
+    case Scaler::Lanczos2:
+        return downsampleCodeLanczos2;
+
+    case Scaler::Lanczos3:
+        return downsampleCodeLanczos3;
+
+    case Scaler::Kaiser2:
+        return downsampleCodeKaiser2;
+
+    case Scaler::Kaiser3:
+        return downsampleCodeKaiser3;
+
+    case Scaler::Magic:
+        return downsampleCodeMAGIC;
+
+    default:
+        return downsampleCodeBC;
+    }
+}
+
+// Same sources for Dx11 and Dx12
+inline static void WarmupOutputScaling()
+{
+    // With FSR1 upsampling is precompiled too
+    if (Config::Instance()->UsePrecompiledShaders.value_or_default())
+        return;
+
+    auto selected = Config::Instance()->OutputScalingDownscaler.value_or_default();
+
+    // Scaler is created with each feature
+    if (selected != Scaler::FSR1)
+    {
+        WarmupShader(upsampleCode.c_str(), "CSMain", "cs_5_0");
+        WarmupShader(DownsampleCode(selected).c_str(), "CSMain", "cs_5_0");
+    }
+
+    if (!Config::Instance()->OutputScalingEnabled.value_or_default())
+        return;
+
+    // Downscaler can be changed from the menu
+    if (selected == Scaler::FSR1)
+        WarmupShader(upsampleCode.c_str(), "CSMain", "cs_5_0");
+
+    for (uint32_t i = (uint32_t) Scaler::Bicubic; i < (uint32_t) Scaler::Count; i++)
+    {
+        if ((Scaler) i != selected)
+            WarmupShader(DownsampleCode((Scaler) i).c_str(), "CSMain", "cs_5_0");
+    }
+}
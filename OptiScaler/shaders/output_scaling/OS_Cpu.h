@@ -0,0 +1,1300 @@
+#pragma once
+
+#include "OS_Constants.h"
+
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#if defined(_M_X64) || defined(__x86_64__)
+#define OS_CPU_X64
+#include <immintrin.h>
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#define OS_CPU_AVX2
+#else
+#define OS_CPU_AVX2 __attribute__((target("avx2")))
+#endif
+#endif
+
+// CPU ports of the output scaling shaders (OS_Common.h and fsr1/), driven by the same Constants.
+// Scalar versions follow the HLSL and are the reference, SSE and AVX2 versions keep the order of operations
+// per channel so they match it bit for bit unless the compiler contracts the scalar code to FMA.
+// AVX2 versions process two output pixels per register.
+// Known differences to the GPU:
+//  - Bilinear taps of Bicubic and CatmullRom use exact weights, texture units round them to 8 bits
+//  - MAGIC always reads its whole footprint, the shader truncates the 32x32 LDS tile below ~1/3 ratio
+//  - FSR1 runs EASU for every pixel, the shader falls back to bilinear outside of the given radius
+//  - sin, exp and sqrt come from the C runtime
+// No platform dependencies, images are RGBA32F.
+namespace os_cpu
+{
+
+// Same order as Scaler in Config.h
+enum class Filter : uint32_t
+{
+    FSR1,
+    Bicubic,
+    CatmullRom,
+    Lanczos2,
+    Lanczos3,
+    Kaiser2,
+    Kaiser3,
+    Magic,
+    Count
+};
+
+enum class Isa : uint32_t
+{
+    Scalar,
+    Sse,
+    Avx2,
+};
+
+inline const char* FilterName(Filter filter)
+{
+    switch (filter)
+    {
+    case Filter::FSR1:
+        return "FSR1";
+    case Filter::Bicubic:
+        return "Bicubic";
+    case Filter::CatmullRom:
+        return "CatmullRom";
+    case Filter::Lanczos2:
+        return "Lanczos2";
+    case Filter::Lanczos3:
+        return "Lanczos3";
+    case Filter::Kaiser2:
+        return "Kaiser2";
+    case Filter::Kaiser3:
+        return "Kaiser3";
+    case Filter::Magic:
+        return "MAGIC";
+    default:
+        return "Unknown";
+    }
+}
+
+inline const char* IsaName(Isa isa)
+{
+    switch (isa)
+    {
+    case Isa::Sse:
+        return "SSE";
+    case Isa::Avx2:
+        return "AVX2";
+    default:
+        return "Scalar";
+    }
+}
+
+// Best instruction set of the running CPU
+inline Isa DetectIsa()
+{
+#ifdef OS_CPU_X64
+    static const Isa isa = []
+    {
+#ifdef _MSC_VER
+        int info[4] = {};
+        __cpuid(info, 1);
+
+        // AVX and OS support for YMM state
+        if ((info[2] & (1 << 27)) == 0 || (info[2] & (1 << 28)) == 0 || (_xgetbv(0) & 6) != 6)
+            return Isa::Sse;
+
+        __cpuidex(info, 7, 0);
+        return (info[1] & (1 << 5)) != 0 ? Isa::Avx2 : Isa::Sse;
+#else
+        __builtin_cpu_init();
+        return __builtin_cpu_supports("avx2") ? Isa::Avx2 : Isa::Sse;
+#endif
+    }();
+
+    return isa;
+#else
+    return Isa::Scalar;
+#endif
+}
+
+struct Image
+{
+    int32_t Width = 0;
+    int32_t Height = 0;
+
+    // RGBA rows without padding
+    std::vector<float> Data;
+
+    Image() = default;
+    Image(int32_t width, int32_t height) : Width(width), Height(height), Data((size_t) width * height * 4, 0.0f) {}
+
+    float* Row(int32_t y) { return Data.data() + (size_t) y * Width * 4; }
+    const float* Row(int32_t y) const { return Data.data() + (size_t) y * Width * 4; }
+};
+
+// Kernels, same names and constants as in the HLSL
+
+inline float Sinc(float x)
+{
+    x *= 3.1415926535f;
+
+    if (std::abs(x) < 1e-5f)
+        return 1.0f;
+
+    return std::sin(x) / x;
+}
+
+// Modified Bessel function I0, Cephes style polynomial
+inline float I0(float x)
+{
+    float ax = std::abs(x);
+
+    if (ax < 3.75f)
+    {
+        float t = x / 3.75f;
+        float t2 = t * t;
+        return 1.0f +
+               t2 * (3.5156229f +
+                     t2 * (3.0899424f + t2 * (1.2067492f + t2 * (0.2659732f + t2 * (0.0360768f + t2 * 0.0045813f)))));
+    }
+
+    float t = 3.75f / ax;
+    return (std::exp(ax) / std::sqrt(ax)) *
+           (0.39894228f +
+            t * (0.01328592f +
+                 t * (0.00225319f +
+                      t * (-0.00157565f +
+                           t * (0.00916281f +
+                                t * (-0.02057706f + t * (0.02635537f + t * (-0.01647633f + t * 0.00392377f))))))));
+}
+
+inline float KaiserWindow(float x, float a, float beta, float invI0Beta)
+{
+    float ax = std::abs(x);
+
+    if (ax >= a)
+        return 0.0f;
+
+    float r = ax / a;
+    float t = std::sqrt(std::clamp(1.0f - r * r, 0.0f, 1.0f));
+
+    return I0(beta * t) * invI0Beta;
+}
+
+inline float Kaiser(float x, float a, float beta, float invI0Beta)
+{
+    return Sinc(x) * KaiserWindow(x, a, beta, invI0Beta);
+}
+
+inline float Lanczos(float x, float a)
+{
+    if (std::abs(x) >= a)
+        return 0.0f;
+
+    return Sinc(x) * Sinc(x / a);
+}
+
+inline float CubicKeys(float x, float a)
+{
+    x = std::abs(x);
+    float x2 = x * x;
+    float x3 = x2 * x;
+
+    if (x < 1.0f)
+        return (a + 2.0f) * x3 - (a + 3.0f) * x2 + 1.0f;
+
+    if (x < 2.0f)
+        return a * x3 - 5.0f * a * x2 + 8.0f * a * x - 4.0f * a;
+
+    return 0.0f;
+}
+
+inline float MagicKernel(float x)
+{
+    if (std::abs(x) >= 1.5f)
+        return 0.0f;
+
+    if (x <= -0.5f)
+    {
+        float t = x + 1.5f;
+        return 0.5f * t * t;
+    }
+
+    if (x < 0.5f)
+        return 0.75f - x * x;
+
+    float t = x - 1.5f;
+    return 0.5f * t * t;
+}
+
+// APrxLoRcpF1 and APrxLoRsqF1 of ffx_a.h
+inline float PrxLoRcp(float a) { return std::bit_cast<float>(0x7ef07ebbu - std::bit_cast<uint32_t>(a)); }
+inline float PrxLoRsq(float a) { return std::bit_cast<float>(0x5f347d74u - (std::bit_cast<uint32_t>(a) >> 1)); }
+
+// Source taps of one axis, output coordinate o uses Count entries starting at o * Count.
+// Indices are clamped to the image and weights are normalized like in the shaders.
+struct AxisTaps
+{
+    int32_t Count = 0;
+    std::vector<int32_t> Index;
+    std::vector<float> Weight;
+};
+
+// Lanczos2/3 and Kaiser2/3
+inline AxisTaps WindowTaps(Filter filter, int32_t srcSize, int32_t dstSize)
+{
+    const bool wide = filter == Filter::Lanczos3 || filter == Filter::Kaiser3;
+    const bool kaiser = filter == Filter::Kaiser2 || filter == Filter::Kaiser3;
+    const int32_t radius = wide ? 3 : 2;
+    const float a = (float) radius;
+    const float beta = wide ? 6.0f : 5.0f;
+    const float invI0Beta = 1.0f / I0(beta);
+    const float scale = (float) srcSize / (float) dstSize;
+
+    AxisTaps taps;
+    taps.Count = radius * 2;
+    taps.Index.resize((size_t) dstSize * taps.Count);
+    taps.Weight.resize(taps.Index.size());
+
+    for (int32_t o = 0; o < dstSize; o++)
+    {
+        float srcPos = ((float) o + 0.5f) * scale - 0.5f;
+        float ip = std::floor(srcPos);
+        float f = srcPos - ip;
+        int32_t base = (int32_t) ip - (radius - 1);
+
+        auto index = &taps.Index[(size_t) o * taps.Count];
+        auto weight = &taps.Weight[(size_t) o * taps.Count];
+        float sum = 0.0f;
+
+        for (int32_t i = 0; i < taps.Count; i++)
+        {
+            float d = (float) i - (float) (radius - 1) - f;
+            weight[i] = kaiser ? Kaiser(d, a, beta, invI0Beta) : Lanczos(d, a);
+            sum += weight[i];
+            index[i] = std::clamp(base + i, 0, srcSize - 1);
+        }
+
+        float invSum = sum != 0.0f ? 1.0f / sum : 0.0f;
+
+        for (int32_t i = 0; i < taps.Count; i++)
+            weight[i] *= invSum;
+    }
+
+    return taps;
+}
+
+// MAGIC, tap count varies per output so shorter footprints are padded with zero weights
+inline AxisTaps MagicTaps(int32_t srcSize, int32_t dstSize)
+{
+    constexpr float R = 1.5f;
+    constexpr int32_t MaxTaps = 12;
+    const float k = (float) dstSize / (float) srcSize;
+
+    std::vector<int32_t> first(dstSize);
+    std::vector<int32_t> count(dstSize);
+
+    AxisTaps taps;
+
+    for (int32_t o = 0; o < dstSize; o++)
+    {
+        float oc = (float) o + 0.5f;
+        int32_t x0 = std::clamp((int32_t) std::ceil((oc - R) / k - 0.5f), 0, srcSize - 1);
+        int32_t x1 = std::clamp((int32_t) std::floor((oc + R) / k - 0.5f), 0, srcSize - 1);
+
+        first[o] = x0;
+        count[o] = std::clamp(x1 - x0 + 1, 1, MaxTaps);
+        taps.Count = std::max(taps.Count, count[o]);
+    }
+
+    taps.Index.resize((size_t) dstSize * taps.Count);
+    taps.Weight.resize(taps.Index.size());
+
+    for (int32_t o = 0; o < dstSize; o++)
+    {
+        float oc = (float) o + 0.5f;
+        float uBase = k * ((float) first[o] + 0.5f) - oc;
+
+        auto index = &taps.Index[(size_t) o * taps.Count];
+        auto weight = &taps.Weight[(size_t) o * taps.Count];
+        float sum = 0.0f;
+
+        for (int32_t i = 0; i < taps.Count; i++)
+        {
+            weight[i] = i < count[o] ? MagicKernel(uBase + k * (float) i) : 0.0f;
+            sum += weight[i];
+            index[i] = std::min(first[o] + i, srcSize - 1);
+        }
+
+        float invSum = sum > 0.0f ? 1.0f / sum : 0.0f;
+
+        for (int32_t i = 0; i < taps.Count; i++)
+            weight[i] *= invSum;
+    }
+
+    return taps;
+}
+
+// Bicubic and CatmullRom fold 4 cubic taps into 2 bilinear taps per axis
+struct BilinearTaps
+{
+    // 4 per output: both texels of the w01 tap, then of the w23 tap
+    std::vector<int32_t> Index;
+
+    // 2 per output: fraction between the texels of each tap
+    std::vector<float> Frac;
+
+    // 2 per output: w01, w23
+    std::vector<float> Weight;
+};
+
+inline BilinearTaps CubicTaps(Filter filter, int32_t srcSize, int32_t dstSize)
+{
+    const float a = filter == Filter::CatmullRom ? -0.45f : -0.6f;
+    const float scale = (float) srcSize / (float) dstSize;
+
+    BilinearTaps taps;
+    taps.Index.resize((size_t) dstSize * 4);
+    taps.Frac.resize((size_t) dstSize * 2);
+    taps.Weight.resize((size_t) dstSize * 2);
+
+    for (int32_t o = 0; o < dstSize; o++)
+    {
+        float srcPos = ((float) o + 0.5f) * scale - 0.5f;
+        float ip = std::floor(srcPos);
+        float t = srcPos - ip;
+
+        // Same as the shaders, together with o01 = -1 + ... this puts both taps one texel early
+        // so the output is shifted up and left by one source texel
+        float base = ip - 1.0f;
+
+        float w0 = CubicKeys(1.0f + t, a);
+        float w1 = CubicKeys(t, a);
+        float w2 = CubicKeys(1.0f - t, a);
+        float w3 = CubicKeys(2.0f - t, a);
+
+        float w01 = w0 + w1;
+        float w23 = w2 + w3;
+
+        float invW01 = w01 != 0.0f ? 1.0f / w01 : 0.0f;
+        float invW23 = w23 != 0.0f ? 1.0f / w23 : 0.0f;
+
+        // Where the sampler filters, uv * size - 0.5
+        float pos[2] = { base + (-1.0f + w1 * invW01), base + (1.0f + w3 * invW23) };
+
+        for (int32_t i = 0; i < 2; i++)
+        {
+            float first = std::floor(pos[i]);
+            taps.Frac[o * 2 + i] = pos[i] - first;
+            taps.Index[o * 4 + i * 2] = std::clamp((int32_t) first, 0, srcSize - 1);
+            taps.Index[o * 4 + i * 2 + 1] = std::clamp((int32_t) first + 1, 0, srcSize - 1);
+        }
+
+        taps.Weight[o * 2] = w01;
+        taps.Weight[o * 2 + 1] = w23;
+    }
+
+    return taps;
+}
+
+// FsrEasuCon with the viewport covering the whole input. The other constants only locate the gathers.
+struct EasuCon
+{
+    float ScaleX;
+    float ScaleY;
+    float OffsetX;
+    float OffsetY;
+};
+
+inline EasuCon EasuConstants(const Constants& constants)
+{
+    float rcpX = 1.0f / (float) constants.destWidth;
+    float rcpY = 1.0f / (float) constants.destHeight;
+
+    return { (float) constants.srcWidth * rcpX, (float) constants.srcHeight * rcpY,
+             0.5f * (float) constants.srcWidth * rcpX - 0.5f, 0.5f * (float) constants.srcHeight * rcpY - 0.5f };
+}
+
+// EASU taps relative to 'f' in accumulation order: b c i j f e k l h g o n
+//    b c
+//  e f g h
+//  i j k l
+//    n o
+inline constexpr int32_t EasuTapX[12] = { 0, 1, -1, 0, 0, -1, 1, 2, 2, 1, 1, 0 };
+inline constexpr int32_t EasuTapY[12] = { -1, -1, 1, 1, 0, 0, 1, 1, 0, 0, 2, 2 };
+
+// Kernel shape after the direction and length analysis
+struct EasuShape
+{
+    float DirX;
+    float DirY;
+    float LenX;
+    float LenY;
+    float Lob;
+    float Clp;
+};
+
+namespace detail
+{
+
+inline float Saturate(float value) { return std::clamp(value, 0.0f, 1.0f); }
+
+// Texels of the 12 EASU taps and their luma times 2
+inline void EasuFetch(const Image& src, float ppx, float ppy, const float** tap, float* luma)
+{
+    int32_t fx = (int32_t) std::floor(ppx);
+    int32_t fy = (int32_t) std::floor(ppy);
+
+    for (int32_t t = 0; t < 12; t++)
+    {
+        int32_t x = std::clamp(fx + EasuTapX[t], 0, src.Width - 1);
+        int32_t y = std::clamp(fy + EasuTapY[t], 0, src.Height - 1);
+        tap[t] = src.Row(y) + (size_t) x * 4;
+        luma[t] = tap[t][2] * 0.5f + (tap[t][0] * 0.5f + tap[t][1]);
+    }
+}
+
+// FsrEasuSetF
+inline void EasuSet(float& dirX, float& dirY, float& len, float w, float lA, float lB, float lC, float lD, float lE)
+{
+    float dc = lD - lC;
+    float cb = lC - lB;
+    float lenX = PrxLoRcp(std::max(std::abs(dc), std::abs(cb)));
+    float dX = lD - lB;
+    dirX += dX * w;
+    lenX = Saturate(std::abs(dX) * lenX);
+    lenX *= lenX;
+    len += lenX * w;
+
+    float ec = lE - lC;
+    float ca = lC - lA;
+    float lenY = PrxLoRcp(std::max(std::abs(ec), std::abs(ca)));
+    float dY = lE - lA;
+    dirY += dY * w;
+    lenY = Saturate(std::abs(dY) * lenY);
+    lenY *= lenY;
+    len += lenY * w;
+}
+
+// Normalizes the direction and shapes the kernel, rest of FsrEasuF before the accumulation
+inline EasuShape EasuShapeOf(float dirX, float dirY, float len)
+{
+    float dirR = dirX * dirX + dirY * dirY;
+    bool zro = dirR < 1.0f / 32768.0f;
+    dirR = zro ? 1.0f : PrxLoRsq(dirR);
+    dirX = zro ? 1.0f : dirX;
+    dirX *= dirR;
+    dirY *= dirR;
+
+    len = len * 0.5f;
+    len *= len;
+
+    float stretch = (dirX * dirX + dirY * dirY) * PrxLoRcp(std::max(std::abs(dirX), std::abs(dirY)));
+
+    EasuShape shape;
+    shape.DirX = dirX;
+    shape.DirY = dirY;
+    shape.LenX = 1.0f + (stretch - 1.0f) * len;
+    shape.LenY = 1.0f + -0.5f * len;
+    shape.Lob = 0.5f + (float) ((1.0 / 4.0 - 0.04) - 0.5) * len;
+    shape.Clp = PrxLoRcp(shape.Lob);
+    return shape;
+}
+
+// FsrEasuTapF without the accumulation
+inline float EasuTapWeight(float offX, float offY, const EasuShape& shape)
+{
+    float vx = (offX * shape.DirX) + (offY * shape.DirY);
+    float vy = (offX * (-shape.DirY)) + (offY * shape.DirX);
+    vx *= shape.LenX;
+    vy *= shape.LenY;
+
+    float d2 = std::min(vx * vx + vy * vy, shape.Clp);
+    float wB = 0.4f * d2 + -1.0f;
+    float wA = shape.Lob * d2 + -1.0f;
+    wB *= wB;
+    wA *= wA;
+    wB = 1.5625f * wB + -0.5625f;
+    return wB * wA;
+}
+
+// Bilinear corner weights in FsrEasuSetF order s t u v
+inline void EasuCorners(float ppx, float ppy, float* w)
+{
+    w[0] = (1.0f - ppx) * (1.0f - ppy);
+    w[1] = ppx * (1.0f - ppy);
+    w[2] = (1.0f - ppx) * ppy;
+    w[3] = ppx * ppy;
+}
+
+// Tap indices of the luma inputs A..E of each FsrEasuSetF call
+//  s: b e f g j, t: c f g h k, u: f i j k n, v: g j k l o
+inline constexpr int32_t EasuSetTaps[5][4] = {
+    { 0, 1, 4, 9 }, { 5, 4, 2, 3 }, { 4, 9, 3, 6 }, { 9, 8, 6, 7 }, { 3, 6, 11, 10 }
+};
+
+// Scalar reference
+
+inline void DirectScalar(const Image& src, Image& dst, const AxisTaps& tx, const AxisTaps& ty, bool clampToTaps)
+{
+    for (int32_t oy = 0; oy < dst.Height; oy++)
+    {
+        auto iy = &ty.Index[(size_t) oy * ty.Count];
+        auto wy = &ty.Weight[(size_t) oy * ty.Count];
+        auto out = dst.Row(oy);
+
+        for (int32_t ox = 0; ox < dst.Width; ox++, out += 4)
+        {
+            auto ix = &tx.Index[(size_t) ox * tx.Count];
+            auto wx = &tx.Weight[(size_t) ox * tx.Count];
+
+            float acc[3] = {};
+            float mn[3] = { 1e30f, 1e30f, 1e30f };
+            float mx[3] = { -1e30f, -1e30f, -1e30f };
+
+            for (int32_t j = 0; j < ty.Count; j++)
+            {
+                auto row = src.Row(iy[j]);
+
+                for (int32_t i = 0; i < tx.Count; i++)
+                {
+                    auto s = row + (size_t) ix[i] * 4;
+                    float w = wx[i] * wy[j];
+
+                    for (int32_t c = 0; c < 3; c++)
+                    {
+                        acc[c] += s[c] * w;
+                        mn[c] = std::min(mn[c], s[c]);
+                        mx[c] = std::max(mx[c], s[c]);
+                    }
+                }
+            }
+
+            for (int32_t c = 0; c < 3; c++)
+                out[c] = clampToTaps ? std::min(std::max(acc[c], mn[c]), mx[c]) : acc[c];
+
+            out[3] = 1.0f;
+        }
+    }
+}
+
+inline void CubicScalar(const Image& src, Image& dst, const BilinearTaps& tx, const BilinearTaps& ty)
+{
+    auto bilinear = [](const float* r0, const float* r1, const int32_t* ix, float fx, float fy, float* out)
+    {
+        auto a = r0 + (size_t) ix[0] * 4;
+        auto b = r0 + (size_t) ix[1] * 4;
+        auto c = r1 + (size_t) ix[0] * 4;
+        auto d = r1 + (size_t) ix[1] * 4;
+
+        for (int32_t i = 0; i < 3; i++)
+            out[i] = (a[i] * (1.0f - fx) + b[i] * fx) * (1.0f - fy) + (c[i] * (1.0f - fx) + d[i] * fx) * fy;
+    };
+
+    for (int32_t oy = 0; oy < dst.Height; oy++)
+    {
+        auto iy = &ty.Index[(size_t) oy * 4];
+        auto fy = &ty.Frac[(size_t) oy * 2];
+        auto wy = &ty.Weight[(size_t) oy * 2];
+        auto out = dst.Row(oy);
+
+        for (int32_t ox = 0; ox < dst.Width; ox++, out += 4)
+        {
+            auto ix = &tx.Index[(size_t) ox * 4];
+            auto fx = &tx.Frac[(size_t) ox * 2];
+            auto wx = &tx.Weight[(size_t) ox * 2];
+
+            float s00[3], s10[3], s01[3], s11[3];
+            bilinear(src.Row(iy[0]), src.Row(iy[1]), ix, fx[0], fy[0], s00);
+            bilinear(src.Row(iy[0]), src.Row(iy[1]), ix + 2, fx[1], fy[0], s10);
+            bilinear(src.Row(iy[2]), src.Row(iy[3]), ix, fx[0], fy[1], s01);
+            bilinear(src.Row(iy[2]), src.Row(iy[3]), ix + 2, fx[1], fy[1], s11);
+
+            for (int32_t c = 0; c < 3; c++)
+            {
+                float rgb = (s00[c] * wx[0] + s10[c] * wx[1]) * wy[0] + (s01[c] * wx[0] + s11[c] * wx[1]) * wy[1];
+                float mn = std::min(std::min(s00[c], s10[c]), std::min(s01[c], s11[c]));
+                float mx = std::max(std::max(s00[c], s10[c]), std::max(s01[c], s11[c]));
+                out[c] = std::min(std::max(rgb, mn), mx);
+            }
+
+            out[3] = 1.0f;
+        }
+    }
+}
+
+inline void EasuScalar(const Image& src, Image& dst, const EasuCon& con)
+{
+    for (int32_t oy = 0; oy < dst.Height; oy++)
+    {
+        auto out = dst.Row(oy);
+
+        for (int32_t ox = 0; ox < dst.Width; ox++, out += 4)
+        {
+            float ppx = (float) ox * con.ScaleX + con.OffsetX;
+            float ppy = (float) oy * con.ScaleY + con.OffsetY;
+
+            const float* tap[12];
+            float l[12];
+            EasuFetch(src, ppx, ppy, tap, l);
+
+            ppx -= std::floor(ppx);
+            ppy -= std::floor(ppy);
+
+            float corner[4];
+            EasuCorners(ppx, ppy, corner);
+
+            float dirX = 0.0f;
+            float dirY = 0.0f;
+            float len = 0.0f;
+
+            for (int32_t i = 0; i < 4; i++)
+            {
+                EasuSet(dirX, dirY, len, corner[i], l[EasuSetTaps[0][i]], l[EasuSetTaps[1][i]], l[EasuSetTaps[2][i]],
+                        l[EasuSetTaps[3][i]], l[EasuSetTaps[4][i]]);
+            }
+
+            auto shape = EasuShapeOf(dirX, dirY, len);
+
+            float aC[3] = {};
+            float aW = 0.0f;
+
+            for (int32_t t = 0; t < 12; t++)
+            {
+                float w = EasuTapWeight((float) EasuTapX[t] - ppx, (float) EasuTapY[t] - ppy, shape);
+
+                for (int32_t c = 0; c < 3; c++)
+                    aC[c] += tap[t][c] * w;
+
+                aW += w;
+            }
+
+            // Min and max of f g j k
+            for (int32_t c = 0; c < 3; c++)
+            {
+                float mn = std::min(std::min(tap[4][c], tap[9][c]), std::min(tap[3][c], tap[6][c]));
+                float mx = std::max(std::max(tap[4][c], tap[9][c]), std::max(tap[3][c], tap[6][c]));
+                out[c] = std::min(mx, std::max(mn, aC[c] * (1.0f / aW)));
+            }
+
+            out[3] = 1.0f;
+        }
+    }
+}
+
+#ifdef OS_CPU_X64
+
+// SSE, one RGBA pixel per register
+
+inline __m128 Clamp(__m128 value, __m128 mn, __m128 mx) { return _mm_min_ps(_mm_max_ps(value, mn), mx); }
+
+inline void StorePixel(float* out, __m128 value)
+{
+    _mm_storeu_ps(out, value);
+    out[3] = 1.0f;
+}
+
+inline void DirectSse(const Image& src, Image& dst, const AxisTaps& tx, const AxisTaps& ty, bool clampToTaps)
+{
+    for (int32_t oy = 0; oy < dst.Height; oy++)
+    {
+        auto iy = &ty.Index[(size_t) oy * ty.Count];
+        auto wy = &ty.Weight[(size_t) oy * ty.Count];
+        auto out = dst.Row(oy);
+
+        for (int32_t ox = 0; ox < dst.Width; ox++, out += 4)
+        {
+            auto ix = &tx.Index[(size_t) ox * tx.Count];
+            auto wx = &tx.Weight[(size_t) ox * tx.Count];
+
+            __m128 acc = _mm_setzero_ps();
+            __m128 mn = _mm_set1_ps(1e30f);
+            __m128 mx = _mm_set1_ps(-1e30f);
+
+            for (int32_t j = 0; j < ty.Count; j++)
+            {
+                auto row = src.Row(iy[j]);
+
+                for (int32_t i = 0; i < tx.Count; i++)
+                {
+                    __m128 s = _mm_loadu_ps(row + (size_t) ix[i] * 4);
+                    acc = _mm_add_ps(acc, _mm_mul_ps(s, _mm_set1_ps(wx[i] * wy[j])));
+                    mn = _mm_min_ps(mn, s);
+                    mx = _mm_max_ps(mx, s);
+                }
+            }
+
+            StorePixel(out, clampToTaps ? Clamp(acc, mn, mx) : acc);
+        }
+    }
+}
+
+inline __m128 BilinearSse(const float* r0, const float* r1, const int32_t* ix, float fx, float fy)
+{
+    __m128 fx1 = _mm_set1_ps(fx);
+    __m128 fx0 = _mm_set1_ps(1.0f - fx);
+
+    __m128 top = _mm_add_ps(_mm_mul_ps(_mm_loadu_ps(r0 + (size_t) ix[0] * 4), fx0),
+                            _mm_mul_ps(_mm_loadu_ps(r0 + (size_t) ix[1] * 4), fx1));
+    __m128 bottom = _mm_add_ps(_mm_mul_ps(_mm_loadu_ps(r1 + (size_t) ix[0] * 4), fx0),
+                               _mm_mul_ps(_mm_loadu_ps(r1 + (size_t) ix[1] * 4), fx1));
+
+    return _mm_add_ps(_mm_mul_ps(top, _mm_set1_ps(1.0f - fy)), _mm_mul_ps(bottom, _mm_set1_ps(fy)));
+}
+
+inline __m128 CubicCombine(__m128 s00, __m128 s10, __m128 s01, __m128 s11, const float* wx, const float* wy)
+{
+    __m128 wx01 = _mm_set1_ps(wx[0]);
+    __m128 wx23 = _mm_set1_ps(wx[1]);
+
+    __m128 top = _mm_mul_ps(_mm_add_ps(_mm_mul_ps(s00, wx01), _mm_mul_ps(s10, wx23)), _mm_set1_ps(wy[0]));
+    __m128 bottom = _mm_mul_ps(_mm_add_ps(_mm_mul_ps(s01, wx01), _mm_mul_ps(s11, wx23)), _mm_set1_ps(wy[1]));
+
+    __m128 mn = _mm_min_ps(_mm_min_ps(s00, s10), _mm_min_ps(s01, s11));
+    __m128 mx = _mm_max_ps(_mm_max_ps(s00, s10), _mm_max_ps(s01, s11));
+    return Clamp(_mm_add_ps(top, bottom), mn, mx);
+}
+
+inline void CubicSse(const Image& src, Image& dst, const BilinearTaps& tx, const BilinearTaps& ty)
+{
+    for (int32_t oy = 0; oy < dst.Height; oy++)
+    {
+        auto iy = &ty.Index[(size_t) oy * 4];
+        auto fy = &ty.Frac[(size_t) oy * 2];
+        auto wy = &ty.Weight[(size_t) oy * 2];
+        auto r0 = src.Row(iy[0]);
+        auto r1 = src.Row(iy[1]);
+        auto r2 = src.Row(iy[2]);
+        auto r3 = src.Row(iy[3]);
+        auto out = dst.Row(oy);
+
+        for (int32_t ox = 0; ox < dst.Width; ox++, out += 4)
+        {
+            auto ix = &tx.Index[(size_t) ox * 4];
+            auto fx = &tx.Frac[(size_t) ox * 2];
+            auto wx = &tx.Weight[(size_t) ox * 2];
+
+            __m128 s00 = BilinearSse(r0, r1, ix, fx[0], fy[0]);
+            __m128 s10 = BilinearSse(r0, r1, ix + 2, fx[1], fy[0]);
+            __m128 s01 = BilinearSse(r2, r3, ix, fx[0], fy[1]);
+            __m128 s11 = BilinearSse(r2, r3, ix + 2, fx[1], fy[1]);
+
+            StorePixel(out, CubicCombine(s00, s10, s01, s11, wx, wy));
+        }
+    }
+}
+
+// FsrEasuSetF for the 4 corners at once, sums are added up in the scalar order
+inline void EasuSetSse(const float* l, const float* corner, float& dirX, float& dirY, float& len)
+{
+    const __m128 sign = _mm_set1_ps(-0.0f);
+    const __m128i rcp = _mm_set1_epi32(0x7ef07ebb);
+
+    __m128 in[5];
+
+    for (int32_t i = 0; i < 5; i++)
+    {
+        auto t = EasuSetTaps[i];
+        in[i] = _mm_setr_ps(l[t[0]], l[t[1]], l[t[2]], l[t[3]]);
+    }
+
+    __m128 w = _mm_loadu_ps(corner);
+
+    // Gradient across the centre luma, D C B on x and E C A on y
+    auto axis = [&](__m128 next, __m128 centre, __m128 prev, float* dirW, float* lenW)
+    {
+        __m128 dc = _mm_sub_ps(next, centre);
+        __m128 cb = _mm_sub_ps(centre, prev);
+        __m128 lenV = _mm_max_ps(_mm_andnot_ps(sign, dc), _mm_andnot_ps(sign, cb));
+        lenV = _mm_castsi128_ps(_mm_sub_epi32(rcp, _mm_castps_si128(lenV)));
+        __m128 d = _mm_sub_ps(next, prev);
+        _mm_storeu_ps(dirW, _mm_mul_ps(d, w));
+        lenV = _mm_mul_ps(_mm_andnot_ps(sign, d), lenV);
+        lenV = _mm_min_ps(_mm_max_ps(lenV, _mm_setzero_ps()), _mm_set1_ps(1.0f));
+        lenV = _mm_mul_ps(lenV, lenV);
+        _mm_storeu_ps(lenW, _mm_mul_ps(lenV, w));
+    };
+
+    float dirXW[4], dirYW[4], lenXW[4], lenYW[4];
+    axis(in[3], in[2], in[1], dirXW, lenXW);
+    axis(in[4], in[2], in[0], dirYW, lenYW);
+
+    for (int32_t i = 0; i < 4; i++)
+    {
+        dirX += dirXW[i];
+        len += lenXW[i];
+        dirY += dirYW[i];
+        len += lenYW[i];
+    }
+}
+
+// FsrEasuTapF weights of 4 taps
+inline __m128 EasuWeightsSse(__m128 offX, __m128 offY, const EasuShape& shape)
+{
+    __m128 dirX = _mm_set1_ps(shape.DirX);
+    __m128 dirY = _mm_set1_ps(shape.DirY);
+
+    __m128 vx = _mm_add_ps(_mm_mul_ps(offX, dirX), _mm_mul_ps(offY, dirY));
+    __m128 vy = _mm_add_ps(_mm_mul_ps(offX, _mm_set1_ps(-shape.DirY)), _mm_mul_ps(offY, dirX));
+    vx = _mm_mul_ps(vx, _mm_set1_ps(shape.LenX));
+    vy = _mm_mul_ps(vy, _mm_set1_ps(shape.LenY));
+
+    __m128 d2 = _mm_min_ps(_mm_add_ps(_mm_mul_ps(vx, vx), _mm_mul_ps(vy, vy)), _mm_set1_ps(shape.Clp));
+    __m128 wB = _mm_add_ps(_mm_mul_ps(_mm_set1_ps(0.4f), d2), _mm_set1_ps(-1.0f));
+    __m128 wA = _mm_add_ps(_mm_mul_ps(_mm_set1_ps(shape.Lob), d2), _mm_set1_ps(-1.0f));
+    wB = _mm_mul_ps(wB, wB);
+    wA = _mm_mul_ps(wA, wA);
+    wB = _mm_add_ps(_mm_mul_ps(_mm_set1_ps(1.5625f), wB), _mm_set1_ps(-0.5625f));
+    return _mm_mul_ps(wB, wA);
+}
+
+inline void EasuSse(const Image& src, Image& dst, const EasuCon& con)
+{
+    for (int32_t oy = 0; oy < dst.Height; oy++)
+    {
+        auto out = dst.Row(oy);
+
+        for (int32_t ox = 0; ox < dst.Width; ox++, out += 4)
+        {
+            float ppx = (float) ox * con.ScaleX + con.OffsetX;
+            float ppy = (float) oy * con.ScaleY + con.OffsetY;
+
+            const float* tap[12];
+            float l[12];
+            EasuFetch(src, ppx, ppy, tap, l);
+
+            ppx -= std::floor(ppx);
+            ppy -= std::floor(ppy);
+
+            float corner[4];
+            EasuCorners(ppx, ppy, corner);
+
+            float dirX = 0.0f;
+            float dirY = 0.0f;
+            float len = 0.0f;
+            EasuSetSse(l, corner, dirX, dirY, len);
+
+            auto shape = EasuShapeOf(dirX, dirY, len);
+
+            alignas(16) float w[12];
+            __m128 ppxV = _mm_set1_ps(ppx);
+            __m128 ppyV = _mm_set1_ps(ppy);
+
+            for (int32_t t = 0; t < 12; t += 4)
+            {
+                __m128 offX = _mm_sub_ps(_mm_setr_ps((float) EasuTapX[t], (float) EasuTapX[t + 1],
+                                                     (float) EasuTapX[t + 2], (float) EasuTapX[t + 3]),
+                                         ppxV);
+                __m128 offY = _mm_sub_ps(_mm_setr_ps((float) EasuTapY[t], (float) EasuTapY[t + 1],
+                                                     (float) EasuTapY[t + 2], (float) EasuTapY[t + 3]),
+                                         ppyV);
+                _mm_store_ps(w + t, EasuWeightsSse(offX, offY, shape));
+            }
+
+            __m128 aC = _mm_setzero_ps();
+            float aW = 0.0f;
+
+            for (int32_t t = 0; t < 12; t++)
+            {
+                aC = _mm_add_ps(aC, _mm_mul_ps(_mm_loadu_ps(tap[t]), _mm_set1_ps(w[t])));
+                aW += w[t];
+            }
+
+            __m128 f = _mm_loadu_ps(tap[4]);
+            __m128 g = _mm_loadu_ps(tap[9]);
+            __m128 j = _mm_loadu_ps(tap[3]);
+            __m128 k = _mm_loadu_ps(tap[6]);
+            __m128 mn = _mm_min_ps(_mm_min_ps(f, g), _mm_min_ps(j, k));
+            __m128 mx = _mm_max_ps(_mm_max_ps(f, g), _mm_max_ps(j, k));
+
+            StorePixel(out, _mm_min_ps(mx, _mm_max_ps(mn, _mm_mul_ps(aC, _mm_set1_ps(1.0f / aW)))));
+        }
+    }
+}
+
+// AVX2, output pixels ox and ox + 1 in the low and high half, odd widths finish with SSE
+
+OS_CPU_AVX2 inline __m256 Pair(__m128 low, __m128 high)
+{
+    return _mm256_insertf128_ps(_mm256_castps128_ps256(low), high, 1);
+}
+
+OS_CPU_AVX2 inline __m256 PairLoad(const float* low, const float* high)
+{
+    return Pair(_mm_loadu_ps(low), _mm_loadu_ps(high));
+}
+
+OS_CPU_AVX2 inline __m256 PairSet(float low, float high) { return Pair(_mm_set1_ps(low), _mm_set1_ps(high)); }
+
+OS_CPU_AVX2 inline void StorePixels(float* out, __m256 value)
+{
+    _mm256_storeu_ps(out, value);
+    out[3] = 1.0f;
+    out[7] = 1.0f;
+}
+
+OS_CPU_AVX2 inline void DirectAvx2(const Image& src, Image& dst, const AxisTaps& tx, const AxisTaps& ty,
+                                   bool clampToTaps)
+{
+    __m256 wxPair[12];
+
+    for (int32_t oy = 0; oy < dst.Height; oy++)
+    {
+        auto iy = &ty.Index[(size_t) oy * ty.Count];
+        auto wy = &ty.Weight[(size_t) oy * ty.Count];
+        auto out = dst.Row(oy);
+        int32_t ox = 0;
+
+        for (; ox + 1 < dst.Width; ox += 2, out += 8)
+        {
+            auto ixA = &tx.Index[(size_t) ox * tx.Count];
+            auto ixB = ixA + tx.Count;
+            auto wxA = &tx.Weight[(size_t) ox * tx.Count];
+            auto wxB = wxA + tx.Count;
+
+            for (int32_t i = 0; i < tx.Count; i++)
+                wxPair[i] = PairSet(wxA[i], wxB[i]);
+
+            __m256 acc = _mm256_setzero_ps();
+            __m256 mn = _mm256_set1_ps(1e30f);
+            __m256 mx = _mm256_set1_ps(-1e30f);
+
+            for (int32_t j = 0; j < ty.Count; j++)
+            {
+                auto row = src.Row(iy[j]);
+                __m256 wyj = _mm256_set1_ps(wy[j]);
+
+                for (int32_t i = 0; i < tx.Count; i++)
+                {
+                    __m256 s = PairLoad(row + (size_t) ixA[i] * 4, row + (size_t) ixB[i] * 4);
+                    acc = _mm256_add_ps(acc, _mm256_mul_ps(s, _mm256_mul_ps(wxPair[i], wyj)));
+                    mn = _mm256_min_ps(mn, s);
+                    mx = _mm256_max_ps(mx, s);
+                }
+            }
+
+            StorePixels(out, clampToTaps ? _mm256_min_ps(_mm256_max_ps(acc, mn), mx) : acc);
+        }
+
+        if (ox < dst.Width)
+        {
+            auto ix = &tx.Index[(size_t) ox * tx.Count];
+            auto wx = &tx.Weight[(size_t) ox * tx.Count];
+
+            __m128 acc = _mm_setzero_ps();
+            __m128 mn = _mm_set1_ps(1e30f);
+            __m128 mx = _mm_set1_ps(-1e30f);
+
+            for (int32_t j = 0; j < ty.Count; j++)
+            {
+                auto row = src.Row(iy[j]);
+
+                for (int32_t i = 0; i < tx.Count; i++)
+                {
+                    __m128 s = _mm_loadu_ps(row + (size_t) ix[i] * 4);
+                    acc = _mm_add_ps(acc, _mm_mul_ps(s, _mm_set1_ps(wx[i] * wy[j])));
+                    mn = _mm_min_ps(mn, s);
+                    mx = _mm_max_ps(mx, s);
+                }
+            }
+
+            StorePixel(out, clampToTaps ? Clamp(acc, mn, mx) : acc);
+        }
+    }
+}
+
+OS_CPU_AVX2 inline __m256 BilinearAvx2(const float* r0, const float* r1, const int32_t* ixA, const int32_t* ixB,
+                                       float fxA, float fxB, float fy)
+{
+    __m256 fx1 = PairSet(fxA, fxB);
+    __m256 fx0 = PairSet(1.0f - fxA, 1.0f - fxB);
+
+    __m256 top = _mm256_add_ps(_mm256_mul_ps(PairLoad(r0 + (size_t) ixA[0] * 4, r0 + (size_t) ixB[0] * 4), fx0),
+                               _mm256_mul_ps(PairLoad(r0 + (size_t) ixA[1] * 4, r0 + (size_t) ixB[1] * 4), fx1));
+    __m256 bottom = _mm256_add_ps(_mm256_mul_ps(PairLoad(r1 + (size_t) ixA[0] * 4, r1 + (size_t) ixB[0] * 4), fx0),
+                                  _mm256_mul_ps(PairLoad(r1 + (size_t) ixA[1] * 4, r1 + (size_t) ixB[1] * 4), fx1));
+
+    return _mm256_add_ps(_mm256_mul_ps(top, _mm256_set1_ps(1.0f - fy)), _mm256_mul_ps(bottom, _mm256_set1_ps(fy)));
+}
+
+OS_CPU_AVX2 inline void CubicAvx2(const Image& src, Image& dst, const BilinearTaps& tx, const BilinearTaps& ty)
+{
+    for (int32_t oy = 0; oy < dst.Height; oy++)
+    {
+        auto iy = &ty.Index[(size_t) oy * 4];
+        auto fy = &ty.Frac[(size_t) oy * 2];
+        auto wy = &ty.Weight[(size_t) oy * 2];
+        auto r0 = src.Row(iy[0]);
+        auto r1 = src.Row(iy[1]);
+        auto r2 = src.Row(iy[2]);
+        auto r3 = src.Row(iy[3]);
+        auto out = dst.Row(oy);
+        int32_t ox = 0;
+
+        for (; ox + 1 < dst.Width; ox += 2, out += 8)
+        {
+            auto ix = &tx.Index[(size_t) ox * 4];
+            auto fx = &tx.Frac[(size_t) ox * 2];
+            auto wx = &tx.Weight[(size_t) ox * 2];
+
+            __m256 s00 = BilinearAvx2(r0, r1, ix, ix + 4, fx[0], fx[2], fy[0]);
+            __m256 s10 = BilinearAvx2(r0, r1, ix + 2, ix + 6, fx[1], fx[3], fy[0]);
+            __m256 s01 = BilinearAvx2(r2, r3, ix, ix + 4, fx[0], fx[2], fy[1]);
+            __m256 s11 = BilinearAvx2(r2, r3, ix + 2, ix + 6, fx[1], fx[3], fy[1]);
+
+            __m256 wx01 = PairSet(wx[0], wx[2]);
+            __m256 wx23 = PairSet(wx[1], wx[3]);
+
+            __m256 top = _mm256_mul_ps(_mm256_add_ps(_mm256_mul_ps(s00, wx01), _mm256_mul_ps(s10, wx23)),
+                                       _mm256_set1_ps(wy[0]));
+            __m256 bottom = _mm256_mul_ps(_mm256_add_ps(_mm256_mul_ps(s01, wx01), _mm256_mul_ps(s11, wx23)),
+                                          _mm256_set1_ps(wy[1]));
+
+            __m256 mn = _mm256_min_ps(_mm256_min_ps(s00, s10), _mm256_min_ps(s01, s11));
+            __m256 mx = _mm256_max_ps(_mm256_max_ps(s00, s10), _mm256_max_ps(s01, s11));
+            StorePixels(out, _mm256_min_ps(_mm256_max_ps(_mm256_add_ps(top, bottom), mn), mx));
+        }
+
+        if (ox < dst.Width)
+        {
+            auto ix = &tx.Index[(size_t) ox * 4];
+            auto fx = &tx.Frac[(size_t) ox * 2];
+
+            __m128 s00 = BilinearSse(r0, r1, ix, fx[0], fy[0]);
+            __m128 s10 = BilinearSse(r0, r1, ix + 2, fx[1], fy[0]);
+            __m128 s01 = BilinearSse(r2, r3, ix, fx[0], fy[1]);
+            __m128 s11 = BilinearSse(r2, r3, ix + 2, fx[1], fy[1]);
+
+            StorePixel(out, CubicCombine(s00, s10, s01, s11, &tx.Weight[(size_t) ox * 2], wy));
+        }
+    }
+}
+
+// Per pixel part of EASU in front of the accumulation
+struct EasuPixel
+{
+    const float* Tap[12];
+    float PpX;
+    float PpY;
+    EasuShape Shape;
+};
+
+inline void EasuPrepare(const Image& src, const EasuCon& con, int32_t ox, int32_t oy, EasuPixel& pixel)
+{
+    float ppx = (float) ox * con.ScaleX + con.OffsetX;
+    float ppy = (float) oy * con.ScaleY + con.OffsetY;
+
+    float l[12];
+    EasuFetch(src, ppx, ppy, pixel.Tap, l);
+
+    pixel.PpX = ppx - std::floor(ppx);
+    pixel.PpY = ppy - std::floor(ppy);
+
+    float corner[4];
+    EasuCorners(pixel.PpX, pixel.PpY, corner);
+
+    float dirX = 0.0f;
+    float dirY = 0.0f;
+    float len = 0.0f;
+    EasuSetSse(l, corner, dirX, dirY, len);
+
+    pixel.Shape = EasuShapeOf(dirX, dirY, len);
+}
+
+OS_CPU_AVX2 inline void EasuAvx2(const Image& src, Image& dst, const EasuCon& con)
+{
+    EasuPixel a;
+    EasuPixel b;
+
+    for (int32_t oy = 0; oy < dst.Height; oy++)
+    {
+        auto out = dst.Row(oy);
+        int32_t ox = 0;
+
+        for (; ox + 1 < dst.Width; ox += 2, out += 8)
+        {
+            EasuPrepare(src, con, ox, oy, a);
+            EasuPrepare(src, con, ox + 1, oy, b);
+
+            // FsrEasuTapF weights, taps t..t+3 of both pixels
+            alignas(32) float w[3][8];
+
+            __m256 dirX = PairSet(a.Shape.DirX, b.Shape.DirX);
+            __m256 dirY = PairSet(a.Shape.DirY, b.Shape.DirY);
+            __m256 negDirY = PairSet(-a.Shape.DirY, -b.Shape.DirY);
+            __m256 lenX = PairSet(a.Shape.LenX, b.Shape.LenX);
+            __m256 lenY = PairSet(a.Shape.LenY, b.Shape.LenY);
+            __m256 lob = PairSet(a.Shape.Lob, b.Shape.Lob);
+            __m256 clp = PairSet(a.Shape.Clp, b.Shape.Clp);
+            __m256 ppx = PairSet(a.PpX, b.PpX);
+            __m256 ppy = PairSet(a.PpY, b.PpY);
+
+            for (int32_t t = 0; t < 12; t += 4)
+            {
+                __m128 tapX = _mm_setr_ps((float) EasuTapX[t], (float) EasuTapX[t + 1], (float) EasuTapX[t + 2],
+                                          (float) EasuTapX[t + 3]);
+                __m128 tapY = _mm_setr_ps((float) EasuTapY[t], (float) EasuTapY[t + 1], (float) EasuTapY[t + 2],
+                                          (float) EasuTapY[t + 3]);
+
+                __m256 offX = _mm256_sub_ps(Pair(tapX, tapX), ppx);
+                __m256 offY = _mm256_sub_ps(Pair(tapY, tapY), ppy);
+
+                __m256 vx = _mm256_add_ps(_mm256_mul_ps(offX, dirX), _mm256_mul_ps(offY, dirY));
+                __m256 vy = _mm256_add_ps(_mm256_mul_ps(offX, negDirY), _mm256_mul_ps(offY, dirX));
+                vx = _mm256_mul_ps(vx, lenX);
+                vy = _mm256_mul_ps(vy, lenY);
+
+                __m256 d2 = _mm256_min_ps(_mm256_add_ps(_mm256_mul_ps(vx, vx), _mm256_mul_ps(vy, vy)), clp);
+                __m256 wB = _mm256_add_ps(_mm256_mul_ps(_mm256_set1_ps(0.4f), d2), _mm256_set1_ps(-1.0f));
+                __m256 wA = _mm256_add_ps(_mm256_mul_ps(lob, d2), _mm256_set1_ps(-1.0f));
+                wB = _mm256_mul_ps(wB, wB);
+                wA = _mm256_mul_ps(wA, wA);
+                wB = _mm256_add_ps(_mm256_mul_ps(_mm256_set1_ps(1.5625f), wB), _mm256_set1_ps(-0.5625f));
+                _mm256_store_ps(w[t / 4], _mm256_mul_ps(wB, wA));
+            }
+
+            __m256 aC = _mm256_setzero_ps();
+            float aWA = 0.0f;
+            float aWB = 0.0f;
+
+            for (int32_t t = 0; t < 12; t++)
+            {
+                float wA = w[t / 4][t % 4];
+                float wB = w[t / 4][4 + t % 4];
+                aC = _mm256_add_ps(aC, _mm256_mul_ps(PairLoad(a.Tap[t], b.Tap[t]), PairSet(wA, wB)));
+                aWA += wA;
+                aWB += wB;
+            }
+
+            __m256 f = PairLoad(a.Tap[4], b.Tap[4]);
+            __m256 g = PairLoad(a.Tap[9], b.Tap[9]);
+            __m256 j = PairLoad(a.Tap[3], b.Tap[3]);
+            __m256 k = PairLoad(a.Tap[6], b.Tap[6]);
+            __m256 mn = _mm256_min_ps(_mm256_min_ps(f, g), _mm256_min_ps(j, k));
+            __m256 mx = _mm256_max_ps(_mm256_max_ps(f, g), _mm256_max_ps(j, k));
+
+            __m256 pix = _mm256_mul_ps(aC, PairSet(1.0f / aWA, 1.0f / aWB));
+            StorePixels(out, _mm256_min_ps(mx, _mm256_max_ps(mn, pix)));
+        }
+
+        if (ox < dst.Width)
+        {
+            EasuPrepare(src, con, ox, oy, a);
+
+            alignas(16) float w[12];
+
+            for (int32_t t = 0; t < 12; t += 4)
+            {
+                __m128 offX = _mm_sub_ps(_mm_setr_ps((float) EasuTapX[t], (float) EasuTapX[t + 1],
+                                                     (float) EasuTapX[t + 2], (float) EasuTapX[t + 3]),
+                                         _mm_set1_ps(a.PpX));
+                __m128 offY = _mm_sub_ps(_mm_setr_ps((float) EasuTapY[t], (float) EasuTapY[t + 1],
+                                                     (float) EasuTapY[t + 2], (float) EasuTapY[t + 3]),
+                                         _mm_set1_ps(a.PpY));
+                _mm_store_ps(w + t, EasuWeightsSse(offX, offY, a.Shape));
+            }
+
+            __m128 aC = _mm_setzero_ps();
+            float aW = 0.0f;
+
+            for (int32_t t = 0; t < 12; t++)
+            {
+                aC = _mm_add_ps(aC, _mm_mul_ps(_mm_loadu_ps(a.Tap[t]), _mm_set1_ps(w[t])));
+                aW += w[t];
+            }
+
+            __m128 f = _mm_loadu_ps(a.Tap[4]);
+            __m128 g = _mm_loadu_ps(a.Tap[9]);
+            __m128 j = _mm_loadu_ps(a.Tap[3]);
+            __m128 k = _mm_loadu_ps(a.Tap[6]);
+            __m128 mn = _mm_min_ps(_mm_min_ps(f, g), _mm_min_ps(j, k));
+            __m128 mx = _mm_max_ps(_mm_max_ps(f, g), _mm_max_ps(j, k));
+
+            StorePixel(out, _mm_min_ps(mx, _mm_max_ps(mn, _mm_mul_ps(aC, _mm_set1_ps(1.0f / aW)))));
+        }
+    }
+}
+
+#endif
+
+} // namespace detail
+
+// Runs the filter the way the output scaling pass does for these constants, dst is resized to the destination.
+// isa is lowered to what the CPU supports. False when the constants don't match src.
+inline bool Run(Filter filter, const Constants& constants, const Image& src, Image& dst, Isa isa = Isa::Avx2)
+{
+    if (constants.srcWidth <= 0 || constants.srcHeight <= 0 || constants.destWidth <= 0 ||
+        constants.destHeight <= 0 || src.Width != constants.srcWidth || src.Height != constants.srcHeight ||
+        src.Data.size() != (size_t) src.Width * src.Height * 4 || filter >= Filter::Count)
+    {
+        return false;
+    }
+
+    if (dst.Width != constants.destWidth || dst.Height != constants.destHeight)
+        dst = Image(constants.destWidth, constants.destHeight);
+
+    isa = std::min(isa, DetectIsa());
+
+    switch (filter)
+    {
+    case Filter::FSR1:
+    {
+        auto con = EasuConstants(constants);
+
+#ifdef OS_CPU_X64
+        if (isa == Isa::Avx2)
+            detail::EasuAvx2(src, dst, con);
+        else if (isa == Isa::Sse)
+            detail::EasuSse(src, dst, con);
+        else
+#endif
+            detail::EasuScalar(src, dst, con);
+
+        return true;
+    }
+
+    case Filter::Bicubic:
+    case Filter::CatmullRom:
+    {
+        auto tx = CubicTaps(filter, constants.srcWidth, constants.destWidth);
+        auto ty = CubicTaps(filter, constants.srcHeight, constants.destHeight);
+
+#ifdef OS_CPU_X64
+        if (isa == Isa::Avx2)
+            detail::CubicAvx2(src, dst, tx, ty);
+        else if (isa == Isa::Sse)
+            detail::CubicSse(src, dst, tx, ty);
+        else
+#endif
+            detail::CubicScalar(src, dst, tx, ty);
+
+        return true;
+    }
+
+    default:
+    {
+        bool magic = filter == Filter::Magic;
+        auto tx = magic ? MagicTaps(constants.srcWidth, constants.destWidth)
+                        : WindowTaps(filter, constants.srcWidth, constants.destWidth);
+        auto ty = magic ? MagicTaps(constants.srcHeight, constants.destHeight)
+                        : WindowTaps(filter, constants.srcHeight, constants.destHeight);
+
+#ifdef OS_CPU_X64
+        if (isa == Isa::Avx2)
+            detail::DirectAvx2(src, dst, tx, ty, !magic);
+        else if (isa == Isa::Sse)
+            detail::DirectSse(src, dst, tx, ty, !magic);
+        else
+#endif
+            detail::DirectScalar(src, dst, tx, ty, !magic);
+
+        return true;
+    }
+    }
+}
+
+} // namespace os_cpu
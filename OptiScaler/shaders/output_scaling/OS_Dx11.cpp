@@ -233,6 +233,8 @@ bool OS_Dx11::Dispatch(ID3D11Device* InDevice, ID3D11DeviceContext* InContext, I
     return true;
 }
 
+void OS_Dx11::Warmup() { WarmupOutputScaling(); }
+
 OS_Dx11::OS_Dx11(std::string InName, ID3D11Device* InDevice, bool InUpsample)
     : _name(InName), _device(InDevice), _upsample(InUpsample)
 {
@@ -37,6 +37,8 @@ class OS_Dx11
     bool IsUpsampling() { return _upsample; }
     bool CanRender() const { return _init && _buffer != nullptr; }
 
+    static void Warmup();
+
     OS_Dx11(std::string InName, ID3D11Device* InDevice, bool InUpsample);
 
     ~OS_Dx11();
@@ -111,6 +111,84 @@ bool OS_Dx12::Dispatch(ID3D12GraphicsCommandList* InCmdList, ID3D12Resource* InR
     return true;
 }
 
+struct OSShader
+{
+    const void* Bytecode;
+    size_t Size;
+    const char* Source;
+};
+
+static OSShader SelectShader(bool upsample, Scaler scaler)
+{
+    // don't wanna compile fsr easu on runtime :)
+    if (scaler == Scaler::FSR1)
+        return { fsr_easu_cso, sizeof(fsr_easu_cso), nullptr };
+
+    if (upsample)
+        return { bcus_cso, sizeof(bcus_cso), upsampleCode.c_str() };
+
+    auto source = DownsampleCode(scaler).c_str();
+
+    switch (scaler)
+    {
+    case Scaler::CatmullRom:
+        return { bcds_catmull_cso, sizeof(bcds_catmull_cso), source };
+
+    case Scaler::Lanczos2:
+        return { bcds_lanczos2_cso, sizeof(bcds_lanczos2_cso), source };
+
+    case Scaler::Lanczos3:
+        return { bcds_lanczos3_cso, sizeof(bcds_lanczos3_cso), source };
+
+    case Scaler::Kaiser2:
+        return { bcds_kaiser2_cso, sizeof(bcds_kaiser2_cso), source };
+
+    case Scaler::Kaiser3:
+        return { bcds_kaiser3_cso, sizeof(bcds_kaiser3_cso), source };
+
+    case Scaler::Magic:
+        return { bcds_magc_cso, sizeof(bcds_magc_cso), source };
+
+    default:
+        return { bcds_bicubic_cso, sizeof(bcds_bicubic_cso), source };
+    }
+}
+
+static CD3DX12_STATIC_SAMPLER_DESC LinearClampSampler()
+{
+    CD3DX12_STATIC_SAMPLER_DESC sampler(0);
+    sampler.Filter = D3D12_FILTER_MIN_MAG_LINEAR_MIP_POINT;
+    sampler.AddressU = sampler.AddressV = D3D12_TEXTURE_ADDRESS_MODE_CLAMP; // no sampler.AddressW ???
+    return sampler;
+}
+
+void OS_Dx12::Warmup(ID3D12Device* InDevice)
+{
+    auto sampler = LinearClampSampler();
+    auto rootSignature = SerializeRootSignature(1, 1, 1, 0, 1, &sampler);
+    auto selected = Config::Instance()->OutputScalingDownscaler.value_or_default();
+
+    auto prewarm = [&](bool upsample, Scaler scaler)
+    {
+        auto shader = SelectShader(upsample, scaler);
+        PrewarmComputePipeline(InDevice, rootSignature, shader.Bytecode, shader.Size, shader.Source, "Output Scaling");
+    };
+
+    // Scaler is created with each feature, upsampling or not depends on the ratio
+    prewarm(true, selected);
+    prewarm(false, selected);
+
+    if (!Config::Instance()->OutputScalingEnabled.value_or_default())
+        return;
+
+    // Downscaler can be changed from the menu, already queued ones are skipped
+    for (uint32_t i = (uint32_t) Scaler::FSR1; i < (uint32_t) Scaler::Count; i++)
+    {
+        prewarm(true, (Scaler) i);
+        prewarm(false, (Scaler) i);
+    }
+}
+
 OS_Dx12::OS_Dx12(std::string InName, ID3D12Device* InDevice, bool InUpsample)
     : Shader_Dx12(InName, InDevice), _upsample(InUpsample)
 {
@@ -122,9 +200,7 @@ OS_Dx12::OS_Dx12(std::string InName, ID3D12Device* InDevice, bool InUpsample)
 
     LOG_DEBUG("{0} start!", _name);
 
-    CD3DX12_STATIC_SAMPLER_DESC sampler(0);
-    sampler.Filter = D3D12_FILTER_MIN_MAG_LINEAR_MIP_POINT;
-    sampler.AddressU = sampler.AddressV = D3D12_TEXTURE_ADDRESS_MODE_CLAMP; // no sampler.AddressW ???
+    auto sampler = LinearClampSampler();
 
     if (!SetupRootSignature(InDevice, 1, 1, 1, 0, 0, 1, &sampler))
     {
@@ -137,171 +213,21 @@ OS_Dx12::OS_Dx12(std::string InName, ID3D12Device* InDevice, bool InUpsample)
     InDevice->CreateCommittedResource(&heapProps, D3D12_HEAP_FLAG_NONE, &desc, D3D12_RESOURCE_STATE_GENERIC_READ,
                                       nullptr, IID_PPV_ARGS(&_constantBuffer));
 
-    // don't wanna compile fsr easu on runtime :)
-    if (Config::Instance()->UsePrecompiledShaders.value_or_default() ||
-        Config::Instance()->OutputScalingDownscaler.value_or_default() == Scaler::FSR1)
+    auto scaler = Config::Instance()->OutputScalingDownscaler.value_or_default();
+
+    if (!_upsample && scaler != Scaler::FSR1)
     {
-        D3D12_COMPUTE_PIPELINE_STATE_DESC computePsoDesc = {};
-        computePsoDesc.pRootSignature = _rootSignature;
-        computePsoDesc.Flags = D3D12_PIPELINE_STATE_FLAG_NONE;
-
-        // fsr upscaling
-        if (Config::Instance()->OutputScalingDownscaler.value_or_default() == Scaler::FSR1)
-        {
-            computePsoDesc.CS =
-                CD3DX12_SHADER_BYTECODE(reinterpret_cast<const void*>(fsr_easu_cso), sizeof(fsr_easu_cso));
-        }
-        else
-        {
-            if (_upsample)
-            {
-                computePsoDesc.CS = CD3DX12_SHADER_BYTECODE(reinterpret_cast<const void*>(bcus_cso), sizeof(bcus_cso));
-            }
-            else
-            {
-                InNumThreadsY = 8;
-                InNumThreadsX = 8;
-
-                switch (Config::Instance()->OutputScalingDownscaler.value_or_default())
-                {
-                case Scaler::Bicubic:
-                    computePsoDesc.CS = CD3DX12_SHADER_BYTECODE(reinterpret_cast<const void*>(bcds_bicubic_cso),
-                                                                sizeof(bcds_bicubic_cso));
-
-                    break;
-
-                case Scaler::CatmullRom:
-                    computePsoDesc.CS = CD3DX12_SHADER_BYTECODE(reinterpret_cast<const void*>(bcds_catmull_cso),
-                                                                sizeof(bcds_catmull_cso));
-                    break;
-
-                case Scaler::Lanczos2:
-                    computePsoDesc.CS = CD3DX12_SHADER_BYTECODE(reinterpret_cast<const void*>(bcds_lanczos2_cso),
-                                                                sizeof(bcds_lanczos2_cso));
-                    break;
-
-                case Scaler::Lanczos3:
-                    computePsoDesc.CS = CD3DX12_SHADER_BYTECODE(reinterpret_cast<const void*>(bcds_lanczos3_cso),
-                                                                sizeof(bcds_lanczos3_cso));
-                    break;
-
-                case Scaler::Kaiser2:
-                    computePsoDesc.CS = CD3DX12_SHADER_BYTECODE(reinterpret_cast<const void*>(bcds_kaiser2_cso),
-                                                                sizeof(bcds_kaiser2_cso));
-                    break;
-
-                case Scaler::Kaiser3:
-                    computePsoDesc.CS = CD3DX12_SHADER_BYTECODE(reinterpret_cast<const void*>(bcds_kaiser3_cso),
-                                                                sizeof(bcds_kaiser3_cso));
-                    break;
-
-                case Scaler::Magic:
-                    computePsoDesc.CS =
-                        CD3DX12_SHADER_BYTECODE(reinterpret_cast<const void*>(bcds_magc_cso), sizeof(bcds_magc_cso));
-                    break;
-
-                default:
-                    computePsoDesc.CS = CD3DX12_SHADER_BYTECODE(reinterpret_cast<const void*>(bcds_bicubic_cso),
-                                                                sizeof(bcds_bicubic_cso));
-                    break;
-                }
-            }
-        }
-
-        auto hr = InDevice->CreateComputePipelineState(&computePsoDesc, __uuidof(ID3D12PipelineState*),
-                                                       (void**) &_pipelineState);
-
-        if (FAILED(hr))
-        {
-            LOG_ERROR("[{0}] CreateComputePipelineState error: {1:X}", _name, hr);
-            return;
-        }
+        InNumThreadsY = 8;
+        InNumThreadsX = 8;
     }
-    else
+
+    // Usually prewarmed after device creation
+    auto shader = SelectShader(_upsample, scaler);
+
+    if (!CreateComputePipeline(InDevice, &_pipelineState, shader.Bytecode, shader.Size, shader.Source))
     {
-        // Compile shader blobs
-        ID3DBlob* _recEncodeShader = nullptr;
-        D3D12_SHADER_BYTECODE byteCode = {};
-
-        if (_upsample)
-        {
-            _recEncodeShader = CompileShader(upsampleCode.c_str(), "CSMain", "cs_5_0");
-            byteCode = CD3DX12_SHADER_BYTECODE(reinterpret_cast<const void*>(bcus_cso), sizeof(bcus_cso));
-        }
-        else
-        {
-            InNumThreadsY = 8;
-            InNumThreadsX = 8;
-
-            switch (Config::Instance()->OutputScalingDownscaler.value_or_default())
-            {
-            case Scaler::Bicubic:
-                _recEncodeShader = CompileShader(downsampleCodeBC.c_str(), "CSMain", "cs_5_0");
-                byteCode =
-                    CD3DX12_SHADER_BYTECODE(reinterpret_cast<const void*>(bcds_bicubic_cso), sizeof(bcds_bicubic_cso));
-
-                break;
-
-            case Scaler::CatmullRom:
-                _recEncodeShader = CompileShader(downsampleCodeCatmull.c_str(), "CSMain", "cs_5_0");
-                byteCode =
-                    CD3DX12_SHADER_BYTECODE(reinterpret_cast<const void*>(bcds_catmull_cso), sizeof(bcds_catmull_cso));
-
-                break;
-
-            case Scaler::Lanczos2:
-                _recEncodeShader = CompileShader(downsampleCodeLanczos2.c_str(), "CSMain", "cs_5_0");
-                byteCode = CD3DX12_SHADER_BYTECODE(reinterpret_cast<const void*>(bcds_lanczos2_cso),
-                                                   sizeof(bcds_lanczos2_cso));
-
-                break;
-
-            case Scaler::Lanczos3:
-                _recEncodeShader = CompileShader(downsampleCodeLanczos3.c_str(), "CSMain", "cs_5_0");
-                byteCode = CD3DX12_SHADER_BYTECODE(reinterpret_cast<const void*>(bcds_lanczos3_cso),
-                                                   sizeof(bcds_lanczos3_cso));
-
-                break;
-
-            case Scaler::Kaiser2:
-                _recEncodeShader = CompileShader(downsampleCodeKaiser2.c_str(), "CSMain", "cs_5_0");
-                byteCode =
-                    CD3DX12_SHADER_BYTECODE(reinterpret_cast<const void*>(bcds_kaiser2_cso), sizeof(bcds_kaiser2_cso));
-                break;
-
-            case Scaler::Kaiser3:
-                _recEncodeShader = CompileShader(downsampleCodeKaiser3.c_str(), "CSMain", "cs_5_0");
-                byteCode =
-                    CD3DX12_SHADER_BYTECODE(reinterpret_cast<const void*>(bcds_kaiser3_cso), sizeof(bcds_kaiser3_cso));
-
-                break;
-
-            case Scaler::Magic:
-                _recEncodeShader = CompileShader(downsampleCodeMAGIC.c_str(), "CSMain", "cs_5_0");
-                byteCode = CD3DX12_SHADER_BYTECODE(reinterpret_cast<const void*>(bcds_magc_cso), sizeof(bcds_magc_cso));
-
-                break;
-
-            default:
-                _recEncodeShader = CompileShader(downsampleCodeBC.c_str(), "CSMain", "cs_5_0");
-                byteCode =
-                    CD3DX12_SHADER_BYTECODE(reinterpret_cast<const void*>(bcds_bicubic_cso), sizeof(bcds_bicubic_cso));
-
-                break;
-            }
-        }
-
-        if (_recEncodeShader == nullptr)
-            LOG_ERROR("[{0}] CompileShader error!", _name);
-
-        // create pso objects
-        if (!Shader_Dx12::CreateComputeShader(InDevice, _rootSignature, &_pipelineState, _recEncodeShader, byteCode))
-        {
-            LOG_ERROR("[{0}] CreateComputeShader error!", _name);
-            return;
-        }
-
-        SAFE_RELEASE(_recEncodeShader);
+        LOG_ERROR("[{0}] CreateComputePipeline error!", _name);
+        return;
     }
 
     _init = InitHeaps(InDevice, _frameHeaps, OS_NUM_OF_HEAPS);
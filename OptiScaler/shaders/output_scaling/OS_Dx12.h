@@ -30,6 +30,8 @@ class OS_Dx12 : public Shader_Dx12
     bool IsUpsampling() { return _upsample; }
     bool CanRender() const { return _init && _buffer != nullptr; }
 
+    static void Warmup(ID3D12Device* InDevice);
+
     OS_Dx12(std::string InName, ID3D12Device* InDevice, bool InUpsample);
 
     ~OS_Dx12();
@@ -0,0 +1,272 @@
+#pragma once
+
+#include "OS_Cpu.h"
+
+#include <chrono>
+#include <cstdio>
+#include <limits>
+#include <string>
+
+// Golden image comparison and cost measurement of the CPU output scaling kernels.
+// Used to pick the cheapest filter which still meets a quality target for a scaling ratio.
+// Golden images, the check and the benchmark are in tools/os_golden.
+namespace os_cpu
+{
+
+struct Quality
+{
+    // RGB, peak value of 1.0. Infinite for identical images
+    double Psnr = 0.0;
+
+    // Luma, 8x8 windows with a stride of 4
+    double Ssim = 0.0;
+
+    float MaxError = 0.0f;
+};
+
+inline double Psnr(const Image& reference, const Image& test)
+{
+    double sum = 0.0;
+    size_t count = 0;
+
+    for (size_t i = 0; i < reference.Data.size(); i++)
+    {
+        if ((i & 3) == 3)
+            continue;
+
+        double diff = (double) reference.Data[i] - (double) test.Data[i];
+        sum += diff * diff;
+        count++;
+    }
+
+    if (sum == 0.0 || count == 0)
+        return std::numeric_limits<double>::infinity();
+
+    return 10.0 * std::log10(1.0 / (sum / (double) count));
+}
+
+inline double Ssim(const Image& reference, const Image& test)
+{
+    constexpr int32_t Window = 8;
+    constexpr int32_t Stride = 4;
+    constexpr double C1 = 0.01 * 0.01;
+    constexpr double C2 = 0.03 * 0.03;
+
+    auto luma = [](const float* p) { return 0.2126 * p[0] + 0.7152 * p[1] + 0.0722 * p[2]; };
+
+    // Images smaller than a window are compared as one
+    int32_t windowX = std::min(Window, reference.Width);
+    int32_t windowY = std::min(Window, reference.Height);
+
+    double total = 0.0;
+    size_t windows = 0;
+
+    for (int32_t y0 = 0; y0 + windowY <= reference.Height; y0 += Stride)
+    {
+        for (int32_t x0 = 0; x0 + windowX <= reference.Width; x0 += Stride)
+        {
+            double sumA = 0.0, sumB = 0.0, sumAA = 0.0, sumBB = 0.0, sumAB = 0.0;
+
+            for (int32_t y = y0; y < y0 + windowY; y++)
+            {
+                auto rowA = reference.Row(y);
+                auto rowB = test.Row(y);
+
+                for (int32_t x = x0; x < x0 + windowX; x++)
+                {
+                    double a = luma(rowA + (size_t) x * 4);
+                    double b = luma(rowB + (size_t) x * 4);
+                    sumA += a;
+                    sumB += b;
+                    sumAA += a * a;
+                    sumBB += b * b;
+                    sumAB += a * b;
+                }
+            }
+
+            double n = (double) windowX * windowY;
+            double meanA = sumA / n;
+            double meanB = sumB / n;
+            double varA = sumAA / n - meanA * meanA;
+            double varB = sumBB / n - meanB * meanB;
+            double cov = sumAB / n - meanA * meanB;
+
+            total += ((2.0 * meanA * meanB + C1) * (2.0 * cov + C2)) /
+                     ((meanA * meanA + meanB * meanB + C1) * (varA + varB + C2));
+            windows++;
+        }
+    }
+
+    return windows != 0 ? total / (double) windows : 0.0;
+}
+
+// Zero quality when the sizes don't match
+inline Quality Compare(const Image& reference, const Image& test)
+{
+    Quality quality;
+
+    if (reference.Width != test.Width || reference.Height != test.Height || reference.Data.empty() ||
+        reference.Data.size() != test.Data.size())
+    {
+        return quality;
+    }
+
+    for (size_t i = 0; i < reference.Data.size(); i++)
+    {
+        if ((i & 3) != 3)
+            quality.MaxError = std::max(quality.MaxError, std::abs(reference.Data[i] - test.Data[i]));
+    }
+
+    quality.Psnr = Psnr(reference, test);
+    quality.Ssim = Ssim(reference, test);
+    return quality;
+}
+
+// Golden images are stored as little endian RGB PFM, alpha is dropped
+inline bool SavePfm(const std::string& path, const Image& image)
+{
+    auto file = std::fopen(path.c_str(), "wb");
+
+    if (file == nullptr)
+        return false;
+
+    std::fprintf(file, "PF\n%d %d\n-1.0\n", image.Width, image.Height);
+
+    std::vector<float> row((size_t) image.Width * 3);
+    bool result = true;
+
+    // Bottom to top
+    for (int32_t y = image.Height - 1; y >= 0 && result; y--)
+    {
+        auto src = image.Row(y);
+
+        for (int32_t x = 0; x < image.Width; x++)
+        {
+            row[x * 3] = src[x * 4];
+            row[x * 3 + 1] = src[x * 4 + 1];
+            row[x * 3 + 2] = src[x * 4 + 2];
+        }
+
+        result = std::fwrite(row.data(), sizeof(float), row.size(), file) == row.size();
+    }
+
+    return std::fclose(file) == 0 && result;
+}
+
+inline bool LoadPfm(const std::string& path, Image& image)
+{
+    auto file = std::fopen(path.c_str(), "rb");
+
+    if (file == nullptr)
+        return false;
+
+    char magic[3] = {};
+    int32_t width = 0;
+    int32_t height = 0;
+    float scale = 0.0f;
+
+    bool result = std::fscanf(file, "%2s %d %d %f", magic, &width, &height, &scale) == 4 &&
+                  std::string(magic) == "PF" && width > 0 && height > 0 && scale < 0.0f && std::fgetc(file) == '\n';
+
+    if (result)
+    {
+        image = Image(width, height);
+        std::vector<float> row((size_t) width * 3);
+
+        for (int32_t y = height - 1; y >= 0 && result; y--)
+        {
+            result = std::fread(row.data(), sizeof(float), row.size(), file) == row.size();
+
+            auto dst = image.Row(y);
+
+            for (int32_t x = 0; x < width && result; x++)
+            {
+                dst[x * 4] = row[x * 3];
+                dst[x * 4 + 1] = row[x * 3 + 1];
+                dst[x * 4 + 2] = row[x * 3 + 2];
+                dst[x * 4 + 3] = 1.0f;
+            }
+        }
+    }
+
+    std::fclose(file);
+    return result;
+}
+
+// Best of the runs in nanoseconds per output pixel, negative when the filter can't run with these constants
+inline double MeasureNsPerPixel(Filter filter, const Constants& constants, const Image& src, Isa isa,
+                                uint32_t runs = 5)
+{
+    Image dst;
+
+    // Warms up caches and allocates dst
+    if (!Run(filter, constants, src, dst, isa))
+        return -1.0;
+
+    double best = std::numeric_limits<double>::max();
+
+    for (uint32_t i = 0; i < runs; i++)
+    {
+        auto start = std::chrono::steady_clock::now();
+        Run(filter, constants, src, dst, isa);
+        auto elapsed = std::chrono::steady_clock::now() - start;
+
+        best = std::min(best, (double) std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count());
+    }
+
+    return best / ((double) constants.destWidth * constants.destHeight);
+}
+
+struct Candidate
+{
+    Filter Kernel = Filter::FSR1;
+    Quality Score;
+    double NsPerPixel = 0.0;
+};
+
+// Runs every filter and compares it against the golden image of the destination size
+inline std::vector<Candidate> Evaluate(const Constants& constants, const Image& src, const Image& golden,
+                                       Isa isa = Isa::Avx2, uint32_t runs = 5)
+{
+    std::vector<Candidate> candidates;
+    Image dst;
+
+    for (uint32_t i = 0; i < (uint32_t) Filter::Count; i++)
+    {
+        auto filter = (Filter) i;
+
+        if (!Run(filter, constants, src, dst, isa))
+            continue;
+
+        Candidate candidate;
+        candidate.Kernel = filter;
+        candidate.Score = Compare(golden, dst);
+        candidate.NsPerPixel = MeasureNsPerPixel(filter, constants, src, isa, runs);
+        candidates.push_back(candidate);
+    }
+
+    return candidates;
+}
+
+// Cheapest candidate meeting both targets, the one with the best SSIM when none does. Null when empty
+inline const Candidate* SelectFilter(const std::vector<Candidate>& candidates, double minPsnr, double minSsim)
+{
+    const Candidate* cheapest = nullptr;
+    const Candidate* best = nullptr;
+
+    for (auto& candidate : candidates)
+    {
+        if (best == nullptr || candidate.Score.Ssim > best->Score.Ssim)
+            best = &candidate;
+
+        if (candidate.Score.Psnr < minPsnr || candidate.Score.Ssim < minSsim)
+            continue;
+
+        if (cheapest == nullptr || candidate.NsPerPixel < cheapest->NsPerPixel)
+            cheapest = &candidate;
+    }
+
+    return cheapest != nullptr ? cheapest : best;
+}
+
+} // namespace os_cpu
@@ -426,6 +426,17 @@ bool RCAS_Dx11::Dispatch(ID3D11Device* InDevice, ID3D11DeviceContext* InContext,
     }
 }
 
+void RCAS_Dx11::Warmup()
+{
+    if (Config::Instance()->UsePrecompiledShaders.value_or_default())
+        return;
+
+    // All are compiled with each feature
+    WarmupShader(rcasCode.c_str(), "CSMain", "cs_5_0");
+    WarmupShader(daRcasSharpenCode.c_str(), "CSMain", "cs_5_0");
+    WarmupShader(dasDASharpenCode.c_str(), "CSMain", "cs_5_0");
+}
+
 RCAS_Dx11::RCAS_Dx11(std::string InName, ID3D11Device* InDevice) : _name(InName), _device(InDevice)
 {
     if (InDevice == nullptr)
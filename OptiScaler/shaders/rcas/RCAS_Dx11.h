@@ -54,6 +54,8 @@ class RCAS_Dx11 : public RCAS_Common
     bool IsInit() const { return _init; }
     bool CanRender() const { return _init && _buffer != nullptr; }
 
+    static void Warmup();
+
     RCAS_Dx11(std::string InName, ID3D11Device* InDevice);
 
     ~RCAS_Dx11();
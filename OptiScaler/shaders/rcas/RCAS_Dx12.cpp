@@ -155,6 +155,17 @@ bool RCAS_Dx12::Dispatch(ID3D12GraphicsCommandList* InCmdList, ID3D12Resource* I
     }
 }
 
+void RCAS_Dx12::Warmup(ID3D12Device* InDevice)
+{
+    // All are created with each feature
+    auto rootSignature = SerializeRootSignature(3, 1, 1);
+    PrewarmComputePipeline(InDevice, rootSignature, rcas_cso, sizeof(rcas_cso), rcasCode.c_str(), "RCAS");
+    PrewarmComputePipeline(InDevice, rootSignature, da_rcas_sharpen_cso, sizeof(da_rcas_sharpen_cso),
+                           daRcasSharpenCode.c_str(), "RCAS DA");
+    PrewarmComputePipeline(InDevice, rootSignature, da_das_sharpen_cso, sizeof(da_das_sharpen_cso),
+                           dasDASharpenCode.c_str(), "RCAS DAS DA");
+}
+
 RCAS_Dx12::RCAS_Dx12(std::string InName, ID3D12Device* InDevice) : Shader_Dx12(InName, InDevice)
 {
     if (InDevice == nullptr)
@@ -212,9 +223,6 @@ RCAS_Dx12::~RCAS_Dx12()
     if (!_init || State::Instance().isShuttingDown)
         return;
 
-    SAFE_RELEASE(_pipelineStateDA);
-    SAFE_RELEASE(_pipelineStateDASDA);
-
     for (int i = 0; i < RCAS_NUM_OF_HEAPS; i++)
     {
         _frameHeaps[i].ReleaseHeaps();
@@ -38,6 +38,8 @@ class RCAS_Dx12 : public Shader_Dx12, public RCAS_Common
     ID3D12Resource* Buffer() { return _buffer; }
     bool CanRender() const { return _init && _buffer != nullptr; }
 
+    static void Warmup(ID3D12Device* InDevice);
+
     RCAS_Dx12(std::string InName, ID3D12Device* InDevice);
 
     ~RCAS_Dx12();
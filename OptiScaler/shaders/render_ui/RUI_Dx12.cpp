@@ -52,6 +52,23 @@ void RUI_Dx12::SetBufferState(UINT index, ID3D12GraphicsCommandList* InCommandLi
     _bufferState[index] = InState;
 }
 
+void RUI_Dx12::Warmup()
+{
+    if (Config::Instance()->UsePrecompiledShaders.value_or_default() ||
+        Config::Instance()->FGOutput.value_or_default() == FGOutput::NoFG)
+        return;
+
+    // Selected one first, premultiplied alpha can be changed from the menu
+    auto premultiplied = Config::Instance()->FGUIPremultipliedAlpha.value_or_default();
+    auto& selected = premultiplied ? ruipmCode : ruiCode;
+    auto& other = premultiplied ? ruiCode : ruipmCode;
+
+    WarmupShader(selected.c_str(), "VSMain", "vs_5_1");
+    WarmupShader(selected.c_str(), "PSMain", "ps_5_1");
+    WarmupShader(other.c_str(), "VSMain", "vs_5_1");
+    WarmupShader(other.c_str(), "PSMain", "ps_5_1");
+}
+
 RUI_Dx12::RUI_Dx12(std::string InName, ID3D12Device* InDevice, bool preMultipliedAlpha) : Shader_Dx12(InName, InDevice)
 {
     _pm = preMultipliedAlpha;
@@ -145,10 +162,10 @@ RUI_Dx12::RUI_Dx12(std::string InName, ID3D12Device* InDevice, bool preMultiplie
         Shader_Dx12::TranslateTypelessFormats(scDesc.BufferDesc.Format); // match swapchain RTV format (can be *_SRGB)
     graphicsPsoDesc.SampleDesc = { 1, 0 };
 
-    auto result = InDevice->CreateGraphicsPipelineState(&graphicsPsoDesc, IID_PPV_ARGS(&_pipelineState));
-    if (result != S_OK)
+    // Kept by the pipeline manager, recreating the pass doesn't build it again
+    if (!CreateGraphicsPipeline(InDevice, graphicsPsoDesc))
     {
-        LOG_ERROR("CreateGraphicsPipelineState error: {:X}", (unsigned long) result);
+        LOG_ERROR("[{0}] Failed to create graphics pipeline", _name);
         return;
     }
 
@@ -264,7 +281,6 @@ RUI_Dx12::~RUI_Dx12()
     if (!_init || State::Instance().isShuttingDown)
         return;
 
-    SAFE_RELEASE(_rootSignature);
     SAFE_RELEASE(_constantBuffer);
 
     for (int i = 0; i < HC_NUM_OF_HEAPS; i++)
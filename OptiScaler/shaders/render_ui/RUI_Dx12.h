@@ -31,6 +31,8 @@ class RUI_Dx12 : public Shader_Dx12
 
     bool IsPreMultipliedAlpha() const { return _pm; }
 
+    static void Warmup();
+
     RUI_Dx12(std::string InName, ID3D12Device* InDevice, bool preMultipliedAlpha);
 
     ~RUI_Dx12();
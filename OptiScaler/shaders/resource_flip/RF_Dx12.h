@@ -21,6 +21,8 @@ class RF_Dx12 : public Shader_Dx12
     bool Dispatch(ID3D12GraphicsCommandList* InCmdList, ID3D12Resource* InResource, ID3D12Resource* OutResource,
                   UINT64 width, UINT height, bool velocity);
 
+    static void Warmup(ID3D12Device* InDevice);
+
     RF_Dx12(std::string InName, ID3D12Device* InDevice);
 
     ~RF_Dx12();
@@ -0,0 +1,391 @@
+#pragma once
+
+#include <span>
+#include <array>
+#include <mutex>
+#include <atomic>
+#include <cstdint>
+#include <fstream>
+#include <filesystem>
+
+// API independent bookkeeping of GPU timestamp scopes.
+// Queries live in a ring of FrameCount frames, every frame has a begin/end
+// query pair per scope. Frames are read back oldest first once the GPU has
+// finished them, a frame which is not ready yet is retried on the next
+// EndFrame instead of waiting. API backends only write and read timestamps.
+// No platform dependencies, so the frame latency logic can be driven by a
+// mock ITimestampSource on any OS.
+namespace gpu_profiler
+{
+
+enum class Scope : uint32_t
+{
+    Upscale,
+    RCAS,
+    OutputScaling,
+    HudfixCopy,
+    FGDispatch,
+    MenuRender,
+    Count
+};
+
+inline constexpr uint32_t ScopeCount = (uint32_t) Scope::Count;
+inline constexpr uint32_t FrameCount = 4;
+inline constexpr uint32_t QueriesPerFrame = ScopeCount * 2;
+inline constexpr uint32_t QueryCount = FrameCount * QueriesPerFrame;
+inline constexpr uint32_t InvalidQuery = UINT32_MAX;
+
+// Bit per scope
+using ScopeMask = uint32_t;
+
+inline constexpr ScopeMask MaskOf(Scope scope) { return 1u << (uint32_t) scope; }
+
+inline const char* ScopeName(Scope scope)
+{
+    switch (scope)
+    {
+    case Scope::Upscale:
+        return "Upscale";
+    case Scope::RCAS:
+        return "RCAS";
+    case Scope::OutputScaling:
+        return "Output Scaling";
+    case Scope::HudfixCopy:
+        return "Hudfix Copy";
+    case Scope::FGDispatch:
+        return "FG Dispatch";
+    case Scope::MenuRender:
+        return "Menu Render";
+    default:
+        return "Unknown";
+    }
+}
+
+// Index of the begin query, end query is the next one
+inline constexpr uint32_t QueryIndex(uint32_t slot, Scope scope) { return slot * QueriesPerFrame + (uint32_t) scope * 2; }
+
+enum class ReadResult
+{
+    NotReady, // GPU did not finish the frame yet, try again later
+    Ok,
+    Invalid // Frame can't be used (e.g. disjoint), it will be discarded
+};
+
+class ITimestampSource
+{
+  public:
+    virtual ~ITimestampSource() = default;
+
+    // Must not block. Only queries of scopes in mask have to be filled,
+    // timestamps[scope * 2] is begin and timestamps[scope * 2 + 1] is end.
+    virtual ReadResult ReadFrame(uint32_t slot, ScopeMask mask, std::span<uint64_t, QueriesPerFrame> timestamps,
+                                 double& ticksPerSecond) = 0;
+};
+
+struct FrameResult
+{
+    uint64_t FrameId = 0;
+    ScopeMask Mask = 0;
+    std::array<double, ScopeCount> Ms {};
+
+    bool Has(Scope scope) const { return (Mask & MaskOf(scope)) != 0; }
+};
+
+class GpuProfiler
+{
+  public:
+    // Values above this are treated as broken measurements
+    static constexpr double MaxScopeMs = 100.0;
+
+  private:
+    enum class SlotState : uint8_t
+    {
+        Free,
+        Recording,
+        Pending
+    };
+
+    struct Slot
+    {
+        uint64_t FrameId = 0;
+        ScopeMask Begun = 0;
+        ScopeMask Ended = 0;
+        SlotState State = SlotState::Free;
+    };
+
+    struct ScopeStats
+    {
+        std::atomic<float> Last { 0.0f };
+        std::atomic<float> Average { 0.0f };
+        std::atomic<uint64_t> Frames { 0 };
+        std::atomic<uint64_t> LastFrameId { 0 };
+    };
+
+    std::mutex _mutex;
+    std::array<Slot, FrameCount> _slots {};
+    uint32_t _current = 0;
+    uint32_t _pendingCount = 0;
+    uint64_t _frameId = 0;
+
+    std::array<ScopeStats, ScopeCount> _stats;
+    std::atomic<uint64_t> _dropped { 0 };
+
+    std::ofstream _csv;
+
+    Slot& Current()
+    {
+        auto& slot = _slots[_current];
+
+        if (slot.State == SlotState::Free)
+        {
+            slot.FrameId = _frameId;
+            slot.Begun = 0;
+            slot.Ended = 0;
+            slot.State = SlotState::Recording;
+        }
+
+        return slot;
+    }
+
+    void Store(const FrameResult& result)
+    {
+        for (uint32_t i = 0; i < ScopeCount; i++)
+        {
+            if (!result.Has((Scope) i))
+                continue;
+
+            auto& stats = _stats[i];
+            auto ms = (float) result.Ms[i];
+            auto frames = stats.Frames.load(std::memory_order_relaxed);
+
+            // Running average for the first frames, then exponential
+            auto weight = frames < 32 ? 1.0f / (float) (frames + 1) : 1.0f / 32.0f;
+            auto average = stats.Average.load(std::memory_order_relaxed);
+
+            stats.Average.store(average + (ms - average) * weight, std::memory_order_relaxed);
+            stats.Last.store(ms, std::memory_order_relaxed);
+            stats.Frames.store(frames + 1, std::memory_order_relaxed);
+            stats.LastFrameId.store(result.FrameId, std::memory_order_relaxed);
+        }
+
+        if (_csv.is_open())
+        {
+            _csv << result.FrameId;
+
+            for (uint32_t i = 0; i < ScopeCount; i++)
+            {
+                _csv << ',';
+
+                if (result.Has((Scope) i))
+                    _csv << result.Ms[i];
+            }
+
+            _csv << '\n';
+        }
+    }
+
+  public:
+    // Returns index of the begin query to write, InvalidQuery when scope
+    // was already recorded in this frame. Only first instance is measured.
+    uint32_t BeginScope(Scope scope)
+    {
+        std::scoped_lock lock(_mutex);
+
+        auto& slot = Current();
+        auto mask = MaskOf(scope);
+
+        if ((slot.Begun & mask) != 0)
+            return InvalidQuery;
+
+        slot.Begun |= mask;
+        return QueryIndex(_current, scope);
+    }
+
+    // Returns index of the end query to write, InvalidQuery when scope
+    // was not begun in this frame
+    uint32_t EndScope(Scope scope)
+    {
+        std::scoped_lock lock(_mutex);
+
+        auto& slot = _slots[_current];
+        auto mask = MaskOf(scope);
+
+        if (slot.State != SlotState::Recording || (slot.Begun & mask) == 0 || (slot.Ended & mask) != 0)
+            return InvalidQuery;
+
+        slot.Ended |= mask;
+        return QueryIndex(_current, scope) + 1;
+    }
+
+    // Closes current frame, returns its slot or InvalidQuery when nothing was recorded.
+    // If the next slot is still waiting for readback the GPU is too far behind,
+    // that frame is dropped and its queries are reused.
+    uint32_t EndFrame()
+    {
+        std::scoped_lock lock(_mutex);
+
+        auto closed = InvalidQuery;
+        auto& slot = _slots[_current];
+
+        if (slot.State == SlotState::Recording && (slot.Begun & slot.Ended) != 0)
+        {
+            slot.State = SlotState::Pending;
+            _pendingCount++;
+            closed = _current;
+        }
+        else
+        {
+            slot.State = SlotState::Free;
+        }
+
+        _frameId++;
+        _current = (_current + 1) % FrameCount;
+
+        auto& next = _slots[_current];
+        if (next.State == SlotState::Pending)
+        {
+            next.State = SlotState::Free;
+            _pendingCount--;
+            _dropped.fetch_add(1, std::memory_order_relaxed);
+        }
+
+        return closed;
+    }
+
+    // Reads finished frames in submission order, stops at the first one which is not ready.
+    // onFrame is called for every successfully read frame. Returns number of frames read.
+    template <typename F> uint32_t Collect(ITimestampSource& source, F&& onFrame)
+    {
+        std::scoped_lock lock(_mutex);
+
+        uint32_t read = 0;
+        std::array<uint64_t, QueriesPerFrame> timestamps {};
+
+        // Slots after the current one in ring order are the older ones
+        for (uint32_t i = 1; i < FrameCount && _pendingCount > 0; i++)
+        {
+            auto slotIndex = (_current + i) % FrameCount;
+            auto& slot = _slots[slotIndex];
+
+            if (slot.State != SlotState::Pending)
+                continue;
+
+            auto mask = slot.Begun & slot.Ended;
+            double ticksPerSecond = 0.0;
+            auto result = source.ReadFrame(slotIndex, mask, timestamps, ticksPerSecond);
+
+            if (result == ReadResult::NotReady)
+                break;
+
+            slot.State = SlotState::Free;
+            _pendingCount--;
+
+            if (result != ReadResult::Ok || ticksPerSecond <= 0.0)
+                continue;
+
+            FrameResult frame;
+            frame.FrameId = slot.FrameId;
+
+            for (uint32_t i = 0; i < ScopeCount; i++)
+            {
+                if ((mask & (1u << i)) == 0)
+                    continue;
+
+                auto begin = timestamps[i * 2];
+                auto end = timestamps[i * 2 + 1];
+
+                if (end < begin)
+                    continue;
+
+                auto ms = (double) (end - begin) / ticksPerSecond * 1000.0;
+
+                // filter out posibly wrong measured high values
+                if (ms >= MaxScopeMs)
+                    continue;
+
+                frame.Ms[i] = ms;
+                frame.Mask |= 1u << i;
+            }
+
+            if (frame.Mask == 0)
+                continue;
+
+            Store(frame);
+            onFrame(frame);
+            read++;
+        }
+
+        return read;
+    }
+
+    uint32_t Collect(ITimestampSource& source)
+    {
+        return Collect(source, [](const FrameResult&) {});
+    }
+
+    // Drops every pending frame, used when queries are recreated
+    void Reset()
+    {
+        std::scoped_lock lock(_mutex);
+
+        for (auto& slot : _slots)
+            slot = {};
+
+        _current = 0;
+        _pendingCount = 0;
+    }
+
+    float Last(Scope scope) const { return _stats[(uint32_t) scope].Last.load(std::memory_order_relaxed); }
+    float Average(Scope scope) const { return _stats[(uint32_t) scope].Average.load(std::memory_order_relaxed); }
+    uint64_t Frames(Scope scope) const { return _stats[(uint32_t) scope].Frames.load(std::memory_order_relaxed); }
+
+    // Scope was measured in one of the last frames, used to hide disabled passes
+    bool IsRecent(Scope scope)
+    {
+        std::scoped_lock lock(_mutex);
+
+        auto& stats = _stats[(uint32_t) scope];
+        return stats.Frames.load(std::memory_order_relaxed) > 0 &&
+               stats.LastFrameId.load(std::memory_order_relaxed) + 2 * FrameCount >= _frameId;
+    }
+
+    uint64_t Dropped() const { return _dropped.load(std::memory_order_relaxed); }
+
+    // Per frame timings as CSV, one row per collected frame
+    bool StartCsv(const std::filesystem::path& path)
+    {
+        std::scoped_lock lock(_mutex);
+
+        if (_csv.is_open())
+            _csv.close();
+
+        _csv.open(path, std::ios::out | std::ios::trunc);
+
+        if (!_csv.is_open())
+            return false;
+
+        _csv << "frame";
+
+        for (uint32_t i = 0; i < ScopeCount; i++)
+            _csv << ',' << ScopeName((Scope) i) << " (ms)";
+
+        _csv << '\n';
+        return true;
+    }
+
+    void StopCsv()
+    {
+        std::scoped_lock lock(_mutex);
+
+        if (_csv.is_open())
+            _csv.close();
+    }
+
+    bool IsCsvActive()
+    {
+        std::scoped_lock lock(_mutex);
+        return _csv.is_open();
+    }
+};
+
+} // namespace gpu_profiler
@@ -0,0 +1,142 @@
+#include "pch.h"
+#include "GpuProfiler_Dx11.h"
+
+#include <State.h>
+
+using namespace gpu_profiler;
+
+struct GpuProfilerDx11::Source : public ITimestampSource
+{
+    ID3D11DeviceContext* Context = nullptr;
+
+    ReadResult ReadFrame(uint32_t slot, ScopeMask mask, std::span<uint64_t, QueriesPerFrame> timestamps,
+                         double& ticksPerSecond) override
+    {
+        D3D11_QUERY_DATA_TIMESTAMP_DISJOINT disjointData;
+        auto result = Context->GetData(_disjointQueries[slot], &disjointData, sizeof(disjointData),
+                                       D3D11_ASYNC_GETDATA_DONOTFLUSH);
+
+        if (result == S_FALSE)
+            return ReadResult::NotReady;
+
+        if (result != S_OK || disjointData.Disjoint || disjointData.Frequency == 0)
+            return ReadResult::Invalid;
+
+        for (uint32_t i = 0; i < QueriesPerFrame; i++)
+        {
+            if ((mask & (1u << (i / 2))) == 0)
+                continue;
+
+            UINT64 timestamp = 0;
+            result = Context->GetData(_timestampQueries[slot * QueriesPerFrame + i], &timestamp, sizeof(UINT64),
+                                      D3D11_ASYNC_GETDATA_DONOTFLUSH);
+
+            if (result == S_FALSE)
+                return ReadResult::NotReady;
+
+            if (result != S_OK)
+                return ReadResult::Invalid;
+
+            timestamps[i] = timestamp;
+        }
+
+        ticksPerSecond = static_cast<double>(disjointData.Frequency);
+        return ReadResult::Ok;
+    }
+};
+
+void GpuProfilerDx11::Init(ID3D11Device* device)
+{
+    if (_initDone || device == nullptr)
+        return;
+
+    // Create Disjoint Query
+    D3D11_QUERY_DESC disjointQueryDesc = {};
+    disjointQueryDesc.Query = D3D11_QUERY_TIMESTAMP_DISJOINT;
+
+    // Create Timestamp Queries
+    D3D11_QUERY_DESC timestampQueryDesc = {};
+    timestampQueryDesc.Query = D3D11_QUERY_TIMESTAMP;
+
+    for (uint32_t i = 0; i < FrameCount; i++)
+    {
+        if (device->CreateQuery(&disjointQueryDesc, &_disjointQueries[i]) != S_OK)
+        {
+            LOG_ERROR("Can't create disjoint query!");
+            return;
+        }
+    }
+
+    for (uint32_t i = 0; i < QueryCount; i++)
+    {
+        if (device->CreateQuery(&timestampQueryDesc, &_timestampQueries[i]) != S_OK)
+        {
+            LOG_ERROR("Can't create timestamp query!");
+            return;
+        }
+    }
+
+    State::Instance().gpuProfiler.Reset();
+    _initDone = true;
+}
+
+void GpuProfilerDx11::Begin(ID3D11DeviceContext* deviceContext, Scope scope)
+{
+    if (!_initDone || deviceContext == nullptr)
+        return;
+
+    auto index = State::Instance().gpuProfiler.BeginScope(scope);
+
+    if (index == InvalidQuery)
+        return;
+
+    // Disjoint query covers every scope of the frame, it's started with the first one
+    auto slot = index / QueriesPerFrame;
+    if (!_disjointActive[slot])
+    {
+        deviceContext->Begin(_disjointQueries[slot]);
+        _disjointActive[slot] = true;
+    }
+
+    deviceContext->End(_timestampQueries[index]);
+}
+
+void GpuProfilerDx11::End(ID3D11DeviceContext* deviceContext, Scope scope)
+{
+    if (!_initDone || deviceContext == nullptr)
+        return;
+
+    auto index = State::Instance().gpuProfiler.EndScope(scope);
+
+    if (index != InvalidQuery)
+        deviceContext->End(_timestampQueries[index]);
+}
+
+void GpuProfilerDx11::EndFrame(ID3D11DeviceContext* deviceContext)
+{
+    if (!_initDone || deviceContext == nullptr)
+        return;
+
+    for (uint32_t i = 0; i < FrameCount; i++)
+    {
+        if (_disjointActive[i])
+        {
+            deviceContext->End(_disjointQueries[i]);
+            _disjointActive[i] = false;
+        }
+    }
+
+    auto& state = State::Instance();
+    state.gpuProfiler.EndFrame();
+
+    Source source;
+    source.Context = deviceContext;
+
+    state.gpuProfiler.Collect(source,
+                              [&state](const FrameResult& frame)
+                              {
+                                  if (frame.Has(Scope::Upscale))
+                                      state.frameStats.Record(frame_stats::Series::Upscaler,
+                                                              frame.Ms[(uint32_t) Scope::Upscale]);
+                              });
+}
@@ -0,0 +1,25 @@
+#pragma once
+
+#include "SysUtils.h"
+#include "GpuProfiler.h"
+
+#include <d3d11.h>
+
+class GpuProfilerDx11
+{
+  public:
+    static void Init(ID3D11Device* device);
+    static void Begin(ID3D11DeviceContext* deviceContext, gpu_profiler::Scope scope);
+    static void End(ID3D11DeviceContext* deviceContext, gpu_profiler::Scope scope);
+
+    // Call once per present, closes the disjoint query and reads finished frames
+    static void EndFrame(ID3D11DeviceContext* deviceContext);
+
+  private:
+    struct Source;
+
+    inline static ID3D11Query* _disjointQueries[gpu_profiler::FrameCount] = {};
+    inline static ID3D11Query* _timestampQueries[gpu_profiler::QueryCount] = {};
+    inline static bool _disjointActive[gpu_profiler::FrameCount] = {};
+    inline static bool _initDone = false;
+};
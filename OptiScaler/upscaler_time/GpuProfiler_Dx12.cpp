@@ -0,0 +1,179 @@
+#include "pch.h"
+#include "GpuProfiler_Dx12.h"
+
+#include <State.h>
+
+#include <include/d3dx/d3dx12.h>
+
+using namespace gpu_profiler;
+
+struct GpuProfilerDx12::Source : public ITimestampSource
+{
+    ReadResult ReadFrame(uint32_t slot, ScopeMask mask, std::span<uint64_t, QueriesPerFrame> timestamps,
+                         double& ticksPerSecond) override
+    {
+        // Frame fence is signalled on the present queue after the frame's work
+        if (_fence->GetCompletedValue() < _slotFenceValues[slot])
+            return ReadResult::NotReady;
+
+        auto offset = (SIZE_T) slot * QueriesPerFrame * sizeof(UINT64);
+        D3D12_RANGE readRange = { offset, offset + QueriesPerFrame * sizeof(UINT64) };
+        UINT64* timestampData = nullptr;
+
+        if (_readbackBuffer->Map(0, &readRange, reinterpret_cast<void**>(&timestampData)) != S_OK ||
+            timestampData == nullptr)
+        {
+            LOG_WARN("Can't map readback buffer!");
+            return ReadResult::Invalid;
+        }
+
+        memcpy(timestamps.data(), reinterpret_cast<uint8_t*>(timestampData) + offset,
+               QueriesPerFrame * sizeof(UINT64));
+
+        D3D12_RANGE writeRange = { 0, 0 };
+        _readbackBuffer->Unmap(0, &writeRange);
+
+        ticksPerSecond = _frequency;
+        return ReadResult::Ok;
+    }
+};
+
+void GpuProfilerDx12::Init(ID3D12Device* device)
+{
+    std::scoped_lock lock(_initMutex);
+
+    if (_queryHeap != nullptr || device == nullptr)
+        return;
+
+    // Create query heap for timestamp queries of every frame and scope
+    D3D12_QUERY_HEAP_DESC queryHeapDesc = {};
+    queryHeapDesc.Count = QueryCount;
+    queryHeapDesc.NodeMask = 0;
+    queryHeapDesc.Type = D3D12_QUERY_HEAP_TYPE_TIMESTAMP;
+
+    auto result = device->CreateQueryHeap(&queryHeapDesc, IID_PPV_ARGS(&_queryHeap));
+
+    if (result != S_OK)
+    {
+        LOG_ERROR("CreateQueryHeap error: {:X}", (UINT) result);
+        _initFailed = true;
+        return;
+    }
+
+    // Create a readback buffer to retrieve timestamp data
+    D3D12_RESOURCE_DESC bufferDesc = CD3DX12_RESOURCE_DESC::Buffer(QueryCount * sizeof(UINT64));
+    D3D12_HEAP_PROPERTIES heapProps = {};
+    heapProps.Type = D3D12_HEAP_TYPE_READBACK;
+
+    result = device->CreateCommittedResource(&heapProps, D3D12_HEAP_FLAG_NONE, &bufferDesc,
+                                             D3D12_RESOURCE_STATE_COPY_DEST, nullptr, IID_PPV_ARGS(&_readbackBuffer));
+
+    if (result == S_OK)
+        result = device->CreateFence(0, D3D12_FENCE_FLAG_NONE, IID_PPV_ARGS(&_fence));
+
+    if (result != S_OK)
+    {
+        LOG_ERROR("CreateCommittedResource/CreateFence error: {:X}", (UINT) result);
+
+        if (_readbackBuffer != nullptr)
+        {
+            _readbackBuffer->Release();
+            _readbackBuffer = nullptr;
+        }
+
+        _queryHeap->Release();
+        _queryHeap = nullptr;
+        _initFailed = true;
+        return;
+    }
+
+    D3D12_FEATURE_DATA_D3D12_OPTIONS3 options3 {};
+    if (device->CheckFeatureSupport(D3D12_FEATURE_D3D12_OPTIONS3, &options3, sizeof(options3)) == S_OK)
+        _copyQueueTimestamps = options3.CopyQueueTimestampQueriesSupported;
+
+    State::Instance().gpuProfiler.Reset();
+}
+
+bool GpuProfilerDx12::CanWrite(ID3D12GraphicsCommandList* cmdList)
+{
+    if (cmdList == nullptr)
+        return false;
+
+    if (_queryHeap == nullptr && !_initFailed)
+    {
+        ID3D12Device* device = nullptr;
+
+        if (cmdList->GetDevice(IID_PPV_ARGS(&device)) == S_OK)
+        {
+            Init(device);
+            device->Release();
+        }
+    }
+
+    if (_queryHeap == nullptr)
+        return false;
+
+    auto type = cmdList->GetType();
+
+    if (type == D3D12_COMMAND_LIST_TYPE_COPY)
+        return _copyQueueTimestamps;
+
+    return type == D3D12_COMMAND_LIST_TYPE_DIRECT || type == D3D12_COMMAND_LIST_TYPE_COMPUTE;
+}
+
+void GpuProfilerDx12::Begin(ID3D12GraphicsCommandList* cmdList, Scope scope)
+{
+    if (!CanWrite(cmdList))
+        return;
+
+    auto index = State::Instance().gpuProfiler.BeginScope(scope);
+
+    if (index != InvalidQuery)
+        cmdList->EndQuery(_queryHeap, D3D12_QUERY_TYPE_TIMESTAMP, index);
+}
+
+void GpuProfilerDx12::End(ID3D12GraphicsCommandList* cmdList, Scope scope)
+{
+    if (!CanWrite(cmdList))
+        return;
+
+    auto index = State::Instance().gpuProfiler.EndScope(scope);
+
+    if (index == InvalidQuery)
+        return;
+
+    cmdList->EndQuery(_queryHeap, D3D12_QUERY_TYPE_TIMESTAMP, index);
+
+    // Resolve begin & end of this scope to its own place in the readback buffer
+    cmdList->ResolveQueryData(_queryHeap, D3D12_QUERY_TYPE_TIMESTAMP, index - 1, 2, _readbackBuffer,
+                              (UINT64) (index - 1) * sizeof(UINT64));
+}
+
+void GpuProfilerDx12::EndFrame(ID3D12CommandQueue* commandQueue)
+{
+    if (_queryHeap == nullptr || commandQueue == nullptr)
+        return;
+
+    auto& state = State::Instance();
+    auto slot = state.gpuProfiler.EndFrame();
+
+    if (slot != InvalidQuery)
+    {
+        // Get the GPU timestamp frequency (ticks per second)
+        UINT64 gpuFrequency = 0;
+        if (commandQueue->GetTimestampFrequency(&gpuFrequency) == S_OK)
+            _frequency = static_cast<double>(gpuFrequency);
+
+        _slotFenceValues[slot] = ++_fenceValue;
+        commandQueue->Signal(_fence, _fenceValue);
+    }
+
+    Source source;
+    state.gpuProfiler.Collect(source,
+                              [&state](const FrameResult& frame)
+                              {
+                                  if (frame.Has(Scope::Upscale))
+                                      state.frameStats.Record(frame_stats::Series::Upscaler,
+                                                              frame.Ms[(uint32_t) Scope::Upscale]);
+                              });
+}
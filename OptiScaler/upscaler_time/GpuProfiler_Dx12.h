@@ -0,0 +1,34 @@
+#pragma once
+
+#include "SysUtils.h"
+#include "GpuProfiler.h"
+
+#include <d3d12.h>
+
+class GpuProfilerDx12
+{
+  public:
+    static void Init(ID3D12Device* device);
+
+    // Only for command lists executed on the present queue, frames are read back after its fence
+    static void Begin(ID3D12GraphicsCommandList* cmdList, gpu_profiler::Scope scope);
+    static void End(ID3D12GraphicsCommandList* cmdList, gpu_profiler::Scope scope);
+
+    // Call once per present, signals the frame fence and reads finished frames
+    static void EndFrame(ID3D12CommandQueue* commandQueue);
+
+  private:
+    struct Source;
+
+    static bool CanWrite(ID3D12GraphicsCommandList* cmdList);
+
+    static inline std::mutex _initMutex;
+    static inline ID3D12QueryHeap* _queryHeap = nullptr;
+    static inline ID3D12Resource* _readbackBuffer = nullptr;
+    static inline ID3D12Fence* _fence = nullptr;
+    static inline UINT64 _fenceValue = 0;
+    static inline UINT64 _slotFenceValues[gpu_profiler::FrameCount] = {};
+    static inline double _frequency = 0.0;
+    static inline bool _copyQueueTimestamps = false;
+    static inline bool _initFailed = false;
+};
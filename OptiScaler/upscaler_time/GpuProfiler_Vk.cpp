@@ -0,0 +1,106 @@
+#include "pch.h"
+#include "GpuProfiler_Vk.h"
+
+#include <State.h>
+
+using namespace gpu_profiler;
+
+struct GpuProfilerVk::Source : public ITimestampSource
+{
+    ReadResult ReadFrame(uint32_t slot, ScopeMask mask, std::span<uint64_t, QueriesPerFrame> timestamps,
+                         double& ticksPerSecond) override
+    {
+        for (uint32_t i = 0; i < ScopeCount; i++)
+        {
+            if ((mask & (1u << i)) == 0)
+                continue;
+
+            // Without WAIT flag VK_NOT_READY is returned if the GPU is not done yet
+            auto result = vkGetQueryPoolResults(_device, _queryPool, QueryIndex(slot, (Scope) i), 2,
+                                                2 * sizeof(uint64_t), timestamps.data() + i * 2, sizeof(uint64_t),
+                                                VK_QUERY_RESULT_64_BIT);
+
+            if (result == VK_NOT_READY)
+                return ReadResult::NotReady;
+
+            if (result != VK_SUCCESS)
+                return ReadResult::Invalid;
+        }
+
+        // timestampPeriod is nanoseconds per tick
+        ticksPerSecond = 1e9 / _timeStampPeriod;
+        return ReadResult::Ok;
+    }
+};
+
+void GpuProfilerVk::Init(VkDevice device, VkPhysicalDevice pd)
+{
+    if (_queryPool != VK_NULL_HANDLE)
+        return;
+
+    VkQueryPoolCreateInfo queryPoolInfo = {};
+    queryPoolInfo.sType = VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO;
+    queryPoolInfo.queryType = VK_QUERY_TYPE_TIMESTAMP;
+    queryPoolInfo.queryCount = QueryCount;
+
+    auto result = vkCreateQueryPool(device, &queryPoolInfo, nullptr, &_queryPool);
+
+    if (result != VK_SUCCESS)
+    {
+        LOG_ERROR("vkCreateQueryPool error: {}", (int) result);
+        _queryPool = VK_NULL_HANDLE;
+        return;
+    }
+
+    VkPhysicalDeviceProperties deviceProperties;
+    vkGetPhysicalDeviceProperties(pd, &deviceProperties);
+
+    if (deviceProperties.limits.timestampPeriod > 0.0f)
+        _timeStampPeriod = deviceProperties.limits.timestampPeriod;
+
+    _device = device;
+    State::Instance().gpuProfiler.Reset();
+}
+
+void GpuProfilerVk::Begin(VkCommandBuffer cmdBuffer, Scope scope)
+{
+    if (_queryPool == VK_NULL_HANDLE)
+        return;
+
+    auto index = State::Instance().gpuProfiler.BeginScope(scope);
+
+    if (index == InvalidQuery)
+        return;
+
+    vkCmdResetQueryPool(cmdBuffer, _queryPool, index, 2);
+    vkCmdWriteTimestamp(cmdBuffer, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, _queryPool, index);
+}
+
+void GpuProfilerVk::End(VkCommandBuffer cmdBuffer, Scope scope)
+{
+    if (_queryPool == VK_NULL_HANDLE)
+        return;
+
+    auto index = State::Instance().gpuProfiler.EndScope(scope);
+
+    if (index != InvalidQuery)
+        vkCmdWriteTimestamp(cmdBuffer, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, _queryPool, index);
+}
+
+void GpuProfilerVk::EndFrame(VkDevice device)
+{
+    if (_queryPool == VK_NULL_HANDLE || device != _device)
+        return;
+
+    auto& state = State::Instance();
+    state.gpuProfiler.EndFrame();
+
+    Source source;
+    state.gpuProfiler.Collect(source,
+                              [&state](const FrameResult& frame)
+                              {
+                                  if (frame.Has(Scope::Upscale))
+                                      state.frameStats.Record(frame_stats::Series::Upscaler,
+                                                              frame.Ms[(uint32_t) Scope::Upscale]);
+                              });
+}
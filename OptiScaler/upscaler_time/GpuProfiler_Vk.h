@@ -0,0 +1,26 @@
+#pragma once
+
+#include "SysUtils.h"
+#include "GpuProfiler.h"
+
+#include <vulkan/vulkan.hpp>
+
+class GpuProfilerVk
+{
+  public:
+    static void Init(VkDevice device, VkPhysicalDevice pd);
+
+    // Must be called outside of a render pass, queries are reset here
+    static void Begin(VkCommandBuffer cmdBuffer, gpu_profiler::Scope scope);
+    static void End(VkCommandBuffer cmdBuffer, gpu_profiler::Scope scope);
+
+    // Call once per present, reads finished frames without waiting
+    static void EndFrame(VkDevice device);
+
+  private:
+    struct Source;
+
+    static inline VkQueryPool _queryPool = VK_NULL_HANDLE;
+    static inline VkDevice _device = VK_NULL_HANDLE;
+    static inline double _timeStampPeriod = 1.0;
+};
@@ -2,6 +2,8 @@
 #include <Config.h>
 #include "IFeature.h"
 
+#include <NVNGX_Parameter.h>
+
 void IFeature::SetHandle(unsigned int InHandleId)
 {
     _handle = new NVSDK_NGX_Handle { InHandleId };
@@ -173,25 +175,42 @@ bool IFeature::SetInitParameters(NVSDK_NGX_Parameter* InParameters)
 void IFeature::GetRenderResolution(const NVSDK_NGX_Parameter* InParameters, unsigned int* OutWidth,
                                    unsigned int* OutHeight)
 {
-    if (InParameters->Get(NVSDK_NGX_Parameter_DLSS_Render_Subrect_Dimensions_Width, OutWidth) !=
-            NVSDK_NGX_Result_Success ||
-        InParameters->Get(NVSDK_NGX_Parameter_DLSS_Render_Subrect_Dimensions_Height, OutHeight) !=
-            NVSDK_NGX_Result_Success)
+    unsigned int subrectWidth = 0;
+    unsigned int subrectHeight = 0;
+    unsigned int width = 0;
+    unsigned int height = 0;
+    unsigned int outWidth = 0;
+    unsigned int outHeight = 0;
+    JitterInfo ji {};
+
+    // Fetch all per frame values in one batch instead of a Get call for each
+    ParameterRequest requests[] = {
+        { NVSDK_NGX_Parameter_DLSS_Render_Subrect_Dimensions_Width, &subrectWidth },
+        { NVSDK_NGX_Parameter_DLSS_Render_Subrect_Dimensions_Height, &subrectHeight },
+        { NVSDK_NGX_Parameter_Width, &width },
+        { NVSDK_NGX_Parameter_Height, &height },
+        { NVSDK_NGX_Parameter_OutWidth, &outWidth },
+        { NVSDK_NGX_Parameter_OutHeight, &outHeight },
+        { NVSDK_NGX_Parameter_Jitter_Offset_X, &ji.x },
+        { NVSDK_NGX_Parameter_Jitter_Offset_Y, &ji.y },
+    };
+
+    GetNGXParameterValues(InParameters, requests);
+
+    if (requests[0].Found && requests[1].Found)
+    {
+        *OutWidth = subrectWidth;
+        *OutHeight = subrectHeight;
+    }
+    else
     {
         LOG_WARN("No subrect dimension info!");
 
-        unsigned int width;
-        unsigned int height;
-        unsigned int outWidth;
-        unsigned int outHeight;
-
         do
         {
-            if (InParameters->Get(NVSDK_NGX_Parameter_Width, &width) == NVSDK_NGX_Result_Success &&
-                InParameters->Get(NVSDK_NGX_Parameter_Height, &height) == NVSDK_NGX_Result_Success)
+            if (requests[2].Found && requests[3].Found)
             {
-                if (InParameters->Get(NVSDK_NGX_Parameter_OutWidth, &outWidth) == NVSDK_NGX_Result_Success &&
-                    InParameters->Get(NVSDK_NGX_Parameter_OutHeight, &outHeight) == NVSDK_NGX_Result_Success)
+                if (requests[4].Found && requests[5].Found)
                 {
                     if (width < outWidth)
                     {
@@ -236,29 +255,46 @@ void IFeature::GetRenderResolution(const NVSDK_NGX_Parameter* InParameters, unsi
     //	InParameters->Set(NVSDK_NGX_Parameter_SuperSampling_ScaleFactor, 1.0f);
     // }
 
-    JitterInfo ji {};
-    if (_jitterInfo.size() < 350 &&
-        InParameters->Get(NVSDK_NGX_Parameter_Jitter_Offset_X, &ji.x) == NVSDK_NGX_Result_Success &&
-        InParameters->Get(NVSDK_NGX_Parameter_Jitter_Offset_Y, &ji.y) == NVSDK_NGX_Result_Success)
+    if (requests[6].Found && requests[7].Found)
     {
-        _jitterInfo.insert(std::make_pair(ji.x, ji.y));
+        std::scoped_lock lock(_jitterMutex);
+        _jitterAnalyzer.Record(ji.x, ji.y);
     }
 }
 
-float IFeature::GetSharpness(const NVSDK_NGX_Parameter* InParameters)
+IFeature::EvaluateValues IFeature::GetEvaluateValues(const NVSDK_NGX_Parameter* InParameters)
+{
+    EvaluateValues values {};
+
+    // Fetch all per frame values in one batch instead of a Get call for each
+    ParameterRequest requests[] = {
+        { NVSDK_NGX_Parameter_Jitter_Offset_X, &values.JitterX },
+        { NVSDK_NGX_Parameter_Jitter_Offset_Y, &values.JitterY },
+        { NVSDK_NGX_Parameter_MV_Scale_X, &values.MVScaleX },
+        { NVSDK_NGX_Parameter_MV_Scale_Y, &values.MVScaleY },
+        { NVSDK_NGX_Parameter_Sharpness, &values.Sharpness },
+        { NVSDK_NGX_Parameter_Reset, &values.Reset },
+    };
+
+    GetNGXParameterValues(InParameters, requests);
+
+    // Missing scales stay at 1.0
+    values.HasMVScale = requests[2].Found && requests[3].Found;
+
+    return values;
+}
+
+float IFeature::GetSharpness(const EvaluateValues& InValues)
 {
     if (Config::Instance()->OverrideSharpness.value_or_default())
         return Config::Instance()->Sharpness.value_or_default();
 
-    float sharpness = 0.0f;
+    float sharpness = InValues.Sharpness;
 
-    if (InParameters->Get(NVSDK_NGX_Parameter_Sharpness, &sharpness) == NVSDK_NGX_Result_Success)
-    {
-        if (sharpness < 0.0f)
-            sharpness = 0.0f;
-        else if (sharpness > 1.0f)
-            sharpness = 1.0f;
-    }
+    if (sharpness < 0.0f)
+        sharpness = 0.0f;
+    else if (sharpness > 1.0f)
+        sharpness = 1.0f;
 
     return sharpness;
 }
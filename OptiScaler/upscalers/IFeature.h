@@ -4,8 +4,10 @@
 #include <nvsdk_ngx.h>
 #include <nvsdk_ngx_defs.h>
 
-#include <unordered_set>
 #include <Util.h>
+#include <upscalers/JitterAnalyzer.h>
+
+#include <mutex>
 
 #define DLSS_MOD_ID_OFFSET 1000000
 
@@ -36,17 +38,9 @@ class IFeature
         float y;
     };
 
-    struct hashFunction
-    {
-        size_t operator()(const std::pair<float, float>& p) const
-        {
-            size_t h1 = std::hash<float>()(p.first);
-            size_t h2 = std::hash<float>()(p.second);
-            return h1 ^ (h2 << 1);
-        }
-    };
-
-    std::unordered_set<std::pair<float, float>, hashFunction> _jitterInfo;
+    // Recorded on the evaluate thread, read by the menu
+    std::mutex _jitterMutex;
+    jitter_analysis::Analyzer _jitterAnalyzer;
 
   protected:
     // D3D11with12
@@ -77,11 +71,24 @@ class IFeature
     bool _featureFrozen = false;
     bool _moduleLoaded = false;
 
+    // Per frame values every upscaler reads in Evaluate
+    struct EvaluateValues
+    {
+        float JitterX = 0.0f;
+        float JitterY = 0.0f;
+        float MVScaleX = 1.0f;
+        float MVScaleY = 1.0f;
+        float Sharpness = 0.0f;
+        unsigned int Reset = 0;
+        bool HasMVScale = false;
+    };
+
     void SetHandle(unsigned int InHandleId);
     bool SetInitParameters(NVSDK_NGX_Parameter* InParameters);
     void GetRenderResolution(const NVSDK_NGX_Parameter* InParameters, unsigned int* OutWidth, unsigned int* OutHeight);
     void GetDynamicOutputResolution(NVSDK_NGX_Parameter* InParameters, unsigned int* width, unsigned int* height);
-    float GetSharpness(const NVSDK_NGX_Parameter* InParameters);
+    EvaluateValues GetEvaluateValues(const NVSDK_NGX_Parameter* InParameters);
+    float GetSharpness(const EvaluateValues& InValues);
 
     virtual void SetInit(bool InValue) { _isInited = InValue; }
 
@@ -97,7 +104,11 @@ class IFeature
     std::string Name() const { return UpscalerDisplayName(GetUpscalerType()); };
     std::string ShortName() const { return UpscalerShortName(GetUpscalerType()); }; // Without the version
 
-    virtual size_t JitterCount() { return _jitterInfo.size(); }
+    virtual jitter_analysis::Result JitterAnalysis()
+    {
+        std::scoped_lock lock(_jitterMutex);
+        return _jitterAnalyzer.GetResult();
+    }
 
     virtual void TickFrozenCheck();
     virtual bool IsFrozen() { return _featureFrozen; };
@@ -69,9 +69,9 @@ class IFeature_Dx11wDx12 : public virtual IFeature_Dx11
         return CallFeature([](auto f) { return f->Version(); }, feature_version {});
     }
 
-    size_t JitterCount() override
+    jitter_analysis::Result JitterAnalysis() override
     {
-        return CallFeature([](auto f) { return f->JitterCount(); }, size_t {});
+        return CallFeature([](auto f) { return f->JitterAnalysis(); }, jitter_analysis::Result {});
     }
 
     void TickFrozenCheck() override
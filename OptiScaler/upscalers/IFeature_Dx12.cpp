@@ -6,7 +6,7 @@
 #include "IFeature_Dx12.h"
 #include "State.h"
 
-#include "upscaler_time/UpscalerTime_Dx12.h"
+#include "upscaler_time/GpuProfiler_Dx12.h"
 
 void IFeature_Dx12::ResourceBarrier(ID3D12GraphicsCommandList* InCommandList, ID3D12Resource* InResource,
                                     D3D12_RESOURCE_STATES InBeforeState, D3D12_RESOURCE_STATES InAfterState) const
@@ -54,10 +54,12 @@ bool IFeature_Dx12::Evaluate(ID3D12GraphicsCommandList* InCommandList, NVSDK_NGX
         return false;
     }
 
+    auto values = GetEvaluateValues(InParameters);
+
     if (Config::Instance()->OverrideSharpness.value_or_default())
         _sharpness = Config::Instance()->Sharpness.value_or_default();
     else
-        _sharpness = GetSharpness(InParameters);
+        _sharpness = GetSharpness(values);
 
     if (_sharpness > 1.0f)
         _sharpness = 1.0f;
@@ -121,7 +123,11 @@ bool IFeature_Dx12::Evaluate(ID3D12GraphicsCommandList* InCommandList, NVSDK_NGX
                   LOG_DEBUG("Scaling output...");
                   OutputScaler->SetBufferState(InCommandList, D3D12_RESOURCE_STATE_NON_PIXEL_SHADER_RESOURCE);
 
-                  if (!OutputScaler->Dispatch(InCommandList, input, output))
+                  GpuProfilerDx12::Begin(InCommandList, gpu_profiler::Scope::OutputScaling);
+                  auto scaled = OutputScaler->Dispatch(InCommandList, input, output);
+                  GpuProfilerDx12::End(InCommandList, gpu_profiler::Scope::OutputScaling);
+
+                  if (!scaled)
                   {
                       Config::Instance()->OutputScalingEnabled.set_volatile_value(false);
                       State::Instance().changeBackend[Handle()->Id] = true;
@@ -165,8 +171,8 @@ bool IFeature_Dx12::Evaluate(ID3D12GraphicsCommandList* InCommandList, NVSDK_NGX
                   rcasConstants.DepthIsReversed = DepthInverted();
                   rcasConstants.IsHdr = IsHdr();
 
-                  InParameters->Get(NVSDK_NGX_Parameter_MV_Scale_X, &rcasConstants.MvScaleX);
-                  InParameters->Get(NVSDK_NGX_Parameter_MV_Scale_Y, &rcasConstants.MvScaleY);
+                  rcasConstants.MvScaleX = values.MVScaleX;
+                  rcasConstants.MvScaleY = values.MVScaleY;
 
                   float nearPlane = 0.0f;
                   float farPlane = 0.0f;
@@ -185,7 +191,11 @@ bool IFeature_Dx12::Evaluate(ID3D12GraphicsCommandList* InCommandList, NVSDK_NGX
                       rcasConstants.CameraFar = Config::Instance()->FsrCameraFar.value_or_default();
                   }
 
-                  if (!RCAS->Dispatch(InCommandList, input, paramMotion, rcasConstants, output, paramDepth))
+                  GpuProfilerDx12::Begin(InCommandList, gpu_profiler::Scope::RCAS);
+                  auto sharpened = RCAS->Dispatch(InCommandList, input, paramMotion, rcasConstants, output, paramDepth);
+                  GpuProfilerDx12::End(InCommandList, gpu_profiler::Scope::RCAS);
+
+                  if (!sharpened)
                   {
                       Config::Instance()->RcasEnabled.set_volatile_value(false);
                       return false;
@@ -219,7 +229,7 @@ bool IFeature_Dx12::Evaluate(ID3D12GraphicsCommandList* InCommandList, NVSDK_NGX
 
                   Magnifier->SetBufferState(InCommandList, D3D12_RESOURCE_STATE_NON_PIXEL_SHADER_RESOURCE);
 
-                  UpscalerTimeDx12::UpscaleEnd(InCommandList);
+                  GpuProfilerDx12::End(InCommandList, gpu_profiler::Scope::Upscale);
 
                   magnifierRanSuccess = Magnifier->Dispatch(InCommandList, input, output);
 
@@ -0,0 +1,521 @@
+#pragma once
+
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <algorithm>
+
+// Streaming analysis of the jitter offsets a game sends.
+// Finds the phase count (period) of the sequence, checks if jitter is missing or broken,
+// matches it against Halton(2,3) and R2 generators to find unit scale and axis signs.
+// Fixed size ring and hash table, no allocations and O(1) work per recorded frame.
+// No platform dependencies, so it can be tested with generated sequences on any OS.
+namespace jitter_analysis
+{
+
+inline constexpr uint32_t RingSize = 256;
+// Ring's keys fill at most a quarter of the table, so rebuilds at half full are rare
+inline constexpr uint32_t TableSize = RingSize * 4;
+inline constexpr uint32_t MaxPeriod = RingSize / 2;
+
+// Frames needed before anything is reported
+inline constexpr uint32_t WarmupFrames = 32;
+
+// Result is recalculated after this many frames
+inline constexpr uint32_t UpdateFrames = 16;
+
+enum class Status : uint32_t
+{
+    Unknown,
+
+    // All offsets are same (usually 0)
+    Absent,
+
+    // Too few distinct offsets, offsets over a pixel or not finite values
+    Broken,
+
+    // Repeats with a fixed phase count
+    Periodic,
+
+    // Valid offsets without a detected period (random or very long sequence)
+    Aperiodic,
+};
+
+enum class Generator : uint32_t
+{
+    Unknown,
+    Halton23,
+    R2,
+};
+
+struct Result
+{
+    Status State = Status::Unknown;
+    Generator Sequence = Generator::Unknown;
+
+    uint64_t Frames = 0;
+
+    // Distinct offsets in last RingSize frames
+    uint32_t Distinct = 0;
+
+    // Phase count, 0 when not periodic
+    uint32_t Period = 0;
+
+    // Largest offset, about 0.5 when offsets are in pixels
+    float Amplitude = 0.0f;
+
+    // Offset unit in pixels, 1.0 for pixel offsets and 2 / resolution for NDC offsets.
+    // Only valid when Sequence is known
+    float ScaleX = 0.0f;
+    float ScaleY = 0.0f;
+
+    // Axis signs compared to the generator. Only valid when Sequence is known
+    int32_t SignX = 0;
+    int32_t SignY = 0;
+};
+
+// Phase count suggested by DLSS and FSR programming guides for an upscale ratio
+inline uint32_t RecommendedPhases(float upscaleRatio)
+{
+    if (upscaleRatio < 1.0f)
+        upscaleRatio = 1.0f;
+
+    return (uint32_t) std::ceil(8.0f * upscaleRatio * upscaleRatio);
+}
+
+// Texture mip bias the jitter can support.
+// log2(render / display) needs RecommendedPhases, with fewer phases only part of it is resolved
+// and without jitter negative bias only adds aliasing.
+inline float RecommendedMipBias(const Result& result, float renderWidth, float displayWidth)
+{
+    if (renderWidth <= 0.0f || displayWidth <= 0.0f || renderWidth >= displayWidth)
+        return 0.0f;
+
+    if (result.State == Status::Absent || result.State == Status::Broken)
+        return 0.0f;
+
+    auto full = std::log2(renderWidth / displayWidth);
+
+    if (result.State != Status::Periodic)
+        return full;
+
+    auto supported = -0.5f * std::log2(std::max(result.Period / 8.0f, 1.0f));
+    // + 0.0f turns -0 into 0
+    return std::max(full, supported) + 0.0f;
+}
+
+inline float Halton(uint32_t index, uint32_t base)
+{
+    float f = 1.0f;
+    float result = 0.0f;
+
+    while (index > 0)
+    {
+        f /= (float) base;
+        result += f * (float) (index % base);
+        index /= base;
+    }
+
+    return result;
+}
+
+// Centered generator points as games use them
+inline void GeneratorPoint(Generator generator, uint32_t index, float& x, float& y)
+{
+    if (generator == Generator::Halton23)
+    {
+        x = Halton(index, 2) - 0.5f;
+        y = Halton(index, 3) - 0.5f;
+        return;
+    }
+
+    // R2 sequence, plastic constant based
+    constexpr double a1 = 0.7548776662466927;
+    constexpr double a2 = 0.5698402909980532;
+
+    auto fx = 0.5 + a1 * index;
+    auto fy = 0.5 + a2 * index;
+    x = (float) (fx - std::floor(fx)) - 0.5f;
+    y = (float) (fy - std::floor(fy)) - 0.5f;
+}
+
+// Not thread safe
+class Analyzer
+{
+  private:
+    struct Sample
+    {
+        float X = 0.0f;
+        float Y = 0.0f;
+    };
+
+    struct Entry
+    {
+        uint64_t Key = 0;
+        uint64_t LastFrame = 0;
+
+        // Samples of the ring with this key
+        uint32_t Count = 0;
+        bool Used = false;
+    };
+
+    std::array<Sample, RingSize> _ring {};
+    std::array<Entry, TableSize> _table {};
+    uint32_t _tableUsed = 0;
+
+    uint64_t _frames = 0;
+    uint32_t _distinct = 0;
+    uint32_t _invalid = 0;
+
+    uint32_t _candidatePeriod = 0;
+    uint32_t _periodHits = 0;
+    uint32_t _period = 0;
+
+    // Generator match is only redone when a new period is confirmed
+    uint32_t _matchedPeriod = 0;
+    Result _match;
+
+    Result _result;
+
+    // Low mantissa bits are dropped so tiny float noise still hits the same key
+    static uint64_t KeyOf(float x, float y)
+    {
+        uint32_t bx;
+        uint32_t by;
+        memcpy(&bx, &x, sizeof(bx));
+        memcpy(&by, &y, sizeof(by));
+
+        // -0.0 and 0.0 are same offset
+        if ((bx & 0x7FFFFFFF) == 0)
+            bx = 0;
+
+        if ((by & 0x7FFFFFFF) == 0)
+            by = 0;
+
+        return ((uint64_t) (bx & ~0xFu) << 32) | (by & ~0xFu);
+    }
+
+    static uint32_t Hash(uint64_t key)
+    {
+        key ^= key >> 33;
+        key *= 0xFF51AFD7ED558CCDull;
+        key ^= key >> 33;
+        return (uint32_t) key & (TableSize - 1);
+    }
+
+    Entry* Find(uint64_t key)
+    {
+        for (uint32_t i = 0, index = Hash(key); i < TableSize; i++, index = (index + 1) & (TableSize - 1))
+        {
+            auto& entry = _table[index];
+
+            if (!entry.Used)
+                return nullptr;
+
+            if (entry.Key == key)
+                return &entry;
+        }
+
+        return nullptr;
+    }
+
+    Entry* Insert(uint64_t key)
+    {
+        for (uint32_t i = 0, index = Hash(key); i < TableSize; i++, index = (index + 1) & (TableSize - 1))
+        {
+            auto& entry = _table[index];
+
+            if (entry.Used)
+                continue;
+
+            entry = { key, 0, 0, true };
+            _tableUsed++;
+            return &entry;
+        }
+
+        return nullptr;
+    }
+
+    // Keys without samples in the ring pile up with aperiodic jitter, table is rebuilt from the ring
+    // when half full. Happens at most once every RingSize new keys, so cost per frame stays constant.
+    void Rebuild()
+    {
+        std::array<Entry, TableSize> old = _table;
+
+        _table = {};
+        _tableUsed = 0;
+
+        for (auto& entry : old)
+        {
+            if (!entry.Used || entry.Count == 0)
+                continue;
+
+            *Insert(entry.Key) = entry;
+        }
+    }
+
+    static bool IsValid(float x, float y) { return std::isfinite(x) && std::isfinite(y); }
+
+    // Checks if the ring's last cycle is the generator's point set with per axis scale and sign.
+    // Points are compared as a set, so the phase the game starts from doesn't matter.
+    bool MatchGenerator(Generator generator, uint32_t first, uint32_t count, Result& result) const
+    {
+        if (count < 4)
+            return false;
+
+        float maxX = 0.0f;
+        float maxY = 0.0f;
+        float refMaxX = 0.0f;
+        float refMaxY = 0.0f;
+
+        for (uint32_t i = 0; i < count; i++)
+        {
+            auto& sample = _ring[(_frames - 1 - i) % RingSize];
+            maxX = std::max(maxX, std::fabs(sample.X));
+            maxY = std::max(maxY, std::fabs(sample.Y));
+
+            float x;
+            float y;
+            GeneratorPoint(generator, first + i, x, y);
+            refMaxX = std::max(refMaxX, std::fabs(x));
+            refMaxY = std::max(refMaxY, std::fabs(y));
+        }
+
+        if (maxX <= 0.0f || maxY <= 0.0f || refMaxX <= 0.0f || refMaxY <= 0.0f)
+            return false;
+
+        auto scaleX = maxX / refMaxX;
+        auto scaleY = maxY / refMaxY;
+
+        // Points of a cycle are about 1 / count apart
+        auto tolerance = 0.1f / (float) count;
+
+        for (int32_t signX = 1; signX >= -1; signX -= 2)
+        {
+            for (int32_t signY = 1; signY >= -1; signY -= 2)
+            {
+                uint32_t matched = 0;
+
+                for (uint32_t i = 0; i < count; i++)
+                {
+                    float x;
+                    float y;
+                    GeneratorPoint(generator, first + i, x, y);
+
+                    for (uint32_t j = 0; j < count; j++)
+                    {
+                        auto& sample = _ring[(_frames - 1 - j) % RingSize];
+
+                        if (std::fabs(sample.X / scaleX * signX - x) <= tolerance &&
+                            std::fabs(sample.Y / scaleY * signY - y) <= tolerance)
+                        {
+                            matched++;
+                            break;
+                        }
+                    }
+
+                    if (matched != i + 1)
+                        break;
+                }
+
+                if (matched == count)
+                {
+                    result.Sequence = generator;
+                    result.ScaleX = scaleX;
+                    result.ScaleY = scaleY;
+                    result.SignX = signX;
+                    result.SignY = signY;
+                    return true;
+                }
+            }
+        }
+
+        return false;
+    }
+
+    void Update()
+    {
+        Result result;
+        result.Frames = _frames;
+        result.Distinct = _distinct;
+
+        auto window = (uint32_t) std::min<uint64_t>(_frames, RingSize);
+
+        for (uint32_t i = 0; i < window; i++)
+        {
+            auto& sample = _ring[i];
+            result.Amplitude = std::max({ result.Amplitude, std::fabs(sample.X), std::fabs(sample.Y) });
+        }
+
+        if (_frames < WarmupFrames)
+        {
+            _result = result;
+            return;
+        }
+
+        if (_invalid > 0 || _distinct < 4 || result.Amplitude > 1.0f)
+        {
+            result.State = (_invalid == 0 && _distinct <= 1) ? Status::Absent : Status::Broken;
+            _result = result;
+            return;
+        }
+
+        if (_period > 0)
+        {
+            if (_matchedPeriod != _period)
+            {
+                _match = {};
+
+                // Halton sequences usually start from index 1, some start from 0
+                if (!MatchGenerator(Generator::Halton23, 1, _period, _match) &&
+                    !MatchGenerator(Generator::Halton23, 0, _period, _match))
+                {
+                    MatchGenerator(Generator::R2, 0, _period, _match);
+                }
+
+                _matchedPeriod = _period;
+            }
+
+            result.State = Status::Periodic;
+            result.Period = _period;
+            result.Sequence = _match.Sequence;
+            result.ScaleX = _match.ScaleX;
+            result.ScaleY = _match.ScaleY;
+            result.SignX = _match.SignX;
+            result.SignY = _match.SignY;
+        }
+        else
+        {
+            result.State = Status::Aperiodic;
+        }
+
+        _result = result;
+    }
+
+  public:
+    void Record(float x, float y)
+    {
+        auto slot = (uint32_t) (_frames % RingSize);
+
+        // Sample leaving the window
+        if (_frames >= RingSize)
+        {
+            auto& old = _ring[slot];
+
+            if (!IsValid(old.X, old.Y))
+            {
+                _invalid--;
+            }
+            else if (auto entry = Find(KeyOf(old.X, old.Y)); entry != nullptr && entry->Count > 0)
+            {
+                if (--entry->Count == 0)
+                    _distinct--;
+            }
+        }
+
+        _ring[slot] = { x, y };
+        auto frame = _frames++;
+
+        if (!IsValid(x, y))
+        {
+            _invalid++;
+            _candidatePeriod = 0;
+            _periodHits = 0;
+            _period = 0;
+        }
+        else
+        {
+            auto key = KeyOf(x, y);
+            auto entry = Find(key);
+
+            if (entry == nullptr)
+            {
+                if (_tableUsed >= TableSize / 2)
+                    Rebuild();
+
+                entry = Insert(key);
+                entry->LastFrame = frame;
+
+                // New offset, any period seen so far is broken
+                _candidatePeriod = 0;
+                _periodHits = 0;
+                _period = 0;
+            }
+            else
+            {
+                auto lag = frame - entry->LastFrame;
+                entry->LastFrame = frame;
+
+                if (lag == _candidatePeriod)
+                {
+                    // A whole cycle with same lag confirms the period
+                    if (++_periodHits >= _candidatePeriod && _candidatePeriod > 1)
+                        _period = _candidatePeriod;
+                }
+                else
+                {
+                    _candidatePeriod = lag <= MaxPeriod ? (uint32_t) lag : 0;
+                    _periodHits = 1;
+                    _period = 0;
+                }
+            }
+
+            if (entry->Count++ == 0)
+                _distinct++;
+        }
+
+        if (_frames % UpdateFrames == 0)
+            Update();
+    }
+
+    const Result& GetResult() const { return _result; }
+
+    void Reset()
+    {
+        _ring = {};
+        _table = {};
+        _tableUsed = 0;
+        _frames = 0;
+        _distinct = 0;
+        _invalid = 0;
+        _candidatePeriod = 0;
+        _periodHits = 0;
+        _period = 0;
+        _matchedPeriod = 0;
+        _match = {};
+        _result = {};
+    }
+};
+
+inline const char* StatusName(Status status)
+{
+    switch (status)
+    {
+    case Status::Absent:
+        return "Absent";
+    case Status::Broken:
+        return "Broken";
+    case Status::Periodic:
+        return "Periodic";
+    case Status::Aperiodic:
+        return "Aperiodic";
+    default:
+        return "Unknown";
+    }
+}
+
+inline const char* GeneratorName(Generator generator)
+{
+    switch (generator)
+    {
+    case Generator::Halton23:
+        return "Halton(2,3)";
+    case Generator::R2:
+        return "R2";
+    default:
+        return "Unknown";
+    }
+}
+
+} // namespace jitter_analysis
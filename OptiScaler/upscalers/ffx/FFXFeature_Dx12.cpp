@@ -58,8 +58,9 @@ bool FFXFeatureDx12::EvaluateInternal(ID3D12GraphicsCommandList* InCommandList,
     else if (Config::Instance()->FsrNonLinearSRGB.value_or_default())
         params.flags |= FFX_UPSCALE_FLAG_NON_LINEAR_COLOR_SRGB;
 
-    InParameters->Get(NVSDK_NGX_Parameter_Jitter_Offset_X, &params.jitterOffset.x);
-    InParameters->Get(NVSDK_NGX_Parameter_Jitter_Offset_Y, &params.jitterOffset.y);
+    auto values = GetEvaluateValues(InParameters);
+    params.jitterOffset.x = values.JitterX;
+    params.jitterOffset.y = values.JitterY;
 
     params.enableSharpening = _sharpness > 0.0f;
     params.sharpness = _sharpness;
@@ -76,9 +77,7 @@ bool FFXFeatureDx12::EvaluateInternal(ID3D12GraphicsCommandList* InCommandList,
 
     LOG_DEBUG("Jitter Offset: {0}x{1}", params.jitterOffset.x, params.jitterOffset.y);
 
-    unsigned int reset;
-    InParameters->Get(NVSDK_NGX_Parameter_Reset, &reset);
-    params.reset = (reset == 1);
+    params.reset = (values.Reset == 1);
 
     GetRenderResolution(InParameters, &params.renderSize.width, &params.renderSize.height);
 
@@ -312,11 +311,10 @@ bool FFXFeatureDx12::EvaluateInternal(ID3D12GraphicsCommandList* InCommandList,
         ffxResolveTypelessFormat(params.output.description.format);
     }
 
-    params.motionVectorScale.x = 1.0f;
-    params.motionVectorScale.y = 1.0f;
+    params.motionVectorScale.x = values.MVScaleX;
+    params.motionVectorScale.y = values.MVScaleY;
 
-    if (InParameters->Get(NVSDK_NGX_Parameter_MV_Scale_X, &params.motionVectorScale.x) != NVSDK_NGX_Result_Success ||
-        InParameters->Get(NVSDK_NGX_Parameter_MV_Scale_Y, &params.motionVectorScale.y) != NVSDK_NGX_Result_Success)
+    if (!values.HasMVScale)
     {
         LOG_WARN("Can't get motion vector scales!");
     }
@@ -246,12 +246,11 @@ bool FFXFeatureVk::Evaluate(VkCommandBuffer InCmdBuffer, NVSDK_NGX_Parameter* In
     else if (Config::Instance()->FsrNonLinearSRGB.value_or_default())
         params.flags = FFX_UPSCALE_FLAG_NON_LINEAR_COLOR_SRGB;
 
-    InParameters->Get(NVSDK_NGX_Parameter_Jitter_Offset_X, &params.jitterOffset.x);
-    InParameters->Get(NVSDK_NGX_Parameter_Jitter_Offset_Y, &params.jitterOffset.y);
+    auto values = GetEvaluateValues(InParameters);
+    params.jitterOffset.x = values.JitterX;
+    params.jitterOffset.y = values.JitterY;
 
-    unsigned int reset;
-    InParameters->Get(NVSDK_NGX_Parameter_Reset, &reset);
-    params.reset = (reset == 1);
+    params.reset = (values.Reset == 1);
 
     GetRenderResolution(InParameters, &params.renderSize.width, &params.renderSize.height);
 
@@ -415,7 +414,7 @@ bool FFXFeatureVk::Evaluate(VkCommandBuffer InCmdBuffer, NVSDK_NGX_Parameter* In
     VkImageView finalOutputView = paramOutput->Resource.ImageViewInfo.ImageView;
     VkImage finalOutputImage = paramOutput->Resource.ImageViewInfo.Image;
 
-    _sharpness = GetSharpness(InParameters);
+    _sharpness = GetSharpness(values);
     float ssMulti = Config::Instance()->OutputScalingMultiplier.value_or(1.5f);
     bool useSS =
         Config::Instance()->OutputScalingEnabled.value_or_default() && (LowResMV() || RenderWidth() == DisplayWidth());
@@ -494,11 +493,10 @@ bool FFXFeatureVk::Evaluate(VkCommandBuffer InCmdBuffer, NVSDK_NGX_Parameter* In
     _accessToReactiveMask = paramReactiveMask != nullptr || paramReactiveMask2 != nullptr;
     _hasOutput = params.output.resource != nullptr;
 
-    params.motionVectorScale.x = 1.0f;
-    params.motionVectorScale.y = 1.0f;
+    params.motionVectorScale.x = values.MVScaleX;
+    params.motionVectorScale.y = values.MVScaleY;
 
-    if (InParameters->Get(NVSDK_NGX_Parameter_MV_Scale_X, &params.motionVectorScale.x) != NVSDK_NGX_Result_Success ||
-        InParameters->Get(NVSDK_NGX_Parameter_MV_Scale_Y, &params.motionVectorScale.y) != NVSDK_NGX_Result_Success)
+    if (!values.HasMVScale)
     {
         LOG_WARN("Can't get motion vector scales!");
     }
@@ -703,8 +701,8 @@ bool FFXFeatureVk::Evaluate(VkCommandBuffer InCmdBuffer, NVSDK_NGX_Parameter* In
         rcasConstants.DepthIsReversed = DepthInverted();
         rcasConstants.IsHdr = IsHdr();
         rcasConstants.Sharpness = _sharpness;
-        InParameters->Get(NVSDK_NGX_Parameter_MV_Scale_X, &rcasConstants.MvScaleX);
-        InParameters->Get(NVSDK_NGX_Parameter_MV_Scale_Y, &rcasConstants.MvScaleY);
+        rcasConstants.MvScaleX = values.MVScaleX;
+        rcasConstants.MvScaleY = values.MVScaleY;
 
         if (DepthInverted())
         {
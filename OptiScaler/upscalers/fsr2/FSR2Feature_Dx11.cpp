@@ -286,12 +286,11 @@ bool FSR2FeatureDx11::Evaluate(ID3D11DeviceContext* InContext, NVSDK_NGX_Paramet
     FfxFsr2DispatchDescription params {};
     params.commandList = InContext;
 
-    InParameters->Get(NVSDK_NGX_Parameter_Jitter_Offset_X, &params.jitterOffset.x);
-    InParameters->Get(NVSDK_NGX_Parameter_Jitter_Offset_Y, &params.jitterOffset.y);
+    auto values = GetEvaluateValues(InParameters);
+    params.jitterOffset.x = values.JitterX;
+    params.jitterOffset.y = values.JitterY;
 
-    unsigned int reset;
-    InParameters->Get(NVSDK_NGX_Parameter_Reset, &reset);
-    params.reset = (reset == 1);
+    params.reset = (values.Reset == 1);
 
     GetRenderResolution(InParameters, &params.renderSize.width, &params.renderSize.height);
 
@@ -303,7 +302,7 @@ bool FSR2FeatureDx11::Evaluate(ID3D11DeviceContext* InContext, NVSDK_NGX_Paramet
     if (Config::Instance()->OverrideSharpness.value_or_default())
         _sharpness = Config::Instance()->Sharpness.value_or_default();
     else
-        _sharpness = GetSharpness(InParameters);
+        _sharpness = GetSharpness(values);
 
     if (Config::Instance()->RcasEnabled.value_or_default())
     {
@@ -482,11 +481,10 @@ bool FSR2FeatureDx11::Evaluate(ID3D11DeviceContext* InContext, NVSDK_NGX_Paramet
     _accessToReactiveMask = paramReactiveMask != nullptr;
     _hasOutput = params.output.resource != nullptr;
 
-    params.motionVectorScale.x = 1.0f;
-    params.motionVectorScale.y = 1.0f;
+    params.motionVectorScale.x = values.MVScaleX;
+    params.motionVectorScale.y = values.MVScaleY;
 
-    if (InParameters->Get(NVSDK_NGX_Parameter_MV_Scale_X, &params.motionVectorScale.x) != NVSDK_NGX_Result_Success ||
-        InParameters->Get(NVSDK_NGX_Parameter_MV_Scale_Y, &params.motionVectorScale.y) != NVSDK_NGX_Result_Success)
+    if (!values.HasMVScale)
     {
         LOG_WARN("Can't get motion vector scales!");
     }
@@ -541,8 +539,8 @@ bool FSR2FeatureDx11::Evaluate(ID3D11DeviceContext* InContext, NVSDK_NGX_Paramet
         rcasConstants.DepthIsReversed = DepthInverted();
         rcasConstants.IsHdr = IsHdr();
         rcasConstants.Sharpness = _sharpness;
-        InParameters->Get(NVSDK_NGX_Parameter_MV_Scale_X, &rcasConstants.MvScaleX);
-        InParameters->Get(NVSDK_NGX_Parameter_MV_Scale_Y, &rcasConstants.MvScaleY);
+        rcasConstants.MvScaleX = values.MVScaleX;
+        rcasConstants.MvScaleY = values.MVScaleY;
 
         if (DepthInverted())
         {
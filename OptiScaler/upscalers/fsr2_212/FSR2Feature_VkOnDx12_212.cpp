@@ -239,13 +239,14 @@ bool FSR2FeatureVkOnDx12_212::Evaluate(VkCommandBuffer InCmdBuffer, NVSDK_NGX_Pa
     // Set up dispatch parameters
     Fsr212::FfxFsr2DispatchDescription params = {};
 
-    InParameters->Get(NVSDK_NGX_Parameter_Jitter_Offset_X, &params.jitterOffset.x);
-    InParameters->Get(NVSDK_NGX_Parameter_Jitter_Offset_Y, &params.jitterOffset.y);
+    auto values = GetEvaluateValues(InParameters);
+    params.jitterOffset.x = values.JitterX;
+    params.jitterOffset.y = values.JitterY;
 
     if (Config::Instance()->OverrideSharpness.value_or_default())
         _sharpness = Config::Instance()->Sharpness.value_or_default();
     else
-        _sharpness = GetSharpness(InParameters);
+        _sharpness = GetSharpness(values);
 
     if (Config::Instance()->RcasEnabled.value_or_default())
     {
@@ -261,9 +262,7 @@ bool FSR2FeatureVkOnDx12_212::Evaluate(VkCommandBuffer InCmdBuffer, NVSDK_NGX_Pa
         params.sharpness = _sharpness;
     }
 
-    unsigned int reset;
-    InParameters->Get(NVSDK_NGX_Parameter_Reset, &reset);
-    params.reset = (reset == 1);
+    params.reset = (values.Reset == 1);
 
     GetRenderResolution(InParameters, &params.renderSize.width, &params.renderSize.height);
 
@@ -377,12 +376,10 @@ bool FSR2FeatureVkOnDx12_212::Evaluate(VkCommandBuffer InCmdBuffer, NVSDK_NGX_Pa
         _hasTM = params.transparencyAndComposition.resource != nullptr;
         _hasOutput = params.output.resource != nullptr;
 
-        params.motionVectorScale.x = 1.0f;
-        params.motionVectorScale.y = 1.0f;
+        params.motionVectorScale.x = values.MVScaleX;
+        params.motionVectorScale.y = values.MVScaleY;
 
-        if (InParameters->Get(NVSDK_NGX_Parameter_MV_Scale_X, &params.motionVectorScale.x) !=
-                NVSDK_NGX_Result_Success ||
-            InParameters->Get(NVSDK_NGX_Parameter_MV_Scale_Y, &params.motionVectorScale.y) != NVSDK_NGX_Result_Success)
+        if (!values.HasMVScale)
         {
             LOG_WARN("Can't get motion vector scales!");
         }
@@ -477,8 +474,8 @@ bool FSR2FeatureVkOnDx12_212::Evaluate(VkCommandBuffer InCmdBuffer, NVSDK_NGX_Pa
             rcasConstants.DepthIsReversed = DepthInverted();
             rcasConstants.IsHdr = IsHdr();
             rcasConstants.Sharpness = _sharpness;
-            InParameters->Get(NVSDK_NGX_Parameter_MV_Scale_X, &rcasConstants.MvScaleX);
-            InParameters->Get(NVSDK_NGX_Parameter_MV_Scale_Y, &rcasConstants.MvScaleY);
+            rcasConstants.MvScaleX = values.MVScaleX;
+            rcasConstants.MvScaleY = values.MVScaleY;
 
             if (DepthInverted())
             {
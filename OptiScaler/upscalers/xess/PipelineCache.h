@@ -0,0 +1,394 @@
+#pragma once
+
+#include <misc/TreeHash.h>
+
+#include <span>
+#include <string>
+#include <vector>
+#include <cstdio>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <algorithm>
+#include <filesystem>
+
+// Serialized pipeline libraries kept on disk, one file per GPU, driver and library version.
+// Files are only reused when the header, the key and the payload hash match, anything else is
+// treated as a miss and deleted. No platform dependencies, the driver side (CreatePipelineLibrary)
+// is handled by the caller.
+namespace pipeline_cache
+{
+
+inline constexpr uint32_t Magic = 0x5058534F; // "OSXP"
+
+// Increase when the file layout changes, old files are deleted on load
+inline constexpr uint32_t FormatVersion = 1;
+
+inline constexpr const char* Extension = ".psolib";
+
+// Limits of the cache folder, least recently used files are removed first
+inline constexpr size_t MaxFiles = 8;
+inline constexpr uint64_t MaxTotalBytes = 512ull * 1024 * 1024;
+inline constexpr uint64_t MaxFileBytes = 256ull * 1024 * 1024;
+
+struct Key
+{
+    uint32_t VendorId = 0;
+    uint32_t DeviceId = 0;
+    uint32_t SubSysId = 0;
+    uint32_t Revision = 0;
+
+    // UMD version of the driver
+    uint64_t DriverVersion = 0;
+
+    // Version of the library which builds the pipelines (e.g. libxess.dll)
+    uint64_t LibraryVersion = 0;
+
+    bool SameAdapter(const Key& other) const
+    {
+        return VendorId == other.VendorId && DeviceId == other.DeviceId && SubSysId == other.SubSysId &&
+               Revision == other.Revision;
+    }
+
+    bool operator==(const Key&) const = default;
+};
+
+static_assert(sizeof(Key) == 32, "Key is written to the file as is");
+
+inline uint64_t PackVersion(uint32_t major, uint32_t minor, uint32_t patch)
+{
+    return ((uint64_t) major << 40) | ((uint64_t) (minor & 0xFFFFF) << 20) | (patch & 0xFFFFF);
+}
+
+enum class LoadStatus : uint32_t
+{
+    Loaded,
+    Missing,
+    Invalid,
+    OldFormat,
+    KeyMismatch,
+    Corrupt,
+};
+
+inline const char* StatusName(LoadStatus status)
+{
+    switch (status)
+    {
+    case LoadStatus::Loaded:
+        return "Loaded";
+    case LoadStatus::Missing:
+        return "Missing";
+    case LoadStatus::Invalid:
+        return "Invalid";
+    case LoadStatus::OldFormat:
+        return "Old format";
+    case LoadStatus::KeyMismatch:
+        return "Key mismatch";
+    case LoadStatus::Corrupt:
+        return "Corrupt";
+    default:
+        return "Unknown";
+    }
+}
+
+#pragma pack(push, 1)
+struct FileHeader
+{
+    uint32_t Magic;
+    uint32_t Version;
+    Key CacheKey;
+    uint64_t PayloadSize;
+    uint64_t PayloadHash;
+
+    // Hash of the fields above
+    uint64_t HeaderHash;
+};
+#pragma pack(pop)
+
+inline uint64_t HashHeader(const FileHeader& header)
+{
+    return tree_hash::XXH64(reinterpret_cast<const uint8_t*>(&header), offsetof(FileHeader, HeaderHash));
+}
+
+inline FileHeader MakeHeader(const Key& key, std::span<const uint8_t> payload)
+{
+    FileHeader header { Magic, FormatVersion, key, payload.size(), tree_hash::XXH64(payload.data(), payload.size()),
+                        0 };
+    header.HeaderHash = HashHeader(header);
+    return header;
+}
+
+// Checks everything but the payload hash, fileSize is the size of the whole file
+inline LoadStatus CheckHeader(const FileHeader& header, uint64_t fileSize, const Key* key)
+{
+    if (header.Magic != Magic)
+        return LoadStatus::Invalid;
+
+    if (header.Version != FormatVersion)
+        return LoadStatus::OldFormat;
+
+    if (header.HeaderHash != HashHeader(header))
+        return LoadStatus::Corrupt;
+
+    if (header.PayloadSize == 0 || header.PayloadSize > MaxFileBytes ||
+        fileSize != sizeof(FileHeader) + header.PayloadSize)
+        return LoadStatus::Invalid;
+
+    if (key != nullptr && !(header.CacheKey == *key))
+        return LoadStatus::KeyMismatch;
+
+    return LoadStatus::Loaded;
+}
+
+inline std::vector<uint8_t> Serialize(const Key& key, std::span<const uint8_t> payload)
+{
+    std::vector<uint8_t> data(sizeof(FileHeader) + payload.size());
+
+    auto header = MakeHeader(key, payload);
+    memcpy(data.data(), &header, sizeof(header));
+
+    if (!payload.empty())
+        memcpy(data.data() + sizeof(FileHeader), payload.data(), payload.size());
+
+    return data;
+}
+
+// payload is only set when Loaded is returned
+inline LoadStatus Deserialize(std::span<const uint8_t> data, const Key& key, std::vector<uint8_t>& payload)
+{
+    payload.clear();
+
+    if (data.size() < sizeof(FileHeader))
+        return LoadStatus::Invalid;
+
+    FileHeader header;
+    memcpy(&header, data.data(), sizeof(header));
+
+    auto status = CheckHeader(header, data.size(), &key);
+
+    if (status != LoadStatus::Loaded)
+        return status;
+
+    auto body = data.subspan(sizeof(FileHeader));
+
+    if (tree_hash::XXH64(body.data(), body.size()) != header.PayloadHash)
+        return LoadStatus::Corrupt;
+
+    payload.assign(body.begin(), body.end());
+    return LoadStatus::Loaded;
+}
+
+// File name only depends on the key, so versions of the same GPU don't overwrite each other
+inline std::string FileName(const Key& key)
+{
+    char name[32];
+    snprintf(name, sizeof(name), "%016llx%s",
+             (unsigned long long) tree_hash::XXH64(reinterpret_cast<const uint8_t*>(&key), sizeof(key)), Extension);
+    return name;
+}
+
+struct FileInfo
+{
+    // Header could be read and has the current format
+    bool Valid = false;
+    Key CacheKey;
+    uint64_t Size = 0;
+
+    // Loads and saves update the write time, so it's used as last use
+    int64_t LastUse = 0;
+};
+
+// Indexes of the files to delete, keep is never selected.
+// Invalid files and files of the same GPU with another driver or library version go first,
+// they can't be used anymore. Then the least recently used ones until the limits are met.
+inline std::vector<size_t> SelectEvictions(std::span<const FileInfo> files, const Key& keep,
+                                           size_t maxFiles = MaxFiles, uint64_t maxTotalBytes = MaxTotalBytes)
+{
+    std::vector<size_t> evictions;
+    std::vector<size_t> remaining;
+    size_t keptCount = 0;
+    uint64_t totalBytes = 0;
+
+    for (size_t i = 0; i < files.size(); i++)
+    {
+        auto& file = files[i];
+
+        if (file.Valid && file.CacheKey == keep)
+        {
+            keptCount++;
+            totalBytes += file.Size;
+            continue;
+        }
+
+        if (!file.Valid || file.CacheKey.SameAdapter(keep))
+        {
+            evictions.push_back(i);
+            continue;
+        }
+
+        remaining.push_back(i);
+        totalBytes += file.Size;
+    }
+
+    // Oldest first
+    std::sort(remaining.begin(), remaining.end(),
+              [&](size_t a, size_t b) { return files[a].LastUse < files[b].LastUse; });
+
+    // Kept file is counted in the limits too
+    auto fileCount = remaining.size() + keptCount;
+
+    for (auto index : remaining)
+    {
+        if (fileCount <= maxFiles && totalBytes <= maxTotalBytes)
+            break;
+
+        evictions.push_back(index);
+        totalBytes -= files[index].Size;
+        fileCount--;
+    }
+
+    return evictions;
+}
+
+// Cache folder, one instance per folder. Not thread safe, callers serialize Load and Save.
+class Store
+{
+  private:
+    std::filesystem::path _folder;
+
+    void Touch(const std::filesystem::path& path)
+    {
+        std::error_code ec;
+        std::filesystem::last_write_time(path, std::filesystem::file_time_type::clock::now(), ec);
+    }
+
+  public:
+    explicit Store(std::filesystem::path folder) : _folder(std::move(folder)) {}
+
+    const std::filesystem::path& Folder() const { return _folder; }
+    std::filesystem::path PathOf(const Key& key) const { return _folder / FileName(key); }
+
+    LoadStatus Load(const Key& key, std::vector<uint8_t>& payload)
+    {
+        payload.clear();
+
+        auto path = PathOf(key);
+
+        std::error_code ec;
+        auto size = std::filesystem::file_size(path, ec);
+
+        if (ec)
+            return LoadStatus::Missing;
+
+        LoadStatus status = LoadStatus::Invalid;
+
+        if (size >= sizeof(FileHeader) && size <= sizeof(FileHeader) + MaxFileBytes)
+        {
+            std::vector<uint8_t> data(size);
+
+            {
+                std::ifstream file(path, std::ios::binary);
+
+                if (file.read(reinterpret_cast<char*>(data.data()), data.size()))
+                    status = Deserialize(data, key, payload);
+            }
+        }
+
+        // Can't be used with this key, next save writes a new one
+        if (status != LoadStatus::Loaded)
+            std::filesystem::remove(path, ec);
+        else
+            Touch(path);
+
+        return status;
+    }
+
+    // Writes to a temp file and renames so a crash never leaves a half written file
+    bool Save(const Key& key, std::span<const uint8_t> payload)
+    {
+        if (payload.empty() || payload.size() > MaxFileBytes)
+            return false;
+
+        std::error_code ec;
+        std::filesystem::create_directories(_folder, ec);
+
+        auto path = PathOf(key);
+        auto tempPath = path;
+        tempPath += ".tmp";
+
+        {
+            auto header = MakeHeader(key, payload);
+            std::ofstream file(tempPath, std::ios::binary | std::ios::trunc);
+
+            if (!file.write(reinterpret_cast<const char*>(&header), sizeof(header)) ||
+                !file.write(reinterpret_cast<const char*>(payload.data()), payload.size()))
+            {
+                file.close();
+                std::filesystem::remove(tempPath, ec);
+                return false;
+            }
+        }
+
+        std::filesystem::rename(tempPath, path, ec);
+
+        if (ec)
+        {
+            std::filesystem::remove(tempPath, ec);
+            return false;
+        }
+
+        Touch(path);
+        Evict(key);
+
+        return true;
+    }
+
+    void Remove(const Key& key)
+    {
+        std::error_code ec;
+        std::filesystem::remove(PathOf(key), ec);
+    }
+
+    // Returns number of deleted files
+    size_t Evict(const Key& keep)
+    {
+        std::vector<std::filesystem::path> paths;
+        std::vector<FileInfo> files;
+
+        std::error_code ec;
+        for (auto& entry : std::filesystem::directory_iterator(_folder, ec))
+        {
+            if (!entry.is_regular_file(ec) || entry.path().extension() != Extension)
+                continue;
+
+            FileInfo info;
+            info.Size = entry.file_size(ec);
+            info.LastUse = ec ? 0 : entry.last_write_time(ec).time_since_epoch().count();
+
+            FileHeader header;
+            std::ifstream file(entry.path(), std::ios::binary);
+
+            if (file.read(reinterpret_cast<char*>(&header), sizeof(header)))
+            {
+                info.Valid = CheckHeader(header, info.Size, nullptr) == LoadStatus::Loaded;
+                info.CacheKey = header.CacheKey;
+            }
+
+            paths.push_back(entry.path());
+            files.push_back(info);
+        }
+
+        size_t deleted = 0;
+
+        for (auto index : SelectEvictions(files, keep))
+        {
+            if (std::filesystem::remove(paths[index], ec))
+                deleted++;
+        }
+
+        return deleted;
+    }
+};
+
+} // namespace pipeline_cache
@@ -3,6 +3,7 @@
 #include "XeSSFeature.h"
 #include <Config.h>
 #include <Util.h>
+#include <misc/IdentifyGpu.h>
 
 #include <include/detours/detours.h>
 #include <include/d3dx/d3dx12.h>
@@ -14,6 +15,136 @@ inline void XeSSLogCallback(const char* Message, xess_logging_level_t Level)
     spdlog::log((spdlog::level::level_enum) logLevel, "XeSSFeature::LogCallback XeSS Runtime ({0})", Message);
 }
 
+static std::mutex _pipelineCacheMutex;
+
+static pipeline_cache::Store& PipelineCacheStore()
+{
+    static pipeline_cache::Store store(Util::DllPath().parent_path() / "OptiScaler.xesscache");
+    return store;
+}
+
+// Real adapter ids and driver version, cache must not follow spoofing
+static bool GetPipelineCacheKey(ID3D12Device* device, pipeline_cache::Key& key)
+{
+    auto luid = device->GetAdapterLuid();
+
+    for (auto& gpu : IdentifyGpu::getAllGpus())
+    {
+        if (!IsEqualLUID(gpu.luid, luid))
+            continue;
+
+        if (gpu.driverVersion == 0)
+            return false;
+
+        auto version = XeSSProxy::Version();
+
+        key.VendorId = (uint32_t) gpu.vendorId;
+        key.DeviceId = gpu.deviceId;
+        key.SubSysId = gpu.subsystemId;
+        key.Revision = gpu.revisionId;
+        key.DriverVersion = gpu.driverVersion;
+        key.LibraryVersion = pipeline_cache::PackVersion(version.major, version.minor, version.patch);
+
+        return true;
+    }
+
+    return false;
+}
+
+void XeSSFeature::CreatePipelineLibrary(ID3D12Device* device, ID3D12Device1* device1, bool useCache)
+{
+    SAFE_RELEASE(_localPipeline);
+    _pipelineCacheData.reset();
+
+    _pipelineCacheEnabled =
+        Config::Instance()->XeSSPipelineCache.value_or_default() && GetPipelineCacheKey(device, _pipelineCacheKey);
+
+    if (_pipelineCacheEnabled && useCache)
+    {
+        auto data = std::make_shared<std::vector<uint8_t>>();
+        pipeline_cache::LoadStatus status;
+
+        {
+            std::scoped_lock lock(_pipelineCacheMutex);
+            status = PipelineCacheStore().Load(_pipelineCacheKey, *data);
+        }
+
+        LOG_DEBUG("XeSS pipeline cache: {}", pipeline_cache::StatusName(status));
+
+        if (status == pipeline_cache::LoadStatus::Loaded)
+        {
+            HRESULT hr = device1->CreatePipelineLibrary(data->data(), data->size(), IID_PPV_ARGS(&_localPipeline));
+
+            if (SUCCEEDED(hr) && _localPipeline != nullptr)
+            {
+                LOG_INFO("Using cached XeSS pipelines, {} bytes", data->size());
+                _pipelineCacheData = data;
+                return;
+            }
+
+            // D3D12_ERROR_DRIVER_VERSION_MISMATCH, D3D12_ERROR_ADAPTER_NOT_FOUND or data rejected by the driver
+            LOG_WARN("CreatePipelineLibrary with cached data failed {0:x}, building pipelines from scratch",
+                     (UINT) hr);
+
+            std::scoped_lock lock(_pipelineCacheMutex);
+            PipelineCacheStore().Remove(_pipelineCacheKey);
+        }
+    }
+
+    HRESULT hr = device1->CreatePipelineLibrary(nullptr, 0, IID_PPV_ARGS(&_localPipeline));
+
+    if (FAILED(hr) || _localPipeline == nullptr)
+    {
+        LOG_ERROR("CreatePipelineLibrary failed {0:x}!", (UINT) hr);
+        _localPipeline = nullptr;
+    }
+}
+
+void XeSSFeature::SavePipelineCache()
+{
+    if (_pipelineCacheSaved)
+        return;
+
+    _pipelineCacheSaved = true;
+
+    if (!_pipelineCacheEnabled || _localPipeline == nullptr)
+        return;
+
+    _localPipeline->AddRef();
+
+    std::thread(
+        [library = _localPipeline, data = _pipelineCacheData, key = _pipelineCacheKey]()
+        {
+            auto size = library->GetSerializedSize();
+
+            // Nothing was added to the loaded library
+            if (size == 0 || (data != nullptr && data->size() == size))
+            {
+                LOG_DEBUG("XeSS pipeline cache is up to date");
+                library->Release();
+                return;
+            }
+
+            std::vector<uint8_t> blob(size);
+            HRESULT hr = library->Serialize(blob.data(), blob.size());
+            library->Release();
+
+            if (FAILED(hr))
+            {
+                LOG_ERROR("ID3D12PipelineLibrary::Serialize failed {0:x}!", (UINT) hr);
+                return;
+            }
+
+            std::scoped_lock lock(_pipelineCacheMutex);
+
+            if (PipelineCacheStore().Save(key, blob))
+                LOG_INFO("Saved XeSS pipeline cache, {} bytes", blob.size());
+            else
+                LOG_ERROR("Can't save XeSS pipeline cache!");
+        })
+        .detach();
+}
+
 bool XeSSFeature::InitXeSS(ID3D12Device* device, const NVSDK_NGX_Parameter* InParameters)
 {
     LOG_FUNC();
@@ -269,17 +400,35 @@ bool XeSSFeature::InitXeSS(ID3D12Device* device, const NVSDK_NGX_Parameter* InPa
             }
             else
             {
-                HRESULT hr = device1->CreatePipelineLibrary(nullptr, 0, IID_PPV_ARGS(&_localPipeline));
+                CreatePipelineLibrary(device, device1, true);
 
-                if (FAILED(hr) || !_localPipeline)
+                if (_localPipeline == nullptr)
                 {
-                    LOG_ERROR("CreatePipelineLibrary failed {0:x}!", (UINT) hr);
                     ret = XeSSProxy::D3D12BuildPipelines()(_xessContext, NULL, false, xessParams.initFlags);
                 }
                 else
                 {
                     ret = XeSSProxy::D3D12BuildPipelines()(_xessContext, _localPipeline, false, xessParams.initFlags);
 
+                    // Cached library might be incompatible with this XeSS runtime, retry with an empty one
+                    if (ret != XESS_RESULT_SUCCESS && _pipelineCacheData != nullptr)
+                    {
+                        LOG_WARN("xessD3D12BuildPipelines error with cached pipelines: {0}", ResultToString(ret));
+
+                        {
+                            std::scoped_lock lock(_pipelineCacheMutex);
+                            PipelineCacheStore().Remove(_pipelineCacheKey);
+                        }
+
+                        CreatePipelineLibrary(device, device1, false);
+
+                        if (_localPipeline != nullptr)
+                        {
+                            ret = XeSSProxy::D3D12BuildPipelines()(_xessContext, _localPipeline, false,
+                                                                   xessParams.initFlags);
+                        }
+                    }
+
                     if (ret != XESS_RESULT_SUCCESS)
                     {
                         LOG_ERROR("xessD3D12BuildPipelines error with _localPipeline: {0}", ResultToString(ret));
@@ -4,6 +4,9 @@
 
 #include <proxies/XeSS_Proxy.h>
 
+#include "PipelineCache.h"
+
+#include <memory>
 #include <string>
 
 inline static std::string ResultToString(xess_result_t result)
@@ -51,6 +54,14 @@ class XeSSFeature : public virtual IFeature
     ID3D12Heap* _localBufferHeap = nullptr;
     ID3D12Heap* _localTextureHeap = nullptr;
 
+    // Library keeps using the cached data, it has to live as long as _localPipeline
+    std::shared_ptr<std::vector<uint8_t>> _pipelineCacheData;
+    pipeline_cache::Key _pipelineCacheKey {};
+    bool _pipelineCacheEnabled = false;
+    bool _pipelineCacheSaved = false;
+
+    void CreatePipelineLibrary(ID3D12Device* device, ID3D12Device1* device1, bool useCache);
+
   protected:
     xess_context_handle_t _xessContext = nullptr;
 
@@ -59,6 +70,9 @@ class XeSSFeature : public virtual IFeature
 
     bool InitXeSS(ID3D12Device* device, const NVSDK_NGX_Parameter* InParameters);
 
+    // Writes the pipeline library on a background thread, only once per feature
+    void SavePipelineCache();
+
   public:
     feature_version Version() override
     {
@@ -1,5 +1,6 @@
 #include <pch.h>
 #include "XeSSFeature_Dx11.h"
+#include <NVNGX_Parameter.h>
 #include <imgui/ImGuiNotify.hpp>
 
 static std::string ResultToString(xess_result_t result)
@@ -326,18 +327,19 @@ bool XeSSFeature_Dx11::Evaluate(ID3D11DeviceContext* DeviceContext, NVSDK_NGX_Pa
     xess_result_t xessResult;
     xess_d3d11_execute_params_t params {};
 
-    InParameters->Get(NVSDK_NGX_Parameter_Jitter_Offset_X, &params.jitterOffsetX);
-    InParameters->Get(NVSDK_NGX_Parameter_Jitter_Offset_Y, &params.jitterOffsetY);
+    auto values = GetEvaluateValues(InParameters);
+    params.jitterOffsetX = values.JitterX;
+    params.jitterOffsetY = values.JitterY;
 
     if (InParameters->Get(NVSDK_NGX_Parameter_DLSS_Exposure_Scale, &params.exposureScale) != NVSDK_NGX_Result_Success ||
         params.exposureScale <= 0.0f)
         params.exposureScale = 1.0f;
 
-    InParameters->Get(NVSDK_NGX_Parameter_Reset, &params.resetHistory);
+    params.resetHistory = values.Reset;
 
     GetRenderResolution(InParameters, &params.inputWidth, &params.inputHeight);
 
-    _sharpness = GetSharpness(InParameters);
+    _sharpness = GetSharpness(values);
 
     float ssMulti = Config::Instance()->OutputScalingMultiplier.value_or(1.5f);
 
@@ -482,13 +484,9 @@ bool XeSSFeature_Dx11::Evaluate(ID3D11DeviceContext* DeviceContext, NVSDK_NGX_Pa
     _hasExposure = params.pExposureScaleTexture != nullptr;
     _accessToReactiveMask = params.pResponsivePixelMaskTexture != nullptr;
 
-    float MVScaleX = 1.0f;
-    float MVScaleY = 1.0f;
-
-    if (InParameters->Get(NVSDK_NGX_Parameter_MV_Scale_X, &MVScaleX) == NVSDK_NGX_Result_Success &&
-        InParameters->Get(NVSDK_NGX_Parameter_MV_Scale_Y, &MVScaleY) == NVSDK_NGX_Result_Success)
+    if (values.HasMVScale)
     {
-        xessResult = XeSSProxy::D3D11SetVelocityScale()(_xessContext, MVScaleX, MVScaleY);
+        xessResult = XeSSProxy::D3D11SetVelocityScale()(_xessContext, values.MVScaleX, values.MVScaleY);
 
         if (xessResult != XESS_RESULT_SUCCESS)
         {
@@ -499,18 +497,21 @@ bool XeSSFeature_Dx11::Evaluate(ID3D11DeviceContext* DeviceContext, NVSDK_NGX_Pa
     else
         LOG_WARN("Can't get motion vector scales!");
 
-    InParameters->Get(NVSDK_NGX_Parameter_DLSS_Input_Color_Subrect_Base_X, &params.inputColorBase.x);
-    InParameters->Get(NVSDK_NGX_Parameter_DLSS_Input_Color_Subrect_Base_Y, &params.inputColorBase.y);
-    InParameters->Get(NVSDK_NGX_Parameter_DLSS_Input_Depth_Subrect_Base_X, &params.inputDepthBase.x);
-    InParameters->Get(NVSDK_NGX_Parameter_DLSS_Input_Depth_Subrect_Base_Y, &params.inputDepthBase.y);
-    InParameters->Get(NVSDK_NGX_Parameter_DLSS_Input_MV_SubrectBase_X, &params.inputMotionVectorBase.x);
-    InParameters->Get(NVSDK_NGX_Parameter_DLSS_Input_MV_SubrectBase_Y, &params.inputMotionVectorBase.y);
-    InParameters->Get(NVSDK_NGX_Parameter_DLSS_Output_Subrect_Base_X, &params.outputColorBase.x);
-    InParameters->Get(NVSDK_NGX_Parameter_DLSS_Output_Subrect_Base_Y, &params.outputColorBase.y);
-    InParameters->Get(NVSDK_NGX_Parameter_DLSS_Input_Bias_Current_Color_SubrectBase_X,
-                      &params.inputResponsiveMaskBase.x);
-    InParameters->Get(NVSDK_NGX_Parameter_DLSS_Input_Bias_Current_Color_SubrectBase_Y,
-                      &params.inputResponsiveMaskBase.y);
+    // Subrect bases stay at 0 when the game doesn't set them
+    ParameterRequest subrectRequests[] = {
+        { NVSDK_NGX_Parameter_DLSS_Input_Color_Subrect_Base_X, &params.inputColorBase.x },
+        { NVSDK_NGX_Parameter_DLSS_Input_Color_Subrect_Base_Y, &params.inputColorBase.y },
+        { NVSDK_NGX_Parameter_DLSS_Input_Depth_Subrect_Base_X, &params.inputDepthBase.x },
+        { NVSDK_NGX_Parameter_DLSS_Input_Depth_Subrect_Base_Y, &params.inputDepthBase.y },
+        { NVSDK_NGX_Parameter_DLSS_Input_MV_SubrectBase_X, &params.inputMotionVectorBase.x },
+        { NVSDK_NGX_Parameter_DLSS_Input_MV_SubrectBase_Y, &params.inputMotionVectorBase.y },
+        { NVSDK_NGX_Parameter_DLSS_Output_Subrect_Base_X, &params.outputColorBase.x },
+        { NVSDK_NGX_Parameter_DLSS_Output_Subrect_Base_Y, &params.outputColorBase.y },
+        { NVSDK_NGX_Parameter_DLSS_Input_Bias_Current_Color_SubrectBase_X, &params.inputResponsiveMaskBase.x },
+        { NVSDK_NGX_Parameter_DLSS_Input_Bias_Current_Color_SubrectBase_Y, &params.inputResponsiveMaskBase.y },
+    };
+
+    GetNGXParameterValues(InParameters, subrectRequests);
 
     LOG_DEBUG("Executing!!");
     xessResult = XeSSProxy::D3D11Execute()(_xessContext, &params);
@@ -532,8 +533,8 @@ bool XeSSFeature_Dx11::Evaluate(ID3D11DeviceContext* DeviceContext, NVSDK_NGX_Pa
         rcasConstants.DepthIsReversed = DepthInverted();
         rcasConstants.IsHdr = IsHdr();
         rcasConstants.Sharpness = _sharpness;
-        InParameters->Get(NVSDK_NGX_Parameter_MV_Scale_X, &rcasConstants.MvScaleX);
-        InParameters->Get(NVSDK_NGX_Parameter_MV_Scale_Y, &rcasConstants.MvScaleY);
+        rcasConstants.MvScaleX = values.MVScaleX;
+        rcasConstants.MvScaleY = values.MVScaleY;
         rcasConstants.CameraNear = Config::Instance()->FsrCameraNear.value_or_default();
         rcasConstants.CameraFar = Config::Instance()->FsrCameraFar.value_or_default();
 
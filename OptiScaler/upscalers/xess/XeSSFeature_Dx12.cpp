@@ -2,6 +2,7 @@
 #include <Config.h>
 
 #include "XeSSFeature_Dx12.h"
+#include <NVNGX_Parameter.h>
 
 bool XeSSFeatureDx12::InitInternal(ID3D12GraphicsCommandList* InCommandList, NVSDK_NGX_Parameter* InParameters)
 {
@@ -48,14 +49,15 @@ bool XeSSFeatureDx12::EvaluateInternal(ID3D12GraphicsCommandList* InCommandList,
 
     xess_d3d12_execute_params_t params {};
 
-    InParameters->Get(NVSDK_NGX_Parameter_Jitter_Offset_X, &params.jitterOffsetX);
-    InParameters->Get(NVSDK_NGX_Parameter_Jitter_Offset_Y, &params.jitterOffsetY);
+    auto values = GetEvaluateValues(InParameters);
+    params.jitterOffsetX = values.JitterX;
+    params.jitterOffsetY = values.JitterY;
 
     if (InParameters->Get(NVSDK_NGX_Parameter_DLSS_Exposure_Scale, &params.exposureScale) != NVSDK_NGX_Result_Success ||
         params.exposureScale <= 0.0f)
         params.exposureScale = 1.0f;
 
-    InParameters->Get(NVSDK_NGX_Parameter_Reset, &params.resetHistory);
+    params.resetHistory = values.Reset;
 
     GetRenderResolution(InParameters, &params.inputWidth, &params.inputHeight);
 
@@ -274,13 +276,9 @@ bool XeSSFeatureDx12::EvaluateInternal(ID3D12GraphicsCommandList* InCommandList,
     _hasExposure = params.pExposureScaleTexture != nullptr;
     _accessToReactiveMask = paramReactiveMask != nullptr;
 
-    float MVScaleX = 1.0f;
-    float MVScaleY = 1.0f;
-
-    if (InParameters->Get(NVSDK_NGX_Parameter_MV_Scale_X, &MVScaleX) == NVSDK_NGX_Result_Success &&
-        InParameters->Get(NVSDK_NGX_Parameter_MV_Scale_Y, &MVScaleY) == NVSDK_NGX_Result_Success)
+    if (values.HasMVScale)
     {
-        xessResult = XeSSProxy::SetVelocityScale()(_xessContext, MVScaleX, MVScaleY);
+        xessResult = XeSSProxy::SetVelocityScale()(_xessContext, values.MVScaleX, values.MVScaleY);
 
         if (xessResult != XESS_RESULT_SUCCESS)
         {
@@ -291,18 +289,21 @@ bool XeSSFeatureDx12::EvaluateInternal(ID3D12GraphicsCommandList* InCommandList,
     else
         LOG_WARN("Can't get motion vector scales!");
 
-    InParameters->Get(NVSDK_NGX_Parameter_DLSS_Input_Color_Subrect_Base_X, &params.inputColorBase.x);
-    InParameters->Get(NVSDK_NGX_Parameter_DLSS_Input_Color_Subrect_Base_Y, &params.inputColorBase.y);
-    InParameters->Get(NVSDK_NGX_Parameter_DLSS_Input_Depth_Subrect_Base_X, &params.inputDepthBase.x);
-    InParameters->Get(NVSDK_NGX_Parameter_DLSS_Input_Depth_Subrect_Base_Y, &params.inputDepthBase.y);
-    InParameters->Get(NVSDK_NGX_Parameter_DLSS_Input_MV_SubrectBase_X, &params.inputMotionVectorBase.x);
-    InParameters->Get(NVSDK_NGX_Parameter_DLSS_Input_MV_SubrectBase_Y, &params.inputMotionVectorBase.y);
-    InParameters->Get(NVSDK_NGX_Parameter_DLSS_Output_Subrect_Base_X, &params.outputColorBase.x);
-    InParameters->Get(NVSDK_NGX_Parameter_DLSS_Output_Subrect_Base_Y, &params.outputColorBase.y);
-    InParameters->Get(NVSDK_NGX_Parameter_DLSS_Input_Bias_Current_Color_SubrectBase_X,
-                      &params.inputResponsiveMaskBase.x);
-    InParameters->Get(NVSDK_NGX_Parameter_DLSS_Input_Bias_Current_Color_SubrectBase_Y,
-                      &params.inputResponsiveMaskBase.y);
+    // Subrect bases stay at 0 when the game doesn't set them
+    ParameterRequest subrectRequests[] = {
+        { NVSDK_NGX_Parameter_DLSS_Input_Color_Subrect_Base_X, &params.inputColorBase.x },
+        { NVSDK_NGX_Parameter_DLSS_Input_Color_Subrect_Base_Y, &params.inputColorBase.y },
+        { NVSDK_NGX_Parameter_DLSS_Input_Depth_Subrect_Base_X, &params.inputDepthBase.x },
+        { NVSDK_NGX_Parameter_DLSS_Input_Depth_Subrect_Base_Y, &params.inputDepthBase.y },
+        { NVSDK_NGX_Parameter_DLSS_Input_MV_SubrectBase_X, &params.inputMotionVectorBase.x },
+        { NVSDK_NGX_Parameter_DLSS_Input_MV_SubrectBase_Y, &params.inputMotionVectorBase.y },
+        { NVSDK_NGX_Parameter_DLSS_Output_Subrect_Base_X, &params.outputColorBase.x },
+        { NVSDK_NGX_Parameter_DLSS_Output_Subrect_Base_Y, &params.outputColorBase.y },
+        { NVSDK_NGX_Parameter_DLSS_Input_Bias_Current_Color_SubrectBase_X, &params.inputResponsiveMaskBase.x },
+        { NVSDK_NGX_Parameter_DLSS_Input_Bias_Current_Color_SubrectBase_Y, &params.inputResponsiveMaskBase.y },
+    };
+
+    GetNGXParameterValues(InParameters, subrectRequests);
 
     LOG_DEBUG("Executing!!");
     xessResult = XeSSProxy::D3D12Execute()(_xessContext, InCommandList, &params);
@@ -339,6 +340,8 @@ bool XeSSFeatureDx12::EvaluateInternal(ID3D12GraphicsCommandList* InCommandList,
                         D3D12_RESOURCE_STATE_NON_PIXEL_SHADER_RESOURCE,
                         (D3D12_RESOURCE_STATES) Config::Instance()->MaskResourceBarrier.value());
 
+    SavePipelineCache();
+
     _frameCount++;
 
     return true;
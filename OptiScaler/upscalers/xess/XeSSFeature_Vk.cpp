@@ -1,5 +1,6 @@
 #include <pch.h>
 #include "XeSSFeature_Vk.h"
+#include <NVNGX_Parameter.h>
 #include <nvsdk_ngx_vk.h>
 #include <imgui/ImGuiNotify.hpp>
 
@@ -322,18 +323,19 @@ bool XeSSFeature_Vk::Evaluate(VkCommandBuffer InCmdBuffer, NVSDK_NGX_Parameter*
     xess_result_t xessResult;
     xess_vk_execute_params_t params {};
 
-    InParameters->Get(NVSDK_NGX_Parameter_Jitter_Offset_X, &params.jitterOffsetX);
-    InParameters->Get(NVSDK_NGX_Parameter_Jitter_Offset_Y, &params.jitterOffsetY);
+    auto values = GetEvaluateValues(InParameters);
+    params.jitterOffsetX = values.JitterX;
+    params.jitterOffsetY = values.JitterY;
 
     if (InParameters->Get(NVSDK_NGX_Parameter_DLSS_Exposure_Scale, &params.exposureScale) != NVSDK_NGX_Result_Success ||
         params.exposureScale <= 0.0f)
         params.exposureScale = 1.0f;
 
-    InParameters->Get(NVSDK_NGX_Parameter_Reset, &params.resetHistory);
+    params.resetHistory = values.Reset;
 
     GetRenderResolution(InParameters, &params.inputWidth, &params.inputHeight);
 
-    _sharpness = GetSharpness(InParameters);
+    _sharpness = GetSharpness(values);
 
     float ssMulti = Config::Instance()->OutputScalingMultiplier.value_or(1.5f);
     bool useSS =
@@ -472,13 +474,9 @@ bool XeSSFeature_Vk::Evaluate(VkCommandBuffer InCmdBuffer, NVSDK_NGX_Parameter*
     _hasExposure = params.exposureScaleTexture.image != VK_NULL_HANDLE;
     _accessToReactiveMask = params.responsivePixelMaskTexture.image != VK_NULL_HANDLE;
 
-    float MVScaleX = 1.0f;
-    float MVScaleY = 1.0f;
-
-    if (InParameters->Get(NVSDK_NGX_Parameter_MV_Scale_X, &MVScaleX) == NVSDK_NGX_Result_Success &&
-        InParameters->Get(NVSDK_NGX_Parameter_MV_Scale_Y, &MVScaleY) == NVSDK_NGX_Result_Success)
+    if (values.HasMVScale)
     {
-        xessResult = XeSSProxy::SetVelocityScale()(_xessContext, MVScaleX, MVScaleY);
+        xessResult = XeSSProxy::SetVelocityScale()(_xessContext, values.MVScaleX, values.MVScaleY);
 
         if (xessResult != XESS_RESULT_SUCCESS)
         {
@@ -489,18 +487,21 @@ bool XeSSFeature_Vk::Evaluate(VkCommandBuffer InCmdBuffer, NVSDK_NGX_Parameter*
     else
         LOG_WARN("Can't get motion vector scales!");
 
-    InParameters->Get(NVSDK_NGX_Parameter_DLSS_Input_Color_Subrect_Base_X, &params.inputColorBase.x);
-    InParameters->Get(NVSDK_NGX_Parameter_DLSS_Input_Color_Subrect_Base_Y, &params.inputColorBase.y);
-    InParameters->Get(NVSDK_NGX_Parameter_DLSS_Input_Depth_Subrect_Base_X, &params.inputDepthBase.x);
-    InParameters->Get(NVSDK_NGX_Parameter_DLSS_Input_Depth_Subrect_Base_Y, &params.inputDepthBase.y);
-    InParameters->Get(NVSDK_NGX_Parameter_DLSS_Input_MV_SubrectBase_X, &params.inputMotionVectorBase.x);
-    InParameters->Get(NVSDK_NGX_Parameter_DLSS_Input_MV_SubrectBase_Y, &params.inputMotionVectorBase.y);
-    InParameters->Get(NVSDK_NGX_Parameter_DLSS_Output_Subrect_Base_X, &params.outputColorBase.x);
-    InParameters->Get(NVSDK_NGX_Parameter_DLSS_Output_Subrect_Base_Y, &params.outputColorBase.y);
-    InParameters->Get(NVSDK_NGX_Parameter_DLSS_Input_Bias_Current_Color_SubrectBase_X,
-                      &params.inputResponsiveMaskBase.x);
-    InParameters->Get(NVSDK_NGX_Parameter_DLSS_Input_Bias_Current_Color_SubrectBase_Y,
-                      &params.inputResponsiveMaskBase.y);
+    // Subrect bases stay at 0 when the game doesn't set them
+    ParameterRequest subrectRequests[] = {
+        { NVSDK_NGX_Parameter_DLSS_Input_Color_Subrect_Base_X, &params.inputColorBase.x },
+        { NVSDK_NGX_Parameter_DLSS_Input_Color_Subrect_Base_Y, &params.inputColorBase.y },
+        { NVSDK_NGX_Parameter_DLSS_Input_Depth_Subrect_Base_X, &params.inputDepthBase.x },
+        { NVSDK_NGX_Parameter_DLSS_Input_Depth_Subrect_Base_Y, &params.inputDepthBase.y },
+        { NVSDK_NGX_Parameter_DLSS_Input_MV_SubrectBase_X, &params.inputMotionVectorBase.x },
+        { NVSDK_NGX_Parameter_DLSS_Input_MV_SubrectBase_Y, &params.inputMotionVectorBase.y },
+        { NVSDK_NGX_Parameter_DLSS_Output_Subrect_Base_X, &params.outputColorBase.x },
+        { NVSDK_NGX_Parameter_DLSS_Output_Subrect_Base_Y, &params.outputColorBase.y },
+        { NVSDK_NGX_Parameter_DLSS_Input_Bias_Current_Color_SubrectBase_X, &params.inputResponsiveMaskBase.x },
+        { NVSDK_NGX_Parameter_DLSS_Input_Bias_Current_Color_SubrectBase_Y, &params.inputResponsiveMaskBase.y },
+    };
+
+    GetNGXParameterValues(InParameters, subrectRequests);
 
     VkImageView finalOutputView = params.outputTexture.imageView;
     VkImage finalOutputImage = params.outputTexture.image;
@@ -617,8 +618,8 @@ bool XeSSFeature_Vk::Evaluate(VkCommandBuffer InCmdBuffer, NVSDK_NGX_Parameter*
         rcasConstants.DepthIsReversed = DepthInverted();
         rcasConstants.IsHdr = IsHdr();
         rcasConstants.Sharpness = _sharpness;
-        InParameters->Get(NVSDK_NGX_Parameter_MV_Scale_X, &rcasConstants.MvScaleX);
-        InParameters->Get(NVSDK_NGX_Parameter_MV_Scale_Y, &rcasConstants.MvScaleY);
+        rcasConstants.MvScaleX = values.MVScaleX;
+        rcasConstants.MvScaleY = values.MVScaleY;
         rcasConstants.CameraNear = Config::Instance()->FsrCameraNear.value_or_default();
         rcasConstants.CameraFar = Config::Instance()->FsrCameraFar.value_or_default();
 
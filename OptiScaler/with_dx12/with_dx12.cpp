@@ -4,6 +4,7 @@
 
 #include <proxies/DXGI_Proxy.h>
 #include <proxies/D3D12_Proxy.h>
+#include <shaders/Shader_Common.h>
 
 HRESULT CreateD3D12DeviceOnAdapter(IDXGIAdapter* adapter, D3D_FEATURE_LEVEL featureLevel, ID3D12Device** device)
 {
@@ -42,6 +43,9 @@ void WithDx12::SetD3D12Objects(ID3D12Device* InDevice, ID3D12CommandQueue* InCom
     UpdateStateObjects();
 
     LOG_DEBUG("Using D3D12 objects, device: {:X}, queue: {:X}", (size_t) _d3d12Device, (size_t) _d3d12CommandQueue);
+
+    // Device is going to present, probe devices never get here
+    WarmupDx12Shaders(_d3d12Device);
 }
 
 bool WithDx12::PrepareD3D12ForD3D11(ID3D11Device* InDx11Device, D3D_FEATURE_LEVEL InFeatureLevel)
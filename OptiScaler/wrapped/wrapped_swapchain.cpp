@@ -11,8 +11,8 @@
 #include <menu/menu_overlay_dx.h>
 
 #include <misc/FrameLimit.h>
-#include <upscaler_time/UpscalerTime_Dx11.h>
-#include <upscaler_time/UpscalerTime_Dx12.h>
+#include <upscaler_time/GpuProfiler_Dx11.h>
+#include <upscaler_time/GpuProfiler_Dx12.h>
 
 #include <d3d11.h>
 #include <d3d12.h>
@@ -244,18 +244,18 @@ static HRESULT LocalPresent(IDXGISwapChain* pSwapChain, UINT SyncInterval, UINT
 
     XellHooks::update();
 
-    // Upscaler GPU time computation
+    // Read finished GPU timings
     if (willPresent && (fg == nullptr || !fg->IsActive() || fg->IsPaused()))
     {
         if (cq != nullptr)
         {
-            UpscalerTimeDx12::ReadUpscalingTime(cq);
+            GpuProfilerDx12::EndFrame(cq);
         }
         else if (device != nullptr)
         {
             ID3D11DeviceContext* context = nullptr;
             device->GetImmediateContext(&context);
-            UpscalerTimeDx11::ReadUpscalingTime(context);
+            GpuProfilerDx11::EndFrame(context);
             context->Release();
         }
     }
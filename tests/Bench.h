@@ -0,0 +1,36 @@
+#pragma once
+
+#include <chrono>
+#include <cstdio>
+#include <cstdint>
+#include <cstring>
+
+// Timing helpers of the benchmarks. With --quick (used by ctest) a benchmark only does a few
+// iterations, so it is kept building and running without slowing down the tests.
+inline bool QuickRun(int argc, char** argv)
+{
+    for (int i = 1; i < argc; i++)
+    {
+        if (std::strcmp(argv[i], "--quick") == 0)
+            return true;
+    }
+
+    return false;
+}
+
+// Nanoseconds per operation of body, which does count operations
+template <typename F> double NsPerOp(uint64_t count, F&& body)
+{
+    auto start = std::chrono::steady_clock::now();
+    body();
+    auto end = std::chrono::steady_clock::now();
+
+    return std::chrono::duration<double, std::nano>(end - start).count() / (double) (count == 0 ? 1 : count);
+}
+
+// Keeps the optimizer from dropping a result
+template <typename T> inline void KeepValue(const T& value)
+{
+    static volatile uint64_t sink;
+    sink = sink + (uint64_t) value;
+}
@@ -0,0 +1,33 @@
+#pragma once
+
+#include <cstdio>
+
+// Minimal checks for the platform independent cores, the tests don't need a framework.
+// A failed CHECK prints its location and the test keeps running, TestResult is the exit code of main.
+inline int& CheckFailures()
+{
+    static int failures = 0;
+    return failures;
+}
+
+#define CHECK(condition)                                                                                               \
+    do                                                                                                                 \
+    {                                                                                                                  \
+        if (!(condition))                                                                                              \
+        {                                                                                                              \
+            std::printf("%s:%d: CHECK(%s) failed\n", __FILE__, __LINE__, #condition);                                 \
+            CheckFailures()++;                                                                                         \
+        }                                                                                                              \
+    } while (false)
+
+inline int TestResult()
+{
+    if (CheckFailures() != 0)
+    {
+        std::printf("%d checks failed\n", CheckFailures());
+        return 1;
+    }
+
+    std::printf("ok\n");
+    return 0;
+}
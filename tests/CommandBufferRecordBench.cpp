@@ -0,0 +1,180 @@
+// hooks/CommandBufferTable.h, recording and replaying command buffers from 1 to 8 threads.
+// Shared mutex + map of shared_ptr entries is the lookup CommandBufferStateTracker did before the table.
+
+#include "Bench.h"
+
+#include <hooks/CommandBufferTable.h>
+
+#include <array>
+#include <memory>
+#include <shared_mutex>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+struct FakeCommandBuffer_T;
+using CommandBuffer = FakeCommandBuffer_T*;
+
+struct RecordedState
+{
+    uint64_t Pipeline = 0;
+    std::array<uint64_t, 8> Sets {};
+    uint32_t Commands = 0;
+};
+
+struct Entry
+{
+    std::mutex Mutex;
+    CommandBuffer Cmd = nullptr;
+    RecordedState State;
+
+    void Recycle() { State = RecordedState {}; }
+};
+
+class TableTracker
+{
+    vk_state::EntryRegistry<CommandBuffer, Entry> _entries;
+
+  public:
+    void Record(CommandBuffer cmd, uint64_t value)
+    {
+        auto [entry, lock] = _entries.Lock(cmd);
+        entry->State.Sets[value % 8] = value;
+        entry->State.Commands++;
+    }
+
+    void Replay(CommandBuffer src, CommandBuffer dst)
+    {
+        RecordedState snapshot;
+
+        if (auto entry = _entries.Find(src); entry != nullptr)
+        {
+            std::scoped_lock lock(entry->Mutex);
+
+            if (entry->Cmd == src)
+                snapshot = entry->State;
+        }
+
+        auto [entry, lock] = _entries.Lock(dst);
+        entry->State = snapshot;
+    }
+};
+
+class SharedMutexTracker
+{
+    struct OldEntry
+    {
+        std::mutex Mutex;
+        RecordedState State;
+    };
+
+    std::shared_mutex _mapMutex;
+    std::unordered_map<CommandBuffer, std::shared_ptr<OldEntry>> _states;
+
+    std::shared_ptr<OldEntry> GetOrCreate(CommandBuffer cmd)
+    {
+        {
+            std::shared_lock lock(_mapMutex);
+
+            if (auto it = _states.find(cmd); it != _states.end())
+                return it->second;
+        }
+
+        std::unique_lock lock(_mapMutex);
+        auto& entry = _states[cmd];
+
+        if (entry == nullptr)
+            entry = std::make_shared<OldEntry>();
+
+        return entry;
+    }
+
+  public:
+    void Record(CommandBuffer cmd, uint64_t value)
+    {
+        auto entry = GetOrCreate(cmd);
+        std::scoped_lock lock(entry->Mutex);
+        entry->State.Sets[value % 8] = value;
+        entry->State.Commands++;
+    }
+
+    void Replay(CommandBuffer src, CommandBuffer dst)
+    {
+        RecordedState snapshot;
+        std::shared_ptr<OldEntry> source;
+
+        {
+            std::shared_lock lock(_mapMutex);
+
+            if (auto it = _states.find(src); it != _states.end())
+                source = it->second;
+        }
+
+        if (source != nullptr)
+        {
+            std::scoped_lock lock(source->Mutex);
+            snapshot = source->State;
+        }
+
+        auto entry = GetOrCreate(dst);
+        std::scoped_lock lock(entry->Mutex);
+        entry->State = snapshot;
+    }
+};
+
+constexpr size_t CommandBuffersPerThread = 64;
+constexpr size_t CommandsPerRecording = 32;
+
+static CommandBuffer Handle(size_t index) { return reinterpret_cast<CommandBuffer>((index + 1) * 64); }
+
+// Every thread records its own command buffers, each recording ends with a replay into a helper command buffer
+template <typename Tracker> static double RecordNs(size_t threadCount, uint64_t recordings)
+{
+    Tracker tracker;
+
+    return NsPerOp(recordings * threadCount * (CommandsPerRecording + 1),
+                   [&]
+                   {
+                       std::vector<std::thread> threads;
+
+                       for (size_t t = 0; t < threadCount; t++)
+                       {
+                           threads.emplace_back(
+                               [&, t]
+                               {
+                                   auto first = t * (CommandBuffersPerThread + 1);
+                                   auto helper = Handle(first + CommandBuffersPerThread);
+
+                                   for (uint64_t r = 0; r < recordings; r++)
+                                   {
+                                       auto cmd = Handle(first + r % CommandBuffersPerThread);
+
+                                       for (uint64_t c = 0; c < CommandsPerRecording; c++)
+                                           tracker.Record(cmd, r + c);
+
+                                       tracker.Replay(cmd, helper);
+                                   }
+                               });
+                       }
+
+                       for (auto& thread : threads)
+                           thread.join();
+                   });
+}
+
+int main(int argc, char** argv)
+{
+    auto quick = QuickRun(argc, argv);
+    const uint64_t recordings = quick ? 100 : 50'000;
+
+    std::printf("%8s %16s %18s\n", "threads", "table ns/cmd", "shared mutex ns/cmd");
+
+    for (size_t threadCount : { 1, 2, 4, 8 })
+    {
+        auto table = RecordNs<TableTracker>(threadCount, recordings);
+        auto shared = RecordNs<SharedMutexTracker>(threadCount, recordings);
+        std::printf("%8zu %16.1f %18.1f\n", threadCount, table, shared);
+    }
+
+    return 0;
+}
@@ -0,0 +1,229 @@
+// hooks/BumpArena.h, allocations per frame of command buffer state resets.
+// CommandBufferState needs the Vulkan headers, so the states here have the same containers with plain handles:
+// Before is the old reset (assigning a fresh state, every bind call owning two vectors),
+// After is BindPointState::Reset / ResetForNewRecording keeping capacities and storing calls in the arenas.
+
+#include "Bench.h"
+#include "Check.h"
+
+#include <hooks/BumpArena.h>
+
+#include <array>
+#include <atomic>
+#include <cstdlib>
+#include <new>
+#include <vector>
+
+static std::atomic<uint64_t> _allocations { 0 };
+
+void* operator new(size_t size)
+{
+    _allocations.fetch_add(1, std::memory_order_relaxed);
+
+    if (auto pointer = std::malloc(size == 0 ? 1 : size); pointer != nullptr)
+        return pointer;
+
+    throw std::bad_alloc();
+}
+
+void operator delete(void* pointer) noexcept { std::free(pointer); }
+void operator delete(void* pointer, size_t) noexcept { std::free(pointer); }
+
+using Handle = uint64_t;
+
+struct PushConstantEntry
+{
+    Handle Layout = 0;
+    uint32_t Stages = 0;
+    uint32_t Offset = 0;
+    uint32_t Size = 0;
+    std::array<uint8_t, 256> Data {};
+};
+
+struct BeforeCall
+{
+    Handle Layout = 0;
+    uint32_t FirstSet = 0;
+    std::vector<Handle> Sets;
+    std::vector<uint32_t> DynamicOffsets;
+};
+
+struct BeforeState
+{
+    std::array<std::vector<BeforeCall>, 2> Calls;
+    std::vector<PushConstantEntry> PushConstantHistory;
+
+    BeforeState()
+    {
+        for (auto& calls : Calls)
+            calls.reserve(4);
+
+        PushConstantHistory.reserve(8);
+    }
+
+    void Reset() { *this = BeforeState {}; }
+
+    void BindDescriptorSets(uint32_t bp, Handle layout, uint32_t firstSet, const Handle* sets, uint32_t count,
+                            const uint32_t* offsets, uint32_t offsetCount)
+    {
+        BeforeCall call;
+        call.Layout = layout;
+        call.FirstSet = firstSet;
+        call.Sets.assign(sets, sets + count);
+        call.DynamicOffsets.assign(offsets, offsets + offsetCount);
+        Calls[bp].push_back(std::move(call));
+    }
+};
+
+struct AfterCall
+{
+    Handle Layout = 0;
+    uint32_t FirstSet = 0;
+    uint32_t SetsOffset = 0;
+    uint32_t SetsCount = 0;
+    uint32_t DynamicOffsetsOffset = 0;
+    uint32_t DynamicOffsetsCount = 0;
+};
+
+struct AfterBindPoint
+{
+    std::vector<AfterCall> DescriptorBindCalls;
+    vk_state::BumpArena<Handle> SetArena;
+    vk_state::BumpArena<uint32_t> DynamicOffsetArena;
+
+    AfterBindPoint() { DescriptorBindCalls.reserve(4); }
+
+    void Reset()
+    {
+        DescriptorBindCalls.clear();
+        SetArena.Rewind();
+        DynamicOffsetArena.Rewind();
+    }
+};
+
+struct AfterState
+{
+    std::array<AfterBindPoint, 2> BP;
+    std::vector<PushConstantEntry> PushConstantHistory;
+
+    AfterState() { PushConstantHistory.reserve(8); }
+
+    void Reset()
+    {
+        for (auto& bp : BP)
+            bp.Reset();
+
+        PushConstantHistory.clear();
+    }
+
+    void BindDescriptorSets(uint32_t bp, Handle layout, uint32_t firstSet, const Handle* sets, uint32_t count,
+                            const uint32_t* offsets, uint32_t offsetCount)
+    {
+        auto& point = BP[bp];
+        AfterCall call;
+        call.Layout = layout;
+        call.FirstSet = firstSet;
+
+        if (count > 0)
+        {
+            call.SetsOffset = point.SetArena.Push(sets, count);
+            call.SetsCount = count;
+        }
+
+        if (offsetCount > 0)
+        {
+            call.DynamicOffsetsOffset = point.DynamicOffsetArena.Push(offsets, offsetCount);
+            call.DynamicOffsetsCount = offsetCount;
+        }
+
+        point.DescriptorBindCalls.push_back(call);
+    }
+};
+
+constexpr size_t CommandBuffers = 64;
+constexpr size_t RecordingsPerFrame = 3000;
+
+// A frame of recordings, command buffers are reused round robin like a game's per frame pools.
+// Recordings are a few draws / dispatches each, the sizes vary per command buffer.
+template <typename State> static void RecordFrame(std::vector<State>& states, uint64_t frame)
+{
+    Handle sets[4] = { 1, 2, 3, 4 };
+    uint32_t offsets[2] = { 256, 512 };
+    PushConstantEntry push;
+
+    for (size_t r = 0; r < RecordingsPerFrame; r++)
+    {
+        auto index = (r + frame) % states.size();
+        auto& state = states[index];
+        state.Reset();
+
+        auto calls = 2 + (uint32_t) (index % 6);
+
+        for (uint32_t c = 0; c < calls; c++)
+        {
+            state.BindDescriptorSets(c % 3 == 0 ? 1 : 0, 100 + c, c % 2, sets, 1 + (c + (uint32_t) index) % 4,
+                                     offsets, c % 3);
+        }
+
+        for (uint32_t p = 0; p < 1 + index % 4; p++)
+            state.PushConstantHistory.push_back(push);
+    }
+}
+
+template <typename State> static void Measure(const char* name, uint64_t frames, uint64_t& allocationsPerFrame)
+{
+    std::vector<State> states(CommandBuffers);
+
+    // First frames grow the capacities
+    for (uint64_t frame = 0; frame < 4; frame++)
+        RecordFrame(states, frame);
+
+    auto before = _allocations.load(std::memory_order_relaxed);
+
+    auto ns = NsPerOp(frames,
+                      [&]
+                      {
+                          for (uint64_t frame = 0; frame < frames; frame++)
+                              RecordFrame(states, frame);
+                      });
+
+    allocationsPerFrame = (_allocations.load(std::memory_order_relaxed) - before) / frames;
+    std::printf("%8s %18llu %14.1f\n", name, (unsigned long long) allocationsPerFrame, ns / 1000.0);
+}
+
+// An unusually big recording doesn't keep its arena memory
+static void Trim()
+{
+    AfterBindPoint bp;
+    std::vector<Handle> sets(vk_state::BumpArena<Handle>::kTrimCapacity + 1, 1);
+
+    bp.SetArena.Push(sets.data(), (uint32_t) sets.size());
+    bp.Reset();
+    CHECK(bp.SetArena.Data.capacity() == 0);
+
+    bp.SetArena.Push(sets.data(), 1000);
+    bp.Reset();
+    CHECK(bp.SetArena.Data.capacity() >= 1000);
+    CHECK(bp.SetArena.Get(0, 1).empty());
+}
+
+int main(int argc, char** argv)
+{
+    auto quick = QuickRun(argc, argv);
+    const uint64_t frames = quick ? 4 : 200;
+
+    std::printf("%zu recordings per frame over %zu command buffers\n", RecordingsPerFrame, CommandBuffers);
+    std::printf("%8s %18s %14s\n", "reset", "allocations/frame", "us/frame");
+
+    uint64_t beforeAllocations = 0;
+    uint64_t afterAllocations = 0;
+    Measure<BeforeState>("before", frames, beforeAllocations);
+    Measure<AfterState>("after", frames, afterAllocations);
+
+    CHECK(beforeAllocations > RecordingsPerFrame);
+    CHECK(afterAllocations == 0);
+
+    Trim();
+
+    return TestResult();
+}
@@ -0,0 +1,257 @@
+// hooks/CommandBufferTable.h, lock free lookups next to inserts / erases and recycled entries
+
+#include "Check.h"
+
+#include <hooks/CommandBufferTable.h>
+
+#include <memory>
+#include <thread>
+#include <vector>
+
+struct FakeCommandBuffer_T;
+using CommandBuffer = FakeCommandBuffer_T*;
+
+struct Entry
+{
+    std::mutex Mutex;
+    CommandBuffer Cmd = nullptr;
+    int Recycled = 0;
+    uint64_t Recorded = 0;
+
+    void Recycle()
+    {
+        Recycled++;
+        Recorded = 0;
+    }
+};
+
+using Table = vk_state::HandleTable<CommandBuffer, Entry>;
+using Registry = vk_state::EntryRegistry<CommandBuffer, Entry>;
+
+// Handles are pointers, aligned like real dispatchable handles
+static CommandBuffer Handle(size_t index) { return reinterpret_cast<CommandBuffer>((index + 1) * 64); }
+
+static void InsertFindErase()
+{
+    Table table;
+    std::vector<Entry> entries(5000);
+
+    CHECK(table.Find(nullptr) == nullptr);
+    CHECK(table.Find(Handle(0)) == nullptr);
+
+    // Grows past the initial capacity
+    for (size_t i = 0; i < entries.size(); i++)
+        table.Insert(Handle(i), &entries[i]);
+
+    for (size_t i = 0; i < entries.size(); i++)
+        CHECK(table.Find(Handle(i)) == &entries[i]);
+
+    for (size_t i = 0; i < entries.size(); i += 2)
+        CHECK(table.Erase(Handle(i)) == &entries[i]);
+
+    CHECK(table.Erase(Handle(0)) == nullptr);
+    CHECK(table.Erase(Handle(entries.size())) == nullptr);
+
+    for (size_t i = 0; i < entries.size(); i++)
+        CHECK(table.Find(Handle(i)) == (i % 2 == 0 ? nullptr : &entries[i]));
+
+    // Tombstones are reused and skipped by later probes
+    for (size_t round = 0; round < 20; round++)
+    {
+        for (size_t i = 0; i < entries.size(); i += 2)
+            table.Insert(Handle(i), &entries[i]);
+
+        for (size_t i = 0; i < entries.size(); i += 2)
+            CHECK(table.Erase(Handle(i)) == &entries[i]);
+    }
+
+    for (size_t i = 1; i < entries.size(); i += 2)
+        CHECK(table.Find(Handle(i)) == &entries[i]);
+}
+
+// Readers look up while a writer inserts, erases and grows the table
+static void ConcurrentFind()
+{
+    constexpr size_t Stable = 256;
+    constexpr size_t Churn = 4096;
+
+    Table table;
+    std::vector<Entry> entries(Stable + Churn);
+
+    for (size_t i = 0; i < Stable; i++)
+        table.Insert(Handle(i), &entries[i]);
+
+    std::atomic<bool> done { false };
+    std::atomic<int> reads { 0 };
+    std::atomic<int> wrong { 0 };
+    std::vector<std::thread> readers;
+
+    for (int t = 0; t < 2; t++)
+    {
+        readers.emplace_back(
+            [&, t]
+            {
+                uint64_t state = t + 1;
+
+                while (!done.load(std::memory_order_acquire))
+                {
+                    state = state * 6364136223846793005ull + 1442695040888963407ull;
+                    auto index = (size_t) (state >> 33) % entries.size();
+                    auto entry = table.Find(Handle(index));
+
+                    // Stable handles are always there, others are either missing or map to their own entry
+                    if (index < Stable ? entry != &entries[index] : entry != nullptr && entry != &entries[index])
+                        wrong++;
+
+                    reads.fetch_add(1, std::memory_order_release);
+                }
+            });
+    }
+
+    while (reads.load(std::memory_order_acquire) == 0)
+        std::this_thread::yield();
+
+    for (size_t round = 0; round < 4; round++)
+    {
+        for (size_t i = Stable; i < entries.size(); i++)
+            table.Insert(Handle(i), &entries[i]);
+
+        for (size_t i = Stable; i < entries.size(); i++)
+            table.Erase(Handle(i));
+    }
+
+    done = true;
+
+    for (auto& reader : readers)
+        reader.join();
+
+    CHECK(wrong == 0);
+}
+
+// A pointer from the lock free lookup can belong to another command buffer by the time it is locked
+static void RecycledEntryRecheck()
+{
+    Registry registry;
+
+    auto first = registry.GetOrCreate(Handle(1));
+    CHECK(first->Cmd == Handle(1));
+    CHECK(registry.Find(Handle(1)) == first);
+
+    // Racing free of Handle(1) and allocation of Handle(2) recycles the entry
+    auto stale = registry.Find(Handle(1));
+    {
+        std::scoped_lock lock(registry.WriteMutex());
+        registry.ReleaseLocked(Handle(1));
+        CHECK(registry.CreateLocked(Handle(2)) == stale);
+    }
+
+    CHECK(stale->Cmd == Handle(2) && stale->Recycled == 1);
+    CHECK(registry.Find(Handle(1)) == nullptr);
+
+    // Lock checks the owner and gives Handle(1) its own entry again
+    {
+        auto [entry, lock] = registry.Lock(Handle(1));
+        CHECK(entry != stale && entry->Cmd == Handle(1));
+    }
+
+    {
+        auto [entry, lock] = registry.Lock(Handle(2));
+        CHECK(entry == stale);
+    }
+
+    // Releasing all entries while iterating them
+    {
+        std::scoped_lock lock(registry.WriteMutex());
+
+        for (auto& entry : registry.EntriesLocked())
+        {
+            if (entry->Cmd != nullptr)
+                registry.ReleaseLocked(entry->Cmd);
+        }
+
+        CHECK(registry.EntriesLocked().size() == 2);
+    }
+
+    CHECK(registry.Find(Handle(1)) == nullptr && registry.Find(Handle(2)) == nullptr);
+}
+
+// Recording threads lock their command buffers while another thread frees and allocates them
+static void ConcurrentRecycle()
+{
+    constexpr size_t Recorders = 2;
+    constexpr size_t PerThread = 16;
+
+    Registry registry;
+    std::atomic<bool> done { false };
+    std::atomic<int> records { 0 };
+    std::atomic<int> wrong { 0 };
+    std::vector<std::thread> threads;
+
+    for (size_t t = 0; t < Recorders; t++)
+    {
+        threads.emplace_back(
+            [&, t]
+            {
+                for (size_t n = 0; !done.load(std::memory_order_acquire); n++)
+                {
+                    auto cmd = Handle(t * PerThread + n % PerThread);
+                    auto [entry, lock] = registry.Lock(cmd);
+
+                    if (entry->Cmd != cmd)
+                        wrong++;
+
+                    entry->Recorded++;
+                    records.fetch_add(1, std::memory_order_release);
+                }
+            });
+    }
+
+    while (records.load(std::memory_order_acquire) == 0)
+        std::this_thread::yield();
+
+    // Frees command buffers of the recorders and allocates unrelated ones, so entries move between handles
+    for (size_t round = 0; round < 4000; round++)
+    {
+        std::unique_lock lock(registry.WriteMutex());
+        auto cmd = Handle(round % (Recorders * PerThread));
+        auto other = Handle(1000 + round % 8);
+
+        registry.ReleaseLocked(cmd);
+        registry.ReleaseLocked(other);
+
+        if (registry.Find(other) == nullptr)
+            registry.CreateLocked(other);
+
+        lock.unlock();
+
+        if (round % 16 == 0)
+            std::this_thread::yield();
+    }
+
+    done = true;
+
+    for (auto& thread : threads)
+        thread.join();
+
+    CHECK(wrong == 0);
+    CHECK(records > 0);
+
+    // Every live handle has exactly one entry which belongs to it
+    std::scoped_lock lock(registry.WriteMutex());
+
+    for (auto& entry : registry.EntriesLocked())
+    {
+        if (entry->Cmd != nullptr)
+            CHECK(registry.Find(entry->Cmd) == entry.get());
+    }
+}
+
+int main()
+{
+    InsertFindErase();
+    ConcurrentFind();
+    RecycledEntryRecheck();
+    ConcurrentRecycle();
+
+    return TestResult();
+}
@@ -0,0 +1,87 @@
+// misc/FileLocator.h, locating the NGX dlls in a game folder with 200k entries.
+// One walk per file is what Util::FindFilePath did for every dll before the single walk and the path cache.
+
+#include "Bench.h"
+
+#include <misc/FileLocator.h>
+
+#include <array>
+
+namespace fs = std::filesystem;
+
+static const fs::path Names[] = { "nvngx_dlss.dll", "nvngx_dlssd.dll", "nvngx_dlssg.dll" };
+
+// Folders of 100 files, the dlls sit at the end of the tree or don't exist
+static fs::path MakeGame(const fs::path& dir, size_t entries)
+{
+    auto game = dir / "game";
+
+    for (size_t i = 0; i < entries; i++)
+    {
+        auto folder = game / ("pak" + std::to_string(i / 1000)) / ("dir" + std::to_string(i / 100 % 10));
+
+        if (i % 100 == 0)
+            fs::create_directories(folder);
+
+        std::ofstream(folder / ("asset" + std::to_string(i) + ".bin"), std::ios::binary);
+    }
+
+    auto ngx = game / "zz/Binaries/ThirdParty/NGX";
+    fs::create_directories(ngx);
+    std::ofstream(ngx / "nvngx_dlss.dll", std::ios::binary);
+
+    return game;
+}
+
+int main(int argc, char** argv)
+{
+    auto quick = QuickRun(argc, argv);
+    const size_t entries = quick ? 2'000 : 200'000;
+
+    auto dir = fs::temp_directory_path() / "opti_file_locator_bench";
+    fs::remove_all(dir);
+    auto game = MakeGame(dir, entries);
+
+    // Warm the OS directory cache, so every variant reads from memory
+    file_locator::WalkOptions options;
+    std::array<std::optional<fs::path>, std::size(Names)> results;
+    file_locator::FindFiles(game, Names, results, options);
+
+    auto perFile = NsPerOp(1,
+                           [&]
+                           {
+                               for (auto& name : Names)
+                               {
+                                   std::optional<fs::path> result;
+                                   file_locator::FindFiles(game, std::span(&name, 1), std::span(&result, 1), options);
+                                   KeepValue(result.has_value());
+                               }
+                           });
+
+    auto singleWalk = NsPerOp(1,
+                              [&]
+                              {
+                                  std::array<std::optional<fs::path>, std::size(Names)> found;
+                                  KeepValue(file_locator::FindFiles(game, Names, found, options));
+                              });
+
+    file_locator::PathCache cache;
+    cache.Store(game, Names[0], results[0].value());
+
+    const uint64_t lookups = quick ? 10 : 10'000;
+    auto cached = NsPerOp(lookups,
+                          [&]
+                          {
+                              for (uint64_t i = 0; i < lookups; i++)
+                                  KeepValue(cache.Lookup(game, Names[0]).has_value());
+                          });
+
+    std::printf("%zu entries, %zu dlls of which 2 are missing\n", entries, std::size(Names));
+    std::printf("%24s %12.2f ms\n", "walk per file", perFile / 1e6);
+    std::printf("%24s %12.2f ms\n", "single walk", singleWalk / 1e6);
+    std::printf("%24s %12.2f us\n", "path cache hit", cached / 1e3);
+
+    fs::remove_all(dir);
+
+    return 0;
+}
@@ -0,0 +1,215 @@
+// misc/FileLocator.h, single walk search of several files and the persistent path cache
+
+#include "Check.h"
+
+#include <misc/FileLocator.h>
+
+#include <array>
+
+namespace fs = std::filesystem;
+using namespace file_locator;
+
+static void Touch(const fs::path& path)
+{
+    fs::create_directories(path.parent_path());
+    std::ofstream file(path, std::ios::binary);
+    file << "x";
+}
+
+using Results = std::array<std::optional<fs::path>, 4>;
+
+static const fs::path Names[] = { "nvngx_dlss.dll", "nvngx_dlssd.dll", "nvngx_dlssg.dll", "missing.dll" };
+
+// Layout of an UE game, DLSSG both in the streamline folder of Opti and in a plugin
+static fs::path MakeGame(const fs::path& dir)
+{
+    auto game = dir / "game";
+    Touch(game / "Engine/Binaries/ThirdParty/NVIDIA/NGX/Win64/nvngx_dlss.dll");
+    Touch(game / "NVNGX_DLSSD.DLL");
+    Touch(game / "streamline/nvngx_dlssg.dll");
+    Touch(game / "Engine/Plugins/Streamline/nvngx_dlssg.dll");
+    Touch(game / "Engine/Plugins/readme.txt");
+    return game;
+}
+
+// First path with the file name a plain recursive walk reaches
+static std::optional<fs::path> FirstInWalk(const fs::path& root, const fs::path& fileName)
+{
+    for (auto& entry : fs::recursive_directory_iterator(root))
+    {
+        if (!entry.is_directory() && entry.path().filename() == fileName)
+            return entry.path();
+    }
+
+    return std::nullopt;
+}
+
+static void FindsAllInOneWalk(const fs::path& game)
+{
+    Results results;
+
+    CHECK(FindFiles(game, Names, results) == 3);
+    CHECK(results[0] == game / "Engine/Binaries/ThirdParty/NVIDIA/NGX/Win64/nvngx_dlss.dll");
+    CHECK(results[1] == game / "NVNGX_DLSSD.DLL"); // case insensitive like Windows
+    CHECK(!results[3].has_value());
+
+    // First match in walk order wins
+    CHECK(results[2] == FirstInWalk(game, "nvngx_dlssg.dll"));
+
+    // Files which already have a result are not searched again
+    Results partial;
+    partial[0] = "keep/nvngx_dlss.dll";
+
+    CHECK(FindFiles(game, Names, partial) == 2);
+    CHECK(partial[0] == fs::path("keep/nvngx_dlss.dll"));
+
+    Results none;
+    none[0] = none[1] = none[2] = none[3] = "done";
+    CHECK(FindFiles(game, Names, none) == 0);
+
+    Results missingRoot;
+    CHECK(FindFiles(game / "not_there", Names, missingRoot) == 0);
+}
+
+static void ExcludedDirs(const fs::path& game)
+{
+    // Whole subtree is skipped, the compare ignores case and trailing separators
+    WalkOptions options;
+    options.ExcludedDirs.push_back(Normalize(game / "STREAMLINE/"));
+
+    Results results;
+    FindFiles(game, Names, results, options);
+    CHECK(results[2] == game / "Engine/Plugins/Streamline/nvngx_dlssg.dll");
+
+    options.ExcludedDirs.push_back(Normalize(game / "engine/plugins"));
+
+    Results excluded;
+    CHECK(FindFiles(game, Names, excluded, options) == 2);
+    CHECK(!excluded[2].has_value());
+    CHECK(excluded[0].has_value());
+}
+
+static void MaxDepth(const fs::path& game)
+{
+    // nvngx_dlss.dll sits in the 6th directory below the root
+    WalkOptions options;
+    options.MaxDepth = 6;
+
+    Results shallow;
+    FindFiles(game, Names, shallow, options);
+    CHECK(!shallow[0].has_value());
+    CHECK(shallow[1].has_value() && shallow[2].has_value());
+
+    options.MaxDepth = 7;
+
+    Results deep;
+    FindFiles(game, Names, deep, options);
+    CHECK(deep[0].has_value());
+
+    // Only the root itself
+    options.MaxDepth = 1;
+
+    Results rootOnly;
+    CHECK(FindFiles(game, Names, rootOnly, options) == 1);
+    CHECK(rootOnly[1].has_value());
+}
+
+static void CacheRevalidation(const fs::path& dir)
+{
+    auto root = dir / "cache_game";
+    auto file = root / "bin/nvngx_dlss.dll";
+    Touch(file);
+
+    PathCache cache;
+    CHECK(!cache.Lookup(root, "nvngx_dlss.dll").has_value());
+
+    cache.Store(root, "nvngx_dlss.dll", file);
+    CHECK(cache.IsDirty() && cache.Size() == 1);
+    CHECK(cache.Lookup(root, "nvngx_dlss.dll") == file);
+    CHECK(cache.Lookup(root / "bin/..", "NVNGX_DLSS.DLL") == file);
+    CHECK(!cache.Lookup(root / "bin", "nvngx_dlss.dll").has_value());
+
+    auto cacheFile = dir / "OptiScaler.pathcache";
+    CHECK(cache.Save(cacheFile));
+    CHECK(!cache.IsDirty());
+
+    // Same path again doesn't need a save
+    cache.Store(root, "nvngx_dlss.dll", file);
+    CHECK(!cache.IsDirty());
+
+    // Moved file, the stale entry is dropped on lookup
+    fs::remove(file);
+    CHECK(!cache.Lookup(root, "nvngx_dlss.dll").has_value());
+    CHECK(cache.Size() == 0 && cache.IsDirty());
+
+    PathCache loaded;
+    CHECK(loaded.Load(cacheFile) && loaded.Size() == 1);
+    CHECK(!loaded.Lookup(root, "nvngx_dlss.dll").has_value());
+    CHECK(loaded.Size() == 0);
+}
+
+static void CacheCap(const fs::path& dir)
+{
+    auto root = dir / "cap_game";
+    PathCache cache;
+
+    for (int i = 0; i < 100; i++)
+    {
+        auto name = "file" + std::to_string(i) + ".dll";
+        Touch(root / name);
+        cache.Store(root, name, root / name);
+    }
+
+    // Oldest entries are evicted
+    CHECK(cache.Size() == 64);
+    CHECK(!cache.Lookup(root, "file0.dll").has_value());
+    CHECK(!cache.Lookup(root, "file35.dll").has_value());
+    CHECK(cache.Lookup(root, "file36.dll") == root / "file36.dll");
+    CHECK(cache.Lookup(root, "file99.dll") == root / "file99.dll");
+
+    auto cacheFile = dir / "cap.pathcache";
+    CHECK(cache.Save(cacheFile));
+
+    PathCache loaded;
+    CHECK(loaded.Load(cacheFile) && loaded.Size() == 64);
+    CHECK(loaded.Lookup(root, "file99.dll") == root / "file99.dll");
+
+    // Longer files from other versions are capped too, broken lines skipped
+    {
+        std::ofstream file(cacheFile, std::ios::binary | std::ios::app);
+        file << "broken line\n";
+
+        for (int i = 0; i < 10; i++)
+            file << (root / "x").string() << "\tx.dll\t" << (root / "x.dll").string() << '\n';
+    }
+
+    CHECK(loaded.Load(cacheFile) && loaded.Size() == 64);
+
+    // Unknown format
+    {
+        std::ofstream file(cacheFile, std::ios::binary | std::ios::trunc);
+        file << "Some other cache\n";
+    }
+
+    CHECK(!loaded.Load(cacheFile) && loaded.Size() == 0);
+    CHECK(!loaded.Load(dir / "not_there.pathcache"));
+}
+
+int main()
+{
+    auto dir = fs::temp_directory_path() / "opti_file_locator_test";
+    fs::remove_all(dir);
+    fs::create_directories(dir);
+
+    auto game = MakeGame(dir);
+
+    FindsAllInOneWalk(game);
+    ExcludedDirs(game);
+    MaxDepth(game);
+    CacheRevalidation(dir);
+    CacheCap(dir);
+
+    fs::remove_all(dir);
+
+    return TestResult();
+}
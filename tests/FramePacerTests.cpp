@@ -0,0 +1,151 @@
+// misc/FramePacer.h, limit snapping and absolute deadline pacing on a simulated clock
+
+#include "Check.h"
+
+#include <misc/FramePacer.h>
+
+#include <random>
+
+using namespace frame_pacer;
+
+static bool Near(double a, double b) { return std::abs(a - b) < 1e-9; }
+
+static void Intervals()
+{
+    Target target;
+    CHECK(Interval(target) == 0);
+
+    target.Fps = 60.0;
+    CHECK(Interval(target) == 16666667);
+
+    // Frame generation doubles the time between rendered frames
+    target.FramesPerRender = 2;
+    CHECK(Interval(target) == 33333333);
+
+    target.FramesPerRender = 0;
+    CHECK(Interval(target) == 16666667);
+}
+
+static void Snapping()
+{
+    CHECK(Near(DisplayFps({ 100.0, 1, 144.0, Snap::RefreshDivisor }), 72.0));
+    CHECK(Near(DisplayFps({ 144.0, 1, 144.0, Snap::RefreshDivisor }), 144.0));
+    CHECK(Near(DisplayFps({ 200.0, 1, 144.0, Snap::RefreshDivisor }), 144.0));
+
+    // Unknown refresh rate, limit is kept
+    CHECK(Near(DisplayFps({ 100.0, 1, 0.0, Snap::RefreshDivisor }), 100.0));
+
+    // No limit or a limit over the cap is lowered under the refresh rate
+    auto cap = DisplayFps({ 0.0, 1, 144.0, Snap::VrrCap });
+    CHECK(Near(cap, 1000.0 / (1000.0 / 144.0 + VrrMarginMs)));
+    CHECK(cap < 144.0 && cap > 137.0);
+    CHECK(Near(DisplayFps({ 200.0, 1, 144.0, Snap::VrrCap }), cap));
+    CHECK(Near(DisplayFps({ 100.0, 1, 144.0, Snap::VrrCap }), 100.0));
+}
+
+// 5 - 15 ms frames at a 60 fps limit, every wait wakes up 50 us late
+static void LateWakesDontDrift()
+{
+    std::mt19937 rng(3);
+    std::uniform_int_distribution<int64_t> work(5'000'000, 15'000'000);
+
+    auto interval = Interval({ 60.0 });
+
+    Pacer pacer;
+    uint64_t now = 1000;
+    uint64_t first = 0;
+    uint64_t last = 0;
+    constexpr int Frames = 10000;
+
+    for (int i = 0; i < Frames; i++)
+    {
+        if (auto deadline = pacer.Next(now, interval); deadline != 0)
+        {
+            CHECK(deadline > now);
+            now = deadline + 50'000;
+        }
+
+        if (i == 0)
+            first = now;
+
+        last = now;
+        now += work(rng);
+    }
+
+    auto average = (double) (last - first) / (Frames - 1);
+    CHECK(std::abs(average - 16666667.0) < 2000.0);
+    CHECK(pacer.Resyncs() == 0);
+}
+
+// A 100 ms stall restarts the grid instead of letting a burst of frames through
+static void HitchResyncs()
+{
+    auto interval = Interval({ 60.0 });
+
+    Pacer pacer;
+    uint64_t now = 0;
+    int skippedWaits = 0;
+
+    for (int i = 0; i < 100; i++)
+    {
+        if (auto deadline = pacer.Next(now + 1, interval); deadline != 0)
+            now = deadline;
+        else if (i > 1)
+            skippedWaits++;
+
+        if (i == 50)
+            now += 100'000'000;
+
+        now += 8'000'000;
+    }
+
+    CHECK(skippedWaits <= 1);
+    CHECK(pacer.Resyncs() == 1);
+}
+
+static void LimitChanges()
+{
+    Pacer pacer;
+
+    CHECK(pacer.Next(1000, 10'000'000) == 0);
+    CHECK(pacer.Next(2000, 10'000'000) == 10'001'000);
+
+    // New limit starts a new grid
+    CHECK(pacer.Next(3000, 20'000'000) == 0);
+    CHECK(pacer.Next(4000, 20'000'000) == 20'003'000);
+
+    // Limit off and on again
+    CHECK(pacer.Next(5000, 0) == 0);
+    CHECK(pacer.Next(6000, 20'000'000) == 0);
+
+    pacer.Reset();
+    CHECK(pacer.Next(7000, 20'000'000) == 0);
+    CHECK(pacer.Next(8000, 20'000'000) == 20'007'000);
+}
+
+static void Deterministic()
+{
+    auto interval = Interval({ 60.0 });
+
+    Pacer a;
+    Pacer b;
+    uint64_t now = 5;
+
+    for (int i = 0; i < 100; i++)
+    {
+        CHECK(a.Next(now, interval) == b.Next(now, interval));
+        now += 7'000'000 + i * 1000;
+    }
+}
+
+int main()
+{
+    Intervals();
+    Snapping();
+    LateWakesDontDrift();
+    HitchResyncs();
+    LimitChanges();
+    Deterministic();
+
+    return TestResult();
+}
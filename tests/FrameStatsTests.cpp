@@ -0,0 +1,225 @@
+// misc/FrameStats.h, histogram bucketing and percentiles of recorded frame time traces
+
+#include "Check.h"
+
+#include <misc/FrameStats.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <thread>
+#include <vector>
+
+using namespace frame_stats;
+
+// 60 fps capture with shader compile hitches and a loading stall, values in ms
+static std::vector<double> RecordedTrace(size_t frames)
+{
+    std::vector<double> trace;
+    uint64_t state = 12345;
+
+    for (size_t i = 0; i < frames; i++)
+    {
+        state = state * 6364136223846793005ull + 1442695040888963407ull;
+        auto noise = (double) ((state >> 33) % 2001) / 1000.0 - 1.0; // [-1, 1]
+
+        if (i % 97 == 13)
+            trace.push_back(33.4 + 8.0 * noise);
+        else if (i % 1009 == 500)
+            trace.push_back(250.0);
+        else
+            trace.push_back(16.67 + 1.5 * noise);
+    }
+
+    return trace;
+}
+
+// Nearest rank percentile, what LogHistogram approximates
+static double ExactPercentile(std::vector<double> values, double percentile)
+{
+    std::sort(values.begin(), values.end());
+    auto rank = (size_t) std::ceil(percentile / 100.0 * (double) values.size());
+    return values[rank == 0 ? 0 : rank - 1];
+}
+
+static void Bucketing()
+{
+    using H = LogHistogram;
+
+    // Exact buckets for small values
+    for (uint32_t value = 0; value < 2 * H::SubBucketCount; value++)
+        CHECK(H::BucketOf(value) == value && H::BucketWidth(value) == 1);
+
+    uint32_t previous = 0;
+    bool valid = true;
+
+    for (uint32_t value = 0; value <= H::MaxValue; value++)
+    {
+        auto bucket = H::BucketOf(value);
+        auto start = H::BucketStart(bucket);
+        auto width = H::BucketWidth(bucket);
+
+        // Every value falls into its bucket, buckets are ordered and the width stays under ~3% of the value
+        valid &= bucket < H::BucketCount && bucket >= previous && bucket <= previous + 1;
+        valid &= start <= value && value < start + width;
+        valid &= value < 2 * H::SubBucketCount || (double) width / (double) start <= 1.0 / H::SubBucketCount;
+
+        previous = bucket;
+    }
+
+    CHECK(valid);
+    CHECK(H::BucketOf(H::MaxValue) == H::BucketCount - 1);
+    CHECK(H::BucketOf(H::MaxValue + 1) == H::BucketCount - 1);
+    CHECK(H::BucketOf(UINT32_MAX) == H::BucketCount - 1);
+
+    H histogram;
+    CHECK(histogram.ValueAtPercentile(50.0) == 0);
+
+    histogram.Add(1000);
+    histogram.Add(2000);
+    histogram.Remove(5000); // never added, ignored
+    CHECK(histogram.Count() == 2);
+    CHECK(histogram.ValueAtPercentile(-10.0) == histogram.ValueAtPercentile(0.0));
+    CHECK(histogram.ValueAtPercentile(200.0) == histogram.ValueAtPercentile(100.0));
+
+    histogram.Remove(2000);
+    CHECK(histogram.Count() == 1);
+    CHECK(std::abs((int) histogram.ValueAtPercentile(100.0) - 1000) <= 16);
+}
+
+static void TracePercentiles()
+{
+    auto trace = RecordedTrace(5000);
+    SeriesStats stats;
+
+    for (auto ms : trace)
+        stats.Add(ms);
+
+    // Only the last WindowSize frames count
+    std::vector<double> window(trace.end() - SeriesStats::WindowSize, trace.end());
+    auto summary = stats.Summarize();
+
+    CHECK(summary.Count == SeriesStats::WindowSize);
+    CHECK(std::fabs(summary.Last - trace.back()) < 0.001);
+    CHECK(std::fabs(summary.Min - *std::min_element(window.begin(), window.end())) < 0.001);
+    CHECK(std::fabs(summary.Max - *std::max_element(window.begin(), window.end())) < 0.001);
+
+    double sum = 0.0;
+    double diffSum = 0.0;
+
+    for (size_t i = 0; i < window.size(); i++)
+    {
+        sum += window[i];
+
+        if (i > 0)
+            diffSum += std::fabs(window[i] - window[i - 1]);
+    }
+
+    CHECK(std::fabs(summary.Average - sum / window.size()) < 0.001);
+    CHECK(std::fabs(summary.Jitter - diffSum / (window.size() - 1)) < 0.001);
+
+    // Percentiles are within one bucket of the exact value
+    for (auto [percentile, value] : { std::pair { 50.0, summary.P50 },
+                                      { 95.0, summary.P95 },
+                                      { 99.0, summary.P99 },
+                                      { 99.9, summary.P999 } })
+    {
+        auto exact = ExactPercentile(window, percentile);
+        CHECK(std::fabs(value - exact) <= exact / LogHistogram::SubBucketCount + 0.001);
+    }
+
+    // Hitches show up in the tail, the single loading stall only in the max
+    CHECK(summary.P50 < 18.5 && summary.P95 < 18.5 && summary.P99 > 25.0 && summary.P999 < 200.0);
+    CHECK(summary.Max == 250.0);
+
+    for (size_t age = 0; age < 10; age++)
+        CHECK(std::fabs(stats.Sample(age) - trace[trace.size() - 1 - age]) < 0.001);
+
+    CHECK(stats.Sample(SeriesStats::WindowSize) == 0.0);
+
+    // Invalid samples are skipped, huge ones are clamped
+    stats.Add(-1.0);
+    stats.Add(NAN);
+    CHECK(std::fabs(stats.Last() - trace.back()) < 0.001);
+
+    stats.Add(1e9);
+    CHECK(stats.Last() == LogHistogram::MaxValue / 1000.0);
+
+    stats.Reset();
+    CHECK(stats.Size() == 0 && stats.Summarize().Count == 0);
+}
+
+// Samples recorded on another thread reach the statistics, a full ring drops instead of blocking
+static void RecordUpdate()
+{
+    FrameStats frameStats;
+    auto trace = RecordedTrace(3000);
+    std::atomic<bool> done { false };
+
+    std::thread producer(
+        [&]
+        {
+            for (size_t i = 0; i < trace.size(); i++)
+            {
+                frameStats.Record(Series::Present, trace[i]);
+
+                if (i % 64 == 0)
+                    std::this_thread::yield();
+            }
+
+            done = true;
+        });
+
+    while (!done)
+    {
+        frameStats.Update();
+        std::this_thread::yield();
+    }
+
+    producer.join();
+    frameStats.Update();
+
+    auto received = trace.size() - frameStats.Dropped();
+    CHECK(frameStats.Get(Series::Present).Size() == std::min(received, SeriesStats::WindowSize));
+    CHECK(frameStats.Get(Series::Upscaler).Size() == 0);
+
+    // Without Update the ring holds RingSize samples
+    FrameStats full;
+
+    for (size_t i = 0; i < FrameStats::RingSize + 10; i++)
+        full.Record(Series::Upscaler, 1.0);
+
+    CHECK(full.Dropped() == 10);
+
+    full.Update();
+    CHECK(full.Get(Series::Upscaler).Size() == FrameStats::RingSize);
+
+    full.Record(Series::Upscaler, 2.0);
+    full.Reset();
+    CHECK(full.Get(Series::Upscaler).Size() == 0);
+}
+
+static void FrameTimeHistory()
+{
+    History<double, 300> history;
+
+    CHECK(history.Last() == 0.0 && history.Recent(299) == 0.0);
+
+    for (int i = 1; i <= 1000; i++)
+        history.Push(i);
+
+    CHECK(history.Last() == 1000.0);
+    CHECK(history.Recent(99) == 901.0);
+    CHECK(history.Recent(299) == 701.0);
+    CHECK(history.Size() == 300);
+}
+
+int main()
+{
+    Bucketing();
+    TracePercentiles();
+    RecordUpdate();
+    FrameTimeHistory();
+
+    return TestResult();
+}
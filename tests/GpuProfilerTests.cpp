@@ -0,0 +1,241 @@
+// upscaler_time/GpuProfiler.h driven by a mock timestamp source
+
+#include "Check.h"
+
+#include <upscaler_time/GpuProfiler.h>
+
+#include <cmath>
+#include <string>
+#include <vector>
+
+using namespace gpu_profiler;
+
+// 1 tick is 1 us
+static constexpr double TicksPerSecond = 1000000.0;
+
+class MockSource : public ITimestampSource
+{
+  public:
+    std::array<uint64_t, QueryCount> Queries {};
+
+    // GPU finished the frame in the slot
+    std::array<bool, FrameCount> Ready {};
+
+    ReadResult Result = ReadResult::Ok;
+    std::vector<uint32_t> ReadSlots;
+
+    ReadResult ReadFrame(uint32_t slot, ScopeMask, std::span<uint64_t, QueriesPerFrame> timestamps,
+                         double& ticksPerSecond) override
+    {
+        if (!Ready[slot])
+            return ReadResult::NotReady;
+
+        Ready[slot] = false;
+        ReadSlots.push_back(slot);
+
+        for (uint32_t i = 0; i < QueriesPerFrame; i++)
+            timestamps[i] = Queries[slot * QueriesPerFrame + i];
+
+        ticksPerSecond = TicksPerSecond;
+        return Result;
+    }
+};
+
+// Writes the timestamps the GPU would write for the scope
+static bool Record(GpuProfiler& profiler, MockSource& source, Scope scope, uint64_t begin, uint64_t end)
+{
+    auto beginQuery = profiler.BeginScope(scope);
+    auto endQuery = profiler.EndScope(scope);
+
+    if (beginQuery == InvalidQuery || endQuery == InvalidQuery)
+        return false;
+
+    source.Queries[beginQuery] = begin;
+    source.Queries[endQuery] = end;
+    return true;
+}
+
+static bool Near(double a, double b) { return std::abs(a - b) < 1e-4; }
+
+static void ReadsFramesOnceReady()
+{
+    GpuProfiler profiler;
+    MockSource source;
+
+    CHECK(Record(profiler, source, Scope::Upscale, 1000, 3500));
+    CHECK(Record(profiler, source, Scope::RCAS, 3500, 3800));
+
+    auto slot = profiler.EndFrame();
+    CHECK(slot == 0);
+
+    // Not finished, nothing read and nothing waited for
+    CHECK(profiler.Collect(source) == 0);
+    CHECK(profiler.Frames(Scope::Upscale) == 0);
+
+    source.Ready[slot] = true;
+
+    std::vector<FrameResult> frames;
+    CHECK(profiler.Collect(source, [&](const FrameResult& frame) { frames.push_back(frame); }) == 1);
+    CHECK(frames.size() == 1);
+    CHECK(frames[0].FrameId == 0);
+    CHECK(frames[0].Has(Scope::Upscale) && frames[0].Has(Scope::RCAS) && !frames[0].Has(Scope::FGDispatch));
+    CHECK(Near(frames[0].Ms[(uint32_t) Scope::Upscale], 2.5));
+    CHECK(Near(profiler.Last(Scope::RCAS), 0.3));
+
+    // Slot is free again, reading again gives nothing
+    CHECK(profiler.Collect(source) == 0);
+}
+
+static void ReadsInSubmissionOrder()
+{
+    GpuProfiler profiler;
+    MockSource source;
+
+    for (uint32_t i = 0; i < 3; i++)
+    {
+        CHECK(Record(profiler, source, Scope::Upscale, 0, 1000 * (i + 1)));
+        profiler.EndFrame();
+    }
+
+    // Frame 1 is late, frame 2 must wait for it
+    source.Ready[0] = true;
+    source.Ready[2] = true;
+
+    CHECK(profiler.Collect(source) == 1);
+    CHECK(source.ReadSlots == std::vector<uint32_t>({ 0 }));
+
+    source.Ready[1] = true;
+
+    CHECK(profiler.Collect(source) == 2);
+    CHECK(source.ReadSlots == std::vector<uint32_t>({ 0, 1, 2 }));
+    CHECK(Near(profiler.Last(Scope::Upscale), 3.0));
+
+    // Running average of 1, 2 and 3 ms
+    CHECK(Near(profiler.Average(Scope::Upscale), 2.0));
+    CHECK(profiler.Frames(Scope::Upscale) == 3);
+}
+
+static void DropsFramesWhenGpuFallsBehind()
+{
+    GpuProfiler profiler;
+    MockSource source;
+
+    for (uint32_t i = 0; i < FrameCount; i++)
+    {
+        CHECK(Record(profiler, source, Scope::Upscale, 0, 100));
+        profiler.EndFrame();
+    }
+
+    // Fourth EndFrame wrapped onto the unread frame 0
+    CHECK(profiler.Dropped() == 1);
+
+    for (auto& ready : source.Ready)
+        ready = true;
+
+    CHECK(profiler.Collect(source) == FrameCount - 1);
+}
+
+static void IgnoresInvalidScopes()
+{
+    GpuProfiler profiler;
+    MockSource source;
+
+    // Only the first instance of a scope is measured
+    CHECK(profiler.BeginScope(Scope::Upscale) != InvalidQuery);
+    CHECK(profiler.BeginScope(Scope::Upscale) == InvalidQuery);
+    CHECK(profiler.EndScope(Scope::Upscale) != InvalidQuery);
+    CHECK(profiler.EndScope(Scope::Upscale) == InvalidQuery);
+
+    // End without begin
+    CHECK(profiler.EndScope(Scope::RCAS) == InvalidQuery);
+    profiler.EndFrame();
+
+    // Frame without a finished scope isn't read back
+    CHECK(profiler.BeginScope(Scope::RCAS) != InvalidQuery);
+    CHECK(profiler.EndFrame() == InvalidQuery);
+
+    // Broken measurements: end before begin and over MaxScopeMs
+    GpuProfiler filtered;
+    MockSource filteredSource;
+
+    CHECK(Record(filtered, filteredSource, Scope::Upscale, 500, 100));
+    CHECK(Record(filtered, filteredSource, Scope::RCAS, 0, (uint64_t) (GpuProfiler::MaxScopeMs * 1000.0) + 1));
+    CHECK(Record(filtered, filteredSource, Scope::MenuRender, 0, 200));
+    filteredSource.Ready[filtered.EndFrame()] = true;
+
+    std::vector<FrameResult> frames;
+    filtered.Collect(filteredSource, [&](const FrameResult& frame) { frames.push_back(frame); });
+    CHECK(frames.size() == 1 && frames[0].Mask == MaskOf(Scope::MenuRender));
+
+    // Invalid frames (e.g. disjoint) are discarded and free their slot
+    GpuProfiler disjoint;
+    MockSource disjointSource;
+    disjointSource.Result = ReadResult::Invalid;
+
+    CHECK(Record(disjoint, disjointSource, Scope::Upscale, 0, 100));
+    disjointSource.Ready[disjoint.EndFrame()] = true;
+    CHECK(disjoint.Collect(disjointSource) == 0);
+    CHECK(disjoint.Frames(Scope::Upscale) == 0);
+    CHECK(disjointSource.ReadSlots.size() == 1);
+}
+
+static void RecentScopes()
+{
+    GpuProfiler profiler;
+    MockSource source;
+
+    CHECK(!profiler.IsRecent(Scope::Upscale));
+
+    CHECK(Record(profiler, source, Scope::Upscale, 0, 100));
+    source.Ready[profiler.EndFrame()] = true;
+    profiler.Collect(source);
+    CHECK(profiler.IsRecent(Scope::Upscale));
+
+    // Pass got disabled
+    for (uint32_t i = 0; i < 2 * FrameCount + 1; i++)
+        profiler.EndFrame();
+
+    CHECK(!profiler.IsRecent(Scope::Upscale));
+}
+
+static void WritesCsv()
+{
+    auto path = std::filesystem::temp_directory_path() / "opti_gpu_profiler_test.csv";
+
+    GpuProfiler profiler;
+    MockSource source;
+
+    CHECK(profiler.StartCsv(path));
+    CHECK(profiler.IsCsvActive());
+
+    CHECK(Record(profiler, source, Scope::RCAS, 0, 500));
+    source.Ready[profiler.EndFrame()] = true;
+    profiler.Collect(source);
+    profiler.StopCsv();
+    CHECK(!profiler.IsCsvActive());
+
+    std::ifstream file(path);
+    std::string header;
+    std::string row;
+    std::getline(file, header);
+    std::getline(file, row);
+    file.close();
+
+    CHECK(header.rfind("frame,Upscale (ms),RCAS (ms)", 0) == 0);
+    CHECK(row == "0,,0.5,,,,");
+
+    std::error_code ec;
+    std::filesystem::remove(path, ec);
+}
+
+int main()
+{
+    ReadsFramesOnceReady();
+    ReadsInSubmissionOrder();
+    DropsFramesWhenGpuFallsBehind();
+    IgnoresInvalidScopes();
+    RecentScopes();
+    WritesCsv();
+
+    return TestResult();
+}
@@ -0,0 +1,176 @@
+// misc/GracePeriod.h, the reclamation used by the command buffer table and the heap index.
+// The table itself depends on pch.h and Vulkan, so it is exercised through the same publish / retire pattern.
+
+#include "Check.h"
+
+#include <misc/GracePeriod.h>
+#include <resource_tracking/HeapIndex_dx12.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <thread>
+#include <vector>
+
+static constexpr uint32_t Alive = 0xA11CE;
+static constexpr uint32_t Freed = 0xDEAD;
+
+struct Table
+{
+    std::vector<uint32_t> Values;
+};
+
+// Writer republishes a copy and poisons the old table after Synchronize, readers must never see the poison
+static void RetiredTablesOutliveReaders()
+{
+    grace_period::Domain domain;
+    std::atomic<Table*> current { new Table { std::vector<uint32_t>(64, Alive) } };
+    std::atomic<bool> stop { false };
+    std::atomic<uint64_t> poisoned { 0 };
+    std::atomic<uint64_t> reads { 0 };
+
+    std::vector<std::thread> readers;
+
+    for (int i = 0; i < 3; i++)
+    {
+        readers.emplace_back(
+            [&]
+            {
+                while (!stop.load(std::memory_order_relaxed))
+                {
+                    auto guard = domain.Enter();
+                    auto table = current.load(std::memory_order_seq_cst);
+
+                    for (auto value : table->Values)
+                    {
+                        if (value != Alive)
+                            poisoned.fetch_add(1, std::memory_order_relaxed);
+                    }
+
+                    reads.fetch_add(1, std::memory_order_relaxed);
+                }
+            });
+    }
+
+    // Don't let the writer finish before a reader got scheduled
+    while (reads.load() == 0)
+        std::this_thread::yield();
+
+    for (int i = 0; i < 300; i++)
+    {
+        auto next = new Table { current.load(std::memory_order_relaxed)->Values };
+        auto old = current.exchange(next, std::memory_order_seq_cst);
+
+        domain.Synchronize();
+
+        std::fill(old->Values.begin(), old->Values.end(), Freed);
+        delete old;
+    }
+
+    stop = true;
+
+    for (auto& reader : readers)
+        reader.join();
+
+    delete current.load();
+
+    CHECK(poisoned.load() == 0);
+    CHECK(reads.load() > 0);
+}
+
+// Synchronize must not return while a reader which entered before it still holds its guard
+static void SynchronizeWaitsForReaders()
+{
+    grace_period::Domain domain;
+    std::atomic<bool> entered { false };
+    std::atomic<bool> release { false };
+    std::atomic<bool> synchronized { false };
+
+    std::thread reader(
+        [&]
+        {
+            auto guard = domain.Enter();
+            entered = true;
+
+            while (!release)
+                std::this_thread::yield();
+        });
+
+    while (!entered)
+        std::this_thread::yield();
+
+    std::thread writer(
+        [&]
+        {
+            domain.Synchronize();
+            synchronized = true;
+        });
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    CHECK(!synchronized.load());
+
+    release = true;
+    reader.join();
+    writer.join();
+
+    CHECK(synchronized.load());
+}
+
+// Heap index publishes on the same domain, lookups race inserts and removes
+static void HeapIndexLookupsDuringUpdates()
+{
+    static int values[8];
+
+    HeapIntervalIndex<int> index;
+    std::atomic<bool> stop { false };
+    std::atomic<uint64_t> wrong { 0 };
+
+    std::vector<std::thread> readers;
+
+    for (int i = 0; i < 2; i++)
+    {
+        readers.emplace_back(
+            [&]
+            {
+                while (!stop.load(std::memory_order_relaxed))
+                {
+                    for (size_t handle = 100; handle < 900; handle += 37)
+                    {
+                        auto value = index.Find(handle);
+
+                        // Ranges are [100 + k * 100, 150 + k * 100)
+                        if (value != nullptr && value != &values[(handle - 100) / 100])
+                            wrong.fetch_add(1, std::memory_order_relaxed);
+                    }
+                }
+            });
+    }
+
+    for (int i = 0; i < 600; i++)
+    {
+        int k = i % 8;
+        index.Insert(100 + k * 100, 150 + k * 100, &values[k]);
+
+        if (i % 3 == 0)
+            index.Remove(&values[(k + 3) % 8]);
+    }
+
+    stop = true;
+
+    for (auto& reader : readers)
+        reader.join();
+
+    CHECK(wrong.load() == 0);
+    CHECK(index.Find(99) == nullptr);
+    CHECK(index.Find(150) == nullptr);
+}
+
+int main()
+{
+    RetiredTablesOutliveReaders();
+    SynchronizeWaitsForReaders();
+    HeapIndexLookupsDuringUpdates();
+
+    return TestResult();
+}
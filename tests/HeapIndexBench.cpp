@@ -0,0 +1,111 @@
+// resource_tracking/HeapIndex_dx12.h, lookup, insert and remove cost for 10, 100 and 10k heaps.
+// The linear walk is what descriptor lookups did before the index.
+
+#include "Bench.h"
+
+#include <resource_tracking/HeapIndex_dx12.h>
+
+#include <random>
+#include <thread>
+#include <vector>
+
+struct Heap
+{
+    size_t Start;
+    size_t End;
+};
+
+static const Heap* LinearFind(const std::vector<Heap>& heaps, size_t handle)
+{
+    for (auto& heap : heaps)
+    {
+        if (handle >= heap.Start && handle < heap.End)
+            return &heap;
+    }
+
+    return nullptr;
+}
+
+int main(int argc, char** argv)
+{
+    auto quick = QuickRun(argc, argv);
+    const uint64_t lookups = quick ? 1000 : 2'000'000;
+
+    std::printf("%8s %12s %12s %14s %20s\n", "heaps", "find ns", "linear ns", "find 4 thr ns", "insert+remove us");
+
+    for (size_t count : { 10, 100, 10000 })
+    {
+        // Heaps of 1k descriptors, 32 byte descriptor size, with gaps like separate allocations
+        std::vector<Heap> heaps(count);
+
+        for (size_t i = 0; i < count; i++)
+            heaps[i] = { 0x10000 + i * 0x10000, 0x10000 + i * 0x10000 + 1000 * 32 };
+
+        HeapIntervalIndex<const Heap> index;
+
+        for (auto& heap : heaps)
+            index.Insert(heap.Start, heap.End, &heap);
+
+        std::mt19937_64 rng(1);
+        std::vector<size_t> handles(4096);
+
+        for (auto& handle : handles)
+        {
+            auto& heap = heaps[rng() % count];
+            handle = heap.Start + (rng() % 1000) * 32;
+        }
+
+        auto find = NsPerOp(lookups,
+                            [&]
+                            {
+                                for (uint64_t i = 0; i < lookups; i++)
+                                    KeepValue(index.Find(handles[i & 4095]));
+                            });
+
+        auto linearLookups = count > 1000 ? lookups / 100 : lookups;
+        auto linear = NsPerOp(linearLookups,
+                              [&]
+                              {
+                                  for (uint64_t i = 0; i < linearLookups; i++)
+                                      KeepValue(LinearFind(heaps, handles[i & 4095]));
+                              });
+
+        // Lookups from several recording threads
+        auto threaded = NsPerOp(lookups,
+                                [&]
+                                {
+                                    std::vector<std::thread> threads;
+
+                                    for (uint64_t t = 0; t < 4; t++)
+                                    {
+                                        threads.emplace_back(
+                                            [&, t]
+                                            {
+                                                for (uint64_t i = 0; i < lookups / 4; i++)
+                                                    KeepValue(index.Find(handles[(i + t * 1024) & 4095]));
+                                            });
+                                    }
+
+                                    for (auto& thread : threads)
+                                        thread.join();
+                                });
+
+        // Heap created and released, copy on write of the whole index
+        const uint64_t updates = quick ? 10 : 200;
+        Heap extra { 0x10000 + count * 0x10000, 0x10000 + count * 0x10000 + 32000 };
+
+        auto update = NsPerOp(updates,
+                              [&]
+                              {
+                                  for (uint64_t i = 0; i < updates; i++)
+                                  {
+                                      index.Insert(extra.Start, extra.End, &extra);
+                                      index.Remove(&extra);
+                                  }
+                              });
+
+        std::printf("%8zu %12.1f %12.1f %14.1f %20.2f\n", count, find, linear, threaded, update / 1000.0);
+    }
+
+    return 0;
+}
@@ -0,0 +1,148 @@
+// resource_tracking/HeapIndex_dx12.h, lookups, inserts and removes of the descriptor heap interval index
+
+#include "Check.h"
+
+#include <resource_tracking/HeapIndex_dx12.h>
+
+static int heaps[8];
+
+static void Lookups()
+{
+    HeapIntervalIndex<int> index;
+    CHECK(index.Find(100) == nullptr && index.Size() == 0 && index.Epoch() == 0);
+
+    // Inserted out of order
+    index.Insert(300, 400, &heaps[2]);
+    index.Insert(100, 200, &heaps[0]);
+    index.Insert(200, 250, &heaps[1]);
+    CHECK(index.Size() == 3 && index.Epoch() == 3);
+
+    CHECK(index.Find(99) == nullptr);
+    CHECK(index.Find(100) == &heaps[0]);
+    CHECK(index.Find(199) == &heaps[0]);
+
+    // End is exclusive, adjacent range takes over
+    CHECK(index.Find(200) == &heaps[1]);
+    CHECK(index.Find(249) == &heaps[1]);
+
+    // Gap between ranges
+    CHECK(index.Find(250) == nullptr);
+    CHECK(index.Find(299) == nullptr);
+    CHECK(index.Find(300) == &heaps[2]);
+    CHECK(index.Find(400) == nullptr);
+    CHECK(index.Find(SIZE_MAX) == nullptr);
+}
+
+static void InvalidInserts()
+{
+    HeapIntervalIndex<int> index;
+
+    index.Insert(0, 100, &heaps[0]);
+    index.Insert(200, 200, &heaps[0]);
+    index.Insert(300, 250, &heaps[0]);
+    index.Insert(400, 500, nullptr);
+
+    CHECK(index.Size() == 0 && index.Epoch() == 0);
+}
+
+// Address space of a released heap got reused by a new one
+static void OverlapReplacesStaleRanges()
+{
+    HeapIntervalIndex<int> index;
+
+    index.Insert(100, 200, &heaps[0]);
+    index.Insert(200, 300, &heaps[1]);
+    index.Insert(400, 500, &heaps[2]);
+
+    index.Insert(150, 250, &heaps[3]);
+    CHECK(index.Size() == 2);
+    CHECK(index.Find(120) == nullptr);
+    CHECK(index.Find(150) == &heaps[3] && index.Find(249) == &heaps[3]);
+    CHECK(index.Find(260) == nullptr);
+    CHECK(index.Find(450) == &heaps[2]);
+
+    // Same range again
+    index.Insert(150, 250, &heaps[4]);
+    CHECK(index.Size() == 2 && index.Find(150) == &heaps[4]);
+}
+
+static void Removes()
+{
+    HeapIntervalIndex<int> index;
+
+    index.Insert(100, 200, &heaps[0]);
+    index.Insert(200, 300, &heaps[1]);
+    index.Insert(300, 400, &heaps[0]);
+
+    // Every range of the heap goes
+    index.Remove(&heaps[0]);
+    CHECK(index.Size() == 1);
+    CHECK(index.Find(150) == nullptr && index.Find(350) == nullptr);
+    CHECK(index.Find(250) == &heaps[1]);
+
+    // Unknown heap and nullptr don't publish a new snapshot
+    auto epoch = index.Epoch();
+    index.Remove(&heaps[5]);
+    index.Remove(nullptr);
+    CHECK(index.Epoch() == epoch);
+
+    index.Remove(&heaps[1]);
+    CHECK(index.Size() == 0 && index.Find(250) == nullptr);
+    CHECK(index.Epoch() == epoch + 1);
+}
+
+// Compared with a linear walk of the same ranges over many heaps
+static void MatchesLinearWalk()
+{
+    HeapIntervalIndex<int> index;
+    static int many[1000];
+
+    struct Range
+    {
+        size_t Start;
+        size_t End;
+        int* Value;
+    };
+
+    std::vector<Range> ranges;
+
+    for (size_t i = 0; i < 1000; i++)
+    {
+        // Mixed sizes with gaps, inserted in a scattered order
+        auto slot = (i * 389) % 1000;
+        auto start = 1 + slot * 1000;
+        auto end = start + 1 + (slot * 7) % 900;
+
+        index.Insert(start, end, &many[slot]);
+        ranges.push_back({ start, end, &many[slot] });
+    }
+
+    uint32_t wrong = 0;
+
+    for (size_t handle = 0; handle < 1000 * 1000 + 10; handle += 13)
+    {
+        int* expected = nullptr;
+
+        for (auto& range : ranges)
+        {
+            if (handle >= range.Start && handle < range.End)
+                expected = range.Value;
+        }
+
+        if (index.Find(handle) != expected)
+            wrong++;
+    }
+
+    CHECK(wrong == 0);
+}
+
+int main()
+{
+    Lookups();
+    InvalidInserts();
+    OverlapReplacesStaleRanges();
+    Removes();
+    MatchesLinearWalk();
+
+    return TestResult();
+}
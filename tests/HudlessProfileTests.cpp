@@ -0,0 +1,225 @@
+// hudfix/HudlessProfile.h, signature matching, per session tracking and the profile file
+
+#include "Check.h"
+
+#include <hudfix/HudlessProfile.h>
+
+namespace fs = std::filesystem;
+using namespace hudless_profile;
+
+constexpr uint32_t Rgba16 = 10;
+constexpr uint32_t Bgra8 = 87;
+constexpr uint32_t FromPresent = 1;
+constexpr uint32_t FromCopy = 2;
+
+static Signature Hudless(uint32_t ordinal = 40)
+{
+    return MakeSignature(Rgba16, 3840, 2160, 3840, 2160, FromCopy, ordinal);
+}
+
+static void Matching()
+{
+    auto stored = Hudless();
+
+    CHECK(Ratio(1920, 3840) == 500 && Ratio(0, 3840) == 0 && Ratio(100, 0) == 0);
+    CHECK(Matches(stored, stored));
+
+    // Dynamic resolution and rounding stay inside the ratio tolerance
+    CHECK(Matches(stored, MakeSignature(Rgba16, 3830, 2155, 3840, 2160, FromCopy, 40)));
+    CHECK(!Matches(stored, MakeSignature(Rgba16, 3800, 2160, 3840, 2160, FromCopy, 40)));
+    CHECK(!Matches(stored, MakeSignature(Rgba16, 1920, 1080, 3840, 2160, FromCopy, 40)));
+
+    // Same resource at another display size
+    CHECK(Matches(stored, MakeSignature(Rgba16, 1920, 1080, 1920, 1080, FromCopy, 40)));
+
+    CHECK(!Matches(stored, MakeSignature(Bgra8, 3840, 2160, 3840, 2160, FromCopy, 40)));
+    CHECK(!Matches(stored, MakeSignature(Rgba16, 3840, 2160, 3840, 2160, FromPresent, 40)));
+
+    // Ordinal tolerance grows with the ordinal, never below MinOrdinalTolerance
+    CHECK(OrdinalTolerance(0) == MinOrdinalTolerance && OrdinalTolerance(40) == MinOrdinalTolerance);
+    CHECK(OrdinalTolerance(160) == 10);
+    CHECK(Matches(stored, Hudless(42)) && Matches(stored, Hudless(38)));
+    CHECK(!Matches(stored, Hudless(43)) && !Matches(stored, Hudless(37)));
+    CHECK(Matches(Hudless(160), Hudless(170)) && !Matches(Hudless(160), Hudless(171)));
+}
+
+static void OrdinalDeferral()
+{
+    Tracker tracker;
+    auto other = MakeSignature(Bgra8, 3840, 2160, 3840, 2160, FromCopy, 0);
+
+    // Without a profile everything goes to the regular checks
+    CHECK(tracker.Check(other) == Decision::Regular);
+
+    tracker.SetStored(Hudless(40));
+
+    // Earlier candidates wait, the profile could still match later in the frame
+    other.Ordinal = 10;
+    CHECK(tracker.Check(other) == Decision::Defer);
+    other.Ordinal = 42;
+    CHECK(tracker.Check(other) == Decision::Defer);
+    CHECK(tracker.Check(Hudless(41)) == Decision::Capture);
+
+    // Past the window regular checks take over
+    other.Ordinal = 43;
+    CHECK(tracker.Check(other) == Decision::Regular);
+
+    // After the match nothing else of the frame is deferred
+    CHECK(!tracker.Captured(Hudless(41)));
+    other.Ordinal = 10;
+    CHECK(tracker.Check(other) == Decision::Regular);
+    CHECK(tracker.Check(Hudless(40)) == Decision::Regular);
+
+    CHECK(!tracker.FrameEnd(5));
+    CHECK(tracker.Check(other) == Decision::Defer);
+}
+
+static void MissRemoval()
+{
+    Tracker tracker;
+    tracker.SetStored(Hudless());
+
+    // Frames without candidates (menus, loading screens) don't count
+    for (uint32_t i = 0; i < MaxMissFrames * 2; i++)
+        CHECK(!tracker.FrameEnd(0));
+
+    for (uint32_t i = 0; i < MaxMissFrames - 1; i++)
+        CHECK(!tracker.FrameEnd(3));
+
+    // A match resets the count
+    tracker.Captured(Hudless());
+    CHECK(!tracker.FrameEnd(3));
+
+    for (uint32_t i = 0; i < MaxMissFrames - 1; i++)
+        CHECK(!tracker.FrameEnd(3));
+
+    CHECK(tracker.Stored().has_value());
+    CHECK(tracker.FrameEnd(3));
+    CHECK(!tracker.Stored().has_value());
+
+    // Dropped profile doesn't fire again
+    CHECK(!tracker.FrameEnd(3));
+    CHECK(tracker.Check(Hudless()) == Decision::Regular);
+}
+
+static void SaveThreshold()
+{
+    Tracker tracker;
+    auto hudless = Hudless(12);
+
+    for (uint32_t i = 1; i < StableFrames; i++)
+    {
+        CHECK(!tracker.Captured(hudless));
+        tracker.FrameEnd(4);
+    }
+
+    // Signature changed, stable count starts again
+    auto moved = Hudless(20);
+    CHECK(!tracker.Captured(moved));
+    tracker.FrameEnd(4);
+
+    for (uint32_t i = 1; i < StableFrames - 1; i++)
+    {
+        CHECK(!tracker.Captured(moved));
+        tracker.FrameEnd(4);
+    }
+
+    CHECK(tracker.Captured(moved));
+    CHECK(tracker.Stored() == moved);
+    tracker.FrameEnd(4);
+
+    // Saved once, later matching captures don't ask again
+    for (uint32_t i = 0; i < StableFrames * 2; i++)
+    {
+        CHECK(!tracker.Captured(moved));
+        tracker.FrameEnd(4);
+    }
+
+    // Loaded profile counts as saved
+    Tracker loaded;
+    loaded.SetStored(moved);
+
+    for (uint32_t i = 0; i < StableFrames * 2; i++)
+    {
+        CHECK(!loaded.Captured(moved));
+        loaded.FrameEnd(4);
+    }
+}
+
+static void FileRoundTrip(const fs::path& dir)
+{
+    auto path = dir / "OptiScaler.hudless";
+
+    ProfileFile profiles;
+    CHECK(!profiles.Load(path) && profiles.Size() == 0);
+
+    profiles.Store("Game-Win64-Shipping.exe", Hudless(12));
+    profiles.Store("other game.exe", MakeSignature(Bgra8, 2560, 1440, 2560, 1440, FromPresent, 3));
+    CHECK(profiles.IsDirty() && profiles.Size() == 2);
+    CHECK(profiles.Save(path) && !profiles.IsDirty());
+    CHECK(!fs::exists(dir / "OptiScaler.hudless.tmp"));
+
+    // Same value again doesn't need a save
+    profiles.Store("Game-Win64-Shipping.exe", Hudless(12));
+    CHECK(!profiles.IsDirty());
+
+    ProfileFile loaded;
+    CHECK(loaded.Load(path) && loaded.Size() == 2);
+    CHECK(loaded.Lookup("Game-Win64-Shipping.exe") == Hudless(12));
+    CHECK(loaded.Lookup("other game.exe") == MakeSignature(Bgra8, 2560, 1440, 2560, 1440, FromPresent, 3));
+    CHECK(!loaded.Lookup("game-win64-shipping.exe").has_value());
+
+    loaded.Remove("other game.exe");
+    loaded.Remove("not there.exe");
+    CHECK(loaded.IsDirty() && loaded.Size() == 1);
+
+    // Oldest entries go first, the file keeps 64
+    for (int i = 0; i < 70; i++)
+        loaded.Store("game" + std::to_string(i) + ".exe", Hudless(i));
+
+    CHECK(loaded.Size() == 64);
+    CHECK(!loaded.Lookup("Game-Win64-Shipping.exe").has_value() && !loaded.Lookup("game5.exe").has_value());
+    CHECK(loaded.Lookup("game6.exe") == Hudless(6));
+    CHECK(loaded.Save(path));
+
+    CHECK(profiles.Load(path) && profiles.Size() == 64);
+    CHECK(profiles.Lookup("game69.exe") == Hudless(69));
+
+    // Broken lines are skipped
+    {
+        std::ofstream file(path, std::ios::binary | std::ios::trunc);
+        file << "OptiScaler hudless profile 1\n";
+        file << "no tab\n";
+        file << "\t1 2 3 4 5\n";
+        file << "short.exe\t1\t2\n";
+        file << "good.exe\t1\t2\t3\t4\t5\n";
+    }
+
+    CHECK(profiles.Load(path) && profiles.Size() == 1);
+    CHECK(profiles.Lookup("good.exe") == (Signature { 1, 2, 3, 4, 5 }));
+
+    {
+        std::ofstream file(path, std::ios::binary | std::ios::trunc);
+        file << "OptiScaler hudless profile 0\n";
+        file << "game.exe\t1\t2\t3\t4\t5\n";
+    }
+
+    CHECK(!profiles.Load(path) && profiles.Size() == 0);
+}
+
+int main()
+{
+    auto dir = fs::temp_directory_path() / "opti_hudless_profile_test";
+    fs::remove_all(dir);
+    fs::create_directories(dir);
+
+    Matching();
+    OrdinalDeferral();
+    MissRemoval();
+    SaveThreshold();
+    FileRoundTrip(dir);
+
+    fs::remove_all(dir);
+
+    return TestResult();
+}
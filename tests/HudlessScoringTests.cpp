@@ -0,0 +1,203 @@
+// hudfix/HudlessScoring.h, election and capture of hudless candidates and trace replay
+
+#include "Check.h"
+
+#include <hudfix/HudlessScoring.h>
+
+#include <random>
+#include <thread>
+
+using namespace hudless_scoring;
+
+// Full size, display format group
+static Candidate Hudless(uint32_t ordinal) { return { 0xA000, 28, 6, 1000, 1000, 64 | 512, ordinal }; }
+
+// Half size, other format group
+static Candidate Other(uint64_t key, uint32_t ordinal) { return { key, 10, 3, 500, 500, 2 | 256, ordinal }; }
+
+// 200 frames of 300 candidates, hudless at position 120 and a full size impostor every 7th frame before it
+static std::string SyntheticTrace()
+{
+    std::mt19937 rng(1);
+    std::ostringstream trace;
+
+    trace << "# frame key format formatGroup widthRatio heightRatio captureInfo ordinal\n\n";
+
+    for (uint64_t frame = 0; frame < 200; frame++)
+    {
+        for (uint32_t i = 0; i < 300; i++)
+        {
+            Candidate c;
+
+            if (i == 120)
+                c = Hudless(i);
+            else if (i == 40 && frame % 7 == 0)
+                c = { 0xB000 + frame, 28, 6, 1000, 1000, 2 | 256, i };
+            else
+                c = Other(0x1000 + (uint64_t) (rng() % 50) * 16, i);
+
+            trace << frame << ' ' << c.Key << ' ' << c.Format << ' ' << c.FormatGroup << ' ' << c.WidthRatio << ' '
+                  << c.HeightRatio << ' ' << c.CaptureInfo << ' ' << c.Ordinal << '\n';
+        }
+    }
+
+    return trace.str();
+}
+
+static void ReplayCapturesHudless()
+{
+    std::istringstream input(SyntheticTrace() + "not a candidate\n");
+    auto trace = ParseTrace(input);
+    CHECK(trace.size() == 60000);
+
+    FrameSettings settings;
+    settings.DisplayFormatGroup = 6;
+
+    Engine engine;
+    auto report = Replay(trace, settings, engine);
+    CHECK(report.Frames.size() == 200);
+    CHECK(report.Candidates == 60000);
+
+    // Without history the earlier impostor wins the tie, its key doesn't come back in the next frame
+    CHECK(report.Frames[0].Result.Winner.Key == 0xB000);
+    CHECK(!report.Frames[0].Captured.has_value() && !report.Frames[1].Captured.has_value());
+
+    uint32_t captures = 0;
+    uint32_t wrong = 0;
+
+    for (size_t i = 1; i < report.Frames.size(); i++)
+    {
+        auto& frame = report.Frames[i];
+        CHECK(frame.Result.Elected && frame.Result.Winner.Key == 0xA000);
+
+        if (!frame.Captured.has_value())
+            continue;
+
+        captures++;
+
+        if (frame.Captured->Key != 0xA000)
+            wrong++;
+    }
+
+    CHECK(captures == 198);
+    CHECK(wrong == 0);
+}
+
+static void LowScoreIsNotElected()
+{
+    Engine engine;
+    FrameSettings settings;
+    settings.DisplayFormatGroup = 6;
+
+    CHECK(!engine.Record(Other(0x1000, 0)));
+    auto decision = engine.EndFrame(settings);
+
+    CHECK(decision.Candidates == 1 && decision.Distinct == 1);
+    CHECK(!decision.Elected);
+    CHECK(decision.Score < Weights {}.MinScore);
+    CHECK(!engine.Record(Other(0x1000, 0)));
+}
+
+static void CapturesOncePerFrame()
+{
+    Engine engine;
+    FrameSettings settings;
+    settings.DisplayFormatGroup = 6;
+
+    std::atomic<uint32_t> captures { 0 };
+
+    for (uint32_t frame = 0; frame < 20; frame++)
+    {
+        std::vector<std::thread> threads;
+
+        for (uint32_t t = 0; t < 4; t++)
+        {
+            threads.emplace_back(
+                [&]
+                {
+                    for (uint32_t i = 0; i < 100; i++)
+                    {
+                        if (engine.Record(Hudless(i)))
+                            captures++;
+                    }
+                });
+        }
+
+        for (auto& thread : threads)
+            thread.join();
+
+        auto decision = engine.EndFrame(settings);
+
+        // Same resource recorded 400 times is one distinct candidate with the lowest ordinal
+        CHECK(decision.Distinct == 1 && decision.Winner.Ordinal == 0);
+    }
+
+    CHECK(captures.load() == 19);
+}
+
+static void EmptyFrameKeepsElection()
+{
+    Engine engine;
+    FrameSettings settings;
+    settings.DisplayFormatGroup = 6;
+
+    engine.Record(Hudless(0));
+    CHECK(engine.EndFrame(settings).Elected);
+
+    // Menu or loading screen
+    auto empty = engine.EndFrame(settings);
+    CHECK(!empty.Elected && empty.Candidates == 0);
+    CHECK(engine.Record(Hudless(0)));
+
+    engine.EndFrame(settings);
+    engine.Reset();
+    CHECK(!engine.Record(Hudless(0)));
+}
+
+static void ProfileDecidesBetweenEqualCandidates()
+{
+    // Same size and format, first one is preferred by rank
+    Candidate first { 0xC000, 28, 6, 1000, 1000, 2 | 256, 0 };
+    Candidate second { 0xD000, 28, 6, 1000, 1000, 64 | 512, 1 };
+
+    FrameSettings settings;
+    settings.DisplayFormatGroup = 6;
+
+    Engine plain;
+    plain.Record(first);
+    plain.Record(second);
+    CHECK(plain.EndFrame(settings).Winner.Key == first.Key);
+
+    settings.Profile = second.ToSignature();
+
+    Engine profiled;
+    profiled.Record(first);
+    profiled.Record(second);
+    CHECK(profiled.EndFrame(settings).Winner.Key == second.Key);
+}
+
+static void FullTableDropsCandidates()
+{
+    Engine engine;
+
+    for (uint32_t i = 0; i < Engine::TableSize + 10; i++)
+        engine.Record(Other(0x1000 + i * 16, i));
+
+    CHECK(engine.Dropped() == 10);
+
+    auto decision = engine.EndFrame({});
+    CHECK(decision.Candidates == Engine::TableSize);
+    CHECK(engine.Frame() == 1);
+}
+
+int main()
+{
+    ReplayCapturesHudless();
+    LowScoreIsNotElected();
+    CapturesOncePerFrame();
+    EmptyFrameKeepsElection();
+    ProfileDecidesBetweenEqualCandidates();
+    FullTableDropsCandidates();
+
+    return TestResult();
+}
@@ -0,0 +1,208 @@
+// upscalers/JitterAnalyzer.h, detection of jitter sequences, their units and axis signs
+
+#include "Check.h"
+
+#include <upscalers/JitterAnalyzer.h>
+
+#include <cmath>
+#include <random>
+
+using namespace jitter_analysis;
+
+template <typename F> static Result Run(F offset, int frames = 1000)
+{
+    Analyzer analyzer;
+
+    for (int i = 0; i < frames; i++)
+    {
+        float x = 0.0f;
+        float y = 0.0f;
+        offset(i, x, y);
+        analyzer.Record(x, y);
+    }
+
+    return analyzer.GetResult();
+}
+
+static void DetectsHalton()
+{
+    auto result = Run([](int i, float& x, float& y) { GeneratorPoint(Generator::Halton23, 1 + i % 8, x, y); });
+    CHECK(result.State == Status::Periodic && result.Period == 8);
+    CHECK(result.Sequence == Generator::Halton23);
+    CHECK(std::fabs(result.ScaleX - 1.0f) < 1e-4f);
+
+    // NDC units with flipped Y, sequence doesn't start at the first index
+    result = Run(
+        [](int i, float& x, float& y)
+        {
+            GeneratorPoint(Generator::Halton23, 1 + (i + 5) % 32, x, y);
+            x *= 2.0f / 1920.0f;
+            y *= -2.0f / 1080.0f;
+        });
+    CHECK(result.Period == 32);
+    CHECK(result.SignX == 1 && result.SignY == -1);
+    CHECK(std::fabs(result.ScaleX - 2.0f / 1920.0f) < 1e-6f);
+
+    result = Run([](int i, float& x, float& y) { GeneratorPoint(Generator::Halton23, i % 16, x, y); });
+    CHECK(result.Period == 16 && result.Sequence == Generator::Halton23);
+
+    result = Run([](int i, float& x, float& y) { GeneratorPoint(Generator::Halton23, 1 + i % 72, x, y); });
+    CHECK(result.Period == 72 && result.Sequence == Generator::Halton23);
+}
+
+static void DetectsR2()
+{
+    auto result = Run(
+        [](int i, float& x, float& y)
+        {
+            GeneratorPoint(Generator::R2, i % 24, x, y);
+            x = -x;
+        });
+    CHECK(result.Period == 24 && result.Sequence == Generator::R2);
+    CHECK(result.SignX == -1);
+}
+
+static void DetectsCustomSequence()
+{
+    static const float points[4][2] = {
+        { 0.125f, 0.375f }, { -0.375f, 0.125f }, { 0.375f, -0.125f }, { -0.125f, -0.375f }
+    };
+
+    auto result = Run(
+        [](int i, float& x, float& y)
+        {
+            x = points[i % 4][0];
+            y = points[i % 4][1];
+        });
+    CHECK(result.State == Status::Periodic && result.Period == 4);
+    CHECK(result.Sequence == Generator::Unknown);
+}
+
+static void Aperiodic()
+{
+    auto result = Run([](int i, float& x, float& y) { GeneratorPoint(Generator::Halton23, 1 + i, x, y); });
+    CHECK(result.State == Status::Aperiodic);
+
+    std::mt19937 rng(1);
+    std::uniform_real_distribution<float> offset(-0.5f, 0.5f);
+
+    result = Run(
+        [&](int, float& x, float& y)
+        {
+            x = offset(rng);
+            y = offset(rng);
+        },
+        5000);
+    CHECK(result.State == Status::Aperiodic && result.Distinct == RingSize);
+}
+
+static void AbsentAndBroken()
+{
+    auto result = Run(
+        [](int, float& x, float& y)
+        {
+            x = 0.0f;
+            y = -0.0f;
+        });
+    CHECK(result.State == Status::Absent);
+
+    // Stuck between two offsets
+    result = Run(
+        [](int i, float& x, float& y)
+        {
+            x = i % 2 ? 0.25f : -0.25f;
+            y = 0.0f;
+        });
+    CHECK(result.State == Status::Broken);
+
+    // Recent NaN breaks the sequence, an old one is forgotten
+    result = Run(
+        [](int i, float& x, float& y)
+        {
+            GeneratorPoint(Generator::Halton23, 1 + i % 8, x, y);
+
+            if (i == 900)
+                x = NAN;
+        });
+    CHECK(result.State == Status::Broken);
+
+    result = Run(
+        [](int i, float& x, float& y)
+        {
+            GeneratorPoint(Generator::Halton23, 1 + i % 8, x, y);
+
+            if (i == 100)
+                x = NAN;
+        });
+    CHECK(result.State == Status::Periodic);
+}
+
+static void FollowsSequenceChange()
+{
+    auto result = Run(
+        [](int i, float& x, float& y)
+        {
+            if (i < 600)
+                GeneratorPoint(Generator::Halton23, 1 + i % 8, x, y);
+            else
+                GeneratorPoint(Generator::Halton23, 1 + i % 16, x, y);
+        },
+        1200);
+    CHECK(result.State == Status::Periodic && result.Period == 16);
+
+    Analyzer analyzer;
+
+    for (uint32_t i = 0; i < 100; i++)
+    {
+        float x;
+        float y;
+        GeneratorPoint(Generator::Halton23, 1 + i % 8, x, y);
+        analyzer.Record(x, y);
+    }
+
+    CHECK(analyzer.GetResult().State == Status::Periodic);
+    analyzer.Reset();
+    CHECK(analyzer.GetResult().State == Status::Unknown);
+}
+
+static void Recommendations()
+{
+    CHECK(RecommendedPhases(1.5f) == 18);
+    CHECK(RecommendedPhases(2.0f) == 32);
+    CHECK(RecommendedPhases(3.0f) == 72);
+    CHECK(RecommendedPhases(0.5f) == 8);
+
+    Result result;
+    result.State = Status::Periodic;
+
+    // 8 phases resolve none of the -1 bias of a 2x upscale, 16 half of it, 32 all of it
+    result.Period = 8;
+    CHECK(RecommendedMipBias(result, 1280.0f, 2560.0f) == 0.0f);
+    result.Period = 16;
+    CHECK(std::fabs(RecommendedMipBias(result, 1280.0f, 2560.0f) + 0.5f) < 1e-6f);
+    result.Period = 32;
+    CHECK(std::fabs(RecommendedMipBias(result, 1280.0f, 2560.0f) + 1.0f) < 1e-6f);
+
+    result.State = Status::Aperiodic;
+    CHECK(std::fabs(RecommendedMipBias(result, 1280.0f, 2560.0f) + 1.0f) < 1e-6f);
+
+    result.State = Status::Absent;
+    CHECK(RecommendedMipBias(result, 1280.0f, 2560.0f) == 0.0f);
+
+    // Native resolution
+    result.State = Status::Periodic;
+    CHECK(RecommendedMipBias(result, 2560.0f, 2560.0f) == 0.0f);
+}
+
+int main()
+{
+    DetectsHalton();
+    DetectsR2();
+    DetectsCustomSequence();
+    Aperiodic();
+    AbsentAndBroken();
+    FollowsSequenceChange();
+    Recommendations();
+
+    return TestResult();
+}
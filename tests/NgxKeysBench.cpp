@@ -0,0 +1,157 @@
+// NVNGX_ParameterKeys.h, the parameter reads of an Evaluate call.
+// Locked map with std::string keys is how NVNGX_Parameters stored every parameter before the fixed slots.
+
+#include "Bench.h"
+
+#include <nvsdk_ngx_defs.h>
+#include <NVNGX_ParameterKeys.h>
+
+#include <array>
+#include <atomic>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+// Reads of a DLSS Evaluate: inputs, jitter, MV scale, sizes, subrect, FSR extras and one game specific key
+static const char* EvaluateKeys[] = {
+    NVSDK_NGX_Parameter_Color,
+    NVSDK_NGX_Parameter_Output,
+    NVSDK_NGX_Parameter_Depth,
+    NVSDK_NGX_Parameter_MotionVectors,
+    NVSDK_NGX_Parameter_ExposureTexture,
+    NVSDK_NGX_Parameter_DLSS_Input_Bias_Current_Color_Mask,
+    NVSDK_NGX_Parameter_TransparencyMask,
+    NVSDK_NGX_Parameter_Jitter_Offset_X,
+    NVSDK_NGX_Parameter_Jitter_Offset_Y,
+    NVSDK_NGX_Parameter_MV_Scale_X,
+    NVSDK_NGX_Parameter_MV_Scale_Y,
+    NVSDK_NGX_Parameter_Sharpness,
+    NVSDK_NGX_Parameter_Reset,
+    NVSDK_NGX_Parameter_Width,
+    NVSDK_NGX_Parameter_Height,
+    NVSDK_NGX_Parameter_OutWidth,
+    NVSDK_NGX_Parameter_OutHeight,
+    NVSDK_NGX_Parameter_DLSS_Render_Subrect_Dimensions_Width,
+    NVSDK_NGX_Parameter_DLSS_Render_Subrect_Dimensions_Height,
+    NVSDK_NGX_Parameter_DLSS_Input_Color_Subrect_Base_X,
+    NVSDK_NGX_Parameter_DLSS_Input_Color_Subrect_Base_Y,
+    NVSDK_NGX_Parameter_DLSS_Pre_Exposure,
+    NVSDK_NGX_Parameter_DLSS_Exposure_Scale,
+    NVSDK_NGX_Parameter_FrameTimeDeltaInMsec,
+    "FSR.cameraNear",
+    "FSR.cameraFar",
+    "FSR.cameraFovAngleVertical",
+    "FSR.upscaleSize.width",
+    "FSR.upscaleSize.height",
+    "Game.Custom.Parameter",
+};
+
+class LockedMap
+{
+    std::mutex _mutex;
+    std::unordered_map<std::string, uint64_t> _values;
+
+  public:
+    void Set(const char* key, uint64_t value)
+    {
+        std::scoped_lock lock(_mutex);
+        _values[key] = value;
+    }
+
+    bool Get(const char* key, uint64_t& value)
+    {
+        std::scoped_lock lock(_mutex);
+
+        if (auto it = _values.find(key); it != _values.end())
+        {
+            value = it->second;
+            return true;
+        }
+
+        return false;
+    }
+};
+
+// Fixed slots for known keys, the map only for unknown ones
+class FixedSlots
+{
+    struct Slot
+    {
+        std::atomic<bool> Set { false };
+        std::atomic<uint64_t> Value { 0 };
+    };
+
+    std::array<Slot, ngx_keys::KeyCount> _slots;
+    LockedMap _unknown;
+
+  public:
+    void Set(const char* key, uint64_t value)
+    {
+        if (auto index = ngx_keys::Find(key); index >= 0)
+        {
+            _slots[index].Value.store(value, std::memory_order_relaxed);
+            _slots[index].Set.store(true, std::memory_order_release);
+            return;
+        }
+
+        _unknown.Set(key, value);
+    }
+
+    bool Get(const char* key, uint64_t& value)
+    {
+        if (auto index = ngx_keys::Find(key); index >= 0)
+        {
+            if (!_slots[index].Set.load(std::memory_order_acquire))
+                return false;
+
+            value = _slots[index].Value.load(std::memory_order_relaxed);
+            return true;
+        }
+
+        return _unknown.Get(key, value);
+    }
+};
+
+template <typename Parameters> static double EvaluateNs(uint64_t evaluates)
+{
+    Parameters parameters;
+
+    // Everything but the jitter is set, so some reads miss like they do in games
+    for (size_t i = 0; i < std::size(EvaluateKeys); i++)
+    {
+        if (i != 7 && i != 8)
+            parameters.Set(EvaluateKeys[i], i);
+    }
+
+    return NsPerOp(evaluates,
+                   [&]
+                   {
+                       uint64_t sum = 0;
+
+                       for (uint64_t e = 0; e < evaluates; e++)
+                       {
+                           for (auto key : EvaluateKeys)
+                           {
+                               uint64_t value = 0;
+
+                               if (parameters.Get(key, value))
+                                   sum += value;
+                           }
+                       }
+
+                       KeepValue(sum);
+                   });
+}
+
+int main(int argc, char** argv)
+{
+    auto quick = QuickRun(argc, argv);
+    const uint64_t evaluates = quick ? 100 : 200'000;
+
+    std::printf("%zu reads per Evaluate\n", std::size(EvaluateKeys));
+    std::printf("%20s %16s\n", "parameters", "ns/Evaluate");
+    std::printf("%20s %16.1f\n", "fixed slots", EvaluateNs<FixedSlots>(evaluates));
+    std::printf("%20s %16.1f\n", "locked string map", EvaluateNs<LockedMap>(evaluates));
+
+    return 0;
+}
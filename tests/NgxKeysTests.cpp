@@ -0,0 +1,108 @@
+// NVNGX_ParameterKeys.h, every key define of the NGX SDK resolves to its slot and unknown keys don't
+
+#include "Check.h"
+
+#include <nvsdk_ngx_defs.h>
+#include <NVNGX_ParameterKeys.h>
+
+#include <string>
+#include <vector>
+
+// Generated by CMake from nvsdk_ngx_defs.h
+static const char* SdkKeys[] = {
+#include "NgxSdkKeys.inc"
+};
+
+static int LinearFind(std::string_view key)
+{
+    for (size_t i = 0; i < ngx_keys::KeyCount; i++)
+    {
+        if (ngx_keys::KnownKeys[i] == key)
+            return (int) i;
+    }
+
+    return -1;
+}
+
+static void KnownKeysResolve()
+{
+    for (size_t i = 0; i < ngx_keys::KeyCount; i++)
+    {
+        std::string key(ngx_keys::KnownKeys[i]);
+        CHECK(ngx_keys::Find(key.c_str()) == (int) i);
+    }
+
+    // Every slot holds one key at most and the table uses all of them
+    size_t used = 0;
+
+    for (auto index : ngx_keys::detail::Table.keyIndex)
+    {
+        if (index >= 0)
+            used++;
+    }
+
+    CHECK(used == ngx_keys::KeyCount);
+    CHECK(ngx_keys::detail::Table.steps <= ngx_keys::detail::MaxBuildSteps);
+}
+
+static void SdkKeysResolve()
+{
+    CHECK(std::size(SdkKeys) > 250);
+
+    for (auto key : SdkKeys)
+    {
+        auto index = ngx_keys::Find(key);
+        CHECK(index >= 0);
+
+        if (index >= 0)
+            CHECK(ngx_keys::KnownKeys[index] == key);
+    }
+}
+
+static void UnknownKeys()
+{
+    CHECK(ngx_keys::Find(nullptr) == -1);
+    CHECK(ngx_keys::Find("") == -1);
+    CHECK(ngx_keys::Find("Some.Game.Key") == -1);
+    CHECK(ngx_keys::Find("width") == -1);
+    CHECK(ngx_keys::Find("DLSSG.depth") == -1);
+
+    // Prefixes, extensions and one changed character of every known key, some of these are other known keys
+    size_t unknown = 0;
+
+    for (auto known : ngx_keys::KnownKeys)
+    {
+        std::string key(known);
+        std::vector<std::string> variants { key + "_", key + ".X" };
+
+        if (key.size() > 1)
+            variants.push_back(key.substr(0, key.size() - 1));
+
+        for (size_t c = 0; c < key.size(); c++)
+        {
+            variants.push_back(key);
+            variants.back()[c] ^= 0x20;
+
+            if (variants.back()[c] == 0)
+                variants.pop_back();
+        }
+
+        for (auto& variant : variants)
+        {
+            auto index = ngx_keys::Find(variant.c_str());
+            CHECK(index == LinearFind(variant));
+            unknown += index == -1;
+        }
+    }
+
+    CHECK(unknown > ngx_keys::KeyCount * 10);
+}
+
+int main()
+{
+    KnownKeysResolve();
+    SdkKeysResolve();
+    UnknownKeys();
+
+    return TestResult();
+}
@@ -0,0 +1,80 @@
+// scanner/Pattern.h, throughput of the search kernels and of the multi pattern scan over a synthetic code section
+
+#include "Bench.h"
+#include "SyntheticCode.h"
+
+#include <scanner/Pattern.h>
+
+using namespace scanner;
+
+int main(int argc, char** argv)
+{
+    auto quick = QuickRun(argc, argv);
+    const size_t size = quick ? (1 << 20) : (128 << 20);
+
+    // Signatures are not in the data, every search walks the whole section like a miss in a game update
+    auto data = SyntheticCode(size, 1);
+    auto& signatures = RealisticSignatures();
+
+    std::vector<Pattern> patterns;
+
+    for (auto& signature : signatures)
+        patterns.push_back(Pattern(signature));
+
+    auto count = [&](const Pattern& pattern) { return data.size() - pattern.Size() + 1; };
+    auto gbPerSecond = [&](double nsPerByte) { return 1.0 / nsPerByte; };
+
+    std::printf("%-12s %10s\n", "kernel", "GB/s");
+
+    auto scalar = NsPerOp(size * patterns.size(),
+                          [&]
+                          {
+                              for (auto& pattern : patterns)
+                                  KeepValue(detail::FindScalar(data.data(), count(pattern), pattern));
+                          });
+    std::printf("%-12s %10.2f\n", "scalar", gbPerSecond(scalar));
+
+    auto sse2 = NsPerOp(size * patterns.size(),
+                        [&]
+                        {
+                            for (auto& pattern : patterns)
+                                KeepValue(detail::FindSSE2(data.data(), count(pattern), pattern));
+                        });
+    std::printf("%-12s %10.2f\n", "sse2", gbPerSecond(sse2));
+
+    if (detail::HasAVX2())
+    {
+        auto avx2 = NsPerOp(size * patterns.size(),
+                            [&]
+                            {
+                                for (auto& pattern : patterns)
+                                    KeepValue(detail::FindAVX2(data.data(), count(pattern), pattern));
+                            });
+        std::printf("%-12s %10.2f\n", "avx2", gbPerSecond(avx2));
+    }
+
+    // All patterns in one pass against a pass per pattern, as section time (ms)
+    std::vector<const Pattern*> pointers;
+
+    for (auto& pattern : patterns)
+        pointers.push_back(&pattern);
+
+    auto separate = NsPerOp(1,
+                            [&]
+                            {
+                                for (auto& pattern : patterns)
+                                    KeepValue(FindPattern(data, pattern));
+                            });
+
+    auto combined = NsPerOp(1,
+                            [&]
+                            {
+                                std::vector<const uint8_t*> results(patterns.size());
+                                KeepValue(FindPatterns(data, pointers, results));
+                            });
+
+    std::printf("\n%zu patterns over %zu MB: %.1f ms separate, %.1f ms single pass\n", patterns.size(), size >> 20,
+                separate / 1e6, combined / 1e6);
+
+    return 0;
+}
@@ -0,0 +1,208 @@
+// scanner/Pattern.h, SIMD and block wise searches compared with a naive search over synthetic code sections
+
+#include "Check.h"
+#include "SyntheticCode.h"
+
+#include <scanner/Pattern.h>
+
+using namespace scanner;
+
+static size_t NaiveFind(std::span<const uint8_t> data, const Pattern& pattern)
+{
+    if (!pattern.IsValid() || data.size() < pattern.Size())
+        return SIZE_MAX;
+
+    for (size_t i = 0; i + pattern.Size() <= data.size(); i++)
+    {
+        if (pattern.MatchAt(data.data() + i))
+            return i;
+    }
+
+    return SIZE_MAX;
+}
+
+static size_t Offset(std::span<const uint8_t> data, const uint8_t* match)
+{
+    return match == nullptr ? SIZE_MAX : (size_t) (match - data.data());
+}
+
+static void Parsing()
+{
+    Pattern pattern("48 8B ? ?? 89");
+    CHECK(pattern.IsValid() && pattern.Size() == 5);
+
+    uint8_t data[] = { 0x48, 0x8B, 0x11, 0x22, 0x89 };
+    CHECK(pattern.MatchAt(data));
+    data[4] = 0x88;
+    CHECK(!pattern.MatchAt(data));
+
+    // Anchors are two different fixed bytes, never wildcards
+    CHECK(pattern.Anchor() != 2 && pattern.Anchor() != 3);
+    CHECK(pattern.SecondAnchor() != pattern.Anchor() && pattern.SecondAnchor() != 2 && pattern.SecondAnchor() != 3);
+
+    CHECK(!Pattern("48 8G").IsValid());
+    CHECK(!Pattern("48 8").IsValid());
+    CHECK(!Pattern("? ??").IsValid());
+    CHECK(!Pattern("").IsValid());
+
+    // Wildcards are part of the hash
+    CHECK(Pattern("48 ? 89").Hash() != Pattern("48 00 89").Hash());
+    CHECK(Pattern("48 ? 89").Hash() == Pattern("48 ?? 89").Hash());
+}
+
+static std::string RandomMask(std::mt19937& rng, size_t size)
+{
+    std::string mask;
+    char hex[4];
+
+    for (size_t i = 0; i < size; i++)
+    {
+        if (rng() % 4 == 0 && i != 0)
+            mask += "? ";
+        else
+        {
+            std::snprintf(hex, sizeof(hex), "%02X ", (unsigned) (rng() % 256));
+            mask += hex;
+        }
+    }
+
+    return mask;
+}
+
+// Every implementation against the naive search, with and without a planted match and at all tail lengths
+static void KernelsMatchNaive()
+{
+    std::mt19937 rng(7);
+    uint32_t wrong = 0;
+
+    for (uint32_t n = 0; n < 4000; n++)
+    {
+        auto mask = RandomMask(rng, 1 + rng() % 24);
+        Pattern pattern(mask);
+
+        if (!pattern.IsValid())
+            continue;
+
+        auto data = SyntheticCode(pattern.Size() + rng() % 300, n);
+
+        if (rng() % 2 == 0)
+            Plant(data, rng() % (data.size() - pattern.Size() + 1), mask, n);
+
+        auto expected = NaiveFind(data, pattern);
+        auto count = data.size() - pattern.Size() + 1;
+
+        if (detail::FindScalar(data.data(), count, pattern) != expected)
+            wrong++;
+
+        if (detail::FindSSE2(data.data(), count, pattern) != expected)
+            wrong++;
+
+        if (detail::HasAVX2() && detail::FindAVX2(data.data(), count, pattern) != expected)
+            wrong++;
+
+        if (Offset(data, FindPattern(data, pattern)) != expected)
+            wrong++;
+    }
+
+    CHECK(wrong == 0);
+}
+
+// Matches straddling the 16 KB blocks of FindPatterns must be found, and the first one of each pattern wins
+static void BlocksCarryOver()
+{
+    constexpr size_t Block = 16 * 1024;
+
+    auto& signatures = RealisticSignatures();
+    std::vector<Pattern> patterns;
+
+    for (auto& signature : signatures)
+        patterns.push_back(Pattern(signature));
+
+    std::vector<const Pattern*> pointers;
+
+    for (auto& pattern : patterns)
+        pointers.push_back(&pattern);
+
+    std::mt19937 rng(11);
+    uint32_t wrong = 0;
+
+    for (uint32_t n = 0; n < 200; n++)
+    {
+        auto data = SyntheticCode(3 * Block + rng() % Block, 100 + n);
+
+        for (size_t p = 0; p < signatures.size(); p++)
+        {
+            // Across a border, at the very end and somewhere, some patterns are left out
+            auto size = patterns[p].Size();
+            auto border = Block * (1 + rng() % 3);
+
+            if (rng() % 3 == 0)
+                Plant(data, border - 1 - rng() % (size - 1), signatures[p], n);
+
+            if (rng() % 4 == 0)
+                Plant(data, data.size() - size, signatures[p], n);
+
+            if (rng() % 3 == 0)
+                Plant(data, rng() % (data.size() - size), signatures[p], n);
+        }
+
+        std::vector<const uint8_t*> results(patterns.size());
+        auto found = FindPatterns(data, pointers, results);
+
+        size_t expectedFound = 0;
+
+        for (size_t p = 0; p < patterns.size(); p++)
+        {
+            auto expected = NaiveFind(data, patterns[p]);
+
+            if (expected != SIZE_MAX)
+                expectedFound++;
+
+            if (Offset(data, results[p]) != expected)
+                wrong++;
+        }
+
+        if (found != expectedFound)
+            wrong++;
+    }
+
+    CHECK(wrong == 0);
+}
+
+static void FindPatternsInputs()
+{
+    auto data = SyntheticCode(40000, 3);
+    Plant(data, 20000, "83 F9 05 0F 87", 0);
+
+    Pattern present("83 F9 05 0F 87");
+    Pattern invalid("zz");
+    std::mt19937 rng(1);
+    Pattern tooLong(RandomMask(rng, 64));
+
+    std::vector<const Pattern*> patterns { &present, nullptr, &invalid };
+    std::vector<const uint8_t*> results(3);
+
+    CHECK(FindPatterns(data, patterns, results) == 1);
+    CHECK(results[0] != nullptr && results[1] == nullptr && results[2] == nullptr);
+
+    // Already found patterns are skipped and not counted again
+    uint8_t marker = 0;
+    results[0] = &marker;
+    CHECK(FindPatterns(data, patterns, results) == 0 && results[0] == &marker);
+
+    // Pattern longer than the data
+    std::vector<const Pattern*> longOnly { &tooLong };
+    std::vector<const uint8_t*> longResult(1);
+    CHECK(FindPatterns(std::span(data).first(10), longOnly, longResult) == 0 && longResult[0] == nullptr);
+    CHECK(FindPattern(std::span(data).first(10), tooLong) == nullptr);
+}
+
+int main()
+{
+    Parsing();
+    KernelsMatchNaive();
+    BlocksCarryOver();
+    FindPatternsInputs();
+
+    return TestResult();
+}
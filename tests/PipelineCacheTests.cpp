@@ -0,0 +1,174 @@
+// upscalers/xess/PipelineCache.h, file format validation, eviction choice and the on disk store
+
+#include "Check.h"
+
+#include <upscalers/xess/PipelineCache.h>
+
+#include <chrono>
+#include <thread>
+
+using namespace pipeline_cache;
+namespace fs = std::filesystem;
+
+static const Key TestKey { 0x8086, 0x56a0, 1, 8, 0x1f0000001234, PackVersion(2, 0, 1) };
+
+static std::vector<uint8_t> Blob(size_t size, uint8_t seed)
+{
+    std::vector<uint8_t> blob(size);
+
+    for (size_t i = 0; i < size; i++)
+        blob[i] = (uint8_t) (i * 31 + seed);
+
+    return blob;
+}
+
+static void FileFormat()
+{
+    auto blob = Blob(100000, 3);
+    auto data = Serialize(TestKey, blob);
+    std::vector<uint8_t> out;
+
+    CHECK(Deserialize(data, TestKey, out) == LoadStatus::Loaded && out == blob);
+
+    // New driver
+    auto newDriver = TestKey;
+    newDriver.DriverVersion++;
+    CHECK(Deserialize(data, newDriver, out) == LoadStatus::KeyMismatch && out.empty());
+    CHECK(FileName(TestKey) != FileName(newDriver));
+
+    auto broken = data;
+    broken[sizeof(FileHeader) + 500] ^= 1;
+    CHECK(Deserialize(broken, TestKey, out) == LoadStatus::Corrupt);
+
+    broken = data;
+    broken[offsetof(FileHeader, PayloadSize)] ^= 1;
+    CHECK(Deserialize(broken, TestKey, out) == LoadStatus::Corrupt);
+
+    CHECK(Deserialize(std::span(data).first(data.size() - 1), TestKey, out) == LoadStatus::Invalid);
+    CHECK(Deserialize(std::span(data).first(10), TestKey, out) == LoadStatus::Invalid);
+
+    // Valid header of an older layout
+    broken = data;
+    FileHeader header;
+    std::memcpy(&header, broken.data(), sizeof(header));
+    header.Version = 0;
+    header.HeaderHash = HashHeader(header);
+    std::memcpy(broken.data(), &header, sizeof(header));
+    CHECK(Deserialize(broken, TestKey, out) == LoadStatus::OldFormat);
+
+    broken = data;
+    broken[0] = 'X';
+    CHECK(Deserialize(broken, TestKey, out) == LoadStatus::Invalid);
+}
+
+static FileInfo OtherGpu(uint32_t deviceId, int64_t lastUse, uint64_t size)
+{
+    FileInfo file;
+    file.Valid = true;
+    file.CacheKey = TestKey;
+    file.CacheKey.DeviceId = deviceId;
+    file.LastUse = lastUse;
+    file.Size = size;
+    return file;
+}
+
+static void EvictionChoice()
+{
+    std::vector<FileInfo> files;
+
+    // Current file
+    files.push_back(OtherGpu(TestKey.DeviceId, 100, 10));
+
+    FileInfo invalid;
+    invalid.Size = 5;
+    files.push_back(invalid);
+
+    // Same GPU, older library
+    auto superseded = OtherGpu(TestKey.DeviceId, 200, 10);
+    superseded.CacheKey.LibraryVersion = PackVersion(1, 3, 0);
+    files.push_back(superseded);
+
+    for (uint32_t i = 0; i < 10; i++)
+        files.push_back(OtherGpu(1000 + i, 10 + i, 10));
+
+    // Invalid and superseded go first, then the 3 least recently used of the other GPUs
+    auto evictions = SelectEvictions(files, TestKey, 8, 1 << 30);
+    CHECK(evictions == std::vector<size_t>({ 1, 2, 3, 4, 5 }));
+
+    // 110 bytes down to 60
+    evictions = SelectEvictions(files, TestKey, 100, 60);
+    CHECK(evictions.size() == 7);
+
+    // Current file is never evicted
+    evictions = SelectEvictions(files, TestKey, 0, 0);
+    CHECK(evictions.size() == files.size() - 1);
+    CHECK(std::find(evictions.begin(), evictions.end(), 0) == evictions.end());
+}
+
+static void DiskStore()
+{
+    auto dir = fs::temp_directory_path() / "opti_pipeline_cache_test";
+    fs::remove_all(dir);
+
+    auto blob = Blob(100000, 3);
+    std::vector<uint8_t> out;
+
+    auto newDriver = TestKey;
+    newDriver.DriverVersion++;
+
+    Store store(dir);
+    CHECK(store.Load(TestKey, out) == LoadStatus::Missing);
+    CHECK(store.Save(TestKey, blob));
+    CHECK(store.Load(TestKey, out) == LoadStatus::Loaded && out == blob);
+    CHECK(store.Load(newDriver, out) == LoadStatus::Missing);
+
+    // Corrupt file is deleted
+    {
+        std::fstream file(store.PathOf(TestKey), std::ios::in | std::ios::out | std::ios::binary);
+        file.seekp(sizeof(FileHeader) + 10);
+        file.put(0x55);
+    }
+
+    CHECK(store.Load(TestKey, out) == LoadStatus::Corrupt && !fs::exists(store.PathOf(TestKey)));
+
+    // Driver update, file of the old driver goes on the next save
+    CHECK(store.Save(TestKey, blob));
+    CHECK(store.Save(newDriver, Blob(1000, 1)));
+    CHECK(!fs::exists(store.PathOf(TestKey)) && fs::exists(store.PathOf(newDriver)));
+
+    // Files of other GPUs, least recently used go over the limit
+    for (uint32_t device = 0; device < 12; device++)
+    {
+        auto key = newDriver;
+        key.DeviceId = device;
+        CHECK(store.Save(key, Blob(100, (uint8_t) device)));
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    }
+
+    size_t fileCount = 0;
+
+    for (auto& entry : fs::directory_iterator(dir))
+    {
+        (void) entry;
+        fileCount++;
+    }
+
+    CHECK(fileCount == MaxFiles);
+
+    auto newest = newDriver;
+    newest.DeviceId = 11;
+    auto oldest = newDriver;
+    oldest.DeviceId = 3;
+    CHECK(fs::exists(store.PathOf(newest)) && !fs::exists(store.PathOf(oldest)));
+
+    fs::remove_all(dir);
+}
+
+int main()
+{
+    FileFormat();
+    EvictionChoice();
+    DiskStore();
+
+    return TestResult();
+}
@@ -0,0 +1,316 @@
+// shaders/PipelineManager.h with a mock device, deduplication, ownership and the prewarm worker
+
+#include "Check.h"
+
+#include <shaders/PipelineManager.h>
+
+#include <set>
+
+using namespace pipeline_manager;
+
+struct MockDevice
+{
+    std::mutex Mutex;
+    std::set<uint64_t> Alive;
+    uint64_t Next = 1;
+    uint32_t SignatureCreates = 0;
+    uint32_t PipelineCreates = 0;
+
+    // Released twice, unknown or with a released signature
+    uint32_t Misuse = 0;
+
+    bool FailSignatures = false;
+
+    uint64_t New()
+    {
+        std::lock_guard lock(Mutex);
+        auto handle = Next++;
+        Alive.insert(handle);
+        return handle;
+    }
+};
+
+class MockBackend : public Backend
+{
+    MockDevice& _device;
+
+  public:
+    explicit MockBackend(MockDevice& device) : _device(device) {}
+
+    uint64_t CreateSignature(std::span<const uint8_t>) override
+    {
+        {
+            std::lock_guard lock(_device.Mutex);
+            _device.SignatureCreates++;
+
+            if (_device.FailSignatures)
+                return 0;
+        }
+
+        return _device.New();
+    }
+
+    void Release(uint64_t handle) override
+    {
+        std::lock_guard lock(_device.Mutex);
+
+        if (_device.Alive.erase(handle) != 1)
+            _device.Misuse++;
+    }
+};
+
+static CreateFunc Pipeline(MockDevice& device)
+{
+    return [&device](uint64_t signature)
+    {
+        {
+            std::lock_guard lock(device.Mutex);
+
+            if (signature == 0 || !device.Alive.contains(signature))
+                device.Misuse++;
+
+            device.PipelineCreates++;
+        }
+
+        return device.New();
+    };
+}
+
+// Create function which blocks until opened, keeps the worker busy for as long as the test needs
+class Gate
+{
+    std::mutex _mutex;
+    std::condition_variable _changed;
+    bool _entered = false;
+    bool _open = false;
+
+  public:
+    CreateFunc Wrap(CreateFunc create)
+    {
+        return [this, create](uint64_t signature)
+        {
+            std::unique_lock lock(_mutex);
+            _entered = true;
+            _changed.notify_all();
+            _changed.wait(lock, [this] { return _open; });
+            lock.unlock();
+
+            return create(signature);
+        };
+    }
+
+    void WaitEntered()
+    {
+        std::unique_lock lock(_mutex);
+        _changed.wait(lock, [this] { return _entered; });
+    }
+
+    void Open()
+    {
+        std::lock_guard lock(_mutex);
+        _open = true;
+        _changed.notify_all();
+    }
+};
+
+static const std::vector<uint8_t> BlobA { 1, 2, 3 };
+static const std::vector<uint8_t> BlobB { 4, 5, 6 };
+
+static void DeduplicatesAndOwns()
+{
+    MockDevice device;
+
+    {
+        Manager manager(std::make_unique<MockBackend>(device));
+
+        auto a1 = manager.AcquireSignature(BlobA);
+        auto a2 = manager.AcquireSignature(BlobA);
+        auto b = manager.AcquireSignature(BlobB);
+        CHECK(a1 == a2 && a1 != b && device.SignatureCreates == 2);
+
+        auto p1 = manager.Acquire(100, SignatureKey(BlobA), Pipeline(device));
+        auto p2 = manager.Acquire(100, SignatureKey(BlobA), Pipeline(device));
+        CHECK(p1 != 0 && p1 == p2 && device.PipelineCreates == 1);
+
+        auto stats = manager.GetStats();
+        CHECK(stats.Signatures == 2 && stats.SignatureHits == 1);
+        CHECK(stats.Pipelines == 1 && stats.PipelineHits == 1 && stats.BuiltInline == 1);
+    }
+
+    // Everything released once with the manager
+    CHECK(device.Alive.empty() && device.Misuse == 0);
+}
+
+static void PrewarmsOnWorker()
+{
+    MockDevice device;
+    Manager manager(std::make_unique<MockBackend>(device));
+
+    // Signatures are only created when a pipeline needs them
+    auto a = manager.AddSignature(BlobA);
+    auto b = manager.AddSignature(BlobB);
+    CHECK(device.SignatureCreates == 0);
+
+    for (uint64_t key = 1; key <= 8; key++)
+        manager.Prewarm(key, key % 2 ? a : b, Pipeline(device));
+
+    manager.WaitIdle();
+    CHECK(device.SignatureCreates == 2 && device.PipelineCreates == 8);
+
+    for (uint64_t key = 1; key <= 8; key++)
+        CHECK(manager.Acquire(key, 0, nullptr) != 0);
+
+    auto stats = manager.GetStats();
+    CHECK(stats.Prewarmed == 8 && stats.PipelineHits == 8 && stats.BuiltInline == 0);
+    CHECK(device.Misuse == 0);
+}
+
+// Acquire builds a queued pipeline itself and waits for one the worker is building
+static void AcquireClaimsOrWaits()
+{
+    MockDevice device;
+    Manager manager(std::make_unique<MockBackend>(device));
+    auto a = manager.AddSignature(BlobA);
+
+    Gate gate;
+    manager.Prewarm(1, a, gate.Wrap(Pipeline(device)));
+    gate.WaitEntered();
+    CHECK(manager.GetStatus(1) == Status::Building);
+
+    for (uint64_t key = 2; key <= 5; key++)
+        manager.Prewarm(key, a, Pipeline(device));
+
+    // Worker is still blocked, so this can only return by building inline
+    CHECK(manager.Acquire(5, a, nullptr) != 0);
+    CHECK(manager.GetStats().BuiltInline == 1);
+
+    std::thread opener(
+        [&]
+        {
+            while (manager.GetStats().Waited == 0)
+                std::this_thread::yield();
+
+            gate.Open();
+        });
+
+    CHECK(manager.Acquire(1, a, nullptr) != 0);
+    opener.join();
+    manager.WaitIdle();
+
+    auto stats = manager.GetStats();
+    CHECK(stats.BuiltInline == 1 && stats.Waited == 1 && stats.Prewarmed == 4);
+    CHECK(device.PipelineCreates == 5);
+}
+
+static void TryGetMovesToFront()
+{
+    MockDevice device;
+    Manager manager(std::make_unique<MockBackend>(device));
+    auto a = manager.AddSignature(BlobA);
+
+    std::mutex orderMutex;
+    std::vector<uint64_t> order;
+
+    auto recording = [&](uint64_t key)
+    {
+        return [&, key](uint64_t)
+        {
+            {
+                std::lock_guard lock(orderMutex);
+                order.push_back(key);
+            }
+
+            return device.New();
+        };
+    };
+
+    Gate gate;
+    manager.Prewarm(1, a, gate.Wrap(recording(1)));
+    gate.WaitEntered();
+
+    for (uint64_t key = 2; key <= 6; key++)
+        manager.Prewarm(key, a, recording(key));
+
+    CHECK(manager.TryGet(6) == 0);
+    CHECK(manager.TryGet(99) == 0);
+
+    gate.Open();
+    manager.WaitIdle();
+
+    CHECK(manager.TryGet(6) != 0);
+    CHECK(order == std::vector<uint64_t>({ 1, 6, 2, 3, 4, 5 }));
+}
+
+// Pipelines of a failed root signature fail without calling their create function
+static void FailedSignatureFailsPipelines()
+{
+    MockDevice device;
+    device.FailSignatures = true;
+
+    Manager manager(std::make_unique<MockBackend>(device));
+    auto a = manager.AddSignature(BlobA);
+
+    manager.Prewarm(1, a, Pipeline(device));
+    manager.Prewarm(2, a, Pipeline(device));
+    manager.WaitIdle();
+
+    CHECK(manager.GetStatus(1) == Status::Failed);
+    CHECK(manager.Acquire(2, a, nullptr) == 0);
+    CHECK(device.PipelineCreates == 0 && device.SignatureCreates == 1);
+    CHECK(manager.GetStats().Failed == 2);
+}
+
+// Threads acquiring in different orders while the worker prewarms, every pipeline is built once
+static void ConcurrentAcquire()
+{
+    MockDevice device;
+
+    {
+        Manager manager(std::make_unique<MockBackend>(device));
+        auto a = manager.AddSignature(BlobA);
+
+        for (uint64_t key = 1; key <= 64; key++)
+            manager.Prewarm(key, a, Pipeline(device));
+
+        std::atomic<uint32_t> failed { 0 };
+        std::vector<std::thread> threads;
+
+        for (uint64_t t = 0; t < 8; t++)
+        {
+            threads.emplace_back(
+                [&, t]
+                {
+                    for (uint64_t key = 64; key >= 1; key--)
+                    {
+                        if (manager.Acquire((key + t * 7) % 64 + 1, a, nullptr) == 0)
+                            failed++;
+                    }
+                });
+        }
+
+        for (auto& thread : threads)
+            thread.join();
+
+        CHECK(failed.load() == 0);
+        CHECK(device.PipelineCreates == 64);
+
+        // Stopped manager still builds on Acquire
+        manager.Stop();
+        manager.Prewarm(100, a, Pipeline(device));
+        CHECK(manager.Acquire(100, a, Pipeline(device)) != 0);
+    }
+
+    CHECK(device.Alive.empty() && device.Misuse == 0);
+}
+
+int main()
+{
+    DeduplicatesAndOwns();
+    PrewarmsOnWorker();
+    AcquireClaimsOrWaits();
+    TryGetMovesToFront();
+    FailedSignatureFailsPipelines();
+    ConcurrentAcquire();
+
+    return TestResult();
+}
@@ -0,0 +1,117 @@
+// misc/PrecisionWait.h, wake up error and spin time of timer plus spin waits with clock_nanosleep.
+// Fixed 2 ms spin margin is what the frame limiter used before the margin was learned from the overshoots.
+
+#include "Bench.h"
+
+#include <misc/PrecisionWait.h>
+
+#include <algorithm>
+#include <time.h>
+
+class LinuxClock
+{
+  public:
+    uint64_t Now()
+    {
+        timespec time {};
+        clock_gettime(CLOCK_MONOTONIC, &time);
+        return (uint64_t) time.tv_sec * 1'000'000'000ULL + (uint64_t) time.tv_nsec;
+    }
+
+    int Sleep(int64_t ns)
+    {
+        timespec time { (time_t) (ns / 1'000'000'000), (long) (ns % 1'000'000'000) };
+        return clock_nanosleep(CLOCK_MONOTONIC, 0, &time, nullptr);
+    }
+
+    void Relax(uint64_t)
+    {
+#if defined(__x86_64__) || defined(__i386__)
+        __builtin_ia32_pause();
+#endif
+    }
+};
+
+struct Result
+{
+    double MeanErrorNs = 0.0;
+    int64_t MaxErrorNs = 0;
+    double MeanSpinNs = 0.0;
+};
+
+static Result FixedMargin(LinuxClock& clock, int64_t waitNs, int count)
+{
+    Result result;
+
+    for (int i = 0; i < count; i++)
+    {
+        auto start = clock.Now();
+        auto deadline = start + (uint64_t) waitNs;
+        auto timerNs = waitNs - precision_wait::DefaultMarginNs;
+
+        if (timerNs > 0)
+            clock.Sleep(timerNs);
+
+        auto spinStart = clock.Now();
+        auto now = spinStart;
+
+        while (now < deadline)
+        {
+            clock.Relax(deadline);
+            now = clock.Now();
+        }
+
+        auto error = (int64_t) (now - deadline);
+        result.MeanErrorNs += (double) error / count;
+        result.MaxErrorNs = std::max(result.MaxErrorNs, error);
+        result.MeanSpinNs += (double) (now - spinStart) / count;
+    }
+
+    return result;
+}
+
+static Result Calibrated(LinuxClock& clock, int64_t waitNs, int count)
+{
+    precision_wait::Calibrator calibrator;
+
+    // Margin is learned first, only the settled waits are measured
+    for (uint32_t i = 0; i < precision_wait::WarmupSamples * 2; i++)
+        precision_wait::WaitFor(clock, calibrator, waitNs);
+
+    calibrator.ResetStats();
+
+    for (int i = 0; i < count; i++)
+        precision_wait::WaitFor(clock, calibrator, waitNs);
+
+    auto stats = calibrator.GetStats();
+    std::printf("%24s %10.1f us\n", "final margin", stats.MarginNs / 1e3);
+
+    return { stats.MeanErrorNs, stats.MaxErrorNs, stats.MeanSpinNs };
+}
+
+static void Print(const char* name, const Result& result)
+{
+    std::printf("%24s %10.2f %10.2f %10.1f\n", name, result.MeanErrorNs / 1e3, result.MaxErrorNs / 1e3,
+                result.MeanSpinNs / 1e3);
+}
+
+int main(int argc, char** argv)
+{
+    auto quick = QuickRun(argc, argv);
+    const int count = quick ? 5 : 500;
+
+    LinuxClock clock;
+
+    for (int64_t waitNs : { 4'000'000LL, 8'000'000LL })
+    {
+        std::printf("%d waits of %.1f ms\n", count, waitNs / 1e6);
+
+        auto calibrated = Calibrated(clock, waitNs, count);
+
+        std::printf("%24s %10s %10s %10s\n", "", "mean us", "max us", "spin us");
+        Print("fixed 2 ms margin", FixedMargin(clock, waitNs, count));
+        Print("learned margin", calibrated);
+    }
+
+    return 0;
+}
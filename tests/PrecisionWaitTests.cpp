@@ -0,0 +1,192 @@
+// misc/PrecisionWait.h, margin learning and timer plus spin waits on a simulated clock
+
+#include "Check.h"
+
+#include <misc/PrecisionWait.h>
+
+#include <random>
+
+using namespace precision_wait;
+
+// Timer wakes up Overshoot late, a spin step takes SpinStepNs
+struct SimClock
+{
+    static constexpr uint64_t SpinStepNs = 500;
+
+    uint64_t Time = 1'000'000'000;
+    int64_t Overshoot = 300'000;
+    int Status = 0;
+    uint64_t Sleeps = 0;
+
+    uint64_t Now() { return Time; }
+
+    int Sleep(int64_t ns)
+    {
+        Sleeps++;
+
+        if (Status != 0)
+            return Status;
+
+        Time += (uint64_t) (ns + Overshoot);
+        return 0;
+    }
+
+    void Relax(uint64_t) { Time += SpinStepNs; }
+};
+
+static void Warmup()
+{
+    SimClock clock;
+    Calibrator calibrator;
+
+    // Old fixed margin until WarmupSamples timer waits are measured
+    for (uint32_t i = 1; i < WarmupSamples; i++)
+    {
+        WaitFor(clock, calibrator, 8'000'000);
+        CHECK(calibrator.Margin() == DefaultMarginNs);
+    }
+
+    WaitFor(clock, calibrator, 8'000'000);
+
+    // 300 us is in the 300 - 320 us bucket, its upper edge plus the safety
+    CHECK(calibrator.Margin() == 320'000 + SafetyNs);
+    CHECK(calibrator.GetStats().TimerWaits == WarmupSamples && calibrator.GetStats().Waits == WarmupSamples);
+    CHECK(calibrator.GetStats().MarginNs == calibrator.Margin());
+}
+
+static void Quantile()
+{
+    // 198 of 200 are under the p99, 2 slow wakes don't move the margin
+    Calibrator p99;
+
+    for (int i = 0; i < 198; i++)
+        p99.RecordOvershoot(100'000);
+
+    p99.RecordOvershoot(1'000'000);
+    p99.RecordOvershoot(1'000'000);
+    CHECK(p99.Margin() == 120'000 + SafetyNs);
+
+    // The third one is past it
+    p99.RecordOvershoot(1'000'000);
+    CHECK(p99.Margin() == 1'020'000 + SafetyNs);
+
+    // Negative overshoots count as on time
+    Calibrator early;
+
+    for (uint32_t i = 0; i < WarmupSamples; i++)
+        early.RecordOvershoot(i % 2 == 0 ? -50'000 : 50'000);
+
+    CHECK(early.Margin() == 60'000 + SafetyNs);
+}
+
+static void Clamp()
+{
+    // Exact timer, the margin doesn't go under MinMarginNs
+    Calibrator exact;
+
+    for (uint32_t i = 0; i < WarmupSamples; i++)
+        exact.RecordOvershoot(0);
+
+    CHECK(BucketNs + SafetyNs < MinMarginNs);
+    CHECK(exact.Margin() == MinMarginNs);
+
+    // Overshoots past the histogram go to MaxMarginNs
+    Calibrator coarse;
+
+    for (uint32_t i = 0; i < WarmupSamples; i++)
+        coarse.RecordOvershoot(15'600'000);
+
+    CHECK(coarse.Margin() == MaxMarginNs);
+
+    // Last bucket still counts by its edge
+    Calibrator last;
+
+    for (uint32_t i = 0; i < WarmupSamples; i++)
+        last.RecordOvershoot((int64_t) BucketCount * BucketNs - 1);
+
+    CHECK(last.Margin() == (int64_t) BucketCount * BucketNs + SafetyNs);
+}
+
+static void Decay()
+{
+    // Timer got better, e.g. after the timer resolution changed
+    Calibrator calibrator;
+
+    for (int i = 0; i < 300; i++)
+        calibrator.RecordOvershoot(1'000'000);
+
+    CHECK(calibrator.Margin() == 1'020'000 + SafetyNs);
+
+    for (uint32_t i = 0; i < DecaySamples * 8; i++)
+        calibrator.RecordOvershoot(100'000);
+
+    CHECK(calibrator.Margin() == 120'000 + SafetyNs);
+}
+
+static void Waits()
+{
+    SimClock clock;
+    Calibrator calibrator;
+    std::mt19937 rng(7);
+    std::uniform_int_distribution<int64_t> overshoot(200'000, 400'000);
+    std::uniform_int_distribution<int64_t> length(2'500'000, 16'000'000);
+
+    for (int i = 0; i < 2000; i++)
+    {
+        clock.Overshoot = overshoot(rng);
+
+        auto deadline = clock.Now() + (uint64_t) length(rng);
+        CHECK(WaitUntil(clock, calibrator, deadline) == 0);
+
+        // Never early, late by at most one spin step
+        CHECK(clock.Now() >= deadline && clock.Now() < deadline + SimClock::SpinStepNs);
+    }
+
+    auto stats = calibrator.GetStats();
+    CHECK(stats.Waits == 2000 && stats.TimerWaits == 2000);
+    CHECK(stats.MaxErrorNs < (int64_t) SimClock::SpinStepNs && stats.MeanErrorNs >= 0.0);
+    CHECK(stats.MeanOvershootNs > 280'000 && stats.MeanOvershootNs < 320'000);
+
+    // Margin ends at the worst overshoot plus the safety, spin is what is left of it
+    CHECK(stats.MarginNs == 400'000 + SafetyNs);
+    CHECK(stats.MeanSpinNs < 300'000 && stats.MeanSpinNs > 100'000);
+
+    calibrator.ResetStats();
+    CHECK(calibrator.GetStats().Waits == 0 && calibrator.GetStats().MarginNs == stats.MarginNs);
+}
+
+static void ShortAndFailedWaits()
+{
+    SimClock clock;
+    Calibrator calibrator;
+
+    // Nothing to wait
+    auto start = clock.Now();
+    CHECK(WaitFor(clock, calibrator, 0) == 0 && WaitFor(clock, calibrator, -5) == 0);
+    CHECK(WaitUntil(clock, calibrator, start - 1) == 0);
+    CHECK(clock.Now() == start && calibrator.GetStats().Waits == 0);
+
+    // Shorter than the margin, spin only
+    CHECK(WaitFor(clock, calibrator, 1'000'000) == 0);
+    CHECK(clock.Sleeps == 0 && clock.Now() >= start + 1'000'000);
+    CHECK(calibrator.GetStats().Waits == 1 && calibrator.GetStats().TimerWaits == 0);
+
+    // Failed timer is returned, not measured, and the wait is still finished by spinning
+    clock.Status = 22;
+    auto deadline = clock.Now() + 5'000'000;
+    CHECK(WaitUntil(clock, calibrator, deadline) == 22);
+    CHECK(clock.Sleeps == 1 && clock.Now() >= deadline);
+    CHECK(calibrator.GetStats().Waits == 2 && calibrator.GetStats().TimerWaits == 0);
+}
+
+int main()
+{
+    Warmup();
+    Quantile();
+    Clamp();
+    Decay();
+    Waits();
+    ShortAndFailedWaits();
+
+    return TestResult();
+}
@@ -0,0 +1,128 @@
+// resource_tracking/ResourceLinks.h, descriptor writes from 1 to 32 threads.
+// Global lock + map of vectors is what the tracking did before the sharded lists.
+
+#include "Bench.h"
+
+#include <resource_tracking/ResourceLinks.h>
+
+#include <algorithm>
+#include <memory>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+struct Resource
+{
+    int Id = 0;
+};
+
+struct Info
+{
+    Resource* buffer = nullptr;
+    uint64_t lastUsedFrame = 0;
+};
+
+using Link = resource_links::Link<Resource, Info>;
+using Links = resource_links::Map<Resource, Info, std::mutex, std::unordered_map<Resource*, Link*>>;
+
+struct GlobalMap
+{
+    std::mutex Mutex;
+    std::unordered_map<Resource*, std::vector<Info*>> Slots;
+
+    void Attach(Info* info, Resource* old, Resource* resource)
+    {
+        std::scoped_lock lock(Mutex);
+
+        if (old != nullptr)
+        {
+            auto& slots = Slots[old];
+            slots.erase(std::remove(slots.begin(), slots.end(), info), slots.end());
+        }
+
+        Slots[resource].push_back(info);
+    }
+};
+
+constexpr size_t SlotsPerThread = 1024;
+constexpr size_t ResourceCount = 4096;
+
+int main(int argc, char** argv)
+{
+    auto quick = QuickRun(argc, argv);
+    const uint64_t writes = quick ? 2000 : 400'000;
+
+    static Resource resources[ResourceCount];
+
+    std::printf("%8s %16s %16s\n", "threads", "sharded ns", "global lock ns");
+
+    for (size_t threadCount : { 1, 2, 4, 8, 16, 32 })
+    {
+        std::vector<std::unique_ptr<Link[]>> links;
+        std::vector<std::unique_ptr<Info[]>> infos;
+
+        for (size_t t = 0; t < threadCount; t++)
+        {
+            links.push_back(std::make_unique<Link[]>(SlotsPerThread));
+            infos.push_back(std::make_unique<Info[]>(SlotsPerThread));
+
+            for (size_t i = 0; i < SlotsPerThread; i++)
+                links[t][i].info = &infos[t][i];
+        }
+
+        // Every thread writes descriptors of random resources into its own heap slots
+        auto run = [&](auto write)
+        {
+            return NsPerOp(writes * threadCount,
+                           [&]
+                           {
+                               std::vector<std::thread> threads;
+
+                               for (size_t t = 0; t < threadCount; t++)
+                               {
+                                   threads.emplace_back(
+                                       [&, t]
+                                       {
+                                           uint64_t state = t * 0x9E3779B97F4A7C15ull + 1;
+
+                                           for (uint64_t n = 0; n < writes; n++)
+                                           {
+                                               state = state * 6364136223846793005ull + 1442695040888963407ull;
+                                               write(t, n % SlotsPerThread, &resources[(state >> 33) % ResourceCount]);
+                                           }
+                                       });
+                               }
+
+                               for (auto& thread : threads)
+                                   thread.join();
+                           });
+        };
+
+        auto sharded = run(
+            [&](size_t t, size_t slot, Resource* resource)
+            {
+                infos[t][slot].buffer = resource;
+                Links::Attach(&links[t][slot], resource);
+            });
+
+        for (auto& threadLinks : links)
+        {
+            for (size_t i = 0; i < SlotsPerThread; i++)
+                Links::Detach(&threadLinks[i]);
+        }
+
+        GlobalMap global;
+
+        auto locked = run(
+            [&](size_t t, size_t slot, Resource* resource)
+            {
+                auto& info = infos[t][slot];
+                global.Attach(&info, info.buffer, resource);
+                info.buffer = resource;
+            });
+
+        std::printf("%8zu %16.1f %16.1f\n", threadCount, sharded, locked);
+    }
+
+    return 0;
+}
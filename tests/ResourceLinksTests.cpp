@@ -0,0 +1,204 @@
+// resource_tracking/ResourceLinks.h, resource to descriptor slot lists
+
+#include "Check.h"
+
+#include <resource_tracking/ResourceLinks.h>
+
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+struct Resource
+{
+    int Id = 0;
+};
+
+struct Info
+{
+    Resource* buffer = nullptr;
+    uint64_t lastUsedFrame = 0;
+};
+
+using Link = resource_links::Link<Resource, Info>;
+using Links = resource_links::Map<Resource, Info, std::mutex, std::unordered_map<Resource*, Link*>>;
+
+// Walks the resource's list, checks the back links and returns its length
+static size_t ListSize(Resource* resource)
+{
+    auto& shard = Links::GetShard(resource);
+    std::scoped_lock lock(shard.mutex);
+
+    auto it = shard.heads.find(resource);
+
+    if (it == shard.heads.end())
+        return 0;
+
+    size_t size = 0;
+    Link* prev = nullptr;
+
+    for (auto link = it->second; link != nullptr; link = link->next)
+    {
+        CHECK(link->prev == prev && link->owner.load() == resource);
+        prev = link;
+        size++;
+    }
+
+    return size;
+}
+
+static void AttachAndDetach()
+{
+    static Resource resources[2];
+    static Info infos[4];
+    static Link links[4];
+
+    for (size_t i = 0; i < 4; i++)
+        links[i].info = &infos[i];
+
+    for (auto& link : links)
+        Links::Attach(&link, &resources[0]);
+
+    // Same resource again is a no-op
+    Links::Attach(&links[0], &resources[0]);
+    CHECK(ListSize(&resources[0]) == 4);
+
+    // Middle, head and tail
+    Links::Detach(&links[1]);
+    Links::Detach(&links[3]);
+    Links::Detach(&links[0]);
+    CHECK(ListSize(&resources[0]) == 1 && links[0].owner.load() == nullptr);
+
+    // Detached twice and never attached
+    Links::Detach(&links[0]);
+    Links::Attach(&links[0], nullptr);
+    CHECK(links[0].owner.load() == nullptr);
+
+    Links::Detach(&links[2]);
+    CHECK(ListSize(&resources[0]) == 0);
+}
+
+// Descriptor slot rewritten with another resource without detaching first
+static void AttachMovesBetweenLists()
+{
+    static Resource resources[2];
+    static Info infos[3];
+    static Link links[3];
+
+    for (size_t i = 0; i < 3; i++)
+    {
+        links[i].info = &infos[i];
+        Links::Attach(&links[i], &resources[0]);
+    }
+
+    Links::Attach(&links[1], &resources[1]);
+    CHECK(links[1].owner.load() == &resources[1]);
+    CHECK(ListSize(&resources[0]) == 2);
+    CHECK(ListSize(&resources[1]) == 1);
+
+    // Old list is still intact
+    Links::Detach(&links[0]);
+    Links::Detach(&links[2]);
+    CHECK(ListSize(&resources[0]) == 0);
+
+    Links::Detach(&links[1]);
+    CHECK(ListSize(&resources[1]) == 0);
+}
+
+static void ReleaseDetachesAll()
+{
+    static Resource resources[2];
+    static Info infos[3];
+    static Link links[3];
+
+    for (size_t i = 0; i < 3; i++)
+    {
+        links[i].info = &infos[i];
+        infos[i].lastUsedFrame = 10;
+        infos[i].buffer = &resources[0];
+        Links::Attach(&links[i], &resources[0]);
+    }
+
+    // Slot info already points at another resource, only the link is dropped
+    infos[2].buffer = &resources[1];
+
+    {
+        auto& shard = Links::GetShard(&resources[0]);
+        std::scoped_lock lock(shard.mutex);
+        CHECK(Links::DetachAllLocked(shard, &resources[0]));
+        CHECK(!Links::DetachAllLocked(shard, &resources[0]));
+    }
+
+    CHECK(ListSize(&resources[0]) == 0);
+    CHECK(infos[0].buffer == nullptr && infos[0].lastUsedFrame == 0);
+    CHECK(infos[2].buffer == &resources[1] && infos[2].lastUsedFrame == 10);
+
+    for (auto& link : links)
+        CHECK(link.owner.load() == nullptr && link.next == nullptr && link.prev == nullptr);
+
+    // Detach after release is a no-op
+    Links::Detach(&links[0]);
+}
+
+// Threads rewrite their own slots with resources shared by all of them
+static void ConcurrentWrites()
+{
+    constexpr size_t Threads = 4;
+    constexpr size_t Slots = 64;
+
+    static Resource resources[16];
+    static Info infos[Threads][Slots];
+    static Link links[Threads][Slots];
+
+    std::vector<std::thread> threads;
+
+    for (size_t t = 0; t < Threads; t++)
+    {
+        threads.emplace_back(
+            [t]
+            {
+                for (size_t i = 0; i < Slots; i++)
+                    links[t][i].info = &infos[t][i];
+
+                for (size_t n = 0; n < 5000; n++)
+                {
+                    auto slot = (n * 7 + t) % Slots;
+
+                    if (n % 5 == 0)
+                        Links::Detach(&links[t][slot]);
+                    else
+                        Links::Attach(&links[t][slot], &resources[(n + t * 3) % 16]);
+                }
+            });
+    }
+
+    for (auto& thread : threads)
+        thread.join();
+
+    size_t attached = 0;
+
+    for (auto& threadLinks : links)
+    {
+        for (auto& link : threadLinks)
+        {
+            if (link.owner.load() != nullptr)
+                attached++;
+        }
+    }
+
+    size_t listed = 0;
+
+    for (auto& resource : resources)
+        listed += ListSize(&resource);
+
+    CHECK(listed == attached);
+}
+
+int main()
+{
+    AttachAndDetach();
+    AttachMovesBetweenLists();
+    ReleaseDetachesAll();
+    ConcurrentWrites();
+
+    return TestResult();
+}
@@ -0,0 +1,298 @@
+// framegen/ResourcePool.h, reuse, fence and frame latency gating, trimming and key matching with a fake device
+
+#include "Check.h"
+
+#include <framegen/ResourcePool.h>
+
+#include <set>
+
+using namespace resource_pool;
+
+// BUFFER_COUNT of SysUtils.h, ResourcePoolDx12 keeps released resources for BUFFER_COUNT + 1 frames
+constexpr uint64_t BufferCount = 4;
+constexpr uint64_t Latency = BufferCount + 1;
+
+// Handles are numbers, 0 is the failed creation. Completed is the fence value the fake GPU has reached.
+struct FakeDevice
+{
+    using Resource = uint32_t;
+
+    uint32_t Next = 1;
+    std::set<uint32_t> Alive;
+    uint64_t Completed = 0;
+    bool Fail = false;
+
+    Resource Create(const Key& key, uint64_t& size)
+    {
+        if (Fail)
+            return 0;
+
+        size = key.Width * key.Height * 4;
+        Alive.insert(Next);
+        return Next++;
+    }
+
+    void Destroy(Resource resource) { CHECK(Alive.erase(resource) == 1); }
+
+    uint64_t CompletedFrame() { return Completed; }
+};
+
+using FakePool = Pool<FakeDevice>;
+
+static Key Texture(uint64_t width = 1920, uint32_t height = 1080)
+{
+    Key key;
+    key.Owner = 1;
+    key.Dimension = 4;
+    key.Width = width;
+    key.Height = height;
+    key.DepthOrArraySize = 1;
+    key.MipLevels = 1;
+    key.Format = 10;
+    key.SampleCount = 1;
+    key.HeapType = 1;
+    return key;
+}
+
+// Present of a GPU which is never behind, the fence reaches the signalled value right away
+static void Present(FakePool& pool, FakeDevice& device)
+{
+    pool.EndFrame(device);
+    device.Completed = pool.Frame();
+}
+
+static void ReuseAfterLatency()
+{
+    FakeDevice device;
+    FakePool pool(Latency);
+
+    auto first = pool.Acquire(device, Texture());
+    CHECK(first != 0 && pool.Owns(first));
+    CHECK(pool.Release(first));
+    Present(pool, device);
+
+    // Fence is already passed, the frames of the FG slots still hold it back
+    for (uint64_t i = 1; i < Latency; i++)
+    {
+        auto other = pool.Acquire(device, Texture());
+        CHECK(other != first);
+        pool.Release(other);
+        Present(pool, device);
+    }
+
+    CHECK(pool.Frame() == Latency);
+    CHECK(pool.Acquire(device, Texture()) == first);
+
+    auto& stats = pool.GetStats();
+    CHECK(stats.Hits == 1 && stats.Misses == Latency);
+    CHECK(stats.Created == Latency && stats.Resident == Latency && stats.InUse == 1);
+    CHECK(stats.BytesInUse == 1920 * 1080 * 4 && stats.BytesResident == Latency * 1920 * 1080 * 4);
+
+    pool.Release(first);
+    Present(pool, device);
+
+    // Steady state, one resource a frame keeps the pool at Latency resources
+    for (int i = 0; i < 100; i++)
+    {
+        auto resource = pool.Acquire(device, Texture());
+        pool.Release(resource);
+        Present(pool, device);
+    }
+
+    CHECK(stats.Created == Latency && device.Alive.size() == Latency);
+    CHECK(stats.HitRate() > 0.9);
+}
+
+static void FenceGating()
+{
+    FakeDevice device;
+    FakePool pool(1);
+
+    auto first = pool.Acquire(device, Texture());
+    pool.Release(first);
+
+    // GPU is stuck before the end of the release frame, neither handed out nor trimmed
+    for (int i = 0; i < 400; i++)
+    {
+        pool.EndFrame(device);
+        auto other = pool.Acquire(device, Texture());
+        CHECK(other != first);
+        pool.Release(other);
+    }
+
+    CHECK(device.Alive.count(first) == 1);
+
+    // Release frame is done, the fence value signalled after frame 0 is 1
+    device.Completed = 1;
+    CHECK(pool.Acquire(device, Texture()) == first);
+
+    // Released during frame 400, signalled as 401 after the next EndFrame
+    pool.Release(first);
+    pool.EndFrame(device);
+    device.Completed = 400;
+    CHECK(pool.Acquire(device, Texture()) != first);
+
+    device.Completed = 401;
+    CHECK(pool.Acquire(device, Texture()) == first);
+}
+
+static void FenceAndLatency()
+{
+    FakeDevice device;
+    FakePool pool(Latency);
+
+    auto first = pool.Acquire(device, Texture());
+    pool.Release(first);
+
+    // GPU runs 8 frames behind, the fence decides instead of the frame latency
+    const uint64_t behind = 8;
+
+    for (uint64_t i = 0; i < behind; i++)
+    {
+        pool.EndFrame(device);
+        CHECK(pool.Acquire(device, Texture()) != first);
+    }
+
+    // Frame latency is long passed, the fence value of the release frame is reached only now
+    CHECK(pool.Frame() == behind);
+    device.Completed = 1;
+    CHECK(pool.Acquire(device, Texture()) == first);
+
+    // Fence ahead of the frame latency, for FG queues the present fence doesn't cover
+    pool.Release(first);
+    auto released = pool.Frame() + 1;
+    pool.EndFrame(device);
+    device.Completed = UINT64_MAX;
+
+    while (pool.Frame() + 1 < released + Latency)
+    {
+        CHECK(pool.Acquire(device, Texture()) != first);
+        pool.EndFrame(device);
+    }
+
+    CHECK(pool.Acquire(device, Texture()) == first);
+}
+
+static void Trim()
+{
+    FakeDevice device;
+    FakePool pool(1, 300);
+
+    auto unused = pool.Acquire(device, Texture());
+    auto kept = pool.Acquire(device, Texture());
+    pool.Release(unused);
+
+    // Released in frame 0, fence value 1, destroyed 300 frames after that
+    for (int i = 0; i < 300; i++)
+        Present(pool, device);
+
+    CHECK(device.Alive.count(unused) == 1 && pool.Owns(unused));
+
+    Present(pool, device);
+    CHECK(device.Alive.count(unused) == 0 && !pool.Owns(unused));
+
+    // Resources in use are never trimmed
+    CHECK(device.Alive.count(kept) == 1 && pool.Owns(kept));
+
+    // A hit restarts the count
+    pool.Release(kept);
+
+    for (int i = 0; i < 200; i++)
+        Present(pool, device);
+
+    CHECK(pool.Acquire(device, Texture()) == kept);
+    pool.Release(kept);
+
+    for (int i = 0; i < 299; i++)
+        Present(pool, device);
+
+    CHECK(pool.Owns(kept));
+
+    // Trimming waits for the fence as well
+    CHECK(pool.Acquire(device, Texture()) == kept);
+    pool.Release(kept);
+
+    for (int i = 0; i < 400; i++)
+        pool.EndFrame(device);
+
+    CHECK(pool.Owns(kept));
+    device.Completed = pool.Frame();
+    pool.EndFrame(device);
+    CHECK(!pool.Owns(kept) && device.Alive.empty());
+
+    auto& stats = pool.GetStats();
+    CHECK(stats.Created == 2 && stats.Destroyed == 2);
+    CHECK(stats.Resident == 0 && stats.BytesResident == 0 && stats.InUse == 0 && stats.BytesInUse == 0);
+}
+
+static void KeyMismatch()
+{
+    FakeDevice device;
+    FakePool pool(1);
+
+    auto first = pool.Acquire(device, Texture());
+    pool.Release(first);
+    Present(pool, device);
+
+    // Any difference in the description, heap, state or device is another resource
+    Key keys[8];
+
+    for (auto& key : keys)
+        key = Texture();
+
+    keys[0].Width = 1921;
+    keys[1].Height = 1081;
+    keys[2].Format = 87;
+    keys[3].Owner = 2;
+    keys[4].InitialState = 0x800;
+    keys[5].HeapType = 5;
+    keys[6].Flags = 1;
+    keys[7].MipLevels = 2;
+
+    for (auto& key : keys)
+        CHECK(pool.Acquire(device, key) != first);
+
+    CHECK(pool.GetStats().Hits == 0 && pool.GetStats().Misses == 9);
+    CHECK(pool.Acquire(device, Texture()) == first);
+}
+
+static void Ownership()
+{
+    FakeDevice device;
+    FakePool pool(1);
+
+    auto resource = pool.Acquire(device, Texture());
+
+    // Not from the pool, or already given back
+    CHECK(!pool.Release(12345));
+    CHECK(!pool.Owns(12345));
+    CHECK(pool.Release(resource));
+    CHECK(!pool.Release(resource));
+    CHECK(pool.GetStats().InUse == 0);
+
+    // Failed creation isn't kept
+    device.Fail = true;
+    CHECK(pool.Acquire(device, Texture(640, 360)) == 0);
+    CHECK(pool.GetStats().Misses == 2 && pool.GetStats().Resident == 1);
+    device.Fail = false;
+
+    // Clear destroys resources in use as well
+    pool.Acquire(device, Texture(640, 360));
+    pool.Clear(device);
+
+    auto& stats = pool.GetStats();
+    CHECK(device.Alive.empty() && stats.Destroyed == 2);
+    CHECK(stats.Resident == 0 && stats.BytesResident == 0 && stats.InUse == 0 && stats.BytesInUse == 0);
+}
+
+int main()
+{
+    ReuseAfterLatency();
+    FenceGating();
+    FenceAndLatency();
+    Trim();
+    KeyMismatch();
+    Ownership();
+
+    return TestResult();
+}
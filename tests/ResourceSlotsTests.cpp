@@ -0,0 +1,168 @@
+// framegen/ResourceSlots.h, slot lifecycle of the FG frame resources
+
+#include "Check.h"
+
+#include <framegen/ResourceSlots.h>
+
+#include <atomic>
+#include <mutex>
+#include <shared_mutex>
+#include <thread>
+#include <vector>
+
+enum class ResourceType : uint32_t
+{
+    Depth,
+    Velocity,
+    HudlessColor,
+    UIColor,
+    Distortion,
+    Count
+};
+
+struct Resource
+{
+    uint64_t First = 0;
+    uint64_t Second = 0;
+    void* Copy = nullptr;
+};
+
+using FrameMap = resource_slots::Map<ResourceType, Resource, (size_t) ResourceType::Count>;
+
+static void MapSemantics()
+{
+    FrameMap map;
+
+    CHECK(!map.contains(ResourceType::Depth));
+    CHECK(map.find(ResourceType::Depth) == nullptr);
+    CHECK(map.mask() == 0);
+
+    map[ResourceType::Depth].First = 5;
+    map[ResourceType::Velocity];
+
+    CHECK(map.contains(ResourceType::Depth) && map.contains(ResourceType::Velocity));
+    CHECK(map.find(ResourceType::Depth)->First == 5);
+    CHECK(map.mask() == (resource_slots::Bit(0) | resource_slots::Bit(1)));
+
+    // Existing value isn't reset by another operator[]
+    CHECK(map[ResourceType::Depth].First == 5);
+
+    map.clear();
+    CHECK(!map.contains(ResourceType::Depth) && map.find(ResourceType::Depth) == nullptr);
+
+    // Value of a cleared key comes back default constructed
+    CHECK(map[ResourceType::Depth].First == 0);
+
+    resource_slots::Flags flags;
+    flags.Set(3);
+    CHECK(flags.Has(3) && !flags.Has(2) && flags.Mask() == resource_slots::Bit(3));
+    flags.Clear();
+    CHECK(!flags.Has(3));
+}
+
+// Frame resources are rewritten under the frame's lock while readers check readiness without it,
+// a reader must never see a half written or stale value of a slot marked ready
+static void NewFrameAgainstReaders()
+{
+    constexpr uint32_t BufferCount = 4;
+
+    static FrameMap frames[BufferCount];
+    static resource_slots::Flags ready[BufferCount];
+    static std::shared_mutex mutexes[BufferCount];
+
+    std::atomic<bool> stop { false };
+    std::atomic<uint64_t> torn { 0 };
+    std::atomic<uint64_t> reads { 0 };
+
+    // Something to read before the writer starts
+    {
+        auto& depth = frames[1][ResourceType::Depth];
+        depth.First = 1;
+        depth.Second = 1;
+    }
+
+    std::vector<std::thread> readers;
+
+    for (uint32_t r = 0; r < 2; r++)
+    {
+        readers.emplace_back(
+            [&]
+            {
+                while (!stop.load(std::memory_order_relaxed))
+                {
+                    for (uint32_t i = 0; i < BufferCount; i++)
+                    {
+                        auto isReady = ready[i].Has((uint32_t) ResourceType::Velocity);
+                        std::shared_lock lock(mutexes[i]);
+
+                        if (auto depth = frames[i].find(ResourceType::Depth); depth != nullptr)
+                        {
+                            if (depth->First != depth->Second)
+                                torn++;
+
+                            reads++;
+                        }
+
+                        if (isReady && frames[i].contains(ResourceType::Velocity))
+                        {
+                            auto velocity = frames[i].find(ResourceType::Velocity);
+
+                            if (velocity == nullptr || velocity->First != velocity->Second)
+                                torn++;
+                        }
+                    }
+
+                    std::this_thread::yield();
+                }
+            });
+    }
+
+    uint64_t stale = 0;
+
+    // Don't let the writer finish before a reader got scheduled
+    while (reads.load() == 0)
+        std::this_thread::yield();
+
+    for (uint64_t frame = 1; frame < 20000; frame++)
+    {
+        auto index = frame % BufferCount;
+
+        {
+            std::unique_lock lock(mutexes[index]);
+            ready[index].Clear();
+            frames[index].clear();
+        }
+
+        for (auto type : { ResourceType::Depth, ResourceType::Velocity })
+        {
+            std::unique_lock lock(mutexes[index]);
+            auto& resource = frames[index][type];
+
+            if (resource.First != 0 || resource.Copy != nullptr)
+                stale++;
+
+            resource.First = frame;
+            resource.Second = frame;
+        }
+
+        ready[index].Set((uint32_t) ResourceType::Velocity);
+        ready[index].Set((uint32_t) ResourceType::Depth);
+    }
+
+    stop = true;
+
+    for (auto& reader : readers)
+        reader.join();
+
+    CHECK(stale == 0);
+    CHECK(torn.load() == 0);
+    CHECK(reads.load() > 0);
+}
+
+int main()
+{
+    MapSemantics();
+    NewFrameAgainstReaders();
+
+    return TestResult();
+}
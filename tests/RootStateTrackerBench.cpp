@@ -0,0 +1,192 @@
+// hooks/RootStateTracker.h, recording root state of command lists from 1 to 8 threads.
+// Global exclusive lock + map of root parameter vectors is what the D3D12 root hooks did before the tracker.
+
+#include "Bench.h"
+
+#include <hooks/RootStateTracker.h>
+
+#include <shared_mutex>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+using namespace root_state;
+
+constexpr uint64_t SignatureCount = 8;
+constexpr size_t ListsPerThread = 4;
+
+// Table, 4 root constants, CBV, SRV and UAV, one root call each per draw
+static Layout MakeLayout()
+{
+    Layout layout;
+    layout.AddParameter(0);
+    layout.AddParameter(4);
+    layout.AddParameter(0);
+    layout.AddParameter(0);
+    layout.AddParameter(0);
+    return layout;
+}
+
+class TrackerRecorder
+{
+    Tracker<4096> _tracker;
+
+    // Layouts of created root signatures, read when a list switches signature
+    std::shared_mutex _layoutMutex;
+    std::unordered_map<uint64_t, Layout> _layouts;
+
+  public:
+    TrackerRecorder()
+    {
+        for (uint64_t signature = 1; signature <= SignatureCount; signature++)
+            _layouts[signature] = MakeLayout();
+    }
+
+    void SetSignature(const void* list, uint64_t signature)
+    {
+        Layout layout;
+
+        {
+            std::shared_lock lock(_layoutMutex);
+            layout = _layouts[signature];
+        }
+
+        _tracker.Acquire(list)->SetSignature(SignatureType::Compute, signature, layout);
+    }
+
+    void Draw(const void* list, uint64_t draw)
+    {
+        uint32_t constants[4] = { (uint32_t) draw, 1, 2, 3 };
+
+        _tracker.Acquire(list)->SetParameter(SignatureType::Compute, 0, ParameterType::Table, draw);
+        _tracker.Acquire(list)->SetConstants(SignatureType::Compute, 1, 4, constants, 0);
+        _tracker.Acquire(list)->SetParameter(SignatureType::Compute, 2, ParameterType::CBV, draw);
+        _tracker.Acquire(list)->SetParameter(SignatureType::Compute, 3, ParameterType::SRV, draw);
+        _tracker.Acquire(list)->SetParameter(SignatureType::Compute, 4, ParameterType::UAV, draw);
+    }
+};
+
+class GlobalLockRecorder
+{
+    struct RootState
+    {
+        ParameterType Type = ParameterType::Invalid;
+        uint64_t Value = 0;
+        uint32_t Num32BitValues = 0;
+        uint32_t DestOffset = 0;
+        std::vector<uint32_t> Data;
+    };
+
+    std::shared_mutex _countMutex;
+    std::unordered_map<uint64_t, uint32_t> _parameterCounts;
+
+    std::shared_mutex _statesMutex;
+    std::unordered_map<const void*, std::vector<RootState>> _states;
+
+    void Set(const void* list, uint32_t index, ParameterType type, uint64_t value)
+    {
+        std::unique_lock lock(_statesMutex);
+        auto& table = _states[list];
+
+        if (index < table.size())
+        {
+            table[index].Type = type;
+            table[index].Value = value;
+        }
+    }
+
+  public:
+    GlobalLockRecorder()
+    {
+        for (uint64_t signature = 1; signature <= SignatureCount; signature++)
+            _parameterCounts[signature] = MakeLayout().Count;
+    }
+
+    void SetSignature(const void* list, uint64_t signature)
+    {
+        uint32_t count = 0;
+
+        {
+            std::unique_lock lock(_countMutex);
+            count = _parameterCounts[signature];
+        }
+
+        std::unique_lock lock(_statesMutex);
+        _states[list].assign(count, {});
+    }
+
+    void Draw(const void* list, uint64_t draw)
+    {
+        uint32_t constants[4] = { (uint32_t) draw, 1, 2, 3 };
+
+        Set(list, 0, ParameterType::Table, draw);
+
+        {
+            std::unique_lock lock(_statesMutex);
+            auto& table = _states[list];
+
+            if (1 < table.size())
+            {
+                table[1].Type = ParameterType::Constants;
+                table[1].Num32BitValues = 4;
+                table[1].DestOffset = 0;
+                table[1].Data.assign(constants, constants + 4);
+            }
+        }
+
+        Set(list, 2, ParameterType::CBV, draw);
+        Set(list, 3, ParameterType::SRV, draw);
+        Set(list, 4, ParameterType::UAV, draw);
+    }
+};
+
+// Every thread records its own lists, switches list every 1024 draws and root signature every 16 draws
+template <typename Recorder> static double DrawNs(size_t threadCount, uint64_t draws)
+{
+    static char lists[8 * ListsPerThread][64];
+    Recorder recorder;
+
+    return NsPerOp(draws * threadCount,
+                   [&]
+                   {
+                       std::vector<std::thread> threads;
+
+                       for (size_t t = 0; t < threadCount; t++)
+                       {
+                           threads.emplace_back(
+                               [&, t]
+                               {
+                                   for (uint64_t i = 0; i < draws; i++)
+                                   {
+                                       auto list = lists[t * ListsPerThread + (i >> 10) % ListsPerThread];
+
+                                       if ((i & 15) == 0)
+                                           recorder.SetSignature(list, 1 + (i >> 4) % SignatureCount);
+
+                                       recorder.Draw(list, i);
+                                   }
+                               });
+                       }
+
+                       for (auto& thread : threads)
+                           thread.join();
+                   });
+}
+
+int main(int argc, char** argv)
+{
+    auto quick = QuickRun(argc, argv);
+    const uint64_t draws = quick ? 1'000 : 200'000;
+
+    std::printf("5 root calls per draw, %u hardware threads\n", std::thread::hardware_concurrency());
+    std::printf("%8s %16s %18s\n", "threads", "tracker ns/draw", "global lock ns/draw");
+
+    for (size_t threadCount : { 1, 2, 4, 8 })
+    {
+        auto tracker = DrawNs<TrackerRecorder>(threadCount, draws);
+        auto global = DrawNs<GlobalLockRecorder>(threadCount, draws);
+        std::printf("%8zu %16.1f %18.1f\n", threadCount, tracker, global);
+    }
+
+    return 0;
+}
@@ -0,0 +1,245 @@
+// hooks/RootStateTracker.h, per command list root state, slot reuse and the locked overflow map
+
+#include "Check.h"
+
+#include <hooks/RootStateTracker.h>
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+using namespace root_state;
+
+static void RecordsRootState()
+{
+    static Tracker<64> tracker;
+    int list = 0;
+
+    Layout layout;
+    layout.AddParameter(0);
+    layout.AddParameter(4);
+    layout.AddParameter(0);
+    layout.AddParameter(2);
+
+    auto record = tracker.Acquire(&list);
+    CHECK(record != nullptr && record == tracker.Find(&list) && record == tracker.Acquire(&list));
+
+    int other = 0;
+    CHECK(tracker.Find(&other) == nullptr);
+
+    uint32_t constants[4] = { 1, 2, 3, 4 };
+
+    record->SetSignature(SignatureType::Compute, 0x100, layout);
+    record->SetParameter(SignatureType::Compute, 0, ParameterType::Table, 0xAA);
+    record->SetConstants(SignatureType::Compute, 1, 2, constants, 1);
+    record->SetConstants(SignatureType::Compute, 3, 2, constants, 0);
+
+    // Out of the parameter's range and unknown parameter are ignored
+    record->SetConstants(SignatureType::Compute, 3, 2, constants, 1);
+    record->SetParameter(SignatureType::Compute, 9, ParameterType::CBV, 1);
+
+    State state;
+    record->Snapshot(state);
+    CHECK(state.Last == SignatureType::Compute && state.Compute.Parameters[0].Value == 0xAA);
+    CHECK(state.Compute.ConstantMask == ((1ull << 1) | (1ull << 2) | (1ull << 4) | (1ull << 5)));
+    CHECK(state.Compute.Constants[2] == 2 && state.Compute.Constants[5] == 2);
+
+    // Same signature again keeps the bindings
+    record->SetSignature(SignatureType::Compute, 0x100, layout);
+    record->Snapshot(state);
+    CHECK(state.Compute.Parameters[0].Type == ParameterType::Table);
+
+    // Graphics signature doesn't touch compute bindings
+    record->SetSignature(SignatureType::Graphics, 0x200, layout);
+    record->Snapshot(state);
+    CHECK(state.Last == SignatureType::Graphics && state.Compute.Parameters[0].Type == ParameterType::Table);
+
+    // New compute signature drops them
+    record->SetSignature(SignatureType::Compute, 0x300, layout);
+    record->Snapshot(state);
+    CHECK(state.Compute.Parameters[0].Type == ParameterType::Invalid && state.Compute.ConstantMask == 0);
+
+    Layout full;
+
+    for (uint32_t i = 0; i < MaxParameters; i++)
+        CHECK(full.AddParameter(1));
+
+    CHECK(!full.AddParameter(0));
+}
+
+// Writer keeps all constants equal, a snapshot must never mix two writes
+static void SnapshotsAreConsistent()
+{
+    static Tracker<64> tracker;
+    int list = 0;
+
+    Layout layout;
+    layout.AddParameter(4);
+
+    auto record = tracker.Acquire(&list);
+    record->SetSignature(SignatureType::Compute, 1, layout);
+
+    std::atomic<bool> stop { false };
+    std::atomic<uint32_t> written { 0 };
+
+    std::thread writer(
+        [&]
+        {
+            for (uint32_t i = 1; !stop.load(std::memory_order_relaxed); i++)
+            {
+                uint32_t constants[4] = { i, i, i, i };
+                record->SetConstants(SignatureType::Compute, 0, 4, constants, 0);
+                written.store(i, std::memory_order_relaxed);
+            }
+        });
+
+    while (written.load() == 0)
+        std::this_thread::yield();
+
+    uint32_t torn = 0;
+
+    for (uint32_t i = 0; i < 20000; i++)
+    {
+        State state;
+        record->Snapshot(state);
+        auto& c = state.Compute.Constants;
+
+        if (c[0] != c[1] || c[1] != c[2] || c[2] != c[3])
+            torn++;
+    }
+
+    stop = true;
+    writer.join();
+
+    CHECK(torn == 0);
+}
+
+// Lists are created and destroyed far more often than the capacity, records must be reused clean
+static void ReusesRemovedSlots()
+{
+    static Tracker<64> tracker;
+    static int lists[1000];
+
+    Layout layout;
+    layout.AddParameter(0);
+
+    for (uint32_t round = 0; round < 50; round++)
+    {
+        for (uint32_t i = 0; i < 64; i++)
+        {
+            auto record = tracker.Acquire(&lists[(round * 64 + i) % 1000]);
+            CHECK(record != nullptr);
+
+            State state;
+            record->Snapshot(state);
+            CHECK(state.Last == SignatureType::None);
+
+            record->SetSignature(SignatureType::Compute, 5, layout);
+        }
+
+        CHECK(tracker.Count() == 64);
+
+        for (uint32_t i = 0; i < 64; i++)
+            tracker.Remove(&lists[(round * 64 + i) % 1000]);
+
+        CHECK(tracker.Count() == 0);
+    }
+
+    // Untracked list is a no-op
+    tracker.Remove(&lists[999]);
+    CHECK(tracker.Count() == 0);
+}
+
+// More lists than the capacity go to the locked map
+static void OverflowsToLockedMap()
+{
+    static Tracker<64> tracker;
+    static int lists[300];
+
+    std::vector<Record*> records;
+
+    for (uint32_t i = 0; i < 300; i++)
+    {
+        records.push_back(tracker.Acquire(&lists[i]));
+        records.back()->SetPipelineState(i);
+    }
+
+    CHECK(tracker.Count() == 300);
+
+    for (uint32_t i = 0; i < 300; i++)
+    {
+        CHECK(tracker.Find(&lists[i]) == records[i] && tracker.Acquire(&lists[i]) == records[i]);
+        CHECK(records[i]->Current().PipelineState == i);
+    }
+
+    for (uint32_t i = 0; i < 300; i += 2)
+        tracker.Remove(&lists[i]);
+
+    CHECK(tracker.Count() == 150);
+
+    for (uint32_t i = 0; i < 300; i++)
+        CHECK((tracker.Find(&lists[i]) != nullptr) == (i % 2 == 1));
+
+    // Same address after removal gets a clean record, not the cached one
+    CHECK(tracker.Acquire(&lists[0])->Current().PipelineState == 0);
+    CHECK(tracker.Count() == 151);
+}
+
+// Each thread records its own lists while the others add and remove theirs
+static void ConcurrentChurn()
+{
+    static Tracker<128> tracker;
+    static int lists[4][100];
+
+    std::atomic<uint32_t> wrong { 0 };
+    std::vector<std::thread> threads;
+
+    for (uint32_t t = 0; t < 4; t++)
+    {
+        threads.emplace_back(
+            [&, t]
+            {
+                for (uint32_t n = 0; n < 1000; n++)
+                {
+                    auto list = &lists[t][n % 100];
+                    auto record = tracker.Acquire(list);
+                    record->SetPipelineState(t * 1000 + n);
+
+                    if (tracker.Find(list) != record || record->Current().PipelineState != t * 1000 + n)
+                        wrong++;
+
+                    if (n % 3 == 0)
+                        tracker.Remove(list);
+                }
+            });
+    }
+
+    for (auto& thread : threads)
+        thread.join();
+
+    CHECK(wrong.load() == 0);
+
+    uint32_t alive = 0;
+
+    for (auto& threadLists : lists)
+    {
+        for (auto& list : threadLists)
+        {
+            if (tracker.Find(&list) != nullptr)
+                alive++;
+        }
+    }
+
+    CHECK(tracker.Count() == alive);
+}
+
+int main()
+{
+    RecordsRootState();
+    SnapshotsAreConsistent();
+    ReusesRemovedSlots();
+    OverflowsToLockedMap();
+    ConcurrentChurn();
+
+    return TestResult();
+}
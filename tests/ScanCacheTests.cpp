@@ -0,0 +1,262 @@
+// scanner/ScanCache.h against fake module images: hints across restarts, rebuilt or patched modules,
+// unsaved misses, LRU order after a reload and damaged cache files
+
+#include "Check.h"
+#include "SyntheticCode.h"
+
+#include <scanner/ScanCache.h>
+
+#include <filesystem>
+
+using namespace scanner;
+namespace fs = std::filesystem;
+
+// Stand-in for a loaded exe, headers are hashed into the module key like the PE section headers
+struct FakeModule
+{
+    std::vector<uint8_t> headers;
+    std::vector<uint8_t> code;
+    uint64_t timestamp = 0;
+
+    FakeModule(size_t codeSize, uint32_t seed)
+        : headers(SyntheticCode(1024, seed + 1)), code(SyntheticCode(codeSize, seed)), timestamp(0x60000000 + seed)
+    {
+    }
+
+    ModuleKey Key() const
+    {
+        return { headers.size() + code.size(), timestamp, Fnv1a(headers.data(), headers.size()) };
+    }
+};
+
+// Same flow as ScanWithCache in scanner.cpp, returns SIZE_MAX when not found
+static size_t CachedFind(ScanCache& cache, const FakeModule& module, const Pattern& pattern, int& scans)
+{
+    auto key = module.Key();
+    uint64_t rva = 0;
+
+    if (cache.Lookup(key, pattern.Hash(), rva))
+    {
+        if (rva == ScanCache::NotFound)
+            return SIZE_MAX;
+
+        if (rva + pattern.Size() <= module.code.size() && pattern.MatchAt(module.code.data() + rva))
+            return (size_t) rva;
+
+        cache.Remove(key, pattern.Hash());
+    }
+
+    scans++;
+    auto match = FindPattern(module.code, pattern);
+    auto offset = match != nullptr ? (size_t) (match - module.code.data()) : SIZE_MAX;
+    cache.Store(key, pattern.Hash(), offset != SIZE_MAX ? offset : ScanCache::NotFound);
+
+    return offset;
+}
+
+static std::vector<Pattern> Signatures()
+{
+    std::vector<Pattern> patterns;
+
+    for (auto& mask : RealisticSignatures())
+        patterns.emplace_back(mask);
+
+    return patterns;
+}
+
+static FakeModule ModuleWithSignatures(uint32_t seed)
+{
+    FakeModule module(1 << 20, seed);
+    auto& masks = RealisticSignatures();
+
+    for (size_t i = 0; i < masks.size(); i++)
+        Plant(module.code, 4096 + i * 100000, masks[i], seed + (uint32_t) i);
+
+    return module;
+}
+
+static void HintsSurviveRestart(const fs::path& file)
+{
+    auto module = ModuleWithSignatures(1);
+    auto patterns = Signatures();
+    std::vector<size_t> offsets;
+    int scans = 0;
+
+    {
+        ScanCache cache;
+
+        for (auto& pattern : patterns)
+            offsets.push_back(CachedFind(cache, module, pattern, scans));
+
+        CHECK(scans == (int) patterns.size());
+        CHECK(cache.IsDirty());
+        CHECK(cache.Save(file) && !cache.IsDirty());
+    }
+
+    for (auto offset : offsets)
+        CHECK(offset != SIZE_MAX);
+
+    ScanCache cache;
+    CHECK(cache.Load(file) && cache.Size() == patterns.size());
+
+    scans = 0;
+    for (size_t i = 0; i < patterns.size(); i++)
+        CHECK(CachedFind(cache, module, patterns[i], scans) == offsets[i]);
+
+    CHECK(scans == 0);
+}
+
+static void ChangedModules()
+{
+    auto module = ModuleWithSignatures(2);
+    auto patterns = Signatures();
+    ScanCache cache;
+    int scans = 0;
+
+    auto first = CachedFind(cache, module, patterns[1], scans);
+    CHECK(first != SIZE_MAX && scans == 1);
+
+    // Rebuilt exe, new key so the old hint isn't even looked at
+    auto rebuilt = module;
+    rebuilt.timestamp++;
+    rebuilt.headers[100] ^= 0xFF;
+    uint64_t rva = 0;
+    CHECK(!cache.Lookup(rebuilt.Key(), patterns[1].Hash(), rva));
+    CHECK(CachedFind(cache, rebuilt, patterns[1], scans) == first && scans == 2);
+
+    // Patched in place with the same key, hint fails verification and the pattern is found again
+    auto patched = module;
+    for (size_t i = 0; i < patterns[1].Size(); i++)
+        patched.code[first + i] = 0xCC;
+
+    Plant(patched.code, 900000, RealisticSignatures()[1], 7);
+    auto moved = CachedFind(cache, patched, patterns[1], scans);
+    CHECK(moved != first && moved != SIZE_MAX && scans == 3);
+    CHECK(cache.Lookup(patched.Key(), patterns[1].Hash(), rva) && rva == moved);
+}
+
+static void MissesNotSaved(const fs::path& file)
+{
+    // Packed exe, the code isn't there until it unpacks itself
+    FakeModule module(1 << 16, 3);
+    Pattern pattern(RealisticSignatures()[2]);
+    int scans = 0;
+
+    {
+        ScanCache cache;
+        CHECK(CachedFind(cache, module, pattern, scans) == SIZE_MAX && scans == 1);
+
+        // Misses are cached for this run, but don't make the file dirty
+        CHECK(CachedFind(cache, module, pattern, scans) == SIZE_MAX && scans == 1);
+        CHECK(!cache.IsDirty());
+
+        CHECK(cache.Save(file));
+    }
+
+    ScanCache cache;
+    CHECK(cache.Load(file) && cache.Size() == 0);
+
+    Plant(module.code, 5000, RealisticSignatures()[2], 3);
+    CHECK(CachedFind(cache, module, pattern, scans) == 5000 && scans == 2);
+
+    // Found entry turning into a miss removes it from the file
+    CHECK(cache.Save(file) && !cache.IsDirty());
+    cache.Store(module.Key(), pattern.Hash(), ScanCache::NotFound);
+    CHECK(cache.IsDirty());
+    CHECK(cache.Save(file));
+
+    ScanCache reloaded;
+    CHECK(reloaded.Load(file) && reloaded.Size() == 0);
+}
+
+static void LruOrderSaved(const fs::path& file)
+{
+    FakeModule module(4096, 4);
+    auto key = module.Key();
+
+    {
+        ScanCache cache;
+
+        for (uint64_t i = 0; i < ScanCache::MaxEntries; i++)
+            cache.Store(key, i, i * 16);
+
+        CHECK(cache.Save(file));
+
+        // Oldest entries used again, only the use order changes
+        uint64_t rva = 0;
+        for (uint64_t i = 0; i < 10; i++)
+            CHECK(cache.Lookup(key, i, rva) && rva == i * 16);
+
+        CHECK(cache.IsDirty());
+        CHECK(cache.Save(file));
+    }
+
+    ScanCache cache;
+    CHECK(cache.Load(file) && cache.Size() == ScanCache::MaxEntries);
+
+    for (uint64_t i = 0; i < 10; i++)
+        cache.Store(key, 100000 + i, i);
+
+    CHECK(cache.Size() == ScanCache::MaxEntries);
+
+    // Entries used before the restart stay, the next ten in insertion order are evicted
+    uint64_t rva = 0;
+    for (uint64_t i = 0; i < 10; i++)
+        CHECK(cache.Lookup(key, i, rva));
+
+    for (uint64_t i = 10; i < 20; i++)
+        CHECK(!cache.Lookup(key, i, rva));
+
+    CHECK(cache.Lookup(key, 20, rva) && rva == 20 * 16);
+}
+
+static void DamagedFiles(const fs::path& file)
+{
+    FakeModule module(4096, 5);
+    ScanCache cache;
+
+    for (uint64_t i = 0; i < 8; i++)
+        cache.Store(module.Key(), i, i);
+
+    auto data = cache.Serialize();
+    ScanCache loaded;
+    CHECK(loaded.Deserialize(data) && loaded.Size() == 8);
+
+    auto flipped = data;
+    flipped[sizeof(uint32_t) * 4 + 20] ^= 1;
+    CHECK(!loaded.Deserialize(flipped) && loaded.Size() == 0);
+
+    CHECK(!loaded.Deserialize(std::span(data).first(data.size() - 1)) && loaded.Size() == 0);
+
+    auto version = data;
+    version[4]++;
+    CHECK(!loaded.Deserialize(version));
+
+    // Damaged or missing file leaves an empty cache
+    CHECK(loaded.Deserialize(data));
+    CHECK(cache.Save(file));
+    fs::resize_file(file, data.size() / 2);
+    CHECK(!loaded.Load(file) && loaded.Size() == 0);
+
+    fs::remove(file);
+    CHECK(loaded.Deserialize(data));
+    CHECK(!loaded.Load(file) && loaded.Size() == 0);
+}
+
+int main()
+{
+    auto dir = fs::temp_directory_path() / "opti_scan_cache_test";
+    fs::remove_all(dir);
+    fs::create_directories(dir);
+    auto file = dir / "scan.cache";
+
+    HintsSurviveRestart(file);
+    ChangedModules();
+    MissesNotSaved(file);
+    LruOrderSaved(file);
+    DamagedFiles(file);
+
+    fs::remove_all(dir);
+
+    return TestResult();
+}
@@ -0,0 +1,227 @@
+// shaders/ShaderCache.h with a fake compiler, keys, file format, deduplicated compiles and the disk cache
+
+#include "Check.h"
+
+#include <shaders/ShaderCache.h>
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+using namespace shader_cache;
+namespace fs = std::filesystem;
+
+static std::atomic<uint32_t> compiles { 0 };
+
+// Output is the request itself, slow enough for other threads to arrive while compiling
+static bool FakeCompile(const Request& request, std::vector<uint8_t>& bytecode)
+{
+    compiles++;
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+
+    if (request.Source.find("error") != std::string_view::npos)
+        return false;
+
+    auto text = std::string(request.Source) + "|" + request.Entry + "|" + request.Target;
+
+    for (auto& define : request.Defines)
+        text += "|" + define.Name + "=" + define.Value;
+
+    bytecode.assign(text.begin(), text.end());
+    return true;
+}
+
+static std::string Expected(const Request& request)
+{
+    std::vector<uint8_t> bytecode;
+    FakeCompile(request, bytecode);
+    compiles--;
+    return std::string(bytecode.begin(), bytecode.end());
+}
+
+static bool Matches(const std::shared_ptr<const std::vector<uint8_t>>& bytecode, const Request& request)
+{
+    return bytecode != nullptr && std::string(bytecode->begin(), bytecode->end()) == Expected(request);
+}
+
+static const std::string Source = "float4 main() : SV_Target { return 1; }";
+static const Request Shader { Source, "CSMain", "cs_5_0", {}, 8 };
+
+static Request Variant(uint32_t i)
+{
+    auto request = Shader;
+    request.Defines = { { "V", std::to_string(i) } };
+    return request;
+}
+
+static void Keys()
+{
+    auto key = MakeKey(Shader, 47);
+    CHECK(key == MakeKey(Shader, 47));
+    CHECK(!(key == MakeKey(Shader, 48)));
+
+    // Fields are length prefixed, moving a character between them changes the key
+    auto other = Shader;
+    other.Entry = "CSMai";
+    other.Target = "ncs_5_0";
+    CHECK(!(key == MakeKey(other, 47)));
+
+    other = Shader;
+    other.Flags = 0;
+    CHECK(!(key == MakeKey(other, 47)));
+
+    other = Shader;
+    other.Defines = { { "A", "1" } };
+    auto withDefine = MakeKey(other, 47);
+    CHECK(!(key == withDefine));
+
+    other.Defines = { { "A1", "" } };
+    CHECK(!(withDefine == MakeKey(other, 47)));
+
+    static const std::string otherSource = "float4 main() : SV_Target { return 2; }";
+    other = Shader;
+    other.Source = otherSource;
+    CHECK(!(key == MakeKey(other, 47)));
+
+    CHECK(FileName(key).size() == 32 + 4);
+}
+
+static void FileFormat()
+{
+    auto key = MakeKey(Shader, 47);
+    std::vector<uint8_t> blob { 1, 2, 3, 4 };
+    std::vector<uint8_t> out;
+
+    auto data = Serialize(key, blob);
+    CHECK(Deserialize(data, key, out) && out == blob);
+    CHECK(!Deserialize(data, MakeKey(Shader, 1), out) && out.empty());
+
+    auto broken = data;
+    broken.back() ^= 1;
+    CHECK(!Deserialize(broken, key, out));
+    CHECK(!Deserialize(std::span(data).first(data.size() - 1), key, out));
+}
+
+static void CompilesOnce(const fs::path& dir)
+{
+    compiles = 0;
+    Cache cache(dir, FakeCompile, 47, 1 << 20);
+
+    std::atomic<uint32_t> correct { 0 };
+    std::vector<std::thread> threads;
+
+    for (uint32_t i = 0; i < 8; i++)
+    {
+        threads.emplace_back(
+            [&]
+            {
+                if (Matches(cache.Get(Shader), Shader))
+                    correct++;
+            });
+    }
+
+    for (auto& thread : threads)
+        thread.join();
+
+    CHECK(correct.load() == 8 && compiles.load() == 1);
+
+    auto stats = cache.GetStats();
+    CHECK(stats.Compiles == 1 && stats.MemoryHits + stats.Waits == 7);
+    CHECK(fs::exists(dir / FileName(MakeKey(Shader, 47))));
+
+    // Failures aren't cached
+    Request broken { "error", "CSMain", "cs_5_0", {} };
+    CHECK(cache.Get(broken) == nullptr && cache.Get(broken) == nullptr);
+    CHECK(compiles.load() == 3 && cache.GetStats().Failures == 2);
+
+    // Get during warmup waits for the warmup compile instead of compiling again
+    std::vector<Request> warmup;
+
+    for (uint32_t i = 0; i < 5; i++)
+        warmup.push_back(Variant(i));
+
+    compiles = 0;
+    cache.Warmup(warmup);
+    CHECK(Matches(cache.Get(warmup[4]), warmup[4]));
+    cache.WaitForWarmup();
+    CHECK(compiles.load() == 5);
+
+    for (auto& request : warmup)
+        CHECK(cache.Get(request) != nullptr);
+
+    CHECK(compiles.load() == 5);
+}
+
+// Cache files written by CompilesOnce
+static void DiskHits(const fs::path& dir)
+{
+    compiles = 0;
+
+    Cache cache(dir, FakeCompile, 47, 1 << 20);
+    CHECK(Matches(cache.Get(Shader), Shader));
+    CHECK(compiles.load() == 0 && cache.GetStats().DiskHits == 1);
+
+    // Compiler update
+    Cache updated(dir, FakeCompile, 48, 1 << 20);
+    CHECK(updated.Get(Shader) != nullptr && compiles.load() == 1);
+
+    // Corrupt file is compiled again and rewritten
+    {
+        std::fstream file(dir / FileName(MakeKey(Shader, 47)), std::ios::in | std::ios::out | std::ios::binary);
+        file.seekp(-1, std::ios::end);
+        file.put('X');
+    }
+
+    Cache afterCorruption(dir, FakeCompile, 47, 1 << 20);
+    CHECK(Matches(afterCorruption.Get(Shader), Shader) && compiles.load() == 2);
+
+    Cache rewritten(dir, FakeCompile, 47, 1 << 20);
+    CHECK(rewritten.Get(Shader) != nullptr && compiles.load() == 2);
+}
+
+static void MemoryBudget()
+{
+    compiles = 0;
+
+    std::vector<Request> requests;
+
+    for (uint32_t i = 0; i < 4; i++)
+        requests.push_back(Variant(i));
+
+    // Memory only, room for 3 blobs
+    Cache cache({}, FakeCompile, 1, 3 * Expected(requests[0]).size() + 2);
+
+    cache.Get(requests[0]);
+    cache.Get(requests[1]);
+    cache.Get(requests[2]);
+
+    // 0 is used again, so 1 is the least recently used and goes for 3
+    cache.Get(requests[0]);
+    cache.Get(requests[3]);
+    CHECK(cache.GetStats().MemoryEntries == 3);
+
+    auto before = compiles.load();
+    cache.Get(requests[0]);
+    cache.Get(requests[2]);
+    cache.Get(requests[3]);
+    CHECK(compiles.load() == before);
+
+    cache.Get(requests[1]);
+    CHECK(compiles.load() == before + 1);
+}
+
+int main()
+{
+    auto dir = fs::temp_directory_path() / "opti_shader_cache_test";
+    fs::remove_all(dir);
+
+    Keys();
+    FileFormat();
+    CompilesOnce(dir);
+    DiskHits(dir);
+    MemoryBudget();
+
+    fs::remove_all(dir);
+
+    return TestResult();
+}
@@ -0,0 +1,69 @@
+#pragma once
+
+#include <scanner/Pattern.h>
+
+#include <random>
+#include <string>
+#include <vector>
+
+// Executable section stand-in for the scanner tests: bytes drawn with the x64 code frequencies the
+// scanner uses to pick its anchors, so anchor hits are as common as in a real .text section.
+inline std::vector<uint8_t> SyntheticCode(size_t size, uint32_t seed)
+{
+    std::vector<double> weights(256);
+
+    for (size_t b = 0; b < 256; b++)
+        weights[b] = scanner::ByteFrequency[b];
+
+    std::mt19937 rng(seed);
+    std::discrete_distribution<int> byte(weights.begin(), weights.end());
+    std::vector<uint8_t> code(size);
+
+    for (auto& value : code)
+        value = (uint8_t) byte(rng);
+
+    return code;
+}
+
+// Function prologues and call sites like the ones OptiScaler looks up in games
+inline const std::vector<std::string>& RealisticSignatures()
+{
+    static const std::vector<std::string> signatures = {
+        "83 F9 05 0F 87",
+        "48 85 C9 74 36 48 85 D2 74 31 8B 41 04 39 82 ? ? ? ? 77 20 8B 41 08 39 82 ? ? ? ? 77 15",
+        "40 55 57 41 54 41 56 48 8D AC 24 ? ? ? ? 48 81 EC ? ? ? ? 48 8B 05 ? ? ? ? 48 33 C4",
+        "40 55 53 57 48 8D AC 24 ? ? ? ? B8 ? ? ? ? E8 ? ? ? ? 48 2B E0 80 B9 ? ? ? ? 00",
+        "48 89 5C 24 08 57 48 83 EC 20 48 8B F9 E8 ? ? ? ? 84 C0 74 ? 48 8B CF",
+        "F3 0F 10 05 ? ? ? ? F3 0F 59 C1 F3 0F 11 41 ? C3",
+        "4C 8B DC 49 89 5B 10 49 89 6B 18 56 57 41 56 48 81 EC ? ? ? ? 0F 29 70 E8",
+        "E8 ? ? ? ? 48 8B 4D ? 48 85 C9 74 ? E8 ? ? ? ? 90 48 8B 5C 24 ? 48 83 C4 ? 5F C3",
+    };
+
+    return signatures;
+}
+
+// Writes the pattern's fixed bytes at offset, wildcards get random bytes
+inline void Plant(std::vector<uint8_t>& data, size_t offset, std::string_view mask, uint32_t seed)
+{
+    std::mt19937 rng(seed);
+    size_t i = 0;
+
+    for (size_t c = 0; c < mask.size();)
+    {
+        if (mask[c] == ' ')
+        {
+            c++;
+            continue;
+        }
+
+        if (mask[c] == '?')
+        {
+            data[offset + i++] = (uint8_t) rng();
+            c += (c + 1 < mask.size() && mask[c + 1] == '?') ? 2 : 1;
+            continue;
+        }
+
+        data[offset + i++] = (uint8_t) std::stoi(std::string(mask.substr(c, 2)), nullptr, 16);
+        c += 2;
+    }
+}
@@ -0,0 +1,38 @@
+// misc/TreeHash.h, hashing a 512 MB exe sized buffer.
+// Plain XXH64 over the whole buffer is the single threaded baseline, the tree hash is run with 1 to 4 workers.
+
+#include "Bench.h"
+
+#include <misc/TreeHash.h>
+
+int main(int argc, char** argv)
+{
+    auto quick = QuickRun(argc, argv);
+    const size_t size = quick ? 16 * 1024 * 1024 : 512 * 1024 * 1024;
+
+    std::vector<uint8_t> data(size);
+    uint64_t state = 1;
+
+    for (auto& byte : data)
+    {
+        state = state * 6364136223846793005ull + 1442695040888963407ull;
+        byte = (uint8_t) (state >> 56);
+    }
+
+    std::atomic<bool> cancel { false };
+    auto gbPerSecond = [&](double ns) { return (double) size / ns; };
+
+    std::printf("%zu MB, %u hardware threads\n", size / (1024 * 1024), std::thread::hardware_concurrency());
+    std::printf("%24s %10s\n", "", "GB/s");
+
+    auto plain = NsPerOp(1, [&] { KeepValue(tree_hash::XXH64(data.data(), data.size())); });
+    std::printf("%24s %10.2f\n", "XXH64 whole buffer", gbPerSecond(plain));
+
+    for (uint32_t workers : { 1u, 2u, 4u })
+    {
+        auto tree = NsPerOp(1, [&] { KeepValue(tree_hash::Hash(data, cancel, workers)->Low); });
+        std::printf("%16s %u worker %10.2f\n", "tree hash", workers, gbPerSecond(tree));
+    }
+
+    return 0;
+}
@@ -0,0 +1,121 @@
+// misc/TreeHash.h, XXH64 reference vectors and the chunked tree hash
+
+#include "Check.h"
+
+#include <misc/TreeHash.h>
+
+#include <algorithm>
+
+using namespace tree_hash;
+
+constexpr uint64_t Prime32 = 2654435761u;
+constexpr uint64_t Prime64 = 11400714785074694797ull;
+
+// Sanity buffer of the xxHash test suite
+static std::vector<uint8_t> SanityBuffer(size_t size)
+{
+    std::vector<uint8_t> buffer(size);
+    uint64_t generator = Prime32;
+
+    for (auto& byte : buffer)
+    {
+        byte = (uint8_t) (generator >> 56);
+        generator *= Prime64;
+    }
+
+    return buffer;
+}
+
+static void ReferenceVectors()
+{
+    auto buffer = SanityBuffer(2367);
+
+    struct Vector
+    {
+        size_t Size;
+        uint64_t Seed;
+        uint64_t Hash;
+    };
+
+    // Values of xxhsum's self test
+    static constexpr Vector vectors[] = {
+        { 0, 0, 0xEF46DB3751D8E999ull },
+        { 0, Prime32, 0xAC75FDA2929B17EFull },
+        { 1, 0, 0xE934A84ADB052768ull },
+        { 1, Prime32, 0x5014607643A9B4C3ull },
+        { 4, 0, 0x9136A0DCA57457EEull },
+        { 14, 0, 0x8282DCC4994E35C8ull },
+        { 14, Prime32, 0xC3BD6BF63DEB6DF0ull },
+        { 222, 0, 0xB641AE8CB691C174ull },
+        { 222, Prime32, 0x20CB8AB7AE10C14Aull },
+        { 2367, 0, 0xA82418DDEC0EA581ull },
+    };
+
+    for (auto& vector : vectors)
+        CHECK(XXH64(buffer.data(), vector.Size, vector.Seed) == vector.Hash);
+
+    CHECK(XXH64(reinterpret_cast<const uint8_t*>("abc"), 3) == 0x44BC2CF5AD770999ull);
+}
+
+static void WorkerCountIndependent()
+{
+    // Three and a half chunks, the last one is partial
+    auto data = SanityBuffer(ChunkSize * 3 + ChunkSize / 2);
+    std::atomic<bool> cancel { false };
+
+    auto single = Hash(data, cancel, 1);
+    CHECK(single.has_value());
+
+    for (uint32_t workers : { 0u, 2u, 3u, 4u, 16u })
+        CHECK(Hash(data, cancel, workers) == single);
+
+    // Root is XXH64 of the chunk hashes, each seeded with its index
+    std::vector<uint64_t> chunks;
+
+    for (size_t offset = 0, index = 0; offset < data.size(); offset += ChunkSize, index++)
+        chunks.push_back(XXH64(data.data() + offset, std::min(ChunkSize, data.size() - offset), index));
+
+    CHECK(Combine(chunks, data.size()) == single.value());
+    CHECK(single->ToString().size() == 32);
+    CHECK(single->ToString().find_first_not_of("0123456789abcdef") == std::string::npos);
+
+    // One flipped bit, a truncated file and swapped chunks all change the result
+    auto changed = data;
+    changed[ChunkSize * 2 + 12345] ^= 1;
+    CHECK(Hash(changed, cancel, 2) != single);
+
+    CHECK(Hash(std::span(data).first(data.size() - 1), cancel, 2) != single);
+
+    auto swapped = data;
+    std::swap_ranges(swapped.begin(), swapped.begin() + ChunkSize, swapped.begin() + ChunkSize);
+    CHECK(Hash(swapped, cancel, 2) != single);
+}
+
+static void EdgeCases()
+{
+    std::atomic<bool> cancel { false };
+
+    auto empty = Hash({}, cancel, 4);
+    CHECK(empty.has_value() && empty.value() == Combine({}, 0));
+
+    uint8_t one = 7;
+    auto small = Hash({ &one, 1 }, cancel, 4);
+    uint64_t chunk = XXH64(&one, 1, 0);
+    CHECK(small.has_value() && small.value() == Combine({ &chunk, 1 }, 1));
+
+    Digest digest { 0x0123456789ABCDEFull, 0xFEDCBA9876543210ull };
+    CHECK(digest.ToString() == "0123456789abcdeffedcba9876543210");
+
+    cancel = true;
+    auto data = SanityBuffer(ChunkSize * 2);
+    CHECK(!Hash(data, cancel, 2).has_value());
+}
+
+int main()
+{
+    ReferenceVectors();
+    WorkerCountIndependent();
+    EdgeCases();
+
+    return TestResult();
+}
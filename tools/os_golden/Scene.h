@@ -0,0 +1,73 @@
+#pragma once
+
+#include <shaders/output_scaling/OS_Golden.h>
+
+#include <cmath>
+#include <cstdint>
+
+// Analytic test scene on [0, 1]^2, one quadrant for each kind of content the filters struggle with:
+// zone plate (aliasing), rotated square (hard edges), diagonal stripes (ringing) and a plain gradient.
+namespace os_golden
+{
+
+inline void Scene(double u, double v, float* rgb)
+{
+    double r2 = (u - 0.5) * (u - 0.5) + (v - 0.5) * (v - 0.5);
+    double zone = 0.5 + 0.5 * std::cos(900.0 * r2);
+
+    double ru = (u - 0.3) * 0.8 + (v - 0.7) * 0.6;
+    double rv = -(u - 0.3) * 0.6 + (v - 0.7) * 0.8;
+    double square = (std::abs(ru) < 0.12 && std::abs(rv) < 0.12) ? 1.0 : 0.0;
+
+    double stripes = (std::fmod(u * 37.0 + v * 11.0, 1.0) < 0.5) ? 1.0 : 0.0;
+    double gradient = u;
+
+    double value = u < 0.5 ? (v < 0.5 ? zone : square) : (v < 0.5 ? stripes : gradient);
+
+    rgb[0] = (float) (0.8 * value + 0.1 * v);
+    rgb[1] = (float) (0.9 * value + 0.05);
+    rgb[2] = (float) (0.7 * value + 0.2 * u);
+}
+
+// Box filtered render with samples * samples samples per pixel
+inline os_cpu::Image Render(int32_t width, int32_t height, int32_t samples)
+{
+    os_cpu::Image image(width, height);
+
+    for (int32_t y = 0; y < height; y++)
+    {
+        auto row = image.Row(y);
+
+        for (int32_t x = 0; x < width; x++)
+        {
+            double sum[3] = {};
+
+            for (int32_t j = 0; j < samples; j++)
+            {
+                for (int32_t i = 0; i < samples; i++)
+                {
+                    float color[3];
+                    Scene((x + (i + 0.5) / samples) / width, (y + (j + 0.5) / samples) / height, color);
+
+                    for (int32_t c = 0; c < 3; c++)
+                        sum[c] += color[c];
+                }
+            }
+
+            auto pixel = row + (size_t) x * 4;
+
+            for (int32_t c = 0; c < 3; c++)
+                pixel[c] = (float) (sum[c] / (samples * samples));
+
+            pixel[3] = 1.0f;
+        }
+    }
+
+    return image;
+}
+
+// Source images are rendered with fewer samples, like a game's aliased frame
+inline constexpr int32_t SourceSamples = 4;
+inline constexpr int32_t GoldenSamples = 8;
+
+} // namespace os_golden
@@ -0,0 +1,62 @@
+// Cost and quality of the CPU output scaling kernels at game resolutions, and the filter SelectFilter picks.
+//
+//   os_golden_bench [runs]
+//
+// Sources and golden images are rendered from the analytic scene, nothing is read from disk.
+
+#include "Scene.h"
+
+#include <cstdio>
+#include <cstdlib>
+
+using namespace os_cpu;
+
+struct Case
+{
+    const char* Name;
+    int32_t SrcWidth;
+    int32_t SrcHeight;
+    int32_t DestWidth;
+    int32_t DestHeight;
+};
+
+static constexpr Case Cases[] = {
+    { "1.33x down", 1707, 960, 1280, 720 }, { "2x down", 2560, 1440, 1280, 720 },
+    { "3x down", 3840, 2160, 1280, 720 },   { "1.5x up", 853, 480, 1280, 720 },
+    { "2x up", 640, 360, 1280, 720 },
+};
+
+int main(int argc, char** argv)
+{
+    uint32_t runs = argc > 1 ? (uint32_t) std::max(1, std::atoi(argv[1])) : 5;
+
+    std::printf("isa: %s, best of %u runs\n", IsaName(DetectIsa()), runs);
+
+    for (auto& benchCase : Cases)
+    {
+        auto src = os_golden::Render(benchCase.SrcWidth, benchCase.SrcHeight, os_golden::SourceSamples);
+        auto golden = os_golden::Render(benchCase.DestWidth, benchCase.DestHeight, os_golden::GoldenSamples);
+        Constants constants { benchCase.SrcWidth, benchCase.SrcHeight, benchCase.DestWidth, benchCase.DestHeight };
+
+        std::printf("\n%s %dx%d -> %dx%d\n%-10s %8s %8s %9s %9s %9s\n", benchCase.Name, benchCase.SrcWidth,
+                    benchCase.SrcHeight, benchCase.DestWidth, benchCase.DestHeight, "filter", "PSNR", "SSIM",
+                    "scalar", "SSE", "AVX2");
+
+        auto candidates = Evaluate(constants, src, golden, Isa::Avx2, runs);
+
+        for (auto& candidate : candidates)
+        {
+            std::printf("%-10s %8.2f %8.4f %9.2f %9.2f %9.2f\n", FilterName(candidate.Kernel), candidate.Score.Psnr,
+                        candidate.Score.Ssim, MeasureNsPerPixel(candidate.Kernel, constants, src, Isa::Scalar, runs),
+                        MeasureNsPerPixel(candidate.Kernel, constants, src, Isa::Sse, runs), candidate.NsPerPixel);
+        }
+
+        for (double target : { 0.90, 0.93, 0.95 })
+        {
+            if (auto selected = SelectFilter(candidates, 0.0, target); selected != nullptr)
+                std::printf("  SSIM >= %.2f -> %s\n", target, FilterName(selected->Kernel));
+        }
+    }
+
+    return 0;
+}
@@ -0,0 +1,241 @@
+// Golden image check of the CPU output scaling kernels (OptiScaler/shaders/output_scaling/OS_Cpu.h).
+//
+//   os_golden_compare <golden dir>           compares against golden/scene_160x90.pfm and golden/baseline.txt
+//   os_golden_compare <golden dir> --update  renders the golden image again and rewrites the baseline
+//
+// Fails when the SSE or AVX2 output differs from the scalar reference, when a constant image doesn't pass
+// through unchanged or when a filter's PSNR / SSIM against the golden image dropped below the baseline.
+
+#include "Scene.h"
+
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+
+using namespace os_cpu;
+
+struct Case
+{
+    const char* Name;
+    int32_t SrcWidth;
+    int32_t SrcHeight;
+};
+
+// Every case scales to the golden image size
+static constexpr int32_t GoldenWidth = 160;
+static constexpr int32_t GoldenHeight = 90;
+
+static constexpr Case Cases[] = {
+    { "down3x", 480, 270 }, { "down2x", 320, 180 }, { "down1.33x", 213, 120 },
+    { "up1.5x", 107, 60 },  { "up2x", 80, 45 },
+};
+
+// Allowed drop against the baseline, covers C runtime differences of cos / exp / sin between platforms
+static constexpr double PsnrTolerance = 0.05;
+static constexpr double SsimTolerance = 0.001;
+
+struct BaselineEntry
+{
+    std::string CaseName;
+    std::string FilterName;
+    double Psnr = 0.0;
+    double Ssim = 0.0;
+};
+
+static std::vector<BaselineEntry> LoadBaseline(const std::string& path)
+{
+    std::vector<BaselineEntry> entries;
+    auto file = std::fopen(path.c_str(), "r");
+
+    if (file == nullptr)
+        return entries;
+
+    char caseName[64] = {};
+    char filterName[64] = {};
+    double psnr = 0.0;
+    double ssim = 0.0;
+
+    while (std::fscanf(file, "%63s %63s %lf %lf", caseName, filterName, &psnr, &ssim) == 4)
+        entries.push_back({ caseName, filterName, psnr, ssim });
+
+    std::fclose(file);
+    return entries;
+}
+
+static bool SaveBaseline(const std::string& path, const std::vector<BaselineEntry>& entries)
+{
+    auto file = std::fopen(path.c_str(), "w");
+
+    if (file == nullptr)
+        return false;
+
+    for (auto& entry : entries)
+        std::fprintf(file, "%s %s %.4f %.6f\n", entry.CaseName.c_str(), entry.FilterName.c_str(), entry.Psnr,
+                     entry.Ssim);
+
+    return std::fclose(file) == 0;
+}
+
+static const BaselineEntry* FindBaseline(const std::vector<BaselineEntry>& entries, const char* caseName,
+                                         const char* filterName)
+{
+    for (auto& entry : entries)
+    {
+        if (entry.CaseName == caseName && entry.FilterName == filterName)
+            return &entry;
+    }
+
+    return nullptr;
+}
+
+static float MaxDifference(const Image& a, const Image& b)
+{
+    if (a.Data.size() != b.Data.size())
+        return std::numeric_limits<float>::infinity();
+
+    float result = 0.0f;
+
+    for (size_t i = 0; i < a.Data.size(); i++)
+        result = std::max(result, std::abs(a.Data[i] - b.Data[i]));
+
+    return result;
+}
+
+// Every filter has weights summing to one, a flat image must come out unchanged
+static bool CheckConstantImage()
+{
+    Image src(50, 30);
+
+    for (size_t i = 0; i < src.Data.size(); i++)
+        src.Data[i] = (i & 3) == 3 ? 1.0f : 0.37f;
+
+    bool result = true;
+
+    for (auto constants : { Constants { 50, 30, 20, 11 }, Constants { 50, 30, 90, 70 } })
+    {
+        for (uint32_t i = 0; i < (uint32_t) Filter::Count; i++)
+        {
+            Image dst;
+            Run((Filter) i, constants, src, dst, Isa::Scalar);
+
+            for (size_t j = 0; j < dst.Data.size(); j++)
+            {
+                if ((j & 3) != 3 && std::abs(dst.Data[j] - 0.37f) > 2e-6f)
+                {
+                    std::printf("FAIL constant image changed by %s: %g\n", FilterName((Filter) i), dst.Data[j]);
+                    result = false;
+                    break;
+                }
+            }
+        }
+    }
+
+    return result;
+}
+
+int main(int argc, char** argv)
+{
+    if (argc < 2)
+    {
+        std::printf("usage: %s <golden dir> [--update]\n", argv[0]);
+        return 2;
+    }
+
+    const std::string dir = argv[1];
+    const bool update = argc > 2 && std::strcmp(argv[2], "--update") == 0;
+    const auto goldenPath = dir + "/scene_160x90.pfm";
+    const auto baselinePath = dir + "/baseline.txt";
+
+    std::printf("isa: %s\n", IsaName(DetectIsa()));
+
+    Image golden;
+
+    if (update)
+    {
+        golden = os_golden::Render(GoldenWidth, GoldenHeight, os_golden::GoldenSamples);
+
+        if (!SavePfm(goldenPath, golden))
+        {
+            std::printf("Can't write %s\n", goldenPath.c_str());
+            return 1;
+        }
+    }
+    else if (!LoadPfm(goldenPath, golden) || golden.Width != GoldenWidth || golden.Height != GoldenHeight)
+    {
+        std::printf("Can't read %s\n", goldenPath.c_str());
+        return 1;
+    }
+
+    auto baseline = update ? std::vector<BaselineEntry>() : LoadBaseline(baselinePath);
+    std::vector<BaselineEntry> measured;
+    bool result = CheckConstantImage();
+
+    for (auto& testCase : Cases)
+    {
+        auto src = os_golden::Render(testCase.SrcWidth, testCase.SrcHeight, os_golden::SourceSamples);
+        Constants constants { testCase.SrcWidth, testCase.SrcHeight, GoldenWidth, GoldenHeight };
+
+        std::printf("\n%s %dx%d -> %dx%d\n%-10s %8s %8s\n", testCase.Name, testCase.SrcWidth, testCase.SrcHeight,
+                    GoldenWidth, GoldenHeight, "filter", "PSNR", "SSIM");
+
+        for (uint32_t i = 0; i < (uint32_t) Filter::Count; i++)
+        {
+            auto filter = (Filter) i;
+            Image scalar, sse, avx2;
+
+            if (!Run(filter, constants, src, scalar, Isa::Scalar) || !Run(filter, constants, src, sse, Isa::Sse) ||
+                !Run(filter, constants, src, avx2, Isa::Avx2))
+            {
+                std::printf("FAIL %s didn't run\n", FilterName(filter));
+                result = false;
+                continue;
+            }
+
+            if (auto sseDiff = MaxDifference(scalar, sse), avx2Diff = MaxDifference(scalar, avx2);
+                sseDiff != 0.0f || avx2Diff != 0.0f)
+            {
+                std::printf("FAIL %s differs from scalar, SSE: %g, AVX2: %g\n", FilterName(filter), sseDiff, avx2Diff);
+                result = false;
+            }
+
+            auto quality = Compare(golden, scalar);
+            measured.push_back({ testCase.Name, FilterName(filter), quality.Psnr, quality.Ssim });
+
+            std::printf("%-10s %8.2f %8.4f", FilterName(filter), quality.Psnr, quality.Ssim);
+
+            if (update)
+            {
+                std::printf("\n");
+                continue;
+            }
+
+            auto expected = FindBaseline(baseline, testCase.Name, FilterName(filter));
+
+            if (expected == nullptr)
+            {
+                std::printf("  FAIL no baseline\n");
+                result = false;
+            }
+            else if (!std::isfinite(quality.Psnr) || quality.Psnr < expected->Psnr - PsnrTolerance ||
+                     quality.Ssim < expected->Ssim - SsimTolerance)
+            {
+                std::printf("  FAIL baseline %.2f %.4f\n", expected->Psnr, expected->Ssim);
+                result = false;
+            }
+            else
+            {
+                std::printf("\n");
+            }
+        }
+    }
+
+    if (update && !SaveBaseline(baselinePath, measured))
+    {
+        std::printf("Can't write %s\n", baselinePath.c_str());
+        return 1;
+    }
+
+    std::printf("\n%s\n", result ? "ok" : "FAILED");
+    return result ? 0 : 1;
+}